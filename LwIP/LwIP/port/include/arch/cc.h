@@ -115,4 +115,15 @@ typedef uintptr_t mem_ptr_t;
 	}
 #endif
 
+/* Internet checksum of the port, the LWIP_CHKSUM and LWIP_CHKSUM_COPY of
+   lwipopts.h */
+#ifdef __cplusplus
+extern "C" {
+#endif
+u16_t clearcore_chksum(const void *dataptr, int len);
+u16_t clearcore_chksum_copy(void *dst, const void *src, u16_t len);
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* CC_H_INCLUDED */
@@ -36,6 +36,9 @@
     \brief A device driver for the ClearCore to use LwIP.
 **/
 #include "EthernetApi.h"
+#include "GmacHashFilter.h"
+#include "GmacRxScreen.h"
+#include "InetChecksum.h"
 
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #define max(a, b) (((a) > (b)) ? (a) : (b))
@@ -43,6 +46,9 @@
 #include <string.h>
 
 #include "lwip/def.h"
+#if LWIP_IGMP
+#include "lwip/igmp.h"
+#endif
 #if LWIP_IPV6
 #include "lwip/ethip6.h"
 #endif
@@ -59,6 +65,7 @@
 
 typedef struct netif netInt;
 typedef struct pbuf packetBuf;
+typedef ClearCore::GmacRxRing<GMAC_RX_DESC> RxRing;
 
 /**
     \brief Determine the total length of a received packet.
@@ -69,35 +76,44 @@ typedef struct pbuf packetBuf;
 uint32_t PacketLength(ethInt *ethernetif) {
     // Calculated length of the received packet
     uint32_t length = 0;
+    // Offsets to the SF and EF RX buffers from the current RX index.
+    uint32_t first, last;
+
+    // Start at the current RX buffer index.
+    uint32_t index = *(ethernetif->rxBuffIndex);
+    if (!RxRing::Frame(ethernetif->rxDesc, RX_BUFF_CNT, index, first, last)) {
+        return 0;
+    }
+    // Sum the lengths of the buffers of the frame.
+    for (uint32_t i = first; i <= last; i++) {
+        length += ethernetif->rxDesc[(index + i) % RX_BUFF_CNT].bit.LEN;
+    }
+    return length;
+}
+
+/**
+    \brief Find the first complete frame on the RX ring.
 
-    uint8_t sf = 0;
-    uint32_t index;
+    \param ethernetif   An Ethernet interface reference structure.
+    \param length       Returns the bytes of the frame in its first RX buffer.
 
+    \return The first RX buffer of the frame, NULL if no frame is complete.
+**/
+const uint8_t *PacketHeader(ethInt *ethernetif, uint32_t *length) {
+    // Offsets to the SF and EF RX buffers from the current RX index.
+    uint32_t first, last;
     // Start at the current RX buffer index.
-    index = *(ethernetif->rxBuffIndex);
+    uint32_t index = *(ethernetif->rxBuffIndex);
 
-    // Find the length of the packet.
-    for (uint32_t i = 0; i < RX_BUFF_CNT; i++) {
-        // The OWN bit indicates software has ownership of this buffer.
-        if (!ethernetif->rxDesc[index].bit.OWN) {
-            break;
-        }
-        // Check for the beginning of the frame.
-        if (ethernetif->rxDesc[index].bit.SF) {
-            sf = 1;
-        }
-        // If the beginning of the frame has been found, sum the length.
-        if (sf == 1) {
-            length += ethernetif->rxDesc[index].bit.LEN;
-        }
-        // Check for the end of the frame.
-        if (ethernetif->rxDesc[index].bit.EF) {
-            break;
-        }
-        // Increment the local index, treating RX buffers as circular.
-        index = (index + 1) % RX_BUFF_CNT;
+    if (!RxRing::Frame(ethernetif->rxDesc, RX_BUFF_CNT, index, first, last)) {
+        return NULL;
     }
-    return length;
+    // The EF buffer holds the length of the whole frame.
+    *length = min(ethernetif->rxDesc[(index + last) % RX_BUFF_CNT].bit.LEN,
+                  RX_BUFFER_SIZE);
+    // Mask to ignore the lowest 2 bits that are not part of the address.
+    return (const uint8_t *)(ethernetif->rxDesc[(index + first) % RX_BUFF_CNT].reg[0] &
+                             0xFFFFFFFC);
 }
 
 /**
@@ -111,45 +127,31 @@ uint32_t PacketLength(ethInt *ethernetif) {
 **/
 uint32_t PacketRead(ethInt *ethernetif, uint8_t *buffer, uint32_t bytesToCopy) {
     // Offsets to the SF and EF RX buffers from the current RX index.
-    uint8_t startFrameOffset = RX_BUFF_CNT;
-    uint8_t endFrameOffset = RX_BUFF_CNT;
+    uint32_t startFrameOffset, endFrameOffset;
     // Count of RX buffers in the frame.
     uint8_t bufferCount = 0;
-    // Total length of the packet.
-    uint32_t packetLength;
     // Start at the current RX index.
     uint8_t index = *(ethernetif->rxBuffIndex);
 
-    // Determine the number of buffers in the frame.
-    for (uint8_t i = 0; i < RX_BUFF_CNT; i++) {
-        // The OWN bit indicates software has ownership of this buffer.
-        if (!ethernetif->rxDesc[index].bit.OWN) {
-            break;
-        }
-        // The SF bit indicates this RX buffer is the first in the frame.
-        if (ethernetif->rxDesc[index].bit.SF) {
-            startFrameOffset = i;
-        }
-        // THE EF bit indicates this RX buffer is the last in the frame.
-        if (ethernetif->rxDesc[index].bit.EF && startFrameOffset != RX_BUFF_CNT) {
-            endFrameOffset = i;
-            packetLength = ethernetif->rxDesc[index].bit.LEN;
-            bytesToCopy = min(packetLength, bytesToCopy);
-            break;
-        }
-        // Increment the local index, treating RX buffers as circular.
-        index = (index + 1) % RX_BUFF_CNT;
-    }
-
-    if (endFrameOffset == RX_BUFF_CNT || startFrameOffset == RX_BUFF_CNT) {
+    // Determine the buffers of the frame.
+    if (!RxRing::Frame(ethernetif->rxDesc, RX_BUFF_CNT, index,
+                       startFrameOffset, endFrameOffset)) {
         return 0; // Failed to find the frame..
     }
+    // The EF buffer holds the length of the whole frame.
+    bytesToCopy = min(ethernetif->rxDesc[(index + endFrameOffset) % RX_BUFF_CNT].bit.LEN,
+                      bytesToCopy);
 
     // Bytes moved into buffer.
     uint32_t bytesCopied = 0;
 
-    // Move the RX index to be at the start of frame RX buffer.
-    *ethernetif->rxBuffIndex = (*(ethernetif->rxBuffIndex) + startFrameOffset) % RX_BUFF_CNT;
+    // Give the RX buffers before the frame, the tail of a frame whose start
+    // was lost, back to hardware and move the RX index to be at the start
+    // of frame RX buffer.
+    for (uint32_t i = 0; i < startFrameOffset; i++) {
+        ethernetif->rxDesc[*(ethernetif->rxBuffIndex)].bit.OWN = 0;
+        *ethernetif->rxBuffIndex = (*(ethernetif->rxBuffIndex) + 1) % RX_BUFF_CNT;
+    }
     // Determine the number of buffers in the frame.
     bufferCount = endFrameOffset - startFrameOffset + 1;
     if (endFrameOffset < startFrameOffset) {
@@ -261,6 +263,56 @@ static void low_level_init(netInt *netif) {
 
 }
 
+/**
+    The LWIP_CHKSUM of lwipopts.h, used for all checksums that the GMAC does
+    not insert or check.
+**/
+extern "C" u16_t clearcore_chksum(const void *dataptr, int len) {
+    return ClearCore::InetChecksum::Sum(dataptr, len);
+}
+
+/**
+    The LWIP_CHKSUM_COPY of lwipopts.h, sums the data of tcp_write() while
+    copying it when the GMAC checksum offload is disabled.
+**/
+extern "C" u16_t clearcore_chksum_copy(void *dst, const void *src,
+                                     u16_t len) {
+    return ClearCore::InetChecksum::Copy(dst, src, len);
+}
+
+#if LWIP_IGMP
+/**
+    Groups joined through IGMP, the bits of the GMAC multicast hash filter.
+**/
+static ClearCore::GmacHashFilter igmpHashFilter;
+
+/**
+    Called by IGMP when a group is joined or left. Accepts the frames to the
+    Ethernet address of the group through the multicast hash filter.
+
+    @param netif the lwip network interface structure for this ethernetif
+    @param group the multicast group address
+    @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+    @return ERR_OK
+**/
+static err_t igmp_mac_filter(netInt *netif, const ip4_addr_t *group,
+                             enum netif_mac_filter_action action) {
+    (void)netif;
+    uint8_t mac[6];
+    ClearCore::GmacHashFilter::MulticastMac(ip4_addr_get_u32(group), mac);
+
+    bool changed = (action == NETIF_ADD_MAC_FILTER) ?
+                   igmpHashFilter.Add(mac) : igmpHashFilter.Remove(mac);
+    if (changed) {
+        // Write both halves before the hash is enabled for the first group.
+        GMAC->HRB.reg = igmpHashFilter.Bottom();
+        GMAC->HRT.reg = igmpHashFilter.Top();
+        GMAC->NCFGR.bit.MTIHEN = !igmpHashFilter.Empty();
+    }
+    return ERR_OK;
+}
+#endif
+
 /**
     This function should do the actual transmission of the packet. The packet is
     contained in the pbuf that is passed to the function. This pbuf
@@ -414,6 +466,20 @@ err_t ethernetif_init(netInt *netif) {
     // flags to set device capabilities
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP |
                    NETIF_FLAG_ETHERNET;
+#if LWIP_IGMP
+    // IGMP joins the all-hosts group through the filter once the netif is up
+    netif->flags |= NETIF_FLAG_IGMP;
+    igmpHashFilter.Reset();
+    netif_set_igmp_mac_filter(netif, igmp_mac_filter);
+#endif
+#if CLEARCORE_GMAC_CHECKSUM_OFFLOAD
+    // The GMAC inserts and checks the IP, UDP and TCP checksums, ICMP is
+    // left to lwIP
+    NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_GEN_ICMP |
+                            NETIF_CHECKSUM_GEN_ICMP6 |
+                            NETIF_CHECKSUM_CHECK_ICMP |
+                            NETIF_CHECKSUM_CHECK_ICMP6);
+#endif
     // maximum transfer unit
     netif->mtu = 1536;
 
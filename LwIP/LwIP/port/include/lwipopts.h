@@ -2,6 +2,103 @@
 #ifndef LWIPOPTS_H
 #define LWIPOPTS_H
 
+// ClearCore memory profiles. The pools of lwIP are sized from the connection
+// limits of OpENer's opener_user_conf.h, which the LwIP library does not
+// see; they are repeated here and checked against it by the OpENer port
+// (see clearcore_netmem.c). The profile sets its values ahead of the
+// configuration section below, whose values remain the defaults of
+// everything a profile leaves alone.
+#define CLEARCORE_LWIP_PROFILE_BALANCED 0
+#define CLEARCORE_LWIP_PROFILE_IO 1
+#define CLEARCORE_LWIP_PROFILE_EXPLICIT 2
+
+#ifndef CLEARCORE_LWIP_PROFILE
+#define CLEARCORE_LWIP_PROFILE CLEARCORE_LWIP_PROFILE_BALANCED
+#endif
+
+// OPENER_NUMBER_OF_SUPPORTED_SESSIONS
+#ifndef CLEARCORE_LWIP_SESSIONS
+#define CLEARCORE_LWIP_SESSIONS 20
+#endif
+
+// OPENER_CIP_NUM_EXPLICIT_CONNS
+#ifndef CLEARCORE_LWIP_EXPLICIT_CONNS
+#define CLEARCORE_LWIP_EXPLICIT_CONNS 6
+#endif
+
+// OPENER_CIP_NUM_EXLUSIVE_OWNER_CONNS + OPENER_CIP_NUM_INPUT_ONLY_CONNS +
+// OPENER_CIP_NUM_LISTEN_ONLY_CONNS
+#ifndef CLEARCORE_LWIP_IO_CONNS
+#define CLEARCORE_LWIP_IO_CONNS 10
+#endif
+
+// Frames the receive screening may hold, RX_IO_QUEUE_CNT +
+// RX_OTHER_QUEUE_CNT of EthernetApi.h
+#define CLEARCORE_LWIP_RX_QUEUED 10
+
+// TCP connections open at the same time and the pool buffers on top of the
+// receive screening
+#if CLEARCORE_LWIP_PROFILE == CLEARCORE_LWIP_PROFILE_IO
+// A session per class 3 connection and one for the Forward Opens, a frame
+// in flight per I/O connection
+#define CLEARCORE_LWIP_TCP_CONNS (CLEARCORE_LWIP_EXPLICIT_CONNS + 1)
+#define CLEARCORE_LWIP_RX_SPARE CLEARCORE_LWIP_IO_CONNS
+#elif CLEARCORE_LWIP_PROFILE == CLEARCORE_LWIP_PROFILE_EXPLICIT
+// Every session OpENer accepts, a frame in flight per session
+#define CLEARCORE_LWIP_TCP_CONNS CLEARCORE_LWIP_SESSIONS
+#define CLEARCORE_LWIP_RX_SPARE CLEARCORE_LWIP_TCP_CONNS
+#elif CLEARCORE_LWIP_PROFILE == CLEARCORE_LWIP_PROFILE_BALANCED
+#define CLEARCORE_LWIP_TCP_CONNS (CLEARCORE_LWIP_SESSIONS / 2)
+#define CLEARCORE_LWIP_RX_SPARE \
+    ((CLEARCORE_LWIP_TCP_CONNS + CLEARCORE_LWIP_IO_CONNS) / 2)
+#else
+#error "CLEARCORE_LWIP_PROFILE must be one of the CLEARCORE_LWIP_PROFILE_ values"
+#endif
+
+#ifndef MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB CLEARCORE_LWIP_TCP_CONNS
+#endif
+
+// A socket per connection and the listener
+#ifndef MEMP_NUM_NETCONN
+#define MEMP_NUM_NETCONN (CLEARCORE_LWIP_TCP_CONNS + 1)
+#endif
+
+// Two queued segments per connection, at least TCP_SND_QUEUELEN
+#ifndef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG \
+    (2 * CLEARCORE_LWIP_TCP_CONNS > 16 ? 2 * CLEARCORE_LWIP_TCP_CONNS : 16)
+#endif
+
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE (CLEARCORE_LWIP_RX_QUEUED + CLEARCORE_LWIP_RX_SPARE)
+#endif
+
+// PBUF_RAM replies and the unacknowledged TCP data, 768 bytes per connection
+// hold an explicit reply of PC_OPENER_ETHERNET_BUFFER_SIZE with its headers
+#ifndef MEM_SIZE
+#define MEM_SIZE (2048 + 768 * CLEARCORE_LWIP_TCP_CONNS)
+#endif
+
+// A peer per connection
+#ifndef ARP_TABLE_SIZE
+#define ARP_TABLE_SIZE (CLEARCORE_LWIP_TCP_CONNS + CLEARCORE_LWIP_IO_CONNS)
+#endif
+
+// The peers of the I/O connections are pinned as static entries
+// (clearcore_arppin.c), at most one per I/O connection
+#ifndef ETHARP_SUPPORT_STATIC_ENTRIES
+#define ETHARP_SUPPORT_STATIC_ENTRIES 1
+#endif
+#ifndef CLEARCORE_ARP_PINS
+#define CLEARCORE_ARP_PINS CLEARCORE_LWIP_IO_CONNS
+#endif
+
+// Explicit messages, I/O, trace output, DHCP, DNS and one EthernetUdp
+#ifndef MEMP_NUM_UDP_PCB
+#define MEMP_NUM_UDP_PCB 6
+#endif
+
 // <<< Use Configuration Wizard in Context Menu >>>
 
 // <h> Basic Configuration
@@ -59,7 +156,7 @@
 // <q> Enables IGMP
 // <id> lwip_igmp
 #ifndef LWIP_IGMP
-#define LWIP_IGMP 0
+#define LWIP_IGMP 1
 #endif
 
 // <q> Enables SLIP interface
@@ -397,7 +494,7 @@
 // <q> Enables statistics collection in lwip_stats
 // <id> lwip_stats
 #ifndef LWIP_STATS
-#define LWIP_STATS 0
+#define LWIP_STATS 1
 #endif
 
 // <q> Compile in the statistics output functions
@@ -457,7 +554,7 @@
 // <q> Enable memp.c stats
 // <id> lwip_memp_stats
 #ifndef MEMP_STATS
-#define MEMP_STATS 0
+#define MEMP_STATS 1
 #endif
 
 // <q> Enable system stats
@@ -805,6 +902,31 @@
 #define LWIP_MULTICAST_TX_OPTIONS 1
 #endif
 
+// The GMAC inserts and checks the IP, UDP and TCP checksums, the netif of
+// the GMAC turns them off in lwIP (see ethernetif_init())
+#ifndef CLEARCORE_GMAC_CHECKSUM_OFFLOAD
+#define CLEARCORE_GMAC_CHECKSUM_OFFLOAD 1
+#endif
+
+#ifndef LWIP_CHECKSUM_CTRL_PER_NETIF
+#define LWIP_CHECKSUM_CTRL_PER_NETIF CLEARCORE_GMAC_CHECKSUM_OFFLOAD
+#endif
+
+// Software checksum for everything else (see InetChecksum.h)
+#ifndef LWIP_CHKSUM
+#define LWIP_CHKSUM clearcore_chksum
+#endif
+
+// Sum the TCP data while tcp_write() copies it, only worth it when the
+// GMAC does not insert the TCP checksum anyway
+#ifndef LWIP_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY (!CLEARCORE_GMAC_CHECKSUM_OFFLOAD)
+#endif
+
+#ifndef LWIP_CHKSUM_COPY
+#define LWIP_CHKSUM_COPY(dst, src, len) clearcore_chksum_copy(dst, src, len)
+#endif
+
 #define TCPIP_THREAD_TEST 1
 
 #endif // LWIPOPTS_H
@@ -4,6 +4,8 @@
  *
  ******************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_IO
+
 #include <string.h>
 
 #include "appcontype.h"
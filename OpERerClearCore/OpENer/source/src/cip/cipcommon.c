@@ -438,6 +438,10 @@ void InsertAttribute(CipInstance *const instance,
           (attribute_number) % 8 : 0;
       cip_class->set_bit_mask[index] |= ( (cip_flags & kSetable) ? 1 : 0 ) <<
                                         ( (attribute_number) % 8 );
+      if(NULL != cip_class->attribute_index) {
+        cip_class->attribute_index[attribute_number] =
+          (CipUint) (attribute - instance->attributes + 1);
+      }
 
       return;
     }
@@ -497,23 +501,49 @@ void InsertGetSetCallback(CipClass *const cip_class,
   }
 }
 
-CipAttributeStruct *GetCipAttribute(const CipInstance *const instance,
-                                    const EipUint16 attribute_number) {
+/** @brief Looks an attribute up without a trace when it is not defined
+ *
+ *  The instances of a class insert their attributes in the same order, so
+ *  the attribute index of the class gives the position in the attribute
+ *  array. An instance that inserted them in another order is scanned.
+ */
+static CipAttributeStruct *FindCipAttribute(const CipInstance *const instance,
+                                            const EipUint16 attribute_number) {
+  const CipClass *const cip_class = instance->cip_class;
+  if(NULL != cip_class->attribute_index &&
+     attribute_number <= cip_class->highest_attribute_number) {
+    const CipUint position = cip_class->attribute_index[attribute_number];
+    if(0 == position) {
+      return NULL;
+    }
+    CipAttributeStruct *attribute = &instance->attributes[position - 1];
+    if(attribute_number == attribute->attribute_number &&
+       NULL != attribute->data) {
+      return attribute;
+    }
+  }
 
   CipAttributeStruct *attribute = instance->attributes; /* init pointer to array of attributes*/
-  for(int i = 0; i < instance->cip_class->number_of_attributes; i++) {
-    if(attribute_number == attribute->attribute_number) {
+  for(int i = 0; i < cip_class->number_of_attributes; i++) {
+    if(attribute_number == attribute->attribute_number &&
+       NULL != attribute->data) {
       return attribute;
     } else {
       ++attribute;
     }
   }
-
-  OPENER_TRACE_WARN("attribute %d not defined\n", attribute_number);
-
   return NULL;
 }
 
+CipAttributeStruct *GetCipAttribute(const CipInstance *const instance,
+                                    const EipUint16 attribute_number) {
+  CipAttributeStruct *attribute = FindCipAttribute(instance, attribute_number);
+  if(NULL == attribute) {
+    OPENER_TRACE_WARN("attribute %d not defined\n", attribute_number);
+  }
+  return attribute;
+}
+
 void GenerateGetAttributeSingleHeader(
   const CipMessageRouterRequest *const message_router_request,
   CipMessageRouterResponse *const message_router_response) {
@@ -1148,6 +1178,117 @@ EipStatus GetAttributeAll(CipInstance *instance,
   return kEipStatusOkSend;
 }
 
+/** @brief Bytes in front of the data of an explicit reply: encapsulation
+ *  header (24), interface handle and timeout (6), item count (2), connected
+ *  address item (8), data item header (4), sequence count (2) and Message
+ *  Router reply header (4). The list services fill the rest of
+ *  PC_OPENER_ETHERNET_BUFFER_SIZE.
+ */
+enum {
+  kCipExplicitReplyHeaderLength = 24 + 6 + 2 + 8 + 4 + 2 + 4
+};
+
+/** @brief Most entries of a Get_Attribute_List reply, an entry takes at least
+ *  the attribute number and the status */
+#define CIP_GET_ATTRIBUTE_LIST_MAX \
+  ( (PC_OPENER_ETHERNET_BUFFER_SIZE - kCipExplicitReplyHeaderLength - \
+     sizeof(CipUint) ) / (2 * sizeof(CipUint) ) )
+
+/** @brief Encoded length of an attribute in a reply
+ *
+ *  The length of the standard encoders follows from the attribute data. An
+ *  attribute with its own encoder is encoded into the empty scratch message
+ *  to measure it, at the parity of its position as EncodeCipString() pads to
+ *  an even position.
+ *
+ *  @param attribute the attribute
+ *  @param position position of the attribute data in the reply
+ *  @param scratch message that is empty and stays so
+ *  @return number of bytes encode() adds at that position
+ */
+static size_t GetCipAttributeEncodedLength(
+  const CipAttributeStruct *const attribute,
+  const size_t position,
+  ENIPMessage *const scratch) {
+  const CipAttributeEncodeInMessage encode = attribute->encode;
+  if(EncodeCipBool == encode || EncodeCipByte == encode ||
+     EncodeCipUsint == encode || EncodeCipSint == encode) {
+    return 1;
+  }
+  if(EncodeCipWord == encode || EncodeCipUint == encode ||
+     EncodeCipInt == encode) {
+    return 2;
+  }
+  if(EncodeCipDword == encode || EncodeCipUdint == encode ||
+     EncodeCipDint == encode || EncodeCipReal == encode) {
+    return 4;
+  }
+  if(EncodeCipLword == encode || EncodeCipUlint == encode ||
+     EncodeCipLint == encode || EncodeCipLreal == encode) {
+    return 8;
+  }
+  if(EncodeCipEthernetLinkPhyisicalAddress == encode) {
+    return 6;
+  }
+  if(EncodeCipShortString == encode) {
+    return 1U + ( (const CipShortString *) attribute->data )->length;
+  }
+  if(EncodeCipString == encode) {
+    const size_t length = ( (const CipString *) attribute->data )->length;
+    return 0 == length ? 2U : 2U + length + ( (position + 2U + length) & 1U );
+  }
+  if(EncodeCipByteArray == encode) {
+    return ( (const CipByteArray *) attribute->data )->length;
+  }
+  if(EncodeCipEPath == encode) {
+    return 2U + 2U * ( (const CipEpath *) attribute->data )->path_size;
+  }
+
+  const size_t parity = position & 1U;
+  scratch->current_message_position = scratch->message_buffer + parity;
+  scratch->used_message_length = parity;
+  encode(attribute->data, scratch);
+  const size_t length = scratch->used_message_length - parity;
+  scratch->current_message_position = scratch->message_buffer;
+  scratch->used_message_length = 0;
+  return length;
+}
+
+/** @brief Bytes of attribute data in a Set_Attribute_List request
+ *
+ *  @param type CIP type of the attribute
+ *  @param data attribute data in the request
+ *  @param remaining bytes left in the request
+ *  @return the length, 0 when only the decoder knows it
+ */
+static size_t GetCipAttributeRequestLength(const EipUint8 type,
+                                           const CipOctet *const data,
+                                           const size_t remaining) {
+  switch(type) {
+    case kCipShortString:
+      return 0 < remaining ? 1U + data[0] : 1U;
+    case kCipString: {
+      if(remaining < 2) {
+        return 2;
+      }
+      const size_t length = data[0] | (size_t) data[1] << 8;
+      return 2U + length + (length & 1U);
+    }
+    case kCipAny:
+    case kCipDateAndTime:
+    case kCipString2:
+    case kCipStringN:
+    case kCipEpath:
+    case kCipUdintUdintUdintUdintUdintString:
+    case kCipMemberList:
+    case kCipByteArray:
+    case kCipStringI:
+      return 0;
+    default:
+      return GetCipDataTypeLength(type, NULL);
+  }
+}
+
 EipStatus GetAttributeList(CipInstance *instance,
                            CipMessageRouterRequest *message_router_request,
                            CipMessageRouterResponse *message_router_response,
@@ -1157,100 +1298,107 @@ EipStatus GetAttributeList(CipInstance *instance,
   (void)originator_address;
   (void)encapsulation_session;
 
-  InitializeENIPMessage(&message_router_response->message);
+  ENIPMessage *const message = &message_router_response->message;
+  InitializeENIPMessage(message);
   message_router_response->reply_service =
     (0x80 | message_router_request->service);
   message_router_response->general_status = kCipErrorSuccess;
   message_router_response->size_of_additional_status = 0;
 
-  CipUint attribute_count_request = GetUintFromMessage(
+  if(message_router_request->request_data_size < sizeof(CipUint) ) {
+    message_router_response->general_status = kCipErrorNotEnoughData;
+    return kEipStatusOkSend;
+  }
+  const CipUint attribute_count_request = GetUintFromMessage(
     &message_router_request->data);
+  if(0 == attribute_count_request) {
+    message_router_response->general_status = kCipErrorAttributeListError;
+    return kEipStatusOkSend;
+  }
+  if(message_router_request->request_data_size <
+     sizeof(CipUint) * (1U + attribute_count_request) ) {
+    message_router_response->general_status = kCipErrorNotEnoughData;
+    return kEipStatusOkSend;
+  }
 
-  if(0 != attribute_count_request) {
-
-    EipUint16 attribute_number = 0;
-    CipAttributeStruct *attribute = NULL;
-
-    CipOctet *attribute_count_responst_position =
-      message_router_response->message.current_message_position;
-
-    MoveMessageNOctets(sizeof(CipInt), &message_router_response->message);  // move the message pointer to reserve memory
-
-    for(size_t j = 0; j < attribute_count_request; j++) {
-      attribute_number = GetUintFromMessage(&message_router_request->data);
-      attribute = GetCipAttribute(instance, attribute_number);
-
-      const int_fast64_t needed_message_space = NULL != attribute
-          ? (int_fast64_t) GetCipDataTypeLength(attribute->type,
-                                                attribute->data) : (int_fast64_t) (
-        2
-        *
-        sizeof(
-          CipSint) );
-
-      const int_fast64_t remaining_message_space =
-        (int_fast64_t) PC_OPENER_ETHERNET_BUFFER_SIZE -
-        (int_fast64_t)  message_router_response->message.used_message_length -
-        33LL;                                                                                                                                                                   //need 33 bytes extra space for the rest of the ENIP message
-      if (needed_message_space > remaining_message_space) {
-        message_router_response->message.used_message_length -= 2;  // Correct count from Move above
-        CipOctet *const save_current_position =
-          message_router_response->message.current_message_position;
-        message_router_response->message.current_message_position =
-          attribute_count_responst_position;
-        AddIntToMessage(attribute_count_request,
-                        &message_router_response
-                        ->message);       // Add current amount of attributes
-        message_router_response->message.current_message_position =
-          save_current_position;
-        // If there was not alreay an attribute list error, resturn partial
-        // transfer
-        if (message_router_response->general_status !=
-            kCipErrorAttributeListError) {
-          message_router_response->general_status = kCipErrorPartialTransfer;
-        }
-        return kEipStatusOkSend;
+  /* Resolve the attributes and size the reply, as many as fit are sent. The
+   * PreGetCallback runs here, as the length of the data may depend on it. */
+  const size_t reply_space = PC_OPENER_ETHERNET_BUFFER_SIZE -
+                             kCipExplicitReplyHeaderLength;
+  size_t reply_length = sizeof(CipUint); /* attribute count */
+  CipUint attribute_count_reply = 0;
+  /* Attributes of the entries of the reply, NULL if not supported */
+  CipAttributeStruct *attributes[CIP_GET_ATTRIBUTE_LIST_MAX];
+  const CipOctet *attribute_numbers = message_router_request->data;
+  while(attribute_count_reply < attribute_count_request) {
+    const EipUint16 attribute_number = GetUintFromMessage(&attribute_numbers);
+    CipAttributeStruct *const attribute = FindCipAttribute(instance,
+                                                           attribute_number);
+    const EipBool8 gettable = NULL != attribute &&
+                              (attribute->attribute_flags & kGetableSingle);
+    size_t length = 2 * sizeof(CipUint); /* attribute number and status */
+    if(gettable) {
+      /* Call the PreGetCallback if enabled for this attribute and the class provides one. */
+      if( (attribute->attribute_flags & kPreGetFunc) &&
+          NULL != instance->cip_class->PreGetCallback ) {
+        instance->cip_class->PreGetCallback(instance,
+                                            attribute,
+                                            message_router_request->service);
       }
+      length += GetCipAttributeEncodedLength(attribute,
+                                             reply_length + length,
+                                             message);
+    } else if(NULL == attribute) {
+      OPENER_TRACE_WARN("attribute %d not defined\n", attribute_number);
+    }
+    if(reply_length + length > reply_space) {
+      /* Left out, its PostGetCallback still follows the PreGetCallback */
+      if(gettable && (attribute->attribute_flags & kPostGetFunc) &&
+         NULL != instance->cip_class->PostGetCallback ) {
+        instance->cip_class->PostGetCallback(instance,
+                                             attribute,
+                                             message_router_request->service);
+      }
+      break;
+    }
+    attributes[attribute_count_reply] = attribute;
+    reply_length += length;
+    attribute_count_reply++;
+  }
 
-      AddIntToMessage(attribute_number, &message_router_response->message);  // Attribute-ID
-
-      if(NULL != attribute) {
-        uint8_t get_bit_mask =
-          (instance->cip_class->get_single_bit_mask[CalculateIndex(
-                                                      attribute_number)]);
-        if( 0 != ( get_bit_mask & ( 1 << (attribute_number % 8) ) ) ) { //check if attribute is gettable
-          AddSintToMessage(kCipErrorSuccess, &message_router_response->message); // Attribute status
-          AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-          attribute->encode(attribute->data, &message_router_response->message); // write Attribute data to response
-        } else {
-          AddSintToMessage(kCipErrorAttributeNotGettable,
-                           &message_router_response->message);                                // Attribute status
-          AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-          message_router_response->general_status = kCipErrorAttributeListError;
-        }
+  /* Encode them, the reply fits */
+  AddIntToMessage(attribute_count_reply, message);
+  attribute_numbers = message_router_request->data;
+  for(CipUint j = 0; j < attribute_count_reply; j++) {
+    const EipUint16 attribute_number = GetUintFromMessage(&attribute_numbers);
+    CipAttributeStruct *const attribute = attributes[j];
+    AddIntToMessage(attribute_number, message); // Attribute-ID
+    if(NULL != attribute && (attribute->attribute_flags & kGetableSingle) ) {
+      AddSintToMessage(kCipErrorSuccess, message); // Attribute status
+      AddSintToMessage(0, message); // Reserved, shall be 0
+      attribute->encode(attribute->data, message); // write Attribute data to response
 
-      } else {
-        AddSintToMessage(kCipErrorAttributeNotSupported,
-                         &message_router_response->message);                                 // status
-        AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-        message_router_response->general_status = kCipErrorAttributeListError;
+      /* Call the PostGetCallback if enabled for this attribute and the class provides one. */
+      if( (attribute->attribute_flags & kPostGetFunc) &&
+          NULL != instance->cip_class->PostGetCallback ) {
+        instance->cip_class->PostGetCallback(instance,
+                                             attribute,
+                                             message_router_request->service);
       }
+    } else {
+      AddSintToMessage(NULL == attribute ? kCipErrorAttributeNotSupported :
+                       kCipErrorAttributeNotGettable, message); // Attribute status
+      AddSintToMessage(0, message); // Reserved, shall be 0
+      message_router_response->general_status = kCipErrorAttributeListError;
     }
-    // If we are there, we returned all elements
-    message_router_response->message.used_message_length -= 2;  // Correct count from Move above
-    CipOctet *const save_current_position =
-      message_router_response->message.current_message_position;
-    message_router_response->message.current_message_position =
-      attribute_count_responst_position;
-    AddIntToMessage(
-      attribute_count_request,
-      &message_router_response->message);    // Add current amount of attributes
-    message_router_response->message.current_message_position =
-      save_current_position;
-  } else {
-    message_router_response->general_status = kCipErrorAttributeListError;
   }
+  OPENER_ASSERT(reply_length == message->used_message_length);
 
+  // If there was not already an attribute list error, return partial transfer
+  if(attribute_count_reply < attribute_count_request &&
+     kCipErrorAttributeListError != message_router_response->general_status) {
+    message_router_response->general_status = kCipErrorPartialTransfer;
+  }
   return kEipStatusOkSend;
 }
 
@@ -1263,113 +1411,129 @@ EipStatus SetAttributeList(CipInstance *instance,
   (void)originator_address;
   (void)encapsulation_session;
 
-  InitializeENIPMessage(&message_router_response->message);
+  ENIPMessage *const message = &message_router_response->message;
+  InitializeENIPMessage(message);
   message_router_response->reply_service =
     (0x80 | message_router_request->service);
   message_router_response->general_status = kCipErrorSuccess;
   message_router_response->size_of_additional_status = 0;
 
-  CipUint attribute_count_request = GetUintFromMessage(
+  if(message_router_request->request_data_size < sizeof(CipUint) ) {
+    message_router_response->general_status = kCipErrorNotEnoughData;
+    return kEipStatusOkSend;
+  }
+  const CipUint attribute_count_request = GetUintFromMessage(
     &message_router_request->data);
+  if(0 == attribute_count_request) {
+    message_router_response->general_status = kCipErrorAttributeListError;
+    return kEipStatusOkSend;
+  }
 
-  if(0 != attribute_count_request) {
-
-    EipUint16 attribute_number = 0;
-    CipAttributeStruct *attribute = NULL;
-
-    CipOctet *attribute_count_responst_position =
-      message_router_response->message.current_message_position;
-
-    MoveMessageNOctets(sizeof(CipInt), &message_router_response->message);  // move the message pointer to reserve memory
-
-    for(size_t j = 0; j < attribute_count_request; j++) {
-      attribute_number = GetUintFromMessage(&message_router_request->data);
-      attribute = GetCipAttribute(instance, attribute_number);
-
-      const int_fast64_t needed_message_space = NULL != attribute
-          ? (int_fast64_t) GetCipDataTypeLength(attribute->type,
-                                                attribute->data) : (int_fast64_t) (
-        2
-        *
-        sizeof(
-          CipSint) );
-
-      const int_fast64_t remaining_message_space =
-        (int_fast64_t) PC_OPENER_ETHERNET_BUFFER_SIZE -
-        (int_fast64_t)  message_router_response->message.used_message_length -
-        33LL;                                                                                                                                                                   //need 33 bytes extra space for the rest of the ENIP message
-      if (needed_message_space > remaining_message_space) {
-        message_router_response->message.used_message_length -= 2;   // Correct count from Move above
-        CipOctet *const save_current_position =
-          message_router_response->message.current_message_position;
-        message_router_response->message.current_message_position =
-          attribute_count_responst_position;
-        AddIntToMessage(attribute_count_request,
-                        &message_router_response
-                        ->message);       // Add current amount of attributes
-        message_router_response->message.current_message_position =
-          save_current_position;
-        // If there was not alreay an attribute list error, resturn partial
-        // transfer
-        if (message_router_response->general_status !=
-            kCipErrorAttributeListError) {
-          message_router_response->general_status = kCipErrorPartialTransfer;
-        }
-        return kEipStatusOkSend;
-      }
+  /* Every attribute has four bytes in the reply, as many as fit are set */
+  const size_t reply_space = PC_OPENER_ETHERNET_BUFFER_SIZE -
+                             kCipExplicitReplyHeaderLength;
+  CipUint attribute_count_limit = attribute_count_request;
+  if(sizeof(CipUint) * (1U + 2U * attribute_count_limit) > reply_space) {
+    attribute_count_limit = (CipUint) ( (reply_space - sizeof(CipUint) ) /
+                                        (2 * sizeof(CipUint) ) );
+  }
 
-      AddIntToMessage(attribute_number, &message_router_response->message); // Attribute-ID
+  CipOctet *const attribute_count_position = message->current_message_position;
+  MoveMessageNOctets(sizeof(CipUint), message);  // reserve the attribute count
 
-      if(NULL != attribute) {
+  size_t remaining = message_router_request->request_data_size -
+                     sizeof(CipUint);
+  CipUint attribute_count_reply = 0;
+  bool stop = false;
+  while(!stop && attribute_count_reply < attribute_count_limit) {
+    if(remaining < sizeof(CipUint) ) {
+      message_router_response->general_status = kCipErrorNotEnoughData;
+      break;
+    }
+    const EipUint16 attribute_number = GetUintFromMessage(
+      &message_router_request->data);
+    remaining -= sizeof(CipUint);
+    CipAttributeStruct *const attribute = FindCipAttribute(instance,
+                                                           attribute_number);
+    AddIntToMessage(attribute_number, message); // Attribute-ID
+    attribute_count_reply++;
+
+    CipUsint attribute_status = kCipErrorSuccess;
+    if(NULL == attribute) {
+      /* the length of its data is unknown, the next attribute cannot be found */
+      OPENER_TRACE_WARN("attribute %d not defined\n", attribute_number);
+      attribute_status = kCipErrorAttributeNotSupported;
+      stop = true;
+    } else {
+      const size_t data_length = GetCipAttributeRequestLength(attribute->type,
+                                                              message_router_request->data,
+                                                              remaining);
+      if(data_length > remaining) {
+        attribute_status = kCipErrorNotEnoughData;
+        stop = true;
+      } else if(0 == (attribute->attribute_flags & kSetable) ) {
+        attribute_status = kCipErrorAttributeNotSetable;
+        message_router_request->data += data_length;
+        remaining -= data_length;
+        stop = (0 == data_length);
+      } else {
+        /* Call the PreSetCallback if enabled for this attribute and the class provides one. */
+        if( (attribute->attribute_flags & kPreSetFunc) &&
+            NULL != instance->cip_class->PreSetCallback ) {
+          instance->cip_class->PreSetCallback(instance,
+                                              attribute,
+                                              message_router_request->service);
+        }
 
-        uint8_t set_bit_mask =
-          (instance->cip_class->set_bit_mask[CalculateIndex(attribute_number)]);
-        if( 0 != ( set_bit_mask & ( 1 << (attribute_number % 8) ) ) ) { //check if attribute is settable
-          AddSintToMessage(kCipErrorSuccess, &message_router_response->message); // Attribute status
-          AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-          attribute->decode(attribute->data,
-                            message_router_request,
-                            message_router_response);                                          // write data to attribute
+        /* the decoder sets the general status, it becomes the attribute status */
+        const CipUsint list_status = message_router_response->general_status;
+        const CipOctet *const attribute_data = message_router_request->data;
+        message_router_request->request_data_size = remaining;
+        message_router_response->general_status = kCipErrorSuccess;
+        const int decoded = attribute->decode(attribute->data,
+                                              message_router_request,
+                                              message_router_response); // write data to attribute
+        attribute_status = message_router_response->general_status;
+        message_router_response->general_status = list_status;
+
+        const size_t consumed = (size_t) (message_router_request->data -
+                                          attribute_data);
+        if(decoded < 0 || consumed > remaining) {
+          if(kCipErrorSuccess == attribute_status) {
+            attribute_status = kCipErrorNotEnoughData;
+          }
+          stop = true;
         } else {
-          AddSintToMessage(kCipErrorAttributeNotSetable,
-                           &message_router_response->message);                               // Attribute status
-          AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-
-          //move request message pointer
-          size_t attribute_data_length = GetCipDataTypeLength(attribute->type,
-                                                              message_router_request->data);
-          if(0 != attribute_data_length) {
-            message_router_request->data += attribute_data_length;
-            message_router_response->general_status =
-              kCipErrorAttributeListError;
-          } else {
-            message_router_response->general_status = kCipErrorPartialTransfer;
-            return kEipStatusOkSend;
+          remaining -= consumed;
+          /* Call the PostSetCallback if enabled for this attribute and the class provides one. */
+          if(kCipErrorSuccess == attribute_status &&
+             (attribute->attribute_flags & (kPostSetFunc | kNvDataFunc) ) &&
+             NULL != instance->cip_class->PostSetCallback) {
+            instance->cip_class->PostSetCallback(instance,
+                                                 attribute,
+                                                 message_router_request->service);
           }
         }
-      } else {
-        AddSintToMessage(kCipErrorAttributeNotSupported,
-                         &message_router_response->message);                                 // status
-        AddSintToMessage(0, &message_router_response->message); // Reserved, shall be 0
-        message_router_response->general_status = kCipErrorAttributeListError;
       }
     }
-    // If we are there, we returned all elements
-    message_router_response->message.used_message_length -=
-      2;    // Correct count from Move above
-    CipOctet *const save_current_position =
-      message_router_response->message.current_message_position;
-    message_router_response->message.current_message_position =
-      attribute_count_responst_position;
-    AddIntToMessage(
-      attribute_count_request,
-      &message_router_response->message);    // Add current amount of attributes
-    message_router_response->message.current_message_position =
-      save_current_position;
-  } else {
-    message_router_response->general_status = kCipErrorAttributeListError;
+    AddSintToMessage(attribute_status, message); // Attribute status
+    AddSintToMessage(0, message); // Reserved, shall be 0
+    if(kCipErrorSuccess != attribute_status) {
+      message_router_response->general_status = kCipErrorAttributeListError;
+    }
   }
 
+  CipOctet *const save_current_position = message->current_message_position;
+  message->current_message_position = attribute_count_position;
+  message->used_message_length -= sizeof(CipUint);
+  AddIntToMessage(attribute_count_reply, message);  // Add current amount of attributes
+  message->current_message_position = save_current_position;
+
+  // If there was not already an attribute list error, return partial transfer
+  if(attribute_count_reply < attribute_count_request &&
+     kCipErrorSuccess == message_router_response->general_status) {
+    message_router_response->general_status = kCipErrorPartialTransfer;
+  }
   return kEipStatusOkSend;
 }
 
@@ -1652,6 +1816,8 @@ void AllocateAttributeMasks(CipClass *target_class) {
   target_class->get_single_bit_mask = CipCalloc( size, sizeof(uint8_t) );
   target_class->set_bit_mask = CipCalloc( size, sizeof(uint8_t) );
   target_class->get_all_bit_mask = CipCalloc( size, sizeof(uint8_t) );
+  target_class->attribute_index = CipCalloc(
+    1 + target_class->highest_attribute_number, sizeof(CipUint) );
 }
 
 size_t CalculateIndex(EipUint16 attribute_number) {
@@ -115,6 +115,8 @@ EipStatus GetAttributeAll(CipInstance *instance,
  *
  * Copy the contents of the selected gettable attributes of the specified
  * object class or instance into the global message buffer.
+ * The reply is sized before anything is encoded, the attributes that do not
+ * fit into a reply are left out with the status Partial Transfer.
  * @param instance pointer to object instance with data.
  * @param message_router_request pointer to MR request.
  * @param message_router_response pointer for MR response.
@@ -133,6 +135,8 @@ EipStatus GetAttributeList(CipInstance *instance,
  *
  * Sets the values of selected attributes of the specified object class
  * or instance.
+ * The list ends early at an attribute whose data cannot be skipped, e.g. one
+ * that is not supported, and at a reply that would not fit.
  * @param instance pointer to object instance with data.
  * @param message_router_request pointer to MR request.
  * @param message_router_response pointer to MR response.
@@ -3,11 +3,14 @@
  * All rights reserved.
  *
  ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_CONNECTION_MANAGER
+
 #include <string.h>
 #include <stdbool.h>
 
 #ifdef CLEARCORE
 #include "socket_types.h"
+#include "ports/ClearCore/clearcore_arppin.h"
 #endif
 #include "cipconnectionmanager.h"
 #include "opener_user_conf.h"
@@ -1803,6 +1806,12 @@ void AddNewActiveConnection(CipConnectionObject *const connection_object) {
   DoublyLinkedListInsertAtHead(&connection_list, connection_object);
   ConnectionObjectSetState(connection_object,
                            kConnectionObjectStateEstablished);
+#ifdef CLEARCORE
+  /* produced frames shall not wait for ARP while the connection lives */
+  if(ConnectionObjectIsTypeIOConnection(connection_object) ) {
+    ClearCoreArpPin(connection_object->originator_address.sin_addr.s_addr);
+  }
+#endif
 }
 
 void RemoveFromActiveConnections(CipConnectionObject *const connection_object) {
@@ -1810,6 +1819,11 @@ void RemoveFromActiveConnections(CipConnectionObject *const connection_object) {
       iterator = iterator->next) {
     if(iterator->data == connection_object) {
       DoublyLinkedListRemoveNode(&connection_list, &iterator);
+#ifdef CLEARCORE
+      if(ConnectionObjectIsTypeIOConnection(connection_object) ) {
+        ClearCoreArpUnpin(connection_object->originator_address.sin_addr.s_addr);
+      }
+#endif
       return;
     }
   } OPENER_TRACE_ERR("Connection not found in active connection list\n");
@@ -1877,10 +1891,13 @@ EipStatus TriggerConnections(unsigned int output_assembly,
     CipConnectionObject *connection_object = node->data;
     if( (output_assembly == connection_object->consumed_path.instance_id) &&
         (input_assembly == connection_object->produced_path.instance_id) ) {
-      if(
-        kConnectionObjectTransportClassTriggerProductionTriggerApplicationObject
-        == ConnectionObjectGetTransportClassTriggerProductionTrigger(
-          connection_object) ) {
+      const ConnectionObjectTransportClassTriggerProductionTrigger trigger =
+        ConnectionObjectGetTransportClassTriggerProductionTrigger(
+          connection_object);
+      if( (kConnectionObjectTransportClassTriggerProductionTriggerApplicationObject
+           == trigger) ||
+          (kConnectionObjectTransportClassTriggerProductionTriggerChangeOfState
+           == trigger) ) {
         /* produce at the next allowed occurrence */
         connection_object->transmission_trigger_timer =
           connection_object->production_inhibit_time;
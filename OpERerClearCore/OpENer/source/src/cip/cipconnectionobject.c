@@ -4,6 +4,8 @@
  *
  ******************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_CONNECTION_MANAGER
+
 #include <string.h>
 
 #ifdef CLEARCORE
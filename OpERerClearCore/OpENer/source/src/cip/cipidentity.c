@@ -37,6 +37,7 @@
 #include "endianconv.h"
 #include "opener_api.h"
 #include "trace.h"
+#include "encap.h"
 
 /** @brief The device's configuration data for the Identity Object */
 #include "devicedata.h"
@@ -59,32 +60,38 @@ CipIdentityObject g_identity = { .vendor_id = OPENER_DEVICE_VENDOR_ID, /* Attrib
 void SetDeviceRevision(EipUint8 major, EipUint8 minor) {
   g_identity.revision.major_revision = major;
   g_identity.revision.minor_revision = minor;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
 void SetDeviceSerialNumber(const EipUint32 serial_number) {
   g_identity.serial_number = serial_number;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
 void SetDeviceType(const EipUint16 type) {
   g_identity.device_type = type;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
 void SetDeviceProductCode(const EipUint16 code) {
   g_identity.product_code = code;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
 void SetDeviceStatus(const CipWord status) {
   g_identity.status = status;
   g_identity.ext_status = status & kExtStatusMask;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
 void SetDeviceVendorId(CipUint vendor_id) {
   g_identity.vendor_id = vendor_id;
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
@@ -98,6 +105,7 @@ void SetDeviceProductName(const char *product_name) {
     return;
 
   SetCipShortStringByCstr(&g_identity.product_name, product_name);
+  InvalidateListIdentityCache();
 }
 
 /* The Doxygen comment is with the function's prototype in opener_api.h. */
@@ -116,6 +124,7 @@ static inline void MergeStatusAndExtStatus(void) {
     ext_status = kMajorFault;
   }
   g_identity.status = status_flags | ext_status;
+  InvalidateListIdentityCache();
 }
 
 /** @brief Set status flags of the device's Status word
@@ -4,6 +4,8 @@
  *
  ******************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_IO
+
 #ifdef CLEARCORE
 #include "ports/ClearCore/socket_types.h"
 #endif
@@ -512,8 +514,9 @@ EipStatus OpenProducingMulticastConnection(
     return kEipStatusError;
   }
 
+  /* keep the port of a T->O item sent by the originator, 2222 otherwise */
   uint16_t port = htons(kOpenerEipIoUdpPort);
-  if(kCipItemIdSocketAddressInfoTargetToOriginator != sock_addr_info->type_id) {
+  if(kCipItemIdSocketAddressInfoTargetToOriginator == sock_addr_info->type_id) {
     port = sock_addr_info->sin_port;
   }
 
@@ -540,6 +543,14 @@ EipStatus OpenProducingMulticastConnection(
       existing_connection_object->socket[kUdpCommuncationDirectionProducing];
     existing_connection_object->socket[kUdpCommuncationDirectionProducing] =
       kEipInvalidSocket;
+    /* continue the stream the consumers already receive, one frame per RPI
+     * and no gap in the sequence counts */
+    connection_object->eip_level_sequence_count_producing =
+      existing_connection_object->eip_level_sequence_count_producing;
+    connection_object->sequence_count_producing =
+      existing_connection_object->sequence_count_producing;
+    connection_object->transmission_trigger_timer =
+      existing_connection_object->transmission_trigger_timer;
   } else { /* this connection will not produce the data */
     connection_object->socket[kUdpCommuncationDirectionProducing] =
       kEipInvalidSocket;
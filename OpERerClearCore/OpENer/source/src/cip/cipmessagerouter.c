@@ -292,6 +292,7 @@ void DeleteAllClasses(void) {
     CipFree(meta_class->get_single_bit_mask);
     CipFree(meta_class->set_bit_mask);
     CipFree(meta_class->get_all_bit_mask);
+    CipFree(meta_class->attribute_index);
     CipFree(meta_class);
 
     /* free class data*/
@@ -300,6 +301,7 @@ void DeleteAllClasses(void) {
     CipFree(cip_class->get_single_bit_mask);
     CipFree(cip_class->set_bit_mask);
     CipFree(cip_class->get_all_bit_mask);
+    CipFree(cip_class->attribute_index);
     CipFree(cip_class->class_instance.attributes);
     CipFree(cip_class->services);
     CipFree(cip_class);
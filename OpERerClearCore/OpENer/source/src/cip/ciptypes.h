@@ -383,6 +383,9 @@ typedef struct cip_class {
   uint8_t *get_single_bit_mask;   /**< bit mask for GetAttributeSingle */
   uint8_t *set_bit_mask;   /**< bit mask for SetAttributeSingle */
   uint8_t *get_all_bit_mask;   /**< bit mask for GetAttributeAll */
+  CipUint *attribute_index;   /**< position + 1 of each attribute number in
+                                  the attribute arrays of the instances, 0 if
+                                  not inserted */
 
   EipUint16 number_of_services;   /**< number of services supported */
   CipInstance *instances;   /**< pointer to the list of instances */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Helpers shared by the vendor specific objects of the ClearCore
+ *
+ ******************************************************************************/
+
+#include "cipvendorobject.h"
+
+#include "opener_api.h"
+#include "ciperror.h"
+#include "enipmessage.h"
+
+void InsertVendorAttributes(CipInstance *const instance,
+                            const CipVendorAttribute *const table,
+                            const size_t count) {
+  CipOctet *const base = (CipOctet *) instance->data;
+  for(size_t i = 0; i < count; ++i) {
+    const CipVendorAttribute *const attribute = &table[i];
+    InsertAttribute(instance,
+                    attribute->attribute_number,
+                    attribute->type,
+                    attribute->encode,
+                    attribute->decode,
+                    base + attribute->offset,
+                    attribute->flags);
+  }
+}
+
+EipBool8 VendorAttributeSampleDue(const CipAttributeStruct *const attribute,
+                                  const CipByte service,
+                                  const CipUint first_live_attribute) {
+  return (kGetAttributeAll != service) ||
+         (first_live_attribute == attribute->attribute_number);
+}
+
+void GenerateVendorServiceResponseHeader(
+  const CipMessageRouterRequest *const message_router_request,
+  CipMessageRouterResponse *const message_router_response) {
+  InitializeENIPMessage(&message_router_response->message);
+  message_router_response->reply_service =
+    (0x80 | message_router_request->service);
+  message_router_response->general_status = kCipErrorSuccess;
+  message_router_response->size_of_additional_status = 0;
+}
+
+EipBool8 CheckVendorServiceDataSize(
+  const CipMessageRouterRequest *const message_router_request,
+  CipMessageRouterResponse *const message_router_response,
+  const size_t minimum_size,
+  const size_t maximum_size) {
+  if(message_router_request->request_data_size < minimum_size) {
+    message_router_response->general_status = kCipErrorNotEnoughData;
+    return false;
+  }
+  if(message_router_request->request_data_size > maximum_size) {
+    message_router_response->general_status = kCipErrorTooMuchData;
+    return false;
+  }
+  return true;
+}
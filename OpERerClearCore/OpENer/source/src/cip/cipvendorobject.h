@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Helpers shared by the vendor specific objects of the ClearCore
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPVENDOROBJECT_H_
+#define OPENER_CIPVENDOROBJECT_H_
+
+/** @file cipvendorobject.h
+ *  @brief Table driven instance attributes and service helpers
+ *
+ *  The vendor specific objects keep the data of an instance in one struct,
+ *  which CipInstance::data points to, and describe their instance
+ *  attributes by a constant table of offsets into that struct. The table is
+ *  shared by all instances of the object.
+ */
+
+#include <stddef.h>
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Description of one instance attribute of a vendor specific object
+ *
+ *  The data of the attribute is located at @ref offset inside of the
+ *  instance data. An attribute without @ref decode is read only.
+ */
+typedef struct {
+  CipUint attribute_number;
+  CipUsint type;
+  CipAttributeEncodeInMessage encode;
+  CipAttributeDecodeFromMessage decode;
+  size_t offset;
+  CipByte flags;
+} CipVendorAttribute;
+
+/** @brief Number of entries of an attribute table */
+#define CIP_VENDOR_ATTRIBUTE_COUNT(table) \
+  (sizeof(table) / sizeof( (table)[0]) )
+
+/** @brief Insert the attributes of a table into an instance
+ *
+ *  @param instance instance whose data the offsets of the table refer to
+ *  @param table attribute table of the object
+ *  @param count number of entries of @p table
+ */
+void InsertVendorAttributes(CipInstance *const instance,
+                            const CipVendorAttribute *const table,
+                            const size_t count);
+
+/** @brief Tell the PreGetCallback of an object whether to take a new sample
+ *
+ *  Objects whose live attributes are all read from one sample of the
+ *  hardware take it for every Get_Attribute_Single and Get_Attribute_List
+ *  entry, but only once per Get_Attributes_All reply. That service encodes
+ *  the attributes in the order of the table, so the sample is taken for the
+ *  first live attribute and reused for the others.
+ *
+ *  @param attribute attribute about to be encoded
+ *  @param service service code of the request
+ *  @param first_live_attribute lowest attribute number read from the sample
+ *  @return true if the sample is to be taken
+ */
+EipBool8 VendorAttributeSampleDue(const CipAttributeStruct *const attribute,
+                                  const CipByte service,
+                                  const CipUint first_live_attribute);
+
+/** @brief Initialize the reply of a vendor specific service as a success
+ *  without data
+ *
+ *  @param message_router_request request being served
+ *  @param message_router_response reply to initialize
+ */
+void GenerateVendorServiceResponseHeader(
+  const CipMessageRouterRequest *const message_router_request,
+  CipMessageRouterResponse *const message_router_response);
+
+/** @brief Check the request data size of a vendor specific service
+ *
+ *  @param message_router_request request being served
+ *  @param message_router_response reply whose status is set on a mismatch
+ *  @param minimum_size fewest data bytes the service takes
+ *  @param maximum_size most data bytes the service takes
+ *  @return true if the size is in range, otherwise the status of the reply
+ *  is Not Enough Data or Too Much Data
+ */
+EipBool8 CheckVendorServiceDataSize(
+  const CipMessageRouterRequest *const message_router_request,
+  CipMessageRouterResponse *const message_router_response,
+  const size_t minimum_size,
+  const size_t maximum_size);
+
+#endif /* OPENER_CIPVENDOROBJECT_H_ */
@@ -0,0 +1,315 @@
+/*******************************************************************************
+ * Analog Input Object for the ClearCore analog inputs
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipanalog.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_analog.h"
+
+/** @brief Run time data of one Analog Input instance
+ *
+ *  The live attributes are computed from @ref sample, which is refreshed
+ *  from the AdcManager in one call by the PreGetCallback.
+ */
+typedef struct {
+  CipUsint channel; /**< ClearCoreAnalog channel, instance number - 1 */
+  ClearCoreAnalogSample sample; /**< last sample of the input */
+  CipBool analog; /**< Attr. #1: connector in the analog input mode */
+  CipDint value; /**< Attr. #2: scaled filtered value */
+  CipUdint timestamp_us; /**< Attr. #3 */
+  CipDint decimated_value; /**< Attr. #4: scaled decimated value */
+  CipUdint decimated_timestamp_us; /**< Attr. #5 */
+  CipUint filter_ms; /**< Attr. #6: filter rise time */
+  CipUsint oversampling; /**< Attr. #7: oversampling, power of two */
+  CipUint decimation; /**< Attr. #8: results per decimated value */
+  CipDint scale; /**< Attr. #9: value at Q15 full scale */
+  CipDint offset; /**< Attr. #10: value at 0 V */
+  CipUsint assembly_value; /**< Attr. #11: AnalogAssemblyValue */
+} CipAnalogInput;
+
+/* Longest filter rise time that fits the filter's sample count */
+#define ANALOG_FILTER_MS_MAX 10000U
+
+#define ANALOG_DEFAULT_FILTER_MS 2U /* AdcManager::ADC_IIR_FILTER_TC_MS */
+#define ANALOG_DEFAULT_SCALE 10000 /* millivolts */
+
+/* Attributes that are sampled from the AdcManager on every Get */
+#define ANALOG_LIVE (kGetableSingleAndAll | kPreGetFunc)
+/* Attributes that are pushed to the AdcManager after every Set */
+#define ANALOG_SETTABLE (kSetAndGetAble | kPostSetFunc)
+
+static int DecodeAnalogFilterMs(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response);
+static int DecodeAnalogOversampling(void *const data,
+                                    CipMessageRouterRequest *const message_router_request,
+                                    CipMessageRouterResponse *const message_router_response);
+static int DecodeAnalogDecimation(void *const data,
+                                  CipMessageRouterRequest *const message_router_request,
+                                  CipMessageRouterResponse *const message_router_response);
+static int DecodeAnalogAssemblyValue(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response);
+
+/** @brief Attribute table of the instances */
+static const CipVendorAttribute kAnalogAttributes[] = {
+  { 1, kCipBool, EncodeCipBool, (CipAttributeDecodeFromMessage)DecodeCipBool,
+    offsetof(CipAnalogInput, analog), ANALOG_LIVE | ANALOG_SETTABLE },
+  { 2, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipAnalogInput, value), ANALOG_LIVE },
+  { 3, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipAnalogInput, timestamp_us), ANALOG_LIVE },
+  { 4, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipAnalogInput, decimated_value), ANALOG_LIVE },
+  { 5, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipAnalogInput, decimated_timestamp_us), ANALOG_LIVE },
+  { 6, kCipUint, EncodeCipUint, DecodeAnalogFilterMs,
+    offsetof(CipAnalogInput, filter_ms), ANALOG_SETTABLE },
+  { 7, kCipUsint, EncodeCipUsint, DecodeAnalogOversampling,
+    offsetof(CipAnalogInput, oversampling), kSetAndGetAble },
+  { 8, kCipUint, EncodeCipUint, DecodeAnalogDecimation,
+    offsetof(CipAnalogInput, decimation), ANALOG_SETTABLE },
+  { 9, kCipDint, EncodeCipDint, (CipAttributeDecodeFromMessage)DecodeCipDint,
+    offsetof(CipAnalogInput, scale), kSetAndGetAble },
+  { 10, kCipDint, EncodeCipDint, (CipAttributeDecodeFromMessage)DecodeCipDint,
+    offsetof(CipAnalogInput, offset), kSetAndGetAble },
+  { 11, kCipUsint, EncodeCipUsint, DecodeAnalogAssemblyValue,
+    offsetof(CipAnalogInput, assembly_value), kSetAndGetAble },
+};
+
+#define ANALOG_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kAnalogAttributes)
+
+/** @brief Lowest live attribute; a Get_Attributes_All reads the filtered and
+ *  the decimated result of the channel in one ClearCoreAnalogSampleRead, so
+ *  that the values and timestamps of the reply come from the same ADC pass */
+static const CipUint kAnalogFirstLiveAttribute = 1U;
+
+static CipAnalogInput s_analog[CLEARCORE_ANALOG_CHANNELS];
+static CipOctet s_analog_assembly[CIP_ANALOG_INPUT_ASSEMBLY_SIZE];
+
+/** @brief Scale a Q15 result, offset + result * scale / 32768 */
+static CipDint AnalogScale(const CipAnalogInput *const input,
+                           const CipUint result) {
+  const int64_t scaled = (int64_t) result * input->scale;
+  return input->offset + (CipDint) (scaled / 32768);
+}
+
+/** @brief Refresh the sample and the live attributes of an instance */
+static void AnalogRefresh(CipAnalogInput *const input) {
+  ClearCoreAnalogSampleRead(input->channel, &input->sample);
+  input->analog = input->sample.analog;
+  input->value = AnalogScale(input, input->sample.filtered);
+  input->timestamp_us = input->sample.timestamp_us;
+  input->decimated_value = AnalogScale(input, input->sample.decimated);
+  input->decimated_timestamp_us = input->sample.decimated_timestamp_us;
+}
+
+static int DecodeAnalogFilterMs(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response)
+{
+  const CipUint filter_ms = GetUintFromMessage(&message_router_request->data);
+  if( (0 == filter_ms) || (filter_ms > ANALOG_FILTER_MS_MAX) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUint *) data = filter_ms;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 2;
+}
+
+/** @brief Apply the oversampling right away, it may not fit next to the
+ *  oversampling of the other channels */
+static int DecodeAnalogOversampling(void *const data,
+                                    CipMessageRouterRequest *const message_router_request,
+                                    CipMessageRouterResponse *const message_router_response)
+{
+  CipAnalogInput *const input = (CipAnalogInput *) ( (CipOctet *) data -
+                                                     offsetof(CipAnalogInput,
+                                                              oversampling) );
+  const CipUsint oversampling =
+    GetUsintFromMessage(&message_router_request->data);
+  if(oversampling > CLEARCORE_ANALOG_OVERSAMPLING_MAX) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  if( !ClearCoreAnalogOversampling(input->channel, oversampling) ) {
+    OPENER_TRACE_WARN("Analog: oversampling 2^%u on channel %u rejected\n",
+                      oversampling, input->channel);
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+    return -1;
+  }
+  input->oversampling = oversampling;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeAnalogDecimation(void *const data,
+                                  CipMessageRouterRequest *const message_router_request,
+                                  CipMessageRouterResponse *const message_router_response)
+{
+  const CipUint decimation = GetUintFromMessage(&message_router_request->data);
+  if( (0 == decimation) || (decimation > CLEARCORE_ANALOG_DECIMATION_MAX) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUint *) data = decimation;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 2;
+}
+
+static int DecodeAnalogAssemblyValue(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint value = GetUsintFromMessage(&message_router_request->data);
+  if( (kAnalogAssemblyFiltered != value) &&
+      (kAnalogAssemblyDecimated != value) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = value;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static void AnalogPutUdint(CipOctet *const buffer,
+                           const CipUdint value) {
+  buffer[0] = (CipOctet) value;
+  buffer[1] = (CipOctet) (value >> 8);
+  buffer[2] = (CipOctet) (value >> 16);
+  buffer[3] = (CipOctet) (value >> 24);
+}
+
+EipStatus AnalogPreGetCallback(CipInstance *const instance,
+                               CipAttributeStruct *const attribute,
+                               CipByte service) {
+  CipAnalogInput *const input = (CipAnalogInput *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kAnalogFirstLiveAttribute) ) {
+    AnalogRefresh(input);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus AnalogPostSetCallback(CipInstance *const instance,
+                                CipAttributeStruct *const attribute,
+                                CipByte service) {
+  (void) service;
+  CipAnalogInput *const input = (CipAnalogInput *) instance->data;
+
+  switch(attribute->attribute_number) {
+    case 1:
+      if( !ClearCoreAnalogEnable(input->channel, input->analog) ) {
+        OPENER_TRACE_WARN("Analog: mode of channel %u rejected\n",
+                          input->channel);
+      }
+      break;
+    case 6:
+      ClearCoreAnalogFilterMs(input->channel, input->filter_ms);
+      break;
+    case 8:
+      ClearCoreAnalogDecimation(input->channel, input->decimation);
+      break;
+    default:
+      break;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CipAnalogInit(void) {
+  CipClass *analog_class = NULL;
+
+  if( ( analog_class = CreateCipClass(kCipAnalogClassCode,
+                                      7, /* # class attributes */
+                                      7, /* # highest class attribute number */
+                                      2, /* # class services */
+                                      ANALOG_ATTRIBUTE_COUNT, /* # instance attributes */
+                                      11, /* # highest instance attribute number */
+                                      3, /* # instance services */
+                                      CLEARCORE_ANALOG_CHANNELS, /* # instances */
+                                      "Analog Input",
+                                      1, /* # class revision */
+                                      NULL /* # function pointer for initialization */
+                                      ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  memset(s_analog, 0, sizeof(s_analog) );
+  memset(s_analog_assembly, 0, sizeof(s_analog_assembly) );
+#if defined(CLEARCORE_ANALOG_BLOCK_MODE) && 0 != CLEARCORE_ANALOG_BLOCK_MODE
+  ClearCoreAnalogBlockMode(1);
+#endif
+
+  for(CipUsint channel = 0; channel < CLEARCORE_ANALOG_CHANNELS; ++channel) {
+    CipAnalogInput *const input = &s_analog[channel];
+    input->channel = channel;
+    input->filter_ms = ANALOG_DEFAULT_FILTER_MS;
+    input->decimation = 1;
+    input->scale = ANALOG_DEFAULT_SCALE;
+    input->assembly_value = kAnalogAssemblyFiltered;
+    ClearCoreAnalogFilterMs(channel, input->filter_ms);
+    ClearCoreAnalogDecimation(channel, input->decimation);
+    AnalogRefresh(input);
+
+    CipInstance *const instance = GetCipInstance(analog_class, channel + 1);
+    instance->data = input;
+    InsertVendorAttributes(instance, kAnalogAttributes, ANALOG_ATTRIBUTE_COUNT);
+  }
+
+  CreateAssemblyObject(kAnalogInputAssembly,
+                       s_analog_assembly,
+                       sizeof(s_analog_assembly) );
+
+  InsertGetSetCallback(analog_class, AnalogPreGetCallback, kPreGetFunc);
+  InsertGetSetCallback(analog_class, AnalogPostSetCallback, kPostSetFunc);
+
+  InsertService(analog_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(analog_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(analog_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+
+  return kEipStatusOk;
+}
+
+EipBool8 CipAnalogBeforeAssemblyDataSend(CipInstanceNum assembly_instance) {
+  if(kAnalogInputAssembly != assembly_instance) {
+    return false;
+  }
+
+  CipOctet *const data = s_analog_assembly;
+  CipUsint modes = 0;
+  for(CipUsint channel = 0; channel < CLEARCORE_ANALOG_CHANNELS; ++channel) {
+    CipAnalogInput *const input = &s_analog[channel];
+    AnalogRefresh(input);
+    if(kAnalogAssemblyDecimated == input->assembly_value) {
+      AnalogPutUdint(&data[channel * 8], (CipUdint) input->decimated_value);
+      AnalogPutUdint(&data[channel * 8 + 4], input->decimated_timestamp_us);
+    } else {
+      AnalogPutUdint(&data[channel * 8], (CipUdint) input->value);
+      AnalogPutUdint(&data[channel * 8 + 4], input->timestamp_us);
+    }
+    if(input->analog) {
+      modes |= (CipUsint) (1U << channel);
+    }
+  }
+  data[32] = modes;
+  data[33] = (CipOctet) ClearCoreAnalogBlockOverruns();
+  data[34] = 0;
+  data[35] = 0;
+  return true;
+}
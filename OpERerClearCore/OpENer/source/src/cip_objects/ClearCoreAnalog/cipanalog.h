@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * Analog Input Object for the ClearCore analog inputs
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPANALOG_H_
+#define OPENER_CIPANALOG_H_
+
+/** @file cipanalog.h
+ *  @brief Public interface of the vendor specific Analog Input Object
+ *
+ *  Instances 1 .. 4 expose the analog inputs A-9 .. A-12 of the ClearCore
+ *  AdcManager. The values are scaled as
+ *  value = offset + (Q15 result * scale) / 32768, so the default scale of
+ *  10000 gives millivolts.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                        | Type  | Access |
+ *  |----|-----------------------------|-------|--------|
+ *  |  1 | Analog input mode           | BOOL  | Get/Set|
+ *  |  2 | Value (filtered, scaled)    | DINT  | Get    |
+ *  |  3 | Value timestamp, us         | UDINT | Get    |
+ *  |  4 | Decimated value (scaled)    | DINT  | Get    |
+ *  |  5 | Decimated timestamp, us     | UDINT | Get    |
+ *  |  6 | Filter time, ms             | UINT  | Get/Set|
+ *  |  7 | Oversampling, power of two  | USINT | Get/Set|
+ *  |  8 | Decimation, samples         | UINT  | Get/Set|
+ *  |  9 | Scale                       | DINT  | Get/Set|
+ *  | 10 | Offset                      | DINT  | Get/Set|
+ *  | 11 | Assembly value              | USINT | Get/Set|
+ *
+ *  While attribute #1 is false the connector is a digital input and the
+ *  values are not updated. Timestamps are the ClearCore Microseconds()
+ *  counter at the start of the conversion of the newest result in the
+ *  value. The hardware oversampling (#7) averages 2^n conversions into each
+ *  result, setting it fails with kCipErrorObjectStateConflict if the
+ *  conversions of all channels do not fit into one sample time. The
+ *  decimated value (#4) is the average of the last #8 results. Attribute
+ *  #11 selects which value the input assembly carries, see
+ *  @ref AnalogAssemblyValue.
+ *
+ *  Input assembly
+ *  ==============
+ *
+ *  kAnalogInputAssembly (T->O, 36 bytes): per input A-9 .. A-12 a DINT
+ *  value and its UDINT timestamp, then USINT input mode bits (bit 0: A-9),
+ *  USINT block overruns modulo 256 and 2 pad bytes.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Analog Input Object class code (vendor specific range) */
+static const CipUint kCipAnalogClassCode = 0x68U;
+
+/** @brief Input assembly instance of the analog inputs */
+static const CipUint kAnalogInputAssembly = 121U;
+
+#define CIP_ANALOG_INPUT_ASSEMBLY_SIZE 36
+
+/** @brief Values of attribute #11 */
+typedef enum {
+  kAnalogAssemblyFiltered = 0, /**< filtered value and its timestamp */
+  kAnalogAssemblyDecimated = 1 /**< decimated value and its timestamp */
+} AnalogAssemblyValue;
+
+/** @brief Create the Analog Input class, its instances and the input
+ *  assembly
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipAnalogInit(void);
+
+/** @brief Refresh the analog input assembly before it is produced
+ *
+ *  @param assembly_instance instance number of the assembly to be sent
+ *  @return true if the assembly belongs to the Analog Input object
+ */
+EipBool8 CipAnalogBeforeAssemblyDataSend(CipInstanceNum assembly_instance);
+
+#endif /* OPENER_CIPANALOG_H_ */
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ * Waveform Capture Object for the ClearCore SD card
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipcapture.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_capture.h"
+
+/** @brief Run time data of the Waveform Capture instance
+ *
+ *  The live attributes are copied from the capture by the PreGetCallback.
+ */
+typedef struct {
+  CipUsint state; /**< Attr. #1: WaveCaptureState */
+  CipUdint signals; /**< Attr. #2: WaveCaptureSignal bits */
+  CipUsint trigger; /**< Attr. #3: WaveCaptureTrigger */
+  CipUsint trigger_input; /**< Attr. #4: connector index */
+  CipUdint samples; /**< Attr. #5: decimated sample times, 0: no limit */
+  CipUint decimation; /**< Attr. #6 */
+  CipUdint first_block; /**< Attr. #7: header block on the card */
+  CipUdint block_count; /**< Attr. #8: 0: to the end of the card */
+  CipUdint recorded; /**< Attr. #9 */
+  CipUdint lost; /**< Attr. #10 */
+  CipUdint blocks_written; /**< Attr. #11 */
+  CipUint capture_id; /**< Attr. #12 */
+  CipUdint card_blocks; /**< Attr. #13: 0 without a card */
+} CipCapture;
+
+/* Highest trigger input, the HLFB of M-3 in the InputsRT() bitmap */
+#define CAPTURE_TRIGGER_INPUT_MAX 17U
+
+#define CAPTURE_DEFAULT_SIGNALS (kWaveSignalPosition | kWaveSignalInputs)
+
+/* Attributes that are sampled from the capture on every Get */
+#define CAPTURE_LIVE (kGetableSingleAndAll | kPreGetFunc)
+
+static int DecodeCaptureSignals(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response);
+static int DecodeCaptureTrigger(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response);
+static int DecodeCaptureTriggerInput(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response);
+static int DecodeCaptureDecimation(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response);
+
+/** @brief Attribute table of the instance */
+static const CipVendorAttribute kCaptureAttributes[] = {
+  { 1, kCipUsint, EncodeCipUsint, NULL,
+    offsetof(CipCapture, state), CAPTURE_LIVE },
+  { 2, kCipUdint, EncodeCipUdint, DecodeCaptureSignals,
+    offsetof(CipCapture, signals), kSetAndGetAble },
+  { 3, kCipUsint, EncodeCipUsint, DecodeCaptureTrigger,
+    offsetof(CipCapture, trigger), kSetAndGetAble },
+  { 4, kCipUsint, EncodeCipUsint, DecodeCaptureTriggerInput,
+    offsetof(CipCapture, trigger_input), kSetAndGetAble },
+  { 5, kCipUdint, EncodeCipUdint,
+    (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipCapture, samples), kSetAndGetAble },
+  { 6, kCipUint, EncodeCipUint, DecodeCaptureDecimation,
+    offsetof(CipCapture, decimation), kSetAndGetAble },
+  { 7, kCipUdint, EncodeCipUdint,
+    (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipCapture, first_block), kSetAndGetAble },
+  { 8, kCipUdint, EncodeCipUdint,
+    (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipCapture, block_count), kSetAndGetAble },
+  { 9, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipCapture, recorded), CAPTURE_LIVE },
+  { 10, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipCapture, lost), CAPTURE_LIVE },
+  { 11, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipCapture, blocks_written), CAPTURE_LIVE },
+  { 12, kCipUint, EncodeCipUint, NULL,
+    offsetof(CipCapture, capture_id), CAPTURE_LIVE },
+  { 13, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipCapture, card_blocks), CAPTURE_LIVE },
+};
+
+#define CAPTURE_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kCaptureAttributes)
+
+/** @brief Lowest live attribute; a Get_Attributes_All copies the state and
+ *  the counters of the capture once, so that the recorded, lost and written
+ *  counts of the reply agree with each other */
+static const CipUint kCaptureFirstLiveAttribute = 1U;
+
+static CipCapture s_capture;
+
+/** @brief Copy the progress of the capture into the live attributes */
+static void CaptureRefresh(CipCapture *const data) {
+  const WaveCapture *const capture = ClearCoreCapture();
+  if(NULL == capture) {
+    data->state = kWaveCaptureIdle;
+    data->card_blocks = 0;
+    return;
+  }
+  data->state = capture->state;
+  data->recorded = capture->samples;
+  data->lost = capture->lost;
+  data->blocks_written = capture->blocks_written;
+  data->capture_id = capture->capture_id;
+  data->card_blocks = capture->device->block_count;
+}
+
+static int DecodeCaptureSignals(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response)
+{
+  const CipUdint signals = GetUdintFromMessage(&message_router_request->data);
+  if( (0 == signals) || (0 != (signals & ~(CipUdint) kWaveSignalAll) ) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUdint *) data = signals;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 4;
+}
+
+static int DecodeCaptureTrigger(void *const data,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint trigger = GetUsintFromMessage(&message_router_request->data);
+  if(trigger > kWaveTriggerChange) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = trigger;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeCaptureTriggerInput(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint input = GetUsintFromMessage(&message_router_request->data);
+  if(input > CAPTURE_TRIGGER_INPUT_MAX) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = input;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeCaptureDecimation(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response)
+{
+  const CipUint decimation = GetUintFromMessage(&message_router_request->data);
+  if(0 == decimation) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUint *) data = decimation;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 2;
+}
+
+EipStatus CapturePreGetCallback(CipInstance *const instance,
+                                CipAttributeStruct *const attribute,
+                                CipByte service) {
+  CipCapture *const data = (CipCapture *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kCaptureFirstLiveAttribute) ) {
+    CaptureRefresh(data);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CaptureArm(CipInstance *RESTRICT const instance,
+                     CipMessageRouterRequest *const message_router_request,
+                     CipMessageRouterResponse *const message_router_response,
+                     const struct sockaddr *originator_address,
+                     const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipCapture *const data = (CipCapture *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( !CheckVendorServiceDataSize(message_router_request,
+                                  message_router_response, 0, 0) ) {
+    return kEipStatusOkSend;
+  }
+
+  /* The card may have been inserted after start up */
+  WaveCapture *capture = ClearCoreCapture();
+  if(NULL == capture) {
+    capture = ClearCoreCaptureInit();
+  }
+  if(NULL == capture) {
+    OPENER_TRACE_WARN("Capture: no SD card\n");
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+    return kEipStatusOkSend;
+  }
+
+  const WaveCaptureConfig config = {
+    .signals = data->signals,
+    .trigger = data->trigger,
+    .trigger_input = data->trigger_input,
+    .decimation = data->decimation,
+    .samples = data->samples,
+    .first_block = data->first_block,
+    .block_count = data->block_count
+  };
+  if(kEipStatusOk != WaveCaptureArm(capture, &config) ) {
+    OPENER_TRACE_WARN("Capture: arm rejected in state %u\n",
+                      (unsigned) capture->state);
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+  }
+  CaptureRefresh(data);
+  return kEipStatusOkSend;
+}
+
+EipStatus CaptureStop(CipInstance *RESTRICT const instance,
+                      CipMessageRouterRequest *const message_router_request,
+                      CipMessageRouterResponse *const message_router_response,
+                      const struct sockaddr *originator_address,
+                      const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( !CheckVendorServiceDataSize(message_router_request,
+                                  message_router_response, 0, 0) ) {
+    return kEipStatusOkSend;
+  }
+  WaveCapture *const capture = ClearCoreCapture();
+  if(NULL != capture) {
+    WaveCaptureStop(capture);
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus CipCaptureInit(void) {
+  CipClass *capture_class = NULL;
+
+  if( ( capture_class = CreateCipClass(kCipCaptureClassCode,
+                                       7, /* # class attributes */
+                                       7, /* # highest class attribute number */
+                                       2, /* # class services */
+                                       CAPTURE_ATTRIBUTE_COUNT, /* # instance attributes */
+                                       13, /* # highest instance attribute number */
+                                       5, /* # instance services */
+                                       1, /* # instances */
+                                       "Waveform Capture",
+                                       1, /* # class revision */
+                                       NULL /* # function pointer for initialization */
+                                       ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  memset(&s_capture, 0, sizeof(s_capture) );
+  s_capture.signals = CAPTURE_DEFAULT_SIGNALS;
+  s_capture.trigger = kWaveTriggerImmediate;
+  s_capture.decimation = 1;
+  if(NULL == ClearCoreCaptureInit() ) {
+    OPENER_TRACE_INFO("Capture: no SD card at start up\n");
+  }
+  CaptureRefresh(&s_capture);
+
+  CipInstance *const instance = GetCipInstance(capture_class, 1);
+  instance->data = &s_capture;
+  InsertVendorAttributes(instance, kCaptureAttributes, CAPTURE_ATTRIBUTE_COUNT);
+
+  InsertGetSetCallback(capture_class, CapturePreGetCallback, kPreGetFunc);
+
+  InsertService(capture_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(capture_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(capture_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+  InsertService(capture_class, kCaptureServiceArm, &CaptureArm, "Arm");
+  InsertService(capture_class, kCaptureServiceStop, &CaptureStop, "Stop");
+
+  return kEipStatusOk;
+}
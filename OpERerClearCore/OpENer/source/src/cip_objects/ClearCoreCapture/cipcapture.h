@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Waveform Capture Object for the ClearCore SD card
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPCAPTURE_H_
+#define OPENER_CIPCAPTURE_H_
+
+/** @file cipcapture.h
+ *  @brief Public interface of the vendor specific Waveform Capture Object
+ *
+ *  A single instance records ClearCore signals every sample time to the SD
+ *  card, see clearcore_capture.h and wavecapture.h for the recording and
+ *  the format on the card. Tools/wavedecode.py reads a capture back.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                        | Type  | Access |
+ *  |----|-----------------------------|-------|--------|
+ *  |  1 | State                       | USINT | Get    |
+ *  |  2 | Signals                     | UDINT | Get/Set|
+ *  |  3 | Trigger                     | USINT | Get/Set|
+ *  |  4 | Trigger input               | USINT | Get/Set|
+ *  |  5 | Sample count                | UDINT | Get/Set|
+ *  |  6 | Decimation                  | UINT  | Get/Set|
+ *  |  7 | First block                 | UDINT | Get/Set|
+ *  |  8 | Region blocks               | UDINT | Get/Set|
+ *  |  9 | Records stored              | UDINT | Get    |
+ *  | 10 | Records lost                | UDINT | Get    |
+ *  | 11 | Data blocks written         | UDINT | Get    |
+ *  | 12 | Capture id                  | UINT  | Get    |
+ *  | 13 | Card blocks                 | UDINT | Get    |
+ *
+ *  The state (#1) is a WaveCaptureState. The signals (#2) are
+ *  WaveCaptureSignal bits, the trigger (#3) a WaveCaptureTrigger on the
+ *  trigger input (#4), a connector index from IO-0 (0) to the HLFB of M-3
+ *  (17). The capture ends after #5 decimated sample times, 0 records until
+ *  Stop or until the region is full. Every #6th sample time is recorded.
+ *  The capture takes the blocks #7 .. #7 + #8 - 1 of the card, #8 = 0
+ *  takes the rest of the card. Settings apply to the next Arm.
+ *
+ *  Vendor specific services
+ *  ========================
+ *
+ *  - Arm (0x4B): no data, starts a capture with the attributes #2 .. #8.
+ *    Fails with kCipErrorObjectStateConflict while a capture is in
+ *    progress, without a card or if the region does not fit the card.
+ *  - Stop (0x4C): no data, ends the capture in progress.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Waveform Capture Object class code (vendor specific range) */
+static const CipUint kCipCaptureClassCode = 0x69U;
+
+/** @brief Vendor specific service codes of the Waveform Capture Object */
+typedef enum {
+  kCaptureServiceArm = 0x4B,
+  kCaptureServiceStop = 0x4C
+} CaptureServices;
+
+/** @brief Create the Waveform Capture class and its instance
+ *
+ *  Looks for an SD card; without one the object reports 0 card blocks and
+ *  looks again on every Arm.
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipCaptureInit(void);
+
+#endif /* OPENER_CIPCAPTURE_H_ */
@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * CCIO-8 Object for the ClearCore CCIO-8 expansion link
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipccio.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_ccio.h"
+
+/** @brief Run time data of the CCIO-8 instance
+ *
+ *  The live attributes are copied from @ref sample, which is refreshed from
+ *  the CcioBoardManager in one call by the PreGetCallback.
+ */
+typedef struct {
+  ClearCoreCcioSample sample; /**< last sample of the link */
+  CipUsint port; /**< Attr. #1: ClearCoreCcioPort */
+  CipUsint boards; /**< Attr. #2 */
+  CipBool link_broken; /**< Attr. #3 */
+  CipLword inputs; /**< Attr. #4 */
+  CipLword outputs; /**< Attr. #5 */
+  CipLword output_pins; /**< Attr. #6 */
+  CipLword overloaded; /**< Attr. #7 */
+  CipUdint refresh_overruns; /**< Attr. #8 */
+  CipBool rediscover; /**< Attr. #9 */
+  CipLword cos_mask; /**< Attr. #10 */
+  CipLword risen; /**< edges since the input assembly was produced */
+  CipLword fallen;
+  CipBool cos_triggered; /**< production requested for the edges */
+} CipCcio;
+
+/* Attributes that are sampled from the CcioBoardManager on every Get */
+#define CCIO_LIVE (kGetableSingleAndAll | kPreGetFunc)
+/* Attributes that are pushed to the CcioBoardManager after every Set */
+#define CCIO_SETTABLE (kSetAndGetAble | kPostSetFunc)
+
+static int DecodeCcioPort(void *const data,
+                          CipMessageRouterRequest *const message_router_request,
+                          CipMessageRouterResponse *const message_router_response);
+
+/** @brief Attribute table of the instance */
+static const CipVendorAttribute kCcioAttributes[] = {
+  { 1, kCipUsint, EncodeCipUsint, DecodeCcioPort,
+    offsetof(CipCcio, port), kSetAndGetAble },
+  { 2, kCipUsint, EncodeCipUsint, NULL,
+    offsetof(CipCcio, boards), CCIO_LIVE },
+  { 3, kCipBool, EncodeCipBool, NULL,
+    offsetof(CipCcio, link_broken), CCIO_LIVE },
+  { 4, kCipLword, EncodeCipLword, NULL,
+    offsetof(CipCcio, inputs), CCIO_LIVE },
+  { 5, kCipLword, EncodeCipLword,
+    (CipAttributeDecodeFromMessage)DecodeCipLword,
+    offsetof(CipCcio, outputs), CCIO_LIVE | CCIO_SETTABLE },
+  { 6, kCipLword, EncodeCipLword,
+    (CipAttributeDecodeFromMessage)DecodeCipLword,
+    offsetof(CipCcio, output_pins), CCIO_SETTABLE },
+  { 7, kCipLword, EncodeCipLword, NULL,
+    offsetof(CipCcio, overloaded), CCIO_LIVE },
+  { 8, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipCcio, refresh_overruns), CCIO_LIVE },
+  { 9, kCipBool, EncodeCipBool, (CipAttributeDecodeFromMessage)DecodeCipBool,
+    offsetof(CipCcio, rediscover), CCIO_SETTABLE },
+  { 10, kCipLword, EncodeCipLword,
+    (CipAttributeDecodeFromMessage)DecodeCipLword,
+    offsetof(CipCcio, cos_mask), kSetAndGetAble },
+};
+
+#define CCIO_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kCcioAttributes)
+
+/** @brief Lowest live attribute, #1 is the configured port; a
+ *  Get_Attributes_All takes one ClearCoreCcioSampleRead, so that the inputs,
+ *  outputs and overloads of the reply are of the same link refresh */
+static const CipUint kCcioFirstLiveAttribute = 2U;
+
+static CipCcio s_ccio;
+static CipOctet s_ccio_input_assembly[CIP_CCIO_INPUT_ASSEMBLY_SIZE];
+static CipOctet s_ccio_output_assembly[CIP_CCIO_OUTPUT_ASSEMBLY_SIZE];
+
+/** @brief Refresh the sample and the live attributes */
+static void CcioRefresh(CipCcio *const ccio) {
+  ClearCoreCcioSampleRead(&ccio->sample);
+  ccio->boards = ccio->sample.boards;
+  ccio->link_broken = ccio->sample.link_broken;
+  ccio->inputs = ccio->sample.inputs;
+  ccio->outputs = ccio->sample.outputs;
+  ccio->overloaded = ccio->sample.overloaded;
+  ccio->refresh_overruns = ccio->sample.refresh_overruns;
+}
+
+/** @brief Collect the edges the CcioBoardManager latched since the last
+ *  call */
+static void CcioEdgesCollect(CipCcio *const ccio) {
+  uint64_t risen = 0;
+  uint64_t fallen = 0;
+  ClearCoreCcioEdgesRead(&risen, &fallen);
+  ccio->risen |= risen;
+  ccio->fallen |= fallen;
+}
+
+/** @brief Open the link right away, the port may refuse the CCIO mode */
+static int DecodeCcioPort(void *const data,
+                          CipMessageRouterRequest *const message_router_request,
+                          CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint port = GetUsintFromMessage(&message_router_request->data);
+  if(port > kClearCoreCcioPortCom1) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  if( !ClearCoreCcioLinkOpen(port) ) {
+    OPENER_TRACE_WARN("CCIO: link on port %u rejected\n", port);
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+    return -1;
+  }
+  *(CipUsint *) data = port;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static void CcioPutLword(CipOctet *const buffer,
+                         const CipLword value) {
+  for(size_t i = 0; i < 8; ++i) {
+    buffer[i] = (CipOctet) (value >> (8 * i) );
+  }
+}
+
+static CipLword CcioGetLword(const CipOctet *const buffer) {
+  CipLword value = 0;
+  for(size_t i = 8; i > 0; --i) {
+    value = (value << 8) | buffer[i - 1];
+  }
+  return value;
+}
+
+EipStatus CcioPreGetCallback(CipInstance *const instance,
+                             CipAttributeStruct *const attribute,
+                             CipByte service) {
+  CipCcio *const ccio = (CipCcio *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kCcioFirstLiveAttribute) ) {
+    CcioRefresh(ccio);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CcioPostSetCallback(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service) {
+  (void) service;
+  CipCcio *const ccio = (CipCcio *) instance->data;
+
+  switch(attribute->attribute_number) {
+    case 5:
+      ClearCoreCcioOutputsWrite(ccio->outputs, ccio->output_pins);
+      break;
+    case 6:
+      ClearCoreCcioOutputPins(ccio->output_pins);
+      break;
+    case 9:
+      ClearCoreCcioRediscover(ccio->rediscover);
+      break;
+    default:
+      break;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CipCcioInit(void) {
+  CipClass *ccio_class = NULL;
+
+  if( ( ccio_class = CreateCipClass(kCipCcioClassCode,
+                                    7, /* # class attributes */
+                                    7, /* # highest class attribute number */
+                                    2, /* # class services */
+                                    CCIO_ATTRIBUTE_COUNT, /* # instance attributes */
+                                    10, /* # highest instance attribute number */
+                                    3, /* # instance services */
+                                    1, /* # instances */
+                                    "CCIO-8",
+                                    1, /* # class revision */
+                                    NULL /* # function pointer for initialization */
+                                    ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  memset(&s_ccio, 0, sizeof(s_ccio) );
+  memset(s_ccio_input_assembly, 0, sizeof(s_ccio_input_assembly) );
+  memset(s_ccio_output_assembly, 0, sizeof(s_ccio_output_assembly) );
+  s_ccio.rediscover = true;
+  s_ccio.cos_mask = UINT64_MAX;
+#if defined(CLEARCORE_CCIO_PORT) && 0 != CLEARCORE_CCIO_PORT
+  if( ClearCoreCcioLinkOpen(CLEARCORE_CCIO_PORT) ) {
+    s_ccio.port = CLEARCORE_CCIO_PORT;
+  }
+#endif
+  CcioRefresh(&s_ccio);
+
+  CipInstance *const instance = GetCipInstance(ccio_class, 1);
+  instance->data = &s_ccio;
+  InsertVendorAttributes(instance, kCcioAttributes, CCIO_ATTRIBUTE_COUNT);
+
+  CreateAssemblyObject(kCcioInputAssembly,
+                       s_ccio_input_assembly,
+                       sizeof(s_ccio_input_assembly) );
+  CreateAssemblyObject(kCcioOutputAssembly,
+                       s_ccio_output_assembly,
+                       sizeof(s_ccio_output_assembly) );
+
+  InsertGetSetCallback(ccio_class, CcioPreGetCallback, kPreGetFunc);
+  InsertGetSetCallback(ccio_class, CcioPostSetCallback, kPostSetFunc);
+
+  InsertService(ccio_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(ccio_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(ccio_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+
+  return kEipStatusOk;
+}
+
+void CipCcioHandleApplication(void) {
+  if(kClearCoreCcioPortNone == s_ccio.port) {
+    return;
+  }
+  CcioEdgesCollect(&s_ccio);
+  /* Trigger once per production, a new trigger would restart the inhibit
+   * time */
+  if( !s_ccio.cos_triggered &&
+      (0 != ( (s_ccio.risen | s_ccio.fallen) & s_ccio.cos_mask) ) ) {
+    if(kEipStatusOk == TriggerConnections(kCcioOutputAssembly,
+                                          kCcioInputAssembly) ) {
+      s_ccio.cos_triggered = true;
+    }
+  }
+}
+
+EipBool8 CipCcioAfterAssemblyDataReceived(CipInstanceNum assembly_instance) {
+  if(kCcioOutputAssembly != assembly_instance) {
+    return false;
+  }
+
+  ClearCoreCcioOutputsWrite(CcioGetLword(s_ccio_output_assembly),
+                            s_ccio.output_pins);
+  return true;
+}
+
+EipBool8 CipCcioBeforeAssemblyDataSend(CipInstanceNum assembly_instance) {
+  if(kCcioInputAssembly != assembly_instance) {
+    return false;
+  }
+
+  CipCcio *const ccio = &s_ccio;
+  CipOctet *const data = s_ccio_input_assembly;
+  CcioRefresh(ccio);
+  CcioEdgesCollect(ccio);
+  CcioPutLword(&data[0], ccio->inputs);
+  CcioPutLword(&data[8], ccio->risen);
+  CcioPutLword(&data[16], ccio->fallen);
+  CcioPutLword(&data[24], ccio->overloaded);
+  data[32] = ccio->boards;
+  data[33] = (CipOctet) ( (kClearCoreCcioPortNone != ccio->port ?
+                           kCcioStatusLinkOpen : 0) |
+                          (ccio->link_broken ? kCcioStatusLinkBroken : 0) );
+  data[34] = (CipOctet) ccio->refresh_overruns;
+  data[35] = (CipOctet) (ccio->refresh_overruns >> 8);
+  ccio->risen = 0;
+  ccio->fallen = 0;
+  ccio->cos_triggered = false;
+  return true;
+}
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * CCIO-8 Object for the ClearCore CCIO-8 expansion link
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPCCIO_H_
+#define OPENER_CIPCCIO_H_
+
+/** @file cipccio.h
+ *  @brief Public interface of the vendor specific CCIO-8 Object
+ *
+ *  A single instance exposes the chain of up to 8 CCIO-8 boards on a
+ *  ClearCore serial port, 64 pins. Pin bit 0 of the LWORDs is CCIOA0 of the
+ *  first board, bit 8 CCIOA0 of the second board.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type  | Access |
+ *  |----|------------------------|-------|--------|
+ *  |  1 | Link port              | USINT | Get/Set|
+ *  |  2 | Board count            | USINT | Get    |
+ *  |  3 | Link broken            | BOOL  | Get    |
+ *  |  4 | Inputs (filtered)      | LWORD | Get    |
+ *  |  5 | Outputs                | LWORD | Get/Set|
+ *  |  6 | Output pins            | LWORD | Get/Set|
+ *  |  7 | Overloaded outputs     | LWORD | Get    |
+ *  |  8 | Refresh overruns       | UDINT | Get    |
+ *  |  9 | Rediscover enable      | BOOL  | Get/Set|
+ *  | 10 | Change of state mask   | LWORD | Get/Set|
+ *
+ *  Setting attribute #1 (see ClearCoreCcioPort) opens the port in the CCIO
+ *  mode and discovers the boards, 0 closes the link. The pins set in #6 are
+ *  outputs, all others inputs; #5 and the output assembly only write those
+ *  pins. #8 counts the refreshes that were skipped because the previous
+ *  transfer of the link had not ended.
+ *
+ *  Assemblies
+ *  ==========
+ *
+ *  kCcioInputAssembly (T->O, 36 bytes): LWORD inputs, LWORD inputs risen,
+ *  LWORD inputs fallen, LWORD overloaded outputs, USINT board count,
+ *  USINT status (see @ref CcioStatusBits), UINT refresh overruns modulo
+ *  65536. The edges are the ones since the assembly was last produced.
+ *
+ *  kCcioOutputAssembly (O->T, 8 bytes): LWORD outputs.
+ *
+ *  Both are the connection point of an Exclusive Owner connection. A
+ *  connection with the change of state trigger is produced as soon as an
+ *  input of attribute #10 has an edge, limited by its production inhibit
+ *  time, and otherwise at its RPI. The edges are collected from the
+ *  CcioBoardManager, so the application must not read InputsRisen() or
+ *  InputsFallen() of the CCIO-8 pins itself.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief CCIO-8 Object class code (vendor specific range) */
+static const CipUint kCipCcioClassCode = 0x6AU;
+
+/** @brief Input assembly instance of the CCIO-8 link */
+static const CipUint kCcioInputAssembly = 122U;
+
+/** @brief Output assembly instance of the CCIO-8 link */
+static const CipUint kCcioOutputAssembly = 164U;
+
+#define CIP_CCIO_INPUT_ASSEMBLY_SIZE 36
+#define CIP_CCIO_OUTPUT_ASSEMBLY_SIZE 8
+
+/** @brief Bits of the status byte in the input assembly */
+typedef enum {
+  kCcioStatusLinkOpen = 0x01, /**< a port is in the CCIO mode */
+  kCcioStatusLinkBroken = 0x02 /**< the boards do not answer */
+} CcioStatusBits;
+
+/** @brief Create the CCIO-8 class, its instance and the assemblies
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipCcioInit(void);
+
+/** @brief Collect the input edges and trigger the change of state
+ *  production, called from HandleApplication()
+ */
+void CipCcioHandleApplication(void);
+
+/** @brief Apply a received output assembly to the outputs
+ *
+ *  @param assembly_instance instance number of the received assembly
+ *  @return true if the assembly belongs to the CCIO-8 object
+ */
+EipBool8 CipCcioAfterAssemblyDataReceived(CipInstanceNum assembly_instance);
+
+/** @brief Refresh the input assembly before it is produced
+ *
+ *  @param assembly_instance instance number of the assembly to be sent
+ *  @return true if the assembly belongs to the CCIO-8 object
+ */
+EipBool8 CipCcioBeforeAssemblyDataSend(CipInstanceNum assembly_instance);
+
+#endif /* OPENER_CIPCCIO_H_ */
@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * Encoder Object for the ClearCore encoder input
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipencoder.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_encoder.h"
+
+/** @brief Run time data of the Encoder instance
+ *
+ *  The live attributes point into @ref sample, which is refreshed from the
+ *  EncoderInput in one call by the PreGetCallback.
+ */
+typedef struct {
+  ClearCoreEncoderSample sample; /**< last sample of the EncoderInput */
+  CipBool enable; /**< Attr. #10: position decoder enabled */
+  CipUsint latch_pin; /**< Attr. #11: connector of the registration latch */
+  CipUsint latch_trigger; /**< Attr. #12: ClearCoreEncoderLatchTrigger */
+  CipUint velocity_filter_ms; /**< Attr. #13: velocity filter rise time */
+  CipOctet input_assembly[CIP_ENCODER_INPUT_ASSEMBLY_SIZE];
+} CipEncoder;
+
+/* Connectors that can trigger interrupts, DI-6 .. A-12 */
+#define ENCODER_LATCH_PIN_MIN 6U
+#define ENCODER_LATCH_PIN_MAX 12U
+/* Longest velocity filter rise time that fits the filter's sample count */
+#define ENCODER_VELOCITY_FILTER_MS_MAX 10000U
+
+#define ENCODER_DEFAULT_LATCH_PIN 9U /* A-9, DI-6 .. DI-8 carry the encoder */
+#define ENCODER_DEFAULT_VELOCITY_FILTER_MS 10U
+
+/* Attributes that are sampled from the EncoderInput on every Get */
+#define ENCODER_LIVE (kGetableSingleAndAll | kPreGetFunc)
+/* Attributes that are pushed to the EncoderInput after every Set */
+#define ENCODER_SETTABLE (kSetAndGetAble | kPostSetFunc)
+
+static int DecodeEncoderLatchPin(void *const data,
+                                 CipMessageRouterRequest *const message_router_request,
+                                 CipMessageRouterResponse *const message_router_response);
+static int DecodeEncoderLatchTrigger(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response);
+static int DecodeEncoderVelocityFilter(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response);
+
+/** @brief Attribute table of the instance */
+static const CipVendorAttribute kEncoderAttributes[] = {
+  { 1, kCipDint, EncodeCipDint, (CipAttributeDecodeFromMessage)DecodeCipDint,
+    offsetof(CipEncoder, sample.position), ENCODER_LIVE | ENCODER_SETTABLE },
+  { 2, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipEncoder, sample.velocity), ENCODER_LIVE },
+  { 3, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipEncoder, sample.timestamp_us), ENCODER_LIVE },
+  { 4, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipEncoder, sample.index_position), ENCODER_LIVE },
+  { 5, kCipBool, EncodeCipBool, NULL,
+    offsetof(CipEncoder, sample.quadrature_error), ENCODER_LIVE },
+  { 6, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipEncoder, sample.latch_position), ENCODER_LIVE },
+  { 7, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipEncoder, sample.latch_timestamp_us), ENCODER_LIVE },
+  { 8, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipEncoder, sample.latch_count), ENCODER_LIVE },
+  { 9, kCipBool, EncodeCipBool, NULL,
+    offsetof(CipEncoder, sample.latch_armed), ENCODER_LIVE },
+  { 10, kCipBool, EncodeCipBool, (CipAttributeDecodeFromMessage)DecodeCipBool,
+    offsetof(CipEncoder, enable), ENCODER_SETTABLE },
+  { 11, kCipUsint, EncodeCipUsint, DecodeEncoderLatchPin,
+    offsetof(CipEncoder, latch_pin), kSetAndGetAble },
+  { 12, kCipUsint, EncodeCipUsint, DecodeEncoderLatchTrigger,
+    offsetof(CipEncoder, latch_trigger), kSetAndGetAble },
+  { 13, kCipUint, EncodeCipUint, DecodeEncoderVelocityFilter,
+    offsetof(CipEncoder, velocity_filter_ms), ENCODER_SETTABLE },
+};
+
+#define ENCODER_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kEncoderAttributes)
+
+/** @brief Position, the first attribute read from the EncoderInput sample;
+ *  ClearCoreEncoderSampleRead() takes the counts, their timestamp, the
+ *  filtered velocity and the latch state with the sample interrupt blocked,
+ *  so the velocity and timestamps of a reply belong to its position */
+static const CipUint kEncoderFirstLiveAttribute = 1U;
+
+static CipEncoder s_encoder;
+
+static EipBool8 EncoderLatchPinValid(const CipUsint pin) {
+  return (pin >= ENCODER_LATCH_PIN_MIN) && (pin <= ENCODER_LATCH_PIN_MAX);
+}
+
+static EipBool8 EncoderLatchTriggerValid(const CipUsint trigger) {
+  return (kClearCoreEncoderLatchChange == trigger) ||
+         (kClearCoreEncoderLatchFalling == trigger) ||
+         (kClearCoreEncoderLatchRising == trigger);
+}
+
+static int DecodeEncoderLatchPin(void *const data,
+                                 CipMessageRouterRequest *const message_router_request,
+                                 CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint pin = GetUsintFromMessage(&message_router_request->data);
+  if( !EncoderLatchPinValid(pin) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = pin;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeEncoderLatchTrigger(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response)
+{
+  const CipUsint trigger = GetUsintFromMessage(&message_router_request->data);
+  if( !EncoderLatchTriggerValid(trigger) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = trigger;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeEncoderVelocityFilter(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response)
+{
+  const CipUint filter_ms = GetUintFromMessage(&message_router_request->data);
+  if( (0 == filter_ms) || (filter_ms > ENCODER_VELOCITY_FILTER_MS_MAX) ) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUint *) data = filter_ms;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 2;
+}
+
+static void EncoderPutDint(CipOctet *const buffer,
+                           const CipUdint value) {
+  buffer[0] = (CipOctet) value;
+  buffer[1] = (CipOctet) (value >> 8);
+  buffer[2] = (CipOctet) (value >> 16);
+  buffer[3] = (CipOctet) (value >> 24);
+}
+
+EipStatus EncoderPreGetCallback(CipInstance *const instance,
+                                CipAttributeStruct *const attribute,
+                                CipByte service) {
+  CipEncoder *const encoder = (CipEncoder *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kEncoderFirstLiveAttribute) ) {
+    ClearCoreEncoderSampleRead(&encoder->sample);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus EncoderPostSetCallback(CipInstance *const instance,
+                                 CipAttributeStruct *const attribute,
+                                 CipByte service) {
+  (void) service;
+  CipEncoder *const encoder = (CipEncoder *) instance->data;
+
+  switch(attribute->attribute_number) {
+    case 1:
+      ClearCoreEncoderPositionSet(encoder->sample.position);
+      break;
+    case 10:
+      ClearCoreEncoderEnable(encoder->enable);
+      break;
+    case 13:
+      ClearCoreEncoderVelocityFilterMs(encoder->velocity_filter_ms);
+      break;
+    default:
+      break;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus EncoderClearQuadratureError(CipInstance *RESTRICT const instance,
+                                      CipMessageRouterRequest *const message_router_request,
+                                      CipMessageRouterResponse *const message_router_response,
+                                      const struct sockaddr *originator_address,
+                                      const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 0) ) {
+    ClearCoreEncoderClearQuadratureError();
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus EncoderArmLatch(CipInstance *RESTRICT const instance,
+                          CipMessageRouterRequest *const message_router_request,
+                          CipMessageRouterResponse *const message_router_response,
+                          const struct sockaddr *originator_address,
+                          const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipEncoder *const encoder = (CipEncoder *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( !CheckVendorServiceDataSize(message_router_request,
+                                  message_router_response, 0, 2) ) {
+    return kEipStatusOkSend;
+  }
+
+  CipUsint pin = encoder->latch_pin;
+  CipUsint trigger = encoder->latch_trigger;
+  if(message_router_request->request_data_size > 0) {
+    pin = GetUsintFromMessage(&message_router_request->data);
+  }
+  if(message_router_request->request_data_size > 1) {
+    trigger = GetUsintFromMessage(&message_router_request->data);
+  }
+  if( !EncoderLatchPinValid(pin) || !EncoderLatchTriggerValid(trigger) ) {
+    message_router_response->general_status = kCipErrorInvalidParameter;
+  } else if( !ClearCoreEncoderLatchArm(pin, trigger) ) {
+    OPENER_TRACE_WARN("Encoder: latch on connector %u rejected\n", pin);
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+  } else {
+    encoder->latch_pin = pin;
+    encoder->latch_trigger = trigger;
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus EncoderDisarmLatch(CipInstance *RESTRICT const instance,
+                             CipMessageRouterRequest *const message_router_request,
+                             CipMessageRouterResponse *const message_router_response,
+                             const struct sockaddr *originator_address,
+                             const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 0) ) {
+    ClearCoreEncoderLatchDisarm();
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus CipEncoderInit(void) {
+  CipClass *encoder_class = NULL;
+
+  if( ( encoder_class = CreateCipClass(kCipEncoderClassCode,
+                                       7, /* # class attributes */
+                                       7, /* # highest class attribute number */
+                                       2, /* # class services */
+                                       ENCODER_ATTRIBUTE_COUNT, /* # instance attributes */
+                                       13, /* # highest instance attribute number */
+                                       6, /* # instance services */
+                                       1, /* # instances */
+                                       "Encoder",
+                                       1, /* # class revision */
+                                       NULL /* # function pointer for initialization */
+                                       ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  memset(&s_encoder, 0, sizeof(s_encoder) );
+  s_encoder.latch_pin = ENCODER_DEFAULT_LATCH_PIN;
+  s_encoder.latch_trigger = kClearCoreEncoderLatchRising;
+  s_encoder.velocity_filter_ms = ENCODER_DEFAULT_VELOCITY_FILTER_MS;
+  ClearCoreEncoderVelocityFilterMs(s_encoder.velocity_filter_ms);
+
+  CipInstance *const instance = GetCipInstance(encoder_class, 1);
+  instance->data = &s_encoder;
+  InsertVendorAttributes(instance, kEncoderAttributes, ENCODER_ATTRIBUTE_COUNT);
+
+  CreateAssemblyObject(kEncoderInputAssembly,
+                       s_encoder.input_assembly,
+                       sizeof(s_encoder.input_assembly) );
+
+  InsertGetSetCallback(encoder_class, EncoderPreGetCallback, kPreGetFunc);
+  InsertGetSetCallback(encoder_class, EncoderPostSetCallback, kPostSetFunc);
+
+  InsertService(encoder_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(encoder_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(encoder_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+  InsertService(encoder_class, kEncoderServiceClearQuadratureError,
+                &EncoderClearQuadratureError, "ClearQuadratureError");
+  InsertService(encoder_class, kEncoderServiceArmLatch, &EncoderArmLatch,
+                "ArmLatch");
+  InsertService(encoder_class, kEncoderServiceDisarmLatch,
+                &EncoderDisarmLatch, "DisarmLatch");
+
+  return kEipStatusOk;
+}
+
+EipBool8 CipEncoderBeforeAssemblyDataSend(CipInstanceNum assembly_instance) {
+  if(kEncoderInputAssembly != assembly_instance) {
+    return false;
+  }
+
+  ClearCoreEncoderSampleRead(&s_encoder.sample);
+
+  CipOctet *const data = s_encoder.input_assembly;
+  const ClearCoreEncoderSample *const sample = &s_encoder.sample;
+  EncoderPutDint(&data[0], sample->timestamp_us);
+  EncoderPutDint(&data[4], (CipUdint) sample->position);
+  EncoderPutDint(&data[8], (CipUdint) sample->velocity);
+  EncoderPutDint(&data[12], (CipUdint) sample->index_position);
+  EncoderPutDint(&data[16], (CipUdint) sample->latch_position);
+  EncoderPutDint(&data[20], sample->latch_timestamp_us);
+
+  CipUsint status = 0;
+  if(s_encoder.enable) {
+    status |= kEncoderStatusEnabled;
+  }
+  if(sample->quadrature_error) {
+    status |= kEncoderStatusQuadratureError;
+  }
+  if(sample->latch_armed) {
+    status |= kEncoderStatusLatchArmed;
+  }
+  data[24] = status;
+  data[25] = (CipOctet) sample->latch_count;
+  data[26] = 0;
+  data[27] = 0;
+  return true;
+}
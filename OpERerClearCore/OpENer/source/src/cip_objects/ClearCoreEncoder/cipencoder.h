@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Encoder Object for the ClearCore encoder input
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPENCODER_H_
+#define OPENER_CIPENCODER_H_
+
+/** @file cipencoder.h
+ *  @brief Public interface of the vendor specific Encoder Object
+ *
+ *  A single instance exposes the ClearCore EncoderInput (quadrature on
+ *  DI-6/DI-7, index on DI-8) and its registration latch.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type  | Access |
+ *  |----|------------------------|-------|--------|
+ *  |  1 | Position               | DINT  | Get/Set|
+ *  |  2 | Velocity (filtered)    | DINT  | Get    |
+ *  |  3 | Position timestamp, us | UDINT | Get    |
+ *  |  4 | Index position         | DINT  | Get    |
+ *  |  5 | Quadrature error       | BOOL  | Get    |
+ *  |  6 | Latch position         | DINT  | Get    |
+ *  |  7 | Latch timestamp, us    | UDINT | Get    |
+ *  |  8 | Latch count            | UDINT | Get    |
+ *  |  9 | Latch armed            | BOOL  | Get    |
+ *  | 10 | Enable                 | BOOL  | Get/Set|
+ *  | 11 | Latch input connector  | USINT | Get/Set|
+ *  | 12 | Latch trigger          | USINT | Get/Set|
+ *  | 13 | Velocity filter, ms    | UINT  | Get/Set|
+ *
+ *  Timestamps are the ClearCore Microseconds() counter. The position
+ *  timestamp is taken when the position is sampled in the 5 kHz interrupt,
+ *  the latch timestamp in the interrupt of the latch input.
+ *
+ *  Vendor specific services
+ *  ========================
+ *
+ *  - ClearQuadratureError (0x4B): no data
+ *  - ArmLatch (0x4C): optional USINT connector, optional USINT trigger,
+ *    defaults are attributes #11 and #12
+ *  - DisarmLatch (0x4D): no data
+ *
+ *  Input assembly
+ *  ==============
+ *
+ *  kEncoderInputAssembly (T->O, 28 bytes): UDINT position timestamp,
+ *  DINT position, DINT velocity, DINT index position, DINT latch position,
+ *  UDINT latch timestamp, USINT status (see @ref EncoderStatusBits),
+ *  USINT latch count modulo 256, 2 pad bytes.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Encoder Object class code (vendor specific range) */
+static const CipUint kCipEncoderClassCode = 0x65U;
+
+/** @brief Input assembly instance of the encoder */
+static const CipUint kEncoderInputAssembly = 120U;
+
+#define CIP_ENCODER_INPUT_ASSEMBLY_SIZE 28
+
+/** @brief Vendor specific service codes of the Encoder Object */
+typedef enum {
+  kEncoderServiceClearQuadratureError = 0x4B,
+  kEncoderServiceArmLatch = 0x4C,
+  kEncoderServiceDisarmLatch = 0x4D
+} EncoderServices;
+
+/** @brief Bits of the status byte in the input assembly */
+typedef enum {
+  kEncoderStatusEnabled = 0x01, /**< position decoder enabled */
+  kEncoderStatusQuadratureError = 0x02, /**< quadrature error latched */
+  kEncoderStatusLatchArmed = 0x04 /**< waiting for the latch input */
+} EncoderStatusBits;
+
+/** @brief Create the Encoder class, its instance and the input assembly
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipEncoderInit(void);
+
+/** @brief Refresh the encoder input assembly before it is produced
+ *
+ *  @param assembly_instance instance number of the assembly to be sent
+ *  @return true if the assembly belongs to the Encoder object
+ */
+EipBool8 CipEncoderBeforeAssemblyDataSend(CipInstanceNum assembly_instance);
+
+#endif /* OPENER_CIPENCODER_H_ */
@@ -0,0 +1,409 @@
+/*******************************************************************************
+ * Motion Axis Object for the ClearCore MotorDriver connectors
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipmotionaxis.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_motion.h"
+
+/** @brief Run time data of one Motion Axis instance
+ *
+ *  The live attributes point into @ref sample, which is refreshed from the
+ *  MotorDriver in one call by the PreGetCallback.
+ */
+typedef struct {
+  unsigned int axis; /**< MotorDriver index, instance number - 1 */
+  ClearCoreMotorSample sample; /**< last sample of the MotorDriver */
+  CipUdint vel_max; /**< Attr. #3: last VelMax written to the axis */
+  CipUdint accel_max; /**< Attr. #4: last AccelMax written to the axis */
+  CipUdint estop_decel_max; /**< Attr. #5: last EStopDecelMax written */
+  CipBool enable_request; /**< Attr. #10: requested enable state */
+  CipUsint last_control; /**< control byte of the previous output assembly */
+  CipOctet input_assembly[CIP_MOTION_AXIS_INPUT_ASSEMBLY_SIZE];
+  CipOctet output_assembly[CIP_MOTION_AXIS_OUTPUT_ASSEMBLY_SIZE];
+} CipMotionAxis;
+
+/* Attributes that are sampled from the MotorDriver on every Get */
+#define MOTION_AXIS_LIVE (kGetableSingleAndAll | kPreGetFunc)
+/* Attributes that are pushed to the MotorDriver after every Set */
+#define MOTION_AXIS_SETTABLE (kSetAndGetAble | kPostSetFunc)
+
+/** @brief Attribute table shared by all instances */
+static const CipVendorAttribute kMotionAxisAttributes[] = {
+  { 1, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipMotionAxis, sample.position_commanded), MOTION_AXIS_LIVE },
+  { 2, kCipDint, EncodeCipDint, NULL,
+    offsetof(CipMotionAxis, sample.velocity_commanded), MOTION_AXIS_LIVE },
+  { 3, kCipUdint, EncodeCipUdint, (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipMotionAxis, vel_max), MOTION_AXIS_SETTABLE },
+  { 4, kCipUdint, EncodeCipUdint, (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipMotionAxis, accel_max), MOTION_AXIS_SETTABLE },
+  { 5, kCipUdint, EncodeCipUdint, (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipMotionAxis, estop_decel_max), MOTION_AXIS_SETTABLE },
+  { 6, kCipUsint, EncodeCipUsint, NULL,
+    offsetof(CipMotionAxis, sample.hlfb_state), MOTION_AXIS_LIVE },
+  { 7, kCipReal, EncodeCipReal, NULL,
+    offsetof(CipMotionAxis, sample.hlfb_percent), MOTION_AXIS_LIVE },
+  { 8, kCipDword, EncodeCipDword, NULL,
+    offsetof(CipMotionAxis, sample.status_reg), MOTION_AXIS_LIVE },
+  { 9, kCipDword, EncodeCipDword, NULL,
+    offsetof(CipMotionAxis, sample.alert_reg), MOTION_AXIS_LIVE },
+  { 10, kCipBool, EncodeCipBool, (CipAttributeDecodeFromMessage)DecodeCipBool,
+    offsetof(CipMotionAxis, enable_request), MOTION_AXIS_SETTABLE },
+};
+
+#define MOTION_AXIS_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kMotionAxisAttributes)
+
+/** @brief Commanded position, the first attribute read from the MotorDriver
+ *  sample; position, velocity, HLFB and both registers come from one
+ *  ClearCoreMotorSampleRead() so that a reply shows a single sample time */
+static const CipUint kMotionAxisFirstLiveAttribute = 1U;
+
+/* Default limits in steps/s and steps/s^2, applied at initialization */
+#define MOTION_AXIS_DEFAULT_VEL_MAX 10000U
+#define MOTION_AXIS_DEFAULT_ACCEL_MAX 100000U
+#define MOTION_AXIS_DEFAULT_ESTOP_DECEL_MAX 500000U
+
+static CipMotionAxis s_motion_axes[CIP_MOTION_AXIS_INSTANCE_COUNT];
+
+static void MotionAxisRefreshSample(CipMotionAxis *const axis) {
+  ClearCoreMotorSampleRead(axis->axis, &axis->sample);
+}
+
+static CipMotionAxis *MotionAxisFromAssembly(CipInstanceNum assembly_instance,
+                                             CipUint assembly_base) {
+  if( (assembly_instance < assembly_base) ||
+      (assembly_instance >= assembly_base + CIP_MOTION_AXIS_INSTANCE_COUNT) ) {
+    return NULL;
+  }
+  return &s_motion_axes[assembly_instance - assembly_base];
+}
+
+static void MotionAxisPutDint(CipOctet *const buffer,
+                              const CipUdint value) {
+  buffer[0] = (CipOctet) value;
+  buffer[1] = (CipOctet) (value >> 8);
+  buffer[2] = (CipOctet) (value >> 16);
+  buffer[3] = (CipOctet) (value >> 24);
+}
+
+EipStatus MotionAxisPreGetCallback(CipInstance *const instance,
+                                   CipAttributeStruct *const attribute,
+                                   CipByte service) {
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kMotionAxisFirstLiveAttribute) ) {
+    MotionAxisRefreshSample(axis);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus MotionAxisPostSetCallback(CipInstance *const instance,
+                                    CipAttributeStruct *const attribute,
+                                    CipByte service) {
+  (void) service;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  switch(attribute->attribute_number) {
+    case 3:
+      ClearCoreMotorVelMax(axis->axis, axis->vel_max);
+      break;
+    case 4:
+      ClearCoreMotorAccelMax(axis->axis, axis->accel_max);
+      break;
+    case 5:
+      ClearCoreMotorEStopDecelMax(axis->axis, axis->estop_decel_max);
+      break;
+    case 10:
+      ClearCoreMotorEnable(axis->axis, axis->enable_request);
+      break;
+    default:
+      break;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus MotionAxisMove(CipInstance *RESTRICT const instance,
+                         CipMessageRouterRequest *const message_router_request,
+                         CipMessageRouterResponse *const message_router_response,
+                         const struct sockaddr *originator_address,
+                         const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 4, 5) ) {
+    CipDint distance = GetDintFromMessage(&message_router_request->data);
+    CipUsint absolute = 0;
+    if(message_router_request->request_data_size > 4) {
+      absolute = GetUsintFromMessage(&message_router_request->data);
+    }
+    if(absolute > 1) {
+      message_router_response->general_status = kCipErrorInvalidParameter;
+    } else if( !ClearCoreMotorMove(axis->axis, distance, absolute) ) {
+      OPENER_TRACE_WARN("MotionAxis: move rejected on axis %u\n", axis->axis);
+      message_router_response->general_status = kCipErrorObjectStateConflict;
+    }
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus MotionAxisMoveVelocity(CipInstance *RESTRICT const instance,
+                                 CipMessageRouterRequest *const message_router_request,
+                                 CipMessageRouterResponse *const message_router_response,
+                                 const struct sockaddr *originator_address,
+                                 const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 4, 4) ) {
+    CipDint velocity = GetDintFromMessage(&message_router_request->data);
+    if( !ClearCoreMotorMoveVelocity(axis->axis, velocity) ) {
+      OPENER_TRACE_WARN("MotionAxis: velocity move rejected on axis %u\n",
+                        axis->axis);
+      message_router_response->general_status = kCipErrorObjectStateConflict;
+    }
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus MotionAxisStop(CipInstance *RESTRICT const instance,
+                         CipMessageRouterRequest *const message_router_request,
+                         CipMessageRouterResponse *const message_router_response,
+                         const struct sockaddr *originator_address,
+                         const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 1) ) {
+    CipUsint abrupt = 0;
+    if(message_router_request->request_data_size > 0) {
+      abrupt = GetUsintFromMessage(&message_router_request->data);
+    }
+    if(abrupt > 1) {
+      message_router_response->general_status = kCipErrorInvalidParameter;
+    } else {
+      ClearCoreMotorStop(axis->axis, abrupt);
+    }
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus MotionAxisEnable(CipInstance *RESTRICT const instance,
+                           CipMessageRouterRequest *const message_router_request,
+                           CipMessageRouterResponse *const message_router_response,
+                           const struct sockaddr *originator_address,
+                           const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 1, 1) ) {
+    CipUsint enable = GetUsintFromMessage(&message_router_request->data);
+    if(enable > 1) {
+      message_router_response->general_status = kCipErrorInvalidParameter;
+    } else {
+      axis->enable_request = enable;
+      ClearCoreMotorEnable(axis->axis, enable);
+    }
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus MotionAxisClearAlerts(CipInstance *RESTRICT const instance,
+                                CipMessageRouterRequest *const message_router_request,
+                                CipMessageRouterResponse *const message_router_response,
+                                const struct sockaddr *originator_address,
+                                const CipSessionHandle encapsulation_session) {
+  (void) originator_address;
+  (void) encapsulation_session;
+  CipMotionAxis *const axis = (CipMotionAxis *) instance->data;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 0) ) {
+    ClearCoreMotorClearAlerts(axis->axis);
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus CipMotionAxisInit(void) {
+  CipClass *motion_axis_class = NULL;
+
+  if( ( motion_axis_class = CreateCipClass(kCipMotionAxisClassCode,
+                                           7, /* # class attributes */
+                                           7, /* # highest class attribute number */
+                                           2, /* # class services */
+                                           MOTION_AXIS_ATTRIBUTE_COUNT, /* # instance attributes */
+                                           10, /* # highest instance attribute number */
+                                           8, /* # instance services */
+                                           CIP_MOTION_AXIS_INSTANCE_COUNT, /* # instances */
+                                           "Motion Axis",
+                                           1, /* # class revision */
+                                           NULL /* # function pointer for initialization */
+                                           ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  ClearCoreMotorInitialize();
+
+  for(unsigned int idx = 0; idx < CIP_MOTION_AXIS_INSTANCE_COUNT; ++idx) {
+    CipMotionAxis *const axis = &s_motion_axes[idx];
+    memset(axis, 0, sizeof(*axis) );
+    axis->axis = idx;
+    axis->vel_max = MOTION_AXIS_DEFAULT_VEL_MAX;
+    axis->accel_max = MOTION_AXIS_DEFAULT_ACCEL_MAX;
+    axis->estop_decel_max = MOTION_AXIS_DEFAULT_ESTOP_DECEL_MAX;
+    ClearCoreMotorVelMax(idx, axis->vel_max);
+    ClearCoreMotorAccelMax(idx, axis->accel_max);
+    ClearCoreMotorEStopDecelMax(idx, axis->estop_decel_max);
+
+    CipInstance *const instance = GetCipInstance(motion_axis_class, idx + 1);
+    instance->data = axis;
+    InsertVendorAttributes(instance, kMotionAxisAttributes,
+                           MOTION_AXIS_ATTRIBUTE_COUNT);
+
+    CreateAssemblyObject(kMotionAxisInputAssemblyBase + idx,
+                         axis->input_assembly,
+                         sizeof(axis->input_assembly) );
+    CreateAssemblyObject(kMotionAxisOutputAssemblyBase + idx,
+                         axis->output_assembly,
+                         sizeof(axis->output_assembly) );
+  }
+
+  InsertGetSetCallback(motion_axis_class, MotionAxisPreGetCallback,
+                       kPreGetFunc);
+  InsertGetSetCallback(motion_axis_class, MotionAxisPostSetCallback,
+                       kPostSetFunc);
+
+  InsertService(motion_axis_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(motion_axis_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(motion_axis_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+  InsertService(motion_axis_class, kMotionAxisServiceMove, &MotionAxisMove,
+                "Move");
+  InsertService(motion_axis_class, kMotionAxisServiceMoveVelocity,
+                &MotionAxisMoveVelocity, "MoveVelocity");
+  InsertService(motion_axis_class, kMotionAxisServiceStop, &MotionAxisStop,
+                "Stop");
+  InsertService(motion_axis_class, kMotionAxisServiceEnable,
+                &MotionAxisEnable, "Enable");
+  InsertService(motion_axis_class, kMotionAxisServiceClearAlerts,
+                &MotionAxisClearAlerts, "ClearAlerts");
+
+  return kEipStatusOk;
+}
+
+EipBool8 CipMotionAxisAfterAssemblyDataReceived(CipInstanceNum assembly_instance)
+{
+  CipMotionAxis *const axis = MotionAxisFromAssembly(assembly_instance,
+                                                     kMotionAxisOutputAssemblyBase);
+  if(NULL == axis) {
+    return false;
+  }
+
+  const CipOctet *data = axis->output_assembly;
+  const CipUsint control = data[0];
+  const CipUsint rising = (CipUsint) (control & ~axis->last_control);
+  data += 4;
+  const CipDint position = GetDintFromMessage(&data);
+  const CipDint velocity = GetDintFromMessage(&data);
+  const CipUdint vel_max = GetUdintFromMessage(&data);
+  const CipUdint accel_max = GetUdintFromMessage(&data);
+
+  if( (0 != vel_max) && (vel_max != axis->vel_max) ) {
+    axis->vel_max = vel_max;
+    ClearCoreMotorVelMax(axis->axis, vel_max);
+  }
+  if( (0 != accel_max) && (accel_max != axis->accel_max) ) {
+    axis->accel_max = accel_max;
+    ClearCoreMotorAccelMax(axis->axis, accel_max);
+  }
+
+  /* The enable bit acts on its edges, so an Enable service or a Set of
+   * attribute 10 holds until the bit changes */
+  if( (control ^ axis->last_control) & kMotionAxisControlEnable ) {
+    axis->enable_request = (control & kMotionAxisControlEnable) ? 1 : 0;
+    ClearCoreMotorEnable(axis->axis, axis->enable_request);
+  }
+  if(rising & kMotionAxisControlClearAlerts) {
+    ClearCoreMotorClearAlerts(axis->axis);
+  }
+  if(rising & kMotionAxisControlStop) {
+    ClearCoreMotorStop(axis->axis, 0);
+  } else if(rising & kMotionAxisControlMove) {
+    ClearCoreMotorMove(axis->axis, position,
+                       (control & kMotionAxisControlAbsolute) ? 1 : 0);
+  } else if(rising & kMotionAxisControlMoveVelocity) {
+    ClearCoreMotorMoveVelocity(axis->axis, velocity);
+  }
+
+  axis->last_control = control;
+  return true;
+}
+
+void CipMotionAxisIoConnectionEvent(CipInstanceNum output_assembly,
+                                    IoConnectionEvent io_connection_event) {
+  CipMotionAxis *const axis = MotionAxisFromAssembly(output_assembly,
+                                                     kMotionAxisOutputAssemblyBase);
+  if( (NULL != axis) && (kIoConnectionEventOpened == io_connection_event) ) {
+    /* The first data of a new connection acts as edges of all bits set */
+    axis->last_control = 0;
+  }
+}
+
+EipBool8 CipMotionAxisBeforeAssemblyDataSend(CipInstanceNum assembly_instance) {
+  CipMotionAxis *const axis = MotionAxisFromAssembly(assembly_instance,
+                                                     kMotionAxisInputAssemblyBase);
+  if(NULL == axis) {
+    return false;
+  }
+
+  MotionAxisRefreshSample(axis);
+
+  CipOctet *const data = axis->input_assembly;
+  const ClearCoreMotorSample *const sample = &axis->sample;
+  MotionAxisPutDint(&data[0], (CipUdint) sample->position_commanded);
+  MotionAxisPutDint(&data[4], (CipUdint) sample->velocity_commanded);
+  MotionAxisPutDint(&data[8], sample->status_reg);
+  MotionAxisPutDint(&data[12], sample->alert_reg);
+  data[16] = sample->hlfb_state;
+  data[17] = axis->last_control;
+
+  CipInt hlfb_percent = INT16_MIN;
+  if(sample->hlfb_percent != CLEARCORE_MOTOR_HLFB_DUTY_UNKNOWN) {
+    hlfb_percent = (CipInt) (sample->hlfb_percent * 100.0f);
+  }
+  data[18] = (CipOctet) hlfb_percent;
+  data[19] = (CipOctet) ( (CipUint) hlfb_percent >> 8 );
+  return true;
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * Motion Axis Object for the ClearCore MotorDriver connectors
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPMOTIONAXIS_H_
+#define OPENER_CIPMOTIONAXIS_H_
+
+/** @file cipmotionaxis.h
+ *  @brief Public interface of the vendor specific Motion Axis Object
+ *
+ *  One instance exists for each ClearCore MotorDriver connector
+ *  (instance 1 = M-0 ... instance 4 = M-3).
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                 | Type  | Access |
+ *  |----|----------------------|-------|--------|
+ *  |  1 | PositionRefCommanded | DINT  | Get    |
+ *  |  2 | VelocityRefCommanded | DINT  | Get    |
+ *  |  3 | VelMax               | UDINT | Get/Set|
+ *  |  4 | AccelMax             | UDINT | Get/Set|
+ *  |  5 | EStopDecelMax        | UDINT | Get/Set|
+ *  |  6 | HLFB state           | USINT | Get    |
+ *  |  7 | HLFB percent         | REAL  | Get    |
+ *  |  8 | StatusReg            | DWORD | Get    |
+ *  |  9 | AlertReg             | DWORD | Get    |
+ *  | 10 | Enable request       | BOOL  | Get/Set|
+ *
+ *  Vendor specific services
+ *  ========================
+ *
+ *  - Move (0x4B): DINT distance, optional USINT target (0 relative, 1 absolute)
+ *  - MoveVelocity (0x4C): DINT velocity in steps/s
+ *  - Stop (0x4D): optional USINT (0 decelerate, 1 abrupt)
+ *  - Enable (0x4E): USINT (0 disable, 1 enable)
+ *  - ClearAlerts (0x4F): no data
+ *
+ *  Per axis I/O assemblies
+ *  =======================
+ *
+ *  The input assembly kMotionAxisInputAssemblyBase + axis (T->O, 20 bytes):
+ *  DINT PositionRefCommanded, DINT VelocityRefCommanded, DWORD StatusReg,
+ *  DWORD AlertReg, USINT HLFB state, USINT accepted control byte echo,
+ *  INT HLFB percent in 0.01 % (INT16_MIN if unknown).
+ *
+ *  The output assembly kMotionAxisOutputAssemblyBase + axis (O->T, 20 bytes):
+ *  USINT control byte (see @ref MotionAxisControlBits), 3 pad bytes,
+ *  DINT move distance/position, DINT velocity, UDINT VelMax, UDINT AccelMax.
+ *  Moves, stops and alert clears fire on the rising edge of their control bit,
+ *  VelMax/AccelMax are applied when non zero and changed.
+ *
+ *  Enable precedence
+ *  =================
+ *
+ *  The enable bit of the output assembly, the Enable service and a Set of
+ *  attribute 10 all write the enable request, the latest one wins. The enable
+ *  bit acts on its edges only: the rising edge enables the axis, the falling
+ *  edge disables it. A tool that disables the axis over explicit messaging
+ *  while the bit stays set keeps it disabled until the scanner clears and
+ *  sets the bit again. The first data of a newly opened I/O connection counts
+ *  a set enable bit as a rising edge.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Motion Axis Object class code (vendor specific range) */
+static const CipUint kCipMotionAxisClassCode = 0x64U;
+
+/** @brief Number of Motion Axis instances, one per MotorDriver connector */
+#define CIP_MOTION_AXIS_INSTANCE_COUNT 4
+
+/** @brief First input assembly instance, one per axis */
+static const CipUint kMotionAxisInputAssemblyBase = 110U;
+/** @brief First output assembly instance, one per axis */
+static const CipUint kMotionAxisOutputAssemblyBase = 160U;
+
+#define CIP_MOTION_AXIS_INPUT_ASSEMBLY_SIZE 20
+#define CIP_MOTION_AXIS_OUTPUT_ASSEMBLY_SIZE 20
+
+/** @brief Vendor specific service codes of the Motion Axis Object */
+typedef enum {
+  kMotionAxisServiceMove = 0x4B,
+  kMotionAxisServiceMoveVelocity = 0x4C,
+  kMotionAxisServiceStop = 0x4D,
+  kMotionAxisServiceEnable = 0x4E,
+  kMotionAxisServiceClearAlerts = 0x4F
+} MotionAxisServices;
+
+/** @brief Bits of the control byte in the per axis output assembly */
+typedef enum {
+  kMotionAxisControlEnable = 0x01, /**< edges: enable on rising, disable on falling */
+  kMotionAxisControlMove = 0x02, /**< edge: start positional move */
+  kMotionAxisControlAbsolute = 0x04, /**< level: positional move is absolute */
+  kMotionAxisControlMoveVelocity = 0x08, /**< edge: start velocity move */
+  kMotionAxisControlStop = 0x10, /**< edge: decelerate to stop */
+  kMotionAxisControlClearAlerts = 0x20 /**< edge: clear the alert register */
+} MotionAxisControlBits;
+
+/** @brief Create the Motion Axis class, its instances and the per axis
+ *  input/output assemblies
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipMotionAxisInit(void);
+
+/** @brief Apply a received per axis output assembly to its MotorDriver
+ *
+ *  @param assembly_instance instance number of the received assembly
+ *  @return true if the assembly belongs to the Motion Axis object
+ */
+EipBool8 CipMotionAxisAfterAssemblyDataReceived(CipInstanceNum assembly_instance);
+
+/** @brief Forget the control byte of the previous connection when an I/O
+ *  connection to a per axis output assembly opens
+ *
+ *  @param output_assembly instance number of the consumed assembly
+ *  @param io_connection_event what happened to the connection
+ */
+void CipMotionAxisIoConnectionEvent(CipInstanceNum output_assembly,
+                                    IoConnectionEvent io_connection_event);
+
+/** @brief Refresh a per axis input assembly before it is produced
+ *
+ *  @param assembly_instance instance number of the assembly to be sent
+ *  @return true if the assembly belongs to the Motion Axis object
+ */
+EipBool8 CipMotionAxisBeforeAssemblyDataSend(CipInstanceNum assembly_instance);
+
+#endif /* OPENER_CIPMOTIONAXIS_H_ */
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Network Memory Object for the lwIP pools of the ClearCore
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipnetmemory.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "cipstring.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_netmem.h"
+
+/** @brief Run time data of one Network Memory instance
+ *
+ *  The usage attributes point into @ref stats, which is refreshed from lwIP
+ *  in one call by the PreGetCallback.
+ */
+typedef struct {
+  unsigned int pool; /**< pool of clearcore_netmem.h, 0 is the heap */
+  CipShortString name; /**< Attr. #1: pool name */
+  ClearCoreNetMemStats stats; /**< last snapshot of the pool */
+} CipNetMemory;
+
+/* Attributes that are sampled from lwIP on every Get */
+#define NET_MEMORY_LIVE (kGetableSingleAndAll | kPreGetFunc)
+
+/** @brief Attribute table of the instances */
+static const CipVendorAttribute kNetMemoryAttributes[] = {
+  { 1, kCipShortString, EncodeCipShortString, NULL,
+    offsetof(CipNetMemory, name), kGetableSingleAndAll },
+  { 2, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipNetMemory, stats.avail), NET_MEMORY_LIVE },
+  { 3, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipNetMemory, stats.used), NET_MEMORY_LIVE },
+  { 4, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipNetMemory, stats.max), NET_MEMORY_LIVE },
+  { 5, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipNetMemory, stats.err), NET_MEMORY_LIVE },
+};
+
+#define NET_MEMORY_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kNetMemoryAttributes)
+
+/** @brief Lowest live attribute, #1 is the fixed name; a Get_Attributes_All
+ *  reads the counters of the pool once, so that an allocation by lwIP while
+ *  the reply is encoded cannot show more in use than the maximum */
+static const CipUint kNetMemoryFirstLiveAttribute = 2U;
+
+EipStatus NetMemoryPreGetCallback(CipInstance *const instance,
+                                  CipAttributeStruct *const attribute,
+                                  CipByte service) {
+  CipNetMemory *const net_memory = (CipNetMemory *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kNetMemoryFirstLiveAttribute) ) {
+    ClearCoreNetMemRead(net_memory->pool, &net_memory->stats);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus NetMemoryReset(CipInstance *RESTRICT const instance,
+                         CipMessageRouterRequest *const message_router_request,
+                         CipMessageRouterResponse *const message_router_response,
+                         const struct sockaddr *originator_address,
+                         const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if(CheckVendorServiceDataSize(message_router_request,
+                                message_router_response, 0, 0) ) {
+    ClearCoreNetMemReset();
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus CipNetMemoryInit(void) {
+  CipClass *net_memory_class = NULL;
+  const unsigned int pool_count = ClearCoreNetMemPoolCount();
+
+  if( ( net_memory_class = CreateCipClass(kCipNetMemoryClassCode,
+                                          7, /* # class attributes */
+                                          7, /* # highest class attribute number */
+                                          2, /* # class services */
+                                          NET_MEMORY_ATTRIBUTE_COUNT, /* # instance attributes */
+                                          5, /* # highest instance attribute number */
+                                          3, /* # instance services */
+                                          pool_count, /* # instances */
+                                          "Network Memory",
+                                          1, /* # class revision */
+                                          NULL /* # function pointer for initialization */
+                                          ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  CipNetMemory *const pools =
+    (CipNetMemory *) CipCalloc(pool_count, sizeof(CipNetMemory) );
+  if(NULL == pools) {
+    OPENER_TRACE_ERR("Network Memory: no memory for %u instances\n",
+                     pool_count);
+    return kEipStatusError;
+  }
+
+  for(unsigned int pool = 0; pool < pool_count; ++pool) {
+    CipNetMemory *const net_memory = &pools[pool];
+    net_memory->pool = pool;
+    SetCipShortStringByCstr(&net_memory->name,
+                            ClearCoreNetMemPoolName(pool) );
+    ClearCoreNetMemRead(pool, &net_memory->stats);
+
+    CipInstance *const instance = GetCipInstance(net_memory_class, pool + 1);
+    instance->data = net_memory;
+    InsertVendorAttributes(instance, kNetMemoryAttributes,
+                           NET_MEMORY_ATTRIBUTE_COUNT);
+  }
+
+  InsertGetSetCallback(net_memory_class, NetMemoryPreGetCallback,
+                       kPreGetFunc);
+
+  InsertService(net_memory_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(net_memory_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(net_memory_class, kNetMemoryServiceReset, &NetMemoryReset,
+                "Reset");
+
+  return kEipStatusOk;
+}
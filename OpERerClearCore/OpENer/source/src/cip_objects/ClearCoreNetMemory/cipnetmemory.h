@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Network Memory Object for the lwIP pools of the ClearCore
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPNETMEMORY_H_
+#define OPENER_CIPNETMEMORY_H_
+
+/** @file cipnetmemory.h
+ *  @brief Public interface of the vendor specific Network Memory Object
+ *
+ *  Instance 1 is the lwIP heap, which holds the PBUF_RAM replies and the
+ *  TCP data, in bytes. Instances 2 and up are the memp pools of lwIP in
+ *  elements, in the order of lwip/priv/memp_std.h; attribute 1 tells which
+ *  pool an instance is. A growing error count shows a pool that the memory
+ *  profile of lwipopts.h makes too small for the traffic.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type         | Access |
+ *  |----|------------------------|--------------|--------|
+ *  |  1 | Pool name              | SHORT_STRING | Get    |
+ *  |  2 | Available              | UDINT        | Get    |
+ *  |  3 | Used                   | UDINT        | Get    |
+ *  |  4 | Max used               | UDINT        | Get    |
+ *  |  5 | Failed allocations     | UDINT        | Get    |
+ *
+ *  Vendor specific services
+ *  ========================
+ *
+ *  - Reset (0x4B): no data, restarts the max used of all pools from their
+ *    current use and clears the failed allocations
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Network Memory Object class code (vendor specific range) */
+static const CipUint kCipNetMemoryClassCode = 0x6CU;
+
+/** @brief Vendor specific service codes of the Network Memory Object */
+typedef enum {
+  kNetMemoryServiceReset = 0x4B
+} NetMemoryServices;
+
+/** @brief Create the Network Memory class and one instance per pool
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipNetMemoryInit(void);
+
+#endif /* OPENER_CIPNETMEMORY_H_ */
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * ISR Profiler Object for the ClearCore background processing
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipprofiler.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "cipstring.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_profiler.h"
+
+/** @brief Run time data of one ISR Profiler instance
+ *
+ *  The statistics attributes point into @ref stats, which is refreshed from
+ *  the SysProfiler in one call by the PreGetCallback.
+ */
+typedef struct {
+  unsigned int section; /**< SysProfiler section of the instance */
+  CipShortString name; /**< Attr. #1: section name */
+  ClearCoreProfilerStats stats; /**< last snapshot of the section */
+} CipProfiler;
+
+/* Attributes that are sampled from the SysProfiler on every Get */
+#define PROFILER_LIVE (kGetableSingleAndAll | kPreGetFunc)
+
+static void EncodeProfilerHistogram(const void *const data,
+                                    ENIPMessage *const outgoing_message);
+
+/** @brief Attribute table of the instances */
+static const CipVendorAttribute kProfilerAttributes[] = {
+  { 1, kCipShortString, EncodeCipShortString, NULL,
+    offsetof(CipProfiler, name), kGetableSingleAndAll },
+  { 2, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipProfiler, stats.count), PROFILER_LIVE },
+  { 3, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipProfiler, stats.min), PROFILER_LIVE },
+  { 4, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipProfiler, stats.max), PROFILER_LIVE },
+  { 5, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipProfiler, stats.mean), PROFILER_LIVE },
+  { 6, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(CipProfiler, stats.overruns), PROFILER_LIVE },
+  { 7, kCipUdint, EncodeCipUdint,
+    (CipAttributeDecodeFromMessage)DecodeCipUdint,
+    offsetof(CipProfiler, stats.budget),
+    PROFILER_LIVE | kSetAndGetAble | kPostSetFunc },
+  { 8, kCipAny, EncodeProfilerHistogram, NULL,
+    offsetof(CipProfiler, stats.hist), PROFILER_LIVE },
+};
+
+#define PROFILER_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kProfilerAttributes)
+
+/** @brief Update count, the first attribute read from the section snapshot;
+ *  ClearCoreProfilerRead() takes the counters, the budget and the histogram
+ *  from one SysProfiler snapshot, so that the count, mean and histogram of a
+ *  reply cover the same updates */
+static const CipUint kProfilerFirstLiveAttribute = 2U;
+
+static void EncodeProfilerHistogram(const void *const data,
+                                    ENIPMessage *const outgoing_message) {
+  const uint32_t *const hist = (const uint32_t *) data;
+  for(size_t i = 0; i < CLEARCORE_PROFILER_HIST_BINS; ++i) {
+    AddDintToMessage(hist[i], outgoing_message);
+  }
+}
+
+EipStatus ProfilerPreGetCallback(CipInstance *const instance,
+                                 CipAttributeStruct *const attribute,
+                                 CipByte service) {
+  CipProfiler *const profiler = (CipProfiler *) instance->data;
+
+  if( VendorAttributeSampleDue(attribute, service,
+                               kProfilerFirstLiveAttribute) ) {
+    ClearCoreProfilerRead(profiler->section, &profiler->stats);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus ProfilerPostSetCallback(CipInstance *const instance,
+                                  CipAttributeStruct *const attribute,
+                                  CipByte service) {
+  (void) service;
+  CipProfiler *const profiler = (CipProfiler *) instance->data;
+
+  if(7 == attribute->attribute_number) {
+    ClearCoreProfilerBudgetSet(profiler->section, profiler->stats.budget);
+  }
+  return kEipStatusOk;
+}
+
+EipStatus ProfilerReset(CipInstance *RESTRICT const instance,
+                        CipMessageRouterRequest *const message_router_request,
+                        CipMessageRouterResponse *const message_router_response,
+                        const struct sockaddr *originator_address,
+                        const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 0) ) {
+    ClearCoreProfilerReset();
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus ProfilerDumpUsb(CipInstance *RESTRICT const instance,
+                          CipMessageRouterRequest *const message_router_request,
+                          CipMessageRouterResponse *const message_router_response,
+                          const struct sockaddr *originator_address,
+                          const CipSessionHandle encapsulation_session) {
+  (void) instance;
+  (void) originator_address;
+  (void) encapsulation_session;
+
+  GenerateVendorServiceResponseHeader(message_router_request,
+                                      message_router_response);
+  if( CheckVendorServiceDataSize(message_router_request,
+                                 message_router_response, 0, 0) ) {
+    ClearCoreProfilerDump();
+  }
+  return kEipStatusOkSend;
+}
+
+EipStatus CipProfilerInit(void) {
+  CipClass *profiler_class = NULL;
+  const unsigned int section_count = ClearCoreProfilerSectionCount();
+
+  if( ( profiler_class = CreateCipClass(kCipProfilerClassCode,
+                                        7, /* # class attributes */
+                                        7, /* # highest class attribute number */
+                                        2, /* # class services */
+                                        PROFILER_ATTRIBUTE_COUNT, /* # instance attributes */
+                                        8, /* # highest instance attribute number */
+                                        5, /* # instance services */
+                                        section_count, /* # instances */
+                                        "ISR Profiler",
+                                        1, /* # class revision */
+                                        NULL /* # function pointer for initialization */
+                                        ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  CipProfiler *const profilers =
+    (CipProfiler *) CipCalloc(section_count, sizeof(CipProfiler) );
+  if(NULL == profilers) {
+    OPENER_TRACE_ERR("Profiler: no memory for %u instances\n", section_count);
+    return kEipStatusError;
+  }
+
+  for(unsigned int section = 0; section < section_count; ++section) {
+    CipProfiler *const profiler = &profilers[section];
+    profiler->section = section;
+    SetCipShortStringByCstr(&profiler->name,
+                            ClearCoreProfilerSectionName(section) );
+    ClearCoreProfilerRead(section, &profiler->stats);
+
+    CipInstance *const instance = GetCipInstance(profiler_class,
+                                                 section + 1);
+    instance->data = profiler;
+    InsertVendorAttributes(instance, kProfilerAttributes,
+                           PROFILER_ATTRIBUTE_COUNT);
+  }
+
+  InsertGetSetCallback(profiler_class, ProfilerPreGetCallback, kPreGetFunc);
+  InsertGetSetCallback(profiler_class, ProfilerPostSetCallback, kPostSetFunc);
+
+  InsertService(profiler_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(profiler_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(profiler_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+  InsertService(profiler_class, kProfilerServiceReset, &ProfilerReset,
+                "Reset");
+  InsertService(profiler_class, kProfilerServiceDumpUsb, &ProfilerDumpUsb,
+                "DumpUsb");
+
+  return kEipStatusOk;
+}
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * ISR Profiler Object for the ClearCore background processing
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPPROFILER_H_
+#define OPENER_CIPPROFILER_H_
+
+/** @file cipprofiler.h
+ *  @brief Public interface of the vendor specific ISR Profiler Object
+ *
+ *  One instance exists for each section profiled by the ClearCore
+ *  SysProfiler (instance 1 = total of the fast update, see
+ *  ClearCoreProfilerSectionName() for the others). All times are in CPU
+ *  cycles of the 120 MHz core clock, the fast update has a budget of 24000
+ *  cycles per 5 kHz sample.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type         | Access |
+ *  |----|------------------------|--------------|--------|
+ *  |  1 | Section name           | SHORT_STRING | Get    |
+ *  |  2 | Count                  | UDINT        | Get    |
+ *  |  3 | Min cycles             | UDINT        | Get    |
+ *  |  4 | Max cycles             | UDINT        | Get    |
+ *  |  5 | Mean cycles            | UDINT        | Get    |
+ *  |  6 | Overruns               | UDINT        | Get    |
+ *  |  7 | Budget cycles          | UDINT        | Get/Set|
+ *  |  8 | Histogram              | UDINT[20]    | Get    |
+ *
+ *  Bin 0 of the histogram counts updates that took no cycles, bin n the
+ *  updates that took 2^(n-1) .. 2^n - 1 cycles, the last bin also counts
+ *  everything above. A budget of 0 disables
+ *  the overrun check of the section.
+ *
+ *  Vendor specific services
+ *  ========================
+ *
+ *  - Reset (0x4B): no data, clears the statistics of all sections
+ *  - DumpUsb (0x4C): no data, prints all sections to the USB serial port
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief ISR Profiler Object class code (vendor specific range) */
+static const CipUint kCipProfilerClassCode = 0x66U;
+
+/** @brief Vendor specific service codes of the ISR Profiler Object */
+typedef enum {
+  kProfilerServiceReset = 0x4B,
+  kProfilerServiceDumpUsb = 0x4C
+} ProfilerServices;
+
+/** @brief Create the ISR Profiler class and one instance per section
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipProfilerInit(void);
+
+#endif /* OPENER_CIPPROFILER_H_ */
@@ -0,0 +1,481 @@
+/*******************************************************************************
+ * Serial Gateway Object for the ClearCore COM-0 and COM-1 ports
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cipserialgateway.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "cipvendorobject.h"
+#include "ciperror.h"
+#include "endianconv.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_serial.h"
+
+#define SERIAL_GATEWAY_PORTS 2
+
+/* Slowest and fastest baud rate that is accepted */
+#define SERIAL_GATEWAY_BAUD_MIN 300U
+#define SERIAL_GATEWAY_BAUD_MAX 4000000U
+
+/** @brief Run time data of one port instance */
+typedef struct {
+  CipUsint port; /**< ClearCoreSerialPort of the instance */
+  CipBool open; /**< Attr. #1 */
+  CipUsint mode; /**< Attr. #2: ClearCoreSerialMode */
+  CipUdint baud_rate; /**< Attr. #3 */
+  CipUsint parity; /**< Attr. #4: ClearCoreSerialParity */
+  CipUsint stop_bits; /**< Attr. #5 */
+  CipUint timeout; /**< Attr. #6, in ms */
+  CipUdint transactions; /**< Attr. #7 */
+  CipUdint timeouts; /**< Attr. #8 */
+  CipDword errors; /**< Attr. #9 */
+  CipUsint queued; /**< Attr. #10 */
+  CipUsint queue[CIP_SERIAL_GATEWAY_SLOTS]; /**< slots in submission order */
+  CipUsint queue_head;
+  CipBool active; /**< the request at the queue head was sent */
+  MilliSeconds elapsed; /**< since the active request was sent */
+} SerialGatewayPort;
+
+/** @brief A request taken from an output slot */
+typedef struct {
+  CipUsint sequence; /**< last sequence taken from the slot */
+  CipBool busy; /**< queued or sent and not answered yet */
+  CipUsint port;
+  CipUsint request_length;
+  CipUsint expected_length;
+  CipUsint response_length;
+  CipBool truncated;
+  CipOctet request[CIP_SERIAL_GATEWAY_DATA_SIZE];
+  CipOctet response[CIP_SERIAL_GATEWAY_DATA_SIZE];
+} SerialGatewaySlot;
+
+/* Settings that open the port again after every Set */
+#define SERIAL_GATEWAY_SETTING (kSetAndGetAble | kPostSetFunc)
+
+static int DecodeSerialGatewayOpen(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response);
+static int DecodeSerialGatewayMode(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response);
+static int DecodeSerialGatewayBaudRate(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response);
+static int DecodeSerialGatewayParity(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response);
+static int DecodeSerialGatewayStopBits(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response);
+
+/** @brief Attribute table of the instances */
+static const CipVendorAttribute kSerialGatewayAttributes[] = {
+  { 1, kCipBool, EncodeCipBool, DecodeSerialGatewayOpen,
+    offsetof(SerialGatewayPort, open), kSetAndGetAble },
+  { 2, kCipUsint, EncodeCipUsint, DecodeSerialGatewayMode,
+    offsetof(SerialGatewayPort, mode), SERIAL_GATEWAY_SETTING },
+  { 3, kCipUdint, EncodeCipUdint, DecodeSerialGatewayBaudRate,
+    offsetof(SerialGatewayPort, baud_rate), SERIAL_GATEWAY_SETTING },
+  { 4, kCipUsint, EncodeCipUsint, DecodeSerialGatewayParity,
+    offsetof(SerialGatewayPort, parity), SERIAL_GATEWAY_SETTING },
+  { 5, kCipUsint, EncodeCipUsint, DecodeSerialGatewayStopBits,
+    offsetof(SerialGatewayPort, stop_bits), SERIAL_GATEWAY_SETTING },
+  { 6, kCipUint, EncodeCipUint, (CipAttributeDecodeFromMessage)DecodeCipUint,
+    offsetof(SerialGatewayPort, timeout), kSetAndGetAble },
+  { 7, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(SerialGatewayPort, transactions), kGetableSingleAndAll },
+  { 8, kCipUdint, EncodeCipUdint, NULL,
+    offsetof(SerialGatewayPort, timeouts), kGetableSingleAndAll },
+  { 9, kCipDword, EncodeCipDword, NULL,
+    offsetof(SerialGatewayPort, errors), kGetableSingleAndAll },
+  { 10, kCipUsint, EncodeCipUsint, NULL,
+    offsetof(SerialGatewayPort, queued), kGetableSingleAndAll },
+};
+
+#define SERIAL_GATEWAY_ATTRIBUTE_COUNT \
+  CIP_VENDOR_ATTRIBUTE_COUNT(kSerialGatewayAttributes)
+
+static SerialGatewayPort s_ports[SERIAL_GATEWAY_PORTS];
+static SerialGatewaySlot s_slots[CIP_SERIAL_GATEWAY_SLOTS];
+static CipBool s_cos_triggered; /**< production requested for the
+                                   responses */
+static CipBool s_responses_new; /**< responses completed since the last
+                                   production */
+static CipOctet s_input_assembly[CIP_SERIAL_GATEWAY_ASSEMBLY_SIZE];
+static CipOctet s_output_assembly[CIP_SERIAL_GATEWAY_ASSEMBLY_SIZE];
+
+/** @brief The instance of a ClearCoreSerialPort, NULL for others */
+static SerialGatewayPort *SerialGatewayPortGet(const CipUsint port) {
+  if(port < kClearCoreSerialPortCom0 || port > kClearCoreSerialPortCom1) {
+    return NULL;
+  }
+  return &s_ports[port - kClearCoreSerialPortCom0];
+}
+
+/** @brief Open the port with the settings of its instance */
+static int SerialGatewayPortOpen(const SerialGatewayPort *const port) {
+  const ClearCoreSerialConfig config = {
+    .mode = port->mode,
+    .baud_rate = port->baud_rate,
+    .parity = port->parity,
+    .stop_bits = port->stop_bits
+  };
+  return ClearCoreSerialOpen(port->port, &config);
+}
+
+static int DecodeSerialGatewayOpen(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response)
+{
+  SerialGatewayPort *const port =
+    (SerialGatewayPort *) ( (CipOctet *) data -
+                            offsetof(SerialGatewayPort, open) );
+  const CipBool open = GetBoolFromMessage(&message_router_request->data);
+  if( !(open ? SerialGatewayPortOpen(port) :
+        ClearCoreSerialOpen(port->port, NULL) ) ) {
+    OPENER_TRACE_WARN("Serial gateway: port %u refused\n", port->port);
+    message_router_response->general_status = kCipErrorObjectStateConflict;
+    return -1;
+  }
+  port->open = open ? true : false;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+/** @brief Decode a USINT setting and check that it is in [min, max] */
+static int DecodeSerialGatewayUsint(void *const data,
+                                    CipMessageRouterRequest *const message_router_request,
+                                    CipMessageRouterResponse *const message_router_response,
+                                    const CipUsint min,
+                                    const CipUsint max) {
+  const CipUsint value = GetUsintFromMessage(&message_router_request->data);
+  if(value < min || value > max) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUsint *) data = value;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 1;
+}
+
+static int DecodeSerialGatewayMode(void *const data,
+                                   CipMessageRouterRequest *const message_router_request,
+                                   CipMessageRouterResponse *const message_router_response)
+{
+  return DecodeSerialGatewayUsint(data, message_router_request,
+                                  message_router_response,
+                                  kClearCoreSerialModeTtl,
+                                  kClearCoreSerialModeRs232);
+}
+
+static int DecodeSerialGatewayParity(void *const data,
+                                     CipMessageRouterRequest *const message_router_request,
+                                     CipMessageRouterResponse *const message_router_response)
+{
+  return DecodeSerialGatewayUsint(data, message_router_request,
+                                  message_router_response,
+                                  kClearCoreSerialParityNone,
+                                  kClearCoreSerialParityEven);
+}
+
+static int DecodeSerialGatewayStopBits(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response)
+{
+  return DecodeSerialGatewayUsint(data, message_router_request,
+                                  message_router_response, 1, 2);
+}
+
+static int DecodeSerialGatewayBaudRate(void *const data,
+                                       CipMessageRouterRequest *const message_router_request,
+                                       CipMessageRouterResponse *const message_router_response)
+{
+  const CipUdint baud_rate =
+    GetUdintFromMessage(&message_router_request->data);
+  if(baud_rate < SERIAL_GATEWAY_BAUD_MIN ||
+     baud_rate > SERIAL_GATEWAY_BAUD_MAX) {
+    message_router_response->general_status = kCipErrorInvalidAttributeValue;
+    return -1;
+  }
+  *(CipUdint *) data = baud_rate;
+  message_router_response->general_status = kCipErrorSuccess;
+  return 4;
+}
+
+/** @brief Publish the response of a slot in the input assembly */
+static void SerialGatewayRespond(const CipUsint index,
+                                 const CipUsint sequence,
+                                 const SerialGatewayStatus status,
+                                 const CipOctet *const response,
+                                 const CipUsint length) {
+  CipOctet *const slot =
+    &s_input_assembly[index * CIP_SERIAL_GATEWAY_SLOT_SIZE];
+  slot[0] = sequence;
+  slot[1] = (CipOctet) status;
+  slot[2] = length;
+  slot[3] = 0;
+  memset(&slot[4], 0, CIP_SERIAL_GATEWAY_DATA_SIZE);
+  if(length > 0) {
+    memcpy(&slot[4], response, length);
+  }
+  s_responses_new = true;
+}
+
+/** @brief Answer the request at the queue head of a port and dequeue it */
+static void SerialGatewayComplete(SerialGatewayPort *const port,
+                                  const SerialGatewayStatus status) {
+  const CipUsint index = port->queue[port->queue_head];
+  SerialGatewaySlot *const slot = &s_slots[index];
+  SerialGatewayRespond(index, slot->sequence, status, slot->response,
+                       slot->response_length);
+  slot->busy = false;
+  port->queue_head = (port->queue_head + 1) % CIP_SERIAL_GATEWAY_SLOTS;
+  port->queued--;
+  port->active = false;
+  port->transactions++;
+}
+
+/** @brief Take the new requests from the output assembly
+ *
+ *  A slot is only looked at once its previous request was answered, so a
+ *  request that is sent again with the same sequence is not repeated.
+ */
+static void SerialGatewayAccept(void) {
+  for(CipUsint i = 0; i < CIP_SERIAL_GATEWAY_SLOTS; ++i) {
+    SerialGatewaySlot *const slot = &s_slots[i];
+    const CipOctet *const request =
+      &s_output_assembly[i * CIP_SERIAL_GATEWAY_SLOT_SIZE];
+    if(slot->busy || 0 == request[0] || slot->sequence == request[0]) {
+      continue;
+    }
+    slot->sequence = request[0];
+    SerialGatewayPort *const port = SerialGatewayPortGet(request[1]);
+    const CipUsint expected = request[3];
+    if(NULL == port || request[2] > CIP_SERIAL_GATEWAY_DATA_SIZE ||
+       (expected > CIP_SERIAL_GATEWAY_DATA_SIZE &&
+        kSerialGatewayNoResponse != expected) ) {
+      SerialGatewayRespond(i, slot->sequence, kSerialGatewayStatusInvalid,
+                           NULL, 0);
+      continue;
+    }
+    slot->port = request[1];
+    slot->request_length = request[2];
+    slot->expected_length = expected;
+    slot->response_length = 0;
+    slot->truncated = false;
+    memcpy(slot->request, &request[4], slot->request_length);
+    slot->busy = true;
+    port->queue[(port->queue_head + port->queued) %
+                CIP_SERIAL_GATEWAY_SLOTS] = i;
+    port->queued++;
+  }
+}
+
+/** @brief Collect the response bytes of the active request
+ *
+ *  Bytes beyond the slot are read and dropped, so that the idle line still
+ *  ends the response.
+ */
+static void SerialGatewayReceive(const SerialGatewayPort *const port,
+                                 SerialGatewaySlot *const slot) {
+  const CipUsint space = CIP_SERIAL_GATEWAY_DATA_SIZE - slot->response_length;
+  if(space > 0) {
+    slot->response_length += (CipUsint) ClearCoreSerialRead(port->port,
+                                                            &slot->response[
+                                                              slot->
+                                                              response_length],
+                                                            space);
+  }
+  if(CIP_SERIAL_GATEWAY_DATA_SIZE == slot->response_length) {
+    CipOctet overflow[CIP_SERIAL_GATEWAY_DATA_SIZE];
+    while(ClearCoreSerialRead(port->port, overflow, sizeof(overflow) ) > 0) {
+      slot->truncated = true;
+    }
+  }
+}
+
+/** @brief Run the transactions of a port until one waits for its response
+ *
+ *  @param elapsed time to count against the response timeout
+ */
+static void SerialGatewayPump(SerialGatewayPort *const port,
+                              const MilliSeconds elapsed) {
+  if(port->open) {
+    port->errors |= ClearCoreSerialErrors(port->port);
+  }
+  while(port->queued > 0) {
+    SerialGatewaySlot *const slot = &s_slots[port->queue[port->queue_head]];
+    if(!port->open) {
+      SerialGatewayComplete(port, kSerialGatewayStatusPortClosed);
+      continue;
+    }
+    if(!port->active) {
+      /* Whatever arrived before the request is not its response */
+      ClearCoreSerialFlushInput(port->port);
+      if(ClearCoreSerialWrite(port->port, slot->request,
+                              slot->request_length) != slot->request_length) {
+        SerialGatewayComplete(port, kSerialGatewayStatusSendFailed);
+        continue;
+      }
+      if(kSerialGatewayNoResponse == slot->expected_length) {
+        SerialGatewayComplete(port, kSerialGatewayStatusOk);
+        continue;
+      }
+      port->active = true;
+      port->elapsed = 0;
+    }
+    else {
+      port->elapsed += elapsed;
+    }
+
+    SerialGatewayReceive(port, slot);
+    const CipBool complete = (0 != slot->expected_length) ?
+                             (slot->response_length >= slot->expected_length) :
+                             (slot->response_length > 0 &&
+                              ClearCoreSerialRxIdle(port->port) );
+    if(complete) {
+      SerialGatewayComplete(port, slot->truncated ?
+                            kSerialGatewayStatusTruncated :
+                            kSerialGatewayStatusOk);
+      continue;
+    }
+    if(port->elapsed >= port->timeout) {
+      port->timeouts++;
+      SerialGatewayComplete(port, kSerialGatewayStatusTimeout);
+      continue;
+    }
+    return;
+  }
+}
+
+/** @brief Take new requests and run both ports, then ask for the production
+ *  of new responses */
+static void SerialGatewayRun(const MilliSeconds elapsed) {
+  SerialGatewayAccept();
+  for(size_t i = 0; i < SERIAL_GATEWAY_PORTS; ++i) {
+    SerialGatewayPump(&s_ports[i], elapsed);
+  }
+  /* Trigger once per production, a new trigger would restart the inhibit
+   * time */
+  if(s_responses_new && !s_cos_triggered) {
+    if(kEipStatusOk == TriggerConnections(kSerialGatewayOutputAssembly,
+                                          kSerialGatewayInputAssembly) ) {
+      s_cos_triggered = true;
+    }
+  }
+}
+
+EipStatus SerialGatewayPostSetCallback(CipInstance *const instance,
+                                       CipAttributeStruct *const attribute,
+                                       CipByte service) {
+  (void) attribute;
+  (void) service;
+  SerialGatewayPort *const port = (SerialGatewayPort *) instance->data;
+
+  /* A changed setting takes effect by opening the port again */
+  if(port->open && !SerialGatewayPortOpen(port) ) {
+    OPENER_TRACE_WARN("Serial gateway: port %u closed, settings refused\n",
+                      port->port);
+    port->open = false;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CipSerialGatewayInit(void) {
+  CipClass *gateway_class = NULL;
+
+  if( ( gateway_class = CreateCipClass(kCipSerialGatewayClassCode,
+                                       7, /* # class attributes */
+                                       7, /* # highest class attribute number */
+                                       2, /* # class services */
+                                       SERIAL_GATEWAY_ATTRIBUTE_COUNT, /* # instance attributes */
+                                       10, /* # highest instance attribute number */
+                                       3, /* # instance services */
+                                       SERIAL_GATEWAY_PORTS, /* # instances */
+                                       "Serial Gateway",
+                                       1, /* # class revision */
+                                       NULL /* # function pointer for initialization */
+                                       ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  memset(s_ports, 0, sizeof(s_ports) );
+  memset(s_slots, 0, sizeof(s_slots) );
+  memset(s_input_assembly, 0, sizeof(s_input_assembly) );
+  memset(s_output_assembly, 0, sizeof(s_output_assembly) );
+  s_cos_triggered = false;
+  s_responses_new = false;
+
+  for(size_t i = 0; i < SERIAL_GATEWAY_PORTS; ++i) {
+    SerialGatewayPort *const port = &s_ports[i];
+    port->port = (CipUsint) (kClearCoreSerialPortCom0 + i);
+    port->mode = kClearCoreSerialModeTtl;
+    port->baud_rate = 9600;
+    port->parity = kClearCoreSerialParityNone;
+    port->stop_bits = 1;
+    port->timeout = 500;
+#if defined(CLEARCORE_SERIAL_GATEWAY_PORTS) && 0 != CLEARCORE_SERIAL_GATEWAY_PORTS
+    if( (CLEARCORE_SERIAL_GATEWAY_PORTS & (1U << i) ) &&
+        SerialGatewayPortOpen(port) ) {
+      port->open = true;
+    }
+#endif
+
+    CipInstance *const instance = GetCipInstance(gateway_class,
+                                                 (CipInstanceNum) (i + 1) );
+    instance->data = port;
+    InsertVendorAttributes(instance, kSerialGatewayAttributes,
+                           SERIAL_GATEWAY_ATTRIBUTE_COUNT);
+  }
+
+  CreateAssemblyObject(kSerialGatewayInputAssembly,
+                       s_input_assembly,
+                       sizeof(s_input_assembly) );
+  CreateAssemblyObject(kSerialGatewayOutputAssembly,
+                       s_output_assembly,
+                       sizeof(s_output_assembly) );
+
+  InsertGetSetCallback(gateway_class, SerialGatewayPostSetCallback,
+                       kPostSetFunc);
+
+  InsertService(gateway_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(gateway_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(gateway_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+
+  return kEipStatusOk;
+}
+
+void CipSerialGatewayHandleApplication(MilliSeconds elapsed) {
+  SerialGatewayRun(elapsed);
+}
+
+EipBool8 CipSerialGatewayAfterAssemblyDataReceived(
+  CipInstanceNum assembly_instance) {
+  if(kSerialGatewayOutputAssembly != assembly_instance) {
+    return false;
+  }
+
+  /* Send new requests right away instead of at the next timer tick */
+  SerialGatewayRun(0);
+  return true;
+}
+
+EipBool8 CipSerialGatewayBeforeAssemblyDataSend(
+  CipInstanceNum assembly_instance) {
+  if(kSerialGatewayInputAssembly != assembly_instance) {
+    return false;
+  }
+
+  /* The responses are published as they complete */
+  s_responses_new = false;
+  s_cos_triggered = false;
+  return true;
+}
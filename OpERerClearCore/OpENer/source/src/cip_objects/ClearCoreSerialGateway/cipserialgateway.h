@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Serial Gateway Object for the ClearCore COM-0 and COM-1 ports
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPSERIALGATEWAY_H_
+#define OPENER_CIPSERIALGATEWAY_H_
+
+/** @file cipserialgateway.h
+ *  @brief Public interface of the vendor specific Serial Gateway Object
+ *
+ *  Maps request/response transactions with serial devices, e.g. scales,
+ *  barcode readers or Modbus RTU drives, onto I/O assemblies. Instance 1 is
+ *  COM-0, instance 2 COM-1.
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type  | Access |
+ *  |----|------------------------|-------|--------|
+ *  |  1 | Port open              | BOOL  | Get/Set|
+ *  |  2 | Mode                   | USINT | Get/Set|
+ *  |  3 | Baud rate              | UDINT | Get/Set|
+ *  |  4 | Parity                 | USINT | Get/Set|
+ *  |  5 | Stop bits              | USINT | Get/Set|
+ *  |  6 | Response timeout [ms]  | UINT  | Get/Set|
+ *  |  7 | Transactions           | UDINT | Get    |
+ *  |  8 | Timeouts               | UDINT | Get    |
+ *  |  9 | Serial errors          | DWORD | Get    |
+ *  | 10 | Queued requests        | USINT | Get    |
+ *
+ *  #2 is a ClearCoreSerialMode and #4 a ClearCoreSerialParity. Setting #1
+ *  opens the port with #2 to #5 right away; setting those of an open port
+ *  opens it again. A port that carries the CCIO-8 link is refused. #9
+ *  accumulates the frame (bit 0), parity (bit 1) and overflow (bit 2) errors
+ *  of the port.
+ *
+ *  Assemblies
+ *  ==========
+ *
+ *  Both assemblies hold CIP_SERIAL_GATEWAY_SLOTS slots of
+ *  CIP_SERIAL_GATEWAY_SLOT_SIZE bytes. The response to the request in an
+ *  output slot is returned in the input slot with the same index.
+ *
+ *  kSerialGatewayOutputAssembly (O->T) request slot: USINT sequence, USINT
+ *  port (ClearCoreSerialPort), USINT request length, USINT expected response
+ *  length, then the request bytes. A new nonzero sequence submits the
+ *  request once the previous request of the slot is answered. An expected
+ *  length of 0 ends the response at the idle line,
+ *  kSerialGatewayNoResponse completes the request once it is queued to send.
+ *
+ *  kSerialGatewayInputAssembly (T->O) response slot: USINT sequence of the
+ *  answered request, USINT status (see @ref SerialGatewayStatus), USINT
+ *  response length, USINT reserved, then the response bytes.
+ *
+ *  The requests of a port are sent one at a time in the order they were
+ *  submitted, both ports run at the same time. A request is sent as soon as
+ *  its port is free and the response timeout is counted in OpENer timer
+ *  ticks. A connection with the change of state trigger is produced when a
+ *  response is complete, all others at their RPI.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Serial Gateway Object class code (vendor specific range) */
+static const CipUint kCipSerialGatewayClassCode = 0x6BU;
+
+/** @brief Input assembly instance with the responses */
+static const CipUint kSerialGatewayInputAssembly = 123U;
+
+/** @brief Output assembly instance with the requests */
+static const CipUint kSerialGatewayOutputAssembly = 165U;
+
+/** @brief Request and response slots of the assemblies */
+#define CIP_SERIAL_GATEWAY_SLOTS 4
+/** @brief Bytes of a slot, a 4 byte header and the data */
+#define CIP_SERIAL_GATEWAY_SLOT_SIZE 32
+/** @brief Longest request or response */
+#define CIP_SERIAL_GATEWAY_DATA_SIZE (CIP_SERIAL_GATEWAY_SLOT_SIZE - 4)
+
+#define CIP_SERIAL_GATEWAY_ASSEMBLY_SIZE \
+  (CIP_SERIAL_GATEWAY_SLOTS * CIP_SERIAL_GATEWAY_SLOT_SIZE)
+
+/** @brief Expected response length of a request without a response */
+#define kSerialGatewayNoResponse 0xFFU
+
+/** @brief Status of a response slot */
+typedef enum {
+  kSerialGatewayStatusOk = 0, /**< complete response */
+  kSerialGatewayStatusTimeout = 1, /**< no complete response in time, the
+                                      bytes received so far are returned */
+  kSerialGatewayStatusTruncated = 2, /**< the response was longer than the
+                                        slot */
+  kSerialGatewayStatusPortClosed = 3, /**< the port is not open */
+  kSerialGatewayStatusInvalid = 4, /**< bad port or length in the request */
+  kSerialGatewayStatusSendFailed = 5 /**< the request did not fit the send
+                                        buffer */
+} SerialGatewayStatus;
+
+/** @brief Create the Serial Gateway class, its instances and the assemblies
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipSerialGatewayInit(void);
+
+/** @brief Take new requests, run the transactions and trigger the change of
+ *  state production, called from HandleApplication()
+ *
+ *  @param elapsed time since the last call, counts down the response timeout
+ */
+void CipSerialGatewayHandleApplication(MilliSeconds elapsed);
+
+/** @brief Take the new requests of a received output assembly
+ *
+ *  @param assembly_instance instance number of the received assembly
+ *  @return true if the assembly belongs to the Serial Gateway object
+ */
+EipBool8 CipSerialGatewayAfterAssemblyDataReceived(
+  CipInstanceNum assembly_instance);
+
+/** @brief Called before the input assembly is produced
+ *
+ *  @param assembly_instance instance number of the assembly to be sent
+ *  @return true if the assembly belongs to the Serial Gateway object
+ */
+EipBool8 CipSerialGatewayBeforeAssemblyDataSend(
+  CipInstanceNum assembly_instance);
+
+#endif /* OPENER_CIPSERIALGATEWAY_H_ */
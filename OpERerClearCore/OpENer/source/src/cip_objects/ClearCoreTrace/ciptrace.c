@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Trace Object for the run time control of the OpENer traces
+ *
+ ******************************************************************************/
+
+#include "ciptrace.h"
+
+#include "opener_api.h"
+#include "cipcommon.h"
+#include "trace.h"
+#include "ports/ClearCore/clearcore_trace.h"
+
+/** @brief Attr. #2: trace levels compiled into the firmware */
+static CipUdint trace_compiled_mask;
+
+/** @brief Attr. #3: snapshot of the dropped trace records */
+static CipUdint trace_dropped;
+
+EipStatus TracePreGetCallback(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service) {
+  (void) instance;
+  (void) service;
+
+  if(3 == attribute->attribute_number) {
+    trace_dropped = ClearCoreTraceDropped();
+  }
+  return kEipStatusOk;
+}
+
+EipStatus CipTraceInit(void) {
+  CipClass *trace_class = NULL;
+
+  if( ( trace_class = CreateCipClass(kCipTraceClassCode,
+                                     7, /* # class attributes */
+                                     7, /* # highest class attribute number */
+                                     2, /* # class services */
+                                     3, /* # instance attributes */
+                                     3, /* # highest instance attribute number */
+                                     3, /* # instance services */
+                                     1, /* # instances */
+                                     "Trace",
+                                     1, /* # class revision */
+                                     NULL /* # function pointer for initialization */
+                                     ) ) == 0 ) {
+    return kEipStatusError;
+  }
+
+  trace_compiled_mask = OPENER_TRACE_COMPILED_MASK;
+  trace_dropped = 0;
+
+  CipInstance *const instance = GetCipInstance(trace_class, 1);
+  InsertAttribute(instance, 1, kCipUdint, EncodeCipUdint,
+                  (CipAttributeDecodeFromMessage)DecodeCipUdint,
+                  &g_opener_trace_mask, kSetAndGetAble);
+  InsertAttribute(instance, 2, kCipUdint, EncodeCipUdint, NULL,
+                  &trace_compiled_mask, kGetableSingleAndAll);
+  InsertAttribute(instance, 3, kCipUdint, EncodeCipUdint, NULL,
+                  &trace_dropped, kGetableSingleAndAll | kPreGetFunc);
+
+  InsertGetSetCallback(trace_class, TracePreGetCallback, kPreGetFunc);
+
+  InsertService(trace_class, kGetAttributeSingle, &GetAttributeSingle,
+                "GetAttributeSingle");
+  InsertService(trace_class, kGetAttributeAll, &GetAttributeAll,
+                "GetAttributeAll");
+  InsertService(trace_class, kSetAttributeSingle, &SetAttributeSingle,
+                "SetAttributeSingle");
+
+  return kEipStatusOk;
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Trace Object for the run time control of the OpENer traces
+ *
+ ******************************************************************************/
+#ifndef OPENER_CIPTRACE_H_
+#define OPENER_CIPTRACE_H_
+
+/** @file ciptrace.h
+ *  @brief Public interface of the vendor specific Trace Object
+ *
+ *  The single instance exposes the run time trace mask (g_opener_trace_mask)
+ *  of the trace.h macros. A trace mask holds four level bits (error,
+ *  warning, state, info) per module, module n in bits 4n to 4n + 3:
+ *
+ *  | Module | Bits  | Module                  |
+ *  |--------|-------|-------------------------|
+ *  | 0      | 0-3   | General (all others)    |
+ *  | 1      | 4-7   | Encapsulation           |
+ *  | 2      | 8-11  | Common packet format    |
+ *  | 3      | 12-15 | Connection Manager      |
+ *  | 4      | 16-19 | I/O connections         |
+ *  | 5      | 20-23 | Network handler         |
+ *  | 6      | 24-27 | ClearCore port          |
+ *
+ *  Instance attributes
+ *  ===================
+ *
+ *  | Id | Name                   | Type         | Access |
+ *  |----|------------------------|--------------|--------|
+ *  |  1 | Trace mask             | UDINT        | Get/Set|
+ *  |  2 | Compiled mask          | UDINT        | Get    |
+ *  |  3 | Dropped records        | UDINT        | Get    |
+ *
+ *  Levels not set in the compiled mask (OPENER_TRACE_MASK and
+ *  OPENER_TRACE_LEVEL of the build) are not in the firmware, setting them
+ *  in the trace mask has no effect. Dropped records counts the deferred
+ *  trace records lost because the trace ring was full.
+ */
+
+#include "typedefs.h"
+#include "ciptypes.h"
+
+/** @brief Trace Object class code (vendor specific range) */
+static const CipUint kCipTraceClassCode = 0x67U;
+
+/** @brief Create the Trace class and its instance
+ *
+ *  @return kEipStatusOk on success
+ */
+EipStatus CipTraceInit(void);
+
+#endif /* OPENER_CIPTRACE_H_ */
@@ -3,6 +3,8 @@
  * All rights reserved.
  *
  ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_CPF
+
 #include <string.h>
 
 #include "cpf.h"
@@ -3,11 +3,10 @@
  * All rights reserved.
  *
  ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_ENCAP
+
 #ifdef CLEARCORE
 #include "ports/ClearCore/socket_types.h"
-#include "lwip/udp.h"
-#include "lwip/ip_addr.h"
-#include "lwip/ip4_addr.h"
 #endif
 #include <string.h>
 #include <stdlib.h>
@@ -64,35 +63,43 @@ typedef enum {
   kCapabilityFlagsCipUdpClass0or1 = 0x0100
 } CapabilityFlags;
 
-#define ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES 2 /**< According to EIP spec at least 2 delayed message requests should be supported */
+#ifndef ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES
+#define ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES 8 /**< Originators with a pending List Identity response, the EIP spec asks for at least 2 */
+#endif
 
 /* Encapsulation layer data  */
 
-/** @brief Delayed Encapsulation Message structure */
+/** @brief Delayed List Identity response, encoded when it is sent */
 typedef struct {
-  EipInt32 time_out; /**< time out in milli seconds */
-#ifdef CLEARCORE
-  struct udp_pcb *pcb; /**< associated UDP PCB */
-#else
-  int socket; /**< associated socket */
-#endif
+  MilliSeconds due_time; /**< time of g_encapsulation_time to send at */
+  int socket; /**< socket (PCB) the request came in on */
   struct sockaddr_in receiver;
-  ENIPMessage outgoing_message;
+  CipOctet sender_context[8]; /**< of the latest request of the receiver */
 } DelayedEncapsulationMessage;
 
 EncapsulationServiceInformation g_service_information;
 
 int g_registered_sessions[OPENER_NUMBER_OF_SUPPORTED_SESSIONS];
 
+/** Pending responses sorted by falling due time, the next one is the last */
 DelayedEncapsulationMessage g_delayed_encapsulation_messages[ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES];
+size_t g_number_of_delayed_encapsulation_messages = 0;
+
+/** Time of the encapsulation layer, advanced by ManageEncapsulationMessages() */
+static MilliSeconds g_encapsulation_time = 0;
+
+/** @brief CIP Identity item of the List Identity response
+ *
+ *  Encoded again only after InvalidateListIdentityCache() or when the IP
+ *  address it holds changed, a discovery answers with a copy of it.
+ */
+static ENIPMessage g_list_identity_item;
+static bool g_list_identity_item_valid = false;
+static CipUdint g_list_identity_item_ip_address = 0;
 
 /*** private functions ***/
 void HandleReceivedListIdentityCommandTcp(const EncapsulationData *const receive_data, ENIPMessage *const outgoing_message);
 
-void HandleReceivedListIdentityCommandUdp(const int socket,
-                                          const struct sockaddr_in *const from_address,
-                                          const EncapsulationData *const receive_data);
-
 EipStatus HandleReceivedUnregisterSessionCommand(const EncapsulationData *const receive_data, ENIPMessage *const outgoing_message);
 
 EipStatus HandleReceivedSendUnitDataCommand(const EncapsulationData *const receive_data, const struct sockaddr *const originator_address,
@@ -104,7 +111,7 @@ int GetFreeSessionIndex(void);
 
 SessionStatus CheckRegisteredSessions(const EncapsulationData *const receive_data);
 
-void DetermineDelayTime(const EipByte *buffer_start, DelayedEncapsulationMessage *const delayed_message_buffer);
+EipUint16 DetermineDelayTime(const EipByte *buffer_start);
 
 /*   @brief Initializes session list and interface information. */
 void EncapsulationInit(void) {
@@ -120,13 +127,8 @@ void EncapsulationInit(void) {
     g_registered_sessions[i] = kEipInvalidSocket;
   }
 
-  for(size_t i = 0; i < ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES; i++) {
-#ifdef CLEARCORE
-    g_delayed_encapsulation_messages[i].pcb = NULL;
-#else
-    g_delayed_encapsulation_messages[i].socket = kEipInvalidSocket;
-#endif
-  }
+  g_number_of_delayed_encapsulation_messages = 0;
+  InvalidateListIdentityCache();
 
   /*TODO make the service information configurable*/
   /* initialize service information */
@@ -346,39 +348,49 @@ void HandleReceivedListIdentityCommandTcp(const EncapsulationData *const receive
   EncapsulateListIdentityResponseMessage(receive_data, outgoing_message);
 }
 
+/** @brief true when time_a comes before time_b, across the wrap around */
+static bool EncapsulationTimeIsBefore(const MilliSeconds time_a, const MilliSeconds time_b) {
+  return (EipInt32) (time_a - time_b) < 0;
+}
+
 void HandleReceivedListIdentityCommandUdp(const int socket,
                                           const struct sockaddr_in *const from_address,
                                           const EncapsulationData *const receive_data)
 {
-  DelayedEncapsulationMessage *delayed_message_buffer = NULL;
-  ENIPMessage *p_outgoing_message = NULL;
-
-  for(size_t i = 0; i < ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES; i++) {
-#ifdef CLEARCORE
-    if(NULL == g_delayed_encapsulation_messages[i].pcb) {
-#else
-    if(kEipInvalidSocket == g_delayed_encapsulation_messages[i].socket) {
-#endif
-      delayed_message_buffer = &(g_delayed_encapsulation_messages[i]);
-
-      p_outgoing_message = &(delayed_message_buffer->outgoing_message);
-      InitializeENIPMessage(p_outgoing_message);
-      break;
+  for(size_t i = 0; i < g_number_of_delayed_encapsulation_messages; i++) {
+    DelayedEncapsulationMessage *const pending = &g_delayed_encapsulation_messages[i];
+    if(pending->receiver.sin_addr.s_addr == from_address->sin_addr.s_addr &&
+       pending->receiver.sin_port == from_address->sin_port) {
+      /* asked again before the response went out: one response, to the
+       * latest request, at the time drawn for the first one */
+      pending->socket = socket;
+      memcpy(pending->sender_context, receive_data->sender_context, kSenderContextSize);
+      return;
     }
   }
 
-  if(NULL != delayed_message_buffer) {
-#ifdef CLEARCORE
-    delayed_message_buffer->pcb = (struct udp_pcb *)(intptr_t)socket;
-#else
-    delayed_message_buffer->socket = socket;
-#endif
-    memcpy((&delayed_message_buffer->receiver), from_address, sizeof(struct sockaddr_in));
+  if(ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES <= g_number_of_delayed_encapsulation_messages) {
+    OPENER_TRACE_WARN("encap: No room for a delayed List Identity response, request dropped\n");
+    return;
+  }
 
-    DetermineDelayTime(receive_data->communication_buffer_start, delayed_message_buffer);
+  const MilliSeconds due_time = g_encapsulation_time +
+                                DetermineDelayTime(receive_data->communication_buffer_start);
 
-    EncapsulateListIdentityResponseMessage(receive_data, p_outgoing_message);
+  /* keep the falling order, later requests go before those due at the same time */
+  size_t position = g_number_of_delayed_encapsulation_messages;
+  while(position > 0 &&
+        !EncapsulationTimeIsBefore(due_time, g_delayed_encapsulation_messages[position - 1].due_time) ) {
+    g_delayed_encapsulation_messages[position] = g_delayed_encapsulation_messages[position - 1];
+    position--;
   }
+
+  DelayedEncapsulationMessage *const delayed_message = &g_delayed_encapsulation_messages[position];
+  delayed_message->due_time = due_time;
+  delayed_message->socket = socket;
+  memcpy(&delayed_message->receiver, from_address, sizeof(struct sockaddr_in) );
+  memcpy(delayed_message->sender_context, receive_data->sender_context, kSenderContextSize);
+  g_number_of_delayed_encapsulation_messages++;
 }
 
 CipUint ListIdentityGetCipIdentityItemLength() {
@@ -386,7 +398,11 @@ CipUint ListIdentityGetCipIdentityItemLength() {
     + 2 * sizeof(CipUsint) + sizeof(CipWord) + sizeof(CipUdint) + sizeof(CipUsint) + g_identity.product_name.length + sizeof(CipUsint);
 }
 
-void EncodeListIdentityCipIdentityItem(ENIPMessage *const outgoing_message) {
+void InvalidateListIdentityCache(void) {
+  g_list_identity_item_valid = false;
+}
+
+static void EncodeListIdentityCipIdentityItemFields(ENIPMessage *const outgoing_message) {
   /* Item ID*/
   const CipUint kItemIDCipIdentity = 0x0C;
   AddIntToMessage(kItemIDCipIdentity, outgoing_message);
@@ -416,6 +432,21 @@ void EncodeListIdentityCipIdentityItem(ENIPMessage *const outgoing_message) {
   AddSintToMessage(g_identity.state, outgoing_message);
 }
 
+void EncodeListIdentityCipIdentityItem(ENIPMessage *const outgoing_message) {
+  if(!g_list_identity_item_valid ||
+     g_list_identity_item_ip_address != g_tcpip.interface_configuration.ip_address) {
+    InitializeENIPMessage(&g_list_identity_item);
+    EncodeListIdentityCipIdentityItemFields(&g_list_identity_item);
+    g_list_identity_item_ip_address = g_tcpip.interface_configuration.ip_address;
+    g_list_identity_item_valid = true;
+  }
+  memcpy(outgoing_message->current_message_position,
+         g_list_identity_item.message_buffer,
+         g_list_identity_item.used_message_length);
+  outgoing_message->current_message_position += g_list_identity_item.used_message_length;
+  outgoing_message->used_message_length += g_list_identity_item.used_message_length;
+}
+
 void EncapsulateListIdentityResponseMessage(const EncapsulationData *const receive_data, ENIPMessage *const outgoing_message) {
 
   const CipUint kEncapsulationCommandListIdentityLength = ListIdentityGetCipIdentityItemLength() + sizeof(CipUint) + sizeof(CipUint) + sizeof(CipUint); /* Last element is item count */
@@ -429,7 +460,7 @@ void EncapsulateListIdentityResponseMessage(const EncapsulationData *const recei
 
 }
 
-void DetermineDelayTime(const EipByte *buffer_start, DelayedEncapsulationMessage *const delayed_message_buffer) {
+EipUint16 DetermineDelayTime(const EipByte *buffer_start) {
 
   buffer_start += 12; /* start of the sender context */
   EipUint16 maximum_delay_time = GetUintFromMessage((const EipUint8** const ) &buffer_start);
@@ -440,7 +471,7 @@ void DetermineDelayTime(const EipByte *buffer_start, DelayedEncapsulationMessage
     maximum_delay_time = kListIdentityMinimumDelayTime;
   }
 
-  delayed_message_buffer->time_out = rand() % maximum_delay_time;
+  return rand() % maximum_delay_time;
 }
 
 void EncapsulateRegisterSessionCommandResponseMessage(const EncapsulationData *const receive_data, const CipSessionHandle session_handle,
@@ -720,46 +751,34 @@ void EncapsulationShutDown(void) {
   }
 }
 
+/** @brief Encode and send a List Identity response that was due */
+static void SendDelayedListIdentityResponse(const DelayedEncapsulationMessage *const delayed_message) {
+  static ENIPMessage outgoing_message;
+  EncapsulationData request = { .command_code = kEncapsulationCommandListIdentity };
+  memcpy(request.sender_context, delayed_message->sender_context, kSenderContextSize);
+
+  InitializeENIPMessage(&outgoing_message);
+  EncapsulateListIdentityResponseMessage(&request, &outgoing_message);
+
+  OPENER_TRACE_INFO("encap: Sending delayed UDP List Identity response\n");
+  if(kEipStatusOk == SendUdpDataOnSocket(delayed_message->socket, &delayed_message->receiver, &outgoing_message) ) {
+    OPENER_TRACE_INFO("encap: Delayed UDP response sent, %d bytes\n", (int)outgoing_message.used_message_length);
+  } else {
+    OPENER_TRACE_ERR("encap: Error sending delayed UDP response\n");
+  }
+}
+
 void ManageEncapsulationMessages(const MilliSeconds elapsed_time) {
-  for(size_t i = 0; i < ENCAP_NUMBER_OF_SUPPORTED_DELAYED_ENCAP_MESSAGES; i++) {
-#ifdef CLEARCORE
-    if(NULL != g_delayed_encapsulation_messages[i].pcb) {
-#else
-    if(kEipInvalidSocket != g_delayed_encapsulation_messages[i].socket) {
-#endif
-      g_delayed_encapsulation_messages[i].time_out -= elapsed_time;
-      if(0 >= g_delayed_encapsulation_messages[i].time_out) {
-        OPENER_TRACE_INFO("encap: Sending delayed UDP List Identity response\n");
-#ifdef CLEARCORE
-        ip_addr_t addr;
-        ip4_addr_set_u32(&addr, g_delayed_encapsulation_messages[i].receiver.sin_addr.s_addr);
-        struct pbuf *tx_buf = pbuf_alloc(PBUF_TRANSPORT, g_delayed_encapsulation_messages[i].outgoing_message.used_message_length, PBUF_RAM);
-        if (tx_buf != NULL) {
-          memcpy(tx_buf->payload, g_delayed_encapsulation_messages[i].outgoing_message.message_buffer, g_delayed_encapsulation_messages[i].outgoing_message.used_message_length);
-          err_t err = udp_sendto(g_delayed_encapsulation_messages[i].pcb, tx_buf, &addr, ntohs(g_delayed_encapsulation_messages[i].receiver.sin_port));
-          pbuf_free(tx_buf);
-          if (err == ERR_OK) {
-            OPENER_TRACE_INFO("encap: Delayed UDP response sent, %d bytes\n", g_delayed_encapsulation_messages[i].outgoing_message.used_message_length);
-          } else {
-            OPENER_TRACE_ERR("encap: Error sending delayed UDP response: err=%d\n", err);
-          }
-        } else {
-          OPENER_TRACE_ERR("encap: Failed to allocate pbuf for delayed UDP response\n");
-        }
-        g_delayed_encapsulation_messages[i].pcb = NULL;
-#else
-        int sent = sendto(g_delayed_encapsulation_messages[i].socket, (char*) g_delayed_encapsulation_messages[i].outgoing_message.message_buffer,
-          g_delayed_encapsulation_messages[i].outgoing_message.used_message_length, 0, (struct sockaddr*) &(g_delayed_encapsulation_messages[i].receiver),
-          sizeof(struct sockaddr));
-        if(sent < 0) {
-          OPENER_TRACE_ERR("encap: Error sending delayed UDP response\n");
-        } else {
-          OPENER_TRACE_INFO("encap: Delayed UDP response sent, %d bytes\n", sent);
-        }
-        g_delayed_encapsulation_messages[i].socket = kEipInvalidSocket;
-#endif
-      }
+  g_encapsulation_time += elapsed_time;
+  /* only the responses that are due are looked at */
+  while(g_number_of_delayed_encapsulation_messages > 0) {
+    const DelayedEncapsulationMessage *const next =
+      &g_delayed_encapsulation_messages[g_number_of_delayed_encapsulation_messages - 1];
+    if(EncapsulationTimeIsBefore(g_encapsulation_time, next->due_time) ) {
+      break;
     }
+    SendDelayedListIdentityResponse(next);
+    g_number_of_delayed_encapsulation_messages--;
   }
 }
 
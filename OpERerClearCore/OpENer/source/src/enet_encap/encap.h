@@ -92,11 +92,24 @@ void CloseEncapsulationSessionBySockAddr(const CipConnectionObject *const connec
 
 void CloseClass3ConnectionBasedOnSession(CipSessionHandle encapsulation_session_handle);
 
+/** @brief Encode the Identity item of List Identity again on its next use
+ *
+ *  The setters of the Identity object call it, the IP address is checked on
+ *  every use.
+ */
+void InvalidateListIdentityCache(void);
+
 /* No reason to use this functions outside the encapsulation layer, they are here for testing */
 typedef struct enip_message ENIPMessage;
 
 void EncapsulateListIdentityResponseMessage(const EncapsulationData *const receive_data, ENIPMessage *const outgoing_message);
 
+void EncodeListIdentityCipIdentityItem(ENIPMessage *const outgoing_message);
+
+void HandleReceivedListIdentityCommandUdp(const int socket,
+                                          const struct sockaddr_in *const from_address,
+                                          const EncapsulationData *const receive_data);
+
 int_fast32_t CreateEncapsulationStructure(const EipUint8 *receive_buffer,
                                           size_t receive_buffer_length,
                                           EncapsulationData *const encapsulation_data);
@@ -795,7 +795,8 @@ EipStatus HandleReceivedConnectedData(const EipUint8 *const received_data,
 EipStatus ManageConnections(MilliSeconds elapsed_time);
 
 /** @ingroup CIP_API
- * @brief Trigger the production of an application triggered connection.
+ * @brief Trigger the production of an application or change of state
+ * triggered connection.
  *
  * This will issue the production of the specified connection at the next
  * possible occasion. Depending on the values for the RPI and the production
@@ -805,7 +806,7 @@ EipStatus ManageConnections(MilliSeconds elapsed_time);
  * be invoked from void HandleApplication(void).
  *
  * The connection can only be triggered if the application is established and it
- * is of application application triggered type.
+ * is of application triggered or change of state triggered type.
  *
  * @param output_assembly_id the output assembly connection point of the
  * connection
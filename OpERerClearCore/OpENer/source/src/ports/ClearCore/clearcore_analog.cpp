@@ -0,0 +1,87 @@
+#ifdef CLEARCORE
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_analog.h"
+
+static_assert(CLEARCORE_ANALOG_OVERSAMPLING_MAX ==
+              AdcManager::ADC_OVERSAMPLING_MAX,
+              "Analog oversampling limit mismatch");
+static_assert(CLEARCORE_ANALOG_DECIMATION_MAX ==
+              AdcDecimator::DECIMATION_MAX,
+              "Analog decimation limit mismatch");
+
+namespace {
+
+const AdcManager::AdcChannels analogChannels[CLEARCORE_ANALOG_CHANNELS] = {
+    AdcManager::ADC_AIN09,
+    AdcManager::ADC_AIN10,
+    AdcManager::ADC_AIN11,
+    AdcManager::ADC_AIN12,
+};
+
+Connector *const analogConnectors[CLEARCORE_ANALOG_CHANNELS] = {
+    &ConnectorA9, &ConnectorA10, &ConnectorA11, &ConnectorA12
+};
+
+} // anonymous namespace
+
+extern "C" {
+void ClearCoreAnalogSampleRead(uint8_t channel,
+                               ClearCoreAnalogSample *sample) {
+    if (sample == NULL || channel >= CLEARCORE_ANALOG_CHANNELS) {
+        return;
+    }
+    AdcManager::AdcChannels adcChannel = analogChannels[channel];
+
+    // Keep the values and their timestamps from one sample time or block
+    __disable_irq();
+    sample->timestamp_us = AdcMgr.ResultTimestamp();
+    sample->filtered = AdcMgr.FilteredResult(adcChannel);
+    sample->decimated_timestamp_us = AdcMgr.DecimatedTimestamp(adcChannel);
+    sample->decimated = AdcMgr.DecimatedResult(adcChannel);
+    __enable_irq();
+    sample->analog =
+        analogConnectors[channel]->Mode() == Connector::INPUT_ANALOG ? 1 : 0;
+}
+
+int ClearCoreAnalogEnable(uint8_t channel, int enable) {
+    if (channel >= CLEARCORE_ANALOG_CHANNELS) {
+        return 0;
+    }
+    return analogConnectors[channel]->Mode(
+               enable ? Connector::INPUT_ANALOG :
+               Connector::INPUT_DIGITAL) ? 1 : 0;
+}
+
+void ClearCoreAnalogBlockMode(int enable) {
+    AdcMgr.AcquisitionMode(enable ? AdcManager::ACQ_MODE_BLOCK :
+                           AdcManager::ACQ_MODE_SAMPLE);
+}
+
+int ClearCoreAnalogOversampling(uint8_t channel, uint8_t samples_log2) {
+    if (channel >= CLEARCORE_ANALOG_CHANNELS) {
+        return 0;
+    }
+    return AdcMgr.Oversampling(analogChannels[channel], samples_log2) ? 1 : 0;
+}
+
+int ClearCoreAnalogDecimation(uint8_t channel, uint16_t samples) {
+    if (channel >= CLEARCORE_ANALOG_CHANNELS) {
+        return 0;
+    }
+    return AdcMgr.Decimation(analogChannels[channel], samples) ? 1 : 0;
+}
+
+void ClearCoreAnalogFilterMs(uint8_t channel, uint16_t filter_ms) {
+    if (channel >= CLEARCORE_ANALOG_CHANNELS) {
+        return;
+    }
+    AdcMgr.FilterTc(analogChannels[channel], filter_ms,
+                    AdcManager::FILTER_UNIT_MS);
+}
+
+uint32_t ClearCoreAnalogBlockOverruns(void) {
+    return AdcMgr.BlockOverruns();
+}
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef CLEARCORE_ANALOG_H_
+#define CLEARCORE_ANALOG_H_
+
+/** @file clearcore_analog.h
+ *  @brief C interface from the OpENer objects to the ClearCore AdcManager
+ *
+ *  Channels 0 .. 3 are the analog inputs A-9 .. A-12. The functions are
+ *  implemented in clearcore_analog.cpp for the target and by a mock ADC in
+ *  the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of analog inputs, A-9 .. A-12 */
+#define CLEARCORE_ANALOG_CHANNELS 4
+
+/** @brief Highest oversampling, as a power of two, of
+ *  AdcManager::ADC_OVERSAMPLING_MAX */
+#define CLEARCORE_ANALOG_OVERSAMPLING_MAX 4U
+
+/** @brief Longest decimation in results, AdcDecimator::DECIMATION_MAX */
+#define CLEARCORE_ANALOG_DECIMATION_MAX 1024U
+
+/** @brief One coherent sample of an analog input
+ *
+ *  The values are Q15 of the input range, 32768 is 10 V.
+ */
+typedef struct {
+  uint32_t timestamp_us; /**< ResultTimestamp() of the filtered value */
+  uint32_t decimated_timestamp_us; /**< DecimatedTimestamp() */
+  uint16_t filtered; /**< FilteredResult() */
+  uint16_t decimated; /**< DecimatedResult() */
+  uint8_t analog; /**< the connector is in the analog input mode */
+} ClearCoreAnalogSample;
+
+/** @brief Sample the values of one analog input in a single call */
+void ClearCoreAnalogSampleRead(uint8_t channel,
+                               ClearCoreAnalogSample *sample);
+
+/** @brief Switch the connector between the analog and the digital input
+ *  mode
+ *
+ *  @return 1 on success
+ */
+int ClearCoreAnalogEnable(uint8_t channel,
+                          int enable);
+
+/** @brief Collect the ADC results in DMA blocks, filtered outside of the
+ *  sample interrupt, or filter them in every sample time */
+void ClearCoreAnalogBlockMode(int enable);
+
+/** @brief Set the hardware oversampling as a power of two
+ *
+ *  @return 1 on success, 0 if the conversions of all channels do not fit
+ *  into one sample time
+ */
+int ClearCoreAnalogOversampling(uint8_t channel,
+                                uint8_t samples_log2);
+
+/** @brief Set the number of results averaged into one decimated value
+ *
+ *  @return 1 on success
+ */
+int ClearCoreAnalogDecimation(uint8_t channel,
+                              uint16_t samples);
+
+/** @brief Set the 99 % rise time of the filter in ms */
+void ClearCoreAnalogFilterMs(uint8_t channel,
+                             uint16_t filter_ms);
+
+/** @brief Blocks that were overwritten before they were filtered */
+uint32_t ClearCoreAnalogBlockOverruns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_ANALOG_H_ */
@@ -0,0 +1,189 @@
+#include <stddef.h>
+
+#include "lwip/opt.h"
+#include "lwip/etharp.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/sys.h"
+
+/* next to this file, it is built with the lwIP unit tests too */
+#include "clearcore_arppin.h"
+
+#if !LWIP_ARP || !ETHARP_SUPPORT_STATIC_ENTRIES
+#error "Pinning the ARP entries of the I/O peers needs ETHARP_SUPPORT_STATIC_ENTRIES of lwIP"
+#endif
+
+#if CLEARCORE_ARP_PINS >= ARP_TABLE_SIZE
+#error "CLEARCORE_ARP_PINS leaves no room for the dynamic entries of ARP_TABLE_SIZE"
+#endif
+
+/* The clock of lwIP, the port's sys_arch.c; not every lwIP declares it */
+u32_t sys_now(void);
+
+/** @brief A pinned peer, the next hop of the address that was pinned */
+typedef struct {
+  ip4_addr_t hop; /**< peer or its gateway */
+  uint16_t pins; /**< 0 for a free slot */
+  uint8_t is_static; /**< the static entry is in the ARP table */
+} ArpPin;
+
+static ArpPin arp_pins[CLEARCORE_ARP_PINS];
+static uint32_t arp_send_delays;
+static u32_t arp_last_refresh;
+static u32_t arp_last_retry;
+
+/** @brief Next hop of an address as etharp_output() picks it
+ *
+ *  @return the netif, NULL for an address that needs no ARP entry
+ */
+static struct netif *ArpNextHop(uint32_t address, ip4_addr_t *hop) {
+  ip4_addr_t destination;
+  ip4_addr_set_u32(&destination, address);
+  if(ip4_addr_isany_val(destination) || ip4_addr_ismulticast(&destination) ) {
+    return NULL;
+  }
+  struct netif *netif = ip4_route(&destination);
+  if(NULL == netif || ip4_addr_isbroadcast(&destination, netif) ) {
+    return NULL;
+  }
+  if(!ip4_addr_netcmp(&destination, netif_ip4_addr(netif),
+                      netif_ip4_netmask(netif) ) &&
+     !ip4_addr_islinklocal(&destination) ) {
+    if(ip4_addr_isany(netif_ip4_gw(netif) ) ) {
+      return NULL;
+    }
+    ip4_addr_copy(*hop, *netif_ip4_gw(netif) );
+  } else {
+    ip4_addr_copy(*hop, destination);
+  }
+  return netif;
+}
+
+static ArpPin *ArpPinFind(const ip4_addr_t *hop) {
+  for(size_t i = 0; i < CLEARCORE_ARP_PINS; ++i) {
+    if(arp_pins[i].pins > 0 && ip4_addr_cmp(&arp_pins[i].hop, hop) ) {
+      return &arp_pins[i];
+    }
+  }
+  return NULL;
+}
+
+/** @brief Make the entry of a pin static once lwIP resolved it, else ask
+ *  the peer again */
+static void ArpPinResolve(struct netif *netif, ArpPin *pin) {
+  struct eth_addr *entry_mac = NULL;
+  const ip4_addr_t *entry_ip = NULL;
+  if(etharp_find_addr(netif, &pin->hop, &entry_mac, &entry_ip) >= 0) {
+    struct eth_addr mac = *entry_mac;
+    pin->is_static = (ERR_OK == etharp_add_static_entry(&pin->hop, &mac) );
+  } else {
+    etharp_query(netif, &pin->hop, NULL);
+  }
+}
+
+void ClearCoreArpPin(uint32_t address) {
+  ip4_addr_t hop;
+  struct netif *netif = ArpNextHop(address, &hop);
+  if(NULL == netif) {
+    return;
+  }
+  ArpPin *pin = ArpPinFind(&hop);
+  if(NULL != pin) {
+    pin->pins++;
+    return;
+  }
+  for(size_t i = 0; i < CLEARCORE_ARP_PINS; ++i) {
+    if(0 == arp_pins[i].pins) {
+      pin = &arp_pins[i];
+      ip4_addr_copy(pin->hop, hop);
+      pin->pins = 1;
+      pin->is_static = 0;
+      ArpPinResolve(netif, pin);
+      return;
+    }
+  }
+}
+
+void ClearCoreArpUnpin(uint32_t address) {
+  ip4_addr_t hop;
+  struct netif *netif = ArpNextHop(address, &hop);
+  if(NULL == netif) {
+    return;
+  }
+  ArpPin *pin = ArpPinFind(&hop);
+  if(NULL == pin || --pin->pins > 0) {
+    return;
+  }
+  if(pin->is_static) {
+    /* learned again as a dynamic entry, from the reply to the query */
+    etharp_remove_static_entry(&pin->hop);
+    etharp_query(netif, &pin->hop, NULL);
+    pin->is_static = 0;
+  }
+}
+
+void ClearCoreArpPinPoll(void) {
+  const u32_t now = sys_now();
+  const int retry = (u32_t)(now - arp_last_retry) >= CLEARCORE_ARP_RETRY_MS;
+  const int refresh =
+    (u32_t)(now - arp_last_refresh) >= CLEARCORE_ARP_REFRESH_MS;
+  if(!retry && !refresh) {
+    return;
+  }
+  if(retry) {
+    arp_last_retry = now;
+  }
+  if(refresh) {
+    arp_last_refresh = now;
+  }
+
+  for(size_t i = 0; i < CLEARCORE_ARP_PINS; ++i) {
+    ArpPin *pin = &arp_pins[i];
+    if(0 == pin->pins) {
+      continue;
+    }
+    struct netif *netif = ip4_route(&pin->hop);
+    if(NULL == netif) {
+      continue;
+    }
+    if(pin->is_static) {
+      struct eth_addr *entry_mac = NULL;
+      const ip4_addr_t *entry_ip = NULL;
+      /* a link down empties the table of the netif, static entries too */
+      pin->is_static =
+        (etharp_find_addr(netif, &pin->hop, &entry_mac, &entry_ip) >= 0);
+    }
+    if(!pin->is_static) {
+      if(retry) {
+        ArpPinResolve(netif, pin);
+      }
+    } else if(refresh) {
+      etharp_request(netif, &pin->hop);
+    }
+  }
+}
+
+int ClearCoreArpCheckSend(uint32_t address) {
+  ip4_addr_t hop;
+  struct netif *netif = ArpNextHop(address, &hop);
+  struct eth_addr *entry_mac = NULL;
+  const ip4_addr_t *entry_ip = NULL;
+  if(NULL == netif ||
+     etharp_find_addr(netif, &hop, &entry_mac, &entry_ip) >= 0) {
+    return 0;
+  }
+  arp_send_delays++;
+  return 1;
+}
+
+uint32_t ClearCoreArpSendDelays(void) {
+  return arp_send_delays;
+}
+
+unsigned int ClearCoreArpPinCount(void) {
+  unsigned int count = 0;
+  for(size_t i = 0; i < CLEARCORE_ARP_PINS; ++i) {
+    count += (arp_pins[i].pins > 0);
+  }
+  return count;
+}
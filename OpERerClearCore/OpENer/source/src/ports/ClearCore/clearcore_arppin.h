@@ -0,0 +1,74 @@
+#ifndef CLEARCORE_ARPPIN_H_
+#define CLEARCORE_ARPPIN_H_
+
+/** @file clearcore_arppin.h
+ *  @brief ARP entries of the I/O peers that do not expire
+ *
+ *  The connection manager pins the originator of every I/O connection while
+ *  the connection is in the active connection list. A pinned peer, or its
+ *  gateway when it is not on the local subnet, becomes a static entry of
+ *  the lwIP ARP table, so a produced frame never waits for an ARP reply
+ *  once the peer has been resolved. Peers that are not resolved yet are
+ *  queried until they are, and the pinned ones get an ARP request every
+ *  CLEARCORE_ARP_REFRESH_MS, which keeps the entry of the ClearCore fresh
+ *  in the cache of the peer. The last unpin turns the entry back into a
+ *  dynamic one.
+ *
+ *  A static entry is not updated by ARP replies; a peer that is replaced by
+ *  one with the same address is learned once its connections are gone.
+ *
+ *  Depends on lwIP only. Addresses are IPv4 in network byte order.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Peers that are pinned at once, the ARP table keeps room for
+ *  dynamic entries */
+#ifndef CLEARCORE_ARP_PINS
+#define CLEARCORE_ARP_PINS 4
+#endif
+
+/** @brief Period of the ARP requests to the pinned peers */
+#ifndef CLEARCORE_ARP_REFRESH_MS
+#define CLEARCORE_ARP_REFRESH_MS 60000U
+#endif
+
+/** @brief Period of the ARP requests to the peers not resolved yet */
+#ifndef CLEARCORE_ARP_RETRY_MS
+#define CLEARCORE_ARP_RETRY_MS 1000U
+#endif
+
+/** @brief Pin the ARP entry of a peer, pins are counted per peer
+ *
+ *  Broadcast, multicast and unroutable addresses are ignored, as are peers
+ *  beyond CLEARCORE_ARP_PINS.
+ */
+void ClearCoreArpPin(uint32_t address);
+
+/** @brief Release a pin of ClearCoreArpPin() */
+void ClearCoreArpUnpin(uint32_t address);
+
+/** @brief Resolve and refresh the pinned peers, called from the main loop */
+void ClearCoreArpPinPoll(void);
+
+/** @brief Check a UDP frame before it is sent
+ *
+ *  @return 1 when the frame has to wait for ARP, which is counted, else 0
+ */
+int ClearCoreArpCheckSend(uint32_t address);
+
+/** @brief Frames that waited for ARP since the start */
+uint32_t ClearCoreArpSendDelays(void);
+
+/** @brief Peers with at least one pin */
+unsigned int ClearCoreArpPinCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_ARPPIN_H_ */
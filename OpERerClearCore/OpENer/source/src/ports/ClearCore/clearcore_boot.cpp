@@ -0,0 +1,92 @@
+#ifdef CLEARCORE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
+#include <string.h>
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_boot.h"
+#include "lwip/dns.h"
+#include "lwip/ip4_addr.h"
+#include "trace.h"
+
+extern "C" {
+#include "ports/nvdata/nvtcpip.h"
+}
+
+/** Time of the previous boot step */
+static uint32_t boot_last_mark_ms = 0;
+/** PHY link came up at least once */
+static bool boot_link_seen = false;
+/** Fallback address applied */
+static bool boot_fallback_done = false;
+/** Address of the DHCP lease last stored, 0 for none */
+static uint32_t boot_lease_stored = 0;
+
+/**
+    Keep a new DHCP lease for the next start. A renewal of the same lease
+    does not write the flash, the NV store skips unchanged values.
+**/
+static void StoreLease(struct netif *netif) {
+    CipTcpIpInterfaceConfiguration lease;
+    memset(&lease, 0, sizeof(lease));
+    lease.ip_address = netif_ip4_addr(netif)->addr;
+    lease.network_mask = netif_ip4_netmask(netif)->addr;
+    lease.gateway = netif_ip4_gw(netif)->addr;
+    lease.name_server = ip4_addr_get_u32(ip_2_ip4(dns_getserver(0)));
+    lease.name_server_2 = ip4_addr_get_u32(ip_2_ip4(dns_getserver(1)));
+    if (NvTcpipStoreLease(&lease) != kEipStatusOk) {
+        OPENER_TRACE_WARN("boot: DHCP lease not stored\n");
+    }
+    boot_lease_stored = lease.ip_address;
+}
+
+extern "C" {
+void ClearCoreBootMark(const char *step) {
+    uint32_t now = Milliseconds();
+    OPENER_TRACE_INFO("boot: %s at %lu ms (+%lu ms)\n", step,
+                      (unsigned long)now,
+                      (unsigned long)(now - boot_last_mark_ms));
+    boot_last_mark_ms = now;
+}
+
+void ClearCoreBootNetworkProcess(struct netif *netif) {
+    if (netif == NULL) {
+        return;
+    }
+
+    // Setup() reports the link up for good; lwIP only restarts DHCP on a
+    // new link when it is told about the change.
+    bool link = EthernetMgr.PhyLinkActive();
+    if (link != (netif_is_link_up(netif) != 0)) {
+        if (link) {
+            netif_set_link_up(netif);
+        } else {
+            netif_set_link_down(netif);
+        }
+    }
+    if (link && !boot_link_seen) {
+        boot_link_seen = true;
+        ClearCoreBootMark("PHY link up");
+    }
+
+    if (EthernetMgr.DhcpBound() &&
+            netif_ip4_addr(netif)->addr != boot_lease_stored) {
+        if (boot_lease_stored == 0) {
+            ClearCoreBootMark("DHCP lease bound");
+        }
+        StoreLease(netif);
+    }
+
+    if (!boot_fallback_done && ip4_addr_isany_val(*netif_ip4_addr(netif)) &&
+            Milliseconds() >= CLEARCORE_BOOT_DHCP_FALLBACK_MS) {
+        // DHCP keeps trying and replaces the address if a server shows up
+        ip4_addr_t ip, netmask, gateway;
+        IP4_ADDR(&ip, 192, 168, 1, 100);
+        IP4_ADDR(&netmask, 255, 255, 255, 0);
+        IP4_ADDR(&gateway, 192, 168, 1, 1);
+        netif_set_addr(netif, &ip, &netmask, &gateway);
+        boot_fallback_done = true;
+        ClearCoreBootMark("no DHCP answer, fallback address 192.168.1.100");
+    }
+}
+}
+#endif
@@ -0,0 +1,47 @@
+#ifndef CLEARCORE_BOOT_H_
+#define CLEARCORE_BOOT_H_
+
+/** @file clearcore_boot.h
+ *  @brief Fast network start and boot timeline of the ClearCore
+ *
+ *  With CLEARCORE_FAST_BOOT set (the default, see opener_user_conf.h)
+ *  main() sets up lwIP right away and opener_init() starts the stack
+ *  without waiting for the PHY link. IfaceApplyConfiguration() applies the
+ *  stored static address, or the last DHCP lease, and leaves DHCP running in
+ *  the background. ClearCoreBootNetworkProcess() then follows the PHY link
+ *  and falls back to the default static address if DHCP never answers.
+ *
+ *  ClearCoreBootMark() traces each start-up step with its time since reset
+ *  and since the previous step, so the boot time can be read from the trace.
+ */
+
+#include "lwip/netif.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Time without a lease or cached address before the fallback
+ *  address is used, like the five tries of EthernetManager::DhcpBegin()
+ */
+#define CLEARCORE_BOOT_DHCP_FALLBACK_MS 7500U
+
+/** @brief Trace a step of the start-up with its time
+ *
+ *  @param step short description, must stay valid (a string literal)
+ */
+void ClearCoreBootMark(const char *step);
+
+/** @brief Follow the PHY link and the DHCP client, call from the main loop
+ *
+ *  Passes link changes on to lwIP, which restarts DHCP on a new link, and
+ *  applies the fallback address once CLEARCORE_BOOT_DHCP_FALLBACK_MS passed
+ *  without any address.
+ */
+void ClearCoreBootNetworkProcess(struct netif *netif);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_BOOT_H_ */
@@ -0,0 +1,89 @@
+#ifdef CLEARCORE
+#include <limits.h>
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_capture.h"
+
+static_assert(kWaveCaptureBlockSize == SdCardDriver::BLOCK_SIZE,
+              "Capture block size mismatch");
+
+namespace {
+
+MotorDriver *const captureMotors[kWaveCaptureChannels] = {
+    &ConnectorM0, &ConnectorM1, &ConnectorM2, &ConnectorM3
+};
+
+const AdcManager::AdcChannels captureAnalog[kWaveCaptureChannels] = {
+    AdcManager::ADC_AIN09,
+    AdcManager::ADC_AIN10,
+    AdcManager::ADC_AIN11,
+    AdcManager::ADC_AIN12,
+};
+
+int SdBegin(void *context, uint32_t block, uint32_t count) {
+    (void)context;
+    return SdCard.WriteStart(block, count) ? 0 : -1;
+}
+
+int SdWrite(void *context, const void *data, uint32_t count) {
+    (void)context;
+    return SdCard.WriteData(static_cast<const uint8_t *>(data), count) ?
+           0 : -1;
+}
+
+int SdEnd(void *context) {
+    (void)context;
+    return SdCard.WriteStop() ? 0 : -1;
+}
+
+WaveCaptureDevice captureCard = {0, SdBegin, SdWrite, SdEnd, NULL};
+WaveCapture capture;
+bool captureReady = false;
+
+// Runs in the sample interrupt after the motors, encoder and ADC update
+void CaptureSample() {
+    uint8_t state = capture.state;
+    if (state != kWaveCaptureArmed && state != kWaveCaptureRunning) {
+        return;
+    }
+    WaveCaptureValues values;
+    values.timestamp_us = Microseconds();
+    for (uint8_t i = 0; i < kWaveCaptureChannels; i++) {
+        MotorDriver *motor = captureMotors[i];
+        values.position[i] = motor->PositionRefCommanded();
+        float duty = motor->HlfbPercent();
+        values.hlfb[i] = duty == MotorDriver::HLFB_DUTY_UNKNOWN ?
+                         INT16_MIN : static_cast<int16_t>(duty * 100);
+        values.analog[i] = AdcMgr.FilteredResult(captureAnalog[i]);
+    }
+    values.inputs = InputMgr.InputsRT().reg;
+    WaveCaptureSample(&capture, &values);
+}
+
+} // anonymous namespace
+
+extern "C" {
+WaveCapture *ClearCoreCaptureInit(void) {
+    if (captureReady) {
+        return &capture;
+    }
+    if (!SdCard.CardInit()) {
+        return NULL;
+    }
+    captureCard.block_count = SdCard.BlockCount();
+    WaveCaptureInit(&capture, &captureCard, SAMPLE_PERIOD_MICROSECONDS);
+    captureReady = true;
+    SysMgr.SampleCallback(CaptureSample);
+    return &capture;
+}
+
+WaveCapture *ClearCoreCapture(void) {
+    return captureReady ? &capture : NULL;
+}
+
+void ClearCoreCapturePoll(void) {
+    if (captureReady) {
+        WaveCapturePoll(&capture);
+    }
+}
+}
+#endif
@@ -0,0 +1,44 @@
+#ifndef CLEARCORE_CAPTURE_H_
+#define CLEARCORE_CAPTURE_H_
+
+/** @file clearcore_capture.h
+ *  @brief Waveform capture of the ClearCore signals to the SD card
+ *
+ *  Connects the capture engine of wavecapture.h to the ClearCore: the
+ *  SysManager sample callback feeds it the commanded positions and HLFB
+ *  duties of M-0 .. M-3, the filtered analog inputs A-9 .. A-12 and the
+ *  input bitmap of InputManager::InputsRT() every sample time, and
+ *  ClearCoreCapturePoll() streams the full buffer halves to the SD card
+ *  with multi-block writes. The card is written as raw blocks without a
+ *  file system.
+ *
+ *  The functions are implemented in clearcore_capture.cpp for the target
+ *  and by a mock in the unit tests.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The capture engine is C, and called from clearcore_capture.cpp */
+#include "ports/wavecapture.h"
+
+/** @brief Detect the SD card and start sampling into the capture
+ *
+ *  Does nothing if a card was found before.
+ *
+ *  @return the capture, NULL without a usable card
+ */
+WaveCapture *ClearCoreCaptureInit(void);
+
+/** @brief The capture, NULL until a card was found */
+WaveCapture *ClearCoreCapture(void);
+
+/** @brief Write full buffer halves to the card, call from the main loop */
+void ClearCoreCapturePoll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_CAPTURE_H_ */
@@ -0,0 +1,100 @@
+#ifdef CLEARCORE
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_ccio.h"
+
+static_assert(CLEARCORE_CCIO_BOARDS_MAX == CcioLink::BOARDS_MAX,
+              "CCIO-8 chain length mismatch");
+static_assert(CLEARCORE_CCIO_BOARDS_MAX == MAX_CCIO_DEVICES,
+              "CCIO-8 board count mismatch");
+
+namespace {
+
+SerialDriver *ccioPort = NULL;
+
+} // anonymous namespace
+
+extern "C" {
+void ClearCoreCcioSampleRead(ClearCoreCcioSample *sample) {
+    if (sample == NULL) {
+        return;
+    }
+    // Keep the values from one refresh
+    __disable_irq();
+    sample->inputs = CcioMgr.InputState();
+    sample->outputs = CcioMgr.OutputState();
+    sample->overloaded = CcioMgr.IoOverloadRT();
+    sample->refresh_overruns = CcioMgr.RefreshOverruns();
+    sample->boards = CcioMgr.CcioCount();
+    sample->link_broken = CcioMgr.LinkBroken() ? 1 : 0;
+    __enable_irq();
+}
+
+void ClearCoreCcioEdgesRead(uint64_t *risen, uint64_t *fallen) {
+    if (risen != NULL) {
+        *risen = CcioMgr.InputsRisen();
+    }
+    if (fallen != NULL) {
+        *fallen = CcioMgr.InputsFallen();
+    }
+}
+
+int ClearCoreCcioLinkOpen(uint8_t port) {
+    SerialDriver *serial = NULL;
+    switch (port) {
+        case kClearCoreCcioPortNone:
+            break;
+        case kClearCoreCcioPortCom0:
+            serial = &ConnectorCOM0;
+            break;
+        case kClearCoreCcioPortCom1:
+            serial = &ConnectorCOM1;
+            break;
+        default:
+            return 0;
+    }
+    if (serial == ccioPort) {
+        return 1;
+    }
+    // The port is in use in a UART mode, e.g. by the serial gateway
+    if (serial != NULL && serial->PortIsOpen()) {
+        return 0;
+    }
+    if (ccioPort != NULL) {
+        ccioPort->PortClose();
+        ccioPort->Mode(Connector::TTL);
+        ccioPort = NULL;
+    }
+    if (serial == NULL) {
+        return 1;
+    }
+    // Opening the port in the CCIO mode discovers the boards
+    if (!serial->Mode(Connector::CCIO)) {
+        return 0;
+    }
+    serial->PortOpen();
+    ccioPort = serial;
+    return 1;
+}
+
+void ClearCoreCcioOutputPins(uint64_t pins) {
+    for (uint8_t i = 0; i < CLEARCORE_CCIO_PINS; i++) {
+        CcioPin *pin = CcioMgr.PinByIndex(
+                           static_cast<ClearCorePins>(CLEARCORE_PIN_CCIOA0 + i));
+        if (pin == NULL) {
+            continue;
+        }
+        pin->Mode(((pins >> i) & 1) ? Connector::OUTPUT_DIGITAL :
+                  Connector::INPUT_DIGITAL);
+    }
+}
+
+void ClearCoreCcioOutputsWrite(uint64_t outputs, uint64_t mask) {
+    CcioMgr.OutputsWrite(outputs, mask);
+}
+
+void ClearCoreCcioRediscover(int enable) {
+    CcioMgr.CcioRediscoverEnable(enable != 0);
+}
+}
+
+#endif
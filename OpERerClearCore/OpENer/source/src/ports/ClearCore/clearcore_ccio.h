@@ -0,0 +1,75 @@
+#ifndef CLEARCORE_CCIO_H_
+#define CLEARCORE_CCIO_H_
+
+/** @file clearcore_ccio.h
+ *  @brief C interface from the OpENer objects to the ClearCore
+ *  CcioBoardManager
+ *
+ *  Pin bits are numbered as in the CcioBoardManager, bit 0 is CCIOA0 of the
+ *  first board. The functions are implemented in clearcore_ccio.cpp for the
+ *  target and by a mock link in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Longest chain of CCIO-8 boards, CcioLink::BOARDS_MAX */
+#define CLEARCORE_CCIO_BOARDS_MAX 8
+
+/** @brief Pins of the longest chain */
+#define CLEARCORE_CCIO_PINS (8 * CLEARCORE_CCIO_BOARDS_MAX)
+
+/** @brief Serial ports that can carry the link */
+typedef enum {
+  kClearCoreCcioPortNone = 0, /**< link closed */
+  kClearCoreCcioPortCom0 = 1, /**< COM-0 */
+  kClearCoreCcioPortCom1 = 2 /**< COM-1 */
+} ClearCoreCcioPort;
+
+/** @brief One coherent sample of the link */
+typedef struct {
+  uint64_t inputs; /**< InputState(), the filtered inputs */
+  uint64_t outputs; /**< OutputState() */
+  uint64_t overloaded; /**< IoOverloadRT() */
+  uint32_t refresh_overruns; /**< RefreshOverruns() */
+  uint8_t boards; /**< CcioCount() */
+  uint8_t link_broken; /**< LinkBroken() */
+} ClearCoreCcioSample;
+
+/** @brief Sample the state of the link in a single call */
+void ClearCoreCcioSampleRead(ClearCoreCcioSample *sample);
+
+/** @brief Collect the input edges since the last call
+ *
+ *  The edges are cleared in the CcioBoardManager, see InputsRisen() and
+ *  InputsFallen().
+ */
+void ClearCoreCcioEdgesRead(uint64_t *risen,
+                            uint64_t *fallen);
+
+/** @brief Open the link on a port in the CCIO mode and discover the boards,
+ *  or close it
+ *
+ *  @param port ClearCoreCcioPort
+ *  @return 1 on success
+ */
+int ClearCoreCcioLinkOpen(uint8_t port);
+
+/** @brief Make the pins of the bits outputs and all others inputs */
+void ClearCoreCcioOutputPins(uint64_t pins);
+
+/** @brief Write the outputs of the pins in mask */
+void ClearCoreCcioOutputsWrite(uint64_t outputs,
+                               uint64_t mask);
+
+/** @brief Enable the rediscovery of a broken link */
+void ClearCoreCcioRediscover(int enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_CCIO_H_ */
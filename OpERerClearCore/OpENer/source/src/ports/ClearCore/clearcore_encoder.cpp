@@ -0,0 +1,60 @@
+#ifdef CLEARCORE
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_encoder.h"
+
+extern "C" {
+void ClearCoreEncoderSampleRead(ClearCoreEncoderSample *sample) {
+    if (sample == NULL) {
+        return;
+    }
+
+    // Keep the position, its timestamp and the latch from one sample time
+    __disable_irq();
+    sample->timestamp_us = EncoderIn.PositionTimestamp();
+    sample->position = EncoderIn.Position();
+    sample->velocity = EncoderIn.VelocityFiltered();
+    sample->index_position = EncoderIn.IndexPosition();
+    sample->latch_position = EncoderIn.RegistrationPosition();
+    sample->latch_timestamp_us = EncoderIn.RegistrationTimestamp();
+    sample->latch_count = EncoderIn.RegistrationCount();
+    sample->latch_armed = EncoderIn.RegistrationLatchArmed() ? 1 : 0;
+    __enable_irq();
+    sample->quadrature_error = EncoderIn.QuadratureError() ? 1 : 0;
+}
+
+void ClearCoreEncoderEnable(int enable) {
+    EncoderIn.Enable(enable != 0);
+}
+
+void ClearCoreEncoderPositionSet(int32_t position) {
+    EncoderIn.Position(position);
+}
+
+void ClearCoreEncoderClearQuadratureError(void) {
+    EncoderIn.ClearQuadratureError();
+}
+
+void ClearCoreEncoderVelocityFilterMs(uint16_t filter_ms) {
+    EncoderIn.VelocityFilterTc_ms(filter_ms);
+}
+
+int ClearCoreEncoderLatchArm(uint8_t pin, uint8_t trigger) {
+    switch (trigger) {
+        case kClearCoreEncoderLatchChange:
+        case kClearCoreEncoderLatchFalling:
+        case kClearCoreEncoderLatchRising:
+            break;
+        default:
+            return 0;
+    }
+    return EncoderIn.RegistrationLatchArm(
+               static_cast<ClearCorePins>(pin),
+               static_cast<InputManager::InterruptTrigger>(trigger)) ? 1 : 0;
+}
+
+void ClearCoreEncoderLatchDisarm(void) {
+    EncoderIn.RegistrationLatchDisarm();
+}
+}
+
+#endif
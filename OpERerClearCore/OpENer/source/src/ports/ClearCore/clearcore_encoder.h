@@ -0,0 +1,68 @@
+#ifndef CLEARCORE_ENCODER_H_
+#define CLEARCORE_ENCODER_H_
+
+/** @file clearcore_encoder.h
+ *  @brief C interface from the OpENer objects to the ClearCore EncoderInput
+ *
+ *  The functions are implemented in clearcore_encoder.cpp for the target and
+ *  by a mock encoder in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief One coherent sample of the encoder input, taken with the sample
+ *  interrupt blocked */
+typedef struct {
+  uint32_t timestamp_us; /**< PositionTimestamp() */
+  int32_t position; /**< Position() in counts */
+  int32_t velocity; /**< VelocityFiltered() in counts/s */
+  int32_t index_position; /**< IndexPosition() in counts */
+  int32_t latch_position; /**< RegistrationPosition() in counts */
+  uint32_t latch_timestamp_us; /**< RegistrationTimestamp() */
+  uint32_t latch_count; /**< RegistrationCount() */
+  uint8_t latch_armed; /**< RegistrationLatchArmed() */
+  uint8_t quadrature_error; /**< QuadratureError() */
+} ClearCoreEncoderSample;
+
+/** @brief Edge that triggers the registration latch, the values match
+ *  ClearCore::InputManager::InterruptTrigger */
+typedef enum {
+  kClearCoreEncoderLatchChange = 2,
+  kClearCoreEncoderLatchFalling = 3,
+  kClearCoreEncoderLatchRising = 4
+} ClearCoreEncoderLatchTrigger;
+
+/** @brief Sample all values of the encoder input in a single call */
+void ClearCoreEncoderSampleRead(ClearCoreEncoderSample *sample);
+
+/** @brief Enable the position decoder; DI-6 .. DI-8 become encoder inputs */
+void ClearCoreEncoderEnable(int enable);
+
+/** @brief Set the current position in counts */
+void ClearCoreEncoderPositionSet(int32_t position);
+
+void ClearCoreEncoderClearQuadratureError(void);
+
+/** @brief Set the 99 % rise time of the velocity filter in ms */
+void ClearCoreEncoderVelocityFilterMs(uint16_t filter_ms);
+
+/** @brief Arm the one-shot registration latch
+ *
+ *  @param pin ClearCore connector number 6 (DI-6) .. 12 (A-12)
+ *  @param trigger see @ref ClearCoreEncoderLatchTrigger
+ *  @return 1 if the latch was armed
+ */
+int ClearCoreEncoderLatchArm(uint8_t pin,
+                             uint8_t trigger);
+
+void ClearCoreEncoderLatchDisarm(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_ENCODER_H_ */
@@ -0,0 +1,102 @@
+#ifdef CLEARCORE
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_motion.h"
+
+static MotorDriver *const kMotorAxes[CLEARCORE_MOTOR_AXIS_COUNT] = {
+    &ConnectorM0, &ConnectorM1, &ConnectorM2, &ConnectorM3
+};
+
+static inline MotorDriver *MotorAxis(unsigned int axis) {
+    return (axis < CLEARCORE_MOTOR_AXIS_COUNT) ? kMotorAxes[axis] : NULL;
+}
+
+extern "C" {
+void ClearCoreMotorInitialize(void) {
+    MotorMgr.MotorModeSet(MotorManager::MOTOR_ALL,
+                          Connector::CPM_MODE_STEP_AND_DIR);
+}
+
+int ClearCoreMotorSampleRead(unsigned int axis,
+                             ClearCoreMotorSample *sample) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor == NULL || sample == NULL) {
+        return -1;
+    }
+
+    sample->position_commanded = motor->PositionRefCommanded();
+    sample->velocity_commanded = motor->VelocityRefCommanded();
+    sample->status_reg = motor->StatusReg().reg;
+    sample->alert_reg = motor->AlertReg().reg;
+    sample->hlfb_percent = motor->HlfbPercent();
+    sample->hlfb_state = (uint8_t)motor->HlfbState();
+    sample->enable_request = motor->EnableRequest() ? 1 : 0;
+    return 0;
+}
+
+int ClearCoreMotorMove(unsigned int axis, int32_t distance, int absolute) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor == NULL) {
+        return 0;
+    }
+    return motor->Move(distance, absolute ?
+                       StepGenerator::MOVE_TARGET_ABSOLUTE :
+                       StepGenerator::MOVE_TARGET_REL_END_POSN) ? 1 : 0;
+}
+
+int ClearCoreMotorMoveVelocity(unsigned int axis, int32_t velocity) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor == NULL) {
+        return 0;
+    }
+    return motor->MoveVelocity(velocity) ? 1 : 0;
+}
+
+void ClearCoreMotorStop(unsigned int axis, int abrupt) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor == NULL) {
+        return;
+    }
+    if (abrupt) {
+        motor->MoveStopAbrupt();
+    } else {
+        motor->MoveStopDecel();
+    }
+}
+
+void ClearCoreMotorEnable(unsigned int axis, int enable) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor != NULL) {
+        motor->EnableRequest(enable != 0);
+    }
+}
+
+void ClearCoreMotorVelMax(unsigned int axis, uint32_t vel_max) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor != NULL) {
+        motor->VelMax(vel_max);
+    }
+}
+
+void ClearCoreMotorAccelMax(unsigned int axis, uint32_t accel_max) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor != NULL) {
+        motor->AccelMax(accel_max);
+    }
+}
+
+void ClearCoreMotorEStopDecelMax(unsigned int axis, uint32_t decel_max) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor != NULL) {
+        motor->EStopDecelMax(decel_max);
+    }
+}
+
+void ClearCoreMotorClearAlerts(unsigned int axis) {
+    MotorDriver *motor = MotorAxis(axis);
+    if (motor != NULL) {
+        motor->ClearAlerts();
+    }
+}
+}
+
+#endif
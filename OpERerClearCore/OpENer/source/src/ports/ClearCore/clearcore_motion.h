@@ -0,0 +1,74 @@
+#ifndef CLEARCORE_MOTION_H_
+#define CLEARCORE_MOTION_H_
+
+/** @file clearcore_motion.h
+ *  @brief C interface from the OpENer objects to the ClearCore MotorDriver
+ *  connectors M-0 .. M-3
+ *
+ *  The functions are implemented in clearcore_motion.cpp for the target and
+ *  by a mock MotorDriver in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of MotorDriver connectors on the ClearCore */
+#define CLEARCORE_MOTOR_AXIS_COUNT 4
+
+/** @brief Value reported in hlfb_percent when no PWM has been measured */
+#define CLEARCORE_MOTOR_HLFB_DUTY_UNKNOWN (-9999.0f)
+
+/** @brief One coherent sample of a MotorDriver connector */
+typedef struct {
+  int32_t position_commanded; /**< PositionRefCommanded() in steps */
+  int32_t velocity_commanded; /**< VelocityRefCommanded() in steps/s */
+  uint32_t status_reg; /**< StatusReg().reg */
+  uint32_t alert_reg; /**< AlertReg().reg */
+  float hlfb_percent; /**< HlfbPercent() */
+  uint8_t hlfb_state; /**< HlfbState() */
+  uint8_t enable_request; /**< EnableRequest() */
+} ClearCoreMotorSample;
+
+/** @brief Put all MotorDriver connectors into step and direction mode */
+void ClearCoreMotorInitialize(void);
+
+/** @brief Sample all monitored values of one axis in a single call
+ *
+ *  @param axis MotorDriver index 0 .. CLEARCORE_MOTOR_AXIS_COUNT - 1
+ *  @param sample storage for the sampled values
+ *  @return 0 on success, -1 for an invalid axis
+ */
+int ClearCoreMotorSampleRead(unsigned int axis,
+                             ClearCoreMotorSample *sample);
+
+/** @brief Issue a positional move, returns 1 if the move was accepted */
+int ClearCoreMotorMove(unsigned int axis,
+                       int32_t distance,
+                       int absolute);
+
+/** @brief Issue a velocity move, returns 1 if the move was accepted */
+int ClearCoreMotorMoveVelocity(unsigned int axis,
+                               int32_t velocity);
+
+/** @brief Stop the axis, either abruptly or with the E-stop deceleration */
+void ClearCoreMotorStop(unsigned int axis,
+                        int abrupt);
+
+void ClearCoreMotorEnable(unsigned int axis,
+                          int enable);
+void ClearCoreMotorVelMax(unsigned int axis,
+                          uint32_t vel_max);
+void ClearCoreMotorAccelMax(unsigned int axis,
+                            uint32_t accel_max);
+void ClearCoreMotorEStopDecelMax(unsigned int axis,
+                                 uint32_t decel_max);
+void ClearCoreMotorClearAlerts(unsigned int axis);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_MOTION_H_ */
@@ -0,0 +1,80 @@
+#ifdef CLEARCORE
+#include <stddef.h>
+
+#include "opener_user_conf.h"
+#include "ports/ClearCore/clearcore_netmem.h"
+
+#include "lwip/opt.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/stats.h"
+#include "lwip/sys.h"
+
+/* The memory profile of lwipopts.h is sized for these limits */
+#if CLEARCORE_LWIP_SESSIONS != OPENER_NUMBER_OF_SUPPORTED_SESSIONS
+#error "CLEARCORE_LWIP_SESSIONS of lwipopts.h differs from OPENER_NUMBER_OF_SUPPORTED_SESSIONS"
+#endif
+#if CLEARCORE_LWIP_EXPLICIT_CONNS != OPENER_CIP_NUM_EXPLICIT_CONNS
+#error "CLEARCORE_LWIP_EXPLICIT_CONNS of lwipopts.h differs from OPENER_CIP_NUM_EXPLICIT_CONNS"
+#endif
+#if CLEARCORE_LWIP_IO_CONNS != \
+  (OPENER_CIP_NUM_EXLUSIVE_OWNER_CONNS + OPENER_CIP_NUM_INPUT_ONLY_CONNS + \
+   OPENER_CIP_NUM_LISTEN_ONLY_CONNS)
+#error "CLEARCORE_LWIP_IO_CONNS of lwipopts.h differs from the I/O connections of opener_user_conf.h"
+#endif
+
+#if !MEM_STATS || !MEMP_STATS
+#error "The Network Memory object needs MEM_STATS and MEMP_STATS of lwIP"
+#endif
+
+/** @brief Names of the memp pools, lwIP only keeps them for LWIP_DEBUG */
+static const char *const kNetMemPoolNames[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) desc,
+#include "lwip/priv/memp_std.h"
+};
+
+static struct stats_mem *NetMemStats(unsigned int pool) {
+  if(0 == pool) {
+    return &lwip_stats.mem;
+  }
+  return (pool <= MEMP_MAX) ? lwip_stats.memp[pool - 1] : NULL;
+}
+
+unsigned int ClearCoreNetMemPoolCount(void) {
+  return MEMP_MAX + 1;
+}
+
+const char *ClearCoreNetMemPoolName(unsigned int pool) {
+  if(0 == pool) {
+    return "HEAP";
+  }
+  return (pool <= MEMP_MAX) ? kNetMemPoolNames[pool - 1] : "";
+}
+
+int ClearCoreNetMemRead(unsigned int pool, ClearCoreNetMemStats *stats) {
+  const struct stats_mem *mem = NetMemStats(pool);
+  if(NULL == mem) {
+    return -1;
+  }
+  SYS_ARCH_DECL_PROTECT(old_level);
+  SYS_ARCH_PROTECT(old_level);
+  stats->avail = mem->avail;
+  stats->used = mem->used;
+  stats->max = mem->max;
+  stats->err = mem->err;
+  SYS_ARCH_UNPROTECT(old_level);
+  return 0;
+}
+
+void ClearCoreNetMemReset(void) {
+  for(unsigned int pool = 0; pool <= MEMP_MAX; ++pool) {
+    struct stats_mem *mem = NetMemStats(pool);
+    SYS_ARCH_DECL_PROTECT(old_level);
+    SYS_ARCH_PROTECT(old_level);
+    mem->max = mem->used;
+    mem->err = 0;
+    SYS_ARCH_UNPROTECT(old_level);
+  }
+}
+
+#endif
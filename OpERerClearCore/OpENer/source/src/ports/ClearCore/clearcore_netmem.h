@@ -0,0 +1,50 @@
+#ifndef CLEARCORE_NETMEM_H_
+#define CLEARCORE_NETMEM_H_
+
+/** @file clearcore_netmem.h
+ *  @brief C interface from the OpENer objects to the lwIP memory statistics
+ *
+ *  Pool 0 is the lwIP heap (MEM_SIZE), which holds the PBUF_RAM replies and
+ *  the TCP data, pools 1 and up are the memp pools of lwIP in the order of
+ *  lwip/priv/memp_std.h, e.g. TCP_PCB, NETCONN and PBUF_POOL. Their sizes
+ *  come from the memory profile of lwipopts.h.
+ *
+ *  The functions are implemented in clearcore_netmem.c for the target and
+ *  by a mock in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Usage of one lwIP pool or the heap */
+typedef struct {
+  uint32_t avail; /**< elements, bytes for the heap */
+  uint32_t used; /**< elements or bytes in use */
+  uint32_t max; /**< most in use since the start or the last reset */
+  uint32_t err; /**< failed allocations */
+} ClearCoreNetMemStats;
+
+/** @brief Number of pools, the heap included */
+unsigned int ClearCoreNetMemPoolCount(void);
+
+/** @brief Name of a pool as lwIP calls it, "" for an invalid pool */
+const char *ClearCoreNetMemPoolName(unsigned int pool);
+
+/** @brief Read the usage of one pool
+ *
+ *  @return 0 on success, -1 for an invalid pool
+ */
+int ClearCoreNetMemRead(unsigned int pool, ClearCoreNetMemStats *stats);
+
+/** @brief Restart the maximum of all pools from their current use and clear
+ *  the failed allocations */
+void ClearCoreNetMemReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_NETMEM_H_ */
@@ -0,0 +1,44 @@
+#ifdef CLEARCORE
+#include "NvmManager.h"
+#include "ports/ClearCore/clearcore_nvstore.h"
+
+using ClearCore::NvmManager;
+
+static int DataFlashRead(void *context, size_t offset, void *data,
+                         size_t length) {
+    (void)context;
+    return NvmManager::Instance().DataFlashRead(
+               offset, length, static_cast<uint8_t *>(data)) ? 0 : -1;
+}
+
+static int DataFlashProgram(void *context, size_t offset, const void *data,
+                            size_t length) {
+    (void)context;
+    return NvmManager::Instance().DataFlashWrite(
+               offset, length, static_cast<const uint8_t *>(data)) ? 0 : -1;
+}
+
+static int DataFlashErase(void *context, size_t offset) {
+    (void)context;
+    return NvmManager::Instance().DataFlashErase(offset) ? 0 : -1;
+}
+
+static NvStoreFlash clearcore_nvstore_flash = {
+    NvmManager::DATA_FLASH_BLOCK_SIZE, 0,
+    DataFlashRead, DataFlashProgram, DataFlashErase, NULL
+};
+
+extern "C" {
+const NvStoreFlash *ClearCoreNvStoreFlash(void) {
+    static_assert(NvmManager::DATA_FLASH_QUAD_WORD_SIZE == kNvStoreUnit,
+                  "the NV store unit must be the flash quad word");
+    clearcore_nvstore_flash.sector_count =
+        NvmManager::Instance().DataFlashSize() /
+        NvmManager::DATA_FLASH_BLOCK_SIZE;
+    if (clearcore_nvstore_flash.sector_count < 2) {
+        return NULL;
+    }
+    return &clearcore_nvstore_flash;
+}
+}
+#endif
@@ -0,0 +1,31 @@
+#ifndef CLEARCORE_NVSTORE_H_
+#define CLEARCORE_NVSTORE_H_
+
+/** @file clearcore_nvstore.h
+ *  @brief Flash of the NV store on the ClearCore
+ *
+ *  The store uses the data flash area of NvmManager, the main flash blocks
+ *  the linker script keeps free at the end of the second flash bank. Each
+ *  8 KB block is a sector of the store. Erasing a block blocks the caller
+ *  for a few milliseconds, which the write coalescing of the store keeps to
+ *  the rare sector moves.
+ */
+
+#include "ports/nvdata/nvstore.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Flash of the NV store
+ *
+ *  @return the data flash area, NULL if the linker script reserves less
+ *          than two blocks
+ */
+const NvStoreFlash *ClearCoreNvStoreFlash(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_NVSTORE_H_ */
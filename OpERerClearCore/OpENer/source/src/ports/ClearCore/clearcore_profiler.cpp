@@ -0,0 +1,50 @@
+#ifdef CLEARCORE
+#include <string.h>
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_profiler.h"
+
+static_assert(CLEARCORE_PROFILER_HIST_BINS == PROFILE_HIST_BINS,
+              "Profiler histogram size mismatch");
+
+extern "C" {
+unsigned int ClearCoreProfilerSectionCount(void) {
+    return PROFILE_SECTION_COUNT;
+}
+
+const char *ClearCoreProfilerSectionName(unsigned int section) {
+    return SysProfiler::SectionName(static_cast<ProfileSections>(section));
+}
+
+int ClearCoreProfilerRead(unsigned int section,
+                          ClearCoreProfilerStats *stats) {
+    ProfileStats profile;
+    if (stats == NULL ||
+            !ProfilerMgr.Snapshot(static_cast<ProfileSections>(section),
+                                  profile)) {
+        return -1;
+    }
+
+    stats->count = profile.count;
+    stats->min = profile.count ? profile.min : 0;
+    stats->max = profile.max;
+    stats->mean = profile.Mean();
+    stats->overruns = profile.overruns;
+    stats->budget = profile.budget;
+    memcpy(stats->hist, profile.hist, sizeof(stats->hist));
+    return 0;
+}
+
+void ClearCoreProfilerBudgetSet(unsigned int section, uint32_t cycles) {
+    ProfilerMgr.Budget(static_cast<ProfileSections>(section), cycles);
+}
+
+void ClearCoreProfilerReset(void) {
+    ProfilerMgr.Reset();
+}
+
+void ClearCoreProfilerDump(void) {
+    ProfilerMgr.Dump(ConnectorUsb);
+}
+}
+
+#endif
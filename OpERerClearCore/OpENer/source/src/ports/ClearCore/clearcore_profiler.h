@@ -0,0 +1,57 @@
+#ifndef CLEARCORE_PROFILER_H_
+#define CLEARCORE_PROFILER_H_
+
+/** @file clearcore_profiler.h
+ *  @brief C interface from the OpENer objects to the ClearCore SysProfiler
+ *
+ *  The functions are implemented in clearcore_profiler.cpp for the target and
+ *  by a mock profiler in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of histogram bins, matches PROFILE_HIST_BINS */
+#define CLEARCORE_PROFILER_HIST_BINS 20
+
+/** @brief Cycle statistics of one profiled section */
+typedef struct {
+  uint32_t count; /**< recorded updates */
+  uint32_t min; /**< fewest cycles, 0 without samples */
+  uint32_t max; /**< most cycles */
+  uint32_t mean; /**< mean cycles */
+  uint32_t overruns; /**< updates over budget */
+  uint32_t budget; /**< cycle budget, 0 if not checked */
+  uint32_t hist[CLEARCORE_PROFILER_HIST_BINS]; /**< log2 histogram */
+} ClearCoreProfilerStats;
+
+/** @brief Number of profiled sections */
+unsigned int ClearCoreProfilerSectionCount(void);
+
+/** @brief Short name of a section, "" for an invalid section */
+const char *ClearCoreProfilerSectionName(unsigned int section);
+
+/** @brief Read the statistics of one section
+ *
+ *  @return 0 on success, -1 for an invalid section
+ */
+int ClearCoreProfilerRead(unsigned int section,
+                          ClearCoreProfilerStats *stats);
+
+void ClearCoreProfilerBudgetSet(unsigned int section,
+                                uint32_t cycles);
+
+/** @brief Clear the statistics of all sections */
+void ClearCoreProfilerReset(void);
+
+/** @brief Print all sections to the USB serial port */
+void ClearCoreProfilerDump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_PROFILER_H_ */
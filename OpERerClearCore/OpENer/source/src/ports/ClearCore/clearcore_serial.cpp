@@ -0,0 +1,101 @@
+#ifdef CLEARCORE
+#include "ClearCore.h"
+#include "ports/ClearCore/clearcore_serial.h"
+
+namespace {
+
+SerialDriver *SerialPort(uint8_t port) {
+    switch (port) {
+        case kClearCoreSerialPortCom0:
+            return &ConnectorCOM0;
+        case kClearCoreSerialPortCom1:
+            return &ConnectorCOM1;
+        default:
+            return NULL;
+    }
+}
+
+} // anonymous namespace
+
+extern "C" {
+int ClearCoreSerialOpen(uint8_t port, const ClearCoreSerialConfig *config) {
+    SerialDriver *serial = SerialPort(port);
+    if (serial == NULL) {
+        return 0;
+    }
+    // Leave a CCIO-8 link alone, open or not
+    if (serial->Mode() == Connector::CCIO) {
+        return 0;
+    }
+    if (config == NULL) {
+        serial->PortClose();
+        return 1;
+    }
+
+    ISerial::Parities parity;
+    switch (config->parity) {
+        case kClearCoreSerialParityNone:
+            parity = ISerial::PARITY_N;
+            break;
+        case kClearCoreSerialParityOdd:
+            parity = ISerial::PARITY_O;
+            break;
+        case kClearCoreSerialParityEven:
+            parity = ISerial::PARITY_E;
+            break;
+        default:
+            return 0;
+    }
+    Connector::ConnectorModes mode;
+    switch (config->mode) {
+        case kClearCoreSerialModeTtl:
+            mode = Connector::TTL;
+            break;
+        case kClearCoreSerialModeRs232:
+            mode = Connector::RS232;
+            break;
+        default:
+            return 0;
+    }
+
+    // Apply the settings to a closed port, PortOpen() sets it up once
+    serial->PortClose();
+    if (!serial->Mode(mode) || !serial->StopBits(config->stop_bits) ||
+            !serial->Parity(parity) || !serial->UartDma(true)) {
+        return 0;
+    }
+    serial->Speed(config->baud_rate);
+    serial->PortOpen();
+    return 1;
+}
+
+int32_t ClearCoreSerialWrite(uint8_t port, const uint8_t *data,
+                             int32_t length) {
+    SerialDriver *serial = SerialPort(port);
+    return (serial != NULL) ? serial->Write(data, length) : 0;
+}
+
+int32_t ClearCoreSerialRead(uint8_t port, uint8_t *data, int32_t length) {
+    SerialDriver *serial = SerialPort(port);
+    return (serial != NULL) ? serial->Read(data, length) : 0;
+}
+
+void ClearCoreSerialFlushInput(uint8_t port) {
+    SerialDriver *serial = SerialPort(port);
+    if (serial != NULL) {
+        serial->FlushInput();
+    }
+}
+
+int ClearCoreSerialRxIdle(uint8_t port) {
+    SerialDriver *serial = SerialPort(port);
+    return (serial != NULL && serial->RxIdle()) ? 1 : 0;
+}
+
+uint32_t ClearCoreSerialErrors(uint8_t port) {
+    SerialDriver *serial = SerialPort(port);
+    return (serial != NULL) ? serial->ErrorStatusAccum().reg : 0;
+}
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef CLEARCORE_SERIAL_H_
+#define CLEARCORE_SERIAL_H_
+
+/** @file clearcore_serial.h
+ *  @brief C interface from the OpENer objects to the ClearCore COM-0 and
+ *  COM-1 serial ports in a UART mode
+ *
+ *  The ports are opened in the UART DMA mode of SerialBase, so data moves in
+ *  blocks through its rings and the end of a message is found by the idle
+ *  line. The functions are implemented in clearcore_serial.cpp for the target
+ *  and by a mock serial device in the unit tests.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Serial ports, numbered as the CCIO-8 link ports */
+typedef enum {
+  kClearCoreSerialPortCom0 = 1, /**< COM-0 */
+  kClearCoreSerialPortCom1 = 2 /**< COM-1 */
+} ClearCoreSerialPort;
+
+/** @brief Signal levels of a port */
+typedef enum {
+  kClearCoreSerialModeTtl = 0, /**< TTL levels */
+  kClearCoreSerialModeRs232 = 1 /**< RS-232 levels */
+} ClearCoreSerialMode;
+
+/** @brief Parity of the UART frame */
+typedef enum {
+  kClearCoreSerialParityNone = 0,
+  kClearCoreSerialParityOdd = 1,
+  kClearCoreSerialParityEven = 2
+} ClearCoreSerialParity;
+
+/** @brief Settings of an open port */
+typedef struct {
+  uint8_t mode; /**< ClearCoreSerialMode */
+  uint32_t baud_rate; /**< bits per second */
+  uint8_t parity; /**< ClearCoreSerialParity */
+  uint8_t stop_bits; /**< 1 or 2 */
+} ClearCoreSerialConfig;
+
+/** @brief Open a port with the given settings, or close it
+ *
+ *  A port that carries a CCIO-8 link is refused.
+ *
+ *  @param port ClearCoreSerialPort
+ *  @param config settings, NULL to close the port
+ *  @return 1 on success
+ */
+int ClearCoreSerialOpen(uint8_t port,
+                        const ClearCoreSerialConfig *config);
+
+/** @brief Queue up to @p length bytes to send without waiting
+ *
+ *  @return the number of bytes queued
+ */
+int32_t ClearCoreSerialWrite(uint8_t port,
+                             const uint8_t *data,
+                             int32_t length);
+
+/** @brief Copy up to @p length received bytes without waiting
+ *
+ *  @return the number of bytes copied
+ */
+int32_t ClearCoreSerialRead(uint8_t port,
+                            uint8_t *data,
+                            int32_t length);
+
+/** @brief Drop all received bytes */
+void ClearCoreSerialFlushInput(uint8_t port);
+
+/** @brief Check for the end of a received message
+ *
+ *  @return 1 once the line went idle after the last received byte
+ */
+int ClearCoreSerialRxIdle(uint8_t port);
+
+/** @brief Collect the error bits of SerialBase::ErrorStatusAccum()
+ *
+ *  Bit 0 frame, bit 1 parity, bit 2 overflow error, cleared on read.
+ */
+uint32_t ClearCoreSerialErrors(uint8_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_SERIAL_H_ */
@@ -0,0 +1,152 @@
+#ifdef CLEARCORE
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "ClearCore.h"
+#include "opener_user_conf.h"
+#include "ports/ClearCore/clearcore_trace.h"
+extern "C" {
+#include "ports/tracering.h"
+}
+#include "lwip/ip_addr.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+/** Words moved to the sink per ClearCoreTraceDrain() call */
+#define CLEARCORE_TRACE_DRAIN_WORDS 256
+
+static size_t TraceUsbSpace(void) {
+    int32_t space = ConnectorUsb.AvailableForWrite();
+    return space > 0 ? (size_t)space : 0;
+}
+
+static void TraceUsbPut(const uint8_t *data, size_t length) {
+    ConnectorUsb.Send(reinterpret_cast<const char *>(data), length);
+}
+
+static struct udp_pcb *trace_udp_pcb = NULL;
+static ip_addr_t trace_udp_address;
+static uint16_t trace_udp_port = 0;
+
+static size_t TraceUdpSpace(void) {
+    if (0 == trace_udp_port || NULL == netif_default ||
+            !netif_is_up(netif_default) ||
+            ip4_addr_isany_val(*netif_ip4_addr(netif_default))) {
+        return 0;
+    }
+    return CLEARCORE_TRACE_DRAIN_WORDS * sizeof(uint32_t);
+}
+
+static void TraceUdpPut(const uint8_t *data, size_t length) {
+    if (NULL == trace_udp_pcb) {
+        trace_udp_pcb = udp_new();
+        if (NULL == trace_udp_pcb) {
+            return;
+        }
+    }
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)length, PBUF_RAM);
+    if (NULL == p) {
+        return;
+    }
+    memcpy(p->payload, data, length);
+    udp_sendto(trace_udp_pcb, p, &trace_udp_address, trace_udp_port);
+    pbuf_free(p);
+}
+
+extern "C" {
+const ClearCoreTraceSink kClearCoreTraceSinkUsb = {
+    TraceUsbSpace, TraceUsbPut
+};
+
+const ClearCoreTraceSink kClearCoreTraceSinkUdp = {
+    TraceUdpSpace, TraceUdpPut
+};
+}
+
+static const ClearCoreTraceSink *trace_sink = &kClearCoreTraceSinkUsb;
+
+#if CLEARCORE_TRACE_DEFERRED
+static_assert((CLEARCORE_TRACE_RING_WORDS &
+               (CLEARCORE_TRACE_RING_WORDS - 1)) == 0 &&
+              CLEARCORE_TRACE_RING_WORDS >= 64,
+              "CLEARCORE_TRACE_RING_WORDS must be a power of two >= 64");
+
+static uint32_t trace_ring_buffer[CLEARCORE_TRACE_RING_WORDS];
+static TraceRing trace_ring;
+
+/** Set up the ring before the first trace, static constructors may trace */
+static TraceRing *TraceRingGet(void) {
+    static bool initialized = false;
+    if (!initialized) {
+        TraceRingInit(&trace_ring, trace_ring_buffer,
+                      CLEARCORE_TRACE_RING_WORDS);
+        initialized = true;
+    }
+    return &trace_ring;
+}
+#endif
+
+extern "C" {
+void ClearCoreTraceOutput(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+#if CLEARCORE_TRACE_DEFERRED
+    TraceRingRecordV(TraceRingGet(), Microseconds(), format, args);
+#else
+    static char buffer[512];
+    int len = vsnprintf(buffer, sizeof(buffer) - 1, format, args);
+
+    if (len > 0) {
+        buffer[len] = '\0';
+
+        if (len > 0 && buffer[len - 1] != '\n') {
+            if (len < (int)sizeof(buffer) - 1) {
+                buffer[len] = '\n';
+                buffer[len + 1] = '\0';
+            }
+        }
+
+        ConnectorUsb.Send(buffer);
+        ConnectorUsb.Flush();
+    }
+#endif
+    va_end(args);
+}
+
+void ClearCoreTraceDrain(void) {
+#if CLEARCORE_TRACE_DEFERRED
+    static uint32_t records[CLEARCORE_TRACE_DRAIN_WORDS];
+    size_t space = trace_sink->space() / sizeof(uint32_t);
+    if (space > CLEARCORE_TRACE_DRAIN_WORDS) {
+        space = CLEARCORE_TRACE_DRAIN_WORDS;
+    }
+    if (space == 0) {
+        return;
+    }
+    size_t words = TraceRingRead(TraceRingGet(), records, space);
+    if (words > 0) {
+        trace_sink->put(reinterpret_cast<const uint8_t *>(records),
+                        words * sizeof(uint32_t));
+    }
+#endif
+}
+
+void ClearCoreTraceSinkSet(const ClearCoreTraceSink *sink) {
+    trace_sink = (sink != NULL) ? sink : &kClearCoreTraceSinkUsb;
+}
+
+void ClearCoreTraceUdpTarget(uint32_t ip_address, uint16_t port) {
+    ip_addr_set_ip4_u32(&trace_udp_address, lwip_htonl(ip_address));
+    trace_udp_port = port;
+}
+
+uint32_t ClearCoreTraceDropped(void) {
+#if CLEARCORE_TRACE_DEFERRED
+    return TraceRingDropped(TraceRingGet());
+#else
+    return 0;
+#endif
+}
+}
+#endif
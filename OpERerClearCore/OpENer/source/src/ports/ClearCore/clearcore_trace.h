@@ -0,0 +1,67 @@
+#ifndef CLEARCORE_TRACE_H_
+#define CLEARCORE_TRACE_H_
+
+/** @file clearcore_trace.h
+ *  @brief Trace output of OpENer on the ClearCore
+ *
+ *  With CLEARCORE_TRACE_DEFERRED set (the default, see opener_user_conf.h)
+ *  LOG_TRACE() only records the call into a binary trace ring, see
+ *  tracering.h. ClearCoreTraceDrain(), called from the main loop, moves the
+ *  records to the selected sink as far as the sink takes them without
+ *  blocking; Tools/tracedecode.py turns them back into text. Records that
+ *  do not fit into the ring are dropped and counted.
+ *
+ *  Without CLEARCORE_TRACE_DEFERRED every trace is formatted and written to
+ *  the USB serial port at once, like before.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Destination of the drained trace records */
+typedef struct {
+  /** @brief Bytes the sink takes now without blocking */
+  size_t (*space)(void);
+  /** @brief Write whole records, at most space() bytes */
+  void (*put)(const uint8_t *data, size_t length);
+} ClearCoreTraceSink;
+
+/** @brief Binary records on the USB serial port, the default */
+extern const ClearCoreTraceSink kClearCoreTraceSinkUsb;
+
+/** @brief Binary records in UDP datagrams, see ClearCoreTraceUdpTarget() */
+extern const ClearCoreTraceSink kClearCoreTraceSinkUdp;
+
+/** @brief Record (or print) one trace message, the LOG_TRACE() backend */
+void ClearCoreTraceOutput(const char *format, ...);
+
+/** @brief Move pending records to the sink, call from the main loop */
+void ClearCoreTraceDrain(void);
+
+/** @brief Select the sink of ClearCoreTraceDrain()
+ *
+ *  Other sinks, e.g. a file on the SD card, can be provided by the
+ *  application. The sink object must stay valid.
+ */
+void ClearCoreTraceSinkSet(const ClearCoreTraceSink *sink);
+
+/** @brief Set the destination of kClearCoreTraceSinkUdp
+ *
+ *  @param ip_address IPv4 address of the trace receiver, host byte order
+ *  @param port UDP port of the trace receiver, 0 stops sending
+ */
+void ClearCoreTraceUdpTarget(uint32_t ip_address,
+                             uint16_t port);
+
+/** @brief Number of trace records dropped because the ring was full */
+uint32_t ClearCoreTraceDropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLEARCORE_TRACE_H_ */
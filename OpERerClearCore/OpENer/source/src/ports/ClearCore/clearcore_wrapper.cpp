@@ -1,4 +1,6 @@
 #ifdef CLEARCORE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include "ClearCore.h"
 #include "NvmManager.h"
 #include "ports/ClearCore/clearcore_wrapper.h"
@@ -12,10 +14,16 @@
 #include "trace.h"
 #include "lwip/inet.h"
 #include <stdio.h>
-#include <stdarg.h>
 #include <string.h>
 #include <core_cm4.h>
 
+#include "ports/ClearCore/clearcore_boot.h"
+
+extern "C" {
+#include "ports/nvdata/nvdata.h"
+#include "ports/nvdata/nvtcpip.h"
+}
+
 extern "C" {
 unsigned long GetMillis(void) {
     return Milliseconds();
@@ -129,27 +137,6 @@ int ConnectorA12_GetState(void) {
     return ConnectorA12.State() ? 1 : 0;
 }
 
-void ClearCoreTraceOutput(const char *format, ...) {
-    static char buffer[512];
-    va_list args;
-    va_start(args, format);
-    int len = vsnprintf(buffer, sizeof(buffer) - 1, format, args);
-    va_end(args);
-    
-    if (len > 0) {
-        buffer[len] = '\0';
-        
-        if (len > 0 && buffer[len - 1] != '\n') {
-            if (len < (int)sizeof(buffer) - 1) {
-                buffer[len] = '\n';
-                buffer[len + 1] = '\0';
-            }
-        }
-        
-        ConnectorUsb.Send(buffer);
-        ConnectorUsb.Flush();
-    }
-}
 }
 
 int ClearCoreEepromRead(uint16_t address, uint8_t *data, size_t length) {
@@ -190,15 +177,42 @@ EipStatus IfaceApplyConfiguration(TcpIpInterface *iface, CipTcpIpObject *tcpip)
     
     OPENER_TRACE_INFO("IfaceApplyConfiguration: CALLED - This should only happen at startup!\n");
     
+    // The hostname goes out with the DHCP requests, set it first
+    if (tcpip->hostname.string != NULL && tcpip->hostname.length > 0) {
+#if LWIP_NETIF_HOSTNAME
+        if (tcpip->hostname.string[tcpip->hostname.length] == '\0') {
+            netif_set_hostname(iface, (const char *)tcpip->hostname.string);
+            OPENER_TRACE_INFO("IfaceApplyConfiguration: Hostname set to '%s'\n", tcpip->hostname.string);
+        } else {
+            static char hostname_buffer[65];
+            size_t copy_len = (tcpip->hostname.length < 64) ? tcpip->hostname.length : 64;
+            memcpy(hostname_buffer, tcpip->hostname.string, copy_len);
+            hostname_buffer[copy_len] = '\0';
+            netif_set_hostname(iface, hostname_buffer);
+            OPENER_TRACE_INFO("IfaceApplyConfiguration: Hostname set to '%s'\n", hostname_buffer);
+        }
+#endif
+    }
+    
     CipDword config_method = tcpip->config_control & kTcpipCfgCtrlMethodMask;
     
     if (config_method == kTcpipCfgCtrlDhcp) {
-        OPENER_TRACE_INFO("IfaceApplyConfiguration: Switching to DHCP mode\n");
-        bool dhcp_success = EthernetMgr.DhcpBegin();
-        if (!dhcp_success) {
-            OPENER_TRACE_ERR("IfaceApplyConfiguration: DHCP failed\n");
+        // Start with the last lease, DHCP confirms or replaces it in the
+        // background. A client already running keeps its lease.
+        CipTcpIpInterfaceConfiguration lease;
+        if (!EthernetMgr.DhcpBound() && NvTcpipLoadLease(&lease) == kEipStatusOk) {
+            ip4_addr_t ip4_addr, ip4_netmask, ip4_gateway;
+            ip4_addr.addr = lease.ip_address;
+            ip4_netmask.addr = lease.network_mask;
+            ip4_gateway.addr = lease.gateway;
+            netif_set_addr(iface, &ip4_addr, &ip4_netmask, &ip4_gateway);
+            ClearCoreBootMark("last DHCP lease applied");
+        }
+        if (!EthernetMgr.DhcpStart()) {
+            OPENER_TRACE_ERR("IfaceApplyConfiguration: DHCP failed to start\n");
             return kEipStatusError;
         }
+        OPENER_TRACE_INFO("IfaceApplyConfiguration: DHCP running\n");
     } else if (config_method == kTcpipCfgCtrlStaticIp) {
         OPENER_TRACE_INFO("IfaceApplyConfiguration: Setting static IP configuration\n");
         
@@ -241,22 +255,7 @@ EipStatus IfaceApplyConfiguration(TcpIpInterface *iface, CipTcpIpObject *tcpip)
         OPENER_TRACE_INFO("IfaceApplyConfiguration: Static IP set to %d.%d.%d.%d\n",
                           (ip_addr >> 24) & 0xFF, (ip_addr >> 16) & 0xFF,
                           (ip_addr >> 8) & 0xFF, ip_addr & 0xFF);
-    }
-    
-    if (tcpip->hostname.string != NULL && tcpip->hostname.length > 0) {
-#if LWIP_NETIF_HOSTNAME
-        if (tcpip->hostname.string[tcpip->hostname.length] == '\0') {
-            netif_set_hostname(iface, (const char *)tcpip->hostname.string);
-            OPENER_TRACE_INFO("IfaceApplyConfiguration: Hostname set to '%s'\n", tcpip->hostname.string);
-        } else {
-            static char hostname_buffer[65];
-            size_t copy_len = (tcpip->hostname.length < 64) ? tcpip->hostname.length : 64;
-            memcpy(hostname_buffer, tcpip->hostname.string, copy_len);
-            hostname_buffer[copy_len] = '\0';
-            netif_set_hostname(iface, hostname_buffer);
-            OPENER_TRACE_INFO("IfaceApplyConfiguration: Hostname set to '%s'\n", hostname_buffer);
-        }
-#endif
+        ClearCoreBootMark("static address applied");
     }
     
     tcpip->status &= ~kTcpipStatusIfaceCfgPend;
@@ -266,6 +265,9 @@ EipStatus IfaceApplyConfiguration(TcpIpInterface *iface, CipTcpIpObject *tcpip)
 
 void ClearCoreRebootDevice(void) {
     OPENER_TRACE_INFO("ClearCoreRebootDevice: Rebooting device...\n");
+    if (NvdataFlush() != kEipStatusOk) {
+        OPENER_TRACE_ERR("ClearCoreRebootDevice: Pending NV data not written\n");
+    }
     ConnectorUsb.Flush();
     Delay_ms(100);
     NVIC_SystemReset();
@@ -274,10 +276,12 @@ void ClearCoreRebootDevice(void) {
 void ClearCoreClearNvram(void) {
     OPENER_TRACE_INFO("ClearCoreClearNvram: Clearing NVRAM...\n");
     
+    // Clear the settings of older firmware too, or they would migrate back
     uint8_t zero_magic[4] = {0, 0, 0, 0};
     ClearCore::NvmManager &nvm = ClearCore::NvmManager::Instance();
     
     bool success = nvm.BlockWrite((ClearCore::NvmManager::NvmLocations)0x0100, 4, zero_magic);
+    success = (NvdataClear() == kEipStatusOk) && success;
     if (success) {
         OPENER_TRACE_INFO("ClearCoreClearNvram: NVRAM cleared successfully\n");
     } else {
@@ -286,6 +290,28 @@ void ClearCoreClearNvram(void) {
     
     ConnectorUsb.Flush();
 }
+
+void ClearCoreMediaCounters(uint32_t *counters) {
+    const EthernetManager::MacCounters &mac = EthernetMgr.Counters();
+    counters[0] = mac.alignmentErrors;
+    counters[1] = mac.fcsErrors;
+    counters[2] = mac.singleCollisions;
+    counters[3] = mac.multipleCollisions;
+    counters[4] = 0;    // SQE test errors, none on 100BASE-TX
+    counters[5] = mac.deferredFrames;
+    counters[6] = mac.lateCollisions;
+    counters[7] = mac.excessiveCollisions;
+    counters[8] = mac.txUnderruns;
+    counters[9] = mac.carrierSenseErrors;
+    counters[10] = mac.oversizeFrames;
+    // Frames lost because the receive DMA fell behind or found no free
+    // RX buffer
+    counters[11] = mac.rxOverruns + mac.rxResourceErrors;
+}
+
+void ClearCoreMediaCountersClear(void) {
+    EthernetMgr.CountersClear();
+}
 }
 
 #endif
@@ -40,6 +40,11 @@ int ClearCoreEepromWrite(uint16_t address, const uint8_t *data, size_t length);
 void ClearCoreRebootDevice(void);
 void ClearCoreClearNvram(void);
 
+/* GMAC statistics in the order of the Ethernet Link media counters */
+#define CLEARCORE_MEDIA_COUNTERS 12
+void ClearCoreMediaCounters(uint32_t *counters);
+void ClearCoreMediaCountersClear(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,8 @@
  *
  ******************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_NETWORK_HANDLER
+
 #include "networkhandler.h"
 
 #include "opener_error.h"
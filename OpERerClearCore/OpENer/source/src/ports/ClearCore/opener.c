@@ -3,6 +3,8 @@
  * All rights reserved.
  *
  ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #ifdef CLEARCORE
 #include "ports/ClearCore/socket_types.h"
 #endif
@@ -21,18 +23,53 @@
 
 #ifdef CLEARCORE
 #include "ports/nvdata/nvdata.h"
+#include "ports/ClearCore/clearcore_boot.h"
+#include "ports/ClearCore/clearcore_arppin.h"
 #endif
 
 volatile int g_end_stack = 0;
 struct netif *g_netif = NULL;
 
+#ifdef CLEARCORE
+/** Time of the previous NV data processing */
+static MilliSeconds g_nvdata_last_ms = 0;
+#endif
+
+#if CLEARCORE_FAST_BOOT
+/** First connection seen, the end of the boot timeline */
+static int g_first_connection_seen = 0;
+
+/** @brief Follow address changes after the stack started
+ *
+ *  The stack starts with the stored address, or none, while DHCP runs in
+ *  the background. When DHCP binds a different address the TCP/IP object
+ *  and the address frozen for the socket setup are updated; the listeners
+ *  are bound to any address and keep working.
+ */
+static void NetifStatusChanged(struct netif *netif) {
+  if (g_end_stack || ip4_addr_isany_val(*netif_ip4_addr(netif) ) ) {
+    return;
+  }
+  IfaceGetConfiguration(netif, &g_tcpip.interface_configuration);
+  CipTcpIpCalculateMulticastIp(&g_tcpip);
+  g_network_status.ip_address = g_tcpip.interface_configuration.ip_address;
+  g_network_status.network_mask = g_tcpip.interface_configuration.network_mask;
+  OPENER_TRACE_INFO("OpENer: interface address changed\n");
+}
+#endif
+
 void opener_init(struct netif *netif) {
 
   EipStatus eip_status = 0;
 
   g_netif = netif;
 
+#if CLEARCORE_FAST_BOOT
+  /* The listeners do not need the link, start them before it comes up */
+  if (NULL != netif) {
+#else
   if (IfaceLinkIsUp(netif)) {
+#endif
     DoublyLinkedListInitialize(&connection_list,
                                CipConnectionObjectListArrayAllocator,
                                CipConnectionObjectListArrayFree);
@@ -46,6 +83,8 @@ void opener_init(struct netif *netif) {
 
 #ifdef CLEARCORE
     NvdataLoad();
+    g_nvdata_last_ms = GetMilliSeconds();
+    ClearCoreBootMark("NV data loaded");
     CipDword config_method = g_tcpip.config_control & kTcpipCfgCtrlMethodMask;
     if (config_method == kTcpipCfgCtrlDhcp || 
         config_method == kTcpipCfgCtrlStaticIp ||
@@ -76,6 +115,10 @@ void opener_init(struct netif *netif) {
       OPENER_TRACE_ERR("NetworkHandlerInitialize failed with status %d\n", eip_status);
       g_end_stack = 1;
     }
+#if CLEARCORE_FAST_BOOT
+    netif_set_status_callback(netif, NetifStatusChanged);
+    ClearCoreBootMark("encapsulation listeners up");
+#endif
   }
   else {
     OPENER_TRACE_WARN("Network link is down, OpENer not started\n");
@@ -93,13 +136,21 @@ void opener_cyclic(void) {
     return;
   }
 
+#if CLEARCORE_FAST_BOOT
+  /* A lost link is passed to lwIP, the stack keeps running */
+  ClearCoreBootNetworkProcess(g_netif);
+#else
   if (!g_netif || !IfaceLinkIsUp(g_netif)) {
     OPENER_TRACE_INFO("Network link is down, exiting OpENer\n");
     g_end_stack = 1;
     return;
   }
+#endif
 
   sys_check_timeouts();
+#ifdef CLEARCORE
+  ClearCoreArpPinPoll();
+#endif
 
 #ifdef TCPIP_THREAD_TEST
   while (tcpip_thread_poll_one() > 0) {
@@ -110,11 +161,28 @@ void opener_cyclic(void) {
     OPENER_TRACE_ERR("Error in NetworkHandler loop! Exiting OpENer!\n");
     g_end_stack = 1;
   }
+
+#if CLEARCORE_FAST_BOOT
+  if (!g_first_connection_seen && NULL != connection_list.first) {
+    g_first_connection_seen = 1;
+    ClearCoreBootMark("first connection established");
+  }
+#endif
+
+#ifdef CLEARCORE
+  /* Settings changed over the network reach flash once they stop changing */
+  MilliSeconds now_ms = GetMilliSeconds();
+  NvdataProcess(now_ms - g_nvdata_last_ms);
+  g_nvdata_last_ms = now_ms;
+#endif
 }
 
 void opener_shutdown(void) {
   if (!g_end_stack) {
     g_end_stack = 1;
+#ifdef CLEARCORE
+    NvdataFlush();
+#endif
     NetworkHandlerFinish();
     ShutdownCipStack();
   }
@@ -4,6 +4,8 @@
  *
  *****************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include "ethlinkcbs.h"
 
 #include "cipethernetlink.h"
@@ -11,6 +13,7 @@
 #include "lwip/netif.h"
 #include "lwip/snmp.h"
 #include "ports/ClearCore/opener.h"
+#include "ports/ClearCore/clearcore_wrapper.h"
 
 #if defined(OPENER_ETHLINK_CNTRS_ENABLE) && 0 != OPENER_ETHLINK_CNTRS_ENABLE
 
@@ -89,18 +92,9 @@ EipStatus EthLnkPreGetCallback
   case 5: {
     CipEthernetLinkMediaCounters *p_media_cntrs = &g_ethernet_link[idx].media_cntrs;
 
-    p_media_cntrs->ul.align_errs = 0;
-    p_media_cntrs->ul.fcs_errs = 0;
-    p_media_cntrs->ul.single_coll = 0;
-    p_media_cntrs->ul.multi_coll = 0;
-    p_media_cntrs->ul.sqe_test_errs = 0;
-    p_media_cntrs->ul.def_trans = 0;
-    p_media_cntrs->ul.late_coll = 0;
-    p_media_cntrs->ul.exc_coll = 0;
-    p_media_cntrs->ul.mac_tx_errs = 0;
-    p_media_cntrs->ul.crs_errs = 0;
-    p_media_cntrs->ul.frame_too_long = 0;
-    p_media_cntrs->ul.mac_rx_errs = 0;
+    /* from the GMAC statistics, the RX ring overruns and resource errors
+       are the MAC receive errors */
+    ClearCoreMediaCounters(p_media_cntrs->cntr32);
     break;
   }
   default:
@@ -154,6 +148,7 @@ EipStatus EthLnkPostGetCallback
       for (int idx = 0; idx < 12; ++idx) {
         g_ethernet_link[inst_no-1].media_cntrs.cntr32[idx] = 0U;
       }
+      ClearCoreMediaCountersClear();
       break;
     default:
       OPENER_TRACE_INFO(
@@ -74,9 +74,12 @@
 
 #define OPENER_CIP_NUM_EXPLICIT_CONNS 6
 
-#define OPENER_CIP_NUM_EXLUSIVE_OWNER_CONNS 1
+/* One connection for the digital I/O assemblies, one per Motion Axis, one
+ * for the CCIO-8 link and one for the serial gateway */
+#define OPENER_CIP_NUM_EXLUSIVE_OWNER_CONNS 7
 
-#define OPENER_CIP_NUM_INPUT_ONLY_CONNS 1
+/* One connection each for the encoder and the analog input assemblies */
+#define OPENER_CIP_NUM_INPUT_ONLY_CONNS 2
 
 #define OPENER_CIP_NUM_INPUT_ONLY_CONNS_PER_CON_PATH 3
 
@@ -90,6 +93,46 @@
 
 static const MilliSeconds kOpenerTimerTickInMilliSeconds = 10;
 
+/** @brief Start the network from the stored configuration at once instead
+ *  of waiting for the link and DHCP, see clearcore_boot.h
+ */
+#ifndef CLEARCORE_FAST_BOOT
+  #define CLEARCORE_FAST_BOOT 1
+#endif
+
+/** @brief Record traces into a RAM ring drained in the background instead of
+ *  printing them to USB at once, see clearcore_trace.h
+ */
+#ifndef CLEARCORE_TRACE_DEFERRED
+  #define CLEARCORE_TRACE_DEFERRED 1
+#endif
+
+/** @brief Filter the analog inputs a block of DMA results at a time outside
+ *  of the sample interrupt, see clearcore_analog.h
+ */
+#ifndef CLEARCORE_ANALOG_BLOCK_MODE
+  #define CLEARCORE_ANALOG_BLOCK_MODE 1
+#endif
+
+/** @brief Serial port of the CCIO-8 link opened at startup, a
+ *  ClearCoreCcioPort, 0 leaves the link closed, see clearcore_ccio.h
+ */
+#ifndef CLEARCORE_CCIO_PORT
+  #define CLEARCORE_CCIO_PORT 0
+#endif
+
+/** @brief Serial gateway ports opened at startup, bit 0 COM-0 and bit 1
+ *  COM-1, 0 leaves both closed, see cipserialgateway.h
+ */
+#ifndef CLEARCORE_SERIAL_GATEWAY_PORTS
+  #define CLEARCORE_SERIAL_GATEWAY_PORTS 0
+#endif
+
+/** @brief Size of the trace ring in 32-bit words, a power of two */
+#ifndef CLEARCORE_TRACE_RING_WORDS
+  #define CLEARCORE_TRACE_RING_WORDS 2048
+#endif
+
 #ifndef OPENER_UNIT_TEST
 
 #ifdef OPENER_WITH_TRACES
@@ -100,6 +143,7 @@ static const MilliSeconds kOpenerTimerTickInMilliSeconds = 10;
     extern "C" {
     #endif
     extern void ClearCoreTraceOutput(const char *format, ...);
+    extern void ClearCoreTraceDrain(void);
     #ifdef __cplusplus
     }
     #endif
@@ -112,7 +156,7 @@ static const MilliSeconds kOpenerTimerTickInMilliSeconds = 10;
     if( !(assertion) ) {                                            \
       LOG_TRACE("Assertion \"%s\" failed: file \"%s\", line %d\n",  \
                 # assertion, __FILE__, __LINE__);                   \
-      while(1) {  }                                                 \
+      while(1) { ClearCoreTraceDrain(); }                           \
     }                                                               \
   } while(0)
 
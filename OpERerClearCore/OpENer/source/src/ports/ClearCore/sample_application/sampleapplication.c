@@ -4,6 +4,8 @@
  *
  ******************************************************************************/
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -18,10 +20,20 @@
 #include "cipconnectionmanager.h"
 #include "cipethernetlink.h"
 #include "ports/ClearCore/sample_application/ethlinkcbs.h"
+#include "cip_objects/ClearCoreMotionAxis/cipmotionaxis.h"
+#include "cip_objects/ClearCoreAnalog/cipanalog.h"
+#include "cip_objects/ClearCoreCapture/cipcapture.h"
+#include "cip_objects/ClearCoreCcio/cipccio.h"
+#include "cip_objects/ClearCoreEncoder/cipencoder.h"
+#include "cip_objects/ClearCoreNetMemory/cipnetmemory.h"
+#include "cip_objects/ClearCoreProfiler/cipprofiler.h"
+#include "cip_objects/ClearCoreSerialGateway/cipserialgateway.h"
+#include "cip_objects/ClearCoreTrace/ciptrace.h"
 
 #define DEMO_APP_INPUT_ASSEMBLY_NUM                100
 #define DEMO_APP_OUTPUT_ASSEMBLY_NUM               150
 #define DEMO_APP_CONFIG_ASSEMBLY_NUM               151
+#define DEMO_APP_HEARTBEAT_INPUT_ONLY_ASSEMBLY_NUM 152
 
 EipUint8 g_assembly_data064[32];
 EipUint8 g_assembly_data096[32];
@@ -69,6 +81,79 @@ EipStatus ApplicationInitialization(void) {
                                          DEMO_APP_CONFIG_ASSEMBLY_NUM);
   OPENER_TRACE_INFO("ApplicationInitialization: Configured exclusive owner connection point\n");
 
+  if (kEipStatusOk != CipMotionAxisInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Motion Axis object creation failed\n");
+    return kEipStatusError;
+  }
+  for (unsigned int axis = 0; axis < CIP_MOTION_AXIS_INSTANCE_COUNT; ++axis) {
+    ConfigureExclusiveOwnerConnectionPoint(axis + 1,
+                                           kMotionAxisOutputAssemblyBase + axis,
+                                           kMotionAxisInputAssemblyBase + axis,
+                                           DEMO_APP_CONFIG_ASSEMBLY_NUM);
+  }
+  OPENER_TRACE_INFO("ApplicationInitialization: Configured motion axis connection points\n");
+
+  if (kEipStatusOk != CipEncoderInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Encoder object creation failed\n");
+    return kEipStatusError;
+  }
+  CreateAssemblyObject(DEMO_APP_HEARTBEAT_INPUT_ONLY_ASSEMBLY_NUM, NULL, 0);
+  ConfigureInputOnlyConnectionPoint(0,
+                                    DEMO_APP_HEARTBEAT_INPUT_ONLY_ASSEMBLY_NUM,
+                                    kEncoderInputAssembly,
+                                    DEMO_APP_CONFIG_ASSEMBLY_NUM);
+  OPENER_TRACE_INFO("ApplicationInitialization: Configured encoder input only connection point\n");
+
+  if (kEipStatusOk != CipAnalogInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Analog Input object creation failed\n");
+    return kEipStatusError;
+  }
+  ConfigureInputOnlyConnectionPoint(1,
+                                    DEMO_APP_HEARTBEAT_INPUT_ONLY_ASSEMBLY_NUM,
+                                    kAnalogInputAssembly,
+                                    DEMO_APP_CONFIG_ASSEMBLY_NUM);
+  OPENER_TRACE_INFO("ApplicationInitialization: Configured analog input only connection point\n");
+
+  if (kEipStatusOk != CipCcioInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: CCIO-8 object creation failed\n");
+    return kEipStatusError;
+  }
+  ConfigureExclusiveOwnerConnectionPoint(CIP_MOTION_AXIS_INSTANCE_COUNT + 1,
+                                         kCcioOutputAssembly,
+                                         kCcioInputAssembly,
+                                         DEMO_APP_CONFIG_ASSEMBLY_NUM);
+  OPENER_TRACE_INFO("ApplicationInitialization: Configured CCIO-8 connection point\n");
+
+  if (kEipStatusOk != CipSerialGatewayInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Serial Gateway object creation failed\n");
+    return kEipStatusError;
+  }
+  ConfigureExclusiveOwnerConnectionPoint(CIP_MOTION_AXIS_INSTANCE_COUNT + 2,
+                                         kSerialGatewayOutputAssembly,
+                                         kSerialGatewayInputAssembly,
+                                         DEMO_APP_CONFIG_ASSEMBLY_NUM);
+  OPENER_TRACE_INFO("ApplicationInitialization: Configured Serial Gateway connection point\n");
+
+  if (kEipStatusOk != CipProfilerInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: ISR Profiler object creation failed\n");
+    return kEipStatusError;
+  }
+
+  if (kEipStatusOk != CipTraceInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Trace object creation failed\n");
+    return kEipStatusError;
+  }
+
+  if (kEipStatusOk != CipNetMemoryInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Network Memory object creation failed\n");
+    return kEipStatusError;
+  }
+
+  if (kEipStatusOk != CipCaptureInit()) {
+    OPENER_TRACE_ERR("ApplicationInitialization: Waveform Capture object creation failed\n");
+    return kEipStatusError;
+  }
+
 #if defined(OPENER_ETHLINK_CNTRS_ENABLE) && 0 != OPENER_ETHLINK_CNTRS_ENABLE
   {
     CipClass *p_eth_link_class = GetCipClass(kCipEthernetLinkClassCode);
@@ -98,15 +183,16 @@ EipStatus ApplicationInitialization(void) {
 }
 
 void HandleApplication(void) {
+  CipCcioHandleApplication();
+  CipSerialGatewayHandleApplication(kOpenerTimerTickInMilliSeconds);
 }
 
 void CheckIoConnectionEvent(unsigned int output_assembly_id,
                             unsigned int input_assembly_id,
                             IoConnectionEvent io_connection_event) {
 
-  (void) output_assembly_id;
   (void) input_assembly_id;
-  (void) io_connection_event;
+  CipMotionAxisIoConnectionEvent(output_assembly_id, io_connection_event);
 }
 
 EipStatus AfterAssemblyDataReceived(CipInstance *instance) {
@@ -157,8 +243,13 @@ EipStatus AfterAssemblyDataReceived(CipInstance *instance) {
       status = kEipStatusOk;
       break;
     default:
-      OPENER_TRACE_INFO(
-          "Unknown assembly instance ind AfterAssemblyDataReceived");
+      if (!CipMotionAxisAfterAssemblyDataReceived(instance->instance_number) &&
+          !CipCcioAfterAssemblyDataReceived(instance->instance_number) &&
+          !CipSerialGatewayAfterAssemblyDataReceived(
+            instance->instance_number)) {
+        OPENER_TRACE_INFO(
+            "Unknown assembly instance ind AfterAssemblyDataReceived");
+      }
       break;
   }
   return status;
@@ -188,6 +279,15 @@ EipBool8 BeforeAssemblyDataSend(CipInstance *pa_pstInstance) {
     if (ConnectorA12_GetState()) {
       g_assembly_data064[0] |= 0x40;
     }
+  } else if (!CipMotionAxisBeforeAssemblyDataSend(
+               pa_pstInstance->instance_number) &&
+             !CipEncoderBeforeAssemblyDataSend(
+               pa_pstInstance->instance_number) &&
+             !CipAnalogBeforeAssemblyDataSend(
+               pa_pstInstance->instance_number) &&
+             !CipCcioBeforeAssemblyDataSend(
+               pa_pstInstance->instance_number)) {
+    CipSerialGatewayBeforeAssemblyDataSend(pa_pstInstance->instance_number);
   }
   return true;
 }
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * Explicit message throttle
+ *
+ ******************************************************************************/
+
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_NETWORK_HANDLER
+
+#include "explicit_throttle.h"
+
+#include "trace.h"
+
+/** @brief Bucket of a TCP socket */
+typedef struct {
+  int socket; /**< key, kEipInvalidSocket for a free entry */
+  TokenBucket bucket;
+} SocketBucket;
+
+static TokenBucket global_bucket;
+static SocketBucket socket_buckets[OPENER_NUMBER_OF_SUPPORTED_SESSIONS];
+static size_t pass_messages;
+static ExplicitThrottleCounters counters;
+
+void TokenBucketInitialize(TokenBucket *const bucket,
+                           const CipUdint rate,
+                           const CipUdint burst,
+                           const MilliSeconds actual_time) {
+  bucket->rate = rate;
+  bucket->burst = burst;
+  bucket->level = burst * 1000U;
+  bucket->last_refill = actual_time;
+}
+
+bool TokenBucketRefill(TokenBucket *const bucket,
+                       const MilliSeconds actual_time) {
+  if(0 == bucket->rate) {
+    return true;
+  }
+  const CipUdint full = bucket->burst * 1000U;
+  MilliSeconds elapsed = actual_time - bucket->last_refill;
+  bucket->last_refill = actual_time;
+  /* a rate of tokens per second is the rate in thousandths per millisecond */
+  if(elapsed >= full / bucket->rate + 1) {
+    bucket->level = full;
+  } else {
+    bucket->level += (CipUdint)elapsed * bucket->rate;
+    if(bucket->level > full) {
+      bucket->level = full;
+    }
+  }
+  return bucket->level >= 1000U;
+}
+
+void TokenBucketTake(TokenBucket *const bucket) {
+  if(0 != bucket->rate) {
+    bucket->level -= 1000U;
+  }
+}
+
+void ExplicitThrottleInitialize(const MilliSeconds actual_time) {
+  TokenBucketInitialize(&global_bucket, OPENER_EXPLICIT_GLOBAL_RATE,
+                        OPENER_EXPLICIT_GLOBAL_BURST, actual_time);
+  for(size_t i = 0; i < OPENER_NUMBER_OF_SUPPORTED_SESSIONS; ++i) {
+    socket_buckets[i].socket = kEipInvalidSocket;
+  }
+  pass_messages = 0;
+}
+
+void ExplicitThrottleStartPass(void) {
+  pass_messages = 0;
+}
+
+/** @brief Bucket of a socket, a full one for a socket without one yet */
+static TokenBucket *GetSocketBucket(const int socket,
+                                    const MilliSeconds actual_time) {
+  SocketBucket *empty = NULL;
+  for(size_t i = 0; i < OPENER_NUMBER_OF_SUPPORTED_SESSIONS; ++i) {
+    if(socket == socket_buckets[i].socket) {
+      return &socket_buckets[i].bucket;
+    }
+    if(NULL == empty && kEipInvalidSocket == socket_buckets[i].socket) {
+      empty = &socket_buckets[i];
+    }
+  }
+  if(NULL == empty) {
+    return NULL;
+  }
+  empty->socket = socket;
+  TokenBucketInitialize(&empty->bucket, OPENER_EXPLICIT_SESSION_RATE,
+                        OPENER_EXPLICIT_SESSION_BURST, actual_time);
+  return &empty->bucket;
+}
+
+bool ExplicitThrottleAdmit(const int socket,
+                           const MilliSeconds actual_time) {
+  if(0 != OPENER_EXPLICIT_MESSAGES_PER_PASS &&
+     pass_messages >= OPENER_EXPLICIT_MESSAGES_PER_PASS) {
+    counters.pass_limited++;
+    return false;
+  }
+  /* more sockets than sessions share the global bucket only */
+  TokenBucket *const bucket = GetSocketBucket(socket, actual_time);
+  if(NULL != bucket && !TokenBucketRefill(bucket, actual_time) ) {
+    counters.session_throttled++;
+    return false;
+  }
+  if(!TokenBucketRefill(&global_bucket, actual_time) ) {
+    counters.global_throttled++;
+    return false;
+  }
+  if(NULL != bucket) {
+    TokenBucketTake(bucket);
+  }
+  TokenBucketTake(&global_bucket);
+  pass_messages++;
+  counters.admitted++;
+  return true;
+}
+
+void ExplicitThrottleRemoveSocket(const int socket) {
+  for(size_t i = 0; i < OPENER_NUMBER_OF_SUPPORTED_SESSIONS; ++i) {
+    if(socket == socket_buckets[i].socket) {
+      socket_buckets[i].socket = kEipInvalidSocket;
+      OPENER_TRACE_INFO("Removes socket %d from explicit throttle\n", socket);
+    }
+  }
+}
+
+const ExplicitThrottleCounters *ExplicitThrottleGetCounters(void) {
+  return &counters;
+}
+
+void ExplicitThrottleResetCounters(void) {
+  counters = (ExplicitThrottleCounters) { 0 };
+}
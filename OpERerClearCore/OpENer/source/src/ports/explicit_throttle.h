@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * Explicit message throttle
+ *
+ ******************************************************************************/
+
+#ifndef SRC_PORTS_EXPLICIT_THROTTLE_H_
+#define SRC_PORTS_EXPLICIT_THROTTLE_H_
+
+/** @file explicit_throttle.h
+ *  @brief Token buckets for the explicit messages received over TCP
+ *
+ *  The network handler asks ExplicitThrottleAdmit() before it handles an
+ *  encapsulation message of a TCP socket. A message is handled when the
+ *  pass of NetworkHandlerProcessCyclic() has room left, the bucket of its
+ *  socket has a token and the global bucket has one. Else it stays in the
+ *  socket for a later pass, and TCP flow control slows the client down, so
+ *  a client that polls as fast as it can does not delay the I/O connections.
+ *
+ *  A bucket holds up to burst tokens and gains rate tokens per second, a
+ *  rate of 0 disables it.
+ */
+
+#include "typedefs.h"
+#include "opener_user_conf.h"
+
+/** @brief Explicit messages per second of one TCP socket */
+#ifndef OPENER_EXPLICIT_SESSION_RATE
+  #define OPENER_EXPLICIT_SESSION_RATE 100
+#endif
+
+/** @brief Explicit messages one TCP socket may send at once */
+#ifndef OPENER_EXPLICIT_SESSION_BURST
+  #define OPENER_EXPLICIT_SESSION_BURST 10
+#endif
+
+/** @brief Explicit messages per second of all TCP sockets */
+#ifndef OPENER_EXPLICIT_GLOBAL_RATE
+  #define OPENER_EXPLICIT_GLOBAL_RATE 400
+#endif
+
+/** @brief Explicit messages all TCP sockets may send at once */
+#ifndef OPENER_EXPLICIT_GLOBAL_BURST
+  #define OPENER_EXPLICIT_GLOBAL_BURST 20
+#endif
+
+/** @brief Explicit messages handled in one pass of
+ *  NetworkHandlerProcessCyclic(), 0 for no limit */
+#ifndef OPENER_EXPLICIT_MESSAGES_PER_PASS
+  #define OPENER_EXPLICIT_MESSAGES_PER_PASS 4
+#endif
+
+/** @brief Token bucket, the tokens are kept in thousandths */
+typedef struct token_bucket {
+  CipUdint level; /**< thousandths of a token */
+  CipUdint rate; /**< tokens per second, 0 admits everything */
+  CipUdint burst; /**< tokens when full */
+  MilliSeconds last_refill; /**< time of the last refill */
+} TokenBucket;
+
+/** @brief Counters of the explicit message throttle */
+typedef struct explicit_throttle_counters {
+  CipUdint admitted; /**< messages handled */
+  CipUdint session_throttled; /**< deferred by the bucket of their socket */
+  CipUdint global_throttled; /**< deferred by the global bucket */
+  CipUdint pass_limited; /**< deferred by OPENER_EXPLICIT_MESSAGES_PER_PASS */
+} ExplicitThrottleCounters;
+
+/** @brief
+ * Sets up a full Token Bucket
+ *
+ * @param bucket Token Bucket to be set up
+ * @param rate Tokens per second, 0 admits everything
+ * @param burst Tokens when full
+ * @param actual_time Time stamp
+ */
+void TokenBucketInitialize(TokenBucket *const bucket,
+                           const CipUdint rate,
+                           const CipUdint burst,
+                           const MilliSeconds actual_time);
+
+/** @brief
+ * Adds the tokens gained since the last refill
+ *
+ * @param bucket Token Bucket to be refilled
+ * @param actual_time Time stamp
+ * @return true when the bucket has a token
+ */
+bool TokenBucketRefill(TokenBucket *const bucket,
+                       const MilliSeconds actual_time);
+
+/** @brief
+ * Takes a token, the bucket has to be refilled before
+ *
+ * @param bucket Token Bucket to take from
+ */
+void TokenBucketTake(TokenBucket *const bucket);
+
+/** @brief
+ * Sets up the global bucket and frees the socket buckets
+ *
+ * @param actual_time Time stamp
+ */
+void ExplicitThrottleInitialize(const MilliSeconds actual_time);
+
+/** @brief
+ * Starts a pass of NetworkHandlerProcessCyclic()
+ */
+void ExplicitThrottleStartPass(void);
+
+/** @brief
+ * Decides if the next message of a TCP socket is handled now
+ *
+ * @param socket Socket handle
+ * @param actual_time Time stamp
+ * @return true when the message is handled, its tokens are taken
+ */
+bool ExplicitThrottleAdmit(const int socket,
+                           const MilliSeconds actual_time);
+
+/** @brief
+ * Frees the bucket of a closed TCP socket
+ *
+ * @param socket Socket handle
+ */
+void ExplicitThrottleRemoveSocket(const int socket);
+
+/** @brief
+ * Gets the counters since the start or the last reset
+ *
+ * @return The counters
+ */
+const ExplicitThrottleCounters *ExplicitThrottleGetCounters(void);
+
+/** @brief
+ * Clears the counters
+ */
+void ExplicitThrottleResetCounters(void);
+
+#endif /* SRC_PORTS_EXPLICIT_THROTTLE_H_ */
@@ -11,12 +11,15 @@
  *  The generic network handler delegates platform-dependent tasks to the platform network handler
  */
 
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_NETWORK_HANDLER
+
 #ifdef CLEARCORE
 #include "ports/ClearCore/socket_types.h"
 #include "lwip/udp.h"
 #include "lwip/ip_addr.h"
 #include "lwip/ip4_addr.h"
 #include "lwip/tcpip.h"
+#include "ports/ClearCore/clearcore_arppin.h"
 #endif
 #if defined(OPENER_ETHLINK_CNTRS_ENABLE) && 0 != OPENER_ETHLINK_CNTRS_ENABLE
 #ifdef CLEARCORE
@@ -46,6 +49,7 @@ void ClearCoreIncrementOutErrors(void);
 #include "ciptcpipinterface.h"
 #include "opener_user_conf.h"
 #include "cipqos.h"
+#include "explicit_throttle.h"
 
 #define MAX_NO_OF_TCP_SOCKETS 10
 
@@ -140,6 +144,8 @@ void CheckEncapsulationInactivity(int socket_handle);
 
 void RemoveSocketTimerFromList(const int socket_handle);
 
+void ManageConnectionsWhenDue(void);
+
 /*************************************************
 * Function implementations from now on
 *************************************************/
@@ -151,6 +157,7 @@ EipStatus NetworkHandlerInitialize(void) {
   }
 
   SocketTimerArrayInitialize(g_timestamps, OPENER_NUMBER_OF_SUPPORTED_SESSIONS);
+  ExplicitThrottleInitialize(GetMilliSeconds() );
   /* Activate the current DSCP values to become the used set of values. */
   CipQosUpdateUsedSetQosValues();
   /* Make sure the multicast configuration matches the current IP address. */
@@ -375,7 +382,12 @@ EipStatus NetworkHandlerInitialize(void) {
   struct sockaddr_in tcp_address = {
     .sin_family = AF_INET,
     .sin_port = htons(kOpenerEthernetPort),
+#if CLEARCORE_FAST_BOOT
+    /* The address may still change when DHCP binds after the start */
+    .sin_addr.s_addr = htonl(INADDR_ANY)
+#else
     .sin_addr.s_addr = g_network_status.ip_address
+#endif
   };
 
   /* bind the new socket to port 0xAF12 (CIP) */
@@ -456,12 +468,13 @@ EipStatus NetworkHandlerInitialize(void) {
 
 void CloseUdpSocket(int socket_handle) {
 #ifdef CLEARCORE
-  if (socket_handle != 0) {
+  /* All I/O connections share the udp_io_messaging PCB, it stays until
+   * NetworkHandlerFinish() */
+  if (socket_handle != 0 &&
+      socket_handle != (int)(intptr_t)g_network_status.udp_io_messaging) {
     struct udp_pcb *pcb = (struct udp_pcb *)socket_handle;
-    if (pcb != NULL) {
-      udp_remove(pcb);
-      OPENER_TRACE_STATE("Closing UDP PCB\n");
-    }
+    udp_remove(pcb);
+    OPENER_TRACE_STATE("Closing UDP PCB\n");
   }
 #else
   OPENER_TRACE_STATE("Closing UDP socket %d\n", socket_handle);
@@ -473,6 +486,7 @@ void CloseTcpSocket(int socket_handle) {
   OPENER_TRACE_STATE("Closing TCP socket %d\n", socket_handle);
   ShutdownSocketPlatform(socket_handle);
   RemoveSocketTimerFromList(socket_handle);
+  ExplicitThrottleRemoveSocket(socket_handle);
   CloseSocket(socket_handle);
 }
 
@@ -554,11 +568,13 @@ EipStatus NetworkHandlerProcessCyclic(void) {
   g_time_value.tv_sec = 0;
   g_time_value.tv_usec = 1000; /* 1 ms timeout - make select() more responsive */
 
-  static uint32_t cyclic_call_count = 0;
-  cyclic_call_count++;
-  if ((cyclic_call_count % 10000) == 0) {
-    OPENER_TRACE_INFO("networkhandler: cyclic call #%lu, highest_socket=%d\n",
-                      (unsigned long)cyclic_call_count, highest_socket_handle);
+  if (OPENER_TRACE_COMPILED(OPENER_TRACE_LEVEL_INFO) ) {
+    static uint32_t cyclic_call_count = 0;
+    cyclic_call_count++;
+    if ((cyclic_call_count % 10000) == 0) {
+      OPENER_TRACE_INFO("networkhandler: cyclic call #%lu, highest_socket=%d\n",
+                        (unsigned long)cyclic_call_count, highest_socket_handle);
+    }
   }
 
 #ifndef CLEARCORE
@@ -587,13 +603,28 @@ EipStatus NetworkHandlerProcessCyclic(void) {
     }
   }
 
+  /* I/O production and the connection timeouts go ahead of the explicit
+   * messages, which are limited by the explicit throttle */
+  ManageConnectionsWhenDue();
+
   if(ready_socket > 0) {
     CheckAndHandleTcpListenerSocket();
 #ifndef CLEARCORE
     CheckAndHandleConsumingUdpSocket();
 #endif
 
-    for(int socket = 0; socket <= highest_socket_handle; socket++) {
+    /* start at another socket each pass, so the messages of one socket
+     * cannot use up every pass */
+    static int first_socket = 0;
+    if(first_socket > highest_socket_handle) {
+      first_socket = 0;
+    }
+    ExplicitThrottleStartPass();
+    for(int i = 0; i <= highest_socket_handle; i++) {
+      int socket = first_socket + i;
+      if(socket > highest_socket_handle) {
+        socket -= highest_socket_handle + 1;
+      }
 #ifndef CLEARCORE
       if( socket == g_network_status.udp_unicast_listener ||
           socket == g_network_status.udp_global_broadcast_listener ) {
@@ -601,14 +632,19 @@ EipStatus NetworkHandlerProcessCyclic(void) {
       }
 #endif
       if( true == CheckSocketSet(socket) ) {
+        if( !ExplicitThrottleAdmit(socket, g_actual_time) ) {
+          continue; /* the message waits in the socket */
+        }
         if( kEipStatusError == HandleDataOnTcpSocket(socket) ) /* if error */
         {
           OPENER_TRACE_ERR("networkhandler: Error processing TCP socket %d, closing\n", socket);
           CloseTcpSocket(socket);
           RemoveSession(socket); /* clean up session and close the socket */
         }
+        ManageConnectionsWhenDue();
       }
     }
+    first_socket++;
   }
 
   for(int socket = 0; socket <= highest_socket_handle; socket++) {
@@ -618,6 +654,13 @@ EipStatus NetworkHandlerProcessCyclic(void) {
   /* Check if all connections from one originator times out */
   //CheckForTimedOutConnectionsAndCloseTCPConnections();
   //OPENER_TRACE_INFO("Socket Loop done\n");
+  ManageConnectionsWhenDue();
+  return kEipStatusOk;
+}
+
+/** @brief Advance the time and call the connection manager and the timeout
+ *  checkers every kOpenerTimerTickInMilliSeconds */
+void ManageConnectionsWhenDue(void) {
   g_actual_time = GetMilliSeconds();
   g_network_status.elapsed_time += g_actual_time - g_last_time;
   g_last_time = g_actual_time;
@@ -639,7 +682,6 @@ EipStatus NetworkHandlerProcessCyclic(void) {
 
     g_network_status.elapsed_time = 0;
   }
-  return kEipStatusOk;
 }
 
 EipStatus NetworkHandlerFinish(void) {
@@ -900,6 +942,9 @@ EipStatus SendUdpData(const struct sockaddr_in *const address,
     return kEipStatusError;
   }
   memcpy(tx_buf->payload, outgoing_message->message_buffer, outgoing_message->used_message_length);
+  if (ClearCoreArpCheckSend(address->sin_addr.s_addr)) {
+    OPENER_TRACE_INFO("networkhandler: UDP send waits for ARP\n");
+  }
   err_t err = udp_sendto(g_network_status.udp_io_messaging, tx_buf, &addr, ntohs(address->sin_port));
   pbuf_free(tx_buf);
   if (err != ERR_OK) {
@@ -935,6 +980,51 @@ EipStatus SendUdpData(const struct sockaddr_in *const address,
 #endif
 }
 
+EipStatus SendUdpDataOnSocket(const int socket,
+                              const struct sockaddr_in *const address,
+                              const ENIPMessage *const outgoing_message) {
+  if (kEipInvalidSocket == socket) {
+    return kEipStatusError;
+  }
+#ifdef CLEARCORE
+  struct udp_pcb *pcb = (struct udp_pcb *)(intptr_t)socket;
+  if (pcb == NULL) {
+    return kEipStatusError;
+  }
+  ip_addr_t addr;
+  ip4_addr_set_u32(&addr, address->sin_addr.s_addr);
+  struct pbuf *tx_buf = pbuf_alloc(PBUF_TRANSPORT, outgoing_message->used_message_length, PBUF_RAM);
+  if (tx_buf == NULL) {
+    OPENER_TRACE_ERR("networkhandler: Failed to allocate pbuf for UDP send\n");
+    return kEipStatusError;
+  }
+  memcpy(tx_buf->payload, outgoing_message->message_buffer, outgoing_message->used_message_length);
+  err_t err = udp_sendto(pcb, tx_buf, &addr, ntohs(address->sin_port));
+  pbuf_free(tx_buf);
+  if (err != ERR_OK) {
+    OPENER_TRACE_ERR("networkhandler: error with udp_sendto in SendUdpDataOnSocket: err=%d\n", err);
+    return kEipStatusError;
+  }
+  return kEipStatusOk;
+#else
+  int sent_length = sendto(socket,
+                           (char *)outgoing_message->message_buffer,
+                           outgoing_message->used_message_length, 0,
+                           (struct sockaddr *) address, sizeof(*address) );
+  if(sent_length < 0) {
+    int error_code = GetSocketErrorNumber();
+    char *error_message = GetErrorMessage(error_code);
+    OPENER_TRACE_ERR(
+      "networkhandler: error with sendto in SendUdpDataOnSocket: %d - %s\n",
+      error_code,
+      error_message);
+    FreeErrorMessage(error_message);
+    return kEipStatusError;
+  }
+  return kEipStatusOk;
+#endif
+}
+
 EipStatus HandleDataOnTcpSocket(int socket) {
   int remaining_bytes = 0;
   long data_sent = PC_OPENER_ETHERNET_BUFFER_SIZE;
@@ -1157,6 +1247,11 @@ EipStatus HandleDataOnTcpSocket(int socket) {
 int CreateUdpSocket(void) {
 
 #ifdef CLEARCORE
+  /* The PCB bound to port 2222 serves all I/O connections */
+  if (g_network_status.udp_io_messaging != NULL) {
+    return (int)(intptr_t)g_network_status.udp_io_messaging;
+  }
+
   g_network_status.udp_io_messaging = udp_new();
   if (g_network_status.udp_io_messaging == NULL) {
     OPENER_TRACE_ERR("networkhandler: cannot create UDP IO messaging PCB\n");
@@ -1265,6 +1360,15 @@ int SetQos(CipUsint qos_for_socket) {
  * @return 0 if successful, else the error code */
 int SetSocketOptionsMulticastProduce(void) {
 #ifdef CLEARCORE
+  if (g_network_status.udp_io_messaging == NULL) {
+    return ERR_CONN;
+  }
+  /* udp_new() starts with the unicast TTL */
+  udp_set_multicast_ttl(g_network_status.udp_io_messaging,
+                        g_tcpip.mcast_ttl_value);
+  ip4_addr_t my_addr;
+  ip4_addr_set_u32(&my_addr, g_network_status.ip_address);
+  udp_set_multicast_netif_addr(g_network_status.udp_io_messaging, &my_addr);
   return 0;
 #else
   if (g_tcpip.mcast_ttl_value != 1) {
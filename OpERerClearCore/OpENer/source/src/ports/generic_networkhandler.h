@@ -126,4 +126,16 @@ int SetSocketOptionsMulticastProduce(void);
  * @return peer address if successful, else any address (0) */
 EipUint32 GetPeerAddress(void);
 
+/** @brief Send an encapsulation message from the UDP socket a request came
+ *  in on, e.g. a delayed List Identity response
+ *
+ * @param socket The socket (the PCB on the ClearCore) of the request
+ * @param address The originator of the request
+ * @param outgoing_message The message to send
+ * @return kEipStatusOk on success
+ */
+EipStatus SendUdpDataOnSocket(const int socket,
+                              const struct sockaddr_in *const address,
+                              const ENIPMessage *const outgoing_message);
+
 #endif /* GENERIC_NETWORKHANDLER_H_ */
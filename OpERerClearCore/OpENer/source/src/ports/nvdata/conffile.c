@@ -15,6 +15,8 @@
 #define ENABLE_VERBOSE  0   /* Enable this to observe internal operation */
 
 /*   INCLUDES          */
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include "conffile.h"
 
 #include <errno.h>
@@ -12,6 +12,8 @@
  * Also this module provides callback functions to store NV data of known
  *  objects when called by the EIP stack.
  */
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include "nvdata.h"
 
 #include "trace.h"
@@ -22,6 +24,9 @@
 
 #ifdef CLEARCORE
 #include "ciptcpipinterface.h"
+#include "ports/ClearCore/clearcore_nvstore.h"
+
+NvStore g_nvstore;
 #endif
 
 /** @brief Load NV data for all object classes
@@ -38,6 +43,13 @@
  *  and return (-1) on failure and (0) on success.
  */
 EipStatus NvdataLoad(void) {
+#ifdef CLEARCORE
+  const NvStoreFlash *flash = ClearCoreNvStoreFlash();
+  if (NULL == flash || kEipStatusOk != NvStoreMount(&g_nvstore, flash) ) {
+    OPENER_TRACE_ERR("NvdataLoad: NV store not available\n");
+  }
+#endif
+
   /* Load NV data for QoS object instance */
   EipStatus eip_status = NvQosLoad(&g_qos);
   if (kEipStatusError != eip_status) {
@@ -56,6 +68,35 @@ EipStatus NvdataLoad(void) {
   return eip_status;
 }
 
+#ifdef CLEARCORE
+/** @brief Let the NV store write the settings that stopped changing
+ *
+ *  @param elapsed_ms milliseconds since the previous call
+ */
+void NvdataProcess(MilliSeconds elapsed_ms) {
+  NvStoreProcess(&g_nvstore, elapsed_ms);
+}
+
+/** @brief Write all pending NV data now, before a reset
+ *
+ *  @return kEipStatusOk on success, kEipStatusError if a value was not written
+ */
+EipStatus NvdataFlush(void) {
+  if (!NvStoreHasStaged(&g_nvstore) ) {
+    return kEipStatusOk;
+  }
+  return NvStoreFlush(&g_nvstore);
+}
+
+/** @brief Erase all NV data, the objects start with defaults after a reset
+ *
+ *  @return kEipStatusOk on success, kEipStatusError on a flash failure
+ */
+EipStatus NvdataClear(void) {
+  return NvStoreFormat(&g_nvstore);
+}
+#endif
+
 /** A PostSetCallback for QoS class to store NV attributes
  *
  * @param  instance  pointer to instance of QoS class
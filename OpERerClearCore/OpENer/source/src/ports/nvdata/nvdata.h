@@ -15,6 +15,19 @@
 #include "typedefs.h"
 #include "ciptypes.h"
 
+#ifdef CLEARCORE
+#include "nvstore.h"
+
+/** Store holding the NV data of all objects */
+extern NvStore g_nvstore;
+
+void NvdataProcess(MilliSeconds elapsed_ms);
+
+EipStatus NvdataFlush(void);
+
+EipStatus NvdataClear(void);
+#endif
+
 EipStatus NvdataLoad(void);
 
 EipStatus NvQosSetCallback
@@ -7,6 +7,9 @@
 /** @file nvqos.c
  *  @brief This file implements the functions to handle QoS object's NV data.
  *
+ *  On the ClearCore the values are kept in the NV store, elsewhere in a
+ *  text file.
+ *
  *  This is only proof-of-concept code. Don't use it in a real product.
  *  Please think about atomic update of the external file or better parsing
  *  of the data on input.
@@ -21,8 +24,19 @@
 #include "conffile.h"
 #include "ciptypes.h"
 
+#ifdef CLEARCORE
+#include "nvdata.h"
+#endif
+
 #define QOS_CFG_NAME  "qos.cfg"
 
+#ifdef CLEARCORE
+/** Stored DSCP values, in the order of the QoS attributes 4 to 8 */
+typedef struct {
+  CipUsint dscp[5];
+} QosNvData;
+#endif
+
 
 /** @brief Load NV data of the QoS object from file
  *
@@ -30,6 +44,21 @@
  *  @return kEipStatusOk: success; kEipStatusError: failure
  */
 EipStatus NvQosLoad(CipQosObject *p_qos) {
+#ifdef CLEARCORE
+  QosNvData nv_data;
+  size_t length = 0;
+  if (kEipStatusOk != NvStoreGet(&g_nvstore, kNvStoreKeyQos, &nv_data,
+                                 sizeof(nv_data), &length) ||
+      sizeof(nv_data) != length) {
+    return kEipStatusError;
+  }
+  p_qos->dscp.urgent = nv_data.dscp[0];
+  p_qos->dscp.scheduled = nv_data.dscp[1];
+  p_qos->dscp.high = nv_data.dscp[2];
+  p_qos->dscp.low = nv_data.dscp[3];
+  p_qos->dscp.explicit_msg = nv_data.dscp[4];
+  return kEipStatusOk;
+#else
   int rd_cnt = 0;
   EipStatus eip_status = kEipStatusError;
 
@@ -97,6 +126,7 @@ EipStatus NvQosLoad(CipQosObject *p_qos) {
     }
   }
   return eip_status;
+#endif
 }
 
 /** @brief Store NV data of the QoS object to file
@@ -105,6 +135,15 @@ EipStatus NvQosLoad(CipQosObject *p_qos) {
  *  @return kEipStatusOk: success; kEipStatusError: failure
  */
 EipStatus NvQosStore(const CipQosObject *p_qos) {
+#ifdef CLEARCORE
+  QosNvData nv_data;
+  nv_data.dscp[0] = p_qos->dscp.urgent;
+  nv_data.dscp[1] = p_qos->dscp.scheduled;
+  nv_data.dscp[2] = p_qos->dscp.high;
+  nv_data.dscp[3] = p_qos->dscp.low;
+  nv_data.dscp[4] = p_qos->dscp.explicit_msg;
+  return NvStoreSet(&g_nvstore, kNvStoreKeyQos, &nv_data, sizeof(nv_data) );
+#else
   FILE  *p_file = ConfFileOpen(true, QOS_CFG_NAME);
   EipStatus eip_status = kEipStatusOk;
   if (NULL != p_file) {
@@ -126,4 +165,5 @@ EipStatus NvQosStore(const CipQosObject *p_qos) {
         ConfFileClose(&p_file) ) ? kEipStatusError : eip_status;
   }
   return eip_status;
+#endif
 }
@@ -0,0 +1,662 @@
+/*******************************************************************************
+ * Log-structured key/value store for NV data
+ *
+ ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
+#include "nvstore.h"
+
+#include <string.h>
+
+#include "trace.h"
+
+/** @brief First word of a sector header, "NVS1" */
+#define NV_STORE_SECTOR_MAGIC 0x3153564EU
+
+/** @brief Header unit at the start of every sector in use */
+typedef struct {
+  uint32_t magic;
+  uint32_t sequence; /**< one more than the sector used before */
+  uint32_t reserved; /**< left erased */
+  uint32_t crc; /**< CRC of the words above */
+} NvStoreSectorHeader;
+
+/** @brief Header unit of a record, programmed after its data */
+typedef struct {
+  uint16_t key;
+  uint16_t length; /**< data length in bytes */
+  uint32_t data_crc; /**< CRC of the data */
+  uint32_t sequence; /**< sequence of the sector the record is in */
+  uint32_t crc; /**< CRC of the fields above and the record offset */
+} NvStoreRecordHeader;
+
+static const uint32_t kCrc32Table[256] = {
+  0x00000000U, 0x77073096U, 0xEE0E612CU, 0x990951BAU,
+  0x076DC419U, 0x706AF48FU, 0xE963A535U, 0x9E6495A3U,
+  0x0EDB8832U, 0x79DCB8A4U, 0xE0D5E91EU, 0x97D2D988U,
+  0x09B64C2BU, 0x7EB17CBDU, 0xE7B82D07U, 0x90BF1D91U,
+  0x1DB71064U, 0x6AB020F2U, 0xF3B97148U, 0x84BE41DEU,
+  0x1ADAD47DU, 0x6DDDE4EBU, 0xF4D4B551U, 0x83D385C7U,
+  0x136C9856U, 0x646BA8C0U, 0xFD62F97AU, 0x8A65C9ECU,
+  0x14015C4FU, 0x63066CD9U, 0xFA0F3D63U, 0x8D080DF5U,
+  0x3B6E20C8U, 0x4C69105EU, 0xD56041E4U, 0xA2677172U,
+  0x3C03E4D1U, 0x4B04D447U, 0xD20D85FDU, 0xA50AB56BU,
+  0x35B5A8FAU, 0x42B2986CU, 0xDBBBC9D6U, 0xACBCF940U,
+  0x32D86CE3U, 0x45DF5C75U, 0xDCD60DCFU, 0xABD13D59U,
+  0x26D930ACU, 0x51DE003AU, 0xC8D75180U, 0xBFD06116U,
+  0x21B4F4B5U, 0x56B3C423U, 0xCFBA9599U, 0xB8BDA50FU,
+  0x2802B89EU, 0x5F058808U, 0xC60CD9B2U, 0xB10BE924U,
+  0x2F6F7C87U, 0x58684C11U, 0xC1611DABU, 0xB6662D3DU,
+  0x76DC4190U, 0x01DB7106U, 0x98D220BCU, 0xEFD5102AU,
+  0x71B18589U, 0x06B6B51FU, 0x9FBFE4A5U, 0xE8B8D433U,
+  0x7807C9A2U, 0x0F00F934U, 0x9609A88EU, 0xE10E9818U,
+  0x7F6A0DBBU, 0x086D3D2DU, 0x91646C97U, 0xE6635C01U,
+  0x6B6B51F4U, 0x1C6C6162U, 0x856530D8U, 0xF262004EU,
+  0x6C0695EDU, 0x1B01A57BU, 0x8208F4C1U, 0xF50FC457U,
+  0x65B0D9C6U, 0x12B7E950U, 0x8BBEB8EAU, 0xFCB9887CU,
+  0x62DD1DDFU, 0x15DA2D49U, 0x8CD37CF3U, 0xFBD44C65U,
+  0x4DB26158U, 0x3AB551CEU, 0xA3BC0074U, 0xD4BB30E2U,
+  0x4ADFA541U, 0x3DD895D7U, 0xA4D1C46DU, 0xD3D6F4FBU,
+  0x4369E96AU, 0x346ED9FCU, 0xAD678846U, 0xDA60B8D0U,
+  0x44042D73U, 0x33031DE5U, 0xAA0A4C5FU, 0xDD0D7CC9U,
+  0x5005713CU, 0x270241AAU, 0xBE0B1010U, 0xC90C2086U,
+  0x5768B525U, 0x206F85B3U, 0xB966D409U, 0xCE61E49FU,
+  0x5EDEF90EU, 0x29D9C998U, 0xB0D09822U, 0xC7D7A8B4U,
+  0x59B33D17U, 0x2EB40D81U, 0xB7BD5C3BU, 0xC0BA6CADU,
+  0xEDB88320U, 0x9ABFB3B6U, 0x03B6E20CU, 0x74B1D29AU,
+  0xEAD54739U, 0x9DD277AFU, 0x04DB2615U, 0x73DC1683U,
+  0xE3630B12U, 0x94643B84U, 0x0D6D6A3EU, 0x7A6A5AA8U,
+  0xE40ECF0BU, 0x9309FF9DU, 0x0A00AE27U, 0x7D079EB1U,
+  0xF00F9344U, 0x8708A3D2U, 0x1E01F268U, 0x6906C2FEU,
+  0xF762575DU, 0x806567CBU, 0x196C3671U, 0x6E6B06E7U,
+  0xFED41B76U, 0x89D32BE0U, 0x10DA7A5AU, 0x67DD4ACCU,
+  0xF9B9DF6FU, 0x8EBEEFF9U, 0x17B7BE43U, 0x60B08ED5U,
+  0xD6D6A3E8U, 0xA1D1937EU, 0x38D8C2C4U, 0x4FDFF252U,
+  0xD1BB67F1U, 0xA6BC5767U, 0x3FB506DDU, 0x48B2364BU,
+  0xD80D2BDAU, 0xAF0A1B4CU, 0x36034AF6U, 0x41047A60U,
+  0xDF60EFC3U, 0xA867DF55U, 0x316E8EEFU, 0x4669BE79U,
+  0xCB61B38CU, 0xBC66831AU, 0x256FD2A0U, 0x5268E236U,
+  0xCC0C7795U, 0xBB0B4703U, 0x220216B9U, 0x5505262FU,
+  0xC5BA3BBEU, 0xB2BD0B28U, 0x2BB45A92U, 0x5CB36A04U,
+  0xC2D7FFA7U, 0xB5D0CF31U, 0x2CD99E8BU, 0x5BDEAE1DU,
+  0x9B64C2B0U, 0xEC63F226U, 0x756AA39CU, 0x026D930AU,
+  0x9C0906A9U, 0xEB0E363FU, 0x72076785U, 0x05005713U,
+  0x95BF4A82U, 0xE2B87A14U, 0x7BB12BAEU, 0x0CB61B38U,
+  0x92D28E9BU, 0xE5D5BE0DU, 0x7CDCEFB7U, 0x0BDBDF21U,
+  0x86D3D2D4U, 0xF1D4E242U, 0x68DDB3F8U, 0x1FDA836EU,
+  0x81BE16CDU, 0xF6B9265BU, 0x6FB077E1U, 0x18B74777U,
+  0x88085AE6U, 0xFF0F6A70U, 0x66063BCAU, 0x11010B5CU,
+  0x8F659EFFU, 0xF862AE69U, 0x616BFFD3U, 0x166CCF45U,
+  0xA00AE278U, 0xD70DD2EEU, 0x4E048354U, 0x3903B3C2U,
+  0xA7672661U, 0xD06016F7U, 0x4969474DU, 0x3E6E77DBU,
+  0xAED16A4AU, 0xD9D65ADCU, 0x40DF0B66U, 0x37D83BF0U,
+  0xA9BCAE53U, 0xDEBB9EC5U, 0x47B2CF7FU, 0x30B5FFE9U,
+  0xBDBDF21CU, 0xCABAC28AU, 0x53B39330U, 0x24B4A3A6U,
+  0xBAD03605U, 0xCDD70693U, 0x54DE5729U, 0x23D967BFU,
+  0xB3667A2EU, 0xC4614AB8U, 0x5D681B02U, 0x2A6F2B94U,
+  0xB40BBE37U, 0xC30C8EA1U, 0x5A05DF1BU, 0x2D02EF8DU
+};
+
+/** @brief Copy of a value moved or compared by the store */
+static uint8_t nv_store_buffer[kNvStoreMaxValueLength];
+
+static uint32_t Crc32Update(uint32_t crc,
+                            const void *data,
+                            size_t length) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  while(length-- > 0) {
+    crc = kCrc32Table[(crc ^ *bytes++) & 0xFFU] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+uint32_t NvStoreCrc32(const void *data,
+                      size_t length) {
+  return ~Crc32Update(0xFFFFFFFFU, data, length);
+}
+
+static uint32_t SectorHeaderCrc(const NvStoreSectorHeader *header) {
+  return NvStoreCrc32(header, offsetof(NvStoreSectorHeader, crc) );
+}
+
+static uint32_t RecordHeaderCrc(const NvStoreRecordHeader *header,
+                                size_t offset) {
+  uint32_t offset_word = (uint32_t)offset;
+  uint32_t crc = Crc32Update(0xFFFFFFFFU, header,
+                             offsetof(NvStoreRecordHeader, crc) );
+  return ~Crc32Update(crc, &offset_word, sizeof(offset_word) );
+}
+
+static size_t RecordSize(size_t length) {
+  return kNvStoreUnit + ( (length + kNvStoreUnit - 1) & ~(kNvStoreUnit - 1) );
+}
+
+/** @brief Room the live records may take, one record is kept free for a
+ *  record torn by a power loss during a sector move */
+static size_t LiveCapacity(const NvStore *store) {
+  return store->flash->sector_size - kNvStoreUnit -
+         RecordSize(kNvStoreMaxValueLength);
+}
+
+static size_t SectorStart(const NvStore *store,
+                          size_t sector) {
+  return sector * store->flash->sector_size;
+}
+
+static size_t NextSector(const NvStore *store,
+                         size_t sector) {
+  return (sector + 1) % store->flash->sector_count;
+}
+
+static bool IsErased(const uint8_t *data,
+                     size_t length) {
+  for(size_t i = 0; i < length; i++) {
+    if(0xFF != data[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool ReadSectorHeader(const NvStore *store,
+                             size_t sector,
+                             uint32_t *sequence) {
+  NvStoreSectorHeader header;
+  if(0 != store->flash->read_data(store->flash->context,
+                                  SectorStart(store, sector), &header,
+                                  sizeof(header) ) ) {
+    return false;
+  }
+  if(NV_STORE_SECTOR_MAGIC != header.magic ||
+      SectorHeaderCrc(&header) != header.crc) {
+    return false;
+  }
+  *sequence = header.sequence;
+  return true;
+}
+
+/** @brief Offset after the last unit of the sector that is not erased */
+static size_t ProgrammedEnd(const NvStore *store,
+                            size_t sector) {
+  size_t start = SectorStart(store, sector);
+  size_t end = start + store->flash->sector_size;
+  uint8_t unit[kNvStoreUnit];
+  while(end > start) {
+    if(0 != store->flash->read_data(store->flash->context, end - kNvStoreUnit,
+                                    unit, kNvStoreUnit) ||
+        !IsErased(unit, kNvStoreUnit) ) {
+      break;
+    }
+    end -= kNvStoreUnit;
+  }
+  return end;
+}
+
+static EipStatus EraseSector(NvStore *store,
+                             size_t sector) {
+  if(0 != store->flash->erase_sector(store->flash->context,
+                                     SectorStart(store, sector) ) ) {
+    OPENER_TRACE_ERR("NvStore: erasing sector %u failed\n",
+                     (unsigned)sector);
+    return kEipStatusError;
+  }
+  store->erase_count++;
+  return kEipStatusOk;
+}
+
+/** @brief Read a record header and check it belongs at offset */
+static bool ReadRecordHeader(const NvStore *store,
+                             size_t offset,
+                             uint32_t sequence,
+                             NvStoreRecordHeader *header) {
+  if(0 != store->flash->read_data(store->flash->context, offset, header,
+                                  sizeof(*header) ) ) {
+    return false;
+  }
+  return header->sequence == sequence &&
+         header->length <= kNvStoreMaxValueLength &&
+         RecordHeaderCrc(header, offset) == header->crc;
+}
+
+/** @brief Read the data of a checked record header into nv_store_buffer */
+static bool ReadRecordData(const NvStore *store,
+                           size_t offset,
+                           const NvStoreRecordHeader *header) {
+  if(0 != store->flash->read_data(store->flash->context, offset + kNvStoreUnit,
+                                  nv_store_buffer, header->length) ) {
+    return false;
+  }
+  return NvStoreCrc32(nv_store_buffer, header->length) == header->data_crc;
+}
+
+static NvStoreEntry *FindEntry(NvStore *store,
+                               uint16_t key) {
+  for(size_t i = 0; i < store->entry_count; i++) {
+    if(store->entries[i].key == key) {
+      return &store->entries[i];
+    }
+  }
+  return NULL;
+}
+
+static void PutEntry(NvStore *store,
+                     uint16_t key,
+                     uint16_t length,
+                     size_t offset) {
+  NvStoreEntry *entry = FindEntry(store, key);
+  if(NULL == entry) {
+    if(store->entry_count >= kNvStoreMaxKeys) {
+      OPENER_TRACE_ERR("NvStore: no room for key 0x%04X\n", key);
+      return;
+    }
+    entry = &store->entries[store->entry_count++];
+    entry->key = key;
+  }
+  entry->length = length;
+  entry->offset = offset;
+}
+
+static void RemoveEntry(NvStore *store,
+                        NvStoreEntry *entry) {
+  *entry = store->entries[--store->entry_count];
+}
+
+/** @brief Index the valid records of a sector, later records win */
+static void ReplaySector(NvStore *store,
+                         size_t sector,
+                         uint32_t sequence) {
+  size_t start = SectorStart(store, sector);
+  size_t end = ProgrammedEnd(store, sector);
+  size_t offset = start + kNvStoreUnit;
+  while(offset + kNvStoreUnit <= end) {
+    NvStoreRecordHeader header;
+    if(ReadRecordHeader(store, offset, sequence, &header) &&
+        offset + RecordSize(header.length) <= end &&
+        ReadRecordData(store, offset, &header) ) {
+      PutEntry(store, header.key, header.length, offset);
+      offset += RecordSize(header.length);
+    } else {
+      /* Torn or erased unit, the next record may follow any unit */
+      offset += kNvStoreUnit;
+    }
+  }
+}
+
+/** @brief Program a record at the write offset of the active sector */
+static EipStatus WriteRecord(NvStore *store,
+                             uint16_t key,
+                             const uint8_t *data,
+                             size_t length) {
+  size_t offset = store->write_offset;
+  size_t size = RecordSize(length);
+  size_t whole = length & ~(kNvStoreUnit - 1);
+  const NvStoreFlash *flash = store->flash;
+
+  if(offset + size >
+      SectorStart(store, store->active) + flash->sector_size) {
+    return kEipStatusError;
+  }
+
+  /* Any unit touched is used up, even when programming it fails */
+  store->write_offset += size;
+
+  if(whole > 0 &&
+      0 != flash->program_data(flash->context, offset + kNvStoreUnit, data,
+                               whole) ) {
+    return kEipStatusError;
+  }
+  if(length > whole) {
+    uint8_t tail[kNvStoreUnit];
+    memset(tail, 0xFF, sizeof(tail) );
+    memcpy(tail, data + whole, length - whole);
+    if(0 != flash->program_data(flash->context, offset + kNvStoreUnit + whole,
+                                tail, sizeof(tail) ) ) {
+      return kEipStatusError;
+    }
+  }
+
+  NvStoreRecordHeader header;
+  header.key = key;
+  header.length = (uint16_t)length;
+  header.data_crc = NvStoreCrc32(data, length);
+  header.sequence = store->sequence;
+  header.crc = RecordHeaderCrc(&header, offset);
+  if(0 != flash->program_data(flash->context, offset, &header, sizeof(header) ) ) {
+    return kEipStatusError;
+  }
+
+  PutEntry(store, key, (uint16_t)length, offset);
+  return kEipStatusOk;
+}
+
+/** @brief Move the live records of a sector to the active one and erase it */
+static EipStatus ReclaimSector(NvStore *store,
+                               size_t sector) {
+  uint32_t sequence = 0;
+  if(!ReadSectorHeader(store, sector, &sequence) ) {
+    return kEipStatusOk;
+  }
+
+  size_t start = SectorStart(store, sector);
+  size_t end = start + store->flash->sector_size;
+  for(size_t i = 0; i < store->entry_count; i++) {
+    NvStoreEntry *entry = &store->entries[i];
+    if(entry->offset < start || entry->offset >= end) {
+      continue;
+    }
+    NvStoreRecordHeader header;
+    if(!ReadRecordHeader(store, entry->offset, sequence, &header) ||
+        !ReadRecordData(store, entry->offset, &header) ) {
+      OPENER_TRACE_ERR("NvStore: lost damaged key 0x%04X\n", entry->key);
+      RemoveEntry(store, entry);
+      i--;
+      continue;
+    }
+    if(kEipStatusOk !=
+        WriteRecord(store, header.key, nv_store_buffer, header.length) ) {
+      OPENER_TRACE_ERR("NvStore: moving key 0x%04X failed\n", header.key);
+      return kEipStatusError;
+    }
+  }
+  return EraseSector(store, sector);
+}
+
+/** @brief Start a new sector at sequence */
+static EipStatus StartSector(NvStore *store,
+                             size_t sector,
+                             uint32_t sequence) {
+  uint8_t unit[kNvStoreUnit];
+  size_t start = SectorStart(store, sector);
+
+  if(0 != store->flash->read_data(store->flash->context, start, unit,
+                                  sizeof(unit) ) ||
+      !IsErased(unit, sizeof(unit) ) ||
+      ProgrammedEnd(store, sector) != start) {
+    if(kEipStatusOk != EraseSector(store, sector) ) {
+      return kEipStatusError;
+    }
+  }
+
+  NvStoreSectorHeader header;
+  header.magic = NV_STORE_SECTOR_MAGIC;
+  header.sequence = sequence;
+  header.reserved = 0xFFFFFFFFU;
+  header.crc = SectorHeaderCrc(&header);
+  if(0 != store->flash->program_data(store->flash->context, start, &header,
+                                     sizeof(header) ) ) {
+    OPENER_TRACE_ERR("NvStore: starting sector %u failed\n",
+                     (unsigned)sector);
+    return kEipStatusError;
+  }
+  store->active = sector;
+  store->sequence = sequence;
+  store->write_offset = start + kNvStoreUnit;
+  return kEipStatusOk;
+}
+
+/** @brief Continue the log in the next sector, keeping one sector erased */
+static EipStatus RotateSector(NvStore *store) {
+  if(kEipStatusOk !=
+      StartSector(store, NextSector(store, store->active),
+                  store->sequence + 1) ) {
+    return kEipStatusError;
+  }
+  return ReclaimSector(store, NextSector(store, store->active) );
+}
+
+static EipStatus AppendRecord(NvStore *store,
+                              uint16_t key,
+                              const uint8_t *data,
+                              size_t length) {
+  size_t sector_end = 0;
+  for(size_t tries = 0;; tries++) {
+    sector_end = SectorStart(store, store->active) + store->flash->sector_size;
+    if(store->write_offset + RecordSize(length) <= sector_end) {
+      break;
+    }
+    if(tries >= store->flash->sector_count ||
+        kEipStatusOk != RotateSector(store) ) {
+      return kEipStatusError;
+    }
+  }
+  return WriteRecord(store, key, data, length);
+}
+
+/** @brief Tell whether the stored value of key equals data */
+static bool StoredEquals(NvStore *store,
+                         uint16_t key,
+                         const uint8_t *data,
+                         size_t length) {
+  NvStoreEntry *entry = FindEntry(store, key);
+  NvStoreRecordHeader header;
+  return NULL != entry && entry->length == length &&
+         0 == store->flash->read_data(store->flash->context, entry->offset,
+                                 &header, sizeof(header) ) &&
+         header.data_crc == NvStoreCrc32(data, length) &&
+         0 == store->flash->read_data(store->flash->context,
+                                 entry->offset + kNvStoreUnit,
+                                 nv_store_buffer, length) &&
+         0 == memcmp(nv_store_buffer, data, length);
+}
+
+/** @brief Tell whether the live records still fit a sector with the new value */
+static bool FitsLiveCapacity(NvStore *store,
+                             uint16_t key,
+                             size_t length) {
+  size_t live = RecordSize(length);
+  for(size_t i = 0; i < store->entry_count; i++) {
+    if(store->entries[i].key != key) {
+      live += RecordSize(store->entries[i].length);
+    }
+  }
+  return live <= LiveCapacity(store);
+}
+
+EipStatus NvStoreMount(NvStore *store,
+                       const NvStoreFlash *flash) {
+  memset(store, 0, sizeof(*store) );
+  if(NULL == flash || flash->sector_count < 2 ||
+      0 != flash->sector_size % kNvStoreUnit ||
+      flash->sector_size < 2 * kNvStoreUnit +
+      2 * RecordSize(kNvStoreMaxValueLength) ) {
+    OPENER_TRACE_ERR("NvStore: unusable flash geometry\n");
+    return kEipStatusError;
+  }
+  store->flash = flash;
+
+  /* Replay the sectors oldest first */
+  bool found = false;
+  uint32_t last = 0;
+  for(;; ) {
+    size_t oldest = 0;
+    uint32_t oldest_sequence = 0;
+    bool more = false;
+    for(size_t sector = 0; sector < flash->sector_count; sector++) {
+      uint32_t sequence = 0;
+      if(ReadSectorHeader(store, sector, &sequence) &&
+          (!found || sequence > last) &&
+          (!more || sequence < oldest_sequence) ) {
+        oldest = sector;
+        oldest_sequence = sequence;
+        more = true;
+      }
+    }
+    if(!more) {
+      break;
+    }
+    ReplaySector(store, oldest, oldest_sequence);
+    store->active = oldest;
+    store->sequence = oldest_sequence;
+    last = oldest_sequence;
+    found = true;
+  }
+
+  if(!found) {
+    OPENER_TRACE_INFO("NvStore: no store found, formatting\n");
+    return NvStoreFormat(store);
+  }
+  store->write_offset = ProgrammedEnd(store, store->active);
+  if(store->write_offset == SectorStart(store, store->active) ) {
+    store->write_offset += kNvStoreUnit;
+  }
+
+  /* A sector after the active one still in use is left by a move that a
+   * power loss interrupted */
+  uint32_t sequence = 0;
+  if(ReadSectorHeader(store, NextSector(store, store->active), &sequence) ) {
+    OPENER_TRACE_INFO("NvStore: finishing interrupted sector move\n");
+    if(kEipStatusOk !=
+        ReclaimSector(store, NextSector(store, store->active) ) ) {
+      return kEipStatusError;
+    }
+  }
+  OPENER_TRACE_INFO("NvStore: mounted, sector %u, %u keys\n",
+                    (unsigned)store->active, (unsigned)store->entry_count);
+  return kEipStatusOk;
+}
+
+EipStatus NvStoreFormat(NvStore *store) {
+  if(NULL == store->flash) {
+    return kEipStatusError;
+  }
+  uint32_t sequence = store->sequence + 1;
+  store->entry_count = 0;
+  store->staged_count = 0;
+  for(size_t sector = 0; sector < store->flash->sector_count; sector++) {
+    if(ProgrammedEnd(store, sector) != SectorStart(store, sector) &&
+        kEipStatusOk != EraseSector(store, sector) ) {
+      return kEipStatusError;
+    }
+  }
+  return StartSector(store, 0, sequence);
+}
+
+EipStatus NvStoreGet(NvStore *store,
+                     uint16_t key,
+                     void *data,
+                     size_t size,
+                     size_t *length) {
+  for(size_t i = 0; i < store->staged_count; i++) {
+    NvStoreStaged *staged = &store->staged[i];
+    if(staged->key == key) {
+      if(staged->length > size) {
+        return kEipStatusError;
+      }
+      memcpy(data, staged->data, staged->length);
+      if(NULL != length) {
+        *length = staged->length;
+      }
+      return kEipStatusOk;
+    }
+  }
+
+  if(NULL == store->flash) {
+    return kEipStatusError;
+  }
+  NvStoreEntry *entry = FindEntry(store, key);
+  if(NULL == entry || entry->length > size) {
+    return kEipStatusError;
+  }
+  NvStoreRecordHeader header;
+  size_t sector = entry->offset / store->flash->sector_size;
+  uint32_t sequence = 0;
+  if(!ReadSectorHeader(store, sector, &sequence) ||
+      !ReadRecordHeader(store, entry->offset, sequence, &header) ||
+      !ReadRecordData(store, entry->offset, &header) ) {
+    OPENER_TRACE_ERR("NvStore: key 0x%04X damaged\n", key);
+    return kEipStatusError;
+  }
+  memcpy(data, nv_store_buffer, header.length);
+  if(NULL != length) {
+    *length = header.length;
+  }
+  return kEipStatusOk;
+}
+
+EipStatus NvStoreSet(NvStore *store,
+                     uint16_t key,
+                     const void *data,
+                     size_t length) {
+  if(NULL == store->flash || length > kNvStoreMaxValueLength) {
+    return kEipStatusError;
+  }
+
+  NvStoreStaged *staged = NULL;
+  for(size_t i = 0; i < store->staged_count; i++) {
+    if(store->staged[i].key == key) {
+      staged = &store->staged[i];
+    }
+  }
+  if(NULL == staged) {
+    if(store->staged_count >= kNvStoreStagedSlots &&
+        kEipStatusOk != NvStoreFlush(store) ) {
+      return kEipStatusError;
+    }
+    if(0 == store->staged_count) {
+      store->delay_ms = 0;
+    }
+    staged = &store->staged[store->staged_count++];
+    staged->key = key;
+  }
+  staged->length = (uint16_t)length;
+  memcpy(staged->data, data, length);
+  store->quiet_ms = 0;
+  return kEipStatusOk;
+}
+
+EipStatus NvStoreFlush(NvStore *store) {
+  if(NULL == store->flash) {
+    return kEipStatusError;
+  }
+
+  EipStatus status = kEipStatusOk;
+  bool written = false;
+  size_t kept = 0;
+  for(size_t i = 0; i < store->staged_count; i++) {
+    NvStoreStaged *staged = &store->staged[i];
+    if(StoredEquals(store, staged->key, staged->data, staged->length) ) {
+      continue;
+    }
+    if(!FitsLiveCapacity(store, staged->key, staged->length) ) {
+      OPENER_TRACE_ERR("NvStore: store full, key 0x%04X dropped\n",
+                       staged->key);
+      status = kEipStatusError;
+      continue;
+    }
+    if(kEipStatusOk ==
+        AppendRecord(store, staged->key, staged->data, staged->length) ) {
+      written = true;
+      continue;
+    }
+    OPENER_TRACE_ERR("NvStore: writing key 0x%04X failed\n", staged->key);
+    status = kEipStatusError;
+    if(kept != i) {
+      store->staged[kept] = *staged;
+    }
+    kept++;
+  }
+  store->staged_count = kept;
+  store->quiet_ms = 0;
+  store->delay_ms = 0;
+  if(written) {
+    store->flush_count++;
+  }
+  return status;
+}
+
+void NvStoreProcess(NvStore *store,
+                    uint32_t elapsed_ms) {
+  if(0 == store->staged_count) {
+    return;
+  }
+  store->quiet_ms += elapsed_ms;
+  store->delay_ms += elapsed_ms;
+  if(store->quiet_ms >= kNvStoreQuietMs ||
+      store->delay_ms >= kNvStoreMaxDelayMs) {
+    (void)NvStoreFlush(store);
+  }
+}
+
+bool NvStoreHasStaged(const NvStore *store) {
+  return store->staged_count > 0;
+}
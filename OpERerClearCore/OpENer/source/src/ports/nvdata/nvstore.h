@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * Log-structured key/value store for NV data
+ *
+ ******************************************************************************/
+#ifndef SRC_PORTS_NVDATA_NVSTORE_H_
+#define SRC_PORTS_NVDATA_NVSTORE_H_
+
+/** @file nvstore.h
+ *  @brief Power-fail safe key/value store on raw flash
+ *
+ *  The store keeps values of up to kNvStoreMaxValueLength bytes under 16-bit
+ *  keys. It never overwrites data in place: every value is appended to a log
+ *  that spans all erase sectors of the flash, so the previous value stays
+ *  valid until the new record is completely programmed.
+ *
+ *  Each sector starts with a header unit holding a sequence number; the
+ *  sector with the highest number takes the appends. A record is a header
+ *  unit (key, length, CRC of the data, sector sequence and a CRC over all of
+ *  it including its own offset) followed by the data padded to full units.
+ *  The data is programmed first and the header last, a record whose header
+ *  does not check is ignored. All CRCs are the table-driven CRC-32 of
+ *  NvStoreCrc32().
+ *
+ *  When the active sector is full the next sector in the ring is erased and
+ *  becomes active, and the live records of the sector after it, the oldest
+ *  one, are copied forward before that sector is erased. There is always one
+ *  erased sector, and the sectors are erased round robin so that they wear
+ *  evenly. NvStoreMount() finishes a move interrupted by a power loss.
+ *
+ *  NvStoreSet() only stages the value in RAM. NvStoreProcess() writes the
+ *  staged values once no value was set for kNvStoreQuietMs, or at the
+ *  latest kNvStoreMaxDelayMs after the first one, so a burst of attribute
+ *  sets ends up as one flush. A staged value that equals the stored one is
+ *  not written at all.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typedefs.h"
+
+/** @brief Program unit of the flash in bytes, the SAME53 quad word */
+#define kNvStoreUnit 16U
+
+/** @brief Largest value stored under one key */
+#ifndef kNvStoreMaxValueLength
+#define kNvStoreMaxValueLength 256U
+#endif
+
+/** @brief Number of distinct keys the store holds */
+#ifndef kNvStoreMaxKeys
+#define kNvStoreMaxKeys 16U
+#endif
+
+/** @brief Values staged by NvStoreSet() before a flush is forced */
+#ifndef kNvStoreStagedSlots
+#define kNvStoreStagedSlots 4U
+#endif
+
+/** @brief Time without a new NvStoreSet() after which staged values are written */
+#ifndef kNvStoreQuietMs
+#define kNvStoreQuietMs 250U
+#endif
+
+/** @brief Longest time a value stays staged */
+#ifndef kNvStoreMaxDelayMs
+#define kNvStoreMaxDelayMs 2000U
+#endif
+
+/** @brief Keys of the NV data of the nvdata modules */
+typedef enum {
+  kNvStoreKeyTcpip = 0x0001, /**< TCP/IP object, see nvtcpip.c */
+  kNvStoreKeyQos = 0x0002, /**< QoS object, see nvqos.c */
+  kNvStoreKeyDhcpLease = 0x0003, /**< last DHCP lease, see nvtcpip.c */
+} NvStoreKey;
+
+/** @brief Flash below the store
+ *
+ *  Offsets are relative to the start of the store area. The functions
+ *  return 0 on success and -1 on failure.
+ */
+typedef struct {
+  size_t sector_size; /**< bytes per erase sector, a multiple of kNvStoreUnit */
+  size_t sector_count; /**< number of sectors, at least 2 */
+  /** @brief Read length bytes at offset */
+  int (*read_data)(void *context, size_t offset, void *data, size_t length);
+  /** @brief Program erased units, offset and length are multiples of kNvStoreUnit */
+  int (*program_data)(void *context, size_t offset, const void *data,
+                      size_t length);
+  /** @brief Erase the sector starting at offset, it reads all 0xFF after */
+  int (*erase_sector)(void *context, size_t offset);
+  void *context; /**< passed to the functions */
+} NvStoreFlash;
+
+/** @brief Location of the current value of a key */
+typedef struct {
+  uint16_t key;
+  uint16_t length; /**< data length in bytes */
+  size_t offset; /**< offset of the record header */
+} NvStoreEntry;
+
+/** @brief A value staged by NvStoreSet() */
+typedef struct {
+  uint16_t key;
+  uint16_t length;
+  uint8_t data[kNvStoreMaxValueLength];
+} NvStoreStaged;
+
+typedef struct {
+  const NvStoreFlash *flash; /**< NULL until mounted */
+  size_t active; /**< index of the sector taking the appends */
+  uint32_t sequence; /**< sequence number of the active sector */
+  size_t write_offset; /**< next free unit */
+  NvStoreEntry entries[kNvStoreMaxKeys];
+  size_t entry_count;
+  NvStoreStaged staged[kNvStoreStagedSlots];
+  size_t staged_count;
+  uint32_t quiet_ms; /**< time since the last NvStoreSet() */
+  uint32_t delay_ms; /**< time since the oldest staged value */
+  uint32_t flush_count; /**< flushes that programmed at least one record */
+  uint32_t erase_count; /**< sectors erased since mounting */
+} NvStore;
+
+/** @brief CRC-32 (IEEE 802.3, reflected, as zlib) of a block
+ *
+ *  @param data block to check
+ *  @param length of the block in bytes
+ *  @return CRC of the block
+ */
+uint32_t NvStoreCrc32(const void *data,
+                           size_t length);
+
+/** @brief Mount the store, formatting the flash if it holds none
+ *
+ *  Rebuilds the key index from the log and completes an interrupted sector
+ *  move. Nothing is staged afterwards.
+ *
+ *  @param store store to set up
+ *  @param flash flash of the store, must stay valid
+ *  @return kEipStatusOk: success; kEipStatusError: flash failure or bad geometry
+ */
+EipStatus NvStoreMount(NvStore *store,
+                       const NvStoreFlash *flash);
+
+/** @brief Erase all sectors and start an empty store
+ *
+ *  @param store mounted store, staged values are dropped
+ *  @return kEipStatusOk: success; kEipStatusError: flash failure
+ */
+EipStatus NvStoreFormat(NvStore *store);
+
+/** @brief Read the current value of a key, a staged value included
+ *
+ *  @param store mounted store
+ *  @param key key to look up
+ *  @param data buffer of the value
+ *  @param size size of the buffer in bytes
+ *  @param length set to the length of the value, may be NULL
+ *  @return kEipStatusOk: found; kEipStatusError: no such key, buffer too
+ *          small or damaged record
+ */
+EipStatus NvStoreGet(NvStore *store,
+                     uint16_t key,
+                     void *data,
+                     size_t size,
+                     size_t *length);
+
+/** @brief Stage a new value of a key
+ *
+ *  The value is written by NvStoreProcess() or NvStoreFlush(). When all
+ *  staging slots are taken by other keys they are flushed first.
+ *
+ *  @param store mounted store
+ *  @param key key of the value
+ *  @param data value
+ *  @param length of the value, at most kNvStoreMaxValueLength
+ *  @return kEipStatusOk: staged; kEipStatusError: not mounted, too long or the
+ *          forced flush failed
+ */
+EipStatus NvStoreSet(NvStore *store,
+                     uint16_t key,
+                     const void *data,
+                          size_t length);
+
+/** @brief Write all staged values now
+ *
+ *  @param store mounted store
+ *  @return kEipStatusOk: nothing left staged; kEipStatusError: a value could
+ *          not be written, it stays staged
+ */
+EipStatus NvStoreFlush(NvStore *store);
+
+/** @brief Advance the coalescing timers, flushing when they expire
+ *
+ *  @param store store, may be unmounted
+ *  @param elapsed_ms time since the last call
+ */
+void NvStoreProcess(NvStore *store,
+                    uint32_t elapsed_ms);
+
+/** @brief Tell whether values are staged and not yet written
+ *
+ *  @param store store
+ *  @return true when a flush is pending
+ */
+bool NvStoreHasStaged(const NvStore *store);
+
+#endif /* SRC_PORTS_NVDATA_NVSTORE_H_ */
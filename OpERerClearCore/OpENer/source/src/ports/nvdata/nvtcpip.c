@@ -7,6 +7,8 @@
 /** @file nvtcpip.c
  *  @brief This file implements the functions to handle TCP/IP object's NV data.
  */
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
 #include "nvtcpip.h"
 
 #include <string.h>
@@ -24,14 +26,14 @@
 #endif
 
 #ifdef CLEARCORE
+#include "nvdata.h"
+
+/* Location of the settings before the NV store, migrated on first load */
 #define TCPIP_EEPROM_BASE_ADDR  0x0100
 #define TCPIP_EEPROM_MAGIC      0x54435049
 #define TCPIP_EEPROM_VERSION    1
 
 typedef struct {
-  uint32_t magic;
-  uint32_t version;
-  uint32_t crc;
   CipDword config_control;
   CipUdint ip_address;
   CipUdint network_mask;
@@ -42,104 +44,118 @@ typedef struct {
   char domain_name[48];
   uint16_t hostname_length;
   char hostname[64];
-} TcpIpEepromData;
+} TcpIpNvData;
 
-static uint32_t CalculateCrc32(const uint8_t *data, size_t length) {
-  uint32_t crc = 0xFFFFFFFF;
-  for (size_t i = 0; i < length; i++) {
-    crc ^= data[i];
-    for (int j = 0; j < 8; j++) {
-      if (crc & 1) {
-        crc = (crc >> 1) ^ 0xEDB88320;
-      } else {
-        crc >>= 1;
-      }
-    }
-  }
-  return ~crc;
-}
+/** Last address configuration supplied by DHCP */
+typedef struct {
+  CipUdint ip_address;
+  CipUdint network_mask;
+  CipUdint gateway;
+  CipUdint name_server;
+  CipUdint name_server_2;
+} TcpIpNvLease;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t crc; /* over the bytes from offset 16, past config_control */
+  TcpIpNvData data;
+} TcpIpEepromData;
 
 static int EepromRead(uint16_t address, uint8_t *data, size_t length) {
   extern int ClearCoreEepromRead(uint16_t address, uint8_t *data, size_t length);
   return ClearCoreEepromRead(address, data, length);
 }
 
-static int EepromWrite(uint16_t address, const uint8_t *data, size_t length) {
-  extern int ClearCoreEepromWrite(uint16_t address, const uint8_t *data, size_t length);
-  return ClearCoreEepromWrite(address, data, length);
-}
-#endif
-
-/** @brief Load NV data of the TCP/IP object from EEPROM
+/** @brief Read the settings from the user page layout of older firmware
  *
- *  @param  p_tcp_ip pointer to the TCP/IP object's data structure
- *  @return kEipStatusOk: success; kEipStatusError: failure
+ *  @param  nv_data receives the settings
+ *  @return kEipStatusOk: valid settings found; kEipStatusError: none
  */
-EipStatus NvTcpipLoad(CipTcpIpObject *p_tcp_ip) {
-#ifdef CLEARCORE
+static EipStatus LoadLegacy(TcpIpNvData *nv_data) {
   TcpIpEepromData eeprom_data;
-  
+
   if (EepromRead(TCPIP_EEPROM_BASE_ADDR, (uint8_t *)&eeprom_data, sizeof(eeprom_data)) != 0) {
-    OPENER_TRACE_INFO("NvTcpipLoad: EEPROM read failed\n");
-    return kEipStatusError;
-  }
-  
-  if (eeprom_data.magic != TCPIP_EEPROM_MAGIC) {
-    OPENER_TRACE_INFO("NvTcpipLoad: Invalid magic number (0x%08X)\n", eeprom_data.magic);
     return kEipStatusError;
   }
-  
-  if (eeprom_data.version != TCPIP_EEPROM_VERSION) {
-    OPENER_TRACE_INFO("NvTcpipLoad: Unsupported version (%d)\n", eeprom_data.version);
+  if (eeprom_data.magic != TCPIP_EEPROM_MAGIC ||
+      eeprom_data.version != TCPIP_EEPROM_VERSION) {
     return kEipStatusError;
   }
-  
-  uint32_t calculated_crc = CalculateCrc32((uint8_t *)&eeprom_data + 16, sizeof(eeprom_data) - 16);
+  uint32_t calculated_crc = NvStoreCrc32((uint8_t *)&eeprom_data + 16, sizeof(eeprom_data) - 16);
   if (calculated_crc != eeprom_data.crc) {
-    OPENER_TRACE_ERR("NvTcpipLoad: CRC mismatch (stored=0x%08X, calculated=0x%08X)\n", 
+    OPENER_TRACE_ERR("NvTcpipLoad: legacy CRC mismatch (stored=0x%08X, calculated=0x%08X)\n",
                      eeprom_data.crc, calculated_crc);
     return kEipStatusError;
   }
+  *nv_data = eeprom_data.data;
+  return kEipStatusOk;
+}
+#endif
+
+/** @brief Load NV data of the TCP/IP object from the NV store
+ *
+ *  Settings of older firmware, still in the NVM user page, are moved into
+ *  the store the first time they are found.
+ *
+ *  @param  p_tcp_ip pointer to the TCP/IP object's data structure
+ *  @return kEipStatusOk: success; kEipStatusError: failure
+ */
+EipStatus NvTcpipLoad(CipTcpIpObject *p_tcp_ip) {
+#ifdef CLEARCORE
+  TcpIpNvData nv_data;
+  size_t length = 0;
+
+  if (kEipStatusOk != NvStoreGet(&g_nvstore, kNvStoreKeyTcpip, &nv_data,
+                                 sizeof(nv_data), &length) ||
+      sizeof(nv_data) != length) {
+    if (kEipStatusOk != LoadLegacy(&nv_data) ) {
+      OPENER_TRACE_INFO("NvTcpipLoad: no stored configuration\n");
+      return kEipStatusError;
+    }
+    OPENER_TRACE_INFO("NvTcpipLoad: migrating configuration from the NVM user page\n");
+    (void)NvStoreSet(&g_nvstore, kNvStoreKeyTcpip, &nv_data, sizeof(nv_data) );
+  }
   
-  p_tcp_ip->config_control = eeprom_data.config_control;
+  p_tcp_ip->config_control = nv_data.config_control;
   
-  p_tcp_ip->interface_configuration.ip_address = eeprom_data.ip_address;
-  p_tcp_ip->interface_configuration.network_mask = eeprom_data.network_mask;
-  p_tcp_ip->interface_configuration.gateway = eeprom_data.gateway;
-  p_tcp_ip->interface_configuration.name_server = eeprom_data.name_server;
-  p_tcp_ip->interface_configuration.name_server_2 = eeprom_data.name_server_2;
+  p_tcp_ip->interface_configuration.ip_address = nv_data.ip_address;
+  p_tcp_ip->interface_configuration.network_mask = nv_data.network_mask;
+  p_tcp_ip->interface_configuration.gateway = nv_data.gateway;
+  p_tcp_ip->interface_configuration.name_server = nv_data.name_server;
+  p_tcp_ip->interface_configuration.name_server_2 = nv_data.name_server_2;
   
-  if (eeprom_data.domain_name_length > 0 && eeprom_data.domain_name_length <= 48) {
+  if (nv_data.domain_name_length > 0 && nv_data.domain_name_length <= 48) {
     if (p_tcp_ip->interface_configuration.domain_name.string != NULL) {
       CipFree(p_tcp_ip->interface_configuration.domain_name.string);
     }
-    p_tcp_ip->interface_configuration.domain_name.length = eeprom_data.domain_name_length;
-    p_tcp_ip->interface_configuration.domain_name.string = (CipByte *)CipCalloc(eeprom_data.domain_name_length + 1, 1);
+    p_tcp_ip->interface_configuration.domain_name.length = nv_data.domain_name_length;
+    p_tcp_ip->interface_configuration.domain_name.string = (CipByte *)CipCalloc(nv_data.domain_name_length + 1, 1);
     if (p_tcp_ip->interface_configuration.domain_name.string != NULL) {
-      memcpy(p_tcp_ip->interface_configuration.domain_name.string, eeprom_data.domain_name, eeprom_data.domain_name_length);
-      p_tcp_ip->interface_configuration.domain_name.string[eeprom_data.domain_name_length] = '\0';
+      memcpy(p_tcp_ip->interface_configuration.domain_name.string, nv_data.domain_name, nv_data.domain_name_length);
+      p_tcp_ip->interface_configuration.domain_name.string[nv_data.domain_name_length] = '\0';
     }
   } else {
     p_tcp_ip->interface_configuration.domain_name.length = 0;
     p_tcp_ip->interface_configuration.domain_name.string = NULL;
   }
   
-  if (eeprom_data.hostname_length > 0 && eeprom_data.hostname_length <= 64) {
+  if (nv_data.hostname_length > 0 && nv_data.hostname_length <= 64) {
     if (p_tcp_ip->hostname.string != NULL) {
       CipFree(p_tcp_ip->hostname.string);
     }
-    p_tcp_ip->hostname.length = eeprom_data.hostname_length;
-    p_tcp_ip->hostname.string = (CipByte *)CipCalloc(eeprom_data.hostname_length + 1, 1);
+    p_tcp_ip->hostname.length = nv_data.hostname_length;
+    p_tcp_ip->hostname.string = (CipByte *)CipCalloc(nv_data.hostname_length + 1, 1);
     if (p_tcp_ip->hostname.string != NULL) {
-      memcpy(p_tcp_ip->hostname.string, eeprom_data.hostname, eeprom_data.hostname_length);
-      p_tcp_ip->hostname.string[eeprom_data.hostname_length] = '\0';
+      memcpy(p_tcp_ip->hostname.string, nv_data.hostname, nv_data.hostname_length);
+      p_tcp_ip->hostname.string[nv_data.hostname_length] = '\0';
     }
   } else {
     p_tcp_ip->hostname.length = 0;
     p_tcp_ip->hostname.string = NULL;
   }
   
-  OPENER_TRACE_INFO("NvTcpipLoad: Successfully loaded config from EEPROM\n");
+  OPENER_TRACE_INFO("NvTcpipLoad: Successfully loaded config from the NV store\n");
   return kEipStatusOk;
 #else
   FILE *p_file = ConfFileOpen(false, TCPIP_CFG_NAME);
@@ -153,49 +169,48 @@ EipStatus NvTcpipLoad(CipTcpIpObject *p_tcp_ip) {
 #endif
 }
 
-/** @brief Store NV data of the TCP/IP object to EEPROM
+/** @brief Store NV data of the TCP/IP object to the NV store
+ *
+ *  The value is staged; the store writes it to flash once the settings
+ *  stop changing, see NvStoreProcess().
  *
  *  @param  p_tcp_ip pointer to the TCP/IP object's data structure
  *  @return kEipStatusOk: success; kEipStatusError: failure
  */
 EipStatus NvTcpipStore(const CipTcpIpObject *p_tcp_ip) {
 #ifdef CLEARCORE
-  TcpIpEepromData eeprom_data;
+  TcpIpNvData nv_data;
   
-  memset(&eeprom_data, 0, sizeof(eeprom_data));
-  eeprom_data.magic = TCPIP_EEPROM_MAGIC;
-  eeprom_data.version = TCPIP_EEPROM_VERSION;
-  eeprom_data.config_control = p_tcp_ip->config_control;
+  memset(&nv_data, 0, sizeof(nv_data));
+  nv_data.config_control = p_tcp_ip->config_control;
   
-  eeprom_data.ip_address = p_tcp_ip->interface_configuration.ip_address;
-  eeprom_data.network_mask = p_tcp_ip->interface_configuration.network_mask;
-  eeprom_data.gateway = p_tcp_ip->interface_configuration.gateway;
-  eeprom_data.name_server = p_tcp_ip->interface_configuration.name_server;
-  eeprom_data.name_server_2 = p_tcp_ip->interface_configuration.name_server_2;
+  nv_data.ip_address = p_tcp_ip->interface_configuration.ip_address;
+  nv_data.network_mask = p_tcp_ip->interface_configuration.network_mask;
+  nv_data.gateway = p_tcp_ip->interface_configuration.gateway;
+  nv_data.name_server = p_tcp_ip->interface_configuration.name_server;
+  nv_data.name_server_2 = p_tcp_ip->interface_configuration.name_server_2;
   
   if (p_tcp_ip->interface_configuration.domain_name.string != NULL && 
       p_tcp_ip->interface_configuration.domain_name.length > 0) {
-    eeprom_data.domain_name_length = (uint16_t)((p_tcp_ip->interface_configuration.domain_name.length > 48) ? 48 : p_tcp_ip->interface_configuration.domain_name.length);
-    memcpy(eeprom_data.domain_name, p_tcp_ip->interface_configuration.domain_name.string, eeprom_data.domain_name_length);
+    nv_data.domain_name_length = (uint16_t)((p_tcp_ip->interface_configuration.domain_name.length > 48) ? 48 : p_tcp_ip->interface_configuration.domain_name.length);
+    memcpy(nv_data.domain_name, p_tcp_ip->interface_configuration.domain_name.string, nv_data.domain_name_length);
   } else {
-    eeprom_data.domain_name_length = 0;
+    nv_data.domain_name_length = 0;
   }
   
   if (p_tcp_ip->hostname.string != NULL && p_tcp_ip->hostname.length > 0) {
-    eeprom_data.hostname_length = (uint16_t)((p_tcp_ip->hostname.length > 64) ? 64 : p_tcp_ip->hostname.length);
-    memcpy(eeprom_data.hostname, p_tcp_ip->hostname.string, eeprom_data.hostname_length);
+    nv_data.hostname_length = (uint16_t)((p_tcp_ip->hostname.length > 64) ? 64 : p_tcp_ip->hostname.length);
+    memcpy(nv_data.hostname, p_tcp_ip->hostname.string, nv_data.hostname_length);
   } else {
-    eeprom_data.hostname_length = 0;
+    nv_data.hostname_length = 0;
   }
   
-  eeprom_data.crc = CalculateCrc32((uint8_t *)&eeprom_data + 16, sizeof(eeprom_data) - 16);
-  
-  if (EepromWrite(TCPIP_EEPROM_BASE_ADDR, (uint8_t *)&eeprom_data, sizeof(eeprom_data)) != 0) {
-    OPENER_TRACE_ERR("NvTcpipStore: EEPROM write failed\n");
+  if (kEipStatusOk != NvStoreSet(&g_nvstore, kNvStoreKeyTcpip, &nv_data, sizeof(nv_data) ) ) {
+    OPENER_TRACE_ERR("NvTcpipStore: NV store write failed\n");
     return kEipStatusError;
   }
   
-  OPENER_TRACE_INFO("NvTcpipStore: Successfully stored config to EEPROM\n");
+  OPENER_TRACE_INFO("NvTcpipStore: config queued for the NV store\n");
   return kEipStatusOk;
 #else
   FILE *p_file = ConfFileOpen(true, TCPIP_CFG_NAME);
@@ -208,3 +223,48 @@ EipStatus NvTcpipStore(const CipTcpIpObject *p_tcp_ip) {
   }
 #endif
 }
+
+#ifdef CLEARCORE
+/** @brief Load the last DHCP lease, to start with it before DHCP answers
+ *
+ *  Only the addresses are set, the domain name is left alone.
+ *
+ *  @param  p_iface_cfg receives the addresses of the lease
+ *  @return kEipStatusOk: success; kEipStatusError: no lease stored
+ */
+EipStatus NvTcpipLoadLease(CipTcpIpInterfaceConfiguration *p_iface_cfg) {
+  TcpIpNvLease lease;
+  size_t length = 0;
+
+  if (kEipStatusOk != NvStoreGet(&g_nvstore, kNvStoreKeyDhcpLease, &lease,
+                                 sizeof(lease), &length) ||
+      sizeof(lease) != length || 0 == lease.ip_address) {
+    return kEipStatusError;
+  }
+  p_iface_cfg->ip_address = lease.ip_address;
+  p_iface_cfg->network_mask = lease.network_mask;
+  p_iface_cfg->gateway = lease.gateway;
+  p_iface_cfg->name_server = lease.name_server;
+  p_iface_cfg->name_server_2 = lease.name_server_2;
+  return kEipStatusOk;
+}
+
+/** @brief Remember a DHCP lease for the next start
+ *
+ *  A renewal of the same lease is not written again, see NvStoreFlush().
+ *
+ *  @param  p_iface_cfg addresses supplied by DHCP
+ *  @return kEipStatusOk: success; kEipStatusError: failure
+ */
+EipStatus NvTcpipStoreLease(const CipTcpIpInterfaceConfiguration *p_iface_cfg) {
+  TcpIpNvLease lease;
+
+  memset(&lease, 0, sizeof(lease) );
+  lease.ip_address = p_iface_cfg->ip_address;
+  lease.network_mask = p_iface_cfg->network_mask;
+  lease.gateway = p_iface_cfg->gateway;
+  lease.name_server = p_iface_cfg->name_server;
+  lease.name_server_2 = p_iface_cfg->name_server_2;
+  return NvStoreSet(&g_nvstore, kNvStoreKeyDhcpLease, &lease, sizeof(lease) );
+}
+#endif
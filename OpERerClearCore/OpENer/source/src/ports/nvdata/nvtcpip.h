@@ -19,4 +19,10 @@ EipStatus NvTcpipLoad(CipTcpIpObject *p_tcp_ip);
 
 EipStatus NvTcpipStore(const CipTcpIpObject *p_tcp_ip);
 
+#ifdef CLEARCORE
+EipStatus NvTcpipLoadLease(CipTcpIpInterfaceConfiguration *p_iface_cfg);
+
+EipStatus NvTcpipStoreLease(const CipTcpIpInterfaceConfiguration *p_iface_cfg);
+#endif
+
 #endif  /* _NVTCPIP_H_ */
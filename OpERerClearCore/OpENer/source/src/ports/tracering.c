@@ -0,0 +1,298 @@
+/*******************************************************************************
+ * Deferred binary trace ring
+ *
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "tracering.h"
+
+/** @brief Length modifiers of a conversion that change the argument size */
+typedef enum {
+  kTraceLengthDefault, /**< int, or double for floating point */
+  kTraceLengthLongLong, /**< ll and j, two words */
+  kTraceLengthPointerSize, /**< l, z and t: long or size_t, one word kept */
+  kTraceLengthLongDouble /**< L, recorded as double */
+} TraceLength;
+
+/** @brief Argument words collected for one record */
+typedef struct {
+  uint32_t words[kTraceRingMaxArgWords];
+  size_t used;
+  uint8_t flags;
+} TraceArgs;
+
+static int TraceArgsPut(TraceArgs *const args,
+                        const uint32_t word) {
+  if(args->used >= kTraceRingMaxArgWords) {
+    args->flags |= kTraceRingFlagTruncated;
+    return -1;
+  }
+  args->words[args->used++] = word;
+  return 0;
+}
+
+static int TraceArgsPut64(TraceArgs *const args,
+                          const uint64_t value) {
+  if(args->used + 2 > kTraceRingMaxArgWords) {
+    args->flags |= kTraceRingFlagTruncated;
+    return -1;
+  }
+  args->words[args->used++] = (uint32_t) value;
+  args->words[args->used++] = (uint32_t) (value >> 32);
+  return 0;
+}
+
+static int TraceArgsPutString(TraceArgs *const args,
+                              const char *string) {
+  if(NULL == string) {
+    string = "(null)";
+  }
+  size_t length = 0;
+  while(length < kTraceRingMaxStringLength && '\0' != string[length]) {
+    ++length;
+  }
+  size_t words = 1 + (length + 3) / 4;
+  if(args->used + words > kTraceRingMaxArgWords) {
+    args->flags |= kTraceRingFlagTruncated;
+    return -1;
+  }
+  args->words[args->used] = (uint32_t) length;
+  args->words[args->used + words - 1] = 0; /* padding */
+  memcpy(&args->words[args->used + 1], string, length);
+  args->used += words;
+  return 0;
+}
+
+/** @brief Collect the arguments of a format in record order
+ *
+ *  Walks the conversions like printf() would, but only fetches the
+ *  arguments. Stops at the first argument that does not fit.
+ */
+static void TraceArgsCollect(TraceArgs *const args,
+                             const char *format,
+                             va_list *const ap) {
+  while('\0' != *format) {
+    if('%' != *format++) {
+      continue;
+    }
+    if('%' == *format) {
+      ++format;
+      continue;
+    }
+    /* flags */
+    while('-' == *format || '+' == *format || ' ' == *format ||
+          '#' == *format || '0' == *format) {
+      ++format;
+    }
+    /* width and precision */
+    for(int field = 0; field < 2; ++field) {
+      if('*' == *format) {
+        if(0 != TraceArgsPut(args, (uint32_t) va_arg(*ap, int) ) ) {
+          return;
+        }
+        ++format;
+      } else {
+        while(*format >= '0' && *format <= '9') {
+          ++format;
+        }
+      }
+      if(0 == field && '.' == *format) {
+        ++format;
+      } else {
+        break;
+      }
+    }
+    /* length */
+    TraceLength length = kTraceLengthDefault;
+    switch(*format) {
+      case 'h':
+        format += ('h' == format[1]) ? 2 : 1;
+        break;
+      case 'l':
+        if('l' == format[1]) {
+          length = kTraceLengthLongLong;
+          format += 2;
+        } else {
+          length = kTraceLengthPointerSize;
+          ++format;
+        }
+        break;
+      case 'j':
+        length = kTraceLengthLongLong;
+        ++format;
+        break;
+      case 'z':
+      case 't':
+        length = kTraceLengthPointerSize;
+        ++format;
+        break;
+      case 'L':
+        length = kTraceLengthLongDouble;
+        ++format;
+        break;
+      default:
+        break;
+    }
+    /* conversion */
+    int status = 0;
+    switch(*format) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'c':
+        if(kTraceLengthLongLong == length) {
+          status = TraceArgsPut64(args, va_arg(*ap, unsigned long long) );
+        } else if(kTraceLengthPointerSize == length) {
+          status = TraceArgsPut(args, (uint32_t) va_arg(*ap, unsigned long) );
+        } else {
+          status = TraceArgsPut(args, va_arg(*ap, unsigned int) );
+        }
+        break;
+      case 'p':
+        status = TraceArgsPut(args,
+                              (uint32_t) (uintptr_t) va_arg(*ap, void *) );
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A': {
+        double value = (kTraceLengthLongDouble == length) ?
+                       (double) va_arg(*ap, long double) :
+                       va_arg(*ap, double);
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits) );
+        status = TraceArgsPut64(args, bits);
+        break;
+      }
+      case 's':
+        status = TraceArgsPutString(args, va_arg(*ap, const char *) );
+        break;
+      case 'n':
+        (void) va_arg(*ap, void *);
+        break;
+      case '\0':
+        return;
+      default:
+        break;
+    }
+    if(0 != status) {
+      return;
+    }
+    ++format;
+  }
+}
+
+void TraceRingInit(TraceRing *const ring,
+                   uint32_t *const buffer,
+                   const uint32_t size_words) {
+  memset(buffer, 0, size_words * sizeof(uint32_t) );
+  ring->words = buffer;
+  ring->size_mask = size_words - 1;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->dropped = 0;
+  ring->dropped_reported = 0;
+  ring->last_timestamp = 0;
+}
+
+int TraceRingRecordV(TraceRing *const ring,
+                     const uint32_t timestamp,
+                     const char *const format,
+                     va_list args) {
+  TraceArgs record_args;
+  record_args.used = 0;
+  record_args.flags = 0;
+  va_list ap;
+  va_copy(ap, args);
+  TraceArgsCollect(&record_args, format, &ap);
+  va_end(ap);
+
+  const uint32_t length = kTraceRingHeaderWords + record_args.used;
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  do {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if(head - tail + length > ring->size_mask + 1) {
+      __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+      return -1;
+    }
+  } while( !__atomic_compare_exchange_n(&ring->head, &head, head + length,
+                                        true, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED) );
+
+  uint32_t *const words = ring->words;
+  const uint32_t mask = ring->size_mask;
+  words[(head + 1) & mask] = timestamp;
+  words[(head + 2) & mask] = (uint32_t) (uintptr_t) format;
+  for(size_t i = 0; i < record_args.used; ++i) {
+    words[(head + kTraceRingHeaderWords + i) & mask] = record_args.words[i];
+  }
+  /* Publish the record, the consumer stops at a header without magic */
+  __atomic_store_n(&words[head & mask],
+                   (kTraceRingMagic << 16) |
+                   ( (uint32_t) record_args.flags << 8 ) | length,
+                   __ATOMIC_RELEASE);
+  return 0;
+}
+
+int TraceRingRecord(TraceRing *const ring,
+                    const uint32_t timestamp,
+                    const char *const format,
+                    ...) {
+  va_list args;
+  va_start(args, format);
+  int status = TraceRingRecordV(ring, timestamp, format, args);
+  va_end(args);
+  return status;
+}
+
+size_t TraceRingRead(TraceRing *const ring,
+                     uint32_t *const out,
+                     const size_t max_words) {
+  uint32_t *const words = ring->words;
+  const uint32_t mask = ring->size_mask;
+  uint32_t tail = ring->tail;
+  size_t copied = 0;
+
+  while(true) {
+    uint32_t header = __atomic_load_n(&words[tail & mask], __ATOMIC_ACQUIRE);
+    if(kTraceRingMagic != (header >> 16) ) {
+      break;
+    }
+    uint32_t length = header & 0xFFU;
+    if(copied + length > max_words) {
+      break;
+    }
+    for(uint32_t i = 0; i < length; ++i) {
+      out[copied + i] = words[(tail + i) & mask];
+      words[(tail + i) & mask] = 0;
+    }
+    ring->last_timestamp = out[copied + 1];
+    copied += length;
+    tail += length;
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  }
+
+  uint32_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+  if(dropped != ring->dropped_reported &&
+     copied + kTraceRingHeaderWords + 1 <= max_words) {
+    out[copied++] = (kTraceRingMagic << 16) | (kTraceRingHeaderWords + 1);
+    out[copied++] = ring->last_timestamp;
+    out[copied++] = 0;
+    out[copied++] = dropped - ring->dropped_reported;
+    ring->dropped_reported = dropped;
+  }
+  return copied;
+}
+
+uint32_t TraceRingDropped(const TraceRing *const ring) {
+  return ring->dropped;
+}
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Deferred binary trace ring
+ *
+ ******************************************************************************/
+#ifndef SRC_PORTS_TRACERING_H_
+#define SRC_PORTS_TRACERING_H_
+
+/** @file tracering.h
+ *  @brief Lock-free RAM ring of binary trace records
+ *
+ *  A trace call stores the address of its format string and its raw
+ *  arguments instead of formatting them, which takes a few hundred cycles
+ *  instead of a vsnprintf() and a blocking serial write. The records are
+ *  drained in the background and turned back into text on a host by
+ *  tracedecode.py, which looks the format strings up in the ELF file.
+ *
+ *  Record layout, in 32-bit words of the native (little endian) byte order:
+ *
+ *  | Word | Content                                                   |
+ *  |------|-----------------------------------------------------------|
+ *  | 0    | kTraceRingMagic << 16, flags << 8, length in words        |
+ *  | 1    | timestamp in microseconds                                 |
+ *  | 2    | address of the format string, 0 for a drop record         |
+ *  | 3... | arguments in the order of the conversions of the format   |
+ *
+ *  Integers and pointers take one word, except the ll and j conversions
+ *  which take two (low word first), as do floating point values (the
+ *  IEEE 754 double, low word first). A string argument is copied: one word
+ *  holding its length, followed by the characters padded to a full word. A
+ *  '*' width or precision takes one word before its conversion.
+ *
+ *  Any number of producers, including interrupt handlers, may record
+ *  concurrently; space is reserved by a compare-and-swap and a record
+ *  becomes visible when its header word is written. There is a single
+ *  consumer. When the ring is full a record is dropped and counted, the
+ *  consumer reports the count in a drop record.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Value in the upper half of every record header */
+#define kTraceRingMagic 0x5452U
+
+/** @brief Record flag: arguments were cut off at kTraceRingMaxArgWords */
+#define kTraceRingFlagTruncated 0x01U
+
+/** @brief Most argument words of a record */
+#define kTraceRingMaxArgWords 32U
+
+/** @brief Longest string argument copied, in characters */
+#define kTraceRingMaxStringLength 48U
+
+/** @brief Words of a record without arguments */
+#define kTraceRingHeaderWords 3U
+
+typedef struct {
+  uint32_t *words; /**< ring buffer, a power of two words */
+  uint32_t size_mask; /**< size in words - 1 */
+  volatile uint32_t head; /**< free running index of the next reservation */
+  volatile uint32_t tail; /**< free running index of the oldest record */
+  volatile uint32_t dropped; /**< records dropped since initialization */
+  uint32_t dropped_reported; /**< drops already reported by the consumer */
+  uint32_t last_timestamp; /**< timestamp of the last record read */
+} TraceRing;
+
+/** @brief Set up a ring on a buffer
+ *
+ *  @param ring Ring to initialize
+ *  @param buffer Storage of the ring
+ *  @param size_words Size of buffer, a power of two of at least 64
+ */
+void TraceRingInit(TraceRing *const ring,
+                   uint32_t *const buffer,
+                   const uint32_t size_words);
+
+/** @brief Record a trace call
+ *
+ *  @param ring Ring to record into
+ *  @param timestamp Time of the call in microseconds
+ *  @param format printf() style format, must stay valid (a string literal)
+ *  @param args Arguments matching format
+ *  @return 0 if recorded, -1 if dropped because the ring is full
+ */
+int TraceRingRecordV(TraceRing *const ring,
+                     const uint32_t timestamp,
+                     const char *const format,
+                     va_list args);
+
+/** @brief Record a trace call, see TraceRingRecordV() */
+int TraceRingRecord(TraceRing *const ring,
+                    const uint32_t timestamp,
+                    const char *const format,
+                    ...);
+
+/** @brief Move whole records out of the ring
+ *
+ *  Copies the oldest complete records that fit into out and frees their
+ *  space. Records dropped since the last call are reported by a drop record
+ *  (format address 0, one argument holding the count) after the records
+ *  copied, stamped with the time of the last record read.
+ *
+ *  @param ring Ring to read from
+ *  @param out Destination of the records
+ *  @param max_words Size of out in words
+ *  @return Number of words copied to out
+ */
+size_t TraceRingRead(TraceRing *const ring,
+                     uint32_t *const out,
+                     const size_t max_words);
+
+/** @brief Number of records dropped since initialization */
+uint32_t TraceRingDropped(const TraceRing *const ring);
+
+#endif /* SRC_PORTS_TRACERING_H_ */
@@ -0,0 +1,372 @@
+/*******************************************************************************
+ * Streaming waveform capture
+ *
+ ******************************************************************************/
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_PORT
+
+#include "wavecapture.h"
+
+#include <string.h>
+
+#include "trace.h"
+
+/** @brief Keeps the compiler from moving buffer accesses across the hand
+ *  over of a half; the targets are single core, so nothing else is needed */
+#if defined(__GNUC__)
+#define WAVE_CAPTURE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#else
+#define WAVE_CAPTURE_BARRIER()
+#endif
+
+static size_t WaveCaptureBits(uint32_t bits) {
+  size_t count = 0;
+  for(; 0 != bits; bits &= bits - 1) {
+    ++count;
+  }
+  return count;
+}
+
+static void WaveCapturePutUint16(uint8_t *const data,
+                                 const uint16_t value) {
+  data[0] = (uint8_t) value;
+  data[1] = (uint8_t) (value >> 8);
+}
+
+static void WaveCapturePutUint32(uint8_t *const data,
+                                 const uint32_t value) {
+  WaveCapturePutUint16(data, (uint16_t) value);
+  WaveCapturePutUint16(data + 2, (uint16_t) (value >> 16) );
+}
+
+uint16_t WaveCaptureRecordSize(const uint32_t signals) {
+  const uint32_t channels = (1U << kWaveCaptureChannels) - 1U;
+  return (uint16_t) (
+    4 * WaveCaptureBits(signals & (channels * kWaveSignalPosition) ) +
+    2 * WaveCaptureBits(signals & (channels * kWaveSignalHlfb) ) +
+    2 * WaveCaptureBits(signals & (channels * kWaveSignalAnalog) ) +
+    ( (signals & kWaveSignalInputs) ? 4 : 0) );
+}
+
+/** @brief Write the header block of the capture
+ *
+ *  Uses the first block of the buffer, which is free before the data stream
+ *  starts and after it ended.
+ */
+static int WaveCaptureWriteHeader(WaveCapture *const capture,
+                                  const uint16_t flags) {
+  const WaveCaptureDevice *const device = capture->device;
+  uint8_t *const block = capture->half[0].data[0];
+  WaveCaptureHeader header = {
+    .magic = kWaveCaptureHeaderMagic,
+    .version = kWaveCaptureVersion,
+    .capture_id = capture->capture_id,
+    .flags = flags,
+    .record_size = capture->record_size,
+    .signals = capture->config.signals,
+    .sample_period_us = capture->sample_period_us,
+    .decimation = capture->config.decimation,
+    .trigger = capture->config.trigger,
+    .trigger_input = capture->config.trigger_input,
+    .trigger_timestamp_us = capture->trigger_timestamp_us,
+    .samples = capture->samples,
+    .lost = capture->lost,
+    .data_blocks = capture->blocks_written
+  };
+  memset(block, 0, kWaveCaptureBlockSize);
+  memcpy(block, &header, sizeof(header) );
+  if(device->begin(device->context, capture->config.first_block, 1) < 0) {
+    return -1;
+  }
+  if(device->write_blocks(device->context, block, 1) < 0) {
+    device->end(device->context);
+    return -1;
+  }
+  return device->end(device->context);
+}
+
+static EipStatus WaveCaptureFail(WaveCapture *const capture) {
+  const WaveCaptureDevice *const device = capture->device;
+  OPENER_TRACE_ERR("wavecapture: device failed after %lu blocks\n",
+                   (unsigned long) capture->blocks_written);
+  device->end(device->context);
+  capture->state = kWaveCaptureError;
+  return kEipStatusError;
+}
+
+void WaveCaptureInit(WaveCapture *const capture,
+                     const WaveCaptureDevice *const device,
+                     const uint32_t sample_period_us) {
+  memset(capture, 0, sizeof(*capture) );
+  capture->device = device;
+  capture->sample_period_us = sample_period_us;
+  capture->state = kWaveCaptureIdle;
+}
+
+EipStatus WaveCaptureArm(WaveCapture *const capture,
+                         const WaveCaptureConfig *const config) {
+  const WaveCaptureDevice *const device = capture->device;
+  const uint8_t state = capture->state;
+  if(kWaveCaptureArmed == state || kWaveCaptureRunning == state ||
+     kWaveCaptureFlushing == state) {
+    return kEipStatusError;
+  }
+  if(0 == config->signals || 0 != (config->signals & ~kWaveSignalAll) ||
+     config->trigger > kWaveTriggerChange || config->trigger_input >= 32 ||
+     0 == config->decimation || config->first_block >= device->block_count) {
+    return kEipStatusError;
+  }
+  uint32_t blocks = device->block_count - config->first_block;
+  if(0 != config->block_count) {
+    if(config->block_count > blocks) {
+      return kEipStatusError;
+    }
+    blocks = config->block_count;
+  }
+  if(blocks < 2) {
+    return kEipStatusError;
+  }
+
+  capture->config = *config;
+  capture->config.block_count = blocks;
+  capture->record_size = WaveCaptureRecordSize(config->signals);
+  capture->records_per_block = (uint16_t) (
+    (kWaveCaptureBlockSize - kWaveCaptureBlockHeaderSize) /
+    capture->record_size);
+  capture->data_blocks_max = blocks - 1;
+  capture->half[0].full = 0;
+  capture->half[1].full = 0;
+  capture->stop_request = 0;
+  capture->fill = 0;
+  capture->fill_block = 0;
+  capture->fill_records = 0;
+  capture->decimation_count = 0;
+  capture->inputs_valid = false;
+  capture->tick = 0;
+  capture->sequence = 0;
+  capture->trigger_timestamp_us = 0;
+  capture->samples = 0;
+  capture->lost = 0;
+  capture->drain = 0;
+  capture->blocks_written = 0;
+  ++capture->capture_id;
+
+  /* Records a capture in progress, so a card pulled before the end still
+   * tells which data blocks belong to it */
+  if(WaveCaptureWriteHeader(capture, 0) < 0) {
+    capture->state = kWaveCaptureError;
+    return kEipStatusError;
+  }
+  uint32_t expected = 0;
+  if(0 != config->samples) {
+    expected = (config->samples + capture->records_per_block - 1) /
+               capture->records_per_block;
+    if(expected > capture->data_blocks_max) {
+      expected = capture->data_blocks_max;
+    }
+  }
+  if(device->begin(device->context, config->first_block + 1,
+                   expected) < 0) {
+    capture->state = kWaveCaptureError;
+    return kEipStatusError;
+  }
+  WAVE_CAPTURE_BARRIER();
+  capture->state = kWaveCaptureArmed;
+  OPENER_TRACE_INFO("wavecapture: capture %u armed, %u byte records\n",
+                    (unsigned) capture->capture_id,
+                    (unsigned) capture->record_size);
+  return kEipStatusOk;
+}
+
+void WaveCaptureStop(WaveCapture *const capture) {
+  const uint8_t state = capture->state;
+  if(kWaveCaptureArmed == state || kWaveCaptureRunning == state) {
+    capture->stop_request = 1;
+  }
+}
+
+/** @brief Hand the filled blocks of the current half to the consumer */
+static void WaveCaptureHandOver(WaveCapture *const capture) {
+  WaveCaptureHalf *const half = &capture->half[capture->fill];
+  half->blocks = capture->fill_block;
+  WAVE_CAPTURE_BARRIER();
+  half->full = 1;
+  capture->fill ^= 1;
+  capture->fill_block = 0;
+}
+
+/** @brief Write the header of the block being filled and move on */
+static void WaveCaptureCloseBlock(WaveCapture *const capture) {
+  uint8_t *const block =
+    capture->half[capture->fill].data[capture->fill_block];
+  const size_t used = kWaveCaptureBlockHeaderSize +
+                      (size_t) capture->fill_records * capture->record_size;
+  WaveCapturePutUint16(block, kWaveCaptureBlockMagic);
+  WaveCapturePutUint16(block + 2, capture->fill_records);
+  WaveCapturePutUint32(block + 4, capture->sequence);
+  WaveCapturePutUint32(block + 8, capture->block_first_tick);
+  WaveCapturePutUint16(block + 12, capture->capture_id);
+  WaveCapturePutUint16(block + 14, 0);
+  memset(block + used, 0, kWaveCaptureBlockSize - used);
+  ++capture->sequence;
+  capture->fill_records = 0;
+  if(++capture->fill_block == kWaveCaptureHalfBlocks) {
+    WaveCaptureHandOver(capture);
+  }
+}
+
+/** @brief End the recording, the consumer writes what is left */
+static void WaveCaptureFinish(WaveCapture *const capture) {
+  if(0 != capture->fill_records) {
+    WaveCaptureCloseBlock(capture);
+  }
+  if(0 != capture->fill_block) {
+    WaveCaptureHandOver(capture);
+  }
+  WAVE_CAPTURE_BARRIER();
+  capture->state = kWaveCaptureFlushing;
+}
+
+static bool WaveCaptureTriggered(WaveCapture *const capture,
+                                 const uint32_t inputs) {
+  if(kWaveTriggerImmediate == capture->config.trigger) {
+    return true;
+  }
+  const uint32_t last = capture->last_inputs;
+  const bool valid = capture->inputs_valid;
+  capture->last_inputs = inputs;
+  capture->inputs_valid = true;
+  if(!valid) {
+    return false;
+  }
+  const uint32_t changed = (inputs ^ last) &
+                           (1UL << capture->config.trigger_input);
+  switch(capture->config.trigger) {
+    case kWaveTriggerRising:
+      return 0 != (changed & inputs);
+    case kWaveTriggerFalling:
+      return 0 != (changed & last);
+    default:
+      return 0 != changed;
+  }
+}
+
+static void WaveCapturePack(const WaveCapture *const capture,
+                            uint8_t *record,
+                            const WaveCaptureValues *const values) {
+  const uint32_t signals = capture->config.signals;
+  for(size_t channel = 0; channel < kWaveCaptureChannels; ++channel) {
+    if(signals & ( (uint32_t) kWaveSignalPosition << channel) ) {
+      WaveCapturePutUint32(record, (uint32_t) values->position[channel]);
+      record += 4;
+    }
+  }
+  for(size_t channel = 0; channel < kWaveCaptureChannels; ++channel) {
+    if(signals & ( (uint32_t) kWaveSignalHlfb << channel) ) {
+      WaveCapturePutUint16(record, (uint16_t) values->hlfb[channel]);
+      record += 2;
+    }
+  }
+  for(size_t channel = 0; channel < kWaveCaptureChannels; ++channel) {
+    if(signals & ( (uint32_t) kWaveSignalAnalog << channel) ) {
+      WaveCapturePutUint16(record, values->analog[channel]);
+      record += 2;
+    }
+  }
+  if(signals & kWaveSignalInputs) {
+    WaveCapturePutUint32(record, values->inputs);
+  }
+}
+
+void WaveCaptureSample(WaveCapture *const capture,
+                       const WaveCaptureValues *const values) {
+  uint8_t state = capture->state;
+  if(kWaveCaptureArmed == state) {
+    if(capture->stop_request) {
+      WaveCaptureFinish(capture);
+      return;
+    }
+    if(!WaveCaptureTriggered(capture, values->inputs) ) {
+      return;
+    }
+    capture->trigger_timestamp_us = values->timestamp_us;
+    capture->state = state = kWaveCaptureRunning;
+  }
+  if(kWaveCaptureRunning != state) {
+    return;
+  }
+  if(capture->stop_request) {
+    WaveCaptureFinish(capture);
+    return;
+  }
+
+  const bool record = 0 == capture->decimation_count;
+  if(++capture->decimation_count >= capture->config.decimation) {
+    capture->decimation_count = 0;
+  }
+  if(!record) {
+    return;
+  }
+
+  WaveCaptureHalf *const half = &capture->half[capture->fill];
+  if(half->full) {
+    /* The consumer did not write this half yet */
+    ++capture->lost;
+  } else {
+    if(0 == capture->fill_records) {
+      capture->block_first_tick = capture->tick;
+    }
+    WaveCapturePack(capture,
+                    half->data[capture->fill_block] +
+                    kWaveCaptureBlockHeaderSize +
+                    (size_t) capture->fill_records * capture->record_size,
+                    values);
+    ++capture->samples;
+    if(++capture->fill_records == capture->records_per_block) {
+      WaveCaptureCloseBlock(capture);
+    }
+  }
+  ++capture->tick;
+  if( (0 != capture->config.samples &&
+       capture->tick >= capture->config.samples) ||
+      capture->sequence >= capture->data_blocks_max ) {
+    WaveCaptureFinish(capture);
+  }
+}
+
+EipStatus WaveCapturePoll(WaveCapture *const capture) {
+  const WaveCaptureDevice *const device = capture->device;
+  const uint8_t state = capture->state;
+  if(kWaveCaptureArmed != state && kWaveCaptureRunning != state &&
+     kWaveCaptureFlushing != state) {
+    return kEipStatusOk;
+  }
+  /* Halves are handed over alternately, so once the next one is not full
+   * the other is not either */
+  while(capture->half[capture->drain].full) {
+    WaveCaptureHalf *const half = &capture->half[capture->drain];
+    WAVE_CAPTURE_BARRIER();
+    if(device->write_blocks(device->context, half->data,
+                            half->blocks) < 0) {
+      return WaveCaptureFail(capture);
+    }
+    capture->blocks_written += half->blocks;
+    WAVE_CAPTURE_BARRIER();
+    half->full = 0;
+    capture->drain ^= 1;
+  }
+  if(kWaveCaptureFlushing == state) {
+    if(device->end(device->context) < 0) {
+      return WaveCaptureFail(capture);
+    }
+    if(WaveCaptureWriteHeader(capture, kWaveCaptureFlagComplete) < 0) {
+      capture->state = kWaveCaptureError;
+      return kEipStatusError;
+    }
+    capture->state = kWaveCaptureDone;
+    OPENER_TRACE_INFO("wavecapture: capture %u done, %lu records, %lu lost\n",
+                      (unsigned) capture->capture_id,
+                      (unsigned long) capture->samples,
+                      (unsigned long) capture->lost);
+  }
+  return kEipStatusOk;
+}
@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * Streaming waveform capture
+ *
+ ******************************************************************************/
+#ifndef SRC_PORTS_WAVECAPTURE_H_
+#define SRC_PORTS_WAVECAPTURE_H_
+
+/** @file wavecapture.h
+ *  @brief Sample time capture of signals to a block device
+ *
+ *  WaveCaptureSample() is called once per sample time from the sample rate
+ *  interrupt. After the trigger it packs the selected signals of every
+ *  decimation-th sample time into a record and appends it to one half of a
+ *  RAM double buffer. When a half is full the producer continues in the
+ *  other half and WaveCapturePoll(), called from the main loop, writes the
+ *  full half to the device in one multi-block write. Each half is owned by
+ *  exactly one side at a time, handed over by its full flag, so no lock is
+ *  needed. If the device falls behind and the next half is still full, the
+ *  records are dropped and counted.
+ *
+ *  The data blocks of a capture are one contiguous stream on the device,
+ *  opened by WaveCaptureArm() and kept open until the capture ends. The
+ *  block in front of them holds a WaveCaptureHeader, written once when the
+ *  capture is armed and again, complete, when it ends.
+ *
+ *  Data block layout, little endian:
+ *
+ *  | Offset | Size | Content                                            |
+ *  |--------|------|----------------------------------------------------|
+ *  | 0      | 2    | kWaveCaptureBlockMagic                             |
+ *  | 2      | 2    | number of records in the block                     |
+ *  | 4      | 4    | sequence number of the block in the capture, from 0 |
+ *  | 8      | 4    | tick of the first record                           |
+ *  | 12     | 2    | capture id                                         |
+ *  | 14     | 2    | reserved, 0                                        |
+ *  | 16     | ...  | records, the rest of the block is 0                |
+ *
+ *  A tick counts the decimated sample times since the trigger, recorded or
+ *  dropped, so record i of a block was sampled at trigger_timestamp_us +
+ *  (first tick + i) * decimation * sample_period_us. A record holds the
+ *  selected signals in the order of the WaveCaptureSignal bits: the
+ *  commanded positions (DINT), the HLFB duties (INT, 0.01 %), the filtered
+ *  analog inputs (UINT, Q15) and the input bitmap (UDINT).
+ *
+ *  Tools/wavedecode.py turns a capture read back from the card into CSV.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typedefs.h"
+
+/** @brief Block size of the device in bytes */
+#define kWaveCaptureBlockSize 512U
+
+/** @brief Blocks in each half of the double buffer, written in one go */
+#ifndef kWaveCaptureHalfBlocks
+#define kWaveCaptureHalfBlocks 8U
+#endif
+
+/** @brief First bytes of every data block, "WV" */
+#define kWaveCaptureBlockMagic 0x5657U
+
+/** @brief First bytes of the header block, "CCWV" */
+#define kWaveCaptureHeaderMagic 0x56574343UL
+
+/** @brief Version of the header and block layout */
+#define kWaveCaptureVersion 1U
+
+/** @brief Size of the header of a data block */
+#define kWaveCaptureBlockHeaderSize 16U
+
+/** @brief Header flag: the capture ended and the header is complete */
+#define kWaveCaptureFlagComplete 0x01U
+
+/** @brief Number of motor and analog channels of the signal groups */
+#define kWaveCaptureChannels 4U
+
+/** @brief Signals of a record, a channel is the bit shifted by its index */
+typedef enum {
+  kWaveSignalPosition = 0x0001, /**< commanded position of M-0, M-1... */
+  kWaveSignalHlfb = 0x0010, /**< HLFB duty of M-0, M-1... */
+  kWaveSignalAnalog = 0x0100, /**< filtered analog input A-9, A-10... */
+  kWaveSignalInputs = 0x1000, /**< bitmap of the connector input states */
+  kWaveSignalAll = 0x1FFF
+} WaveCaptureSignal;
+
+/** @brief Start of the recording */
+typedef enum {
+  kWaveTriggerImmediate = 0, /**< the first sample time after arming */
+  kWaveTriggerRising = 1, /**< rising edge of the trigger input */
+  kWaveTriggerFalling = 2, /**< falling edge of the trigger input */
+  kWaveTriggerChange = 3 /**< any edge of the trigger input */
+} WaveCaptureTrigger;
+
+typedef enum {
+  kWaveCaptureIdle = 0, /**< never armed */
+  kWaveCaptureArmed = 1, /**< waiting for the trigger */
+  kWaveCaptureRunning = 2, /**< recording */
+  kWaveCaptureFlushing = 3, /**< recording ended, writing the last blocks */
+  kWaveCaptureDone = 4, /**< capture complete on the device */
+  kWaveCaptureError = 5 /**< the device failed, the capture ended */
+} WaveCaptureState;
+
+/** @brief Values of one sample time */
+typedef struct {
+  uint32_t timestamp_us;
+  int32_t position[kWaveCaptureChannels];
+  int16_t hlfb[kWaveCaptureChannels]; /**< duty in 0.01 %, INT16_MIN unknown */
+  uint16_t analog[kWaveCaptureChannels];
+  uint32_t inputs;
+} WaveCaptureValues;
+
+/** @brief Settings of a capture */
+typedef struct {
+  uint32_t signals; /**< WaveCaptureSignal bits, at least one */
+  uint8_t trigger; /**< WaveCaptureTrigger */
+  uint8_t trigger_input; /**< bit of the input bitmap for edge triggers */
+  uint16_t decimation; /**< record every n-th sample time, at least 1 */
+  uint32_t samples; /**< ticks to capture, 0: until stopped or full */
+  uint32_t first_block; /**< header block, the data blocks follow */
+  uint32_t block_count; /**< blocks of the region, 0: to the device end */
+} WaveCaptureConfig;
+
+/** @brief Block device below the capture
+ *
+ *  The functions return 0 on success and -1 on failure.
+ */
+typedef struct {
+  uint32_t block_count; /**< size of the device in blocks */
+  /** @brief Start a stream of contiguous blocks at block, count blocks are
+   *  expected, 0 if unknown */
+  int (*begin)(void *context, uint32_t block, uint32_t count);
+  /** @brief Write the next count blocks of the stream */
+  int (*write_blocks)(void *context, const void *data, uint32_t count);
+  /** @brief End the stream, the blocks are stored */
+  int (*end)(void *context);
+  void *context; /**< passed to the functions */
+} WaveCaptureDevice;
+
+/** @brief Header block of a capture, followed by zeros
+ *
+ *  Without kWaveCaptureFlagComplete the capture did not end, the fields
+ *  after trigger_input are 0 and the data blocks are found by their
+ *  sequence and capture id.
+ */
+typedef struct {
+  uint32_t magic; /**< kWaveCaptureHeaderMagic */
+  uint16_t version; /**< kWaveCaptureVersion */
+  uint16_t capture_id;
+  uint16_t flags; /**< kWaveCaptureFlag... */
+  uint16_t record_size; /**< bytes per record */
+  uint32_t signals;
+  uint32_t sample_period_us;
+  uint16_t decimation;
+  uint8_t trigger;
+  uint8_t trigger_input;
+  uint32_t trigger_timestamp_us;
+  uint32_t samples; /**< records on the device */
+  uint32_t lost; /**< records dropped for a full buffer */
+  uint32_t data_blocks; /**< data blocks on the device */
+} WaveCaptureHeader;
+
+/** @brief One half of the double buffer */
+typedef struct {
+  uint8_t data[kWaveCaptureHalfBlocks][kWaveCaptureBlockSize];
+  uint16_t blocks; /**< blocks to write, set before full */
+  volatile uint8_t full; /**< set by the producer, cleared by the consumer */
+} WaveCaptureHalf;
+
+typedef struct {
+  const WaveCaptureDevice *device;
+  uint32_t sample_period_us;
+  WaveCaptureConfig config;
+  WaveCaptureHalf half[2];
+  uint16_t record_size;
+  uint16_t records_per_block;
+  uint32_t data_blocks_max; /**< data blocks of the region */
+  uint16_t capture_id; /**< incremented by every arm */
+  volatile uint8_t state; /**< WaveCaptureState */
+  volatile uint8_t stop_request;
+  /* Producer */
+  uint8_t fill; /**< half being filled */
+  uint16_t fill_block; /**< block being filled */
+  uint16_t fill_records; /**< records in that block */
+  uint16_t decimation_count;
+  bool inputs_valid; /**< last_inputs holds a sample */
+  uint32_t last_inputs;
+  uint32_t tick; /**< next tick */
+  uint32_t block_first_tick;
+  uint32_t sequence; /**< blocks closed */
+  uint32_t trigger_timestamp_us;
+  volatile uint32_t samples; /**< records stored */
+  volatile uint32_t lost; /**< records dropped */
+  /* Consumer */
+  uint8_t drain; /**< next half to write */
+  uint32_t blocks_written; /**< data blocks on the device */
+} WaveCapture;
+
+/** @brief Set up an idle capture
+ *
+ *  @param capture capture to initialize
+ *  @param device block device, must stay valid
+ *  @param sample_period_us period of the WaveCaptureSample() calls
+ */
+void WaveCaptureInit(WaveCapture *const capture,
+                     const WaveCaptureDevice *const device,
+                     const uint32_t sample_period_us);
+
+/** @brief Bytes of a record with these signals
+ *
+ *  @param signals WaveCaptureSignal bits
+ *  @return record size in bytes
+ */
+uint16_t WaveCaptureRecordSize(const uint32_t signals);
+
+/** @brief Start a capture, write its header and open the data stream
+ *
+ *  Called from the main loop. The capture is armed only when no other is
+ *  armed, running or flushing.
+ *
+ *  @param capture initialized capture
+ *  @param config settings of the capture, copied
+ *  @return kEipStatusOk: armed; kEipStatusError: busy, invalid settings or
+ *          device failure
+ */
+EipStatus WaveCaptureArm(WaveCapture *const capture,
+                         const WaveCaptureConfig *const config);
+
+/** @brief End an armed or running capture
+ *
+ *  Called from the main loop. The next WaveCaptureSample() ends the
+ *  recording and WaveCapturePoll() writes the remaining blocks.
+ *
+ *  @param capture capture to stop
+ */
+void WaveCaptureStop(WaveCapture *const capture);
+
+/** @brief Record one sample time
+ *
+ *  Called from the sample rate interrupt, the only producer.
+ *
+ *  @param capture capture
+ *  @param values values of this sample time
+ */
+void WaveCaptureSample(WaveCapture *const capture,
+                       const WaveCaptureValues *const values);
+
+/** @brief Write full halves of the buffer to the device
+ *
+ *  Called from the main loop, the only consumer. Finishes the capture on
+ *  the device once the recording ended.
+ *
+ *  @param capture capture
+ *  @return kEipStatusOk: nothing failed; kEipStatusError: the device failed
+ *          and the capture ended in kWaveCaptureError
+ */
+EipStatus WaveCapturePoll(WaveCapture *const capture);
+
+#endif /* SRC_PORTS_WAVECAPTURE_H_ */
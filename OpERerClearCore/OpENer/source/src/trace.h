@@ -10,6 +10,51 @@
  * @brief Tracing infrastructure for OpENer
  */
 
+#include <stdint.h>
+
+/** @def OPENER_TRACE_MODULE_GENERAL Trace module of all files that do not
+ *  select one. A file selects its module by defining OPENER_TRACE_MODULE
+ *  before its first include.
+ */
+#define OPENER_TRACE_MODULE_GENERAL 0
+/** @def OPENER_TRACE_MODULE_ENCAP Encapsulation protocol (encap.c) */
+#define OPENER_TRACE_MODULE_ENCAP 1
+/** @def OPENER_TRACE_MODULE_CPF Common packet format (cpf.c) */
+#define OPENER_TRACE_MODULE_CPF 2
+/** @def OPENER_TRACE_MODULE_CONNECTION_MANAGER Connection Manager object */
+#define OPENER_TRACE_MODULE_CONNECTION_MANAGER 3
+/** @def OPENER_TRACE_MODULE_IO I/O connections and the assembly data */
+#define OPENER_TRACE_MODULE_IO 4
+/** @def OPENER_TRACE_MODULE_NETWORK_HANDLER Socket handling */
+#define OPENER_TRACE_MODULE_NETWORK_HANDLER 5
+/** @def OPENER_TRACE_MODULE_PORT Platform port and sample application */
+#define OPENER_TRACE_MODULE_PORT 6
+/** @def OPENER_TRACE_MODULE_COUNT Number of trace modules */
+#define OPENER_TRACE_MODULE_COUNT 7
+
+#ifndef OPENER_TRACE_MODULE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_GENERAL
+#endif
+
+/** @def OPENER_TRACE_MASK_MODULE(module, levels) Trace mask enabling the
+ *  given OPENER_TRACE_LEVEL_xxx flags for one module. A trace mask holds four
+ *  level bits per module, module n in bits 4n to 4n + 3.
+ */
+#define OPENER_TRACE_MASK_MODULE(module, levels) \
+  ( ( (uint32_t) (levels) & 0x0FU ) << (4U * (module) ) )
+
+/** @def OPENER_TRACE_MASK_ALL_MODULES(levels) Trace mask enabling the given
+ *  OPENER_TRACE_LEVEL_xxx flags for all modules
+ */
+#define OPENER_TRACE_MASK_ALL_MODULES(levels) \
+  ( ( (uint32_t) (levels) & 0x0FU ) * 0x01111111UL)
+
+/** @brief Trace mask applied at run time, initialized to
+ *  OPENER_TRACE_COMPILED_MASK. Sites compiled out stay silent whatever it
+ *  holds.
+ */
+extern uint32_t g_opener_trace_mask;
+
 #ifdef OPENER_WITH_TRACES
 
 #ifndef OPENER_INSTALL_AS_LIB
@@ -42,16 +87,50 @@
 #define OPENER_TRACE_LEVEL OPENER_TRACE_LEVEL_ERROR
 #endif
 
+/** @def OPENER_TRACE_MASK Trace levels compiled in per module, see
+ *  OPENER_TRACE_MASK_MODULE(). Defaults to OPENER_TRACE_LEVEL for all
+ *  modules, OPENER_TRACE_LEVEL limits it in any case.
+ */
+#ifndef OPENER_TRACE_MASK
+#define OPENER_TRACE_MASK OPENER_TRACE_MASK_ALL_MODULES(OPENER_TRACE_LEVEL)
+#endif
+
+/** @def OPENER_TRACE_COMPILED_MASK Trace levels compiled in per module */
+#define OPENER_TRACE_COMPILED_MASK \
+  ( (uint32_t) (OPENER_TRACE_MASK) & \
+    OPENER_TRACE_MASK_ALL_MODULES(OPENER_TRACE_LEVEL) )
+
+/** @def OPENER_TRACE_COMPILED(level) Constant expression, true if the level
+ *  is compiled in for the module of the file. Guards code that only exists
+ *  to feed a trace, e.g. a counter printed every n calls.
+ */
+#define OPENER_TRACE_COMPILED(level) \
+  (0 != ( (OPENER_TRACE_COMPILED_MASK >> (4U * OPENER_TRACE_MODULE) ) & \
+          (uint32_t) (level) ) )
+
+/** @def OPENER_TRACE_ON(level) True if the level is compiled in and enabled
+ *  at run time for the module of the file. Folds to 0 at compile time if
+ *  the level is not compiled in. The arguments of a trace site are then
+ *  never evaluated and the compiler drops the dead branch, but they are
+ *  still compiled and type checked, so every identifier they name has to
+ *  be declared.
+ */
+#define OPENER_TRACE_ON(level) \
+  (OPENER_TRACE_COMPILED(level) && \
+   0 != ( (g_opener_trace_mask >> (4U * OPENER_TRACE_MODULE) ) & \
+          (uint32_t) (level) ) )
+
 /* @def OPENER_TRACE_ENABLED Can be used for conditional code compilation */
 #define OPENER_TRACE_ENABLED
 
 /** @def OPENER_TRACE_ERR(...) Trace error messages.
  *  In order to activate this trace level set the OPENER_TRACE_LEVEL_ERROR flag
- *  in OPENER_TRACE_LEVEL.
+ *  in OPENER_TRACE_LEVEL and in the module's bits of OPENER_TRACE_MASK and
+ *  g_opener_trace_mask.
  */
 #define OPENER_TRACE_ERR(...)                                                  \
   do {                                                                         \
-    if (OPENER_TRACE_LEVEL_ERROR & OPENER_TRACE_LEVEL) {LOG_TRACE(__VA_ARGS__);} \
+    if (OPENER_TRACE_ON(OPENER_TRACE_LEVEL_ERROR) ) {LOG_TRACE(__VA_ARGS__);} \
   } while (0)
 
 /** @def OPENER_TRACE_WARN(...) Trace warning messages.
@@ -60,7 +139,7 @@
  */
 #define OPENER_TRACE_WARN(...)                           \
   do {                                                   \
-    if (OPENER_TRACE_LEVEL_WARNING & OPENER_TRACE_LEVEL) { \
+    if (OPENER_TRACE_ON(OPENER_TRACE_LEVEL_WARNING) ) { \
       LOG_TRACE(__VA_ARGS__);}                            \
   } while (0)
 
@@ -70,7 +149,7 @@
  */
 #define OPENER_TRACE_STATE(...)                                                \
   do {                                                                         \
-    if (OPENER_TRACE_LEVEL_STATE & OPENER_TRACE_LEVEL) {LOG_TRACE(__VA_ARGS__);} \
+    if (OPENER_TRACE_ON(OPENER_TRACE_LEVEL_STATE) ) {LOG_TRACE(__VA_ARGS__);} \
   } while (0)
 
 /** @def OPENER_TRACE_INFO(...) Trace information messages.
@@ -79,12 +158,16 @@
  */
 #define OPENER_TRACE_INFO(...)                                                \
   do {                                                                        \
-    if (OPENER_TRACE_LEVEL_INFO & OPENER_TRACE_LEVEL) {LOG_TRACE(__VA_ARGS__);} \
+    if (OPENER_TRACE_ON(OPENER_TRACE_LEVEL_INFO) ) {LOG_TRACE(__VA_ARGS__);} \
   } while (0)
 
 #else
 /* define the tracing macros empty in order to save space */
 
+#define OPENER_TRACE_COMPILED_MASK 0U
+#define OPENER_TRACE_COMPILED(level) 0
+#define OPENER_TRACE_ON(level) 0
+
 #define OPENER_TRACE_ERR(...)
 #define OPENER_TRACE_WARN(...)
 #define OPENER_TRACE_STATE(...)
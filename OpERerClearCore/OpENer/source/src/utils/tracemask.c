@@ -0,0 +1,8 @@
+/*******************************************************************************
+ * Run time trace mask
+ *
+ ******************************************************************************/
+
+#include "trace.h"
+
+uint32_t g_opener_trace_mask = OPENER_TRACE_COMPILED_MASK;
@@ -9,7 +9,31 @@ IMPORT_TEST_GROUP (CipElectronicKey);
 IMPORT_TEST_GROUP (CipElectronicKeyFormat);
 IMPORT_TEST_GROUP (CipConnectionManager);
 IMPORT_TEST_GROUP (CipConnectionObject);
+IMPORT_TEST_GROUP (CipIoConnection);
+IMPORT_TEST_GROUP (CipAttributeList);
 IMPORT_TEST_GROUP (SocketTimer);
+IMPORT_TEST_GROUP (ExplicitThrottle);
+IMPORT_TEST_GROUP (TraceRing);
+IMPORT_TEST_GROUP (NvStore);
+IMPORT_TEST_GROUP (AdcDecimator);
+IMPORT_TEST_GROUP (CcioLink);
+IMPORT_TEST_GROUP (SerialDmaRing);
+IMPORT_TEST_GROUP (GmacHashFilter);
+IMPORT_TEST_GROUP (GmacRxScreen);
+IMPORT_TEST_GROUP (GmacRxRing);
+IMPORT_TEST_GROUP (InetChecksum);
+IMPORT_TEST_GROUP (StepPulseTiming);
+IMPORT_TEST_GROUP (WaveCapture);
 IMPORT_TEST_GROUP (DoublyLinkedList);
 IMPORT_TEST_GROUP (EncapsulationProtocol);
 IMPORT_TEST_GROUP (CipString);
+IMPORT_TEST_GROUP (MotionAxis);
+IMPORT_TEST_GROUP (Encoder);
+IMPORT_TEST_GROUP (Analog);
+IMPORT_TEST_GROUP (Profiler);
+IMPORT_TEST_GROUP (Trace);
+IMPORT_TEST_GROUP (Capture);
+IMPORT_TEST_GROUP (Ccio);
+IMPORT_TEST_GROUP (SerialGateway);
+IMPORT_TEST_GROUP (NetMemory);
+IMPORT_TEST_GROUP (TraceMask);
@@ -0,0 +1,378 @@
+/*******************************************************************************
+ * Tests of the Get_Attribute_List and Set_Attribute_List services
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "ciperror.h"
+#include "cipcommon.h"
+#include "cipmessagerouter.h"
+#include "cipstring.h"
+#include "endianconv.h"
+#include "enipmessage.h"
+
+}
+
+/** @brief Vendor specific class of the tests */
+static const CipUdint kTestClassCode = 0x66U;
+
+/** @brief Attributes 1..kNumberOfUdints are UDINTs */
+#define kNumberOfUdints 40
+
+/** @brief Attribute of a CIP STRING, one of a custom encoder and one that is
+ *  not gettable */
+static const EipUint16 kStringAttribute = kNumberOfUdints + 1;
+static const EipUint16 kCustomAttribute = kNumberOfUdints + 2;
+static const EipUint16 kHiddenAttribute = kNumberOfUdints + 3;
+static const EipUint16 kHighestAttribute = kNumberOfUdints + 3;
+
+static CipUdint s_udints[kNumberOfUdints];
+static CipString s_string;
+static CipUdint s_custom[3];
+static CipUint s_hidden;
+static int s_pre_gets;
+static int s_post_gets;
+static int s_post_sets;
+
+/* InsertService() takes the service names as char * */
+static char s_get_attribute_list_name[] = "GetAttributeList";
+static char s_set_attribute_list_name[] = "SetAttributeList";
+static char s_get_attribute_single_name[] = "GetAttributeSingle";
+
+static CipMessageRouterRequest s_request;
+static CipMessageRouterResponse s_response;
+static CipOctet s_request_data[PC_OPENER_ETHERNET_BUFFER_SIZE];
+
+/** @brief Encodes a struct of three UDINTs, the list services measure it */
+static void EncodeCustom(const void *const data,
+                         ENIPMessage *const outgoing_message) {
+  const CipUdint *const values = (const CipUdint *) data;
+  for(int i = 0; i < 3; i++) {
+    AddDintToMessage(values[i], outgoing_message);
+  }
+}
+
+static EipStatus CountPreGet(CipInstance *const instance,
+                             CipAttributeStruct *const attribute,
+                             CipByte service) {
+  (void) instance;
+  (void) attribute;
+  (void) service;
+  s_pre_gets++;
+  return kEipStatusOk;
+}
+
+static EipStatus CountPostGet(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service) {
+  (void) instance;
+  (void) attribute;
+  (void) service;
+  s_post_gets++;
+  return kEipStatusOk;
+}
+
+static EipStatus CountPostSet(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service) {
+  (void) instance;
+  (void) attribute;
+  (void) service;
+  s_post_sets++;
+  return kEipStatusOk;
+}
+
+static CipInstance *TestInstance(void) {
+  return GetCipInstance(GetCipClass(kTestClassCode), 1);
+}
+
+/** @brief Starts a request of a list service, the attributes follow */
+static CipOctet *StartRequest(const CipUsint service, const CipUint count) {
+  memset(&s_request, 0, sizeof(s_request) );
+  s_request.service = service;
+  s_request.data = s_request_data;
+  CipOctet *position = s_request_data;
+  position[0] = (CipOctet) count;
+  position[1] = (CipOctet) (count >> 8);
+  return position + 2;
+}
+
+static CipOctet *AddUint(CipOctet *position, const CipUint value) {
+  position[0] = (CipOctet) value;
+  position[1] = (CipOctet) (value >> 8);
+  return position + 2;
+}
+
+static CipOctet *AddUdint(CipOctet *position, const CipUdint value) {
+  position = AddUint(position, (CipUint) value);
+  return AddUint(position, (CipUint) (value >> 16) );
+}
+
+static void Send(const CipOctet *const end) {
+  s_request.request_data_size = (size_t) (end - s_request_data);
+  memset(&s_response, 0, sizeof(s_response) );
+  if(kGetAttributeList == s_request.service) {
+    GetAttributeList(TestInstance(), &s_request, &s_response, NULL, 1);
+  } else {
+    SetAttributeList(TestInstance(), &s_request, &s_response, NULL, 1);
+  }
+}
+
+/** @brief Reads the reply, entry by entry */
+typedef struct {
+  const CipOctet *position;
+} Reply;
+
+static CipUint ReplyUint(Reply *reply) {
+  return GetUintFromMessage(&reply->position);
+}
+
+static CipUdint ReplyUdint(Reply *reply) {
+  return GetUdintFromMessage(&reply->position);
+}
+
+TEST_GROUP(CipAttributeList) {
+
+  void setup() {
+    CipClass *test_class = CreateCipClass(kTestClassCode,
+                                          0, /* # class attributes */
+                                          7, /* # highest class attribute number */
+                                          2, /* # class services */
+                                          kHighestAttribute, /* # instance attributes */
+                                          kHighestAttribute, /* # highest instance attribute number */
+                                          3, /* # instance services */
+                                          1, /* # instances */
+                                          "Attribute list test",
+                                          1, /* # class revision */
+                                          NULL /* # function pointer for initialization */
+                                          );
+    CHECK(NULL != test_class);
+    CipInstance *instance = GetCipInstance(test_class, 1);
+    for(int i = 0; i < kNumberOfUdints; i++) {
+      s_udints[i] = 0x01010101U * (CipUdint) (i + 1);
+      InsertAttribute(instance, (EipUint16) (i + 1), kCipUdint, EncodeCipUdint,
+                      (CipAttributeDecodeFromMessage)DecodeCipUdint,
+                      &s_udints[i], kSetAndGetAble | kPreGetFunc | kPostGetFunc |
+                      kPostSetFunc);
+    }
+    SetCipStringByCstr(&s_string, "abc");
+    InsertAttribute(instance, kStringAttribute, kCipString, EncodeCipString,
+                    (CipAttributeDecodeFromMessage)DecodeCipString, &s_string,
+                    kSetAndGetAble);
+    s_custom[0] = 1;
+    s_custom[1] = 2;
+    s_custom[2] = 3;
+    InsertAttribute(instance, kCustomAttribute, kCipAny, EncodeCustom, NULL,
+                    s_custom, kGetableSingle);
+    InsertAttribute(instance, kHiddenAttribute, kCipUint, EncodeCipUint,
+                    (CipAttributeDecodeFromMessage)DecodeCipUint, &s_hidden,
+                    kNotSetOrGetable);
+    InsertService(test_class, kGetAttributeList, &GetAttributeList,
+                  s_get_attribute_list_name);
+    InsertService(test_class, kSetAttributeList, &SetAttributeList,
+                  s_set_attribute_list_name);
+    InsertService(test_class, kGetAttributeSingle, &GetAttributeSingle,
+                  s_get_attribute_single_name);
+    test_class->PreGetCallback = CountPreGet;
+    test_class->PostGetCallback = CountPostGet;
+    test_class->PostSetCallback = CountPostSet;
+    s_pre_gets = 0;
+    s_post_gets = 0;
+    s_post_sets = 0;
+  }
+
+  void teardown() {
+    ClearCipString(&s_string);
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(CipAttributeList, AttributeIndexFindsEveryAttribute) {
+  CipInstance *instance = TestInstance();
+  for(EipUint16 i = 1; i <= kHighestAttribute; i++) {
+    CipAttributeStruct *attribute = GetCipAttribute(instance, i);
+    CHECK(NULL != attribute);
+    CHECK_EQUAL(i, attribute->attribute_number);
+  }
+  POINTERS_EQUAL(NULL, GetCipAttribute(instance, 0) );
+  POINTERS_EQUAL(NULL, GetCipAttribute(instance, kHighestAttribute + 1) );
+
+  /* the class attributes have an index of their own */
+  CipAttributeStruct *revision = GetCipAttribute(
+    (CipInstance *) GetCipClass(kTestClassCode), 1);
+  CHECK(NULL != revision);
+  CHECK_EQUAL(1, revision->attribute_number);
+}
+
+TEST(CipAttributeList, GetReturnsTheAttributesInRequestOrder) {
+  CipOctet *end = StartRequest(kGetAttributeList, 5);
+  end = AddUint(end, 3);
+  end = AddUint(end, kStringAttribute);
+  end = AddUint(end, kCustomAttribute);
+  end = AddUint(end, 1);
+  end = AddUint(end, kHiddenAttribute);
+  Send(end);
+
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+  Reply reply = { s_response.message.message_buffer };
+  CHECK_EQUAL(5, ReplyUint(&reply) );
+  CHECK_EQUAL(3, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(s_udints[2], ReplyUdint(&reply) );
+  CHECK_EQUAL(kStringAttribute, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(3, ReplyUint(&reply) );
+  MEMCMP_EQUAL("abc", reply.position, 3);
+  reply.position += 4; /* padded to an even position */
+  CHECK_EQUAL(kCustomAttribute, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(1, ReplyUdint(&reply) );
+  CHECK_EQUAL(2, ReplyUdint(&reply) );
+  CHECK_EQUAL(3, ReplyUdint(&reply) );
+  CHECK_EQUAL(1, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(s_udints[0], ReplyUdint(&reply) );
+  CHECK_EQUAL(kHiddenAttribute, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorAttributeNotGettable, ReplyUint(&reply) );
+  CHECK_EQUAL(reply.position - s_response.message.message_buffer,
+              s_response.message.used_message_length);
+  CHECK_EQUAL(2, s_pre_gets);
+  CHECK_EQUAL(2, s_post_gets);
+}
+
+TEST(CipAttributeList, GetOfAnUnknownAttribute) {
+  CipOctet *end = StartRequest(kGetAttributeList, 2);
+  end = AddUint(end, 99);
+  end = AddUint(end, 2);
+  Send(end);
+
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+  Reply reply = { s_response.message.message_buffer };
+  CHECK_EQUAL(2, ReplyUint(&reply) );
+  CHECK_EQUAL(99, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorAttributeNotSupported, ReplyUint(&reply) );
+  CHECK_EQUAL(2, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(s_udints[1], ReplyUdint(&reply) );
+}
+
+TEST(CipAttributeList, GetOfTooManyAttributesIsAPartialTransfer) {
+  const CipUint count = 200;
+  CipOctet *end = StartRequest(kGetAttributeList, count);
+  for(CipUint i = 0; i < count; i++) {
+    end = AddUint(end, (CipUint) (1 + i % kNumberOfUdints) );
+  }
+  Send(end);
+
+  CHECK_EQUAL(kCipErrorPartialTransfer, s_response.general_status);
+  Reply reply = { s_response.message.message_buffer };
+  const CipUint sent = ReplyUint(&reply);
+  CHECK(sent > 0 && sent < count);
+  CHECK_EQUAL(2U + 8U * sent, s_response.message.used_message_length);
+  /* the reply and the headers of the frame fit into the buffer */
+  CHECK(s_response.message.used_message_length + 50 <=
+        PC_OPENER_ETHERNET_BUFFER_SIZE);
+  CHECK(s_response.message.used_message_length + 50 + 8 >
+        PC_OPENER_ETHERNET_BUFFER_SIZE);
+  /* the entry that did not fit had its PreGet, it gets its PostGet too */
+  CHECK_EQUAL(sent + 1, s_pre_gets);
+  CHECK_EQUAL(s_pre_gets, s_post_gets);
+}
+
+TEST(CipAttributeList, GetOfATruncatedRequest) {
+  CipOctet *end = StartRequest(kGetAttributeList, 3);
+  end = AddUint(end, 1);
+  Send(end);
+  CHECK_EQUAL(kCipErrorNotEnoughData, s_response.general_status);
+  CHECK_EQUAL(0, s_response.message.used_message_length);
+
+  end = StartRequest(kGetAttributeList, 0);
+  Send(end);
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+}
+
+TEST(CipAttributeList, SetWritesTheAttributesInRequestOrder) {
+  CipOctet *end = StartRequest(kSetAttributeList, 3);
+  end = AddUint(end, 2);
+  end = AddUdint(end, 0xCAFEF00DU);
+  end = AddUint(end, kStringAttribute);
+  end = AddUint(end, 5);
+  memcpy(end, "hello", 6);
+  end += 6; /* padded */
+  end = AddUint(end, 4);
+  end = AddUdint(end, 0x12345678U);
+  Send(end);
+
+  CHECK_EQUAL(kCipErrorSuccess, s_response.general_status);
+  CHECK_EQUAL(0xCAFEF00DU, s_udints[1]);
+  CHECK_EQUAL(5, s_string.length);
+  MEMCMP_EQUAL("hello", s_string.string, 5);
+  CHECK_EQUAL(0x12345678U, s_udints[3]);
+  CHECK_EQUAL(2, s_post_sets);
+
+  Reply reply = { s_response.message.message_buffer };
+  CHECK_EQUAL(3, ReplyUint(&reply) );
+  CHECK_EQUAL(2, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(kStringAttribute, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(4, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+  CHECK_EQUAL(14, s_response.message.used_message_length);
+}
+
+TEST(CipAttributeList, SetSkipsAttributesThatAreNotSettable) {
+  CipOctet *end = StartRequest(kSetAttributeList, 2);
+  end = AddUint(end, kHiddenAttribute);
+  end = AddUint(end, 0xBEEF);
+  end = AddUint(end, 1);
+  end = AddUdint(end, 0xA5A5A5A5U);
+  Send(end);
+
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+  CHECK_EQUAL(0, s_hidden);
+  CHECK_EQUAL(0xA5A5A5A5U, s_udints[0]);
+  Reply reply = { s_response.message.message_buffer };
+  CHECK_EQUAL(2, ReplyUint(&reply) );
+  CHECK_EQUAL(kHiddenAttribute, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorAttributeNotSetable, ReplyUint(&reply) );
+  CHECK_EQUAL(1, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorSuccess, ReplyUint(&reply) );
+}
+
+TEST(CipAttributeList, SetStopsWhereTheDataCannotBeFollowed) {
+  /* the length of an unknown attribute is unknown */
+  CipOctet *end = StartRequest(kSetAttributeList, 2);
+  end = AddUint(end, 99);
+  end = AddUint(end, 0);
+  end = AddUint(end, 1);
+  end = AddUdint(end, 0xA5A5A5A5U);
+  Send(end);
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+  CHECK_EQUAL(0x01010101U, s_udints[0]);
+  Reply reply = { s_response.message.message_buffer };
+  CHECK_EQUAL(1, ReplyUint(&reply) );
+  CHECK_EQUAL(99, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorAttributeNotSupported, ReplyUint(&reply) );
+  CHECK_EQUAL(6, s_response.message.used_message_length);
+
+  /* a value cut off by the end of the request is not written */
+  end = StartRequest(kSetAttributeList, 1);
+  end = AddUint(end, 1);
+  end = AddUint(end, 0xFFFF);
+  Send(end);
+  CHECK_EQUAL(kCipErrorAttributeListError, s_response.general_status);
+  CHECK_EQUAL(0x01010101U, s_udints[0]);
+  reply.position = s_response.message.message_buffer;
+  CHECK_EQUAL(1, ReplyUint(&reply) );
+  CHECK_EQUAL(1, ReplyUint(&reply) );
+  CHECK_EQUAL(kCipErrorNotEnoughData, ReplyUint(&reply) );
+  CHECK_EQUAL(0, s_post_sets);
+}
@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * Tests of the multicast T->O production shared by several connections
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipconnectionmanager.h"
+#include "cipconnectionobject.h"
+#include "cipioconnection.h"
+#include "ciptcpipinterface.h"
+#include "cpf.h"
+#include "doublylinkedlist.h"
+#include "endianconv.h"
+#include "generic_networkhandler.h"
+
+EipStatus OpenProducingMulticastConnection(
+  CipConnectionObject *connection_object,
+  CipCommonPacketFormatData *common_packet_format_data);
+
+}
+
+/** @brief Input assembly produced to all connections */
+static const CipUdint kInputPoint = 100U;
+
+/** @brief RPI of all connections [ms] */
+static const MilliSeconds kRpi = 10U;
+
+/** @brief Any valid socket, the connections only pass it on */
+static const int kProducingSocket = 7;
+
+static const CipUdint kMulticastGroup = 0xEFC00120U; /* 239.192.1.32 */
+
+static int s_sends;
+static CipConnectionObject *s_last_sender;
+
+static EipStatus CountSend(CipConnectionObject *connection_object) {
+  s_sends++;
+  s_last_sender = connection_object;
+  connection_object->sequence_count_producing++;
+  return kEipStatusOk;
+}
+
+static void SetupConnection(CipConnectionObject *connection,
+                            ConnectionObjectInstanceType instance_type) {
+  ConnectionObjectInitializeEmpty(connection);
+  connection->instance_type = instance_type;
+  connection->produced_path.instance_id = kInputPoint;
+  /* T->O multicast */
+  connection->t_to_o_network_connection_parameters = 0x2000;
+  connection->t_to_o_requested_packet_interval = kRpi * 1000;
+  connection->expected_packet_rate = kRpi;
+  connection->transmission_trigger_timer = kRpi;
+  connection->connection_send_data_function = CountSend;
+}
+
+/** @brief Join @p connection the way a Forward Open without a T->O socket
+ *  address item does */
+static EipStatus JoinConnection(CipConnectionObject *connection,
+                                ConnectionObjectInstanceType instance_type) {
+  CipCommonPacketFormatData common_packet_format_data;
+  memset(&common_packet_format_data, 0, sizeof(common_packet_format_data) );
+  SetupConnection(connection, instance_type);
+  EipStatus status = OpenProducingMulticastConnection(connection,
+                                                      &common_packet_format_data);
+  if(kEipStatusOk == status) {
+    AddNewActiveConnection(connection);
+  }
+  return status;
+}
+
+TEST_GROUP(CipIoConnection) {
+  CipConnectionObject master;
+
+  void setup() {
+    mock().disable();
+    s_sends = 0;
+    s_last_sender = NULL;
+    g_tcpip.mcast_config.starting_multicast_address = htonl(kMulticastGroup);
+    DoublyLinkedListInitialize(&connection_list,
+                               CipConnectionObjectListArrayAllocator,
+                               CipConnectionObjectListArrayFree);
+
+    /* the first connection opened the multicast production */
+    SetupConnection(&master, kConnectionObjectInstanceTypeIOInputOnly);
+    master.socket[kUdpCommuncationDirectionProducing] = kProducingSocket;
+    master.cip_produced_connection_id = 0x1234;
+    master.remote_address.sin_family = AF_INET;
+    master.remote_address.sin_port = htons(kOpenerEipIoUdpPort);
+    master.remote_address.sin_addr.s_addr = htonl(kMulticastGroup);
+    AddNewActiveConnection(&master);
+  }
+
+  void teardown() {
+    DoublyLinkedListDestroy(&connection_list);
+    mock().enable();
+  }
+};
+
+TEST(CipIoConnection, OneTransmitServesAllConsumers) {
+  CipConnectionObject consumers[3];
+
+  LONGS_EQUAL(kEipStatusOk,
+              JoinConnection(&consumers[0],
+                             kConnectionObjectInstanceTypeIOInputOnly) );
+  LONGS_EQUAL(kEipStatusOk,
+              JoinConnection(&consumers[1],
+                             kConnectionObjectInstanceTypeIOInputOnly) );
+  LONGS_EQUAL(kEipStatusOk,
+              JoinConnection(&consumers[2],
+                             kConnectionObjectInstanceTypeIOListenOnly) );
+
+  for(int i = 0; i < 3; i++) {
+    LONGS_EQUAL(kEipInvalidSocket,
+                consumers[i].socket[kUdpCommuncationDirectionProducing]);
+    LONGS_EQUAL(0x1234, consumers[i].cip_produced_connection_id);
+    LONGS_EQUAL(htonl(kMulticastGroup),
+                consumers[i].remote_address.sin_addr.s_addr);
+    LONGS_EQUAL(htons(kOpenerEipIoUdpPort),
+                consumers[i].remote_address.sin_port);
+  }
+
+  for(int rpi = 1; rpi <= 5; rpi++) {
+    ManageConnections(kRpi);
+    LONGS_EQUAL(rpi, s_sends);
+    POINTERS_EQUAL(&master, s_last_sender);
+  }
+}
+
+TEST(CipIoConnection, ExclusiveOwnerContinuesTheStream) {
+  CipConnectionObject consumer;
+  CipConnectionObject owner;
+
+  JoinConnection(&consumer, kConnectionObjectInstanceTypeIOInputOnly);
+  ManageConnections(kRpi);
+  ManageConnections(kRpi / 2);
+  LONGS_EQUAL(1, s_sends);
+
+  LONGS_EQUAL(kEipStatusOk,
+              JoinConnection(&owner, kConnectionObjectInstanceTypeIOExclusiveOwner) );
+  LONGS_EQUAL(kProducingSocket,
+              owner.socket[kUdpCommuncationDirectionProducing]);
+  LONGS_EQUAL(kEipInvalidSocket,
+              master.socket[kUdpCommuncationDirectionProducing]);
+  LONGS_EQUAL(htons(kOpenerEipIoUdpPort), owner.remote_address.sin_port);
+  LONGS_EQUAL(master.sequence_count_producing,
+              owner.sequence_count_producing);
+
+  /* the owner takes over half way into the RPI of the master */
+  ManageConnections(kRpi / 2);
+  LONGS_EQUAL(2, s_sends);
+  POINTERS_EQUAL(&owner, s_last_sender);
+  LONGS_EQUAL(2, owner.sequence_count_producing);
+  ManageConnections(kRpi);
+  LONGS_EQUAL(3, s_sends);
+}
+
+TEST(CipIoConnection, OriginatorPortIsKept) {
+  CipConnectionObject consumer;
+  CipCommonPacketFormatData common_packet_format_data;
+  memset(&common_packet_format_data, 0, sizeof(common_packet_format_data) );
+  common_packet_format_data.address_info_item[0].type_id =
+    kCipItemIdSocketAddressInfoTargetToOriginator;
+  common_packet_format_data.address_info_item[0].sin_port = htons(2223);
+
+  SetupConnection(&consumer, kConnectionObjectInstanceTypeIOInputOnly);
+  LONGS_EQUAL(kEipStatusOk,
+              OpenProducingMulticastConnection(&consumer,
+                                               &common_packet_format_data) );
+  LONGS_EQUAL(htons(2223), consumer.remote_address.sin_port);
+  LONGS_EQUAL(htons(2223),
+              common_packet_format_data.address_info_item[0].sin_port);
+}
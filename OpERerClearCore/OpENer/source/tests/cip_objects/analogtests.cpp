@@ -0,0 +1,214 @@
+/*******************************************************************************
+ * Tests of the Analog Input Object against a mock AdcManager
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipassembly.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreAnalog/cipanalog.h"
+#include "ports/ClearCore/clearcore_analog.h"
+
+EipStatus AnalogPreGetCallback(CipInstance *const instance,
+                               CipAttributeStruct *const attribute,
+                               CipByte service);
+
+EipStatus AnalogPostSetCallback(CipInstance *const instance,
+                                CipAttributeStruct *const attribute,
+                                CipByte service);
+
+}
+
+#include "vendorobjecttest.h"
+
+/** @brief State of the mocked AdcManager */
+typedef struct {
+  ClearCoreAnalogSample sample[CLEARCORE_ANALOG_CHANNELS];
+  int enable[CLEARCORE_ANALOG_CHANNELS];
+  uint8_t oversampling[CLEARCORE_ANALOG_CHANNELS];
+  uint16_t decimation[CLEARCORE_ANALOG_CHANNELS];
+  uint16_t filter_ms[CLEARCORE_ANALOG_CHANNELS];
+  int block_mode;
+  int oversampling_accepted;
+  uint32_t block_overruns;
+} MockAdcManager;
+
+static MockAdcManager mock_adc;
+
+extern "C" {
+
+void ClearCoreAnalogSampleRead(uint8_t channel,
+                               ClearCoreAnalogSample *sample) {
+  *sample = mock_adc.sample[channel];
+}
+
+int ClearCoreAnalogEnable(uint8_t channel,
+                          int enable) {
+  mock_adc.enable[channel] = enable;
+  return 1;
+}
+
+void ClearCoreAnalogBlockMode(int enable) {
+  mock_adc.block_mode = enable;
+}
+
+int ClearCoreAnalogOversampling(uint8_t channel,
+                                uint8_t samples_log2) {
+  if (!mock_adc.oversampling_accepted) {
+    return 0;
+  }
+  mock_adc.oversampling[channel] = samples_log2;
+  return 1;
+}
+
+int ClearCoreAnalogDecimation(uint8_t channel,
+                              uint16_t samples) {
+  mock_adc.decimation[channel] = samples;
+  return 1;
+}
+
+void ClearCoreAnalogFilterMs(uint8_t channel,
+                             uint16_t filter_ms) {
+  mock_adc.filter_ms[channel] = filter_ms;
+}
+
+uint32_t ClearCoreAnalogBlockOverruns(void) {
+  return mock_adc.block_overruns;
+}
+
+}
+
+static CipInstance *AnalogInstance(CipInstanceNum instance_number) {
+  return GetCipInstance(GetCipClass(kCipAnalogClassCode), instance_number);
+}
+
+TEST_GROUP(Analog) {
+
+  void setup() {
+    memset(&mock_adc, 0, sizeof(mock_adc) );
+    mock_adc.oversampling_accepted = 1;
+    CipAnalogInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(Analog, InitAppliesDefaults) {
+  for (int channel = 0; channel < CLEARCORE_ANALOG_CHANNELS; channel++) {
+    LONGS_EQUAL(2, mock_adc.filter_ms[channel]);
+    LONGS_EQUAL(1, mock_adc.decimation[channel]);
+    CHECK(NULL != AnalogInstance(channel + 1) );
+  }
+  CHECK(NULL == AnalogInstance(CLEARCORE_ANALOG_CHANNELS + 1) );
+}
+
+TEST(Analog, ForeignAssembliesAreNotClaimed) {
+  CHECK_FALSE( CipAnalogBeforeAssemblyDataSend(100) );
+  CHECK_FALSE( CipAnalogBeforeAssemblyDataSend(kAnalogInputAssembly + 1) );
+}
+
+TEST(Analog, InputAssemblyPacksScaledValues) {
+  mock_adc.sample[0].analog = 1;
+  mock_adc.sample[0].filtered = 16384;
+  mock_adc.sample[0].timestamp_us = 0x11223344U;
+  mock_adc.sample[3].analog = 1;
+  mock_adc.sample[3].decimated = 32767;
+  mock_adc.sample[3].decimated_timestamp_us = 0x55667788U;
+  mock_adc.block_overruns = 0x1FF;
+
+  /* Channel 3 reports its decimated value */
+  CipAttributeStruct *assembly_value = GetCipAttribute(AnalogInstance(4), 11);
+  *(CipUsint *) assembly_value->data = kAnalogAssemblyDecimated;
+
+  CHECK_TRUE( CipAnalogBeforeAssemblyDataSend(kAnalogInputAssembly) );
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipAssemblyClassCode),
+                                         kAnalogInputAssembly);
+  const CipByteArray *const assembly =
+    (CipByteArray *) GetCipAttribute(instance, 3)->data;
+  const CipOctet expected[CIP_ANALOG_INPUT_ASSEMBLY_SIZE] = {
+    0x88, 0x13, 0x00, 0x00, 0x44, 0x33, 0x22, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0F, 0x27, 0x00, 0x00, 0x88, 0x77, 0x66, 0x55,
+    0x09, 0xFF, 0x00, 0x00
+  };
+  LONGS_EQUAL(sizeof(expected), assembly->length);
+  MEMCMP_EQUAL(expected, assembly->data, sizeof(expected) );
+}
+
+TEST(Analog, ScaleAndOffsetApply) {
+  CipInstance *instance = AnalogInstance(2);
+  *(CipDint *) GetCipAttribute(instance, 9)->data = -20000;
+  *(CipDint *) GetCipAttribute(instance, 10)->data = 100;
+  mock_adc.sample[1].filtered = 8192;
+
+  CipAttributeStruct *value = GetCipAttribute(instance, 2);
+  AnalogPreGetCallback(instance, value, kGetAttributeSingle);
+  LONGS_EQUAL(100 - 5000, *(CipDint *) value->data);
+}
+
+TEST(Analog, OversamplingIsAppliedOnDecode) {
+  CipMessageRouterResponse response;
+  CipAttributeStruct *oversampling = GetCipAttribute(AnalogInstance(3), 7);
+
+  const CipOctet too_high[] = { CLEARCORE_ANALOG_OVERSAMPLING_MAX + 1 };
+  CHECK(DecodeAttribute(oversampling, too_high, sizeof(too_high),
+                        &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+
+  const CipOctet four[] = { 2 };
+  LONGS_EQUAL(1, DecodeAttribute(oversampling, four, sizeof(four),
+                                 &response) );
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(2, mock_adc.oversampling[2]);
+  LONGS_EQUAL(2, *(CipUsint *) oversampling->data);
+
+  /* Over the conversion budget of the sample time */
+  mock_adc.oversampling_accepted = 0;
+  const CipOctet sixteen[] = { 4 };
+  CHECK(DecodeAttribute(oversampling, sixteen, sizeof(sixteen),
+                        &response) < 0);
+  LONGS_EQUAL(kCipErrorObjectStateConflict, response.general_status);
+  LONGS_EQUAL(2, *(CipUsint *) oversampling->data);
+}
+
+TEST(Analog, DecimationIsValidated) {
+  CipMessageRouterResponse response;
+  CipAttributeStruct *decimation = GetCipAttribute(AnalogInstance(1), 8);
+
+  const CipOctet zero[] = { 0, 0 };
+  CHECK(DecodeAttribute(decimation, zero, sizeof(zero), &response) < 0);
+  const CipOctet too_long[] = { 0x01, 0x04 };
+  CHECK(DecodeAttribute(decimation, too_long, sizeof(too_long),
+                        &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+
+  const CipOctet longest[] = { 0x00, 0x04 };
+  LONGS_EQUAL(2, DecodeAttribute(decimation, longest, sizeof(longest),
+                                 &response) );
+  AnalogPostSetCallback(AnalogInstance(1), decimation, kSetAttributeSingle);
+  LONGS_EQUAL(1024, mock_adc.decimation[0]);
+}
+
+TEST(Analog, SetAttributesArePushedToTheAdc) {
+  CipInstance *instance = AnalogInstance(4);
+  CipAttributeStruct *analog = GetCipAttribute(instance, 1);
+  *(CipBool *) analog->data = 1;
+  AnalogPostSetCallback(instance, analog, kSetAttributeSingle);
+  LONGS_EQUAL(1, mock_adc.enable[3]);
+
+  CipAttributeStruct *filter_ms = GetCipAttribute(instance, 6);
+  *(CipUint *) filter_ms->data = 50;
+  AnalogPostSetCallback(instance, filter_ms, kSetAttributeSingle);
+  LONGS_EQUAL(50, mock_adc.filter_ms[3]);
+}
@@ -0,0 +1,248 @@
+/*******************************************************************************
+ * Tests of the Waveform Capture Object against a capture on a RAM card
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreCapture/cipcapture.h"
+#include "ports/ClearCore/clearcore_capture.h"
+
+EipStatus CapturePreGetCallback(CipInstance *const instance,
+                                CipAttributeStruct *const attribute,
+                                CipByte service);
+
+EipStatus CaptureArm(CipInstance *RESTRICT const instance,
+                     CipMessageRouterRequest *const message_router_request,
+                     CipMessageRouterResponse *const message_router_response,
+                     const struct sockaddr *originator_address,
+                     const CipSessionHandle encapsulation_session);
+
+EipStatus CaptureStop(CipInstance *RESTRICT const instance,
+                      CipMessageRouterRequest *const message_router_request,
+                      CipMessageRouterResponse *const message_router_response,
+                      const struct sockaddr *originator_address,
+                      const CipSessionHandle encapsulation_session);
+
+}
+
+#include "vendorobjecttest.h"
+
+static const uint32_t kCardBlocks = 16;
+
+/** @brief State of the mocked SD card and capture glue */
+typedef struct {
+  uint8_t blocks[kCardBlocks][kWaveCaptureBlockSize];
+  uint32_t next_block;
+  bool card_present;
+  unsigned long init_count;
+  WaveCaptureDevice device;
+  WaveCapture capture;
+  bool initialized;
+} MockCapture;
+
+static MockCapture mock_capture;
+
+static int RamBegin(void *context,
+                    uint32_t block,
+                    uint32_t count) {
+  (void)context;
+  (void)count;
+  mock_capture.next_block = block;
+  return 0;
+}
+
+static int RamWrite(void *context,
+                    const void *data,
+                    uint32_t count) {
+  (void)context;
+  memcpy(mock_capture.blocks[mock_capture.next_block], data,
+         count * kWaveCaptureBlockSize);
+  mock_capture.next_block += count;
+  return 0;
+}
+
+static int RamEnd(void *context) {
+  (void)context;
+  return 0;
+}
+
+extern "C" {
+
+WaveCapture *ClearCoreCaptureInit(void) {
+  mock_capture.init_count++;
+  if (!mock_capture.card_present) {
+    return NULL;
+  }
+  if (!mock_capture.initialized) {
+    mock_capture.device.block_count = kCardBlocks;
+    mock_capture.device.begin = RamBegin;
+    mock_capture.device.write_blocks = RamWrite;
+    mock_capture.device.end = RamEnd;
+    WaveCaptureInit(&mock_capture.capture, &mock_capture.device, 200);
+    mock_capture.initialized = true;
+  }
+  return &mock_capture.capture;
+}
+
+WaveCapture *ClearCoreCapture(void) {
+  return mock_capture.initialized ? &mock_capture.capture : NULL;
+}
+
+void ClearCoreCapturePoll(void) {
+}
+
+}
+
+static CipInstance *CaptureInstance(void) {
+  return GetCipInstance(GetCipClass(kCipCaptureClassCode), 1);
+}
+
+static CipUsint CallService(CipUsint service) {
+  CipMessageRouterRequest request;
+  CipMessageRouterResponse response;
+  memset(&request, 0, sizeof(request) );
+  memset(&response, 0, sizeof(response) );
+  request.service = service;
+  if (kCaptureServiceArm == service) {
+    CaptureArm(CaptureInstance(), &request, &response, NULL, 0);
+  } else {
+    CaptureStop(CaptureInstance(), &request, &response, NULL, 0);
+  }
+  LONGS_EQUAL(0x80 | service, response.reply_service);
+  return response.general_status;
+}
+
+static CipUdint LiveUdint(CipUint attribute_number) {
+  CipAttributeStruct *attribute = GetCipAttribute(CaptureInstance(),
+                                                  attribute_number);
+  CapturePreGetCallback(CaptureInstance(), attribute, kGetAttributeSingle);
+  if (kCipUsint == attribute->type) {
+    return *(CipUsint *)attribute->data;
+  }
+  if (kCipUint == attribute->type) {
+    return *(CipUint *)attribute->data;
+  }
+  return *(CipUdint *)attribute->data;
+}
+
+TEST_GROUP(Capture) {
+
+  void setup() {
+    memset(&mock_capture, 0, sizeof(mock_capture) );
+    mock_capture.card_present = true;
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(Capture, InitFindsTheCard) {
+  LONGS_EQUAL( kEipStatusOk, CipCaptureInit() );
+  LONGS_EQUAL(1, mock_capture.init_count);
+  LONGS_EQUAL(kCardBlocks, LiveUdint(13) );
+  LONGS_EQUAL(kWaveCaptureIdle, LiveUdint(1) );
+  LONGS_EQUAL(kWaveSignalPosition | kWaveSignalInputs, LiveUdint(2) );
+  LONGS_EQUAL(1, LiveUdint(6) );
+}
+
+TEST(Capture, ArmWithoutCardLooksAgain) {
+  mock_capture.card_present = false;
+  LONGS_EQUAL( kEipStatusOk, CipCaptureInit() );
+  LONGS_EQUAL(0, LiveUdint(13) );
+  LONGS_EQUAL( kCipErrorObjectStateConflict,
+               CallService(kCaptureServiceArm) );
+  LONGS_EQUAL(2, mock_capture.init_count);
+
+  mock_capture.card_present = true;
+  LONGS_EQUAL( kCipErrorSuccess, CallService(kCaptureServiceArm) );
+  LONGS_EQUAL(kWaveCaptureArmed, LiveUdint(1) );
+  LONGS_EQUAL(kCardBlocks, LiveUdint(13) );
+}
+
+TEST(Capture, ArmUsesTheAttributesAndRejectsBusy) {
+  CipCaptureInit();
+  CipInstance *instance = CaptureInstance();
+  *(CipUdint *)GetCipAttribute(instance, 5)->data = 3;
+  *(CipUdint *)GetCipAttribute(instance, 7)->data = 4;
+  *(CipUdint *)GetCipAttribute(instance, 8)->data = 2;
+
+  LONGS_EQUAL( kCipErrorSuccess, CallService(kCaptureServiceArm) );
+  LONGS_EQUAL(1, LiveUdint(12) );
+  LONGS_EQUAL(4, mock_capture.capture.config.first_block);
+  LONGS_EQUAL(3, mock_capture.capture.config.samples);
+  LONGS_EQUAL( kCipErrorObjectStateConflict,
+               CallService(kCaptureServiceArm) );
+
+  WaveCaptureValues values;
+  memset(&values, 0, sizeof(values) );
+  for (int i = 0; i < 3; i++) {
+    WaveCaptureSample(&mock_capture.capture, &values);
+  }
+  WaveCapturePoll(&mock_capture.capture);
+  LONGS_EQUAL(kWaveCaptureDone, LiveUdint(1) );
+  LONGS_EQUAL(3, LiveUdint(9) );
+  LONGS_EQUAL(1, LiveUdint(11) );
+  LONGS_EQUAL( kWaveCaptureBlockMagic,
+               mock_capture.blocks[5][0] | mock_capture.blocks[5][1] << 8);
+}
+
+TEST(Capture, RegionBeyondTheCardIsRejected) {
+  CipCaptureInit();
+  *(CipUdint *)GetCipAttribute(CaptureInstance(), 7)->data = kCardBlocks - 1;
+  LONGS_EQUAL( kCipErrorObjectStateConflict,
+               CallService(kCaptureServiceArm) );
+  LONGS_EQUAL(kWaveCaptureIdle, LiveUdint(1) );
+}
+
+TEST(Capture, StopEndsTheCapture) {
+  CipCaptureInit();
+  LONGS_EQUAL( kCipErrorSuccess, CallService(kCaptureServiceArm) );
+  LONGS_EQUAL( kCipErrorSuccess, CallService(kCaptureServiceStop) );
+  WaveCaptureValues values;
+  memset(&values, 0, sizeof(values) );
+  WaveCaptureSample(&mock_capture.capture, &values);
+  WaveCapturePoll(&mock_capture.capture);
+  LONGS_EQUAL(kWaveCaptureDone, LiveUdint(1) );
+}
+
+TEST(Capture, SettingsAreValidated) {
+  CipCaptureInit();
+  CipMessageRouterResponse response;
+  CipInstance *instance = CaptureInstance();
+
+  const CipOctet no_signals[] = { 0, 0, 0, 0 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 2), no_signals,
+                        sizeof(no_signals), &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+  const CipOctet unknown_signal[] = { 0, 0x20, 0, 0 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 2), unknown_signal,
+                        sizeof(unknown_signal), &response) < 0);
+  const CipOctet all_signals[] = { 0xFF, 0x1F, 0, 0 };
+  LONGS_EQUAL(4, DecodeAttribute(GetCipAttribute(instance, 2), all_signals,
+                                 sizeof(all_signals), &response) );
+  LONGS_EQUAL(kWaveSignalAll, LiveUdint(2) );
+
+  const CipOctet bad_trigger[] = { kWaveTriggerChange + 1 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 3), bad_trigger,
+                        sizeof(bad_trigger), &response) < 0);
+  const CipOctet bad_input[] = { 18 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 4), bad_input,
+                        sizeof(bad_input), &response) < 0);
+  const CipOctet hlfb_m3[] = { 17 };
+  LONGS_EQUAL(1, DecodeAttribute(GetCipAttribute(instance, 4), hlfb_m3,
+                                 sizeof(hlfb_m3), &response) );
+  const CipOctet no_decimation[] = { 0, 0 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 6), no_decimation,
+                        sizeof(no_decimation), &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+}
@@ -0,0 +1,291 @@
+/*******************************************************************************
+ * Tests of the CCIO-8 Object against a mock CcioBoardManager
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipassembly.h"
+#include "cipconnectionmanager.h"
+#include "cipconnectionobject.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "doublylinkedlist.h"
+#include "cip_objects/ClearCoreCcio/cipccio.h"
+#include "ports/ClearCore/clearcore_ccio.h"
+
+EipStatus CcioPreGetCallback(CipInstance *const instance,
+                             CipAttributeStruct *const attribute,
+                             CipByte service);
+
+EipStatus CcioPostSetCallback(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service);
+
+}
+
+#include "vendorobjecttest.h"
+
+/** @brief State of the mocked CcioBoardManager */
+typedef struct {
+  ClearCoreCcioSample sample;
+  uint64_t risen;
+  uint64_t fallen;
+  uint64_t output_pins;
+  uint64_t written_outputs;
+  uint64_t written_mask;
+  int writes;
+  uint8_t port;
+  int port_accepted;
+  int rediscover;
+} MockCcioManager;
+
+static MockCcioManager mock_ccio;
+
+extern "C" {
+
+void ClearCoreCcioSampleRead(ClearCoreCcioSample *sample) {
+  *sample = mock_ccio.sample;
+}
+
+void ClearCoreCcioEdgesRead(uint64_t *risen,
+                            uint64_t *fallen) {
+  /* Cleared on read like InputsRisen() and InputsFallen() */
+  *risen = mock_ccio.risen;
+  *fallen = mock_ccio.fallen;
+  mock_ccio.risen = 0;
+  mock_ccio.fallen = 0;
+}
+
+int ClearCoreCcioLinkOpen(uint8_t port) {
+  if (!mock_ccio.port_accepted) {
+    return 0;
+  }
+  mock_ccio.port = port;
+  return 1;
+}
+
+void ClearCoreCcioOutputPins(uint64_t pins) {
+  mock_ccio.output_pins = pins;
+}
+
+void ClearCoreCcioOutputsWrite(uint64_t outputs,
+                               uint64_t mask) {
+  mock_ccio.written_outputs = outputs;
+  mock_ccio.written_mask = mask;
+  mock_ccio.writes++;
+}
+
+void ClearCoreCcioRediscover(int enable) {
+  mock_ccio.rediscover = enable;
+}
+
+}
+
+static CipInstance *CcioInstance(void) {
+  return GetCipInstance(GetCipClass(kCipCcioClassCode), 1);
+}
+
+static CipByteArray *AssemblyData(CipInstanceNum instance_number) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipAssemblyClassCode),
+                                         instance_number);
+  return (CipByteArray *) GetCipAttribute(instance, 3)->data;
+}
+
+TEST_GROUP(Ccio) {
+
+  void setup() {
+    memset(&mock_ccio, 0, sizeof(mock_ccio) );
+    mock_ccio.port_accepted = 1;
+    CipCcioInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(Ccio, InitCreatesInstanceAndAssemblies) {
+  CHECK(NULL != CcioInstance() );
+  LONGS_EQUAL(CIP_CCIO_INPUT_ASSEMBLY_SIZE,
+              AssemblyData(kCcioInputAssembly)->length);
+  LONGS_EQUAL(CIP_CCIO_OUTPUT_ASSEMBLY_SIZE,
+              AssemblyData(kCcioOutputAssembly)->length);
+  /* The link stays closed unless CLEARCORE_CCIO_PORT opens it */
+  LONGS_EQUAL(0, *(CipUsint *) GetCipAttribute(CcioInstance(), 1)->data);
+}
+
+TEST(Ccio, ForeignAssembliesAreNotClaimed) {
+  CHECK_FALSE( CipCcioBeforeAssemblyDataSend(kCcioOutputAssembly) );
+  CHECK_FALSE( CipCcioBeforeAssemblyDataSend(121) );
+  CHECK_FALSE( CipCcioAfterAssemblyDataReceived(kCcioInputAssembly) );
+  CHECK_FALSE( CipCcioAfterAssemblyDataReceived(150) );
+}
+
+TEST(Ccio, InputAssemblyPacksAllBoards) {
+  mock_ccio.sample.inputs = 0x8877665544332211ULL;
+  mock_ccio.sample.overloaded = 0x8000000000000001ULL;
+  mock_ccio.sample.boards = 8;
+  mock_ccio.sample.link_broken = 1;
+  mock_ccio.sample.refresh_overruns = 0x12345;
+  mock_ccio.risen = 0x0100000000000000ULL;
+  mock_ccio.fallen = 0x02;
+  CipMessageRouterResponse response;
+  const CipOctet com0[] = { kClearCoreCcioPortCom0 };
+  LONGS_EQUAL(1, DecodeAttribute(GetCipAttribute(CcioInstance(), 1), com0,
+                                 sizeof(com0), &response) );
+
+  CHECK_TRUE( CipCcioBeforeAssemblyDataSend(kCcioInputAssembly) );
+  const CipOctet expected[CIP_CCIO_INPUT_ASSEMBLY_SIZE] = {
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x08, kCcioStatusLinkOpen | kCcioStatusLinkBroken, 0x45, 0x23
+  };
+  const CipByteArray *const assembly = AssemblyData(kCcioInputAssembly);
+  MEMCMP_EQUAL(expected, assembly->data, sizeof(expected) );
+
+  /* The edges are reported once */
+  CHECK_TRUE( CipCcioBeforeAssemblyDataSend(kCcioInputAssembly) );
+  for (int i = 8; i < 24; i++) {
+    LONGS_EQUAL(0, assembly->data[i]);
+  }
+}
+
+TEST(Ccio, EdgesAccumulateUntilProduced) {
+  CipMessageRouterResponse response;
+  const CipOctet com1[] = { kClearCoreCcioPortCom1 };
+  DecodeAttribute(GetCipAttribute(CcioInstance(), 1), com1, sizeof(com1),
+                  &response);
+
+  mock_ccio.risen = 0x01;
+  CipCcioHandleApplication();
+  mock_ccio.risen = 0x10;
+  mock_ccio.fallen = 0x01;
+  CipCcioHandleApplication();
+
+  CHECK_TRUE( CipCcioBeforeAssemblyDataSend(kCcioInputAssembly) );
+  const CipByteArray *const assembly = AssemblyData(kCcioInputAssembly);
+  LONGS_EQUAL(0x11, assembly->data[8]);
+  LONGS_EQUAL(0x01, assembly->data[16]);
+}
+
+TEST(Ccio, OutputAssemblyWritesOutputPinsOnly) {
+  CipInstance *instance = CcioInstance();
+  CipAttributeStruct *pins = GetCipAttribute(instance, 6);
+  *(CipLword *) pins->data = 0x00FF00000000000FULL;
+  CcioPostSetCallback(instance, pins, kSetAttributeSingle);
+  CHECK_EQUAL(0x00FF00000000000FULL, mock_ccio.output_pins);
+
+  CipByteArray *const assembly = AssemblyData(kCcioOutputAssembly);
+  const CipOctet outputs[CIP_CCIO_OUTPUT_ASSEMBLY_SIZE] = {
+    0xA5, 0, 0, 0, 0, 0, 0x3C, 0xFF
+  };
+  memcpy(assembly->data, outputs, sizeof(outputs) );
+  CHECK_TRUE( CipCcioAfterAssemblyDataReceived(kCcioOutputAssembly) );
+  CHECK_EQUAL(0xFF3C0000000000A5ULL, mock_ccio.written_outputs);
+  CHECK_EQUAL(0x00FF00000000000FULL, mock_ccio.written_mask);
+}
+
+TEST(Ccio, OutputsAttributeIsWritten) {
+  CipInstance *instance = CcioInstance();
+  *(CipLword *) GetCipAttribute(instance, 6)->data = 0xF0;
+  CipAttributeStruct *outputs = GetCipAttribute(instance, 5);
+  *(CipLword *) outputs->data = 0x3C;
+  CcioPostSetCallback(instance, outputs, kSetAttributeSingle);
+  CHECK_EQUAL(0x3C, mock_ccio.written_outputs);
+  CHECK_EQUAL(0xF0, mock_ccio.written_mask);
+
+  mock_ccio.sample.outputs = 0x30;
+  mock_ccio.sample.refresh_overruns = 7;
+  CcioPreGetCallback(instance, outputs, kGetAttributeSingle);
+  CHECK_EQUAL(0x30, *(CipLword *) outputs->data);
+  LONGS_EQUAL(7, *(CipUdint *) GetCipAttribute(instance, 8)->data);
+}
+
+TEST(Ccio, PortIsValidatedAndOpenedOnDecode) {
+  CipMessageRouterResponse response;
+  CipAttributeStruct *port = GetCipAttribute(CcioInstance(), 1);
+
+  const CipOctet invalid[] = { 3 };
+  CHECK(DecodeAttribute(port, invalid, sizeof(invalid), &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+
+  mock_ccio.port_accepted = 0;
+  const CipOctet com0[] = { kClearCoreCcioPortCom0 };
+  CHECK(DecodeAttribute(port, com0, sizeof(com0), &response) < 0);
+  LONGS_EQUAL(kCipErrorObjectStateConflict, response.general_status);
+  LONGS_EQUAL(0, *(CipUsint *) port->data);
+
+  mock_ccio.port_accepted = 1;
+  LONGS_EQUAL(1, DecodeAttribute(port, com0, sizeof(com0), &response) );
+  LONGS_EQUAL(kClearCoreCcioPortCom0, mock_ccio.port);
+  LONGS_EQUAL(kClearCoreCcioPortCom0, *(CipUsint *) port->data);
+}
+
+TEST(Ccio, RediscoverIsPushed) {
+  CipInstance *instance = CcioInstance();
+  CipAttributeStruct *rediscover = GetCipAttribute(instance, 9);
+  LONGS_EQUAL(1, *(CipBool *) rediscover->data);
+  *(CipBool *) rediscover->data = 0;
+  CcioPostSetCallback(instance, rediscover, kSetAttributeSingle);
+  LONGS_EQUAL(0, mock_ccio.rediscover);
+}
+
+TEST(Ccio, ChangeOfStateTriggersTheConnectionOnce) {
+  DoublyLinkedListInitialize(&connection_list,
+                             CipConnectionObjectListArrayAllocator,
+                             CipConnectionObjectListArrayFree);
+  CipConnectionObject connection;
+  memset(&connection, 0, sizeof(connection) );
+  connection.consumed_path.instance_id = kCcioOutputAssembly;
+  connection.produced_path.instance_id = kCcioInputAssembly;
+  /* Class 1, change of state */
+  connection.transport_class_trigger = 0x11;
+  connection.production_inhibit_time = 5;
+  connection.transmission_trigger_timer = 100;
+  AddNewActiveConnection(&connection);
+
+  CipMessageRouterResponse response;
+  const CipOctet com0[] = { kClearCoreCcioPortCom0 };
+  DecodeAttribute(GetCipAttribute(CcioInstance(), 1), com0, sizeof(com0),
+                  &response);
+  *(CipLword *) GetCipAttribute(CcioInstance(), 10)->data = 0x0F;
+
+  /* Edges outside of the mask do not produce */
+  mock_ccio.risen = 0x10;
+  CipCcioHandleApplication();
+  LONGS_EQUAL(100, connection.transmission_trigger_timer);
+
+  mock_ccio.fallen = 0x04;
+  CipCcioHandleApplication();
+  LONGS_EQUAL(5, connection.transmission_trigger_timer);
+
+  /* Not again before the assembly was produced */
+  connection.transmission_trigger_timer = 50;
+  mock_ccio.risen = 0x01;
+  CipCcioHandleApplication();
+  LONGS_EQUAL(50, connection.transmission_trigger_timer);
+
+  CipCcioBeforeAssemblyDataSend(kCcioInputAssembly);
+  mock_ccio.risen = 0x02;
+  CipCcioHandleApplication();
+  LONGS_EQUAL(5, connection.transmission_trigger_timer);
+
+  /* A cyclic connection is left to its RPI */
+  connection.transport_class_trigger = 0x01;
+  connection.transmission_trigger_timer = 80;
+  CipCcioBeforeAssemblyDataSend(kCcioInputAssembly);
+  mock_ccio.risen = 0x02;
+  CipCcioHandleApplication();
+  LONGS_EQUAL(80, connection.transmission_trigger_timer);
+
+  RemoveFromActiveConnections(&connection);
+}
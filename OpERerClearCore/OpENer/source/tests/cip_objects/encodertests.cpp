@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * Tests of the Encoder Object against a mock EncoderInput
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipassembly.h"
+#include "endianconv.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreEncoder/cipencoder.h"
+#include "ports/ClearCore/clearcore_encoder.h"
+
+EipStatus EncoderArmLatch(CipInstance *RESTRICT const instance,
+                          CipMessageRouterRequest *const message_router_request,
+                          CipMessageRouterResponse *const message_router_response,
+                          const struct sockaddr *originator_address,
+                          const CipSessionHandle encapsulation_session);
+
+EipStatus EncoderPostSetCallback(CipInstance *const instance,
+                                 CipAttributeStruct *const attribute,
+                                 CipByte service);
+
+}
+
+/** @brief State of the mocked EncoderInput */
+typedef struct {
+  ClearCoreEncoderSample sample;
+  int enable;
+  int32_t position_set;
+  uint16_t filter_ms;
+  uint8_t latch_pin;
+  uint8_t latch_trigger;
+  int latch_accepted;
+  unsigned int latch_arm_calls;
+  unsigned int latch_disarm_calls;
+  unsigned int clear_quadrature_error_calls;
+  unsigned int position_set_calls;
+  unsigned int sample_reads;
+} MockEncoderInput;
+
+static MockEncoderInput mock_encoder;
+
+extern "C" {
+
+void ClearCoreEncoderSampleRead(ClearCoreEncoderSample *sample) {
+  mock_encoder.sample_reads++;
+  *sample = mock_encoder.sample;
+}
+
+void ClearCoreEncoderEnable(int enable) {
+  mock_encoder.enable = enable;
+}
+
+void ClearCoreEncoderPositionSet(int32_t position) {
+  mock_encoder.position_set_calls++;
+  mock_encoder.position_set = position;
+}
+
+void ClearCoreEncoderClearQuadratureError(void) {
+  mock_encoder.clear_quadrature_error_calls++;
+  mock_encoder.sample.quadrature_error = 0;
+}
+
+void ClearCoreEncoderVelocityFilterMs(uint16_t filter_ms) {
+  mock_encoder.filter_ms = filter_ms;
+}
+
+int ClearCoreEncoderLatchArm(uint8_t pin,
+                             uint8_t trigger) {
+  mock_encoder.latch_arm_calls++;
+  mock_encoder.latch_pin = pin;
+  mock_encoder.latch_trigger = trigger;
+  return mock_encoder.latch_accepted;
+}
+
+void ClearCoreEncoderLatchDisarm(void) {
+  mock_encoder.latch_disarm_calls++;
+}
+
+}
+
+static CipInstance *EncoderInstance(void) {
+  return GetCipInstance(GetCipClass(kCipEncoderClassCode), 1);
+}
+
+static void ArmLatch(const CipOctet *data,
+                     size_t size,
+                     CipMessageRouterResponse *response) {
+  CipMessageRouterRequest request;
+  memset(&request, 0, sizeof(request) );
+  memset(response, 0, sizeof(*response) );
+  request.service = kEncoderServiceArmLatch;
+  request.data = data;
+  request.request_data_size = size;
+  EncoderArmLatch(EncoderInstance(), &request, response, NULL, 0);
+}
+
+TEST_GROUP(Encoder) {
+
+  void setup() {
+    memset(&mock_encoder, 0, sizeof(mock_encoder) );
+    mock_encoder.latch_accepted = 1;
+    CipEncoderInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(Encoder, InitAppliesDefaultFilter) {
+  LONGS_EQUAL(10, mock_encoder.filter_ms);
+  LONGS_EQUAL(0, mock_encoder.enable);
+  CHECK(NULL != EncoderInstance() );
+}
+
+TEST(Encoder, ForeignAssembliesAreNotClaimed) {
+  CHECK_FALSE( CipEncoderBeforeAssemblyDataSend(100) );
+  CHECK_FALSE( CipEncoderBeforeAssemblyDataSend(kEncoderInputAssembly + 1) );
+  LONGS_EQUAL(0, mock_encoder.sample_reads);
+}
+
+TEST(Encoder, InputAssemblyPacksSample) {
+  mock_encoder.sample.timestamp_us = 0x11223344U;
+  mock_encoder.sample.position = -2;
+  mock_encoder.sample.velocity = 0x01020304;
+  mock_encoder.sample.index_position = 1000;
+  mock_encoder.sample.latch_position = -1000;
+  mock_encoder.sample.latch_timestamp_us = 0x11223300U;
+  mock_encoder.sample.latch_count = 0x1FF;
+  mock_encoder.sample.latch_armed = 1;
+  mock_encoder.sample.quadrature_error = 1;
+
+  CHECK_TRUE( CipEncoderBeforeAssemblyDataSend(kEncoderInputAssembly) );
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipAssemblyClassCode),
+                                         kEncoderInputAssembly);
+  const CipByteArray *const assembly =
+    (CipByteArray *) GetCipAttribute(instance, 3)->data;
+  const CipOctet expected[CIP_ENCODER_INPUT_ASSEMBLY_SIZE] = {
+    0x44, 0x33, 0x22, 0x11,
+    0xFE, 0xFF, 0xFF, 0xFF,
+    0x04, 0x03, 0x02, 0x01,
+    0xE8, 0x03, 0x00, 0x00,
+    0x18, 0xFC, 0xFF, 0xFF,
+    0x00, 0x33, 0x22, 0x11,
+    kEncoderStatusQuadratureError | kEncoderStatusLatchArmed, 0xFF,
+    0x00, 0x00
+  };
+  LONGS_EQUAL(sizeof(expected), assembly->length);
+  MEMCMP_EQUAL(expected, assembly->data, sizeof(expected) );
+}
+
+TEST(Encoder, ArmLatchUsesAttributeDefaults) {
+  CipMessageRouterResponse response;
+  ArmLatch(NULL, 0, &response);
+  LONGS_EQUAL(0x80 | kEncoderServiceArmLatch, response.reply_service);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(1, mock_encoder.latch_arm_calls);
+  LONGS_EQUAL(9, mock_encoder.latch_pin);
+  LONGS_EQUAL(kClearCoreEncoderLatchRising, mock_encoder.latch_trigger);
+}
+
+TEST(Encoder, ArmLatchValidatesParameters) {
+  CipMessageRouterResponse response;
+  const CipOctet bad_pin[] = { 5 };
+  ArmLatch(bad_pin, sizeof(bad_pin), &response);
+  LONGS_EQUAL(kCipErrorInvalidParameter, response.general_status);
+
+  const CipOctet bad_trigger[] = { 10, 1 };
+  ArmLatch(bad_trigger, sizeof(bad_trigger), &response);
+  LONGS_EQUAL(kCipErrorInvalidParameter, response.general_status);
+
+  const CipOctet too_much[] = { 10, 3, 0 };
+  ArmLatch(too_much, sizeof(too_much), &response);
+  LONGS_EQUAL(kCipErrorTooMuchData, response.general_status);
+  LONGS_EQUAL(0, mock_encoder.latch_arm_calls);
+
+  const CipOctet falling_a10[] = { 10, kClearCoreEncoderLatchFalling };
+  ArmLatch(falling_a10, sizeof(falling_a10), &response);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(10, mock_encoder.latch_pin);
+  LONGS_EQUAL(kClearCoreEncoderLatchFalling, mock_encoder.latch_trigger);
+
+  /* The accepted parameters become the new defaults */
+  ArmLatch(NULL, 0, &response);
+  LONGS_EQUAL(10, mock_encoder.latch_pin);
+  LONGS_EQUAL(kClearCoreEncoderLatchFalling, mock_encoder.latch_trigger);
+}
+
+TEST(Encoder, ArmLatchReportsRejection) {
+  CipMessageRouterResponse response;
+  mock_encoder.latch_accepted = 0;
+  ArmLatch(NULL, 0, &response);
+  LONGS_EQUAL(kCipErrorObjectStateConflict, response.general_status);
+}
+
+TEST(Encoder, SetAttributesArePushedToTheEncoder) {
+  CipInstance *instance = EncoderInstance();
+  CipAttributeStruct *position = GetCipAttribute(instance, 1);
+  *(CipDint *) position->data = 4096;
+  EncoderPostSetCallback(instance, position, kSetAttributeSingle);
+  LONGS_EQUAL(1, mock_encoder.position_set_calls);
+  LONGS_EQUAL(4096, mock_encoder.position_set);
+
+  CipAttributeStruct *enable = GetCipAttribute(instance, 10);
+  *(CipBool *) enable->data = 1;
+  EncoderPostSetCallback(instance, enable, kSetAttributeSingle);
+  LONGS_EQUAL(1, mock_encoder.enable);
+}
@@ -0,0 +1,370 @@
+/*******************************************************************************
+ * Tests of the Motion Axis Object against a mock MotorDriver
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipassembly.h"
+#include "endianconv.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreMotionAxis/cipmotionaxis.h"
+#include "ports/ClearCore/clearcore_motion.h"
+
+EipStatus MotionAxisMove(CipInstance *RESTRICT const instance,
+                         CipMessageRouterRequest *const message_router_request,
+                         CipMessageRouterResponse *const message_router_response,
+                         const struct sockaddr *originator_address,
+                         const CipSessionHandle encapsulation_session);
+
+EipStatus MotionAxisEnable(CipInstance *RESTRICT const instance,
+                           CipMessageRouterRequest *const message_router_request,
+                           CipMessageRouterResponse *const message_router_response,
+                           const struct sockaddr *originator_address,
+                           const CipSessionHandle encapsulation_session);
+
+EipStatus MotionAxisPreGetCallback(CipInstance *const instance,
+                                   CipAttributeStruct *const attribute,
+                                   CipByte service);
+
+}
+
+/** @brief State of one mocked MotorDriver connector */
+typedef struct {
+  ClearCoreMotorSample sample;
+  uint32_t vel_max;
+  uint32_t accel_max;
+  uint32_t estop_decel_max;
+  int32_t last_distance;
+  int last_absolute;
+  int32_t last_velocity;
+  int move_accepted;
+  unsigned int move_calls;
+  unsigned int move_velocity_calls;
+  unsigned int stop_calls;
+  unsigned int enable_calls;
+  unsigned int clear_alerts_calls;
+  unsigned int vel_max_calls;
+  unsigned int sample_reads;
+} MockMotorDriver;
+
+static MockMotorDriver mock_motors[CLEARCORE_MOTOR_AXIS_COUNT];
+static unsigned int mock_motor_initialize_calls;
+
+extern "C" {
+
+void ClearCoreMotorInitialize(void) {
+  mock_motor_initialize_calls++;
+}
+
+int ClearCoreMotorSampleRead(unsigned int axis,
+                             ClearCoreMotorSample *sample) {
+  if(axis >= CLEARCORE_MOTOR_AXIS_COUNT) {
+    return -1;
+  }
+  mock_motors[axis].sample_reads++;
+  *sample = mock_motors[axis].sample;
+  return 0;
+}
+
+int ClearCoreMotorMove(unsigned int axis,
+                       int32_t distance,
+                       int absolute) {
+  mock_motors[axis].move_calls++;
+  mock_motors[axis].last_distance = distance;
+  mock_motors[axis].last_absolute = absolute;
+  return mock_motors[axis].move_accepted;
+}
+
+int ClearCoreMotorMoveVelocity(unsigned int axis,
+                               int32_t velocity) {
+  mock_motors[axis].move_velocity_calls++;
+  mock_motors[axis].last_velocity = velocity;
+  return mock_motors[axis].move_accepted;
+}
+
+void ClearCoreMotorStop(unsigned int axis,
+                        int abrupt) {
+  (void) abrupt;
+  mock_motors[axis].stop_calls++;
+}
+
+void ClearCoreMotorEnable(unsigned int axis,
+                          int enable) {
+  mock_motors[axis].enable_calls++;
+  mock_motors[axis].sample.enable_request = enable ? 1 : 0;
+}
+
+void ClearCoreMotorVelMax(unsigned int axis,
+                          uint32_t vel_max) {
+  mock_motors[axis].vel_max_calls++;
+  mock_motors[axis].vel_max = vel_max;
+}
+
+void ClearCoreMotorAccelMax(unsigned int axis,
+                            uint32_t accel_max) {
+  mock_motors[axis].accel_max = accel_max;
+}
+
+void ClearCoreMotorEStopDecelMax(unsigned int axis,
+                                 uint32_t decel_max) {
+  mock_motors[axis].estop_decel_max = decel_max;
+}
+
+void ClearCoreMotorClearAlerts(unsigned int axis) {
+  mock_motors[axis].clear_alerts_calls++;
+  mock_motors[axis].sample.alert_reg = 0;
+}
+
+}
+
+static CipByteArray *MotionAxisAssemblyData(CipInstanceNum assembly) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipAssemblyClassCode),
+                                         assembly);
+  return (CipByteArray *) GetCipAttribute(instance, 3)->data;
+}
+
+static void WriteOutputAssembly(unsigned int axis,
+                                CipUsint control,
+                                CipDint distance,
+                                CipDint velocity,
+                                CipUdint vel_max,
+                                CipUdint accel_max) {
+  CipByteArray *const assembly = MotionAxisAssemblyData(
+    kMotionAxisOutputAssemblyBase + axis);
+  ENIPMessage message;
+  InitializeENIPMessage(&message);
+  AddSintToMessage(control, &message);
+  AddSintToMessage(0, &message);
+  AddIntToMessage(0, &message);
+  AddDintToMessage( (CipUdint) distance, &message );
+  AddDintToMessage( (CipUdint) velocity, &message );
+  AddDintToMessage(vel_max, &message);
+  AddDintToMessage(accel_max, &message);
+  LONGS_EQUAL(assembly->length, message.used_message_length);
+  memcpy(assembly->data, message.message_buffer, assembly->length);
+  CHECK_TRUE( CipMotionAxisAfterAssemblyDataReceived(
+                kMotionAxisOutputAssemblyBase + axis) );
+}
+
+TEST_GROUP(MotionAxis) {
+
+  void setup() {
+    memset(mock_motors, 0, sizeof(mock_motors) );
+    mock_motor_initialize_calls = 0;
+    for(unsigned int axis = 0; axis < CLEARCORE_MOTOR_AXIS_COUNT; ++axis) {
+      mock_motors[axis].move_accepted = 1;
+      mock_motors[axis].sample.hlfb_percent = CLEARCORE_MOTOR_HLFB_DUTY_UNKNOWN;
+    }
+    CipMotionAxisInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(MotionAxis, InitAppliesDefaultLimitsToAllAxes) {
+  LONGS_EQUAL(1, mock_motor_initialize_calls);
+  for(unsigned int axis = 0; axis < CLEARCORE_MOTOR_AXIS_COUNT; ++axis) {
+    UNSIGNED_LONGS_EQUAL(10000U, mock_motors[axis].vel_max);
+    UNSIGNED_LONGS_EQUAL(100000U, mock_motors[axis].accel_max);
+    UNSIGNED_LONGS_EQUAL(500000U, mock_motors[axis].estop_decel_max);
+  }
+  CipClass *motion_axis_class = GetCipClass(kCipMotionAxisClassCode);
+  CHECK(NULL != motion_axis_class);
+  LONGS_EQUAL(CIP_MOTION_AXIS_INSTANCE_COUNT, motion_axis_class->number_of_instances);
+}
+
+TEST(MotionAxis, ForeignAssembliesAreNotClaimed) {
+  CHECK_FALSE( CipMotionAxisAfterAssemblyDataReceived(150) );
+  CHECK_FALSE( CipMotionAxisAfterAssemblyDataReceived(
+                 kMotionAxisOutputAssemblyBase + CIP_MOTION_AXIS_INSTANCE_COUNT) );
+  CHECK_FALSE( CipMotionAxisBeforeAssemblyDataSend(100) );
+  CHECK_FALSE( CipMotionAxisBeforeAssemblyDataSend(
+                 kMotionAxisInputAssemblyBase + CIP_MOTION_AXIS_INSTANCE_COUNT) );
+}
+
+TEST(MotionAxis, MoveFiresOnRisingEdgeOnly) {
+  WriteOutputAssembly(2, kMotionAxisControlMove, -1234, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[2].move_calls);
+  LONGS_EQUAL(-1234, mock_motors[2].last_distance);
+  LONGS_EQUAL(0, mock_motors[2].last_absolute);
+
+  WriteOutputAssembly(2, kMotionAxisControlMove, -1234, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[2].move_calls);
+
+  WriteOutputAssembly(2, 0, 0, 0, 0, 0);
+  WriteOutputAssembly(2, kMotionAxisControlMove | kMotionAxisControlAbsolute,
+                      5000, 0, 0, 0);
+  LONGS_EQUAL(2, mock_motors[2].move_calls);
+  LONGS_EQUAL(5000, mock_motors[2].last_distance);
+  LONGS_EQUAL(1, mock_motors[2].last_absolute);
+  LONGS_EQUAL(0, mock_motors[0].move_calls);
+}
+
+TEST(MotionAxis, StopTakesPrecedenceOverMoves) {
+  WriteOutputAssembly(1,
+                      kMotionAxisControlStop | kMotionAxisControlMove |
+                      kMotionAxisControlMoveVelocity,
+                      100, 200, 0, 0);
+  LONGS_EQUAL(1, mock_motors[1].stop_calls);
+  LONGS_EQUAL(0, mock_motors[1].move_calls);
+  LONGS_EQUAL(0, mock_motors[1].move_velocity_calls);
+}
+
+/** @brief Send the Enable service to an axis */
+static void EnableService(unsigned int axis,
+                          CipUsint enable) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipMotionAxisClassCode),
+                                         axis + 1);
+  const CipOctet request_data[] = { enable };
+  CipMessageRouterRequest request;
+  CipMessageRouterResponse response;
+  memset(&request, 0, sizeof(request) );
+  memset(&response, 0, sizeof(response) );
+  request.service = kMotionAxisServiceEnable;
+  request.data = request_data;
+  request.request_data_size = sizeof(request_data);
+  MotionAxisEnable(instance, &request, &response, NULL, 0);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+}
+
+TEST(MotionAxis, EnableFollowsEdges) {
+  WriteOutputAssembly(0, kMotionAxisControlEnable, 0, 0, 0, 0);
+  WriteOutputAssembly(0, kMotionAxisControlEnable, 0, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[0].enable_calls);
+  LONGS_EQUAL(1, mock_motors[0].sample.enable_request);
+  WriteOutputAssembly(0, 0, 0, 0, 0, 0);
+  LONGS_EQUAL(2, mock_motors[0].enable_calls);
+  LONGS_EQUAL(0, mock_motors[0].sample.enable_request);
+}
+
+TEST(MotionAxis, ExplicitDisableHoldsWhileTheBitStaysSet) {
+  WriteOutputAssembly(0, kMotionAxisControlEnable, 0, 0, 0, 0);
+  EnableService(0, 0);
+  LONGS_EQUAL(0, mock_motors[0].sample.enable_request);
+  WriteOutputAssembly(0, kMotionAxisControlEnable, 0, 0, 0, 0);
+  LONGS_EQUAL(0, mock_motors[0].sample.enable_request);
+  LONGS_EQUAL(2, mock_motors[0].enable_calls);
+
+  /* the scanner takes the axis back with a new rising edge */
+  WriteOutputAssembly(0, 0, 0, 0, 0, 0);
+  WriteOutputAssembly(0, kMotionAxisControlEnable, 0, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[0].sample.enable_request);
+}
+
+TEST(MotionAxis, ExplicitEnableHoldsWhileTheBitStaysClear) {
+  WriteOutputAssembly(2, 0, 0, 0, 0, 0);
+  EnableService(2, 1);
+  WriteOutputAssembly(2, 0, 0, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[2].sample.enable_request);
+  LONGS_EQUAL(1, mock_motors[2].enable_calls);
+}
+
+TEST(MotionAxis, OpenedConnectionStartsWithEdges) {
+  WriteOutputAssembly(1, kMotionAxisControlEnable, 0, 0, 0, 0);
+  EnableService(1, 0);
+  /* a foreign assembly and other events leave the axis alone */
+  CipMotionAxisIoConnectionEvent(150, kIoConnectionEventOpened);
+  CipMotionAxisIoConnectionEvent(kMotionAxisOutputAssemblyBase + 1,
+                                 kIoConnectionEventTimedOut);
+  WriteOutputAssembly(1, kMotionAxisControlEnable, 0, 0, 0, 0);
+  LONGS_EQUAL(0, mock_motors[1].sample.enable_request);
+
+  CipMotionAxisIoConnectionEvent(kMotionAxisOutputAssemblyBase + 1,
+                                 kIoConnectionEventOpened);
+  WriteOutputAssembly(1, kMotionAxisControlEnable, 0, 0, 0, 0);
+  LONGS_EQUAL(1, mock_motors[1].sample.enable_request);
+}
+
+TEST(MotionAxis, LimitsAppliedWhenNonZeroAndChanged) {
+  const unsigned int calls_after_init = mock_motors[3].vel_max_calls;
+  WriteOutputAssembly(3, 0, 0, 0, 0, 0);
+  LONGS_EQUAL(calls_after_init, mock_motors[3].vel_max_calls);
+  WriteOutputAssembly(3, 0, 0, 0, 2500, 40000);
+  WriteOutputAssembly(3, 0, 0, 0, 2500, 40000);
+  LONGS_EQUAL(calls_after_init + 1, mock_motors[3].vel_max_calls);
+  UNSIGNED_LONGS_EQUAL(2500U, mock_motors[3].vel_max);
+  UNSIGNED_LONGS_EQUAL(40000U, mock_motors[3].accel_max);
+}
+
+TEST(MotionAxis, InputAssemblyPacksSample) {
+  mock_motors[1].sample.position_commanded = -2;
+  mock_motors[1].sample.velocity_commanded = 0x01020304;
+  mock_motors[1].sample.status_reg = 0xA5A5F00FU;
+  mock_motors[1].sample.alert_reg = 0x00000100U;
+  mock_motors[1].sample.hlfb_state = 1;
+  WriteOutputAssembly(1, kMotionAxisControlEnable, 0, 0, 0, 0);
+
+  CHECK_TRUE( CipMotionAxisBeforeAssemblyDataSend(
+                kMotionAxisInputAssemblyBase + 1) );
+  const CipByteArray *const assembly = MotionAxisAssemblyData(
+    kMotionAxisInputAssemblyBase + 1);
+  const CipOctet expected[CIP_MOTION_AXIS_INPUT_ASSEMBLY_SIZE] = {
+    0xFE, 0xFF, 0xFF, 0xFF,
+    0x04, 0x03, 0x02, 0x01,
+    0x0F, 0xF0, 0xA5, 0xA5,
+    0x00, 0x01, 0x00, 0x00,
+    0x01, kMotionAxisControlEnable,
+    0x00, 0x80
+  };
+  LONGS_EQUAL(sizeof(expected), assembly->length);
+  MEMCMP_EQUAL(expected, assembly->data, sizeof(expected) );
+
+  mock_motors[1].sample.hlfb_percent = 12.5f;
+  CipMotionAxisBeforeAssemblyDataSend(kMotionAxisInputAssemblyBase + 1);
+  BYTES_EQUAL(0xE2, assembly->data[18]);
+  BYTES_EQUAL(0x04, assembly->data[19]);
+}
+
+TEST(MotionAxis, GetAttributesAllSamplesOnce) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipMotionAxisClassCode),
+                                         1);
+  CipAttributeStruct *first = GetCipAttribute(instance, 1);
+  CipAttributeStruct *status = GetCipAttribute(instance, 8);
+
+  MotionAxisPreGetCallback(instance, first, kGetAttributeAll);
+  MotionAxisPreGetCallback(instance, status, kGetAttributeAll);
+  LONGS_EQUAL(1, mock_motors[0].sample_reads);
+
+  MotionAxisPreGetCallback(instance, status, kGetAttributeSingle);
+  LONGS_EQUAL(2, mock_motors[0].sample_reads);
+}
+
+TEST(MotionAxis, MoveServiceChecksDataAndResult) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipMotionAxisClassCode),
+                                         4);
+  const CipOctet request_data[] = { 0x10, 0x27, 0x00, 0x00, 0x01 };
+  CipMessageRouterRequest request;
+  CipMessageRouterResponse response;
+  memset(&request, 0, sizeof(request) );
+  memset(&response, 0, sizeof(response) );
+  request.service = kMotionAxisServiceMove;
+
+  request.data = request_data;
+  request.request_data_size = 3;
+  MotionAxisMove(instance, &request, &response, NULL, 0);
+  LONGS_EQUAL(kCipErrorNotEnoughData, response.general_status);
+  LONGS_EQUAL(0, mock_motors[3].move_calls);
+
+  request.data = request_data;
+  request.request_data_size = sizeof(request_data);
+  MotionAxisMove(instance, &request, &response, NULL, 0);
+  LONGS_EQUAL(0x80 | kMotionAxisServiceMove, response.reply_service);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(10000, mock_motors[3].last_distance);
+  LONGS_EQUAL(1, mock_motors[3].last_absolute);
+
+  mock_motors[3].move_accepted = 0;
+  request.data = request_data;
+  MotionAxisMove(instance, &request, &response, NULL, 0);
+  LONGS_EQUAL(kCipErrorObjectStateConflict, response.general_status);
+}
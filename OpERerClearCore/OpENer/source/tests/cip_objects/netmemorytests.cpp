@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Tests of the Network Memory Object against mocked lwIP pools
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "endianconv.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreNetMemory/cipnetmemory.h"
+#include "ports/ClearCore/clearcore_netmem.h"
+
+EipStatus NetMemoryReset(CipInstance *RESTRICT const instance,
+                         CipMessageRouterRequest *const message_router_request,
+                         CipMessageRouterResponse *const message_router_response,
+                         const struct sockaddr *originator_address,
+                         const CipSessionHandle encapsulation_session);
+
+EipStatus NetMemoryPreGetCallback(CipInstance *const instance,
+                                  CipAttributeStruct *const attribute,
+                                  CipByte service);
+
+}
+
+#define MOCK_NETMEM_POOLS 3
+
+/** @brief State of the mocked lwIP statistics */
+typedef struct {
+  ClearCoreNetMemStats stats[MOCK_NETMEM_POOLS];
+  unsigned int reads[MOCK_NETMEM_POOLS];
+  unsigned int reset_calls;
+} MockNetMem;
+
+static MockNetMem mock_netmem;
+
+static const char *const kMockPoolNames[MOCK_NETMEM_POOLS] = {
+  "HEAP", "TCP_PCB", "PBUF_POOL"
+};
+
+extern "C" {
+
+unsigned int ClearCoreNetMemPoolCount(void) {
+  return MOCK_NETMEM_POOLS;
+}
+
+const char *ClearCoreNetMemPoolName(unsigned int pool) {
+  return (pool < MOCK_NETMEM_POOLS) ? kMockPoolNames[pool] : "";
+}
+
+int ClearCoreNetMemRead(unsigned int pool, ClearCoreNetMemStats *stats) {
+  if(pool >= MOCK_NETMEM_POOLS) {
+    return -1;
+  }
+  mock_netmem.reads[pool]++;
+  *stats = mock_netmem.stats[pool];
+  return 0;
+}
+
+void ClearCoreNetMemReset(void) {
+  mock_netmem.reset_calls++;
+}
+
+}
+
+static CipInstance *NetMemoryInstance(CipInstanceNum instance_number) {
+  return GetCipInstance(GetCipClass(kCipNetMemoryClassCode), instance_number);
+}
+
+TEST_GROUP(NetMemory) {
+
+  void setup() {
+    memset(&mock_netmem, 0, sizeof(mock_netmem) );
+    CipNetMemoryInit();
+    memset(mock_netmem.reads, 0, sizeof(mock_netmem.reads) );
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(NetMemory, OneInstancePerPool) {
+  for(CipInstanceNum i = 1; i <= MOCK_NETMEM_POOLS; ++i) {
+    CipInstance *instance = NetMemoryInstance(i);
+    CHECK(NULL != instance);
+    const CipShortString *name =
+      (CipShortString *) GetCipAttribute(instance, 1)->data;
+    LONGS_EQUAL(strlen(kMockPoolNames[i - 1]), name->length);
+    MEMCMP_EQUAL(kMockPoolNames[i - 1], name->string, name->length);
+  }
+  POINTERS_EQUAL(NULL, NetMemoryInstance(MOCK_NETMEM_POOLS + 1) );
+}
+
+TEST(NetMemory, GetReadsThePool) {
+  CipInstance *instance = NetMemoryInstance(3);
+  mock_netmem.stats[2].avail = 20;
+  mock_netmem.stats[2].used = 7;
+  mock_netmem.stats[2].max = 20;
+  mock_netmem.stats[2].err = 3;
+
+  CipAttributeStruct *errors = GetCipAttribute(instance, 5);
+  NetMemoryPreGetCallback(instance, errors, kGetAttributeSingle);
+  LONGS_EQUAL(1, mock_netmem.reads[2]);
+  LONGS_EQUAL(0, mock_netmem.reads[1]);
+
+  ENIPMessage message;
+  InitializeENIPMessage(&message);
+  errors->encode(errors->data, &message);
+  LONGS_EQUAL(4, message.used_message_length);
+  const CipOctet expected[] = { 0x03, 0x00, 0x00, 0x00 };
+  MEMCMP_EQUAL(expected, message.message_buffer, 4);
+  LONGS_EQUAL(20, *(CipUdint *) GetCipAttribute(instance, 2)->data);
+  LONGS_EQUAL(7, *(CipUdint *) GetCipAttribute(instance, 3)->data);
+}
+
+TEST(NetMemory, GetAllSamplesOncePerReply) {
+  CipInstance *instance = NetMemoryInstance(1);
+  mock_netmem.stats[0].max = 4096;
+  for(CipUint attribute = 1; attribute <= 5; ++attribute) {
+    NetMemoryPreGetCallback(instance, GetCipAttribute(instance, attribute),
+                            kGetAttributeAll);
+  }
+  LONGS_EQUAL(1, mock_netmem.reads[0]);
+  LONGS_EQUAL(4096, *(CipUdint *) GetCipAttribute(instance, 4)->data);
+}
+
+TEST(NetMemory, ResetRejectsData) {
+  CipMessageRouterRequest request;
+  CipMessageRouterResponse response;
+  const CipOctet data[] = { 0 };
+  memset(&request, 0, sizeof(request) );
+  memset(&response, 0, sizeof(response) );
+  request.service = kNetMemoryServiceReset;
+  request.data = data;
+  request.request_data_size = sizeof(data);
+  NetMemoryReset(NetMemoryInstance(1), &request, &response, NULL, 0);
+  LONGS_EQUAL(kCipErrorTooMuchData, response.general_status);
+  LONGS_EQUAL(0, mock_netmem.reset_calls);
+
+  request.request_data_size = 0;
+  NetMemoryReset(NetMemoryInstance(1), &request, &response, NULL, 0);
+  LONGS_EQUAL(0x80 | kNetMemoryServiceReset, response.reply_service);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(1, mock_netmem.reset_calls);
+}
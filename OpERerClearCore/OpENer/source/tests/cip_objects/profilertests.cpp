@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * Tests of the ISR Profiler Object against a mock SysProfiler
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "endianconv.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "cip_objects/ClearCoreProfiler/cipprofiler.h"
+#include "ports/ClearCore/clearcore_profiler.h"
+
+EipStatus ProfilerReset(CipInstance *RESTRICT const instance,
+                        CipMessageRouterRequest *const message_router_request,
+                        CipMessageRouterResponse *const message_router_response,
+                        const struct sockaddr *originator_address,
+                        const CipSessionHandle encapsulation_session);
+
+EipStatus ProfilerPreGetCallback(CipInstance *const instance,
+                                 CipAttributeStruct *const attribute,
+                                 CipByte service);
+
+EipStatus ProfilerPostSetCallback(CipInstance *const instance,
+                                  CipAttributeStruct *const attribute,
+                                  CipByte service);
+
+}
+
+#define MOCK_PROFILER_SECTIONS 3
+
+/** @brief State of the mocked SysProfiler */
+typedef struct {
+  ClearCoreProfilerStats stats[MOCK_PROFILER_SECTIONS];
+  unsigned int reads[MOCK_PROFILER_SECTIONS];
+  unsigned int budget_section;
+  uint32_t budget;
+  unsigned int reset_calls;
+  unsigned int dump_calls;
+} MockProfiler;
+
+static MockProfiler mock_profiler;
+
+static const char *const kMockSectionNames[MOCK_PROFILER_SECTIONS] = {
+  "FastTotal", "Ccio", "Adc"
+};
+
+extern "C" {
+
+unsigned int ClearCoreProfilerSectionCount(void) {
+  return MOCK_PROFILER_SECTIONS;
+}
+
+const char *ClearCoreProfilerSectionName(unsigned int section) {
+  return (section < MOCK_PROFILER_SECTIONS) ? kMockSectionNames[section] : "";
+}
+
+int ClearCoreProfilerRead(unsigned int section,
+                          ClearCoreProfilerStats *stats) {
+  if(section >= MOCK_PROFILER_SECTIONS) {
+    return -1;
+  }
+  mock_profiler.reads[section]++;
+  *stats = mock_profiler.stats[section];
+  return 0;
+}
+
+void ClearCoreProfilerBudgetSet(unsigned int section,
+                                uint32_t cycles) {
+  mock_profiler.budget_section = section;
+  mock_profiler.budget = cycles;
+}
+
+void ClearCoreProfilerReset(void) {
+  mock_profiler.reset_calls++;
+}
+
+void ClearCoreProfilerDump(void) {
+  mock_profiler.dump_calls++;
+}
+
+}
+
+static CipInstance *ProfilerInstance(CipInstanceNum instance_number) {
+  return GetCipInstance(GetCipClass(kCipProfilerClassCode), instance_number);
+}
+
+TEST_GROUP(Profiler) {
+
+  void setup() {
+    memset(&mock_profiler, 0, sizeof(mock_profiler) );
+    CipProfilerInit();
+    memset(mock_profiler.reads, 0, sizeof(mock_profiler.reads) );
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(Profiler, OneInstancePerSection) {
+  for(CipInstanceNum i = 1; i <= MOCK_PROFILER_SECTIONS; ++i) {
+    CipInstance *instance = ProfilerInstance(i);
+    CHECK(NULL != instance);
+    const CipShortString *name =
+      (CipShortString *) GetCipAttribute(instance, 1)->data;
+    LONGS_EQUAL(strlen(kMockSectionNames[i - 1]), name->length);
+    MEMCMP_EQUAL(kMockSectionNames[i - 1], name->string, name->length);
+  }
+  POINTERS_EQUAL(NULL, ProfilerInstance(MOCK_PROFILER_SECTIONS + 1) );
+}
+
+TEST(Profiler, GetAllSamplesOncePerReply) {
+  CipInstance *instance = ProfilerInstance(2);
+  mock_profiler.stats[1].max = 1234;
+  for(CipUint attribute = 2; attribute <= 8; ++attribute) {
+    ProfilerPreGetCallback(instance, GetCipAttribute(instance, attribute),
+                           kGetAttributeAll);
+  }
+  LONGS_EQUAL(1, mock_profiler.reads[1]);
+  LONGS_EQUAL(0, mock_profiler.reads[0]);
+  LONGS_EQUAL(1234, *(CipUdint *) GetCipAttribute(instance, 4)->data);
+
+  ProfilerPreGetCallback(instance, GetCipAttribute(instance, 5),
+                         kGetAttributeSingle);
+  LONGS_EQUAL(2, mock_profiler.reads[1]);
+}
+
+TEST(Profiler, HistogramEncodesAllBins) {
+  CipInstance *instance = ProfilerInstance(1);
+  for(unsigned int i = 0; i < CLEARCORE_PROFILER_HIST_BINS; ++i) {
+    mock_profiler.stats[0].hist[i] = i * 0x01010101U;
+  }
+  CipAttributeStruct *histogram = GetCipAttribute(instance, 8);
+  ProfilerPreGetCallback(instance, histogram, kGetAttributeSingle);
+
+  ENIPMessage message;
+  InitializeENIPMessage(&message);
+  histogram->encode(histogram->data, &message);
+  LONGS_EQUAL(4 * CLEARCORE_PROFILER_HIST_BINS, message.used_message_length);
+  const CipOctet expected_bin3[] = { 0x03, 0x03, 0x03, 0x03 };
+  MEMCMP_EQUAL(expected_bin3, &message.message_buffer[12], 4);
+}
+
+TEST(Profiler, BudgetIsPushedToTheProfiler) {
+  CipInstance *instance = ProfilerInstance(3);
+  CipAttributeStruct *budget = GetCipAttribute(instance, 7);
+  *(CipUdint *) budget->data = 2400;
+  ProfilerPostSetCallback(instance, budget, kSetAttributeSingle);
+  LONGS_EQUAL(2, mock_profiler.budget_section);
+  LONGS_EQUAL(2400, mock_profiler.budget);
+}
+
+TEST(Profiler, ResetRejectsData) {
+  CipMessageRouterRequest request;
+  CipMessageRouterResponse response;
+  const CipOctet data[] = { 0 };
+  memset(&request, 0, sizeof(request) );
+  memset(&response, 0, sizeof(response) );
+  request.service = kProfilerServiceReset;
+  request.data = data;
+  request.request_data_size = sizeof(data);
+  ProfilerReset(ProfilerInstance(1), &request, &response, NULL, 0);
+  LONGS_EQUAL(kCipErrorTooMuchData, response.general_status);
+  LONGS_EQUAL(0, mock_profiler.reset_calls);
+
+  request.request_data_size = 0;
+  ProfilerReset(ProfilerInstance(1), &request, &response, NULL, 0);
+  LONGS_EQUAL(0x80 | kProfilerServiceReset, response.reply_service);
+  LONGS_EQUAL(kCipErrorSuccess, response.general_status);
+  LONGS_EQUAL(1, mock_profiler.reset_calls);
+}
@@ -0,0 +1,469 @@
+/*******************************************************************************
+ * Tests of the Serial Gateway Object against mock serial devices
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipassembly.h"
+#include "cipconnectionmanager.h"
+#include "cipconnectionobject.h"
+#include "ciperror.h"
+#include "cipmessagerouter.h"
+#include "doublylinkedlist.h"
+#include "cip_objects/ClearCoreSerialGateway/cipserialgateway.h"
+#include "ports/ClearCore/clearcore_serial.h"
+
+EipStatus SerialGatewayPostSetCallback(CipInstance *const instance,
+                                       CipAttributeStruct *const attribute,
+                                       CipByte service);
+
+}
+
+#include "vendorobjecttest.h"
+
+/** @brief State of a mocked serial device on one port */
+typedef struct {
+  int open;
+  int opens;
+  int refuse;
+  ClearCoreSerialConfig config;
+  int loopback; /**< echo every written byte */
+  uint8_t written[256];
+  int32_t written_length;
+  int32_t write_space;
+  uint8_t received[256];
+  int32_t received_length;
+  int32_t read_position;
+  int idle;
+  uint32_t errors;
+} MockSerialPort;
+
+static MockSerialPort mock_serial[2];
+
+static MockSerialPort *MockPort(uint8_t port) {
+  return &mock_serial[port - kClearCoreSerialPortCom0];
+}
+
+/** Let the device send bytes to the gateway */
+static void MockReceive(uint8_t port,
+                        const void *data,
+                        int32_t length) {
+  MockSerialPort *const mock = MockPort(port);
+  memcpy(&mock->received[mock->received_length], data, length);
+  mock->received_length += length;
+}
+
+extern "C" {
+
+int ClearCoreSerialOpen(uint8_t port,
+                        const ClearCoreSerialConfig *config) {
+  MockSerialPort *const mock = MockPort(port);
+  if (mock->refuse) {
+    return 0;
+  }
+  mock->open = (NULL != config);
+  if (NULL != config) {
+    mock->config = *config;
+    mock->opens++;
+  }
+  return 1;
+}
+
+int32_t ClearCoreSerialWrite(uint8_t port,
+                             const uint8_t *data,
+                             int32_t length) {
+  MockSerialPort *const mock = MockPort(port);
+  if (length > mock->write_space) {
+    length = mock->write_space;
+  }
+  memcpy(&mock->written[mock->written_length], data, length);
+  mock->written_length += length;
+  if (mock->loopback) {
+    MockReceive(port, data, length);
+  }
+  return length;
+}
+
+int32_t ClearCoreSerialRead(uint8_t port,
+                            uint8_t *data,
+                            int32_t length) {
+  MockSerialPort *const mock = MockPort(port);
+  const int32_t available = mock->received_length - mock->read_position;
+  if (length > available) {
+    length = available;
+  }
+  memcpy(data, &mock->received[mock->read_position], length);
+  mock->read_position += length;
+  return length;
+}
+
+void ClearCoreSerialFlushInput(uint8_t port) {
+  MockSerialPort *const mock = MockPort(port);
+  mock->read_position = mock->received_length;
+}
+
+int ClearCoreSerialRxIdle(uint8_t port) {
+  return MockPort(port)->idle;
+}
+
+uint32_t ClearCoreSerialErrors(uint8_t port) {
+  MockSerialPort *const mock = MockPort(port);
+  const uint32_t errors = mock->errors;
+  mock->errors = 0;
+  return errors;
+}
+
+}
+
+static CipInstance *GatewayInstance(CipInstanceNum instance_number) {
+  return GetCipInstance(GetCipClass(kCipSerialGatewayClassCode),
+                        instance_number);
+}
+
+static CipByteArray *AssemblyData(CipInstanceNum instance_number) {
+  CipInstance *instance = GetCipInstance(GetCipClass(kCipAssemblyClassCode),
+                                         instance_number);
+  return (CipByteArray *) GetCipAttribute(instance, 3)->data;
+}
+
+static void OpenPort(uint8_t port) {
+  CipMessageRouterResponse response;
+  const CipOctet open[] = { 1 };
+  LONGS_EQUAL(1, DecodeAttribute(GetCipAttribute(GatewayInstance(port), 1),
+                                 open, sizeof(open), &response) );
+}
+
+/** Place a request in an output slot and deliver the assembly */
+static void Submit(int slot,
+                   uint8_t sequence,
+                   uint8_t port,
+                   const char *request,
+                   uint8_t expected) {
+  CipOctet *const data =
+    &AssemblyData(kSerialGatewayOutputAssembly)->data[
+      slot * CIP_SERIAL_GATEWAY_SLOT_SIZE];
+  const size_t length = strlen(request);
+  data[0] = sequence;
+  data[1] = port;
+  data[2] = (CipOctet) length;
+  data[3] = expected;
+  memcpy(&data[4], request, length);
+  CHECK_TRUE( CipSerialGatewayAfterAssemblyDataReceived(
+                kSerialGatewayOutputAssembly) );
+}
+
+static const CipOctet *Response(int slot) {
+  return &AssemblyData(kSerialGatewayInputAssembly)->data[
+    slot * CIP_SERIAL_GATEWAY_SLOT_SIZE];
+}
+
+TEST_GROUP(SerialGateway) {
+
+  void setup() {
+    memset(mock_serial, 0, sizeof(mock_serial) );
+    mock_serial[0].write_space = sizeof(mock_serial[0].written);
+    mock_serial[1].write_space = sizeof(mock_serial[1].written);
+    CipSerialGatewayInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+  }
+
+};
+
+TEST(SerialGateway, InitCreatesInstancesAndAssemblies) {
+  CHECK(NULL != GatewayInstance(1) );
+  CHECK(NULL != GatewayInstance(2) );
+  LONGS_EQUAL(CIP_SERIAL_GATEWAY_ASSEMBLY_SIZE,
+              AssemblyData(kSerialGatewayInputAssembly)->length);
+  LONGS_EQUAL(CIP_SERIAL_GATEWAY_ASSEMBLY_SIZE,
+              AssemblyData(kSerialGatewayOutputAssembly)->length);
+  /* The ports stay closed unless CLEARCORE_SERIAL_GATEWAY_PORTS opens them */
+  LONGS_EQUAL(0, *(CipBool *) GetCipAttribute(GatewayInstance(1), 1)->data);
+  LONGS_EQUAL(9600,
+              *(CipUdint *) GetCipAttribute(GatewayInstance(2), 3)->data);
+  LONGS_EQUAL(0, mock_serial[0].opens + mock_serial[1].opens);
+}
+
+TEST(SerialGateway, ForeignAssembliesAreNotClaimed) {
+  CHECK_FALSE( CipSerialGatewayBeforeAssemblyDataSend(
+                 kSerialGatewayOutputAssembly) );
+  CHECK_FALSE( CipSerialGatewayBeforeAssemblyDataSend(122) );
+  CHECK_FALSE( CipSerialGatewayAfterAssemblyDataReceived(
+                 kSerialGatewayInputAssembly) );
+  CHECK_FALSE( CipSerialGatewayAfterAssemblyDataReceived(164) );
+}
+
+TEST(SerialGateway, LoopbackAnswersInTheSameCycle) {
+  OpenPort(kClearCoreSerialPortCom0);
+  MockPort(kClearCoreSerialPortCom0)->loopback = 1;
+
+  Submit(2, 7, kClearCoreSerialPortCom0, "PING", 4);
+  const CipOctet *const response = Response(2);
+  LONGS_EQUAL(7, response[0]);
+  LONGS_EQUAL(kSerialGatewayStatusOk, response[1]);
+  LONGS_EQUAL(4, response[2]);
+  MEMCMP_EQUAL("PING", &response[4], 4);
+  LONGS_EQUAL(1, *(CipUdint *) GetCipAttribute(GatewayInstance(1), 7)->data);
+  LONGS_EQUAL(0, *(CipUsint *) GetCipAttribute(GatewayInstance(1), 10)->data);
+}
+
+TEST(SerialGateway, RequestsOfAPortAreSentInOrder) {
+  OpenPort(kClearCoreSerialPortCom1);
+  MockSerialPort *const mock = MockPort(kClearCoreSerialPortCom1);
+
+  Submit(3, 1, kClearCoreSerialPortCom1, "A", 2);
+  Submit(0, 1, kClearCoreSerialPortCom1, "B", 2);
+  Submit(1, 1, kClearCoreSerialPortCom1, "C", 2);
+  /* Only the first request is on the line */
+  LONGS_EQUAL(1, mock->written_length);
+  LONGS_EQUAL('A', mock->written[0]);
+  LONGS_EQUAL(3, *(CipUsint *) GetCipAttribute(GatewayInstance(2), 10)->data);
+
+  MockReceive(kClearCoreSerialPortCom1, "a1", 2);
+  CipSerialGatewayHandleApplication(10);
+  MEMCMP_EQUAL("a1", &Response(3)[4], 2);
+  /* Slots submitted in the same assembly are queued in slot order */
+  MEMCMP_EQUAL("AB", mock->written, 2);
+  LONGS_EQUAL(0, Response(0)[0]);
+
+  MockReceive(kClearCoreSerialPortCom1, "b1", 2);
+  CipSerialGatewayHandleApplication(10);
+  MockReceive(kClearCoreSerialPortCom1, "c1", 2);
+  CipSerialGatewayHandleApplication(10);
+  MEMCMP_EQUAL("ABC", mock->written, 3);
+  MEMCMP_EQUAL("b1", &Response(0)[4], 2);
+  MEMCMP_EQUAL("c1", &Response(1)[4], 2);
+  LONGS_EQUAL(3, *(CipUdint *) GetCipAttribute(GatewayInstance(2), 7)->data);
+}
+
+TEST(SerialGateway, BothPortsRunAtTheSameTime) {
+  OpenPort(kClearCoreSerialPortCom0);
+  OpenPort(kClearCoreSerialPortCom1);
+
+  Submit(0, 1, kClearCoreSerialPortCom0, "X", 1);
+  Submit(1, 1, kClearCoreSerialPortCom1, "Y", 1);
+  LONGS_EQUAL(1, MockPort(kClearCoreSerialPortCom0)->written_length);
+  LONGS_EQUAL(1, MockPort(kClearCoreSerialPortCom1)->written_length);
+
+  MockReceive(kClearCoreSerialPortCom1, "y", 1);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(0, Response(0)[0]);
+  LONGS_EQUAL('y', Response(1)[4]);
+  MockReceive(kClearCoreSerialPortCom0, "x", 1);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL('x', Response(0)[4]);
+}
+
+TEST(SerialGateway, IdleLineEndsAResponseOfUnknownLength) {
+  OpenPort(kClearCoreSerialPortCom0);
+  MockSerialPort *const mock = MockPort(kClearCoreSerialPortCom0);
+  /* Quiet before the response is not its end */
+  mock->idle = 1;
+  Submit(0, 5, kClearCoreSerialPortCom0, "?", 0);
+  LONGS_EQUAL(0, Response(0)[0]);
+
+  mock->idle = 0;
+  MockReceive(kClearCoreSerialPortCom0, "12.5 kg", 7);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(0, Response(0)[0]);
+
+  mock->idle = 1;
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(5, Response(0)[0]);
+  LONGS_EQUAL(kSerialGatewayStatusOk, Response(0)[1]);
+  LONGS_EQUAL(7, Response(0)[2]);
+  MEMCMP_EQUAL("12.5 kg", &Response(0)[4], 7);
+}
+
+TEST(SerialGateway, TimeoutReturnsThePartialResponse) {
+  OpenPort(kClearCoreSerialPortCom0);
+  CipAttributeStruct *timeout = GetCipAttribute(GatewayInstance(1), 6);
+  *(CipUint *) timeout->data = 30;
+
+  /* Stale input is flushed before the request is sent */
+  MockReceive(kClearCoreSerialPortCom0, "old", 3);
+  Submit(0, 9, kClearCoreSerialPortCom0, "GET", 6);
+  MockReceive(kClearCoreSerialPortCom0, "new", 3);
+  CipSerialGatewayHandleApplication(10);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(0, Response(0)[0]);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(9, Response(0)[0]);
+  LONGS_EQUAL(kSerialGatewayStatusTimeout, Response(0)[1]);
+  LONGS_EQUAL(3, Response(0)[2]);
+  MEMCMP_EQUAL("new", &Response(0)[4], 3);
+  LONGS_EQUAL(1, *(CipUdint *) GetCipAttribute(GatewayInstance(1), 8)->data);
+}
+
+TEST(SerialGateway, LongResponseIsTruncated) {
+  OpenPort(kClearCoreSerialPortCom0);
+  MockSerialPort *const mock = MockPort(kClearCoreSerialPortCom0);
+  uint8_t response[CIP_SERIAL_GATEWAY_DATA_SIZE + 10];
+  for (size_t i = 0; i < sizeof(response); i++) {
+    response[i] = (uint8_t) i;
+  }
+
+  Submit(0, 1, kClearCoreSerialPortCom0, "DUMP", 0);
+  MockReceive(kClearCoreSerialPortCom0, response, sizeof(response) );
+  mock->idle = 1;
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(kSerialGatewayStatusTruncated, Response(0)[1]);
+  LONGS_EQUAL(CIP_SERIAL_GATEWAY_DATA_SIZE, Response(0)[2]);
+  MEMCMP_EQUAL(response, &Response(0)[4], CIP_SERIAL_GATEWAY_DATA_SIZE);
+  /* The rest of the response is not taken for the next one */
+  LONGS_EQUAL(mock->received_length, mock->read_position);
+}
+
+TEST(SerialGateway, InvalidRequestsAreAnsweredAtOnce) {
+  OpenPort(kClearCoreSerialPortCom0);
+
+  Submit(0, 1, 3, "A", 1);
+  LONGS_EQUAL(1, Response(0)[0]);
+  LONGS_EQUAL(kSerialGatewayStatusInvalid, Response(0)[1]);
+
+  Submit(1, 1, kClearCoreSerialPortCom0, "A", CIP_SERIAL_GATEWAY_DATA_SIZE + 1);
+  LONGS_EQUAL(kSerialGatewayStatusInvalid, Response(1)[1]);
+  LONGS_EQUAL(0, MockPort(kClearCoreSerialPortCom0)->written_length);
+}
+
+TEST(SerialGateway, RequestWithoutResponseCompletesWhenSent) {
+  OpenPort(kClearCoreSerialPortCom0);
+
+  Submit(0, 3, kClearCoreSerialPortCom0, "GO", kSerialGatewayNoResponse);
+  Submit(1, 4, kClearCoreSerialPortCom0, "STOP", kSerialGatewayNoResponse);
+  LONGS_EQUAL(kSerialGatewayStatusOk, Response(0)[1]);
+  LONGS_EQUAL(4, Response(1)[0]);
+  MEMCMP_EQUAL("GOSTOP", MockPort(kClearCoreSerialPortCom0)->written, 6);
+
+  MockPort(kClearCoreSerialPortCom0)->write_space = 0;
+  Submit(0, 5, kClearCoreSerialPortCom0, "GO", kSerialGatewayNoResponse);
+  LONGS_EQUAL(kSerialGatewayStatusSendFailed, Response(0)[1]);
+}
+
+TEST(SerialGateway, ClosedPortAnswersItsQueue) {
+  Submit(0, 1, kClearCoreSerialPortCom1, "A", 1);
+  LONGS_EQUAL(kSerialGatewayStatusPortClosed, Response(0)[1]);
+
+  OpenPort(kClearCoreSerialPortCom1);
+  Submit(0, 2, kClearCoreSerialPortCom1, "A", 1);
+  Submit(1, 2, kClearCoreSerialPortCom1, "B", 1);
+  CipMessageRouterResponse response;
+  const CipOctet close[] = { 0 };
+  DecodeAttribute(GetCipAttribute(GatewayInstance(2), 1), close,
+                  sizeof(close), &response);
+  LONGS_EQUAL(0, MockPort(kClearCoreSerialPortCom1)->open);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(2, Response(0)[0]);
+  LONGS_EQUAL(kSerialGatewayStatusPortClosed, Response(0)[1]);
+  LONGS_EQUAL(kSerialGatewayStatusPortClosed, Response(1)[1]);
+}
+
+TEST(SerialGateway, RepeatedSequenceIsNotSentAgain) {
+  OpenPort(kClearCoreSerialPortCom0);
+  MockPort(kClearCoreSerialPortCom0)->loopback = 1;
+
+  Submit(0, 1, kClearCoreSerialPortCom0, "A", 1);
+  Submit(0, 1, kClearCoreSerialPortCom0, "A", 1);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(1, MockPort(kClearCoreSerialPortCom0)->written_length);
+  Submit(0, 2, kClearCoreSerialPortCom0, "A", 1);
+  LONGS_EQUAL(2, MockPort(kClearCoreSerialPortCom0)->written_length);
+  LONGS_EQUAL(2, Response(0)[0]);
+}
+
+TEST(SerialGateway, SettingsAreValidatedAndReopenThePort) {
+  CipInstance *instance = GatewayInstance(1);
+  CipMessageRouterResponse response;
+
+  const CipOctet parity[] = { 3 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 4), parity,
+                        sizeof(parity), &response) < 0);
+  LONGS_EQUAL(kCipErrorInvalidAttributeValue, response.general_status);
+  const CipOctet baud_rate[] = { 0x10, 0, 0, 0 };
+  CHECK(DecodeAttribute(GetCipAttribute(instance, 3), baud_rate,
+                        sizeof(baud_rate), &response) < 0);
+
+  /* A closed port only takes the setting */
+  const CipOctet fast[] = { 0x00, 0xC2, 0x01, 0x00 };
+  CipAttributeStruct *speed = GetCipAttribute(instance, 3);
+  LONGS_EQUAL(4, DecodeAttribute(speed, fast, sizeof(fast), &response) );
+  SerialGatewayPostSetCallback(instance, speed, kSetAttributeSingle);
+  LONGS_EQUAL(0, MockPort(kClearCoreSerialPortCom0)->opens);
+
+  OpenPort(kClearCoreSerialPortCom0);
+  LONGS_EQUAL(115200, MockPort(kClearCoreSerialPortCom0)->config.baud_rate);
+  const CipOctet rs232[] = { kClearCoreSerialModeRs232 };
+  CipAttributeStruct *mode = GetCipAttribute(instance, 2);
+  LONGS_EQUAL(1, DecodeAttribute(mode, rs232, sizeof(rs232), &response) );
+  SerialGatewayPostSetCallback(instance, mode, kSetAttributeSingle);
+  LONGS_EQUAL(2, MockPort(kClearCoreSerialPortCom0)->opens);
+  LONGS_EQUAL(kClearCoreSerialModeRs232,
+              MockPort(kClearCoreSerialPortCom0)->config.mode);
+}
+
+TEST(SerialGateway, RefusedPortStaysClosed) {
+  MockPort(kClearCoreSerialPortCom1)->refuse = 1;
+  CipMessageRouterResponse response;
+  const CipOctet open[] = { 1 };
+  CipAttributeStruct *attribute = GetCipAttribute(GatewayInstance(2), 1);
+  CHECK(DecodeAttribute(attribute, open, sizeof(open), &response) < 0);
+  LONGS_EQUAL(kCipErrorObjectStateConflict, response.general_status);
+  LONGS_EQUAL(0, *(CipBool *) attribute->data);
+}
+
+TEST(SerialGateway, SerialErrorsAccumulate) {
+  OpenPort(kClearCoreSerialPortCom0);
+  MockPort(kClearCoreSerialPortCom0)->errors = 0x2;
+  CipSerialGatewayHandleApplication(10);
+  MockPort(kClearCoreSerialPortCom0)->errors = 0x4;
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(0x6, *(CipDword *) GetCipAttribute(GatewayInstance(1),
+                                                 9)->data);
+}
+
+TEST(SerialGateway, CompletedResponseTriggersTheConnectionOnce) {
+  DoublyLinkedListInitialize(&connection_list,
+                             CipConnectionObjectListArrayAllocator,
+                             CipConnectionObjectListArrayFree);
+  CipConnectionObject connection;
+  memset(&connection, 0, sizeof(connection) );
+  connection.consumed_path.instance_id = kSerialGatewayOutputAssembly;
+  connection.produced_path.instance_id = kSerialGatewayInputAssembly;
+  /* Class 1, change of state */
+  connection.transport_class_trigger = 0x11;
+  connection.production_inhibit_time = 5;
+  connection.transmission_trigger_timer = 100;
+  AddNewActiveConnection(&connection);
+
+  OpenPort(kClearCoreSerialPortCom0);
+  Submit(0, 1, kClearCoreSerialPortCom0, "A", 1);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(100, connection.transmission_trigger_timer);
+
+  MockReceive(kClearCoreSerialPortCom0, "a", 1);
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(5, connection.transmission_trigger_timer);
+
+  /* Not again before the assembly was produced */
+  connection.transmission_trigger_timer = 50;
+  MockPort(kClearCoreSerialPortCom0)->loopback = 1;
+  Submit(1, 1, kClearCoreSerialPortCom0, "B", 1);
+  LONGS_EQUAL(50, connection.transmission_trigger_timer);
+
+  CHECK_TRUE( CipSerialGatewayBeforeAssemblyDataSend(
+                kSerialGatewayInputAssembly) );
+  CipSerialGatewayHandleApplication(10);
+  LONGS_EQUAL(50, connection.transmission_trigger_timer);
+  Submit(2, 1, kClearCoreSerialPortCom0, "C", 1);
+  LONGS_EQUAL(5, connection.transmission_trigger_timer);
+
+  RemoveFromActiveConnections(&connection);
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Tests of the Trace Object
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "opener_api.h"
+#include "cipmessagerouter.h"
+#include "trace.h"
+#include "cip_objects/ClearCoreTrace/ciptrace.h"
+#include "ports/ClearCore/clearcore_trace.h"
+
+EipStatus TracePreGetCallback(CipInstance *const instance,
+                              CipAttributeStruct *const attribute,
+                              CipByte service);
+
+}
+
+static uint32_t mock_dropped;
+
+extern "C" {
+
+uint32_t ClearCoreTraceDropped(void) {
+  return mock_dropped;
+}
+
+}
+
+static CipInstance *TraceInstance(void) {
+  return GetCipInstance(GetCipClass(kCipTraceClassCode), 1);
+}
+
+TEST_GROUP(Trace) {
+  uint32_t saved_mask;
+
+  void setup() {
+    saved_mask = g_opener_trace_mask;
+    mock_dropped = 0;
+    CipTraceInit();
+  }
+
+  void teardown() {
+    DeleteAllClasses();
+    g_opener_trace_mask = saved_mask;
+  }
+
+};
+
+TEST(Trace, MaskAttributeIsTheRunTimeMask) {
+  CipAttributeStruct *mask = GetCipAttribute(TraceInstance(), 1);
+  POINTERS_EQUAL(&g_opener_trace_mask, mask->data);
+  LONGS_EQUAL(kSetAndGetAble, mask->attribute_flags & kSetAndGetAble);
+
+  ENIPMessage message;
+  InitializeENIPMessage(&message);
+  g_opener_trace_mask = 0x01020304U;
+  mask->encode(mask->data, &message);
+  const CipOctet expected[] = { 0x04, 0x03, 0x02, 0x01 };
+  LONGS_EQUAL(4, message.used_message_length);
+  MEMCMP_EQUAL(expected, message.message_buffer, 4);
+}
+
+TEST(Trace, CompiledMaskIsReadOnly) {
+  CipAttributeStruct *compiled = GetCipAttribute(TraceInstance(), 2);
+  UNSIGNED_LONGS_EQUAL(OPENER_TRACE_COMPILED_MASK,
+                       *(CipUdint *) compiled->data);
+  LONGS_EQUAL(0, compiled->attribute_flags & kSetable);
+}
+
+TEST(Trace, DroppedRecordsAreSampledOnGet) {
+  CipInstance *instance = TraceInstance();
+  CipAttributeStruct *dropped = GetCipAttribute(instance, 3);
+  mock_dropped = 17;
+  TracePreGetCallback(instance, dropped, kGetAttributeSingle);
+  UNSIGNED_LONGS_EQUAL(17, *(CipUdint *) dropped->data);
+}
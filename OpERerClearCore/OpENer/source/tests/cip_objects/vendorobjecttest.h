@@ -0,0 +1,34 @@
+/*******************************************************************************
+ * Helpers of the tests of the vendor specific objects
+ *
+ ******************************************************************************/
+#ifndef OPENER_VENDOROBJECTTEST_H_
+#define OPENER_VENDOROBJECTTEST_H_
+
+#include <string.h>
+
+extern "C" {
+
+#include "ciptypes.h"
+
+}
+
+/** Decode a Set_Attribute_Single request body into an attribute
+ *
+ *  @return the result of the decode function of the attribute, the number of
+ *  bytes taken or -1 with the status of @p response set
+ */
+static inline int DecodeAttribute(CipAttributeStruct *attribute,
+                                  const CipOctet *data,
+                                  size_t size,
+                                  CipMessageRouterResponse *response) {
+  CipMessageRouterRequest request;
+  memset(&request, 0, sizeof(request) );
+  memset(response, 0, sizeof(*response) );
+  request.service = kSetAttributeSingle;
+  request.data = data;
+  request.request_data_size = size;
+  return attribute->decode(attribute->data, &request, response);
+}
+
+#endif /* OPENER_VENDOROBJECTTEST_H_ */
@@ -15,6 +15,11 @@ extern "C" {
 
 #include "ciptypes.h"
 #include "enipmessage.h"
+#include "opener_api.h"
+#include "cipidentity.h"
+#include "ciptcpipinterface.h"
+
+extern size_t g_number_of_delayed_encapsulation_messages;
 
 }
 
@@ -128,3 +133,110 @@ TEST(EncapsulationProtocol, SendRRData) {
                                                fake_originator_pointer,
                                                &outgoing_message);
 }
+
+TEST_GROUP(ListIdentityResponder) {
+  CipOctet request[24];
+  EncapsulationData received_data;
+
+  void setup() {
+    EncapsulationInit();
+    memset(request, 0, sizeof(request) );
+    request[0] = 0x63; /* List Identity */
+    CreateEncapsulationStructure(request, sizeof(request), &received_data);
+  }
+
+  void teardown() {
+    ManageEncapsulationMessages(65535);
+  }
+
+  struct sockaddr_in Originator(const CipUdint host) {
+    struct sockaddr_in originator;
+    memset(&originator, 0, sizeof(originator) );
+    originator.sin_family = AF_INET;
+    originator.sin_addr.s_addr = htonl(0xC0A80100 + host);
+    originator.sin_port = htons(kOpenerEthernetPort);
+    return originator;
+  }
+};
+
+TEST(ListIdentityResponder, CachedIdentityItemFollowsIdentityAndAddress) {
+  ENIPMessage cached;
+  ENIPMessage again;
+  InitializeENIPMessage(&cached);
+  InitializeENIPMessage(&again);
+
+  EncodeListIdentityCipIdentityItem(&cached);
+  EncodeListIdentityCipIdentityItem(&again);
+  CHECK_EQUAL(cached.used_message_length, again.used_message_length);
+  MEMCMP_EQUAL(cached.message_buffer, again.message_buffer,
+               cached.used_message_length);
+
+  const CipWord status = g_identity.status;
+  SetDeviceStatus(status ^ 0x0001);
+  InitializeENIPMessage(&again);
+  EncodeListIdentityCipIdentityItem(&again);
+  CHECK(0 != memcmp(cached.message_buffer, again.message_buffer,
+                    cached.used_message_length) );
+  SetDeviceStatus(status);
+
+  const CipUdint ip_address = g_tcpip.interface_configuration.ip_address;
+  g_tcpip.interface_configuration.ip_address = ip_address ^ 0x01000000;
+  InitializeENIPMessage(&again);
+  EncodeListIdentityCipIdentityItem(&again);
+  CHECK(0 != memcmp(cached.message_buffer, again.message_buffer,
+                    cached.used_message_length) );
+  g_tcpip.interface_configuration.ip_address = ip_address;
+
+  InitializeENIPMessage(&again);
+  EncodeListIdentityCipIdentityItem(&again);
+  MEMCMP_EQUAL(cached.message_buffer, again.message_buffer,
+               cached.used_message_length);
+}
+
+TEST(ListIdentityResponder, FloodFillsTheQueueAndDropsTheRest) {
+  for(CipUdint host = 1; host <= 200; host++) {
+    struct sockaddr_in originator = Originator(host);
+    HandleReceivedListIdentityCommandUdp(kEipInvalidSocket, &originator,
+                                         &received_data);
+  }
+  const size_t queued = g_number_of_delayed_encapsulation_messages;
+  CHECK(queued > 0);
+  CHECK(queued < 200);
+
+  /* the responses are due within the default maximum delay of 2000ms */
+  ManageEncapsulationMessages(2000);
+  CHECK_EQUAL(0, g_number_of_delayed_encapsulation_messages);
+}
+
+TEST(ListIdentityResponder, RepeatedRequestsOfAnOriginatorCoalesce) {
+  struct sockaddr_in originator = Originator(1);
+  for(int i = 0; i < 50; i++) {
+    HandleReceivedListIdentityCommandUdp(kEipInvalidSocket, &originator,
+                                         &received_data);
+  }
+  CHECK_EQUAL(1, g_number_of_delayed_encapsulation_messages);
+
+  /* another port of the same host is another originator */
+  originator.sin_port = htons(kOpenerEthernetPort + 1);
+  HandleReceivedListIdentityCommandUdp(kEipInvalidSocket, &originator,
+                                       &received_data);
+  CHECK_EQUAL(2, g_number_of_delayed_encapsulation_messages);
+}
+
+TEST(ListIdentityResponder, ResponsesAreSentWhenDue) {
+  request[12] = 0xE8; /* maximum delay of 1000ms */
+  request[13] = 0x03;
+  CreateEncapsulationStructure(request, sizeof(request), &received_data);
+  struct sockaddr_in originator = Originator(1);
+  HandleReceivedListIdentityCommandUdp(kEipInvalidSocket, &originator,
+                                       &received_data);
+  CHECK_EQUAL(1, g_number_of_delayed_encapsulation_messages);
+
+  size_t elapsed = 0;
+  while(g_number_of_delayed_encapsulation_messages > 0 && elapsed < 2000) {
+    ManageEncapsulationMessages(10);
+    elapsed += 10;
+  }
+  CHECK_EQUAL(0, g_number_of_delayed_encapsulation_messages);
+  CHECK(elapsed <= 1000);
+}
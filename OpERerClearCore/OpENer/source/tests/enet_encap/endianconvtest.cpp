@@ -10,8 +10,11 @@
 
 extern "C" {
 
+/* The ClearCore port gets the socket API from lwIP through ciptypes.h */
+#ifndef CLEARCORE
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#endif
 
 #include "endianconv.h"
 
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * ADC block decimation tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+
+#include "AdcDecimator.h"
+
+using ClearCore::AdcDecimator;
+using ClearCore::Iir16;
+
+/* 12-bit results of 4 blocks of 5 sample times */
+static const uint16_t kRaw[20] = {
+  0, 4095, 4095, 2048, 1000,
+  3000, 4095, 0, 123, 4000,
+  2500, 2500, 2500, 2500, 17,
+  4095, 3900, 3800, 100, 200
+};
+
+static const uint16_t kTc = 29000;
+
+TEST_GROUP(AdcDecimator) {
+  AdcDecimator decimator;
+  Iir16 filter;
+
+  void setup() {
+    filter.Tc(kTc);
+  }
+};
+
+TEST(AdcDecimator, Q15NormalizesResolutions) {
+  CHECK_EQUAL(0x7F80, AdcDecimator::Q15(0xFF, 8) );
+  CHECK_EQUAL(0x7FE0, AdcDecimator::Q15(0x3FF, 10) );
+  CHECK_EQUAL(0x7FF8, AdcDecimator::Q15(0xFFF, 12) );
+  CHECK_EQUAL(0x4000, AdcDecimator::Q15(0x800, 12) );
+  CHECK_EQUAL(0x7FFF, AdcDecimator::Q15(0xFFFF, 16) );
+  CHECK_EQUAL(0, AdcDecimator::Q15(0, 16) );
+}
+
+/* Reference values from an independent model of the Iir16 update and the
+ * rounded boxcar average */
+TEST(AdcDecimator, MatchesReferenceModel) {
+  static const uint16_t kFiltered[4] = { 8149, 12508, 13648, 15211 };
+  static const uint16_t kDecimated[4] = { 20476, 16190, 18246, 16000 };
+  static const uint16_t kOutputs[4] = { 1, 1, 1, 2 };
+  static const uint16_t kPending[4] = { 1, 2, 3, 0 };
+
+  CHECK_TRUE(decimator.Decimation(4) );
+  for (int block = 0; block < 4; block++) {
+    CHECK_EQUAL(kOutputs[block],
+                decimator.Process(&kRaw[block * 5], 1, 5, 12, filter) );
+    CHECK_EQUAL(kFiltered[block], filter.LastOutput() );
+    CHECK_EQUAL(kDecimated[block], decimator.Decimated() );
+    CHECK_EQUAL(kPending[block], decimator.Pending() );
+    CHECK_EQUAL(AdcDecimator::Q15(kRaw[block * 5 + 4], 12),
+                decimator.LastResult() );
+  }
+  CHECK_EQUAL(5U, decimator.Outputs() );
+}
+
+TEST(AdcDecimator, BlockSplitDoesNotChangeResults) {
+  AdcDecimator whole;
+  Iir16 wholeFilter;
+  wholeFilter.Tc(kTc);
+  whole.Decimation(3);
+  whole.Process(kRaw, 1, 20, 12, wholeFilter);
+
+  /* The same results interleaved with 7 other channels, in uneven blocks */
+  uint16_t interleaved[20][8] = { { 0 } };
+  for (int i = 0; i < 20; i++) {
+    interleaved[i][5] = kRaw[i];
+    interleaved[i][4] = 0xFFF;
+  }
+  decimator.Decimation(3);
+  decimator.Process(&interleaved[0][5], 8, 7, 12, filter);
+  decimator.Process(&interleaved[7][5], 8, 1, 12, filter);
+  decimator.Process(&interleaved[8][5], 8, 12, 12, filter);
+
+  CHECK_EQUAL(wholeFilter.LastOutput(), filter.LastOutput() );
+  CHECK_EQUAL(whole.Decimated(), decimator.Decimated() );
+  CHECK_EQUAL(whole.Pending(), decimator.Pending() );
+  CHECK_EQUAL(whole.Outputs(), decimator.Outputs() );
+}
+
+TEST(AdcDecimator, AverageCarriesAcrossBlocks) {
+  static const uint16_t kOnes[5] = { 1, 1, 1, 1, 1 };
+  decimator.Decimation(8);
+  CHECK_EQUAL(0, decimator.Process(kOnes, 1, 5, 15, filter) );
+  CHECK_EQUAL(5, decimator.Pending() );
+  CHECK_EQUAL(1, decimator.Process(kOnes, 1, 5, 15, filter) );
+  CHECK_EQUAL(2, decimator.Pending() );
+  CHECK_EQUAL(1, decimator.Decimated() );
+}
+
+TEST(AdcDecimator, RejectsDecimationOutOfRange) {
+  CHECK_TRUE(decimator.Decimation(AdcDecimator::DECIMATION_MAX) );
+  CHECK_FALSE(decimator.Decimation(0) );
+  CHECK_FALSE(decimator.Decimation(AdcDecimator::DECIMATION_MAX + 1) );
+  UNSIGNED_LONGS_EQUAL(AdcDecimator::DECIMATION_MAX, decimator.Decimation() );
+}
+
+TEST(AdcDecimator, FullScaleSumFitsAtLongestDecimation) {
+  static const uint16_t kFullScale[16] = {
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF
+  };
+  decimator.Decimation(AdcDecimator::DECIMATION_MAX);
+  uint16_t outputs = 0;
+  for (int block = 0; block < AdcDecimator::DECIMATION_MAX / 16; block++) {
+    outputs += decimator.Process(kFullScale, 1, 16, 16, filter);
+  }
+  CHECK_EQUAL(1, outputs);
+  CHECK_EQUAL(0x7FFF, decimator.Decimated() );
+}
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * CCIO-8 link frame and discovery tests against a simulated shift chain
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "CcioLink.h"
+
+using ClearCore::CcioLink;
+using ClearCore::CcioProbe;
+
+/** @brief Shift register of a chain of CCIO-8 boards
+ *
+ *  Every board adds an input byte and an output byte. chain[0] is the next
+ *  byte out, a sent byte enters at the far end. Asserting the select loads
+ *  the input byte of board b into chain[b], releasing it latches the output
+ *  byte of board b from chain[2n - 1 - b]. The bits on the wire are
+ *  inverted. Without boards nothing drives the line and 0 comes back.
+ */
+class ShiftChain {
+public:
+  explicit ShiftChain(uint8_t boards)
+    : boards_(boards) {
+    memset(chain_, 0, sizeof(chain_) );
+    memset(inputs, 0, sizeof(inputs) );
+    memset(outputs, 0, sizeof(outputs) );
+  }
+
+  void Select() {
+    for (uint8_t b = 0; b < boards_ && b < CcioLink::BOARDS_MAX; b++) {
+      chain_[b] = static_cast<uint8_t>(~inputs[b]);
+    }
+  }
+
+  void Release() {
+    for (uint8_t b = 0; b < boards_ && b < CcioLink::BOARDS_MAX; b++) {
+      outputs[b] = static_cast<uint8_t>(~chain_[2 * boards_ - 1 - b]);
+    }
+  }
+
+  void Transfer(const uint8_t *tx,
+                uint8_t *rx,
+                uint8_t length) {
+    const uint8_t bytes = 2 * boards_;
+    for (uint8_t i = 0; i < length; i++) {
+      if (0 == bytes) {
+        rx[i] = 0;
+        continue;
+      }
+      rx[i] = chain_[0];
+      memmove(chain_, chain_ + 1, bytes - 1);
+      chain_[bytes - 1] = tx[i];
+    }
+  }
+
+  /** Flip bits of the byte at position in the chain */
+  void Corrupt(uint8_t position,
+               uint8_t bits) {
+    chain_[position] ^= bits;
+  }
+
+  uint8_t inputs[CcioLink::BOARDS_MAX];
+  uint8_t outputs[CcioLink::BOARDS_MAX];
+
+private:
+  uint8_t boards_;
+  uint8_t chain_[2 * (CcioLink::BOARDS_MAX + 2)];
+};
+
+/** Run the probe to the end as CcioDiscover() does */
+static CcioProbe::ProbeStatus Discover(ShiftChain *chain,
+                                       CcioProbe *probe) {
+  uint8_t tx[CcioLink::FRAME_MAX];
+  uint8_t rx[CcioLink::FRAME_MAX];
+  CcioProbe::ProbeStatus status;
+  probe->Start(5);
+  chain->Select();
+  do {
+    const uint8_t length = probe->Next(tx);
+    chain->Transfer(tx, rx, length);
+    status = probe->Result(rx);
+  } while (CcioProbe::PROBE_RUNNING == status);
+  return status;
+}
+
+/** Bring the link online as CcioBoardManager::LinkStart() does */
+static void Start(ShiftChain *chain,
+                  CcioLink *link,
+                  uint8_t boards) {
+  link->Boards(boards);
+  for (int i = 0; i < 2; i++) {
+    chain->Select();
+    chain->Transfer(link->TxData(), link->RxData(), link->Length() );
+    chain->Release();
+  }
+}
+
+/** One pipelined refresh as CcioBoardManager::Refresh() does: end the frame
+ *  on the wire, decode it and start the next one with outputs */
+static CcioLink::FrameStatus Refresh(ShiftChain *chain,
+                                     CcioLink *link,
+                                     uint64_t outputs,
+                                     uint64_t *inputs) {
+  chain->Release();
+  const CcioLink::FrameStatus status = link->Receive(*inputs);
+  link->Prepare(outputs);
+  link->Swap();
+  chain->Select();
+  chain->Transfer(link->TxData(), link->RxData(), link->Length() );
+  return status;
+}
+
+static uint64_t BoardBits(const uint8_t *bytes,
+                          uint8_t boards) {
+  uint64_t bits = 0;
+  for (uint8_t b = boards; b > 0; b--) {
+    bits = (bits << 8) | bytes[b - 1];
+  }
+  return bits;
+}
+
+TEST_GROUP(CcioLink) {
+};
+
+TEST(CcioLink, MaskCoversBoards) {
+  CcioLink link;
+  link.Boards(0);
+  CHECK_EQUAL(0, link.Mask() );
+  CHECK_EQUAL(1, link.Length() );
+  link.Boards(1);
+  CHECK_EQUAL(0xFFULL, link.Mask() );
+  link.Boards(4);
+  CHECK_EQUAL(0xFFFFFFFFULL, link.Mask() );
+  link.Boards(5);
+  CHECK_EQUAL(0xFFFFFFFFFFULL, link.Mask() );
+  link.Boards(8);
+  CHECK_EQUAL(UINT64_MAX, link.Mask() );
+  CHECK_EQUAL(CcioLink::FRAME_MAX, link.Length() );
+}
+
+TEST(CcioLink, ProbeCountsBoards) {
+  for (uint8_t boards = 1; boards <= CcioLink::BOARDS_MAX; boards++) {
+    ShiftChain chain(boards);
+    CcioProbe probe;
+    LONGS_EQUAL(CcioProbe::PROBE_FOUND, Discover(&chain, &probe) );
+    LONGS_EQUAL(boards, probe.Boards() );
+  }
+}
+
+TEST(CcioLink, ProbeWithoutBoardsGivesUp) {
+  ShiftChain chain(0);
+  CcioProbe probe;
+  LONGS_EQUAL(CcioProbe::PROBE_NO_LINK, Discover(&chain, &probe) );
+  LONGS_EQUAL(0, probe.Boards() );
+}
+
+TEST(CcioLink, ProbeRejectsTooManyBoards) {
+  ShiftChain chain(CcioLink::BOARDS_MAX + 1);
+  CcioProbe probe;
+  LONGS_EQUAL(CcioProbe::PROBE_TOO_MANY, Discover(&chain, &probe) );
+  LONGS_EQUAL(0, probe.Boards() );
+}
+
+TEST(CcioLink, ProbeRunsOneTransferAtATime) {
+  ShiftChain chain(3);
+  CcioProbe probe;
+  uint8_t tx[CcioLink::FRAME_MAX];
+  uint8_t rx[CcioLink::FRAME_MAX];
+  int transfers = 0;
+  probe.Start(5);
+  CcioProbe::ProbeStatus status;
+  do {
+    const uint8_t length = probe.Next(tx);
+    chain.Transfer(tx, rx, length);
+    status = probe.Result(rx);
+    transfers++;
+  } while (CcioProbe::PROBE_RUNNING == status);
+  LONGS_EQUAL(CcioProbe::PROBE_FOUND, status);
+  LONGS_EQUAL(3, probe.Boards() );
+  /* Ones, zeros and the count, none of them lost */
+  LONGS_EQUAL(3, transfers);
+}
+
+TEST(CcioLink, FirstRefreshAfterStartChecksOut) {
+  for (uint8_t boards = 1; boards <= CcioLink::BOARDS_MAX; boards++) {
+    ShiftChain chain(boards);
+    CcioLink link;
+    for (uint8_t b = 0; b < boards; b++) {
+      chain.inputs[b] = static_cast<uint8_t>(0x11 * (b + 1) );
+    }
+    Start(&chain, &link, boards);
+    uint64_t inputs = 0;
+    LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0, &inputs) );
+    CHECK_EQUAL(BoardBits(chain.inputs, boards), inputs);
+    for (uint8_t b = 0; b < boards; b++) {
+      LONGS_EQUAL(0, chain.outputs[b]);
+    }
+  }
+}
+
+TEST(CcioLink, OutputsAndInputsRoundTrip) {
+  for (uint8_t boards = 1; boards <= CcioLink::BOARDS_MAX; boards++) {
+    ShiftChain chain(boards);
+    CcioLink link;
+    Start(&chain, &link, boards);
+    uint64_t inputs = 0;
+    uint64_t pattern = 0x0123456789ABCDEFULL;
+    for (int refresh = 0; refresh < 20; refresh++) {
+      const uint64_t outputs = pattern & link.Mask();
+      for (uint8_t b = 0; b < boards; b++) {
+        chain.inputs[b] = static_cast<uint8_t>(pattern >> (8 * b) ) ^ 0x5A;
+      }
+      const uint64_t expected_inputs = BoardBits(chain.inputs, boards);
+      LONGS_EQUAL(CcioLink::FRAME_OK,
+                  Refresh(&chain, &link, outputs, &inputs) );
+      /* The outputs are latched when the next refresh ends their frame */
+      chain.Release();
+      CHECK_EQUAL(outputs, BoardBits(chain.outputs, boards) );
+      /* The inputs were loaded when the frame started */
+      LONGS_EQUAL(CcioLink::FRAME_OK,
+                  Refresh(&chain, &link, outputs, &inputs) );
+      CHECK_EQUAL(expected_inputs, inputs);
+      pattern = (pattern << 7) | (pattern >> 57);
+    }
+  }
+}
+
+TEST(CcioLink, RefreshIsPipelinedOneFrameDeep) {
+  ShiftChain chain(2);
+  CcioLink link;
+  Start(&chain, &link, 2);
+  uint64_t inputs = 0;
+
+  /* Refresh k starts the frame with the outputs of k, refresh k + 1 ends
+   * it and latches them */
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x0102, &inputs) );
+  CHECK_EQUAL(0, BoardBits(chain.outputs, 2) );
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x0304, &inputs) );
+  CHECK_EQUAL(0x0102, BoardBits(chain.outputs, 2) );
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x0304, &inputs) );
+  CHECK_EQUAL(0x0304, BoardBits(chain.outputs, 2) );
+}
+
+TEST(CcioLink, MissingBoardBreaksTheMarker) {
+  ShiftChain chain(2);
+  CcioLink link;
+  Start(&chain, &link, 3);
+  uint64_t inputs = 0x55;
+  LONGS_EQUAL(CcioLink::FRAME_MARKER_ERROR,
+              Refresh(&chain, &link, 0, &inputs) );
+  CHECK_EQUAL(0x55, inputs);
+}
+
+TEST(CcioLink, CorruptedOutputIsAnEchoError) {
+  ShiftChain chain(3);
+  CcioLink link;
+  Start(&chain, &link, 3);
+  uint64_t inputs = 0;
+  chain.inputs[0] = 0xA5;
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x00FF00, &inputs) );
+  /* Flip a bit of the output bytes on their way back, the next transfer
+   * shifts them out and the refresh after it decodes that frame */
+  chain.Corrupt(4, 0x08);
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x00FF00, &inputs) );
+  inputs = 0x1234;
+  LONGS_EQUAL(CcioLink::FRAME_ECHO_ERROR,
+              Refresh(&chain, &link, 0x00FF00, &inputs) );
+  CHECK_EQUAL(0x1234, inputs);
+  /* The next frame is clean again */
+  LONGS_EQUAL(CcioLink::FRAME_OK, Refresh(&chain, &link, 0x00FF00, &inputs) );
+  CHECK_EQUAL(0xA5, inputs);
+}
+
+TEST(CcioLink, StaleMarkerIsNotReused) {
+  ShiftChain chain(1);
+  CcioLink link;
+  Start(&chain, &link, 1);
+  uint64_t inputs = 0;
+  LONGS_EQUAL(CcioLink::FRAME_OK, link.Receive(inputs) );
+  /* No transfer in between, as if the transfer had not run */
+  LONGS_EQUAL(CcioLink::FRAME_MARKER_ERROR, link.Receive(inputs) );
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * Explicit message throttle tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "explicit_throttle.h"
+
+}
+
+TEST_GROUP(ExplicitThrottle) {
+  void setup() {
+    ExplicitThrottleInitialize(0);
+    ExplicitThrottleResetCounters();
+  }
+};
+
+TEST(ExplicitThrottle, BucketStartsFullAndRefillsWithTheRate) {
+  TokenBucket bucket;
+  TokenBucketInitialize(&bucket, 100, 3, 0);
+  for(int i = 0; i < 3; i++) {
+    CHECK_TRUE(TokenBucketRefill(&bucket, 0) );
+    TokenBucketTake(&bucket);
+  }
+  CHECK_FALSE(TokenBucketRefill(&bucket, 0) );
+  /* 100 tokens per second is one every 10ms */
+  CHECK_FALSE(TokenBucketRefill(&bucket, 9) );
+  CHECK_TRUE(TokenBucketRefill(&bucket, 10) );
+  TokenBucketTake(&bucket);
+  CHECK_FALSE(TokenBucketRefill(&bucket, 10) );
+  /* never more than the burst, also after a long pause */
+  CHECK_TRUE(TokenBucketRefill(&bucket, 1000000) );
+  CHECK_EQUAL(3000U, bucket.level);
+}
+
+TEST(ExplicitThrottle, RateZeroAdmitsEverything) {
+  TokenBucket bucket;
+  TokenBucketInitialize(&bucket, 0, 0, 0);
+  for(int i = 0; i < 100; i++) {
+    CHECK_TRUE(TokenBucketRefill(&bucket, 0) );
+    TokenBucketTake(&bucket);
+  }
+}
+
+TEST(ExplicitThrottle, SessionBucketLimitsOneSocket) {
+  int admitted = 0;
+  for(int pass = 0; pass < 100; pass++) {
+    ExplicitThrottleStartPass();
+    admitted += ExplicitThrottleAdmit(3, 0);
+  }
+  CHECK_EQUAL(OPENER_EXPLICIT_SESSION_BURST, admitted);
+  CHECK_EQUAL(100 - OPENER_EXPLICIT_SESSION_BURST,
+              ExplicitThrottleGetCounters()->session_throttled);
+
+  /* another socket has its own bucket */
+  ExplicitThrottleStartPass();
+  CHECK_TRUE(ExplicitThrottleAdmit(4, 0) );
+
+  /* a closed socket gives its bucket back, the next one starts full */
+  ExplicitThrottleRemoveSocket(3);
+  ExplicitThrottleStartPass();
+  CHECK_TRUE(ExplicitThrottleAdmit(3, 0) );
+}
+
+TEST(ExplicitThrottle, PassHandlesALimitedNumberOfMessages) {
+  ExplicitThrottleStartPass();
+  for(int socket = 0; socket < OPENER_EXPLICIT_MESSAGES_PER_PASS; socket++) {
+    CHECK_TRUE(ExplicitThrottleAdmit(socket, 0) );
+  }
+  CHECK_FALSE(ExplicitThrottleAdmit(OPENER_EXPLICIT_MESSAGES_PER_PASS, 0) );
+  CHECK_EQUAL(1, ExplicitThrottleGetCounters()->pass_limited);
+  ExplicitThrottleStartPass();
+  CHECK_TRUE(ExplicitThrottleAdmit(OPENER_EXPLICIT_MESSAGES_PER_PASS, 0) );
+}
+
+TEST(ExplicitThrottle, GlobalBucketLimitsAllSockets) {
+  int admitted = 0;
+  for(int pass = 0; pass < 100; pass++) {
+    ExplicitThrottleStartPass();
+    for(int socket = 0; socket < OPENER_NUMBER_OF_SUPPORTED_SESSIONS;
+        socket++) {
+      admitted += ExplicitThrottleAdmit(socket, 0);
+    }
+  }
+  CHECK_EQUAL(OPENER_EXPLICIT_GLOBAL_BURST, admitted);
+  CHECK(ExplicitThrottleGetCounters()->global_throttled > 0);
+  CHECK_EQUAL(admitted, ExplicitThrottleGetCounters()->admitted);
+}
+
+/** @brief Load model of NetworkHandlerProcessCyclic() on a simulated clock
+ *
+ *  Every socket always has a message waiting, each message takes
+ *  message_us of CPU. The connection manager produces when
+ *  kOpenerTimerTickInMilliSeconds has passed at one of its calls, which the
+ *  handler makes at the start of a pass, after every explicit message and
+ *  at the end of a pass. The result is the latest production after its due
+ *  time.
+ */
+static uint32_t RunFlood(const bool throttled,
+                         const int sockets,
+                         const uint32_t message_us,
+                         const uint32_t duration_ms,
+                         uint32_t *const messages) {
+  const uint32_t tick_us = kOpenerTimerTickInMilliSeconds * 1000U;
+  const uint32_t pass_us = 50;
+  uint32_t now_us = 0;
+  uint32_t next_production_us = tick_us;
+  uint32_t worst_lateness_us = 0;
+  int first_socket = 0;
+  *messages = 0;
+
+  ExplicitThrottleInitialize(0);
+  while(now_us < duration_ms * 1000U) {
+    /* ManageConnectionsWhenDue() */
+    for(int call = 0; call < 2 + sockets; call++) {
+      if(call > 0 && call <= sockets) {
+        const int socket = (first_socket + call - 1) % sockets;
+        if(throttled) {
+          if(1 == call) {
+            ExplicitThrottleStartPass();
+          }
+          if(!ExplicitThrottleAdmit(socket, now_us / 1000U) ) {
+            continue;
+          }
+        }
+        now_us += message_us;
+        (*messages)++;
+        if(!throttled) {
+          continue; /* the old handler checked the time after the socket loop */
+        }
+      } else if(call > sockets) {
+        now_us += pass_us;
+      }
+      if(now_us >= next_production_us) {
+        const uint32_t lateness_us = now_us - next_production_us;
+        if(lateness_us > worst_lateness_us) {
+          worst_lateness_us = lateness_us;
+        }
+        next_production_us = now_us + tick_us;
+      }
+    }
+    first_socket++;
+  }
+  return worst_lateness_us;
+}
+
+TEST(ExplicitThrottle, FloodKeepsIoProductionOnTime) {
+  const int sockets = OPENER_NUMBER_OF_SUPPORTED_SESSIONS;
+  const uint32_t message_us = 1500; /* a large Get_Attributes_All */
+  const uint32_t duration_ms = 10000;
+  uint32_t messages = 0;
+
+  const uint32_t unthrottled_lateness_us =
+    RunFlood(false, sockets, message_us, duration_ms, &messages);
+  /* a pass over all sockets takes longer than a tick */
+  CHECK(unthrottled_lateness_us > kOpenerTimerTickInMilliSeconds * 1000U);
+
+  ExplicitThrottleResetCounters();
+  const uint32_t lateness_us =
+    RunFlood(true, sockets, message_us, duration_ms, &messages);
+  /* a production waits for one explicit message at most */
+  CHECK(lateness_us <= message_us + 50);
+
+  /* the explicit messages get the global rate */
+  CHECK(messages <= OPENER_EXPLICIT_GLOBAL_RATE * duration_ms / 1000U +
+                    OPENER_EXPLICIT_GLOBAL_BURST);
+  CHECK(messages >= OPENER_EXPLICIT_GLOBAL_RATE * duration_ms / 1000U / 2);
+  CHECK_EQUAL(messages, ExplicitThrottleGetCounters()->admitted);
+  CHECK(ExplicitThrottleGetCounters()->global_throttled > 0);
+}
+
+TEST(ExplicitThrottle, FloodOfOneSessionLeavesRoomForTheOthers) {
+  uint32_t messages = 0;
+  const uint32_t lateness_us = RunFlood(true, 1, 1500, 10000, &messages);
+  CHECK(lateness_us <= 1500 + 50);
+  CHECK(messages <= OPENER_EXPLICIT_SESSION_RATE * 10 +
+                    OPENER_EXPLICIT_SESSION_BURST);
+  CHECK(ExplicitThrottleGetCounters()->session_throttled > 0);
+}
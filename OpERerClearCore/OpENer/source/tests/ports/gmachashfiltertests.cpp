@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * GMAC multicast hash filter tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+
+#include "GmacHashFilter.h"
+
+using ClearCore::GmacHashFilter;
+
+/** @brief Hash index the way the datasheet lists it, one XOR term per
+ *  address bit */
+static uint8_t ReferenceIndex(const uint8_t *mac) {
+  uint8_t index = 0;
+  for(uint8_t n = 0; n < 6; n++) {
+    uint8_t bit = 0;
+    for(uint8_t k = n; k < 48; k += 6) {
+      bit ^= (mac[k / 8] >> (k % 8) ) & 1;
+    }
+    index |= bit << n;
+  }
+  return index;
+}
+
+/** @brief Group address as lwIP stores it, first octet in the low byte */
+static uint32_t Group(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  return a | (b << 8) | (c << 16) | ( (uint32_t)d << 24 );
+}
+
+TEST_GROUP(GmacHashFilter) {
+};
+
+TEST(GmacHashFilter, MapsGroupsToMulticastMacs) {
+  uint8_t mac[6];
+
+  GmacHashFilter::MulticastMac(Group(239, 192, 1, 0), mac);
+  LONGS_EQUAL(0x01, mac[0]);
+  LONGS_EQUAL(0x00, mac[1]);
+  LONGS_EQUAL(0x5E, mac[2]);
+  /* the top bit of the second octet is not part of the MAC */
+  LONGS_EQUAL(0x40, mac[3]);
+  LONGS_EQUAL(0x01, mac[4]);
+  LONGS_EQUAL(0x00, mac[5]);
+}
+
+TEST(GmacHashFilter, IndexMatchesTheDatasheet) {
+  static const uint8_t macs[][6] = {
+    { 0x01, 0x00, 0x5E, 0x00, 0x00, 0x01 },
+    { 0x01, 0x00, 0x5E, 0x40, 0x01, 0x00 },
+    { 0x01, 0x00, 0x5E, 0x40, 0x01, 0x1F },
+    { 0x01, 0x00, 0x5E, 0x7F, 0xFF, 0xFF },
+    { 0x24, 0x15, 0x10, 0xB0, 0x00, 0x01 },
+    { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+  };
+
+  for(unsigned i = 0; i < sizeof(macs) / sizeof(macs[0]); i++) {
+    LONGS_EQUAL(ReferenceIndex(macs[i]), GmacHashFilter::Index(macs[i]) );
+  }
+  /* all 48 bits set fold to an even count in every index bit */
+  LONGS_EQUAL(0, GmacHashFilter::Index(macs[5]) );
+  /* a single address bit selects the index bit it folds into */
+  const uint8_t bit13[6] = { 0x00, 0x20, 0x00, 0x00, 0x00, 0x00 };
+  LONGS_EQUAL(1 << (13 % 6), GmacHashFilter::Index(bit13) );
+}
+
+TEST(GmacHashFilter, SetsTheRegisterOfTheIndex) {
+  GmacHashFilter filter;
+  uint8_t mac[6];
+
+  CHECK_TRUE(filter.Empty() );
+  GmacHashFilter::MulticastMac(Group(224, 0, 0, 1), mac);
+  uint8_t index = GmacHashFilter::Index(mac);
+  CHECK_TRUE(filter.Add(mac) );
+  CHECK_FALSE(filter.Empty() );
+  if(index < 32) {
+    UNSIGNED_LONGS_EQUAL(1UL << index, filter.Bottom() );
+    UNSIGNED_LONGS_EQUAL(0, filter.Top() );
+  } else {
+    UNSIGNED_LONGS_EQUAL(0, filter.Bottom() );
+    UNSIGNED_LONGS_EQUAL(1UL << (index - 32), filter.Top() );
+  }
+  CHECK_TRUE(filter.Remove(mac) );
+  CHECK_TRUE(filter.Empty() );
+}
+
+TEST(GmacHashFilter, KeepsASharedBitUntilTheLastGroupLeaves) {
+  GmacHashFilter filter;
+  uint8_t first[6];
+  uint8_t second[6];
+
+  /* find a second group that hashes onto the bit of the first */
+  GmacHashFilter::MulticastMac(Group(239, 192, 1, 0), first);
+  uint32_t host = 1;
+  do {
+    GmacHashFilter::MulticastMac(Group(239, 192, 1, host++), second);
+  } while(GmacHashFilter::Index(second) != GmacHashFilter::Index(first) );
+
+  CHECK_TRUE(filter.Add(first) );
+  CHECK_FALSE(filter.Add(second) );
+  CHECK_FALSE(filter.Remove(first) );
+  CHECK_FALSE(filter.Empty() );
+  CHECK_TRUE(filter.Remove(second) );
+  CHECK_TRUE(filter.Empty() );
+  /* removing a group that never joined leaves the filter alone */
+  CHECK_FALSE(filter.Remove(first) );
+}
+
+TEST(GmacHashFilter, ResetDropsAllGroups) {
+  GmacHashFilter filter;
+  uint8_t mac[6];
+
+  for(uint32_t host = 0; host < 32; host++) {
+    GmacHashFilter::MulticastMac(Group(239, 192, 1, host), mac);
+    filter.Add(mac);
+  }
+  CHECK_FALSE(filter.Empty() );
+  filter.Reset();
+  CHECK_TRUE(filter.Empty() );
+  CHECK_TRUE(filter.Add(mac) );
+}
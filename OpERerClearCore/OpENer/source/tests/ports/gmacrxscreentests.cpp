@@ -0,0 +1,460 @@
+/*******************************************************************************
+ * Screening of received frames and the arbitration of the receive queues,
+ * with a replayed broadcast storm
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "GmacRxScreen.h"
+
+using ClearCore::GmacRxRing;
+using ClearCore::GmacRxScreen;
+using ClearCore::RxArbiter;
+
+static const uint16_t kIoPort = 2222;
+static const uint16_t kEncapsulationPort = 44818;
+
+/** @brief Frame of a capture, the parts the model looks at */
+typedef struct {
+  uint32_t time_us;
+  std::vector<uint8_t> data;
+} CapturedFrame;
+
+static void Put16(std::vector<uint8_t> &frame, uint16_t value) {
+  frame.push_back(value >> 8);
+  frame.push_back(value & 0xFF);
+}
+
+static void Put32Le(std::vector<uint8_t> &capture, uint32_t value) {
+  for(int i = 0; i < 4; i++) {
+    capture.push_back( (value >> (8 * i) ) & 0xFF );
+  }
+}
+
+static uint32_t Get32Le(const uint8_t *data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) | ( (uint32_t)data[3] <<
+                                                        24 );
+}
+
+/** @brief Ethernet header, optionally with an 802.1Q tag */
+static std::vector<uint8_t> EthernetHeader(bool broadcast, uint16_t type,
+                                           bool tagged = false) {
+  std::vector<uint8_t> frame;
+  const uint8_t device[6] = { 0x24, 0x15, 0x10, 0xB0, 0x00, 0x01 };
+  for(int i = 0; i < 6; i++) {
+    frame.push_back(broadcast ? 0xFF : device[i]);
+  }
+  for(int i = 0; i < 6; i++) {
+    frame.push_back(0x02 + i);
+  }
+  if(tagged) {
+    Put16(frame, 0x8100);
+    Put16(frame, 0xA000); /* priority 5, VLAN 0 */
+  }
+  Put16(frame, type);
+  return frame;
+}
+
+/** @brief IPv4 UDP datagram with @p payload_len bytes of @p fill */
+static std::vector<uint8_t> UdpFrame(bool broadcast, uint16_t port,
+                                     uint16_t payload_len, uint8_t fill,
+                                     bool tagged = false,
+                                     uint8_t protocol = 17,
+                                     uint16_t fragment = 0,
+                                     uint8_t options = 0) {
+  std::vector<uint8_t> frame = EthernetHeader(broadcast, 0x0800, tagged);
+  uint16_t header_len = 20 + 4 * options;
+  frame.push_back(0x40 | (header_len / 4) );
+  frame.push_back(0);
+  Put16(frame, header_len + 8 + payload_len);
+  Put16(frame, 0x1234);
+  Put16(frame, fragment);
+  frame.push_back(64);
+  frame.push_back(protocol);
+  Put16(frame, 0);
+  const uint8_t source[4] = { 192, 168, 1, 10 };
+  const uint8_t destination[4] = { 192, 168, 1, 100 };
+  for(int i = 0; i < 4; i++) {
+    frame.push_back(source[i]);
+  }
+  for(int i = 0; i < 4; i++) {
+    frame.push_back(broadcast ? 0xFF : destination[i]);
+  }
+  for(int i = 0; i < 4 * options; i++) {
+    frame.push_back(1); /* NOP */
+  }
+  Put16(frame, 2222);
+  Put16(frame, port);
+  Put16(frame, 8 + payload_len);
+  Put16(frame, 0);
+  frame.insert(frame.end(), payload_len, fill);
+  return frame;
+}
+
+static std::vector<uint8_t> ArpFrame(void) {
+  std::vector<uint8_t> frame = EthernetHeader(true, 0x0806);
+  frame.insert(frame.end(), 28, 0);
+  return frame;
+}
+
+static GmacRxScreen::Queues Classify(const std::vector<uint8_t> &frame) {
+  GmacRxScreen screen;
+  return screen.Classify(&frame[0], frame.size() );
+}
+
+/** @brief Write @p frames as a libpcap capture, microsecond time stamps */
+static std::vector<uint8_t> WriteCapture(
+  const std::vector<CapturedFrame> &frames) {
+  std::vector<uint8_t> capture;
+  Put32Le(capture, 0xA1B2C3D4);
+  Put32Le(capture, 2 | (4 << 16) ); /* version 2.4 */
+  Put32Le(capture, 0); /* GMT */
+  Put32Le(capture, 0); /* accuracy */
+  Put32Le(capture, 65535); /* snap length */
+  Put32Le(capture, 1); /* Ethernet */
+  for(size_t i = 0; i < frames.size(); i++) {
+    Put32Le(capture, frames[i].time_us / 1000000);
+    Put32Le(capture, frames[i].time_us % 1000000);
+    Put32Le(capture, frames[i].data.size() );
+    Put32Le(capture, frames[i].data.size() );
+    capture.insert(capture.end(), frames[i].data.begin(),
+                   frames[i].data.end() );
+  }
+  return capture;
+}
+
+/** @brief Read the frames of a libpcap capture back */
+static std::vector<CapturedFrame> ReadCapture(
+  const std::vector<uint8_t> &capture) {
+  std::vector<CapturedFrame> frames;
+  CHECK(capture.size() >= 24);
+  LONGS_EQUAL(0xA1B2C3D4, Get32Le(&capture[0]) );
+  LONGS_EQUAL(1, Get32Le(&capture[20]) );
+  for(size_t at = 24; at + 16 <= capture.size(); ) {
+    CapturedFrame frame;
+    frame.time_us = Get32Le(&capture[at]) * 1000000 +
+                    Get32Le(&capture[at + 4]);
+    uint32_t len = Get32Le(&capture[at + 8]);
+    at += 16;
+    CHECK(at + len <= capture.size() );
+    frame.data.assign(capture.begin() + at, capture.begin() + at + len);
+    at += len;
+    frames.push_back(frame);
+  }
+  return frames;
+}
+
+static bool Earlier(const CapturedFrame &a, const CapturedFrame &b) {
+  return a.time_us < b.time_us;
+}
+
+/** @brief Two seconds of class 1 I/O at an RPI of about 1 ms, with a
+ *  ListIdentity broadcast every 12 us and an ARP request every millisecond
+ *  in between */
+static std::vector<uint8_t> StormCapture(void) {
+  std::vector<CapturedFrame> frames;
+  for(uint32_t time_us = 0; time_us < 2000000; time_us += 12) {
+    CapturedFrame list_identity = {
+      time_us, UdpFrame(true, kEncapsulationPort, 24, 0x63)
+    };
+    frames.push_back(list_identity);
+  }
+  for(uint32_t time_us = 7; time_us < 2000000; time_us += 1000) {
+    CapturedFrame arp = { time_us, ArpFrame() };
+    frames.push_back(arp);
+  }
+  /* the originator's clock drifts against the one of the capture */
+  for(uint16_t sequence = 0; sequence < 2000; sequence++) {
+    CapturedFrame io = {
+      5U + sequence * 997U, UdpFrame(false, kIoPort, 36, 0)
+    };
+    /* the sequence count in the first bytes of the payload */
+    io.data[42] = sequence >> 8;
+    io.data[43] = sequence & 0xFF;
+    frames.push_back(io);
+  }
+  /* time order, as captured */
+  std::stable_sort(frames.begin(), frames.end(), Earlier);
+  return WriteCapture(frames);
+}
+
+/** @brief Frames that fit the RX ring of the GMAC, one 128 byte buffer each */
+static const size_t kRingFrames = 16;
+/** @brief Time between two calls of Refresh() */
+static const uint32_t kRefreshUs = 100;
+/** @brief Frames LwIP gets through in one Refresh() */
+static const uint8_t kLwipFrames = 4;
+
+/** @brief What the firmware passed to LwIP */
+typedef struct {
+  uint32_t io_frames;
+  uint32_t io_late; /* more than a refresh after they arrived */
+  uint32_t io_out_of_order;
+  uint32_t other_frames;
+  uint32_t ring_overruns;
+} Delivered;
+
+static void Deliver(const CapturedFrame &frame, uint32_t now_us,
+                    Delivered *delivered, int32_t *last_sequence) {
+  if(GmacRxScreen::QUEUE_IO == Classify(frame.data) ) {
+    int32_t sequence = (frame.data[42] << 8) | frame.data[43];
+    delivered->io_frames++;
+    if(now_us - frame.time_us > kRefreshUs) {
+      delivered->io_late++;
+    }
+    if(sequence <= *last_sequence) {
+      delivered->io_out_of_order++;
+    }
+    *last_sequence = sequence;
+  } else {
+    delivered->other_frames++;
+  }
+}
+
+/** @brief Replay @p capture into the RX ring, with a Refresh() every
+ *  kRefreshUs that either serves the ring in order or screens it first */
+static Delivered Replay(const std::vector<uint8_t> &capture, bool screened) {
+  std::vector<CapturedFrame> frames = ReadCapture(capture);
+  std::vector<const CapturedFrame *> ring;
+  GmacRxScreen screen;
+  RxArbiter<const CapturedFrame *, 4, 6> queues;
+  Delivered delivered = { 0, 0, 0, 0, 0 };
+  int32_t last_sequence = -1;
+
+  size_t next = 0;
+  for(uint32_t now_us = kRefreshUs; next < frames.size();
+      now_us += kRefreshUs) {
+    for(; next < frames.size() && frames[next].time_us < now_us; next++) {
+      if(ring.size() == kRingFrames) {
+        delivered.ring_overruns++;
+      } else {
+        ring.push_back(&frames[next]);
+      }
+    }
+    const CapturedFrame *frame;
+    if(!screened) {
+      for(uint8_t i = 0; i < kLwipFrames && !ring.empty(); i++) {
+        Deliver(*ring.front(), now_us, &delivered, &last_sequence);
+        ring.erase(ring.begin() );
+      }
+      continue;
+    }
+    for(size_t i = 0; i < ring.size(); i++) {
+      GmacRxScreen::Queues queue =
+        screen.Classify(&ring[i]->data[0], ring[i]->data.size() );
+      queues.Push(queue, ring[i]);
+    }
+    ring.clear();
+    queues.Round(kLwipFrames);
+    while(queues.Pop(frame) ) {
+      Deliver(*frame, now_us, &delivered, &last_sequence);
+    }
+  }
+  return delivered;
+}
+
+TEST_GROUP(GmacRxScreen) {
+};
+
+TEST(GmacRxScreen, ClassifiesClassOneIo) {
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO, Classify(UdpFrame(false, kIoPort, 8,
+                                                        0) ) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO, Classify(UdpFrame(true, kIoPort, 8,
+                                                        0) ) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO,
+              Classify(UdpFrame(false, kIoPort, 8, 0, true) ) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO,
+              Classify(UdpFrame(false, kIoPort, 8, 0, false, 17, 0x4000,
+                                2) ) );
+}
+
+TEST(GmacRxScreen, LeavesEverythingElse) {
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER,
+              Classify(UdpFrame(true, kEncapsulationPort, 24, 0x63) ) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER, Classify(ArpFrame() ) );
+  /* TCP to the port */
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER,
+              Classify(UdpFrame(false, kIoPort, 8, 0, false, 6) ) );
+  /* a later fragment has no UDP header */
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER,
+              Classify(UdpFrame(false, kIoPort, 8, 0, false, 17, 0x0010) ) );
+}
+
+TEST(GmacRxScreen, NeedsTheHeaders) {
+  std::vector<uint8_t> frame = UdpFrame(false, kIoPort, 8, 0);
+  GmacRxScreen screen;
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO, screen.Classify(&frame[0], 38) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER, screen.Classify(&frame[0], 37) );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER, screen.Classify(&frame[0], 13) );
+}
+
+TEST(GmacRxScreen, PortCanBeChanged) {
+  std::vector<uint8_t> frame = UdpFrame(false, 2223, 8, 0);
+  GmacRxScreen screen;
+  LONGS_EQUAL(kIoPort, screen.Port() );
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER,
+              screen.Classify(&frame[0], frame.size() ) );
+  screen.Port(2223);
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO,
+              screen.Classify(&frame[0], frame.size() ) );
+}
+
+TEST(GmacRxScreen, ServesIoFirst) {
+  RxArbiter<int, 4, 4> queues;
+  GmacRxScreen::Queues queue;
+  int item = -1;
+  queues.Round(4);
+  CHECK(queues.Push(GmacRxScreen::QUEUE_OTHER, 1) );
+  CHECK(queues.Push(GmacRxScreen::QUEUE_OTHER, 2) );
+  CHECK(queues.Push(GmacRxScreen::QUEUE_IO, 3) );
+  CHECK(queues.Pop(item, &queue) );
+  LONGS_EQUAL(3, item);
+  LONGS_EQUAL(GmacRxScreen::QUEUE_IO, queue);
+  CHECK(queues.Push(GmacRxScreen::QUEUE_IO, 4) );
+  CHECK(queues.Pop(item) );
+  LONGS_EQUAL(4, item);
+  CHECK(queues.Pop(item, &queue) );
+  LONGS_EQUAL(1, item);
+  LONGS_EQUAL(GmacRxScreen::QUEUE_OTHER, queue);
+  CHECK(queues.Pop(item) );
+  LONGS_EQUAL(2, item);
+  CHECK_FALSE(queues.Pop(item) );
+}
+
+TEST(GmacRxScreen, LimitsOtherFramesPerRound) {
+  RxArbiter<int, 2, 4> queues;
+  int item = -1;
+  for(int i = 0; i < 4; i++) {
+    CHECK(queues.Push(GmacRxScreen::QUEUE_OTHER, i) );
+  }
+  queues.Round(3);
+  for(int i = 0; i < 3; i++) {
+    CHECK(queues.Pop(item) );
+    LONGS_EQUAL(i, item);
+  }
+  CHECK_FALSE(queues.Pop(item) );
+  /* I/O is not limited */
+  CHECK(queues.Push(GmacRxScreen::QUEUE_IO, 10) );
+  CHECK(queues.Pop(item) );
+  LONGS_EQUAL(10, item);
+  LONGS_EQUAL(1, queues.Count(GmacRxScreen::QUEUE_OTHER) );
+  queues.Round(3);
+  CHECK(queues.Pop(item) );
+  LONGS_EQUAL(3, item);
+}
+
+TEST(GmacRxScreen, DropsWhenFull) {
+  RxArbiter<int, 2, 3> queues;
+  for(int i = 0; i < 3; i++) {
+    CHECK(queues.Push(GmacRxScreen::QUEUE_OTHER, i) );
+  }
+  CHECK(queues.Full(GmacRxScreen::QUEUE_OTHER) );
+  CHECK_FALSE(queues.Full(GmacRxScreen::QUEUE_IO) );
+  CHECK_FALSE(queues.Push(GmacRxScreen::QUEUE_OTHER, 3) );
+  queues.Drop(GmacRxScreen::QUEUE_OTHER);
+  LONGS_EQUAL(2, queues.Dropped(GmacRxScreen::QUEUE_OTHER) );
+  LONGS_EQUAL(0, queues.Dropped(GmacRxScreen::QUEUE_IO) );
+  CHECK(queues.Push(GmacRxScreen::QUEUE_IO, 4) );
+  CHECK(queues.Push(GmacRxScreen::QUEUE_IO, 5) );
+  CHECK_FALSE(queues.Push(GmacRxScreen::QUEUE_IO, 6) );
+  LONGS_EQUAL(1, queues.Dropped(GmacRxScreen::QUEUE_IO) );
+}
+
+TEST(GmacRxScreen, ReplayedStormLosesIoWithoutScreening) {
+  /* the receive path before screening, for comparison */
+  Delivered delivered = Replay(StormCapture(), false);
+  CHECK(delivered.ring_overruns > 0);
+  CHECK(delivered.io_frames < 2000);
+}
+
+TEST(GmacRxScreen, ReplayedStormKeepsIoOnTime) {
+  Delivered delivered = Replay(StormCapture(), true);
+  LONGS_EQUAL(2000, delivered.io_frames);
+  LONGS_EQUAL(0, delivered.io_late);
+  LONGS_EQUAL(0, delivered.io_out_of_order);
+  LONGS_EQUAL(0, delivered.ring_overruns);
+  /* the storm is not starved either, LwIP stays busy with it */
+  CHECK(delivered.other_frames >= 2000000 / kRefreshUs * (kLwipFrames - 1) );
+}
+
+/** @brief The bits of a GMAC receive descriptor that the ring walk reads */
+typedef struct {
+  struct {
+    uint32_t LEN : 13;
+    uint32_t SF : 1;
+    uint32_t EF : 1;
+    uint32_t OWN : 1;
+  } bit;
+} RxDesc;
+
+static const uint32_t kRingCount = 6;
+
+/** @brief Hand buffer @p index of the ring to software */
+static void Received(RxDesc *ring, uint32_t index, bool sf, bool ef,
+                     uint32_t len) {
+  ring[index].bit.OWN = 1;
+  ring[index].bit.SF = sf;
+  ring[index].bit.EF = ef;
+  ring[index].bit.LEN = len;
+}
+
+TEST_GROUP(GmacRxRing) {
+  RxDesc ring[kRingCount];
+  uint32_t first;
+  uint32_t last;
+
+  void setup() {
+    memset(ring, 0, sizeof(ring) );
+    first = kRingCount;
+    last = kRingCount;
+  }
+};
+
+TEST(GmacRxRing, FindsAFrameOfOneBuffer) {
+  Received(ring, 0, true, true, 60);
+  CHECK(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 0, first, last) );
+  LONGS_EQUAL(0, first);
+  LONGS_EQUAL(0, last);
+}
+
+TEST(GmacRxRing, FindsAFrameAcrossTheWrap) {
+  Received(ring, 4, true, false, 128);
+  Received(ring, 5, false, false, 128);
+  Received(ring, 0, false, true, 300);
+  CHECK(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 4, first, last) );
+  LONGS_EQUAL(0, first);
+  LONGS_EQUAL(2, last);
+}
+
+TEST(GmacRxRing, WaitsForTheEndOfTheFrame) {
+  Received(ring, 0, true, false, 128);
+  CHECK_FALSE(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 0, first, last) );
+}
+
+/* The tail of a frame whose start was lost is at the head of the ring. Its EF
+ * ends nothing, the frame after it is the first, for PacketHeader() as well as
+ * for PacketLength() and PacketRead(), so RxScreen() takes it off the ring. */
+TEST(GmacRxRing, SkipsAnEndWithoutAStart) {
+  Received(ring, 2, false, true, 200);
+  Received(ring, 3, true, false, 128);
+  Received(ring, 4, false, true, 150);
+  CHECK(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 2, first, last) );
+  LONGS_EQUAL(1, first);
+  LONGS_EQUAL(2, last);
+
+  /* the tail alone is no frame */
+  ring[3].bit.OWN = 0;
+  ring[4].bit.OWN = 0;
+  CHECK_FALSE(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 2, first, last) );
+}
+
+TEST(GmacRxRing, StopsAtABufferOwnedByTheGmac) {
+  Received(ring, 0, true, false, 128);
+  Received(ring, 2, false, true, 60);
+  CHECK_FALSE(GmacRxRing<RxDesc>::Frame(ring, kRingCount, 0, first, last) );
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Software Internet checksum and checksum-on-copy tests against the RFC 1071
+ * reference
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InetChecksum.h"
+
+using ClearCore::InetChecksum;
+
+/** @brief RFC 1071 sum of byte pairs, returned in the byte order of the
+ *  buffer as LWIP_CHKSUM does */
+static uint16_t ReferenceSum(const uint8_t *data, int len) {
+  uint32_t sum = 0;
+  for(; len > 1; len -= 2, data += 2) {
+    sum += (uint32_t)data[0] << 8 | data[1];
+  }
+  if(len > 0) {
+    sum += (uint32_t)data[0] << 8;
+  }
+  while(sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  const uint8_t bytes[2] = { (uint8_t)(sum >> 8), (uint8_t)sum };
+  uint16_t in_memory;
+  memcpy(&in_memory, bytes, sizeof(in_memory) );
+  return in_memory;
+}
+
+TEST_GROUP(InetChecksum) {
+};
+
+TEST(InetChecksum, MatchesTheRfcExample) {
+  /* RFC 1071 section 3: the sum of these bytes is ddf2 */
+  const uint8_t data[] = { 0x00, 0x01, 0xF2, 0x03, 0xF4, 0xF5, 0xF6, 0xF7 };
+  const uint8_t expected[] = { 0xDD, 0xF2 };
+  uint16_t sum = InetChecksum::Sum(data, sizeof(data) );
+  MEMCMP_EQUAL(expected, &sum, sizeof(sum) );
+}
+
+TEST(InetChecksum, ValidIpHeaderSumsToAllOnes) {
+  /* 192.168.1.100 -> 239.192.1.32, UDP, with its header checksum */
+  const uint8_t header[] = {
+    0x45, 0x00, 0x00, 0x40, 0x12, 0x34, 0x00, 0x00, 0x01, 0x11, 0x00, 0x00,
+    0xC0, 0xA8, 0x01, 0x64, 0xEF, 0xC0, 0x01, 0x20
+  };
+  uint8_t checked[sizeof(header)];
+  memcpy(checked, header, sizeof(header) );
+  uint16_t checksum = (uint16_t)~InetChecksum::Sum(header, sizeof(header) );
+  memcpy(&checked[10], &checksum, sizeof(checksum) );
+  LONGS_EQUAL(0xFFFF, InetChecksum::Sum(checked, sizeof(checked) ) );
+}
+
+TEST(InetChecksum, MatchesTheReferenceAtAllAlignments) {
+  uint8_t buffer[1600] __attribute__( (aligned(4) ) );
+  srand(41);
+  for(unsigned i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = (uint8_t)rand();
+  }
+  for(int offset = 0; offset < 4; offset++) {
+    for(int len = 0; len <= 80; len++) {
+      LONGS_EQUAL(ReferenceSum(buffer + offset, len),
+                  InetChecksum::Sum(buffer + offset, len) );
+    }
+    LONGS_EQUAL(ReferenceSum(buffer + offset, 1500),
+                InetChecksum::Sum(buffer + offset, 1500) );
+    LONGS_EQUAL(ReferenceSum(buffer + offset, 1501),
+                InetChecksum::Sum(buffer + offset, 1501) );
+  }
+}
+
+TEST(InetChecksum, CarriesOfAllOnesData) {
+  uint8_t buffer[1600];
+  memset(buffer, 0xFF, sizeof(buffer) );
+  LONGS_EQUAL(0xFFFF, InetChecksum::Sum(buffer, sizeof(buffer) ) );
+  LONGS_EQUAL(0xFFFF, InetChecksum::Sum(buffer + 1, 1498) );
+  LONGS_EQUAL(ReferenceSum(buffer + 1, 1499),
+              InetChecksum::Sum(buffer + 1, 1499) );
+  buffer[0] = 0x00;
+  buffer[1] = 0x01;
+  LONGS_EQUAL(ReferenceSum(buffer, 1600), InetChecksum::Sum(buffer, 1600) );
+}
+
+TEST(InetChecksum, EmptyBufferSumsToZero) {
+  const uint8_t data[1] = { 0xAB };
+  LONGS_EQUAL(0, InetChecksum::Sum(data, 0) );
+}
+
+TEST(InetChecksum, MatchesTheReferenceForRandomBuffers) {
+  uint8_t buffer[1600 + 8] __attribute__( (aligned(4) ) );
+  srand(42);
+  for(unsigned i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = (uint8_t)rand();
+  }
+  for(int i = 0; i < 2000; i++) {
+    int offset = rand() % 8;
+    int len = rand() % 1601;
+    LONGS_EQUAL(ReferenceSum(buffer + offset, len),
+                InetChecksum::Sum(buffer + offset, len) );
+  }
+}
+
+TEST(InetChecksum, CopyCopiesAndSums) {
+  uint8_t source[1600 + 8] __attribute__( (aligned(4) ) );
+  uint8_t copy[1600 + 16] __attribute__( (aligned(4) ) );
+  srand(43);
+  for(unsigned i = 0; i < sizeof(source); i++) {
+    source[i] = (uint8_t)rand();
+  }
+  for(int i = 0; i < 2000; i++) {
+    /* same and different offsets from a word address */
+    int source_offset = rand() % 8;
+    int copy_offset = rand() % 8;
+    int len = rand() % 1601;
+    memset(copy, 0xA5, sizeof(copy) );
+    uint16_t sum = InetChecksum::Copy(copy + copy_offset,
+                                      source + source_offset, len);
+    MEMCMP_EQUAL(source + source_offset, copy + copy_offset, len);
+    LONGS_EQUAL(ReferenceSum(copy + copy_offset, len), sum);
+    /* nothing around the copy is touched */
+    for(int j = 0; j < copy_offset; j++) {
+      LONGS_EQUAL(0xA5, copy[j]);
+    }
+    for(unsigned j = copy_offset + len; j < sizeof(copy); j++) {
+      LONGS_EQUAL(0xA5, copy[j]);
+    }
+  }
+}
+
+TEST(InetChecksum, CopyOfAllOnesData) {
+  uint8_t source[1500] __attribute__( (aligned(4) ) );
+  uint8_t copy[1500] __attribute__( (aligned(4) ) );
+  memset(source, 0xFF, sizeof(source) );
+  LONGS_EQUAL(0xFFFF, InetChecksum::Copy(copy, source, sizeof(copy) ) );
+  LONGS_EQUAL(0xFFFF, InetChecksum::Copy(copy + 1, source + 1, 1498) );
+  LONGS_EQUAL(0, InetChecksum::Copy(copy, source, 0) );
+}
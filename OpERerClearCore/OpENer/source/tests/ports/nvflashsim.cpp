@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * File backed flash simulator for the NV store tests
+ *
+ ******************************************************************************/
+
+#include "nvflashsim.h"
+
+#include <string.h>
+
+static unsigned char NextRandom(NvFlashSim *sim) {
+  sim->random = sim->random * 1103515245U + 12345U;
+  return (unsigned char)(sim->random >> 16);
+}
+
+/** Count an operation, false when the power is or goes off */
+static bool Operate(NvFlashSim *sim) {
+  if (!sim->powered) {
+    return false;
+  }
+  if (sim->operations_left > 0 && 0 == --sim->operations_left) {
+    sim->powered = false;
+    return false;
+  }
+  return true;
+}
+
+static void ReadFile(NvFlashSim *sim,
+                     size_t offset,
+                     void *data,
+                     size_t length) {
+  fseek(sim->file, (long)offset, SEEK_SET);
+  size_t done = fread(data, 1, length, sim->file);
+  (void)done;
+}
+
+static void WriteFile(NvFlashSim *sim,
+                      size_t offset,
+                      const void *data,
+                      size_t length) {
+  fseek(sim->file, (long)offset, SEEK_SET);
+  fwrite(data, 1, length, sim->file);
+  fflush(sim->file);
+}
+
+static int SimRead(void *context,
+                   size_t offset,
+                   void *data,
+                   size_t length) {
+  NvFlashSim *sim = (NvFlashSim *)context;
+  if (!sim->powered ||
+      offset + length > sim->flash.sector_size * sim->flash.sector_count) {
+    return -1;
+  }
+  ReadFile(sim, offset, data, length);
+  return 0;
+}
+
+static int SimProgram(void *context,
+                      size_t offset,
+                      const void *data,
+                      size_t length) {
+  NvFlashSim *sim = (NvFlashSim *)context;
+  const unsigned char *bytes = (const unsigned char *)data;
+  if (0 != offset % kNvStoreUnit || 0 != length % kNvStoreUnit ||
+      offset + length > sim->flash.sector_size * sim->flash.sector_count) {
+    sim->violation = true;
+    return -1;
+  }
+  for (size_t done = 0; done < length; done += kNvStoreUnit) {
+    if (!sim->powered) {
+      return -1;
+    }
+    unsigned char unit[kNvStoreUnit];
+    ReadFile(sim, offset + done, unit, kNvStoreUnit);
+    for (size_t i = 0; i < kNvStoreUnit; i++) {
+      if (0xFF != unit[i]) {
+        sim->violation = true;
+      }
+    }
+    bool completes = Operate(sim);
+    for (size_t i = 0; i < kNvStoreUnit; i++) {
+      /* Cut off while programming, only some bits went down */
+      unsigned char mask = completes ? 0 : NextRandom(sim);
+      unit[i] &= bytes[done + i] | mask;
+    }
+    WriteFile(sim, offset + done, unit, kNvStoreUnit);
+    sim->program_count++;
+    if (!completes) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int SimErase(void *context,
+                    size_t offset) {
+  NvFlashSim *sim = (NvFlashSim *)context;
+  size_t size = sim->flash.sector_size;
+  if (0 != offset % size || offset >= size * sim->flash.sector_count) {
+    sim->violation = true;
+    return -1;
+  }
+  if (!sim->powered) {
+    return -1;
+  }
+  bool completes = Operate(sim);
+  unsigned char *sector = new unsigned char[size];
+  ReadFile(sim, offset, sector, size);
+  for (size_t i = 0; i < size; i++) {
+    /* Cut off while erasing, only some bits went up */
+    sector[i] |= completes ? 0xFF : NextRandom(sim);
+  }
+  WriteFile(sim, offset, sector, size);
+  delete[] sector;
+  sim->erase_count[offset / size]++;
+  return completes ? 0 : -1;
+}
+
+void NvFlashSimOpen(NvFlashSim *sim,
+                    size_t sector_size,
+                    size_t sector_count) {
+  memset(sim, 0, sizeof(*sim) );
+  sim->flash.sector_size = sector_size;
+  sim->flash.sector_count = sector_count;
+  sim->flash.read_data = SimRead;
+  sim->flash.program_data = SimProgram;
+  sim->flash.erase_sector = SimErase;
+  sim->flash.context = sim;
+  sim->file = tmpfile();
+  sim->operations_left = -1;
+  sim->powered = true;
+  sim->random = 1;
+
+  unsigned char erased[256];
+  memset(erased, 0xFF, sizeof(erased) );
+  for (size_t done = 0; done < sector_size * sector_count;
+       done += sizeof(erased) ) {
+    WriteFile(sim, done, erased, sizeof(erased) );
+  }
+}
+
+void NvFlashSimClose(NvFlashSim *sim) {
+  if (NULL != sim->file) {
+    fclose(sim->file);
+    sim->file = NULL;
+  }
+}
+
+void NvFlashSimCutAt(NvFlashSim *sim,
+                     long operation) {
+  sim->operations_left = operation;
+}
+
+void NvFlashSimPowerOn(NvFlashSim *sim) {
+  sim->operations_left = -1;
+  sim->powered = true;
+}
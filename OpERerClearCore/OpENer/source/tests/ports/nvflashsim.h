@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * File backed flash simulator for the NV store tests
+ *
+ ******************************************************************************/
+#ifndef TESTS_PORTS_NVFLASHSIM_H_
+#define TESTS_PORTS_NVFLASHSIM_H_
+
+#include <stdio.h>
+
+extern "C" {
+
+#include "nvstore.h"
+
+}
+
+/** Most sectors of a simulated flash */
+#define kNvFlashSimMaxSectors 8U
+
+/** Flash kept in a temporary file, with the rules of the SAME53 main flash:
+ *  erase sets a whole sector to 0xFF, program only clears bits of erased
+ *  units. A power cut can be scheduled after a number of unit programs and
+ *  sector erases; the operation hit is left half done, bits randomly
+ *  programmed or erased, and the flash fails all access until power is
+ *  restored.
+ */
+typedef struct {
+  NvStoreFlash flash;
+  FILE *file;
+  long operations_left; /**< operations until the power cut, < 0: never */
+  bool powered;
+  unsigned int random;
+  unsigned long program_count; /**< units programmed */
+  unsigned long erase_count[kNvFlashSimMaxSectors];
+  bool violation; /**< a unit was programmed twice or misaligned */
+} NvFlashSim;
+
+/** Create an erased flash */
+void NvFlashSimOpen(NvFlashSim *sim,
+                    size_t sector_size,
+                    size_t sector_count);
+
+void NvFlashSimClose(NvFlashSim *sim);
+
+/** Cut the power during the given operation, counting from 1 */
+void NvFlashSimCutAt(NvFlashSim *sim,
+                     long operation);
+
+/** Restore power, like a reboot of the device */
+void NvFlashSimPowerOn(NvFlashSim *sim);
+
+#endif /* TESTS_PORTS_NVFLASHSIM_H_ */
@@ -0,0 +1,306 @@
+/*******************************************************************************
+ * Log-structured NV store tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "nvflashsim.h"
+
+/* Small sectors so that a few dozen records already move sectors */
+static const size_t kSectorSize = 1024;
+static const size_t kSectorCount = 3;
+
+/** A 40 byte value made from a key and a version */
+static void MakeValue(uint8_t *value,
+                      uint16_t key,
+                      unsigned int version) {
+  memcpy( value, &version, sizeof(version) );
+  for (size_t i = sizeof(version); i < 40; i++) {
+    value[i] = (uint8_t)(key * 31 + i);
+  }
+}
+
+/** Version of the value of a key, -1 if missing or not made by MakeValue() */
+static int ValueVersion(NvStore *store,
+                        uint16_t key,
+                        unsigned int versions) {
+  uint8_t value[64];
+  size_t length = 0;
+  if (kEipStatusOk != NvStoreGet(store, key, value, sizeof(value), &length) ||
+      40 != length) {
+    return -1;
+  }
+  for (unsigned int version = 0; version < versions; version++) {
+    uint8_t expected[40];
+    MakeValue(expected, key, version);
+    if (0 == memcmp(value, expected, sizeof(expected) ) ) {
+      return (int)version;
+    }
+  }
+  return -1;
+}
+
+TEST_GROUP(NvStore) {
+  NvFlashSim sim;
+  NvStore store;
+
+  void setup() {
+    NvFlashSimOpen(&sim, kSectorSize, kSectorCount);
+    LONGS_EQUAL( kEipStatusOk, NvStoreMount(&store, &sim.flash) );
+  }
+
+  void teardown() {
+    CHECK_FALSE(sim.violation);
+    NvFlashSimClose(&sim);
+  }
+
+  /** Reboot: forget everything in RAM and mount again */
+  void Remount() {
+    NvFlashSimPowerOn(&sim);
+    LONGS_EQUAL( kEipStatusOk, NvStoreMount(&store, &sim.flash) );
+  }
+
+  void Store(uint16_t key,
+             unsigned int version) {
+    uint8_t value[40];
+    MakeValue(value, key, version);
+    LONGS_EQUAL( kEipStatusOk, NvStoreSet(&store, key, value, sizeof(value) ) );
+    LONGS_EQUAL( kEipStatusOk, NvStoreFlush(&store) );
+  }
+};
+
+TEST(NvStore, Crc32CheckValue) {
+  UNSIGNED_LONGS_EQUAL( 0xCBF43926UL, NvStoreCrc32("123456789", 9) );
+}
+
+TEST(NvStore, BlankFlashMountsEmpty) {
+  uint8_t value[8];
+  LONGS_EQUAL( kEipStatusError,
+               NvStoreGet(&store, 1, value, sizeof(value), NULL) );
+  Remount();
+  LONGS_EQUAL( kEipStatusError,
+               NvStoreGet(&store, 1, value, sizeof(value), NULL) );
+}
+
+TEST(NvStore, ValueSurvivesReboot) {
+  Store(7, 3);
+  Remount();
+  LONGS_EQUAL( 3, ValueVersion(&store, 7, 4) );
+}
+
+TEST(NvStore, SetIsStagedUntilQuiet) {
+  uint8_t value[40];
+  MakeValue(value, 1, 1);
+  unsigned long programmed = sim.program_count;
+  NvStoreSet(&store, 1, value, sizeof(value) );
+  CHECK_TRUE( NvStoreHasStaged(&store) );
+  LONGS_EQUAL( 1, ValueVersion(&store, 1, 2) );
+
+  NvStoreProcess(&store, kNvStoreQuietMs - 1);
+  UNSIGNED_LONGS_EQUAL(programmed, sim.program_count);
+  NvStoreProcess(&store, 1);
+  CHECK_FALSE( NvStoreHasStaged(&store) );
+  CHECK(sim.program_count > programmed);
+
+  Remount();
+  LONGS_EQUAL( 1, ValueVersion(&store, 1, 2) );
+}
+
+TEST(NvStore, BurstIsOneFlush) {
+  uint8_t value[40];
+  for (unsigned int version = 0; version < 10; version++) {
+    MakeValue(value, 1, version);
+    NvStoreSet(&store, 1, value, sizeof(value) );
+    MakeValue(value, 2, version);
+    NvStoreSet(&store, 2, value, sizeof(value) );
+    NvStoreProcess(&store, kNvStoreQuietMs / 2);
+  }
+  UNSIGNED_LONGS_EQUAL(0, store.flush_count);
+  NvStoreProcess(&store, kNvStoreQuietMs);
+  UNSIGNED_LONGS_EQUAL(1, store.flush_count);
+  /* Two records of one header and three data units */
+  UNSIGNED_LONGS_EQUAL(1 + 2 * 4, sim.program_count);
+
+  Remount();
+  LONGS_EQUAL( 9, ValueVersion(&store, 1, 10) );
+  LONGS_EQUAL( 9, ValueVersion(&store, 2, 10) );
+}
+
+TEST(NvStore, SteadySetsFlushAfterMaxDelay) {
+  uint8_t value[40];
+  MakeValue(value, 1, 0);
+  for (uint32_t elapsed = 0; elapsed < kNvStoreMaxDelayMs;
+       elapsed += kNvStoreQuietMs / 2) {
+    UNSIGNED_LONGS_EQUAL(0, store.flush_count);
+    NvStoreSet(&store, 1, value, sizeof(value) );
+    NvStoreProcess(&store, kNvStoreQuietMs / 2);
+  }
+  UNSIGNED_LONGS_EQUAL(1, store.flush_count);
+}
+
+TEST(NvStore, UnchangedValueIsNotWritten) {
+  Store(1, 5);
+  unsigned long programmed = sim.program_count;
+  Store(1, 5);
+  UNSIGNED_LONGS_EQUAL(programmed, sim.program_count);
+  UNSIGNED_LONGS_EQUAL(1, store.flush_count);
+}
+
+TEST(NvStore, FullStagingFlushesFirst) {
+  for (uint16_t key = 1; key <= kNvStoreStagedSlots + 1; key++) {
+    uint8_t value[40];
+    MakeValue(value, key, 0);
+    LONGS_EQUAL( kEipStatusOk, NvStoreSet(&store, key, value, sizeof(value) ) );
+  }
+  UNSIGNED_LONGS_EQUAL(1, store.flush_count);
+  Remount();
+  LONGS_EQUAL( 0, ValueVersion(&store, 1, 1) );
+  LONGS_EQUAL( -1, ValueVersion(&store, kNvStoreStagedSlots + 1, 1) );
+}
+
+TEST(NvStore, TooLongValueIsRejected) {
+  static uint8_t value[kNvStoreMaxValueLength + 1];
+  LONGS_EQUAL( kEipStatusError,
+               NvStoreSet(&store, 1, value, sizeof(value) ) );
+  LONGS_EQUAL( kEipStatusOk,
+               NvStoreSet(&store, 1, value, kNvStoreMaxValueLength) );
+  LONGS_EQUAL( kEipStatusOk, NvStoreFlush(&store) );
+}
+
+TEST(NvStore, LiveDataBeyondASectorIsRefused) {
+  static uint8_t value[kNvStoreMaxValueLength];
+  LONGS_EQUAL( kEipStatusOk,
+               NvStoreSet(&store, 1, value, sizeof(value) ) );
+  LONGS_EQUAL( kEipStatusOk,
+               NvStoreSet(&store, 2, value, sizeof(value) ) );
+  LONGS_EQUAL( kEipStatusOk,
+               NvStoreSet(&store, 3, value, sizeof(value) ) );
+  LONGS_EQUAL( kEipStatusError, NvStoreFlush(&store) );
+  CHECK_FALSE( NvStoreHasStaged(&store) );
+  Remount();
+  size_t length = 0;
+  LONGS_EQUAL( kEipStatusOk,
+               NvStoreGet(&store, 2, value, sizeof(value), &length) );
+  LONGS_EQUAL( kEipStatusError,
+               NvStoreGet(&store, 3, value, sizeof(value), &length) );
+}
+
+TEST(NvStore, SectorsWearEvenly) {
+  for (unsigned int version = 0; version < 600; version++) {
+    Store(1 + version % 5, version);
+  }
+  unsigned long least = sim.erase_count[0];
+  unsigned long most = sim.erase_count[0];
+  for (size_t sector = 1; sector < kSectorCount; sector++) {
+    least = sim.erase_count[sector] < least ? sim.erase_count[sector] : least;
+    most = sim.erase_count[sector] > most ? sim.erase_count[sector] : most;
+  }
+  CHECK(least >= 10);
+  CHECK(most - least <= 1);
+
+  Remount();
+  for (uint16_t key = 1; key <= 5; key++) {
+    LONGS_EQUAL( 595 + key - 1, ValueVersion(&store, key, 600) );
+  }
+}
+
+TEST(NvStore, FormatForgetsAllKeys) {
+  Store(1, 0);
+  Store(2, 0);
+  LONGS_EQUAL( kEipStatusOk, NvStoreFormat(&store) );
+  LONGS_EQUAL( -1, ValueVersion(&store, 1, 1) );
+  Remount();
+  LONGS_EQUAL( -1, ValueVersion(&store, 1, 1) );
+  LONGS_EQUAL( -1, ValueVersion(&store, 2, 1) );
+}
+
+/* Cut the power at every flash operation of a run of updates that moves
+ * sectors several times. After the reboot every key must hold the last
+ * value acknowledged by NvStoreFlush() or the one being written, and the
+ * store must keep taking new values. The last key is never updated, it has to
+ * survive the moves of its sector. */
+TEST(NvStore, PowerCutAtEveryOperation) {
+  const unsigned int kUpdates = 60;
+  const uint16_t kKeys = 3;
+
+  for (long cut = 1;; cut++) {
+    NvFlashSimClose(&sim);
+    NvFlashSimOpen(&sim, kSectorSize, kSectorCount);
+    LONGS_EQUAL( kEipStatusOk, NvStoreMount(&store, &sim.flash) );
+    for (uint16_t key = 1; key <= kKeys; key++) {
+      Store(key, 0);
+    }
+
+    unsigned int acknowledged[kKeys + 1] = { 0 };
+    unsigned int attempted[kKeys + 1] = { 0 };
+    NvFlashSimCutAt(&sim, cut);
+    for (unsigned int version = 1; version <= kUpdates; version++) {
+      uint16_t key = (uint16_t)(1 + version % (kKeys - 1) );
+      uint8_t value[40];
+      MakeValue(value, key, version);
+      NvStoreSet(&store, key, value, sizeof(value) );
+      attempted[key] = version;
+      if (kEipStatusOk != NvStoreFlush(&store) ) {
+        break;
+      }
+      acknowledged[key] = version;
+    }
+    bool was_cut = !sim.powered;
+
+    Remount();
+    for (uint16_t key = 1; key <= kKeys; key++) {
+      int version = ValueVersion(&store, key, kUpdates + 1);
+      if (version != (int)acknowledged[key] &&
+          version != (int)attempted[key]) {
+        FAIL("key lost its value after a power cut");
+      }
+    }
+    for (unsigned int version = 1; version <= kUpdates; version++) {
+      Store(1, version);
+    }
+    Remount();
+    LONGS_EQUAL( kUpdates, ValueVersion(&store, 1, kUpdates + 1) );
+    LONGS_EQUAL( 0, ValueVersion(&store, kKeys, 1) );
+    CHECK_FALSE(sim.violation);
+
+    if (!was_cut) {
+      /* The run completed before the cut, all operations were covered */
+      CHECK(cut > 100);
+      break;
+    }
+  }
+}
+
+/* Power lost again while recovering from a power cut */
+TEST(NvStore, PowerCutDuringRecovery) {
+  for (long cut = 1; cut < 400; cut += 7) {
+    NvFlashSimClose(&sim);
+    NvFlashSimOpen(&sim, kSectorSize, kSectorCount);
+    LONGS_EQUAL( kEipStatusOk, NvStoreMount(&store, &sim.flash) );
+    Store(5, 0);
+    for (unsigned int version = 0; version < 40; version++) {
+      Store(1 + version % 2, version);
+    }
+    NvFlashSimCutAt(&sim, cut);
+    for (unsigned int version = 40; version < 80; version++) {
+      uint8_t value[40];
+      MakeValue(value, 1 + version % 2, version);
+      NvStoreSet(&store, 1 + version % 2, value, sizeof(value) );
+      if (kEipStatusOk != NvStoreFlush(&store) ) {
+        break;
+      }
+    }
+    for (long again = 1; again < 4; again++) {
+      NvFlashSimPowerOn(&sim);
+      NvFlashSimCutAt(&sim, again);
+      NvStoreMount(&store, &sim.flash);
+    }
+    Remount();
+    CHECK(ValueVersion(&store, 1, 80) >= 38);
+    CHECK(ValueVersion(&store, 2, 80) >= 39);
+    LONGS_EQUAL( 0, ValueVersion(&store, 5, 1) );
+  }
+}
@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * File backed SD card simulator for the waveform capture tests
+ *
+ ******************************************************************************/
+
+#include "sdfilesim.h"
+
+#include <string.h>
+
+static int SimBegin(void *context,
+                    uint32_t block,
+                    uint32_t count) {
+  SdFileSim *sim = (SdFileSim *)context;
+  if (sim->open || block >= sim->device.block_count) {
+    sim->violation = true;
+    return -1;
+  }
+  sim->open = true;
+  sim->next_block = block;
+  sim->expected = count;
+  sim->begin_count++;
+  return 0;
+}
+
+static int SimWrite(void *context,
+                    const void *data,
+                    uint32_t count) {
+  SdFileSim *sim = (SdFileSim *)context;
+  if (!sim->open || 0 == count ||
+      sim->next_block + count > sim->device.block_count) {
+    sim->violation = true;
+    return -1;
+  }
+  if (++sim->write_count == (unsigned long)sim->fail_write) {
+    return -1;
+  }
+  fseek(sim->file, (long)sim->next_block * kWaveCaptureBlockSize, SEEK_SET);
+  fwrite(data, kWaveCaptureBlockSize, count, sim->file);
+  fflush(sim->file);
+  sim->next_block += count;
+  sim->blocks_written += count;
+  if (count > sim->largest_write) {
+    sim->largest_write = count;
+  }
+  return 0;
+}
+
+static int SimEnd(void *context) {
+  SdFileSim *sim = (SdFileSim *)context;
+  if (!sim->open) {
+    sim->violation = true;
+    return -1;
+  }
+  sim->open = false;
+  return 0;
+}
+
+void SdFileSimOpen(SdFileSim *sim,
+                   uint32_t block_count) {
+  memset(sim, 0, sizeof(*sim) );
+  sim->device.block_count = block_count;
+  sim->device.begin = SimBegin;
+  sim->device.write_blocks = SimWrite;
+  sim->device.end = SimEnd;
+  sim->device.context = sim;
+  sim->file = tmpfile();
+
+  unsigned char zero[kWaveCaptureBlockSize] = { 0 };
+  for (uint32_t block = 0; block < block_count; block++) {
+    fwrite(zero, 1, sizeof(zero), sim->file);
+  }
+  fflush(sim->file);
+}
+
+void SdFileSimClose(SdFileSim *sim) {
+  if (NULL != sim->file) {
+    fclose(sim->file);
+    sim->file = NULL;
+  }
+}
+
+void SdFileSimRead(SdFileSim *sim,
+                   uint32_t block,
+                   void *data,
+                   uint32_t count) {
+  fseek(sim->file, (long)block * kWaveCaptureBlockSize, SEEK_SET);
+  size_t done = fread(data, kWaveCaptureBlockSize, count, sim->file);
+  (void)done;
+}
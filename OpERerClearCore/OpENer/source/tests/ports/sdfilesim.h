@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * File backed SD card simulator for the waveform capture tests
+ *
+ ******************************************************************************/
+#ifndef TESTS_PORTS_SDFILESIM_H_
+#define TESTS_PORTS_SDFILESIM_H_
+
+#include <stdio.h>
+
+extern "C" {
+
+#include "wavecapture.h"
+
+}
+
+/** SD card kept in a temporary file, written like the SdCardDriver stream:
+ *  a begin opens a stream of contiguous blocks, writes append whole blocks
+ *  and an end closes it. Using a stream that is not open, opening a second
+ *  one or writing past the card is a violation. A write can be made to fail
+ *  to test the recovery of the capture.
+ */
+typedef struct {
+  WaveCaptureDevice device;
+  FILE *file;
+  bool open; /**< a stream is open */
+  uint32_t next_block; /**< block the next write goes to */
+  unsigned long begin_count;
+  unsigned long write_count; /**< write calls */
+  unsigned long blocks_written;
+  uint32_t largest_write; /**< most blocks of one write call */
+  uint32_t expected; /**< block count given to the last begin */
+  long fail_write; /**< write call that fails, counting from 1, 0: none */
+  bool violation;
+} SdFileSim;
+
+/** Create a card of zeroed blocks */
+void SdFileSimOpen(SdFileSim *sim,
+                   uint32_t block_count);
+
+void SdFileSimClose(SdFileSim *sim);
+
+/** Read blocks back from the card */
+void SdFileSimRead(SdFileSim *sim,
+                   uint32_t block,
+                   void *data,
+                   uint32_t count);
+
+#endif /* TESTS_PORTS_SDFILESIM_H_ */
@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * UART DMA ring tests against a simulated DMA channel
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "SerialDmaRing.h"
+
+using ClearCore::SerialDmaRx;
+using ClearCore::SerialDmaTx;
+
+static const uint16_t kRingSize = 16;
+
+typedef SerialDmaRx<kRingSize> RxRing;
+typedef SerialDmaTx<kRingSize> TxRing;
+
+/** @brief Circular receive DMA: one beat per character into the ring,
+ *  reloading the block at its end */
+class RxDma {
+public:
+  explicit RxDma(RxRing *ring)
+    : ring_(ring), remaining_(kRingSize), next_(0) {
+  }
+
+  void Receive(uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+      ring_->Buffer()[kRingSize - remaining_] = next_++;
+      if (--remaining_ == 0) {
+        remaining_ = kRingSize;
+      }
+    }
+  }
+
+  /** The index the DMA writes next, as SerialBase derives it */
+  uint16_t Pos() const {
+    return kRingSize - remaining_;
+  }
+
+private:
+  RxRing *ring_;
+  uint16_t remaining_;
+  uint8_t next_;
+};
+
+TEST_GROUP(SerialDmaRing) {
+};
+
+TEST(SerialDmaRing, RxReadsAcrossTheWrap) {
+  RxRing ring;
+  RxDma dma(&ring);
+  uint8_t buf[kRingSize];
+
+  dma.Receive(10);
+  LONGS_EQUAL(10, ring.Available(dma.Pos() ) );
+  LONGS_EQUAL(10, ring.Read(dma.Pos(), buf, sizeof(buf) ) );
+  LONGS_EQUAL(0, buf[0]);
+  LONGS_EQUAL(9, buf[9]);
+
+  dma.Receive(12);
+  LONGS_EQUAL(12, ring.Available(dma.Pos() ) );
+  LONGS_EQUAL(12, ring.Read(dma.Pos(), buf, sizeof(buf) ) );
+  for (uint8_t i = 0; i < 12; i++) {
+    LONGS_EQUAL(10 + i, buf[i]);
+  }
+  LONGS_EQUAL(0, ring.Available(dma.Pos() ) );
+}
+
+TEST(SerialDmaRing, RxSpansEndAtTheWrap) {
+  RxRing ring;
+  RxDma dma(&ring);
+  const uint8_t *data;
+
+  dma.Receive(10);
+  ring.Consume(10);
+  dma.Receive(9);
+  LONGS_EQUAL(6, ring.Span(dma.Pos(), data) );
+  LONGS_EQUAL(10, data[0]);
+  ring.Consume(6);
+  LONGS_EQUAL(3, ring.Span(dma.Pos(), data) );
+  LONGS_EQUAL(16, data[0]);
+  ring.Consume(3);
+  LONGS_EQUAL(0, ring.Span(dma.Pos(), data) );
+}
+
+TEST(SerialDmaRing, RxPeekAndDiscard) {
+  RxRing ring;
+  RxDma dma(&ring);
+  uint8_t buf[4];
+
+  LONGS_EQUAL(-1, ring.Peek(dma.Pos() ) );
+  dma.Receive(3);
+  LONGS_EQUAL(0, ring.Peek(dma.Pos() ) );
+  LONGS_EQUAL(3, ring.Available(dma.Pos() ) );
+  ring.Discard(dma.Pos() );
+  LONGS_EQUAL(0, ring.Available(dma.Pos() ) );
+  dma.Receive(1);
+  LONGS_EQUAL(1, ring.Read(dma.Pos(), buf, sizeof(buf) ) );
+  LONGS_EQUAL(3, buf[0]);
+}
+
+TEST(SerialDmaRing, RxTrackFindsOverflow) {
+  RxRing ring;
+  RxDma dma(&ring);
+
+  dma.Receive(kRingSize - 1);
+  CHECK_FALSE(ring.Track(dma.Pos(), 2) );
+  LONGS_EQUAL(kRingSize - 1, ring.Available(dma.Pos() ) );
+  /* One more wraps onto the oldest unread character */
+  dma.Receive(1);
+  CHECK_TRUE(ring.Track(dma.Pos(), 2) );
+
+  /* Nothing is lost while the reader keeps up */
+  ring.Discard(dma.Pos() );
+  for (int i = 0; i < 10; i++) {
+    dma.Receive(kRingSize - 1);
+    CHECK_FALSE(ring.Track(dma.Pos(), 2) );
+    ring.Consume(ring.Available(dma.Pos() ) );
+  }
+}
+
+TEST(SerialDmaRing, RxTrackFindsTheIdleLine) {
+  RxRing ring;
+  RxDma dma(&ring);
+
+  /* A quiet line is idle from the start */
+  CHECK_FALSE(ring.Track(dma.Pos(), 3) );
+  CHECK_FALSE(ring.Track(dma.Pos(), 3) );
+  CHECK_FALSE(ring.Track(dma.Pos(), 3) );
+  CHECK_TRUE(ring.Idle(dma.Pos() ) );
+
+  dma.Receive(2);
+  ring.Track(dma.Pos(), 3);
+  CHECK_FALSE(ring.Idle(dma.Pos() ) );
+  ring.Track(dma.Pos(), 3);
+  ring.Track(dma.Pos(), 3);
+  CHECK_FALSE(ring.Idle(dma.Pos() ) );
+  ring.Track(dma.Pos(), 3);
+  CHECK_TRUE(ring.Idle(dma.Pos() ) );
+  /* Stays idle until the next character */
+  ring.Track(dma.Pos(), 3);
+  CHECK_TRUE(ring.Idle(dma.Pos() ) );
+  /* A character that is not tracked yet already ends the idle line */
+  dma.Receive(1);
+  CHECK_FALSE(ring.Idle(dma.Pos() ) );
+  ring.Track(dma.Pos(), 3);
+  CHECK_FALSE(ring.Idle(dma.Pos() ) );
+}
+
+TEST(SerialDmaRing, TxBlocksEndAtTheWrap) {
+  TxRing ring;
+  uint8_t buf[kRingSize];
+  const uint8_t *data;
+  for (uint8_t i = 0; i < kRingSize; i++) {
+    buf[i] = i;
+  }
+
+  LONGS_EQUAL(kRingSize - 1, ring.Space() );
+  LONGS_EQUAL(10, ring.Write(buf, 10) );
+  LONGS_EQUAL(10, ring.Next(data) );
+  /* One block at a time */
+  LONGS_EQUAL(0, ring.Next(data) );
+  CHECK_TRUE(ring.Busy() );
+  LONGS_EQUAL(10, ring.Pending() );
+  ring.Done();
+  LONGS_EQUAL(0, ring.Pending() );
+
+  LONGS_EQUAL(9, ring.Write(buf, 9) );
+  LONGS_EQUAL(6, ring.Next(data) );
+  LONGS_EQUAL(0, data[0]);
+  ring.Done();
+  LONGS_EQUAL(3, ring.Next(data) );
+  LONGS_EQUAL(6, data[0]);
+  ring.Done();
+  CHECK_FALSE(ring.Busy() );
+  LONGS_EQUAL(0, ring.Next(data) );
+}
+
+TEST(SerialDmaRing, TxKeepsOneSlotFree) {
+  TxRing ring;
+  uint8_t buf[kRingSize + 4] = { 0 };
+  uint8_t *span;
+
+  LONGS_EQUAL(kRingSize - 1, ring.Write(buf, sizeof(buf) ) );
+  LONGS_EQUAL(0, ring.Space() );
+  LONGS_EQUAL(0, ring.Span(span) );
+  LONGS_EQUAL(0, ring.Write(buf, 1) );
+}
+
+TEST(SerialDmaRing, TxComposesInPlace) {
+  TxRing ring;
+  uint8_t *span;
+  const uint8_t *data;
+
+  LONGS_EQUAL(kRingSize - 1, ring.Span(span) );
+  memcpy(span, "ABCDEFGHIJKL", 12);
+  ring.Commit(12);
+  LONGS_EQUAL(12, ring.Next(data) );
+  MEMCMP_EQUAL("ABCDEFGHIJKL", data, 12);
+  /* Space behind the block in flight is not handed out */
+  LONGS_EQUAL(3, ring.Span(span) );
+  ring.Done();
+  /* The free space runs to the end of the ring */
+  LONGS_EQUAL(4, ring.Span(span) );
+}
+
+TEST(SerialDmaRing, TxStreamArrivesInOrder) {
+  TxRing ring;
+  uint8_t sent[256];
+  uint8_t wire[256];
+  uint16_t queued = 0;
+  uint16_t received = 0;
+  for (uint16_t i = 0; i < sizeof(sent); i++) {
+    sent[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+
+  /* Uneven writes against a DMA that takes one block per round */
+  uint16_t chunk = 1;
+  while (received < sizeof(sent) ) {
+    uint16_t len = chunk;
+    if (len > sizeof(sent) - queued) {
+      len = sizeof(sent) - queued;
+    }
+    queued += ring.Write(&sent[queued], len);
+    chunk = (chunk % 11) + 1;
+
+    const uint8_t *data;
+    uint16_t block = ring.Next(data);
+    memcpy(&wire[received], data, block);
+    received += block;
+    ring.Done();
+  }
+  LONGS_EQUAL(sizeof(sent), queued);
+  MEMCMP_EQUAL(sent, wire, sizeof(sent) );
+}
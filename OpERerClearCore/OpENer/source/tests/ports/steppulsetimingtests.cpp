@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * DMA step slot distribution tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+
+#include "StepPulseTiming.h"
+
+using ClearCore::StepPulseTiming;
+
+/* Step timer period of a slot at the normal clock rate: 500 kHz / 5 kHz / 4 */
+static const uint32_t kSlotMax = 25;
+
+static uint32_t Sum(const uint32_t *slots) {
+  uint32_t sum = 0;
+  for (int i = 0; i < STEP_PULSE_SLOTS; i++) {
+    sum += slots[i];
+  }
+  return sum;
+}
+
+TEST_GROUP(StepPulseTiming) {
+  StepPulseTiming timing;
+  uint32_t slots[STEP_PULSE_SLOTS];
+};
+
+TEST(StepPulseTiming, EverySamplePlacesExactlyItsSteps) {
+  for (uint32_t steps = 0; steps <= STEP_PULSE_SLOTS * kSlotMax; steps++) {
+    for (int sample = 0; sample < 3; sample++) {
+      CHECK_EQUAL(steps, timing.Distribute(steps, kSlotMax, slots) );
+      CHECK_EQUAL(steps, Sum(slots) );
+      CHECK(timing.Phase() < STEP_PULSE_SLOTS);
+    }
+  }
+}
+
+TEST(StepPulseTiming, SlotsDifferByAtMostOneStep) {
+  timing.Distribute(7, kSlotMax, slots);
+  for (int i = 0; i < STEP_PULSE_SLOTS; i++) {
+    CHECK(1 == slots[i] || 2 == slots[i]);
+  }
+}
+
+/* The accumulator runs on from one sample into the next, so a steady rate
+ * gives the same slot spacing across the sample boundary as within the
+ * sample, and a whole number of steps per sample brings it back to the same
+ * phase at every boundary */
+TEST(StepPulseTiming, PhaseCarriesAcrossSamples) {
+  uint32_t train[3 * STEP_PULSE_SLOTS];
+  for (int sample = 0; sample < 3; sample++) {
+    timing.Distribute(2, kSlotMax, &train[sample * STEP_PULSE_SLOTS]);
+    CHECK_EQUAL(0U, timing.Phase() );
+  }
+  for (int i = 0; i < 3 * STEP_PULSE_SLOTS; i++) {
+    CHECK_EQUAL( (uint32_t)(i % 2), train[i]);
+  }
+
+  /* 5 steps are 1.25 per slot, the remainder builds up over the sample */
+  static const uint32_t kFive[STEP_PULSE_SLOTS] = { 1, 1, 1, 2 };
+  timing.Distribute(5, kSlotMax, slots);
+  for (int i = 0; i < STEP_PULSE_SLOTS; i++) {
+    CHECK_EQUAL(kFive[i], slots[i]);
+  }
+  CHECK_EQUAL(0U, timing.Phase() );
+}
+
+TEST(StepPulseTiming, SlotsSaturateAtTheTimerPeriod) {
+  const uint32_t placed =
+    timing.Distribute(STEP_PULSE_SLOTS * kSlotMax + 9, kSlotMax, slots);
+  CHECK_EQUAL(STEP_PULSE_SLOTS * kSlotMax, placed);
+  for (int i = 0; i < STEP_PULSE_SLOTS; i++) {
+    CHECK_EQUAL(kSlotMax, slots[i]);
+  }
+}
+
+TEST(StepPulseTiming, ZeroStepsLeaveTheSlotsEmpty) {
+  timing.Distribute(3, kSlotMax, slots);
+  const uint32_t phase = timing.Phase();
+  CHECK_EQUAL(0U, timing.Distribute(0, kSlotMax, slots) );
+  for (int i = 0; i < STEP_PULSE_SLOTS; i++) {
+    CHECK_EQUAL(0U, slots[i]);
+  }
+  CHECK_EQUAL(phase, timing.Phase() );
+
+  timing.Reset();
+  CHECK_EQUAL(0U, timing.Phase() );
+}
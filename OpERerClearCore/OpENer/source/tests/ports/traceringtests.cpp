@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Deferred binary trace ring tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+
+#include "tracering.h"
+
+}
+
+static const char kFormatPlain[] = "no arguments\n";
+static const char kFormatMixed[] = "%d %lld %f %s %*d\n";
+
+TEST_GROUP(TraceRing) {
+  uint32_t buffer[64];
+  uint32_t out[128];
+  TraceRing ring;
+
+  void setup() {
+    TraceRingInit(&ring, buffer, 64);
+  }
+};
+
+TEST(TraceRing, EmptyRingReadsNothing) {
+  UNSIGNED_LONGS_EQUAL( 0, TraceRingRead(&ring, out, 128) );
+}
+
+TEST(TraceRing, RecordWithoutArguments) {
+  LONGS_EQUAL( 0, TraceRingRecord(&ring, 1234, kFormatPlain) );
+  UNSIGNED_LONGS_EQUAL( kTraceRingHeaderWords,
+                        TraceRingRead(&ring, out, 128) );
+  UNSIGNED_LONGS_EQUAL( (kTraceRingMagic << 16) | kTraceRingHeaderWords,
+                        out[0] );
+  UNSIGNED_LONGS_EQUAL(1234, out[1]);
+  UNSIGNED_LONGS_EQUAL( (uint32_t) (uintptr_t) kFormatPlain, out[2] );
+  UNSIGNED_LONGS_EQUAL( 0, TraceRingRead(&ring, out, 128) );
+}
+
+TEST(TraceRing, ArgumentsInConversionOrder) {
+  const double value = 2.5;
+  uint64_t bits;
+  memcpy( &bits, &value, sizeof(bits) );
+  TraceRingRecord(&ring, 1, kFormatMixed, -7, 0x1122334455667788LL, value,
+                  "abcde", 4, 9);
+
+  /* int, ll, double, length + two words of "abcde", width, int */
+  const uint32_t length = kTraceRingHeaderWords + 1 + 2 + 2 + 3 + 1 + 1;
+  UNSIGNED_LONGS_EQUAL( length, TraceRingRead(&ring, out, 128) );
+  UNSIGNED_LONGS_EQUAL(length, out[0] & 0xFF);
+  UNSIGNED_LONGS_EQUAL( (uint32_t) -7, out[3] );
+  UNSIGNED_LONGS_EQUAL(0x55667788, out[4]);
+  UNSIGNED_LONGS_EQUAL(0x11223344, out[5]);
+  UNSIGNED_LONGS_EQUAL( (uint32_t) bits, out[6] );
+  UNSIGNED_LONGS_EQUAL( (uint32_t) (bits >> 32), out[7] );
+  UNSIGNED_LONGS_EQUAL(5, out[8]);
+  MEMCMP_EQUAL("abcde\0\0\0", &out[9], 8);
+  UNSIGNED_LONGS_EQUAL(4, out[11]);
+  UNSIGNED_LONGS_EQUAL(9, out[12]);
+}
+
+TEST(TraceRing, LongArgumentListIsTruncated) {
+  static const char kLong[] =
+    "0123456789012345678901234567890123456789012345678901234567890123";
+  TraceRingRecord(&ring, 1, "%s %s %s", kLong, kLong, kLong);
+  size_t words = TraceRingRead(&ring, out, 128);
+  /* strings are cut to kTraceRingMaxStringLength, the third does not fit */
+  UNSIGNED_LONGS_EQUAL(kTraceRingHeaderWords + 2 * 13, words);
+  UNSIGNED_LONGS_EQUAL(kTraceRingMaxStringLength, out[3]);
+  UNSIGNED_LONGS_EQUAL(kTraceRingFlagTruncated, (out[0] >> 8) & 0xFF);
+}
+
+TEST(TraceRing, FullRingDropsAndReports) {
+  int recorded = 0;
+  while( 0 == TraceRingRecord(&ring, 5, "%d %d %d %d %d", 1, 2, 3, 4, 5) ) {
+    ++recorded;
+  }
+  TraceRingRecord(&ring, 6, kFormatPlain);
+  UNSIGNED_LONGS_EQUAL(64 / 8, recorded);
+  UNSIGNED_LONGS_EQUAL( 2, TraceRingDropped(&ring) );
+
+  size_t words = TraceRingRead(&ring, out, 128);
+  UNSIGNED_LONGS_EQUAL(64 + kTraceRingHeaderWords + 1, words);
+  /* drop record after the copied records */
+  UNSIGNED_LONGS_EQUAL( (kTraceRingMagic << 16) | (kTraceRingHeaderWords + 1),
+                        out[64] );
+  UNSIGNED_LONGS_EQUAL(5, out[65]);
+  UNSIGNED_LONGS_EQUAL(0, out[66]);
+  UNSIGNED_LONGS_EQUAL(2, out[67]);
+  /* reported once */
+  UNSIGNED_LONGS_EQUAL( 0, TraceRingRead(&ring, out, 128) );
+}
+
+TEST(TraceRing, ReadStopsAtWholeRecords) {
+  TraceRingRecord(&ring, 1, "%d", 1);
+  TraceRingRecord(&ring, 2, "%d", 2);
+  UNSIGNED_LONGS_EQUAL( 4, TraceRingRead(&ring, out, 7) );
+  UNSIGNED_LONGS_EQUAL(1, out[1]);
+  UNSIGNED_LONGS_EQUAL( 4, TraceRingRead(&ring, out, 7) );
+  UNSIGNED_LONGS_EQUAL(2, out[1]);
+}
+
+TEST(TraceRing, RecordsWrapAround) {
+  for(uint32_t i = 0; i < 100; ++i) {
+    LONGS_EQUAL( 0, TraceRingRecord(&ring, i, "%u %u", i, ~i) );
+    UNSIGNED_LONGS_EQUAL( 5, TraceRingRead(&ring, out, 128) );
+    UNSIGNED_LONGS_EQUAL(i, out[1]);
+    UNSIGNED_LONGS_EQUAL(i, out[3]);
+    UNSIGNED_LONGS_EQUAL(~i, out[4]);
+  }
+  UNSIGNED_LONGS_EQUAL( 0, TraceRingDropped(&ring) );
+}
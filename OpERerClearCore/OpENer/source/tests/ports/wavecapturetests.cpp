@@ -0,0 +1,310 @@
+/*******************************************************************************
+ * Streaming waveform capture tests
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sdfilesim.h"
+
+static const uint32_t kCardBlocks = 64;
+static const uint32_t kSamplePeriodUs = 200;
+
+/** Position M-0 and the inputs, 8 byte records */
+static const uint32_t kSignals = kWaveSignalPosition | kWaveSignalInputs;
+static const uint16_t kRecordsPerBlock =
+  (kWaveCaptureBlockSize - kWaveCaptureBlockHeaderSize) / 8;
+
+static uint16_t GetUint16(const uint8_t *data) {
+  return (uint16_t)(data[0] | data[1] << 8);
+}
+
+static uint32_t GetUint32(const uint8_t *data) {
+  return GetUint16(data) | (uint32_t)GetUint16(data + 2) << 16;
+}
+
+TEST_GROUP(WaveCapture) {
+  SdFileSim sim;
+  WaveCapture capture;
+  WaveCaptureConfig config;
+  uint32_t time;
+
+  void setup() {
+    SdFileSimOpen(&sim, kCardBlocks);
+    WaveCaptureInit(&capture, &sim.device, kSamplePeriodUs);
+    memset(&config, 0, sizeof(config) );
+    config.signals = kSignals;
+    config.decimation = 1;
+    config.first_block = 2;
+    time = 0;
+  }
+
+  void teardown() {
+    CHECK_FALSE(sim.violation);
+    SdFileSimClose(&sim);
+  }
+
+  /** One sample time, the values are made from the time */
+  void Sample(uint32_t inputs) {
+    WaveCaptureValues values;
+    memset(&values, 0, sizeof(values) );
+    values.timestamp_us = time * kSamplePeriodUs;
+    values.position[0] = (int32_t)time * -3;
+    values.position[1] = 12345;
+    values.inputs = inputs;
+    WaveCaptureSample(&capture, &values);
+    time++;
+  }
+
+  /** Sample times with the time as input bitmap, polling every 10 */
+  void Run(uint32_t samples) {
+    for (uint32_t i = 0; i < samples; i++) {
+      Sample(time);
+      if (0 == time % 10) {
+        LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+      }
+    }
+  }
+
+  void Header(WaveCaptureHeader *header) {
+    uint8_t block[kWaveCaptureBlockSize];
+    SdFileSimRead(&sim, config.first_block, block, 1);
+    memcpy( header, block, sizeof(*header) );
+    UNSIGNED_LONGS_EQUAL(kWaveCaptureHeaderMagic, header->magic);
+    LONGS_EQUAL(kWaveCaptureVersion, header->version);
+    LONGS_EQUAL(capture.capture_id, header->capture_id);
+  }
+
+  /** Check the data blocks; records carry the time they were sampled at
+   *  from time_offset on, every decimation-th */
+  void CheckData(uint32_t blocks,
+                 uint32_t time_offset,
+                 uint16_t decimation) {
+    uint32_t records = 0;
+    for (uint32_t sequence = 0; sequence < blocks; sequence++) {
+      uint8_t block[kWaveCaptureBlockSize];
+      SdFileSimRead(&sim, config.first_block + 1 + sequence, block, 1);
+      LONGS_EQUAL( kWaveCaptureBlockMagic, GetUint16(block) );
+      UNSIGNED_LONGS_EQUAL( sequence, GetUint32(block + 4) );
+      LONGS_EQUAL( capture.capture_id, GetUint16(block + 12) );
+      uint16_t count = GetUint16(block + 2);
+      uint32_t tick = GetUint32(block + 8);
+      CHECK(count <= kRecordsPerBlock);
+      for (uint16_t i = 0; i < count; i++) {
+        const uint8_t *record = block + kWaveCaptureBlockHeaderSize + i * 8;
+        uint32_t sampled = time_offset + (tick + i) * decimation;
+        LONGS_EQUAL( (int32_t)sampled * -3, (int32_t)GetUint32(record) );
+        UNSIGNED_LONGS_EQUAL( sampled, GetUint32(record + 4) );
+      }
+      records += count;
+    }
+    UNSIGNED_LONGS_EQUAL(capture.samples, records);
+  }
+};
+
+TEST(WaveCapture, RecordSizeCountsSelectedSignals) {
+  LONGS_EQUAL( 0, WaveCaptureRecordSize(0) );
+  LONGS_EQUAL( 8, WaveCaptureRecordSize(kSignals) );
+  LONGS_EQUAL( 4 * 4 + 4 * 2 + 4 * 2 + 4,
+               WaveCaptureRecordSize(kWaveSignalAll) );
+  LONGS_EQUAL( 2 + 2 + 4,
+               WaveCaptureRecordSize(kWaveSignalHlfb << 3 |
+                                     kWaveSignalAnalog << 1 |
+                                     kWaveSignalPosition << 2) );
+}
+
+TEST(WaveCapture, StreamsHalvesAsMultiBlockWrites) {
+  const uint32_t samples = 2 * kWaveCaptureHalfBlocks * kRecordsPerBlock + 10;
+  config.samples = samples;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  LONGS_EQUAL(kWaveCaptureArmed, capture.state);
+  CHECK_TRUE(sim.open);
+  LONGS_EQUAL(2 * kWaveCaptureHalfBlocks + 1, sim.expected);
+
+  Run(samples + 5);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+  CHECK_FALSE(sim.open);
+
+  /* Header at arm, the data stream and the final header */
+  LONGS_EQUAL(3, sim.begin_count);
+  LONGS_EQUAL(kWaveCaptureHalfBlocks, sim.largest_write);
+  LONGS_EQUAL(2 + 3, sim.write_count);
+
+  WaveCaptureHeader header;
+  Header(&header);
+  LONGS_EQUAL(kWaveCaptureFlagComplete, header.flags);
+  LONGS_EQUAL(8, header.record_size);
+  UNSIGNED_LONGS_EQUAL(kSignals, header.signals);
+  UNSIGNED_LONGS_EQUAL(kSamplePeriodUs, header.sample_period_us);
+  UNSIGNED_LONGS_EQUAL(0, header.trigger_timestamp_us);
+  UNSIGNED_LONGS_EQUAL(samples, header.samples);
+  UNSIGNED_LONGS_EQUAL(0, header.lost);
+  UNSIGNED_LONGS_EQUAL(2 * kWaveCaptureHalfBlocks + 1, header.data_blocks);
+  CheckData(header.data_blocks, 0, 1);
+}
+
+TEST(WaveCapture, EdgeTriggerStartsTheRecording) {
+  config.trigger = kWaveTriggerFalling;
+  config.trigger_input = 3;
+  config.samples = 5;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+
+  /* Low at arm time is no falling edge */
+  Sample(0);
+  Sample(0x08);
+  Sample(0x18);
+  LONGS_EQUAL(kWaveCaptureArmed, capture.state);
+  Sample(0x10);
+  LONGS_EQUAL(kWaveCaptureRunning, capture.state);
+  UNSIGNED_LONGS_EQUAL(3 * kSamplePeriodUs, capture.trigger_timestamp_us);
+  Run(10);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+
+  WaveCaptureHeader header;
+  Header(&header);
+  LONGS_EQUAL(kWaveTriggerFalling, header.trigger);
+  LONGS_EQUAL(3, header.trigger_input);
+  UNSIGNED_LONGS_EQUAL(3 * kSamplePeriodUs, header.trigger_timestamp_us);
+  UNSIGNED_LONGS_EQUAL(5, header.samples);
+
+  uint8_t block[kWaveCaptureBlockSize];
+  SdFileSimRead(&sim, config.first_block + 1, block, 1);
+  UNSIGNED_LONGS_EQUAL( 0x10, GetUint32(block + kWaveCaptureBlockHeaderSize +
+                                        4) );
+}
+
+TEST(WaveCapture, DecimationSkipsSampleTimes) {
+  config.decimation = 4;
+  config.samples = 10;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  Run(60);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+  UNSIGNED_LONGS_EQUAL(10, capture.samples);
+  CheckData(1, 0, 4);
+}
+
+TEST(WaveCapture, SlowDeviceDropsAndCountsRecords) {
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+
+  /* Both halves fill up before the first poll */
+  const uint32_t buffered = 2 * kWaveCaptureHalfBlocks * kRecordsPerBlock;
+  for (uint32_t i = 0; i < buffered + 7; i++) {
+    Sample(time);
+  }
+  UNSIGNED_LONGS_EQUAL(7, capture.lost);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  Sample(time);
+  Sample(time);
+  WaveCaptureStop(&capture);
+  Sample(time);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+
+  WaveCaptureHeader header;
+  Header(&header);
+  UNSIGNED_LONGS_EQUAL(buffered + 2, header.samples);
+  UNSIGNED_LONGS_EQUAL(7, header.lost);
+  /* The ticks of the block after the gap still give the sample times */
+  CheckData(header.data_blocks, 0, 1);
+  uint8_t block[kWaveCaptureBlockSize];
+  SdFileSimRead(&sim, config.first_block + 1 + 2 * kWaveCaptureHalfBlocks,
+                block, 1);
+  UNSIGNED_LONGS_EQUAL( buffered + 7, GetUint32(block + 8) );
+}
+
+TEST(WaveCapture, StopFlushesThePartialBlock) {
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  Run(100);
+  WaveCaptureStop(&capture);
+  LONGS_EQUAL(kWaveCaptureRunning, capture.state);
+  Sample(time);
+  LONGS_EQUAL(kWaveCaptureFlushing, capture.state);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+
+  WaveCaptureHeader header;
+  Header(&header);
+  UNSIGNED_LONGS_EQUAL(100, header.samples);
+  UNSIGNED_LONGS_EQUAL(2, header.data_blocks);
+  CheckData(2, 0, 1);
+
+  /* The next capture gets a new id */
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  LONGS_EQUAL(2, capture.capture_id);
+}
+
+TEST(WaveCapture, StopWhileArmedEndsEmpty) {
+  config.trigger = kWaveTriggerRising;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  Sample(0);
+  WaveCaptureStop(&capture);
+  Sample(0);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+  UNSIGNED_LONGS_EQUAL(0, capture.samples);
+  UNSIGNED_LONGS_EQUAL(0, capture.blocks_written);
+}
+
+TEST(WaveCapture, FullRegionEndsTheCapture) {
+  config.block_count = 4;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  Run(10 * kRecordsPerBlock);
+  LONGS_EQUAL( kEipStatusOk, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureDone, capture.state);
+
+  WaveCaptureHeader header;
+  Header(&header);
+  UNSIGNED_LONGS_EQUAL(3, header.data_blocks);
+  UNSIGNED_LONGS_EQUAL(3 * kRecordsPerBlock, header.samples);
+  CheckData(3, 0, 1);
+}
+
+TEST(WaveCapture, ArmRejectsBusyCaptureAndBadSettings) {
+  WaveCaptureConfig bad = config;
+  bad.signals = 0;
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &bad) );
+  bad = config;
+  bad.decimation = 0;
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &bad) );
+  bad = config;
+  bad.trigger = kWaveTriggerChange + 1;
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &bad) );
+  bad = config;
+  bad.first_block = kCardBlocks - 1;
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &bad) );
+  bad = config;
+  bad.block_count = kCardBlocks;
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &bad) );
+  LONGS_EQUAL(kWaveCaptureIdle, capture.state);
+  LONGS_EQUAL(0, sim.begin_count);
+
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  LONGS_EQUAL( kEipStatusError, WaveCaptureArm(&capture, &config) );
+  LONGS_EQUAL(1, capture.capture_id);
+}
+
+TEST(WaveCapture, DeviceFailureEndsInError) {
+  /* The header at arm is the first write */
+  sim.fail_write = 2;
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  for (uint32_t i = 0; i < kWaveCaptureHalfBlocks * kRecordsPerBlock; i++) {
+    Sample(time);
+  }
+  LONGS_EQUAL( kEipStatusError, WaveCapturePoll(&capture) );
+  LONGS_EQUAL(kWaveCaptureError, capture.state);
+  CHECK_FALSE(sim.open);
+
+  /* The header still marks the capture as not complete */
+  WaveCaptureHeader header;
+  Header(&header);
+  LONGS_EQUAL(0, header.flags);
+
+  Sample(time);
+  LONGS_EQUAL( kEipStatusOk, WaveCaptureArm(&capture, &config) );
+  LONGS_EQUAL(kWaveCaptureArmed, capture.state);
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Tests of the compile time and run time trace masks
+ *
+ ******************************************************************************/
+
+#include <CppUTest/TestHarness.h>
+#include <stdint.h>
+
+/* Fixed trace configuration of this file: everything for the general
+ * module, errors only for the common packet format, nothing else */
+#ifndef OPENER_WITH_TRACES
+#define OPENER_WITH_TRACES
+#endif
+#undef OPENER_TRACE_LEVEL
+#define OPENER_TRACE_LEVEL 0x0F
+#undef OPENER_TRACE_MASK
+#define OPENER_TRACE_MASK                                                 \
+  (OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_GENERAL, 0x0F) |          \
+   OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_CPF, OPENER_TRACE_LEVEL_ERROR) )
+
+extern "C" {
+
+#include "trace.h"
+
+}
+
+static int trace_calls;
+
+static void MockTrace(const char *format,
+                      ...) {
+  (void) format;
+  trace_calls++;
+}
+
+#undef LOG_TRACE
+#define LOG_TRACE(...) MockTrace(__VA_ARGS__)
+
+TEST_GROUP(TraceMask) {
+  uint32_t saved_mask;
+  int evaluated;
+
+  void setup() {
+    saved_mask = g_opener_trace_mask;
+    g_opener_trace_mask = 0xFFFFFFFFU;
+    trace_calls = 0;
+    evaluated = 0;
+  }
+
+  void teardown() {
+    g_opener_trace_mask = saved_mask;
+  }
+};
+
+#undef OPENER_TRACE_MODULE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_CPF
+
+static_assert(OPENER_TRACE_COMPILED(OPENER_TRACE_LEVEL_ERROR),
+              "errors of the CPF module are compiled in");
+static_assert(!OPENER_TRACE_COMPILED(OPENER_TRACE_LEVEL_INFO),
+              "info of the CPF module is compiled out");
+
+TEST(TraceMask, CompiledOutSiteDoesNotEvaluateArguments) {
+  OPENER_TRACE_INFO("%d\n", ++evaluated);
+  OPENER_TRACE_WARN("%d\n", ++evaluated);
+  LONGS_EQUAL(0, evaluated);
+  LONGS_EQUAL(0, trace_calls);
+
+  OPENER_TRACE_ERR("%d\n", ++evaluated);
+  LONGS_EQUAL(1, evaluated);
+  LONGS_EQUAL(1, trace_calls);
+}
+
+TEST(TraceMask, OtherModulesAreIndependent) {
+  g_opener_trace_mask =
+    OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_GENERAL, 0x0F);
+  OPENER_TRACE_ERR("%d\n", ++evaluated);
+  LONGS_EQUAL(0, evaluated);
+  LONGS_EQUAL(0, trace_calls);
+}
+
+#undef OPENER_TRACE_MODULE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_GENERAL
+
+TEST(TraceMask, RunTimeMaskDisablesSite) {
+  g_opener_trace_mask = 0;
+  OPENER_TRACE_INFO("%d\n", ++evaluated);
+  LONGS_EQUAL(0, evaluated);
+  LONGS_EQUAL(0, trace_calls);
+
+  g_opener_trace_mask = OPENER_TRACE_MASK_ALL_MODULES(OPENER_TRACE_LEVEL_INFO);
+  OPENER_TRACE_INFO("%d\n", ++evaluated);
+  OPENER_TRACE_STATE("%d\n", ++evaluated);
+  LONGS_EQUAL(1, evaluated);
+  LONGS_EQUAL(1, trace_calls);
+}
+
+TEST(TraceMask, MaskLayout) {
+  UNSIGNED_LONGS_EQUAL(0x00000F00U,
+                       OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_CPF, 0x0F) );
+  UNSIGNED_LONGS_EQUAL(0x08000000U,
+                       OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_PORT,
+                                                OPENER_TRACE_LEVEL_INFO) );
+  UNSIGNED_LONGS_EQUAL(0x02222222U,
+                       OPENER_TRACE_MASK_ALL_MODULES(OPENER_TRACE_LEVEL_WARNING) );
+  UNSIGNED_LONGS_EQUAL(0x0000010FU, OPENER_TRACE_COMPILED_MASK);
+}
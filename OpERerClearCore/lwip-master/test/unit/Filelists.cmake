@@ -24,7 +24,9 @@ set(LWIP_TESTFILES
 	${LWIP_TESTDIR}/core/test_pbuf.c
 	${LWIP_TESTDIR}/core/test_timers.c
 	${LWIP_TESTDIR}/dhcp/test_dhcp.c
+	${LWIP_TESTDIR}/etharp/test_arppin.c
 	${LWIP_TESTDIR}/etharp/test_etharp.c
+	${LWIP_DIR}/../OpENer/source/src/ports/ClearCore/clearcore_arppin.c
 	${LWIP_TESTDIR}/ip4/test_ip4.c
 	${LWIP_TESTDIR}/ip6/test_ip6.c
 	${LWIP_TESTDIR}/mdns/test_mdns.c
@@ -40,7 +40,9 @@ TESTFILES=$(TESTDIR)/lwip_unittests.c \
 	$(TESTDIR)/core/test_pbuf.c \
 	$(TESTDIR)/core/test_timers.c \
 	$(TESTDIR)/dhcp/test_dhcp.c \
+	$(TESTDIR)/etharp/test_arppin.c \
 	$(TESTDIR)/etharp/test_etharp.c \
+	$(TESTDIR)/../../../OpENer/source/src/ports/ClearCore/clearcore_arppin.c \
 	$(TESTDIR)/ip4/test_ip4.c \
 	$(TESTDIR)/ip6/test_ip6.c \
 	$(TESTDIR)/mdns/test_mdns.c \
@@ -0,0 +1,304 @@
+#include "test_arppin.h"
+
+#include <string.h>
+
+#include "lwip/etharp.h"
+#include "lwip/inet.h"
+#include "netif/ethernet.h"
+#include "lwip/stats.h"
+#include "lwip/prot/iana.h"
+#include "arch/sys_arch.h"
+
+/* ARP pinning of the ClearCore OpENer port, built with these sources */
+#include "../../../../OpENer/source/src/ports/ClearCore/clearcore_arppin.h"
+
+#if !ETHARP_SUPPORT_STATIC_ENTRIES
+#error "This test needs ETHARP_SUPPORT_STATIC_ENTRIES enabled"
+#endif
+
+static struct netif test_netif;
+static ip4_addr_t test_ipaddr, test_netmask, test_gw;
+static struct eth_addr test_ethaddr =  {{1,1,1,1,1,1}};
+static struct eth_addr test_ethaddr2 = {{1,1,1,1,1,2}};
+static int linkoutput_ctr;
+
+/* Helper functions */
+static void
+etharp_remove_all(void)
+{
+  int i;
+  /* call etharp_tmr often enough to have all entries cleaned */
+  for(i = 0; i < 0xff; i++) {
+    etharp_tmr();
+  }
+}
+
+static err_t
+default_netif_linkoutput(struct netif *netif, struct pbuf *p)
+{
+  fail_unless(netif == &test_netif);
+  fail_unless(p != NULL);
+  linkoutput_ctr++;
+  return ERR_OK;
+}
+
+static err_t
+default_netif_init(struct netif *netif)
+{
+  fail_unless(netif != NULL);
+  netif->linkoutput = default_netif_linkoutput;
+  netif->output = etharp_output;
+  netif->mtu = 1500;
+  netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
+  netif->hwaddr_len = ETHARP_HWADDR_LEN;
+  return ERR_OK;
+}
+
+static void
+default_netif_add(void)
+{
+  IP4_ADDR(&test_gw, 192,168,0,254);
+  IP4_ADDR(&test_ipaddr, 192,168,0,1);
+  IP4_ADDR(&test_netmask, 255,255,255,0);
+
+  fail_unless(netif_default == NULL);
+  netif_set_default(netif_add(&test_netif, &test_ipaddr, &test_netmask,
+                              &test_gw, NULL, default_netif_init, NULL));
+  netif_set_up(&test_netif);
+}
+
+static void
+default_netif_remove(void)
+{
+  fail_unless(netif_default == &test_netif);
+  netif_remove(&test_netif);
+}
+
+static void
+create_arp_response(const ip4_addr_t *adr)
+{
+  struct eth_hdr *ethhdr;
+  struct etharp_hdr *etharphdr;
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, sizeof(struct eth_hdr) + sizeof(struct etharp_hdr), PBUF_RAM);
+  if(p == NULL) {
+    FAIL_RET();
+  }
+  ethhdr = (struct eth_hdr*)p->payload;
+  etharphdr = (struct etharp_hdr*)(ethhdr + 1);
+
+  ethhdr->dest = test_ethaddr;
+  ethhdr->src = test_ethaddr2;
+  ethhdr->type = htons(ETHTYPE_ARP);
+
+  etharphdr->hwtype = htons(LWIP_IANA_HWTYPE_ETHERNET);
+  etharphdr->proto = htons(ETHTYPE_IP);
+  etharphdr->hwlen = ETHARP_HWADDR_LEN;
+  etharphdr->protolen = sizeof(ip4_addr_t);
+  etharphdr->opcode = htons(ARP_REPLY);
+
+  SMEMCPY(&etharphdr->sipaddr, adr, sizeof(ip4_addr_t));
+  SMEMCPY(&etharphdr->dipaddr, &test_ipaddr, sizeof(ip4_addr_t));
+  SMEMCPY(&etharphdr->shwaddr, &test_ethaddr2, ETHARP_HWADDR_LEN);
+  SMEMCPY(&etharphdr->dhwaddr, &test_ethaddr, ETHARP_HWADDR_LEN);
+
+  ethernet_input(p, &test_netif);
+}
+
+static int
+arp_is_resolved(const ip4_addr_t *adr)
+{
+  struct eth_addr *unused_ethaddr;
+  const ip4_addr_t *unused_ipaddr;
+  return etharp_find_addr(&test_netif, adr, &unused_ethaddr, &unused_ipaddr) >= 0;
+}
+
+/* Setups/teardown functions */
+
+static void
+arppin_setup(void)
+{
+  etharp_remove_all();
+  default_netif_add();
+  linkoutput_ctr = 0;
+  lwip_check_ensure_no_alloc(SKIP_POOL(MEMP_SYS_TIMEOUT));
+}
+
+static void
+arppin_teardown(void)
+{
+  fail_unless(ClearCoreArpPinCount() == 0);
+  etharp_remove_all();
+  default_netif_remove();
+  lwip_check_ensure_no_alloc(SKIP_POOL(MEMP_SYS_TIMEOUT));
+}
+
+
+/* Test functions */
+
+/* A peer that is resolved already is pinned at once, without a request */
+START_TEST(test_arppin_resolved_peer)
+{
+  ip4_addr_t peer;
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 192,168,0,10);
+  create_arp_response(&peer);
+  fail_unless(arp_is_resolved(&peer));
+
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+  fail_unless(linkoutput_ctr == 0);
+  fail_unless(ClearCoreArpPinCount() == 1);
+
+  /* static entries do not time out */
+  etharp_remove_all();
+  fail_unless(arp_is_resolved(&peer));
+
+  /* pins are counted, the first connection that closes keeps the entry */
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+  etharp_remove_all();
+  fail_unless(arp_is_resolved(&peer));
+
+  /* the last one releases it and asks the peer again */
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+  fail_unless(ClearCoreArpPinCount() == 0);
+  fail_unless(linkoutput_ctr == 1);
+  fail_unless(!arp_is_resolved(&peer));
+}
+END_TEST
+
+/* A peer that is not resolved yet is queried until it answers */
+START_TEST(test_arppin_unresolved_peer)
+{
+  ip4_addr_t peer;
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 192,168,0,11);
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+  fail_unless(linkoutput_ctr == 1);
+  fail_unless(!arp_is_resolved(&peer));
+
+  /* no answer, asked again on the next retry */
+  lwip_sys_now += CLEARCORE_ARP_RETRY_MS;
+  ClearCoreArpPinPoll();
+  fail_unless(linkoutput_ctr == 2);
+
+  create_arp_response(&peer);
+  lwip_sys_now += CLEARCORE_ARP_RETRY_MS;
+  ClearCoreArpPinPoll();
+  etharp_remove_all();
+  fail_unless(arp_is_resolved(&peer));
+
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+}
+END_TEST
+
+/* The pinned peers get a request every CLEARCORE_ARP_REFRESH_MS */
+START_TEST(test_arppin_refresh)
+{
+  ip4_addr_t peer;
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 192,168,0,12);
+  create_arp_response(&peer);
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+
+  lwip_sys_now += CLEARCORE_ARP_REFRESH_MS;
+  ClearCoreArpPinPoll();
+  fail_unless(linkoutput_ctr == 1);
+
+  /* a resolved peer is not asked on the retries */
+  lwip_sys_now += CLEARCORE_ARP_RETRY_MS;
+  ClearCoreArpPinPoll();
+  fail_unless(linkoutput_ctr == 1);
+
+  lwip_sys_now += CLEARCORE_ARP_REFRESH_MS;
+  ClearCoreArpPinPoll();
+  fail_unless(linkoutput_ctr == 2);
+
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+}
+END_TEST
+
+/* A peer beyond the subnet pins the gateway */
+START_TEST(test_arppin_gateway)
+{
+  ip4_addr_t peer;
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 10,0,0,7);
+  create_arp_response(&test_gw);
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+  etharp_remove_all();
+  fail_unless(arp_is_resolved(&test_gw));
+  fail_unless(!arp_is_resolved(&peer));
+
+  /* no entry for broadcast and multicast */
+  ClearCoreArpPin(PP_HTONL(0xC0A800FFUL));
+  ClearCoreArpPin(PP_HTONL(0xEFC00001UL));
+  fail_unless(ClearCoreArpPinCount() == 1);
+
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+}
+END_TEST
+
+/* Frames to a peer without an entry wait for ARP and are counted */
+START_TEST(test_arppin_send_delays)
+{
+  ip4_addr_t peer;
+  uint32_t delays = ClearCoreArpSendDelays();
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 192,168,0,13);
+  fail_unless(ClearCoreArpCheckSend(ip4_addr_get_u32(&peer)) == 1);
+  fail_unless(ClearCoreArpCheckSend(PP_HTONL(0xEFC00001UL)) == 0);
+  fail_unless(ClearCoreArpSendDelays() == delays + 1);
+
+  create_arp_response(&peer);
+  fail_unless(ClearCoreArpCheckSend(ip4_addr_get_u32(&peer)) == 0);
+  fail_unless(ClearCoreArpSendDelays() == delays + 1);
+}
+END_TEST
+
+/* A link down empties the ARP table, the pinned peer is resolved again */
+START_TEST(test_arppin_link_down)
+{
+  ip4_addr_t peer;
+  LWIP_UNUSED_ARG(_i);
+
+  IP4_ADDR(&peer, 192,168,0,14);
+  create_arp_response(&peer);
+  ClearCoreArpPin(ip4_addr_get_u32(&peer));
+  netif_set_down(&test_netif);
+  fail_unless(!arp_is_resolved(&peer));
+  netif_set_up(&test_netif);
+  linkoutput_ctr = 0;
+
+  lwip_sys_now += CLEARCORE_ARP_RETRY_MS;
+  ClearCoreArpPinPoll();
+  fail_unless(linkoutput_ctr == 1);
+  create_arp_response(&peer);
+  lwip_sys_now += CLEARCORE_ARP_RETRY_MS;
+  ClearCoreArpPinPoll();
+  etharp_remove_all();
+  fail_unless(arp_is_resolved(&peer));
+
+  ClearCoreArpUnpin(ip4_addr_get_u32(&peer));
+}
+END_TEST
+
+
+/** Create the suite including all tests for this module */
+Suite *
+arppin_suite(void)
+{
+  testfunc tests[] = {
+    TESTFUNC(test_arppin_resolved_peer),
+    TESTFUNC(test_arppin_unresolved_peer),
+    TESTFUNC(test_arppin_refresh),
+    TESTFUNC(test_arppin_gateway),
+    TESTFUNC(test_arppin_send_delays),
+    TESTFUNC(test_arppin_link_down)
+  };
+  return create_suite("ARPPIN", tests, sizeof(tests)/sizeof(testfunc), arppin_setup, arppin_teardown);
+}
@@ -0,0 +1,8 @@
+#ifndef LWIP_HDR_TEST_ARPPIN_H
+#define LWIP_HDR_TEST_ARPPIN_H
+
+#include "../lwip_check.h"
+
+Suite* arppin_suite(void);
+
+#endif
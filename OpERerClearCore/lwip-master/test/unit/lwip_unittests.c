@@ -13,6 +13,7 @@
 #include "core/test_pbuf.h"
 #include "core/test_timers.h"
 #include "etharp/test_etharp.h"
+#include "etharp/test_arppin.h"
 #include "dhcp/test_dhcp.h"
 #include "mdns/test_mdns.h"
 #include "mqtt/test_mqtt.h"
@@ -94,6 +95,7 @@ int main(void)
     pbuf_suite,
     timers_suite,
     etharp_suite,
+    arppin_suite,
     dhcp_suite,
     mdns_suite,
     mqtt_suite,
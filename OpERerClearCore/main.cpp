@@ -3,11 +3,25 @@
 #include "lwip/ip_addr.h"
 #include "lwip/ip4_addr.h"
 #include "ports/ClearCore/opener.h"
+#include "ports/ClearCore/clearcore_trace.h"
+#include "ports/ClearCore/clearcore_capture.h"
+#include "ports/ClearCore/clearcore_boot.h"
 #include "ciptcpipinterface.h"
 #include <stdio.h>
 
 int main(void) {
     ConnectorUsb.PortOpen();
+#if CLEARCORE_FAST_BOOT
+    ClearCoreBootMark("USB port open");
+
+    ConnectorUsb.SendLine("\r\n=== OpENer ClearCore Debug ===");
+    ConnectorUsb.SendLine("Fast start: stored network configuration, DHCP in the background");
+    ConnectorUsb.Flush();
+
+    // The link, DHCP and the stored configuration are handled by OpENer
+    EthernetMgr.Setup();
+    ClearCoreBootMark("lwIP up");
+#else
     Delay_ms(100);
     
     ConnectorUsb.SendLine("\r\n=== OpENer ClearCore Debug ===");
@@ -44,6 +58,7 @@ int main(void) {
     }
     
     Delay_ms(500);
+#endif
     
     struct netif *netif = EthernetMgr.MacInterface();
     if (netif == nullptr) {
@@ -70,7 +85,9 @@ int main(void) {
     
     opener_init(netif);
     
+#if !CLEARCORE_FAST_BOOT
     Delay_ms(500);
+#endif
     ConnectorUsb.Flush();
     
     int opener_status = opener_get_status();
@@ -99,6 +116,9 @@ int main(void) {
             lastOpenerCall = currentTime;
         }
         
+        ClearCoreTraceDrain();
+        ClearCoreCapturePoll();
+        
         if ((g_tcpip.status & kTcpipStatusIfaceCfgPend) != 0) {
             if (currentTime - lastLedBlink >= 250) {
                 ledState = !ledState;
@@ -0,0 +1,125 @@
+/**
+    \file attrlistbench.c
+    \brief Cost of Get_Attribute_List against Get_Attribute_Single on the host.
+
+    Reads the 40 UDINT attributes of an instance of a vendor specific class
+    with one Get_Attribute_List request and with 40 Get_Attribute_Single
+    requests, calling the services as the Message Router does. Each figure
+    is the best of BENCH_RUNS runs of BENCH_ROUNDS reads.
+**/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "opener_api.h"
+#include "ciperror.h"
+#include "cipcommon.h"
+
+#define BENCH_CLASS_CODE 0x66U
+#define BENCH_ATTRIBUTES 40
+#define BENCH_ROUNDS 20000
+#define BENCH_RUNS 5
+
+static CipUdint bench_udints[BENCH_ATTRIBUTES];
+static CipOctet bench_request_data[2 * (BENCH_ATTRIBUTES + 1)];
+static CipMessageRouterRequest bench_request;
+static CipMessageRouterResponse bench_response;
+
+/* InsertService() takes the service names as char * */
+static char bench_get_attribute_list_name[] = "GetAttributeList";
+static char bench_get_attribute_single_name[] = "GetAttributeSingle";
+
+static double BenchSeconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static CipInstance *BenchInstance(void) {
+  CipClass *bench_class = CreateCipClass(BENCH_CLASS_CODE,
+                                         0, /* # class attributes */
+                                         7, /* # highest class attribute number */
+                                         2, /* # class services */
+                                         BENCH_ATTRIBUTES, /* # instance attributes */
+                                         BENCH_ATTRIBUTES, /* # highest instance attribute number */
+                                         2, /* # instance services */
+                                         1, /* # instances */
+                                         "Attribute list bench",
+                                         1, /* # class revision */
+                                         NULL /* # function pointer for initialization */
+                                         );
+  if(NULL == bench_class) {
+    return NULL;
+  }
+  CipInstance *instance = GetCipInstance(bench_class, 1);
+  for(int i = 0; i < BENCH_ATTRIBUTES; i++) {
+    bench_udints[i] = 0x01010101U * (CipUdint)(i + 1);
+    InsertAttribute(instance, (EipUint16)(i + 1), kCipUdint, EncodeCipUdint,
+                    NULL, &bench_udints[i], kGetableSingle);
+  }
+  InsertService(bench_class, kGetAttributeList, &GetAttributeList,
+                bench_get_attribute_list_name);
+  InsertService(bench_class, kGetAttributeSingle, &GetAttributeSingle,
+                bench_get_attribute_single_name);
+  return instance;
+}
+
+int main(void) {
+  CipInstance *instance = BenchInstance();
+  if(NULL == instance) {
+    printf("CreateCipClass failed\n");
+    return 1;
+  }
+
+  CipOctet *end = bench_request_data;
+  end[0] = (CipOctet)BENCH_ATTRIBUTES;
+  end[1] = 0;
+  end += 2;
+  for(CipUint i = 1; i <= BENCH_ATTRIBUTES; i++) {
+    end[0] = (CipOctet)i;
+    end[1] = (CipOctet)(i >> 8);
+    end += 2;
+  }
+
+  double list_seconds = 1e9;
+  double single_seconds = 1e9;
+  for(int run = 0; run < BENCH_RUNS; run++) {
+    double start = BenchSeconds();
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+      bench_request.service = kGetAttributeList;
+      bench_request.data = bench_request_data;
+      bench_request.request_data_size = sizeof(bench_request_data);
+      GetAttributeList(instance, &bench_request, &bench_response, NULL, 1);
+    }
+    const double list_run = BenchSeconds() - start;
+    if(kCipErrorSuccess != bench_response.general_status ||
+       2U + 8U * BENCH_ATTRIBUTES !=
+       bench_response.message.used_message_length) {
+      printf("Get_Attribute_List failed\n");
+      return 1;
+    }
+
+    start = BenchSeconds();
+    for(int round = 0; round < BENCH_ROUNDS; round++) {
+      for(EipUint16 i = 1; i <= BENCH_ATTRIBUTES; i++) {
+        bench_request.service = kGetAttributeSingle;
+        bench_request.request_path.attribute_number = i;
+        GetAttributeSingle(instance, &bench_request, &bench_response, NULL, 1);
+      }
+    }
+    const double single_run = BenchSeconds() - start;
+    if(kCipErrorSuccess != bench_response.general_status) {
+      printf("Get_Attribute_Single failed\n");
+      return 1;
+    }
+
+    list_seconds = list_run < list_seconds ? list_run : list_seconds;
+    single_seconds = single_run < single_seconds ? single_run : single_seconds;
+  }
+
+  printf("| %.0f | %.0f |\n",
+         list_seconds / BENCH_ROUNDS * 1e9,
+         single_seconds / BENCH_ROUNDS * 1e9);
+  return 0;
+}
@@ -0,0 +1,175 @@
+/**
+    \file chksumbench.cpp
+    \brief Cost of the software Internet checksum on the host.
+
+    Sums the same frames with
+
+    - the RFC 1071 reference, a byte pair at a time,
+    - 16 bit words into a 32 bit sum, lwIP's default algorithm 2,
+    - 32 bit words into a 64 bit sum, one word per iteration,
+    - ClearCore::InetChecksum, the LWIP_CHKSUM of the port,
+    - memcpy() and then the kernel, lwIP's LWIP_CHKSUM_COPY without an
+      algorithm of the port,
+    - ClearCore::InetChecksum::Copy, the LWIP_CHKSUM_COPY of the port,
+
+    for the frame sizes of a class 1 I/O packet, a typical explicit message
+    and a full Ethernet frame. Besides the time, the cycles of the time stamp
+    counter are given where the host has one; the ratios between the
+    kernels are what carries over to the Cortex-M4. Not so for the copies:
+    the host memcpy() is vectorized and runs from cache, on the Cortex-M4
+    the fused copy saves the second pass over the SRAM.
+**/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+
+#include "InetChecksum.h"
+
+#define BENCH_BYTES (64U * 1024U * 1024U)
+#define BENCH_RUNS 5
+
+static uint8_t bench_buffer[2048] __attribute__( (aligned(4) ) );
+static uint8_t bench_copy[2048] __attribute__( (aligned(4) ) );
+static volatile uint32_t bench_sink;
+
+static uint16_t __attribute__( (noinline) ) Reference(const void *data,
+                                                     int len) {
+  const uint8_t *p = (const uint8_t *)data;
+  uint32_t sum = 0;
+  for(; len > 1; len -= 2, p += 2) {
+    sum += (uint32_t)p[0] << 8 | p[1];
+  }
+  if(len > 0) {
+    sum += (uint32_t)p[0] << 8;
+  }
+  while(sum >> 16) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return (uint16_t)sum;
+}
+
+static uint16_t __attribute__( (noinline) ) Words16(const void *data,
+                                                   int len) {
+  const uint16_t *ps = (const uint16_t *)data;
+  uint32_t sum = 0;
+  for(; len > 1; len -= 2) {
+    sum += *ps++;
+  }
+  if(len > 0) {
+    sum += *(const uint8_t *)ps;
+  }
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  sum = (sum & 0xFFFF) + (sum >> 16);
+  return (uint16_t)sum;
+}
+
+static uint16_t __attribute__( (noinline) ) Words32(const void *data,
+                                                   int len) {
+  const uint32_t *pl = (const uint32_t *)data;
+  uint64_t sum = 0;
+  for(; len > 3; len -= 4) {
+    sum += *pl++;
+  }
+  const uint8_t *pb = (const uint8_t *)pl;
+  for(int i = 0; i < len; i++) {
+    sum += (uint32_t)pb[i] << (8 * (i & 1) );
+  }
+  return ClearCore::InetChecksum::Fold(sum);
+}
+
+static uint16_t __attribute__( (noinline) ) Kernel(const void *data,
+                                                  int len) {
+  return ClearCore::InetChecksum::Sum(data, len);
+}
+
+static uint16_t __attribute__( (noinline) ) CopyThenSum(const void *data,
+                                                       int len) {
+  memcpy(bench_copy, data, len);
+  return ClearCore::InetChecksum::Sum(bench_copy, len);
+}
+
+static uint16_t __attribute__( (noinline) ) CopyKernel(const void *data,
+                                                      int len) {
+  return ClearCore::InetChecksum::Copy(bench_copy, data, len);
+}
+
+typedef uint16_t (*ChecksumFunction)(const void *data, int len);
+
+/** Best of the runs, per frame */
+static void BenchFrames(ChecksumFunction function, int len, double *ns,
+                        double *cycles) {
+  const uint32_t frames = BENCH_BYTES / len;
+  for(int run = 0; run < BENCH_RUNS; ++run) {
+    struct timespec start, end;
+    uint32_t sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+#if BENCH_HAS_TSC
+    uint64_t tsc = __rdtsc();
+#endif
+    for(uint32_t i = 0; i < frames; ++i) {
+      sum += function(bench_buffer, len);
+    }
+#if BENCH_HAS_TSC
+    tsc = __rdtsc() - tsc;
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bench_sink = sum;
+    double run_ns = ( (end.tv_sec - start.tv_sec) * 1e9 +
+                      (end.tv_nsec - start.tv_nsec) ) / frames;
+    if(0 == run || run_ns < *ns) {
+      *ns = run_ns;
+#if BENCH_HAS_TSC
+      *cycles = (double)tsc / frames;
+#else
+      *cycles = 0;
+#endif
+    }
+  }
+}
+
+int main(void) {
+  static const int lengths[] = { 72, 576, 1500 };
+  static const struct {
+    const char *name;
+    ChecksumFunction function;
+  } kernels[] = {
+    { "RFC 1071 byte pairs ", Reference },
+    { "16 bit words        ", Words16 },
+    { "32 bit words        ", Words32 },
+    { "InetChecksum        ", Kernel },
+    { "memcpy + Sum        ", CopyThenSum },
+    { "InetChecksum::Copy  ", CopyKernel },
+  };
+
+  srand(1);
+  for(unsigned i = 0; i < sizeof(bench_buffer); ++i) {
+    bench_buffer[i] = (uint8_t)rand();
+  }
+
+  printf("per frame, best of %d runs over %u MiB%s\n", BENCH_RUNS,
+         BENCH_BYTES >> 20,
+         BENCH_HAS_TSC ? ", ns and TSC cycles" : ", ns");
+  for(unsigned l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+    printf("%d bytes\n", lengths[l]);
+    double base = 0;
+    for(unsigned k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k) {
+      double ns = 0, cycles = 0;
+      BenchFrames(kernels[k].function, lengths[l], &ns, &cycles);
+      if(0 == k) {
+        base = ns;
+      }
+      printf("  %s %8.1f ns %8.0f cycles  x%.1f\n", kernels[k].name, ns,
+             cycles, base / ns);
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/**
+    \file rxringmodel.cpp
+    \brief Memory and loss of GMAC receive ring sizings, modelled on the host.
+
+    The GMAC stores a received frame in as many RX buffers of RX_BUFFER_SIZE
+    bytes as it needs and drops it, counting a resource error (RRE), if the
+    ring has fewer free ones. Refresh() frees the buffers of the complete
+    frames each time it runs. The model replays the same traffic into each
+    RX_BUFFER_SIZE / RX_BUFF_CNT pair:
+
+    - bursts of back-to-back frames at 100 Mbit/s, a mix of class 1 I/O
+      (90 bytes), ListIdentity and ARP (60 bytes), explicit messages
+      (570 bytes) and full TCP segments (1514 bytes),
+    - a Refresh() every 500 us, the polling rate of a busy main loop.
+
+    Printed as the Markdown table of the README, with the RAM of the ring,
+    the frames it holds when they all have the same size, the buffers of
+    an explicit message and the frames lost. The GMAC's 4 KB receive packet
+    buffer in front of the DMA is left out, it only delays the losses.
+    On the target, the resource errors and overruns show in the MAC receive
+    errors of the Ethernet Link media counters.
+**/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Descriptor of an RX buffer, two words */
+#define MODEL_DESC_SIZE 8
+/** Bytes on the wire besides the frame: preamble, FCS and gap */
+#define MODEL_WIRE_OVERHEAD 24
+/** ns per byte at 100 Mbit/s */
+#define MODEL_NS_PER_BYTE 80
+#define MODEL_REFRESH_NS 500000ULL
+#define MODEL_TIME_NS 2000000000ULL
+/** Mean frames of a burst, and the share of the line it takes */
+#define MODEL_BURST_FRAMES 12
+#define MODEL_LOAD_PERCENT 25
+
+typedef struct {
+  uint32_t size;
+  uint32_t count;
+} Sizing;
+
+typedef struct {
+  uint64_t frames;
+  uint64_t lost;
+} Result;
+
+static uint32_t model_random = 0x2545F491;
+
+static uint32_t Random(void) {
+  model_random ^= model_random << 13;
+  model_random ^= model_random >> 17;
+  model_random ^= model_random << 5;
+  return model_random;
+}
+
+static uint32_t FrameSize(void) {
+  uint32_t pick = Random() % 100;
+  if(pick < 40) {
+    return 90;
+  }
+  if(pick < 60) {
+    return 60;
+  }
+  if(pick < 85) {
+    return 570;
+  }
+  return 1514;
+}
+
+static uint32_t Buffers(uint32_t frame, uint32_t size) {
+  return (frame + size - 1) / size;
+}
+
+/** The same traffic for each sizing, from the same seed */
+static Result Replay(const Sizing &sizing) {
+  Result result = { 0, 0 };
+  model_random = 0x2545F491;
+  uint32_t in_use = 0;
+  uint64_t next_refresh = MODEL_REFRESH_NS;
+  uint64_t now = 0;
+  while(now < MODEL_TIME_NS) {
+    uint32_t burst = 1 + Random() % (2 * MODEL_BURST_FRAMES - 1);
+    uint64_t busy = 0;
+    for(uint32_t i = 0; i < burst; i++) {
+      uint32_t frame = FrameSize();
+      now += (uint64_t)(frame + MODEL_WIRE_OVERHEAD) * MODEL_NS_PER_BYTE;
+      busy += (uint64_t)(frame + MODEL_WIRE_OVERHEAD) * MODEL_NS_PER_BYTE;
+      while(next_refresh <= now) {
+        in_use = 0;
+        next_refresh += MODEL_REFRESH_NS;
+      }
+      uint32_t buffers = Buffers(frame, sizing.size);
+      result.frames++;
+      if(in_use + buffers > sizing.count) {
+        result.lost++;
+      } else {
+        in_use += buffers;
+      }
+    }
+    /* idle until the burst took its share of the line */
+    now += busy * (100 - MODEL_LOAD_PERCENT) / MODEL_LOAD_PERCENT;
+    while(next_refresh <= now) {
+      in_use = 0;
+      next_refresh += MODEL_REFRESH_NS;
+    }
+  }
+  return result;
+}
+
+int main(void) {
+  static const Sizing sizings[] = {
+    { 128, 16 },
+    { 128, 48 },
+    { 256, 24 },
+    { 512, 12 },
+    { 512, 24 },
+    { 1536, 4 },
+    { 1536, 8 },
+    { 1536, 16 },
+  };
+
+  printf("| RX_BUFFER_SIZE | RX_BUFF_CNT | RAM [bytes] | 60 B frames | "
+         "570 B frames | 1514 B frames | Buffers per 570 B | Lost |\n");
+  printf("|---:|---:|---:|---:|---:|---:|---:|---:|\n");
+  for(unsigned s = 0; s < sizeof(sizings) / sizeof(sizings[0]); ++s) {
+    const Sizing &sizing = sizings[s];
+    Result result = Replay(sizing);
+    printf("| %u | %u | %u | %u | %u | %u | %u | %.2f %% |\n", sizing.size,
+           sizing.count, sizing.count * (sizing.size + MODEL_DESC_SIZE),
+           sizing.count / Buffers(60, sizing.size),
+           sizing.count / Buffers(570, sizing.size),
+           sizing.count / Buffers(1514, sizing.size),
+           Buffers(570, sizing.size),
+           100.0 * result.lost / result.frames);
+  }
+  return EXIT_SUCCESS;
+}
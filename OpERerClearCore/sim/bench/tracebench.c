@@ -0,0 +1,130 @@
+/**
+    \file tracebench.c
+    \brief Cost of an OpENer trace site on the host.
+
+    Runs the same loop - the address decoding and the "Data received on UDP"
+    trace of the UDP receive callback - with the trace site
+
+    - removed from the source (baseline),
+    - compiled out by the trace mask of its module,
+    - compiled in but disabled by the run time trace mask,
+    - enabled, recording into a trace ring.
+
+    A compiled out site costs exactly as much as no site, the numbers of the
+    first two loops only differ by the noise of the host.
+**/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Compile in all levels of the general module, nothing of the others */
+#define OPENER_TRACE_MASK \
+  OPENER_TRACE_MASK_MODULE(OPENER_TRACE_MODULE_GENERAL, OPENER_TRACE_LEVEL)
+
+#include "trace.h"
+#include "tracering.h"
+
+#define BENCH_ITERATIONS 20000000U
+#define BENCH_RUNS 5
+
+static uint32_t bench_ring_buffer[4096];
+static TraceRing bench_ring;
+static uint32_t bench_drain[4096];
+
+static void BenchTrace(const char *format,
+                       ...) {
+  va_list args;
+  va_start(args, format);
+  if(0 != TraceRingRecordV(&bench_ring, 0, format, args) ) {
+    TraceRingRead(&bench_ring, bench_drain, 4096);
+  }
+  va_end(args);
+}
+
+#undef LOG_TRACE
+#define LOG_TRACE(...) BenchTrace(__VA_ARGS__)
+
+/* Sources of the loops, volatile so that the compiler can not fold them */
+static volatile uint32_t bench_addresses[4] = {
+  0x0A01A8C0U, 0xFFFFFFFFU, 0x0100A8C0U, 0x010000E0U
+};
+static volatile uint32_t bench_sink;
+
+#define BENCH_LOOP_BODY(with_trace)                                         \
+  uint32_t sum = 0;                                                         \
+  for(uint32_t i = 0; i < BENCH_ITERATIONS; ++i) {                          \
+    const uint32_t addr = bench_addresses[i & 3U];                          \
+    const bool is_broadcast = (addr == 0xFFFFFFFFU ||                       \
+                               (addr & 0xFF000000U) == 0xE0000000U);        \
+    sum += addr ^ (uint32_t) is_broadcast;                                  \
+    if(with_trace) {                                                        \
+      OPENER_TRACE_INFO("Data received on UDP (%s): %d bytes from %d.%d.%d.%d:%d\n", \
+                        is_broadcast ? "broadcast" : "unicast",             \
+                        (int) (i & 0x3FFU),                                 \
+                        (int) (addr & 0xFFU), (int) ( (addr >> 8) & 0xFFU), \
+                        (int) ( (addr >> 16) & 0xFFU), (int) (addr >> 24),  \
+                        2222);                                              \
+    }                                                                       \
+  }                                                                         \
+  bench_sink = sum
+
+static void __attribute__( (noinline) ) BenchNoSite(void) {
+  BENCH_LOOP_BODY(false);
+}
+
+#undef OPENER_TRACE_MODULE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_NETWORK_HANDLER
+
+static void __attribute__( (noinline) ) BenchCompiledOut(void) {
+  BENCH_LOOP_BODY(true);
+}
+
+#undef OPENER_TRACE_MODULE
+#define OPENER_TRACE_MODULE OPENER_TRACE_MODULE_GENERAL
+
+static void __attribute__( (noinline) ) BenchSite(void) {
+  BENCH_LOOP_BODY(true);
+}
+
+static double BenchNanoseconds(void (*loop)(void) ) {
+  double best = 0;
+  for(int run = 0; run < BENCH_RUNS; ++run) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    loop();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ns = ( (end.tv_sec - start.tv_sec) * 1e9 +
+                  (end.tv_nsec - start.tv_nsec) ) / BENCH_ITERATIONS;
+    if(0 == run || ns < best) {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+int main(void) {
+  TraceRingInit(&bench_ring, bench_ring_buffer, 4096);
+
+  g_opener_trace_mask = OPENER_TRACE_COMPILED_MASK;
+  const double no_site = BenchNanoseconds(BenchNoSite);
+  const double compiled_out = BenchNanoseconds(BenchCompiledOut);
+  g_opener_trace_mask = 0;
+  const double disabled = BenchNanoseconds(BenchSite);
+  g_opener_trace_mask = OPENER_TRACE_COMPILED_MASK;
+  const double enabled = BenchNanoseconds(BenchSite);
+
+  printf("ns per iteration, best of %d runs of %u\n", BENCH_RUNS,
+         BENCH_ITERATIONS);
+  printf("  no trace site            %7.3f\n", no_site);
+  printf("  compiled out (module)    %7.3f  %+7.3f\n", compiled_out,
+         compiled_out - no_site);
+  printf("  disabled at run time     %7.3f  %+7.3f\n", disabled,
+         disabled - no_site);
+  printf("  enabled, deferred record %7.3f  %+7.3f\n", enabled,
+         enabled - no_site);
+  return EXIT_SUCCESS;
+}
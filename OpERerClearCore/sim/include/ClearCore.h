@@ -0,0 +1,787 @@
+/**
+    \file ClearCore.h
+    \brief Virtual ClearCore for the host build.
+
+    Declares the part of the libClearCore API that the OpENer application and
+    its port glue use, backed by the simulation in sim/src. Names, enum values
+    and semantics follow libClearCore, so that main.cpp and the files in
+    ports/ClearCore build unchanged. See SimClearCore.h for the controls of
+    the simulation.
+**/
+
+#ifndef __CLEARCORE_H__
+#define __CLEARCORE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "core_cm4.h"
+#include "ISerial.h"
+#include "IpAddress.h"
+#include "SimClearCore.h"
+#include "AdcDecimator.h"
+#include "CcioLink.h"
+#include "SysProfiler.h"
+#include "SysTiming.h"
+
+struct netif;
+
+namespace ClearCore {
+
+/**
+    \enum ClearCorePins
+    \brief ClearCore connector indices, as in SysConnectors.h.
+**/
+typedef enum {
+    CLEARCORE_PIN_INVALID = -1,
+    CLEARCORE_PIN_IO0,
+    CLEARCORE_PIN_IO1,
+    CLEARCORE_PIN_IO2,
+    CLEARCORE_PIN_IO3,
+    CLEARCORE_PIN_IO4,
+    CLEARCORE_PIN_IO5,
+    CLEARCORE_PIN_DI6,
+    CLEARCORE_PIN_DI7,
+    CLEARCORE_PIN_DI8,
+    CLEARCORE_PIN_A9,
+    CLEARCORE_PIN_A10,
+    CLEARCORE_PIN_A11,
+    CLEARCORE_PIN_A12,
+    CLEARCORE_PIN_LED,
+    CLEARCORE_PIN_M0,
+    CLEARCORE_PIN_M1,
+    CLEARCORE_PIN_M2,
+    CLEARCORE_PIN_M3,
+    CLEARCORE_PIN_COM0,
+    CLEARCORE_PIN_COM1,
+    CLEARCORE_PIN_USB,
+    CLEARCORE_PIN_MAX,
+    CLEARCORE_PIN_CCIO_BASE = 64,
+    CLEARCORE_PIN_CCIOA0 = CLEARCORE_PIN_CCIO_BASE,
+} ClearCorePins;
+
+#define MAX_CCIO_DEVICES 8
+
+/**
+    \class Connector
+    \brief A digital connector of the virtual board.
+
+    The state lives in the I/O image: inputs read the bit the host wrote,
+    outputs write their bit for the host to read.
+**/
+class Connector {
+public:
+    typedef enum {
+        INVALID_NONE,
+        INPUT_ANALOG,
+        INPUT_DIGITAL,
+        OUTPUT_ANALOG,
+        OUTPUT_DIGITAL,
+        OUTPUT_H_BRIDGE,
+        OUTPUT_PWM,
+        OUTPUT_TONE,
+        OUTPUT_WAVE,
+        CPM_MODE_A_DIRECT_B_DIRECT,
+        CPM_MODE_STEP_AND_DIR,
+        CPM_MODE_A_DIRECT_B_PWM,
+        CPM_MODE_A_PWM_B_PWM,
+        TTL,
+        RS232,
+        SPI,
+        CCIO,
+        USB_CDC,
+    } ConnectorModes;
+
+    explicit Connector(ClearCorePins pin) : m_pin(pin) {}
+
+    Connector::ConnectorModes Mode();
+    bool Mode(ConnectorModes newMode);
+
+    int16_t State();
+    bool State(int16_t newState);
+
+private:
+    ClearCorePins m_pin;
+};
+
+typedef void (*voidFuncPtr)(void);
+
+/**
+    \union SysConnectorState
+    \brief Connector state bits, bit n belongs to ClearCorePins index n, as
+    in SysConnectors.h.
+**/
+union SysConnectorState {
+    SysConnectorState(uint32_t initialBits) : reg(initialBits) {}
+    SysConnectorState() : reg(0) {}
+    uint32_t reg;
+};
+
+/**
+    \class InputManager
+    \brief Interrupt triggers and input states, as in InputManager.h.
+**/
+class InputManager {
+public:
+    typedef enum {
+        LOW = 0,
+        HIGH = 1,
+        CHANGE = 2,
+        FALLING = 3,
+        RISING = 4,
+    } InterruptTrigger;
+
+    /** The inputs of the I/O image **/
+    SysConnectorState InputsRT(SysConnectorState mask = UINT32_MAX);
+};
+
+/**
+    \class StepGenerator
+    \brief Move target selection, as in StepGenerator.h.
+**/
+class StepGenerator {
+public:
+    typedef enum {
+        MOVE_TARGET_ABSOLUTE,
+        MOVE_TARGET_REL_END_POSN,
+    } MoveTarget;
+};
+
+/**
+    \class MotorDriver
+    \brief Step and direction axis with an ideal ClearPath motor.
+
+    Positional moves run at VelMax() without ramps, velocity moves change the
+    velocity at once. HLFB is asserted while the axis is enabled. Moves of a
+    disabled axis are rejected with the MotionCanceledMotorDisabled alert,
+    like on the board.
+**/
+class MotorDriver : public StepGenerator {
+public:
+    typedef enum {
+        HLFB_DEASSERTED,
+        HLFB_ASSERTED,
+        HLFB_HAS_MEASUREMENT,
+        HLFB_UNKNOWN
+    } HlfbStates;
+
+    typedef enum {
+        MOTOR_DISABLED = 0,
+        MOTOR_ENABLING,
+        MOTOR_FAULTED,
+        MOTOR_READY,
+        MOTOR_MOVING
+    } MotorReadyStates;
+
+    union StatusRegMotor {
+        uint32_t reg;
+        struct {
+            uint32_t AtTargetPosition : 1;
+            uint32_t StepsActive : 1;
+            uint32_t AtTargetVelocity : 1;
+            uint32_t MoveDirection : 1;
+            uint32_t MotorInFault : 1;
+            uint32_t Enabled : 1;
+            uint32_t PositionalMove : 1;
+            uint32_t HlfbState : 2;
+            uint32_t AlertsPresent : 1;
+            uint32_t ReadyState : 3;
+            uint32_t Triggering : 1;
+            uint32_t InPositiveLimit : 1;
+            uint32_t InNegativeLimit : 1;
+            uint32_t InEStopSensor : 1;
+        } bit;
+        StatusRegMotor() {
+            reg = 0;
+        }
+        StatusRegMotor(uint32_t val) {
+            reg = val;
+        }
+    };
+
+    union AlertRegMotor {
+        uint32_t reg;
+        struct {
+            uint16_t MotionCanceledInAlert : 1;
+            uint16_t MotionCanceledPositiveLimit : 1;
+            uint16_t MotionCanceledNegativeLimit : 1;
+            uint16_t MotionCanceledSensorEStop : 1;
+            uint16_t MotionCanceledMotorDisabled : 1;
+            uint16_t MotorFaulted : 1;
+        } bit;
+        AlertRegMotor() {
+            reg = 0;
+        }
+        AlertRegMotor(uint32_t val) {
+            reg = val;
+        }
+    };
+
+    static const int16_t HLFB_DUTY_UNKNOWN = -9999;
+
+    explicit MotorDriver(uint8_t axis);
+
+    bool Move(int32_t dist,
+              MoveTarget moveTarget = MOVE_TARGET_REL_END_POSN);
+    bool MoveVelocity(int32_t velocity);
+    void MoveStopAbrupt();
+    void MoveStopDecel(uint32_t decelMax = 0);
+
+    void VelMax(uint32_t velMax) {
+        m_velMax = velMax;
+    }
+    void AccelMax(uint32_t accelMax) {
+        m_accelMax = accelMax;
+    }
+    void EStopDecelMax(uint32_t decelMax) {
+        m_eStopDecelMax = decelMax;
+    }
+
+    int32_t PositionRefCommanded() {
+        return m_position;
+    }
+    int32_t VelocityRefCommanded() {
+        return m_velocity;
+    }
+
+    bool EnableRequest() {
+        return m_enableRequest;
+    }
+    void EnableRequest(bool value);
+
+    volatile const HlfbStates &HlfbState() {
+        return m_hlfbState;
+    }
+    volatile const float &HlfbPercent() {
+        return m_hlfbDuty;
+    }
+
+    volatile const StatusRegMotor &StatusReg() {
+        return m_statusReg;
+    }
+    volatile const AlertRegMotor &AlertReg() {
+        return m_alertReg;
+    }
+    void ClearAlerts(uint32_t mask = UINT32_MAX) {
+        m_alertReg.reg &= ~mask;
+    }
+
+    /**
+        Run one sample time of the step generator.
+    **/
+    void Refresh();
+
+private:
+    uint8_t m_axis;
+    bool m_enableRequest;
+    bool m_positionalMove;
+    int32_t m_position;
+    int32_t m_target;
+    int32_t m_velocity;
+    uint32_t m_velMax;
+    uint32_t m_accelMax;
+    uint32_t m_eStopDecelMax;
+    // Sub-step position, in steps / 2^16
+    int64_t m_positionFrac;
+    HlfbStates m_hlfbState;
+    float m_hlfbDuty;
+    StatusRegMotor m_statusReg;
+    AlertRegMotor m_alertReg;
+
+    void StatusUpdate();
+};
+
+/**
+    \class MotorManager
+    \brief Connector mode handling of the motor connectors.
+**/
+class MotorManager {
+public:
+    typedef enum {
+        MOTOR_M0M1,
+        MOTOR_M2M3,
+        NUM_MOTOR_PAIRS,
+        MOTOR_ALL = NUM_MOTOR_PAIRS,
+    } MotorPair;
+
+    bool MotorModeSet(MotorPair motorPair, Connector::ConnectorModes newMode);
+};
+
+/**
+    \class EncoderInput
+    \brief The encoder input, counting the encoder_counts of the I/O image.
+**/
+class EncoderInput {
+public:
+    EncoderInput();
+
+    int32_t Position();
+    int32_t Position(int32_t newPosn);
+    int32_t IndexPosition();
+    void Enable(bool isEnabled);
+    int32_t VelocityFiltered();
+    void VelocityFilterTc_ms(uint16_t tcMs) {
+        m_velocityFilterTcMs = tcMs ? tcMs : 1;
+    }
+    volatile const uint32_t &PositionTimestamp() {
+        return m_positionTimestamp;
+    }
+
+    bool RegistrationLatchArm(ClearCorePins pin,
+                              InputManager::InterruptTrigger trigger =
+                                  InputManager::RISING);
+    void RegistrationLatchDisarm();
+    volatile const bool &RegistrationLatchArmed() {
+        return m_latchArmed;
+    }
+    volatile const uint32_t &RegistrationCount() {
+        return m_latchCount;
+    }
+    int32_t RegistrationPosition();
+    volatile const uint32_t &RegistrationTimestamp() {
+        return m_latchTimestamp;
+    }
+
+    bool QuadratureError() {
+        return false;
+    }
+    void ClearQuadratureError() {}
+
+    /**
+        Sample the counts and check the registration latch input.
+    **/
+    void Update(uint32_t inputsLastSample);
+
+private:
+    bool m_enabled;
+    int32_t m_countsLast;
+    int32_t m_position;
+    int32_t m_positionOffset;
+    int32_t m_velocity;
+    int32_t m_velocityFiltered;
+    uint16_t m_velocityFilterTcMs;
+    uint32_t m_positionTimestamp;
+    bool m_latchArmed;
+    ClearCorePins m_latchPin;
+    InputManager::InterruptTrigger m_latchTrigger;
+    int32_t m_latchPosition;
+    uint32_t m_latchTimestamp;
+    uint32_t m_latchCount;
+};
+
+/**
+    \class AdcManager
+    \brief The ADC, converting the analog inputs of the I/O image.
+
+    An analog input converts full scale while its input bit is set and zero
+    otherwise, the supply monitors read a constant. The results run through
+    the libClearCore AdcDecimator and Iir16, every sample time in the sample
+    acquisition mode and every ADC_BLOCK_SAMPLES sample times in the block
+    acquisition mode.
+**/
+class AdcManager {
+public:
+    typedef enum {
+        ADC_VSUPPLY_MON = 0,
+        ADC_AIN12,
+        ADC_5VOB_MON,
+        ADC_AIN11,
+        ADC_AIN10,
+        ADC_AIN09,
+        ADC_SDRVR3_IMON,
+        ADC_SDRVR2_IMON,
+        ADC_CHANNEL_COUNT
+    } AdcChannels;
+
+    typedef enum {
+        FILTER_UNIT_RAW,
+        FILTER_UNIT_MS,
+        FILTER_UNIT_SAMPLES,
+    } FilterUnits;
+
+    typedef enum {
+        ACQ_MODE_SAMPLE,
+        ACQ_MODE_BLOCK,
+    } AcquisitionModes;
+
+    static const uint8_t ADC_RESOLUTION_DEFAULT = 12;
+    static const uint32_t ADC_IIR_FILTER_TC_MS = 2;
+    static const uint8_t ADC_BLOCK_SAMPLES = 5;
+    static const uint8_t ADC_OVERSAMPLING_MAX = 4;
+    static const uint8_t ADC_CONVERSIONS_PER_SAMPLE_MAX = 32;
+
+    AdcManager();
+
+    volatile const uint16_t &FilteredResult(AdcChannels adcChannel) {
+        return m_filtered[adcChannel];
+    }
+    volatile const uint16_t &DecimatedResult(AdcChannels adcChannel) {
+        return m_decimated[adcChannel];
+    }
+    volatile const uint32_t &DecimatedTimestamp(AdcChannels adcChannel) {
+        return m_decimatedTimestamp[adcChannel];
+    }
+    volatile const uint32_t &ResultTimestamp() {
+        return m_resultTimestamp;
+    }
+    volatile const uint32_t &BlockOverruns() {
+        return m_blockOverruns;
+    }
+
+    bool FilterTc(AdcChannels adcChannel, uint16_t tc, FilterUnits theUnits);
+    bool AcquisitionMode(AcquisitionModes mode);
+    AcquisitionModes AcquisitionMode() {
+        return m_acqMode;
+    }
+    bool Oversampling(AdcChannels adcChannel, uint8_t samplesLog2);
+    uint8_t Oversampling(AdcChannels adcChannel) {
+        return m_oversampling[adcChannel];
+    }
+    bool Decimation(AdcChannels adcChannel, uint16_t samples);
+    uint16_t Decimation(AdcChannels adcChannel) {
+        return m_decimator[adcChannel].Decimation();
+    }
+
+    /**
+        Convert one sample time, started at \a sampleMicros.
+    **/
+    void Update(uint32_t sampleMicros);
+
+private:
+    AcquisitionModes m_acqMode;
+    uint8_t m_oversampling[ADC_CHANNEL_COUNT];
+    uint8_t m_blockSample;
+    uint16_t m_block[ADC_BLOCK_SAMPLES][ADC_CHANNEL_COUNT];
+    Iir16 m_filter[ADC_CHANNEL_COUNT];
+    AdcDecimator m_decimator[ADC_CHANNEL_COUNT];
+    uint16_t m_filtered[ADC_CHANNEL_COUNT];
+    uint16_t m_decimated[ADC_CHANNEL_COUNT];
+    uint32_t m_decimatedTimestamp[ADC_CHANNEL_COUNT];
+    uint32_t m_resultTimestamp;
+    uint32_t m_blockOverruns;
+
+    uint8_t ResultBits(uint8_t channel) {
+        return ADC_RESOLUTION_DEFAULT + m_oversampling[channel];
+    }
+    void ResultsProcess(uint8_t samples, uint32_t lastTimestamp);
+};
+
+/**
+    \class SdCardDriver
+    \brief The micro SD card, kept in the image file named by
+    CLEARCORE_SIM_SD.
+
+    Without the variable no card is inserted. The size of the file gives the
+    number of blocks. The block interface follows SdCardDriver.h.
+**/
+class SdCardDriver {
+public:
+    static const uint16_t BLOCK_SIZE = 512;
+
+    SdCardDriver();
+    bool CardInit();
+    bool CardReady() {
+        return m_fd >= 0;
+    }
+    uint32_t BlockCount() {
+        return m_blockCount;
+    }
+    bool BlocksRead(uint32_t block, uint8_t *data, uint32_t count);
+    bool BlocksWrite(uint32_t block, const uint8_t *data, uint32_t count);
+    bool WriteStart(uint32_t block, uint32_t count = 0);
+    bool WriteData(const uint8_t *data, uint32_t count);
+    bool WriteStop();
+
+private:
+    int m_fd;
+    uint32_t m_blockCount;
+    uint32_t m_writeBlock;
+    bool m_writing;
+};
+
+/**
+    \class SerialDriver
+    \brief COM-0 or COM-1, as the port of a CCIO-8 link or as a UART in the
+    DMA mode of SerialBase.h.
+
+    Opening the port in the CCIO mode discovers the boards and closing it
+    closes the link, as in SerialDriver.cpp. In a UART mode the port is wired
+    back to itself: every character sent is received at once, so the line
+    is always idle.
+**/
+class SerialDriver {
+public:
+    /** See SerialBase::SerialErrorStatusRegister **/
+    union SerialErrorStatusRegister {
+        uint32_t reg;
+    };
+
+    static const uint16_t LOOPBACK_SIZE = 256;
+
+    explicit SerialDriver(ClearCorePins pin)
+        : m_pin(pin), m_mode(Connector::TTL), m_portOpen(false),
+          m_loopHead(0), m_loopCount(0) {}
+
+    Connector::ConnectorModes Mode() {
+        return m_mode;
+    }
+    bool Mode(Connector::ConnectorModes newMode);
+    void PortOpen();
+    void PortClose();
+    bool PortIsOpen() {
+        return m_portOpen;
+    }
+
+    bool Speed(uint32_t bitsPerSecond) {
+        return bitsPerSecond > 0;
+    }
+    bool Parity(ISerial::Parities newParity) {
+        return newParity <= ISerial::PARITY_N;
+    }
+    bool StopBits(uint8_t bits) {
+        return bits == 1 || bits == 2;
+    }
+    bool UartDma(bool enable) {
+        (void)enable;
+        return true;
+    }
+
+    int32_t Read(uint8_t *buf, int32_t len);
+    int32_t Write(const uint8_t *buf, int32_t len);
+    void FlushInput() {
+        m_loopCount = 0;
+    }
+    bool RxIdle() {
+        return m_portOpen;
+    }
+    SerialErrorStatusRegister ErrorStatusAccum() {
+        SerialErrorStatusRegister errors;
+        errors.reg = 0;
+        return errors;
+    }
+
+private:
+    ClearCorePins m_pin;
+    Connector::ConnectorModes m_mode;
+    bool m_portOpen;
+    uint8_t m_loop[LOOPBACK_SIZE];
+    uint16_t m_loopHead;
+    uint16_t m_loopCount;
+};
+
+/**
+    \class CcioPin
+    \brief A pin of a CCIO-8 board, an input or an output.
+**/
+class CcioPin {
+public:
+    CcioPin() : m_mode(Connector::INPUT_DIGITAL) {}
+
+    Connector::ConnectorModes Mode() {
+        return m_mode;
+    }
+    bool Mode(Connector::ConnectorModes newMode);
+
+private:
+    Connector::ConnectorModes m_mode;
+};
+
+/**
+    \class CcioBoardManager
+    \brief The CCIO-8 link of CcioBoardManager.h with no boards attached.
+
+    A link that is opened finds no board and is reported broken, as on a
+    ClearCore with nothing connected to the port. Outputs are kept but go
+    nowhere and the inputs read 0.
+**/
+class CcioBoardManager {
+public:
+    CcioBoardManager();
+
+    uint8_t CcioDiscover(SerialDriver *comInstance);
+    void LinkClose();
+    uint8_t CcioCount() {
+        return m_ccioCnt;
+    }
+    bool LinkBroken() {
+        return m_ccioLinkBroken;
+    }
+    uint64_t IoOverloadRT() {
+        return 0;
+    }
+    uint64_t InputsRisen(uint64_t mask = UINT64_MAX) {
+        (void)mask;
+        return 0;
+    }
+    uint64_t InputsFallen(uint64_t mask = UINT64_MAX) {
+        (void)mask;
+        return 0;
+    }
+    uint64_t InputState() {
+        return 0;
+    }
+    uint64_t OutputState() {
+        return m_currentOutputs;
+    }
+    void OutputsWrite(uint64_t state, uint64_t mask = UINT64_MAX) {
+        m_currentOutputs = (m_currentOutputs & ~mask) | (state & mask);
+    }
+    uint32_t RefreshOverruns() {
+        return 0;
+    }
+    void CcioRediscoverEnable(bool enable) {
+        m_autoRediscover = enable;
+    }
+    CcioPin *PinByIndex(ClearCorePins connectorIndex);
+
+private:
+    CcioPin m_ccioPins[MAX_CCIO_DEVICES * 8];
+    SerialDriver *m_serPort;
+    uint64_t m_currentOutputs;
+    uint8_t m_ccioCnt;
+    bool m_ccioLinkBroken;
+    bool m_autoRediscover;
+};
+
+/**
+    \class SysManager
+    \brief The sample time callback of SysManager.h, run by the simulated
+    sample time after the motors, the encoder and the ADC.
+**/
+class SysManager {
+public:
+    SysManager() : m_sampleCallback(nullptr) {}
+
+    void SampleCallback(voidFuncPtr callback) {
+        m_sampleCallback = callback;
+    }
+    voidFuncPtr SampleCallback() {
+        return m_sampleCallback;
+    }
+
+private:
+    voidFuncPtr m_sampleCallback;
+};
+
+/**
+    \class SerialUsb
+    \brief The USB serial port, printing to stdout.
+**/
+class SerialUsb : public ISerial {
+public:
+    void PortOpen() override;
+    void Flush() override;
+    void FlushInput() override {}
+    bool SendChar(uint8_t charToSend) override;
+    int32_t AvailableForRead() override {
+        return 0;
+    }
+    /** stdout takes everything **/
+    int32_t AvailableForWrite() override {
+        return 4096;
+    }
+};
+
+/**
+    \class NvmManager
+    \brief See NvmManager.h.
+**/
+class NvmManager;
+
+/**
+    \class EthernetManager
+    \brief The Ethernet port, exchanging frames with a Linux TAP device.
+
+    The PHY link is up while the TAP device is open. Setup(), DhcpBegin(),
+    DhcpStart() and Refresh() drive lwIP like the libClearCore
+    implementation.
+**/
+class EthernetManager {
+public:
+    static EthernetManager &Instance();
+
+    void Setup();
+    bool DhcpBegin();
+    bool DhcpStart();
+    bool DhcpBound();
+    void Refresh();
+
+    bool PhyLinkActive();
+
+    uint8_t *MacAddress();
+
+    IpAddress LocalIp();
+    void LocalIp(IpAddress ipaddr);
+    IpAddress NetmaskIp();
+    void NetmaskIp(IpAddress address);
+    IpAddress GatewayIp();
+    void GatewayIp(IpAddress address);
+
+    struct netif *MacInterface();
+
+    typedef struct {
+        uint32_t alignmentErrors;
+        uint32_t fcsErrors;
+        uint32_t singleCollisions;
+        uint32_t multipleCollisions;
+        uint32_t deferredFrames;
+        uint32_t lateCollisions;
+        uint32_t excessiveCollisions;
+        uint32_t txUnderruns;
+        uint32_t carrierSenseErrors;
+        uint32_t oversizeFrames;
+        uint32_t rxOverruns;
+        uint32_t rxResourceErrors;
+    } MacCounters;
+
+    /**
+        The TAP device has no MAC statistics, they stay zero.
+    **/
+    const MacCounters &Counters() {
+        return m_counters;
+    }
+    void CountersClear() {}
+
+private:
+    bool m_dhcp;
+    bool m_ethernetActive;
+    MacCounters m_counters;
+
+    EthernetManager();
+};
+
+extern Connector ConnectorIO0;
+extern Connector ConnectorIO1;
+extern Connector ConnectorIO2;
+extern Connector ConnectorIO3;
+extern Connector ConnectorIO4;
+extern Connector ConnectorIO5;
+extern Connector ConnectorDI6;
+extern Connector ConnectorDI7;
+extern Connector ConnectorDI8;
+extern Connector ConnectorA9;
+extern Connector ConnectorA10;
+extern Connector ConnectorA11;
+extern Connector ConnectorA12;
+extern Connector ConnectorLed;
+extern MotorDriver ConnectorM0;
+extern MotorDriver ConnectorM1;
+extern MotorDriver ConnectorM2;
+extern MotorDriver ConnectorM3;
+extern SerialDriver ConnectorCOM0;
+extern SerialDriver ConnectorCOM1;
+extern SerialUsb ConnectorUsb;
+extern CcioBoardManager &CcioMgr;
+extern MotorManager &MotorMgr;
+extern EncoderInput EncoderIn;
+extern AdcManager &AdcMgr;
+extern InputManager &InputMgr;
+extern SdCardDriver SdCard;
+extern SysManager SysMgr;
+extern EthernetManager &EthernetMgr;
+extern SysProfiler &ProfilerMgr;
+
+} // ClearCore namespace
+
+using namespace ClearCore;
+
+#endif // __CLEARCORE_H__
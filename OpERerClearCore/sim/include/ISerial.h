@@ -0,0 +1,160 @@
+/**
+    \file ISerial.h
+    \brief Host build version of the ClearCore serial interface.
+
+    Same interface as libClearCore/inc/ISerial.h. The libClearCore header
+    relies on int32_t being distinct from int and on the newlib itoa/utoa,
+    neither holds on a Linux host, so numbers are formatted here with a
+    single conversion for all integer widths.
+**/
+
+#ifndef __ISERIAL_H__
+#define __ISERIAL_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace ClearCore {
+
+/**
+    \class ISerial
+    \brief Base class for interacting with all ClearCore serial.
+**/
+class ISerial {
+public:
+    typedef enum _Parities {
+        PARITY_E,
+        PARITY_O,
+        PARITY_N,
+    } Parities;
+
+    virtual void Flush() = 0;
+    virtual void FlushInput() = 0;
+    virtual void PortOpen() = 0;
+    virtual void PortClose() {}
+    virtual bool Speed(uint32_t bitsPerSecond) {
+        (void)bitsPerSecond;
+        return true;
+    }
+    virtual uint32_t Speed() {
+        return 0;
+    }
+    virtual int16_t CharGet() {
+        return -1;
+    }
+    virtual int16_t CharPeek() {
+        return -1;
+    }
+    virtual bool SendChar(uint8_t charToSend) = 0;
+
+    bool SendLine() {
+        return SendChar('\r') && SendChar('\n');
+    }
+
+    bool Send(const char *buffer, size_t bufferSize) {
+        for (size_t iChar = 0; iChar < bufferSize; iChar++) {
+            if (!SendChar(buffer[iChar])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SendLine(const char *buffer, size_t bufferSize) {
+        return Send(buffer, bufferSize) && SendLine();
+    }
+
+    bool Send(const char *nullTermStr) {
+        return Send(nullTermStr, strlen(nullTermStr));
+    }
+
+    bool SendLine(const char *nullTermStr) {
+        return Send(nullTermStr) && SendLine();
+    }
+
+    bool Send(char theChar) {
+        return SendChar(theChar);
+    }
+
+    bool SendLine(char theChar) {
+        return Send(theChar) && SendLine();
+    }
+
+    bool Send(double number, uint8_t precision = 2) {
+        char strRep[32];
+        snprintf(strRep, sizeof(strRep), "%.*f", precision, number);
+        return Send((const char *)strRep);
+    }
+
+    bool SendLine(double number, uint8_t precision = 2) {
+        return Send(number, precision) && SendLine();
+    }
+
+    bool Send(int32_t number, uint8_t radix = 10) {
+        if (number < 0 && radix == 10) {
+            return Send('-') &&
+                   Send(static_cast<uint32_t>(-(int64_t)number), radix);
+        }
+        return Send(static_cast<uint32_t>(number), radix);
+    }
+
+    bool SendLine(int32_t number, uint8_t radix = 10) {
+        return Send(number, radix) && SendLine();
+    }
+
+    bool Send(uint32_t number, uint8_t radix = 10) {
+        if (radix < 2 || radix > 16) {
+            // Only support bases 2 through 16.
+            return false;
+        }
+        char strRep[1 + 8 * sizeof(number)];
+        char *digit = &strRep[sizeof(strRep) - 1];
+        *digit = '\0';
+        do {
+            *--digit = "0123456789abcdef"[number % radix];
+            number /= radix;
+        } while (number);
+        return Send((const char *)digit);
+    }
+
+    bool SendLine(uint32_t number, uint8_t radix = 10) {
+        return Send(number, radix) && SendLine();
+    }
+
+    bool Send(int8_t number, uint8_t radix = 10) {
+        return Send(static_cast<int32_t>(number), radix);
+    }
+    bool SendLine(int8_t number, uint8_t radix = 10) {
+        return SendLine(static_cast<int32_t>(number), radix);
+    }
+    bool Send(uint8_t number, uint8_t radix = 10) {
+        return Send(static_cast<uint32_t>(number), radix);
+    }
+    bool SendLine(uint8_t number, uint8_t radix = 10) {
+        return SendLine(static_cast<uint32_t>(number), radix);
+    }
+    bool Send(int16_t number, uint8_t radix = 10) {
+        return Send(static_cast<int32_t>(number), radix);
+    }
+    bool SendLine(int16_t number, uint8_t radix = 10) {
+        return SendLine(static_cast<int32_t>(number), radix);
+    }
+    bool Send(uint16_t number, uint8_t radix = 10) {
+        return Send(static_cast<uint32_t>(number), radix);
+    }
+    bool SendLine(uint16_t number, uint8_t radix = 10) {
+        return SendLine(static_cast<uint32_t>(number), radix);
+    }
+
+    virtual int32_t AvailableForRead() = 0;
+    virtual int32_t AvailableForWrite() = 0;
+
+    virtual bool PortIsOpen() {
+        return true;
+    }
+};
+
+} // ClearCore namespace
+
+#endif // __ISERIAL_H__
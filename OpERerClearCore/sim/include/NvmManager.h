@@ -0,0 +1,95 @@
+/**
+    \file NvmManager.h
+    \brief Host build version of the ClearCore NVM user page.
+
+    Same interface as libClearCore/inc/NvmManager.h. The user page is kept in
+    the file named by CLEARCORE_SIM_NVM and written through on every change,
+    a missing file reads as an erased page (all 0xFF). The data flash area
+    is kept the same way in the file named by CLEARCORE_SIM_DATA_FLASH.
+**/
+
+#ifndef __NVMMANAGER_H__
+#define __NVMMANAGER_H__
+
+#include <stdint.h>
+
+/** Size of the NVM user page of the SAME53 **/
+#define NVMCTRL_PAGE_SIZE 512
+
+/** Erase block of the SAME53 main flash **/
+#define NVMCTRL_BLOCK_SIZE 8192
+
+namespace ClearCore {
+
+/**
+    \class NvmManager
+    \brief ClearCore NVM manager, file backed.
+**/
+class NvmManager {
+public:
+    typedef enum {
+        NVM_LOC_USER_START      = 0,
+        NVM_LOC_RESERVED_TEKNIC = 416,
+        NVM_LOC_USER_MAX = NVMCTRL_PAGE_SIZE - 32,   // 480
+        NVM_LOC_HW_REVISION = NVM_LOC_USER_MAX - 18,   // 462
+        NVM_LOC_SERIAL_NUMBER = NVM_LOC_USER_MAX - 16, // 464
+        NVM_LOC_MAC_FIRST  = NVM_LOC_USER_MAX - 12,    // 468
+        NVM_LOC_MAC_SECOND = NVM_LOC_USER_MAX - 8,     // 472
+        NVM_LOC_DAC_ZERO = NVM_LOC_USER_MAX - 4,       // 476
+        NVM_LOC_DAC_SPAN = NVM_LOC_USER_MAX - 2,       // 478
+    } NvmLocations;
+
+    static NvmManager &Instance();
+
+    int8_t Byte(NvmLocations nvmLocation);
+    bool Byte(NvmLocations nvmLocation, int8_t newValue);
+    int16_t Int16(NvmLocations nvmLocation);
+    bool Int16(NvmLocations nvmLocation, int16_t newValue);
+    int32_t Int32(NvmLocations nvmLocation);
+    bool Int32(NvmLocations nvmLocation, int32_t newValue);
+    int64_t Int64(NvmLocations nvmLocationStart);
+    bool Int64(NvmLocations nvmLocationStart, int64_t newValue);
+
+    void BlockRead(NvmLocations nvmLocationStart, int lengthInBytes,
+                   uint8_t *const p_data);
+    bool BlockWrite(NvmLocations nvmLocationStart, int lengthInBytes,
+                    uint8_t const *const p_data);
+
+    void MacAddress(uint8_t *macAddress);
+    uint32_t SerialNumber();
+
+    static const uint32_t DATA_FLASH_BLOCK_SIZE = NVMCTRL_BLOCK_SIZE;
+    static const uint32_t DATA_FLASH_QUAD_WORD_SIZE = 16;
+    /** Four blocks, as the ClearCore linker scripts reserve **/
+    static const uint32_t DATA_FLASH_SIZE = 4 * DATA_FLASH_BLOCK_SIZE;
+
+    uint32_t DataFlashSize() {
+        return DATA_FLASH_SIZE;
+    }
+    bool DataFlashRead(uint32_t offset, uint32_t lengthInBytes,
+                       uint8_t *p_data);
+    bool DataFlashWrite(uint32_t offset, uint32_t lengthInBytes,
+                        uint8_t const *p_data);
+    bool DataFlashErase(uint32_t offset);
+
+    bool FinishNvmWrite() {
+        return true;
+    }
+    bool Synchonized() const {
+        return true;
+    }
+
+private:
+    uint8_t m_nvmPageCache[NVMCTRL_PAGE_SIZE];
+    const char *m_path;
+    uint8_t m_dataFlash[DATA_FLASH_SIZE];
+    const char *m_dataFlashPath;
+
+    NvmManager();
+    bool Store();
+    bool StoreDataFlash(uint32_t offset, uint32_t lengthInBytes);
+};
+
+} // ClearCore namespace
+
+#endif // __NVMMANAGER_H__
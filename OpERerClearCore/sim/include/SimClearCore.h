@@ -0,0 +1,90 @@
+#ifndef SIM_CLEARCORE_H_
+#define SIM_CLEARCORE_H_
+
+/** @file SimClearCore.h
+ *  @brief Control interface of the virtual ClearCore used by the host build
+ *
+ *  The host build replaces libClearCore with a simulation that keeps the
+ *  connector states in an I/O image, runs the 5 kHz sample time from a
+ *  controllable clock, stores the NVM user page in a file and connects lwIP
+ *  to a Linux TAP device. Test harnesses, benchmarks and fuzzers use this
+ *  interface to drive the simulation; the ClearCore application itself only
+ *  sees the usual ClearCore.h API.
+ *
+ *  The simulation is configured from the environment, so that the unchanged
+ *  ClearCore main() can be used:
+ *
+ *  | Variable              | Default                | Meaning                 |
+ *  |-----------------------|------------------------|-------------------------|
+ *  | CLEARCORE_SIM_TAP     | tap0                   | TAP device of the PHY   |
+ *  | CLEARCORE_SIM_MAC     | 02:43:43:00:00:01      | MAC address             |
+ *  | CLEARCORE_SIM_NVM     | clearcore_nvm.bin      | NVM user page file      |
+ *  | CLEARCORE_SIM_IO      | (private image)        | I/O image file to mmap  |
+ *  | CLEARCORE_SIM_SD      | (no card)              | SD card image file      |
+ *  | CLEARCORE_SIM_CLOCK   | realtime               | realtime or manual      |
+ *  | CLEARCORE_SIM_RUN_MS  | 0 (run forever)        | exit after this time    |
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of connectors in the I/O image, IO-0 .. M-3 */
+#define CLEARCORE_SIM_CONNECTORS 18
+
+/** @brief Sample time of the simulated SysManager, 5 kHz */
+#define CLEARCORE_SIM_SAMPLE_US 200U
+
+/** @brief Value of ClearCoreSimIoImage::magic in a valid image file */
+#define CLEARCORE_SIM_IO_MAGIC 0x4F494343U
+
+/** @brief Connector states shared with the host
+ *
+ *  Bit n of the masks belongs to the connector with ClearCorePins index n.
+ *  The host writes @ref inputs and the encoder counts, the application
+ *  writes @ref outputs and @ref modes through the connector API. If
+ *  CLEARCORE_SIM_IO names a file the image is mapped from it, so that other
+ *  processes can drive the inputs and watch the outputs.
+ */
+typedef struct {
+  uint32_t magic; /**< CLEARCORE_SIM_IO_MAGIC */
+  volatile uint32_t inputs; /**< input states, written by the host */
+  volatile uint32_t outputs; /**< output states, written by the application */
+  volatile uint8_t modes[CLEARCORE_SIM_CONNECTORS]; /**< Connector::ConnectorModes */
+  volatile int32_t encoder_counts; /**< raw encoder counts, written by the host */
+  volatile int32_t encoder_index_counts; /**< counts at the last index pulse */
+  volatile int32_t motor_position[4]; /**< commanded position of M-0 .. M-3 */
+  volatile uint32_t ticks; /**< sample times run since start */
+} ClearCoreSimIoImage;
+
+typedef enum {
+  kClearCoreSimClockRealtime = 0, /**< follow CLOCK_MONOTONIC */
+  kClearCoreSimClockManual = 1 /**< advance only by ClearCoreSimClockAdvance() and delays */
+} ClearCoreSimClockMode;
+
+/** @brief The I/O image of the simulated board */
+ClearCoreSimIoImage *ClearCoreSimIo(void);
+
+void ClearCoreSimClockModeSet(ClearCoreSimClockMode mode);
+ClearCoreSimClockMode ClearCoreSimClockModeGet(void);
+
+/** @brief Advance the manual clock and run the sample times that elapsed */
+void ClearCoreSimClockAdvance(uint32_t microseconds);
+
+/** @brief Microseconds since start of the simulation */
+uint64_t ClearCoreSimMicros(void);
+
+/** @brief Set or clear one input connector */
+void ClearCoreSimInputSet(unsigned int connector,
+                          int state);
+
+/** @brief State of one output connector */
+int ClearCoreSimOutputGet(unsigned int connector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_CLEARCORE_H_ */
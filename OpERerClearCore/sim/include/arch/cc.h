@@ -0,0 +1,72 @@
+/**
+    \file cc.h
+    \brief lwIP abstraction layer of the host build.
+
+    Same as LwIP/LwIP/port/include/arch/cc.h, except that errno comes from the
+    C library: glibc keeps errno per thread, so lwIP may not provide its own.
+    Failed assertions abort instead of hanging.
+**/
+
+#ifndef CC_H_INCLUDED
+#define CC_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Types based on stdint.h */
+typedef uint8_t   u8_t;
+typedef int8_t    s8_t;
+typedef uint16_t  u16_t;
+typedef int16_t   s16_t;
+typedef uint32_t  u32_t;
+typedef int32_t   s32_t;
+typedef uintptr_t mem_ptr_t;
+
+/* Define (sn)printf formatters for these lwIP types */
+#define U16_F "hu"
+#define S16_F "hd"
+#define X16_F "hx"
+#define U32_F "u"
+#define S32_F "d"
+#define X32_F "x"
+
+#define PACK_STRUCT_BEGIN
+#define PACK_STRUCT_STRUCT __attribute__((packed))
+#define PACK_STRUCT_END
+#define PACK_STRUCT_FIELD(x) x
+
+#define LWIP_COMPAT_MUTEX 1
+
+#define LWIP_ERRNO_STDINCLUDE
+
+#ifdef LWIP_DEBUG
+#define LWIP_PLATFORM_DIAG(x)                                                  \
+	{                                                                          \
+		printf x;                                                              \
+	}
+#else
+#define LWIP_PLATFORM_DIAG(x)                                                  \
+	{                                                                          \
+		;                                                                      \
+	}
+#endif
+#define LWIP_PLATFORM_ASSERT(x)                                                \
+	{                                                                          \
+		printf("Assertion \"%s\" failed at line %d in %s\n", x, __LINE__,      \
+		       __FILE__);                                                      \
+		abort();                                                               \
+	}
+
+/* Internet checksum of the port, the LWIP_CHKSUM and LWIP_CHKSUM_COPY of
+   lwipopts.h */
+#ifdef __cplusplus
+extern "C" {
+#endif
+u16_t clearcore_chksum(const void *dataptr, int len);
+u16_t clearcore_chksum_copy(void *dst, const void *src, u16_t len);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CC_H_INCLUDED */
@@ -0,0 +1,31 @@
+/**
+    \file core_cm4.h
+    \brief Host build replacements of the CMSIS core functions the ClearCore
+    application uses.
+**/
+
+#ifndef __CORE_CM4_H__
+#define __CORE_CM4_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+    Restart the simulation: the process executes itself again, so that the
+    NVM file is loaded like after a reset of the board.
+**/
+void NVIC_SystemReset(void) __attribute__((noreturn));
+
+/**
+    The sample time runs in the context of the application, there is nothing
+    to lock out.
+**/
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CORE_CM4_H__
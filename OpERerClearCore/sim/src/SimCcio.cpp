@@ -0,0 +1,54 @@
+/**
+    \file SimCcio.cpp
+    \brief CCIO-8 link of the virtual ClearCore, with no boards attached.
+
+    The link is opened and closed by the serial ports, see SimSerial.cpp.
+**/
+
+#include "ClearCore.h"
+
+namespace ClearCore {
+
+static CcioBoardManager ccioBoardManager;
+CcioBoardManager &CcioMgr = ccioBoardManager;
+
+bool CcioPin::Mode(Connector::ConnectorModes newMode) {
+    if (newMode != Connector::INPUT_DIGITAL &&
+            newMode != Connector::OUTPUT_DIGITAL) {
+        return false;
+    }
+    m_mode = newMode;
+    return true;
+}
+
+CcioBoardManager::CcioBoardManager()
+    : m_serPort(nullptr),
+      m_currentOutputs(0),
+      m_ccioCnt(0),
+      m_ccioLinkBroken(false),
+      m_autoRediscover(true) {}
+
+uint8_t CcioBoardManager::CcioDiscover(SerialDriver *comInstance) {
+    m_serPort = comInstance;
+    m_ccioCnt = 0;
+    // Nothing answers on the port
+    m_ccioLinkBroken = comInstance != nullptr;
+    return 0;
+}
+
+void CcioBoardManager::LinkClose() {
+    m_serPort = nullptr;
+    m_ccioCnt = 0;
+    m_ccioLinkBroken = false;
+    m_currentOutputs = 0;
+}
+
+CcioPin *CcioBoardManager::PinByIndex(ClearCorePins connectorIndex) {
+    int index = connectorIndex - CLEARCORE_PIN_CCIO_BASE;
+    if (index < 0 || index >= MAX_CCIO_DEVICES * 8) {
+        return nullptr;
+    }
+    return &m_ccioPins[index];
+}
+
+} // ClearCore namespace
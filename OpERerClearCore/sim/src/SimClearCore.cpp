@@ -0,0 +1,765 @@
+/**
+    \file SimClearCore.cpp
+    \brief Clock, I/O image, connectors and motion of the virtual ClearCore.
+
+    The 5 kHz sample time of SysManager is run lazily: every read of the
+    clock first runs the sample times that elapsed since the last read, so
+    the application sees the same sequence of updates as on the board
+    without a second thread.
+**/
+
+#include "ClearCore.h"
+#include "SimInternal.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace ClearCore {
+
+namespace {
+
+ClearCoreSimIoImage privateIo;
+ClearCoreSimIoImage *simIo = nullptr;
+ClearCoreSimClockMode clockMode = kClearCoreSimClockRealtime;
+uint64_t clockStartNs;
+uint64_t manualMicros;
+uint64_t samplesRun;
+uint64_t runLimitMicros;
+uint32_t inputsLastSample;
+bool inTick;
+
+uint64_t MonotonicNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void IoDefaults(ClearCoreSimIoImage *io) {
+    memset(io, 0, sizeof(*io));
+    io->magic = CLEARCORE_SIM_IO_MAGIC;
+    for (int i = CLEARCORE_PIN_IO0; i <= CLEARCORE_PIN_DI8; i++) {
+        io->modes[i] = Connector::INPUT_DIGITAL;
+    }
+    for (int i = CLEARCORE_PIN_A9; i <= CLEARCORE_PIN_A12; i++) {
+        io->modes[i] = Connector::INPUT_ANALOG;
+    }
+    io->modes[CLEARCORE_PIN_LED] = Connector::OUTPUT_DIGITAL;
+    for (int i = CLEARCORE_PIN_M0; i <= CLEARCORE_PIN_M3; i++) {
+        io->modes[i] = Connector::CPM_MODE_A_DIRECT_B_DIRECT;
+    }
+}
+
+ClearCoreSimIoImage *IoMap(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof(ClearCoreSimIoImage)) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    void *image = mmap(nullptr, sizeof(ClearCoreSimIoImage),
+                       PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    return static_cast<ClearCoreSimIoImage *>(image);
+}
+
+/**
+    Set up the simulation from the environment on first use, the global
+    connector objects may be used before main().
+**/
+void SimInit() {
+    if (simIo) {
+        return;
+    }
+    const char *ioPath = getenv("CLEARCORE_SIM_IO");
+    simIo = (ioPath && *ioPath) ? IoMap(ioPath) : &privateIo;
+    if (simIo->magic != CLEARCORE_SIM_IO_MAGIC) {
+        IoDefaults(simIo);
+    }
+    // A fresh run starts at tick 0 even if the image file is reused
+    simIo->ticks = 0;
+    inputsLastSample = simIo->inputs;
+
+    const char *clock = getenv("CLEARCORE_SIM_CLOCK");
+    if (clock && !strcasecmp(clock, "manual")) {
+        clockMode = kClearCoreSimClockManual;
+    }
+    const char *runMs = getenv("CLEARCORE_SIM_RUN_MS");
+    if (runMs) {
+        runLimitMicros = strtoull(runMs, nullptr, 0) * 1000ULL;
+    }
+    clockStartNs = MonotonicNs();
+}
+
+/**
+    The sample time of SysManager::FastUpdate().
+**/
+void SimSample() {
+    ProfileStubCycles =
+        (uint32_t)(samplesRun * CLEARCORE_SIM_SAMPLE_US * CYCLES_PER_MICROSECOND);
+    MotorDriver *motors[] = {
+        &ConnectorM0, &ConnectorM1, &ConnectorM2, &ConnectorM3
+    };
+    for (uint8_t i = 0; i < 4; i++) {
+        motors[i]->Refresh();
+        simIo->motor_position[i] = motors[i]->PositionRefCommanded();
+    }
+    EncoderIn.Update(inputsLastSample);
+    AdcMgr.Update((uint32_t)(samplesRun * CLEARCORE_SIM_SAMPLE_US));
+    voidFuncPtr sampleCallback = SysMgr.SampleCallback();
+    if (sampleCallback) {
+        sampleCallback();
+    }
+    inputsLastSample = simIo->inputs;
+    simIo->ticks++;
+}
+
+/**
+    Run the sample times that elapsed up to now.
+**/
+void SimTick() {
+    SimInit();
+    if (inTick) {
+        return;
+    }
+    inTick = true;
+    uint64_t now = ClearCoreSimMicros();
+    while ((samplesRun + 1) * CLEARCORE_SIM_SAMPLE_US <= now) {
+        samplesRun++;
+        SimSample();
+    }
+    inTick = false;
+    if (runLimitMicros && now >= runLimitMicros) {
+        fflush(stdout);
+        exit(EXIT_SUCCESS);
+    }
+}
+
+} // anonymous namespace
+
+void SimRefreshIdle() {
+    if (clockMode == kClearCoreSimClockManual) {
+        ClearCoreSimClockAdvance(CLEARCORE_SIM_SAMPLE_US);
+    }
+    else {
+        SimTick();
+    }
+}
+
+/**
+    Returns the mode of the connector.
+**/
+Connector::ConnectorModes Connector::Mode() {
+    SimInit();
+    return static_cast<ConnectorModes>(simIo->modes[m_pin]);
+}
+
+/**
+    Sets the mode of the connector, accepting the modes the connector
+    supports on the board.
+**/
+bool Connector::Mode(ConnectorModes newMode) {
+    SimInit();
+    bool supported;
+    switch (m_pin) {
+        case CLEARCORE_PIN_IO0:
+        case CLEARCORE_PIN_IO1:
+        case CLEARCORE_PIN_IO2:
+        case CLEARCORE_PIN_IO3:
+        case CLEARCORE_PIN_IO4:
+        case CLEARCORE_PIN_IO5:
+            supported = newMode == INPUT_DIGITAL || newMode == OUTPUT_DIGITAL ||
+                        newMode == OUTPUT_PWM;
+            break;
+        case CLEARCORE_PIN_DI6:
+        case CLEARCORE_PIN_DI7:
+        case CLEARCORE_PIN_DI8:
+            supported = newMode == INPUT_DIGITAL;
+            break;
+        case CLEARCORE_PIN_A9:
+        case CLEARCORE_PIN_A10:
+        case CLEARCORE_PIN_A11:
+        case CLEARCORE_PIN_A12:
+            supported = newMode == INPUT_DIGITAL || newMode == INPUT_ANALOG;
+            break;
+        case CLEARCORE_PIN_LED:
+            supported = newMode == OUTPUT_DIGITAL;
+            break;
+        default:
+            supported = false;
+            break;
+    }
+    if (supported) {
+        simIo->modes[m_pin] = newMode;
+        // Leaving an output mode drops the output
+        if (newMode != OUTPUT_DIGITAL && newMode != OUTPUT_PWM) {
+            simIo->outputs &= ~(1UL << m_pin);
+        }
+    }
+    return supported;
+}
+
+/**
+    Returns the output state in an output mode and the input state
+    otherwise. Analog inputs read full scale of the 12-bit ADC while set.
+**/
+int16_t Connector::State() {
+    SimInit();
+    uint32_t mask = 1UL << m_pin;
+    switch (simIo->modes[m_pin]) {
+        case OUTPUT_DIGITAL:
+        case OUTPUT_PWM:
+            return (simIo->outputs & mask) ? 1 : 0;
+        case INPUT_ANALOG:
+            return (simIo->inputs & mask) ? 4095 : 0;
+        default:
+            return (simIo->inputs & mask) ? 1 : 0;
+    }
+}
+
+bool Connector::State(int16_t newState) {
+    SimInit();
+    uint8_t mode = simIo->modes[m_pin];
+    if (mode != OUTPUT_DIGITAL && mode != OUTPUT_PWM) {
+        return false;
+    }
+    if (newState) {
+        simIo->outputs |= 1UL << m_pin;
+    }
+    else {
+        simIo->outputs &= ~(1UL << m_pin);
+    }
+    return true;
+}
+
+SysConnectorState InputManager::InputsRT(SysConnectorState mask) {
+    SimInit();
+    return SysConnectorState(simIo->inputs & mask.reg);
+}
+
+MotorDriver::MotorDriver(uint8_t axis)
+    : m_axis(axis),
+      m_enableRequest(false),
+      m_positionalMove(false),
+      m_position(0),
+      m_target(0),
+      m_velocity(0),
+      m_velMax(10000),
+      m_accelMax(100000),
+      m_eStopDecelMax(100000),
+      m_positionFrac(0),
+      m_hlfbState(HLFB_DEASSERTED),
+      m_hlfbDuty(HLFB_DUTY_UNKNOWN) {}
+
+bool MotorDriver::Move(int32_t dist, MoveTarget moveTarget) {
+    if (!m_enableRequest) {
+        m_alertReg.bit.MotionCanceledMotorDisabled = 1;
+        StatusUpdate();
+        return false;
+    }
+    if (m_alertReg.reg) {
+        m_alertReg.bit.MotionCanceledInAlert = 1;
+        StatusUpdate();
+        return false;
+    }
+    // Relative moves continue from the end of the move in progress
+    int32_t base = m_positionalMove ? m_target : m_position;
+    m_target = (moveTarget == MOVE_TARGET_ABSOLUTE) ? dist : base + dist;
+    m_positionalMove = true;
+    StatusUpdate();
+    return true;
+}
+
+bool MotorDriver::MoveVelocity(int32_t velocity) {
+    if (!m_enableRequest) {
+        m_alertReg.bit.MotionCanceledMotorDisabled = 1;
+        StatusUpdate();
+        return false;
+    }
+    if (m_alertReg.reg) {
+        m_alertReg.bit.MotionCanceledInAlert = 1;
+        StatusUpdate();
+        return false;
+    }
+    m_positionalMove = false;
+    m_velocity = velocity;
+    StatusUpdate();
+    return true;
+}
+
+void MotorDriver::MoveStopAbrupt() {
+    m_positionalMove = false;
+    m_velocity = 0;
+    m_target = m_position;
+    StatusUpdate();
+}
+
+void MotorDriver::MoveStopDecel(uint32_t decelMax) {
+    (void)decelMax;
+    // The ideal motor stops within the sample
+    MoveStopAbrupt();
+}
+
+void MotorDriver::EnableRequest(bool value) {
+    m_enableRequest = value;
+    if (!value) {
+        MoveStopAbrupt();
+    }
+    StatusUpdate();
+}
+
+void MotorDriver::Refresh() {
+    if (m_positionalMove) {
+        int32_t remaining = m_target - m_position;
+        if (remaining == 0) {
+            m_positionalMove = false;
+            m_velocity = 0;
+        }
+        else {
+            m_velocity = remaining > 0 ? (int32_t)m_velMax
+                                       : -(int32_t)m_velMax;
+        }
+    }
+    if (m_velocity) {
+        // Steps per sample, in 1/65536 steps
+        m_positionFrac += ((int64_t)m_velocity << 16) /
+                          (1000000 / CLEARCORE_SIM_SAMPLE_US);
+        int32_t position = (int32_t)(m_positionFrac >> 16);
+        if (m_positionalMove &&
+                ((m_velocity > 0 && position >= m_target) ||
+                 (m_velocity < 0 && position <= m_target))) {
+            position = m_target;
+            m_positionFrac = (int64_t)position << 16;
+            m_positionalMove = false;
+            m_velocity = 0;
+        }
+        m_position = position;
+    }
+    StatusUpdate();
+}
+
+void MotorDriver::StatusUpdate() {
+    bool moving = m_velocity != 0;
+    m_hlfbState = m_enableRequest ? HLFB_ASSERTED : HLFB_DEASSERTED;
+
+    StatusRegMotor status;
+    status.bit.AtTargetPosition = !m_positionalMove && m_position == m_target;
+    status.bit.StepsActive = moving;
+    status.bit.AtTargetVelocity = !m_positionalMove;
+    status.bit.MoveDirection = m_velocity > 0;
+    status.bit.Enabled = m_enableRequest;
+    status.bit.PositionalMove = m_positionalMove;
+    status.bit.HlfbState = m_hlfbState;
+    status.bit.AlertsPresent = m_alertReg.reg != 0;
+    status.bit.ReadyState = !m_enableRequest ? MOTOR_DISABLED :
+                            moving ? MOTOR_MOVING : MOTOR_READY;
+    m_statusReg.reg = status.reg;
+}
+
+bool MotorManager::MotorModeSet(MotorPair motorPair,
+                                Connector::ConnectorModes newMode) {
+    SimInit();
+    switch (newMode) {
+        case Connector::CPM_MODE_A_DIRECT_B_DIRECT:
+        case Connector::CPM_MODE_STEP_AND_DIR:
+        case Connector::CPM_MODE_A_DIRECT_B_PWM:
+        case Connector::CPM_MODE_A_PWM_B_PWM:
+            break;
+        default:
+            return false;
+    }
+    int first = (motorPair == MOTOR_M2M3) ? 2 : 0;
+    int last = (motorPair == MOTOR_M0M1) ? 1 : 3;
+    for (int i = first; i <= last; i++) {
+        simIo->modes[CLEARCORE_PIN_M0 + i] = newMode;
+    }
+    return true;
+}
+
+EncoderInput::EncoderInput()
+    : m_enabled(false),
+      m_countsLast(0),
+      m_position(0),
+      m_positionOffset(0),
+      m_velocity(0),
+      m_velocityFiltered(0),
+      m_velocityFilterTcMs(1),
+      m_positionTimestamp(0),
+      m_latchArmed(false),
+      m_latchPin(CLEARCORE_PIN_INVALID),
+      m_latchTrigger(InputManager::RISING),
+      m_latchPosition(0),
+      m_latchTimestamp(0),
+      m_latchCount(0) {}
+
+int32_t EncoderInput::Position() {
+    return m_position;
+}
+
+int32_t EncoderInput::Position(int32_t newPosn) {
+    SimInit();
+    m_positionOffset = simIo->encoder_counts - newPosn;
+    m_position = newPosn;
+    return m_position;
+}
+
+int32_t EncoderInput::IndexPosition() {
+    SimInit();
+    return simIo->encoder_index_counts - m_positionOffset;
+}
+
+void EncoderInput::Enable(bool isEnabled) {
+    SimInit();
+    if (isEnabled && !m_enabled) {
+        m_countsLast = simIo->encoder_counts;
+    }
+    m_enabled = isEnabled;
+}
+
+int32_t EncoderInput::VelocityFiltered() {
+    return m_velocityFiltered;
+}
+
+bool EncoderInput::RegistrationLatchArm(ClearCorePins pin,
+                                        InputManager::InterruptTrigger trigger) {
+    if (pin < CLEARCORE_PIN_DI6 || pin > CLEARCORE_PIN_A12) {
+        return false;
+    }
+    m_latchPin = pin;
+    m_latchTrigger = trigger;
+    m_latchArmed = true;
+    return true;
+}
+
+void EncoderInput::RegistrationLatchDisarm() {
+    m_latchArmed = false;
+}
+
+int32_t EncoderInput::RegistrationPosition() {
+    return m_latchPosition;
+}
+
+void EncoderInput::Update(uint32_t inputsLastSample) {
+    if (!m_enabled) {
+        return;
+    }
+    uint32_t now = (uint32_t)ClearCoreSimMicros();
+    int32_t counts = simIo->encoder_counts;
+    int32_t delta = counts - m_countsLast;
+    m_countsLast = counts;
+    m_position = counts - m_positionOffset;
+    if (delta) {
+        m_positionTimestamp = now;
+    }
+    m_velocity = delta * (int32_t)(1000000 / CLEARCORE_SIM_SAMPLE_US);
+    // First order filter settling in the time constant
+    int32_t tcSamples = m_velocityFilterTcMs * 1000 / CLEARCORE_SIM_SAMPLE_US;
+    m_velocityFiltered += (m_velocity - m_velocityFiltered) / tcSamples;
+
+    if (!m_latchArmed) {
+        return;
+    }
+    uint32_t mask = 1UL << m_latchPin;
+    bool last = inputsLastSample & mask;
+    bool state = simIo->inputs & mask;
+    bool fire;
+    switch (m_latchTrigger) {
+        case InputManager::LOW:
+            fire = !state;
+            break;
+        case InputManager::HIGH:
+            fire = state;
+            break;
+        case InputManager::CHANGE:
+            fire = state != last;
+            break;
+        case InputManager::FALLING:
+            fire = last && !state;
+            break;
+        case InputManager::RISING:
+        default:
+            fire = !last && state;
+            break;
+    }
+    if (fire) {
+        m_latchPosition = m_position;
+        m_latchTimestamp = now;
+        m_latchCount++;
+        m_latchArmed = false;
+    }
+}
+
+AdcManager::AdcManager()
+    : m_acqMode(ACQ_MODE_SAMPLE),
+      m_oversampling(),
+      m_blockSample(0),
+      m_block(),
+      m_filtered(),
+      m_decimated(),
+      m_decimatedTimestamp(),
+      m_resultTimestamp(0),
+      m_blockOverruns(0) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        m_filter[i].Tc_ms(ADC_IIR_FILTER_TC_MS);
+    }
+}
+
+bool AdcManager::FilterTc(AdcChannels adcChannel, uint16_t tc,
+                          FilterUnits theUnits) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    switch (theUnits) {
+        case FILTER_UNIT_RAW:
+            m_filter[adcChannel].Tc(tc);
+            return true;
+        case FILTER_UNIT_MS:
+            m_filter[adcChannel].Tc_ms(tc);
+            return true;
+        case FILTER_UNIT_SAMPLES:
+            m_filter[adcChannel].TcSamples(tc);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool AdcManager::AcquisitionMode(AcquisitionModes mode) {
+    if (mode != ACQ_MODE_SAMPLE && mode != ACQ_MODE_BLOCK) {
+        return false;
+    }
+    m_acqMode = mode;
+    m_blockSample = 0;
+    return true;
+}
+
+bool AdcManager::Oversampling(AdcChannels adcChannel, uint8_t samplesLog2) {
+    if (adcChannel >= ADC_CHANNEL_COUNT ||
+            samplesLog2 > ADC_OVERSAMPLING_MAX) {
+        return false;
+    }
+    uint16_t conversions = 0;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        conversions += 1U << (i == adcChannel ? samplesLog2 :
+                              m_oversampling[i]);
+    }
+    if (conversions > ADC_CONVERSIONS_PER_SAMPLE_MAX) {
+        return false;
+    }
+    m_oversampling[adcChannel] = samplesLog2;
+    return true;
+}
+
+bool AdcManager::Decimation(AdcChannels adcChannel, uint16_t samples) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    return m_decimator[adcChannel].Decimation(samples);
+}
+
+void AdcManager::Update(uint32_t sampleMicros) {
+    // Nominal 24 V supply and 5 V off-board supply, 12-bit full scale
+    static const uint16_t monitors[ADC_CHANNEL_COUNT] = {
+        1216, 0, 3102, 0, 0, 0, 0, 0
+    };
+    static const ClearCorePins pins[ADC_CHANNEL_COUNT] = {
+        CLEARCORE_PIN_INVALID, CLEARCORE_PIN_A12, CLEARCORE_PIN_INVALID,
+        CLEARCORE_PIN_A11, CLEARCORE_PIN_A10, CLEARCORE_PIN_A9,
+        CLEARCORE_PIN_INVALID, CLEARCORE_PIN_INVALID
+    };
+    uint16_t *results = m_block[m_blockSample];
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        uint16_t raw = monitors[i];
+        if (pins[i] != CLEARCORE_PIN_INVALID) {
+            bool high = simIo->modes[pins[i]] == Connector::INPUT_ANALOG &&
+                        (simIo->inputs & (1UL << pins[i]));
+            raw = high ? 4095 : 0;
+        }
+        // Hardware averaging sums 2^n conversions into 12 + n bits
+        results[i] = raw << m_oversampling[i];
+    }
+
+    if (m_acqMode == ACQ_MODE_SAMPLE) {
+        ResultsProcess(1, sampleMicros);
+    }
+    else if (++m_blockSample == ADC_BLOCK_SAMPLES) {
+        m_blockSample = 0;
+        ResultsProcess(ADC_BLOCK_SAMPLES, sampleMicros);
+    }
+}
+
+void AdcManager::ResultsProcess(uint8_t samples, uint32_t lastTimestamp) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        AdcDecimator &decimator = m_decimator[i];
+        if (decimator.Process(&m_block[0][i], ADC_CHANNEL_COUNT, samples,
+                              ResultBits(i), m_filter[i])) {
+            m_decimated[i] = decimator.Decimated();
+            m_decimatedTimestamp[i] = lastTimestamp -
+                                      decimator.Pending() *
+                                      CLEARCORE_SIM_SAMPLE_US;
+        }
+        m_filtered[i] = m_filter[i].LastOutput();
+    }
+    m_resultTimestamp = lastTimestamp;
+}
+
+void SerialUsb::PortOpen() {}
+
+void SerialUsb::Flush() {
+    fflush(stdout);
+}
+
+bool SerialUsb::SendChar(uint8_t charToSend) {
+    // Bytes pass unchanged, the port also carries binary trace records
+    putchar(charToSend);
+    return true;
+}
+
+Connector ConnectorIO0(CLEARCORE_PIN_IO0);
+Connector ConnectorIO1(CLEARCORE_PIN_IO1);
+Connector ConnectorIO2(CLEARCORE_PIN_IO2);
+Connector ConnectorIO3(CLEARCORE_PIN_IO3);
+Connector ConnectorIO4(CLEARCORE_PIN_IO4);
+Connector ConnectorIO5(CLEARCORE_PIN_IO5);
+Connector ConnectorDI6(CLEARCORE_PIN_DI6);
+Connector ConnectorDI7(CLEARCORE_PIN_DI7);
+Connector ConnectorDI8(CLEARCORE_PIN_DI8);
+Connector ConnectorA9(CLEARCORE_PIN_A9);
+Connector ConnectorA10(CLEARCORE_PIN_A10);
+Connector ConnectorA11(CLEARCORE_PIN_A11);
+Connector ConnectorA12(CLEARCORE_PIN_A12);
+Connector ConnectorLed(CLEARCORE_PIN_LED);
+MotorDriver ConnectorM0(0);
+MotorDriver ConnectorM1(1);
+MotorDriver ConnectorM2(2);
+MotorDriver ConnectorM3(3);
+SerialUsb ConnectorUsb;
+static MotorManager motorManager;
+MotorManager &MotorMgr = motorManager;
+EncoderInput EncoderIn;
+static AdcManager adcManager;
+AdcManager &AdcMgr = adcManager;
+static InputManager inputManager;
+InputManager &InputMgr = inputManager;
+SysManager SysMgr;
+
+} // ClearCore namespace
+
+extern "C" {
+
+ClearCoreSimIoImage *ClearCoreSimIo(void) {
+    ClearCore::SimInit();
+    return ClearCore::simIo;
+}
+
+void ClearCoreSimClockModeSet(ClearCoreSimClockMode mode) {
+    ClearCore::SimInit();
+    if (mode == ClearCore::clockMode) {
+        return;
+    }
+    // Continue from the current time in the new mode
+    uint64_t now = ClearCoreSimMicros();
+    ClearCore::clockMode = mode;
+    ClearCore::manualMicros = now;
+    ClearCore::clockStartNs = ClearCore::MonotonicNs() - now * 1000ULL;
+}
+
+ClearCoreSimClockMode ClearCoreSimClockModeGet(void) {
+    ClearCore::SimInit();
+    return ClearCore::clockMode;
+}
+
+void ClearCoreSimClockAdvance(uint32_t microseconds) {
+    ClearCore::SimInit();
+    if (ClearCore::clockMode == kClearCoreSimClockManual) {
+        ClearCore::manualMicros += microseconds;
+    }
+    ClearCore::SimTick();
+}
+
+uint64_t ClearCoreSimMicros(void) {
+    ClearCore::SimInit();
+    if (ClearCore::clockMode == kClearCoreSimClockManual) {
+        return ClearCore::manualMicros;
+    }
+    return (ClearCore::MonotonicNs() - ClearCore::clockStartNs) / 1000ULL;
+}
+
+void ClearCoreSimInputSet(unsigned int connector,
+                          int state) {
+    ClearCore::SimInit();
+    if (connector >= CLEARCORE_SIM_CONNECTORS) {
+        return;
+    }
+    if (state) {
+        ClearCore::simIo->inputs |= 1UL << connector;
+    }
+    else {
+        ClearCore::simIo->inputs &= ~(1UL << connector);
+    }
+}
+
+int ClearCoreSimOutputGet(unsigned int connector) {
+    ClearCore::SimInit();
+    if (connector >= CLEARCORE_SIM_CONNECTORS) {
+        return 0;
+    }
+    return (ClearCore::simIo->outputs >> connector) & 1;
+}
+
+uint32_t Milliseconds(void) {
+    ClearCore::SimTick();
+    return (uint32_t)(ClearCoreSimMicros() / 1000ULL);
+}
+
+uint32_t Microseconds(void) {
+    ClearCore::SimTick();
+    return (uint32_t)ClearCoreSimMicros();
+}
+
+void Delay_cycles(uint64_t cycles) {
+    uint64_t micros = cycles / CYCLES_PER_MICROSECOND;
+    if (ClearCoreSimClockModeGet() == kClearCoreSimClockManual) {
+        ClearCoreSimClockAdvance((uint32_t)micros);
+        return;
+    }
+    uint64_t end = ClearCoreSimMicros() + micros;
+    for (uint64_t now = ClearCoreSimMicros(); now < end;
+            now = ClearCoreSimMicros()) {
+        uint64_t sleepMicros = end - now;
+        if (sleepMicros > CLEARCORE_SIM_SAMPLE_US) {
+            sleepMicros = CLEARCORE_SIM_SAMPLE_US;
+        }
+        usleep((useconds_t)sleepMicros);
+        ClearCore::SimTick();
+    }
+}
+
+void NVIC_SystemReset(void) {
+    fflush(stdout);
+    // Start over like the board does, the NVM file keeps the settings
+    static char cmdline[4096];
+    static char *argv[64];
+    int fd = open("/proc/self/cmdline", O_RDONLY);
+    ssize_t length = (fd < 0) ? -1 : read(fd, cmdline, sizeof(cmdline) - 1);
+    if (fd >= 0) {
+        close(fd);
+    }
+    size_t argc = 0;
+    for (ssize_t i = 0; i < length && argc < 63; i += strlen(&cmdline[i]) + 1) {
+        argv[argc++] = &cmdline[i];
+    }
+    argv[argc] = nullptr;
+    execv("/proc/self/exe", argv);
+    perror("NVIC_SystemReset");
+    _exit(EXIT_FAILURE);
+}
+
+} // extern "C"
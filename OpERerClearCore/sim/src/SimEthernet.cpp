@@ -0,0 +1,300 @@
+/**
+    \file SimEthernet.cpp
+    \brief Ethernet port of the virtual ClearCore on a Linux TAP device.
+
+    The lwIP stack runs unchanged; only the GMAC driver is replaced by reads
+    and writes of whole frames on the TAP device named by CLEARCORE_SIM_TAP.
+    The device must exist and be up, e.g.:
+
+        ip tuntap add dev tap0 mode tap user $USER
+        ip addr add 192.168.1.1/24 dev tap0
+        ip link set tap0 up
+**/
+
+#include "ClearCore.h"
+#include "EthernetApi.h"
+#include "GmacRxScreen.h"
+#include "InetChecksum.h"
+#include "NvmManager.h"
+#include "SimInternal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include "lwip/dhcp.h"
+#include "lwip/dns.h"
+#include "lwip/etharp.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/timeouts.h"
+#include "netif/ethernet.h"
+
+namespace ClearCore {
+
+namespace {
+
+struct netif macInterface;
+uint8_t macAddress[ETH_HWADDR_LEN];
+int tapFd = -1;
+bool tapOpened;
+// Screening of the received frames, as on the GMAC
+GmacRxScreen rxScreen;
+RxArbiter<struct pbuf *, RX_IO_QUEUE_CNT, RX_OTHER_QUEUE_CNT> rxQueue;
+
+/**
+    Attach to the TAP device once, the link is down if that fails.
+**/
+void TapOpen() {
+    if (tapOpened) {
+        return;
+    }
+    tapOpened = true;
+    const char *name = getenv("CLEARCORE_SIM_TAP");
+    if (!name || !*name) {
+        name = "tap0";
+    }
+    int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        perror("/dev/net/tun");
+        return;
+    }
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+        perror(name);
+        close(fd);
+        return;
+    }
+    tapFd = fd;
+}
+
+err_t TapOutput(struct netif *netif, struct pbuf *p) {
+    (void)netif;
+    uint8_t frame[ETH_HWADDR_LEN * 2 + 2 + 1536];
+    if (tapFd < 0 || p->tot_len > sizeof(frame)) {
+        return ERR_IF;
+    }
+    pbuf_copy_partial(p, frame, p->tot_len, 0);
+    if (write(tapFd, frame, p->tot_len) != p->tot_len) {
+        return ERR_IF;
+    }
+    return ERR_OK;
+}
+
+/**
+    Read the frames waiting on the TAP device into the receive queues.
+
+    \return true if a frame was read
+**/
+bool TapInput() {
+    uint8_t frame[ETH_HWADDR_LEN * 2 + 2 + 1536];
+    bool received = false;
+    ssize_t length;
+    while ((length = read(tapFd, frame, sizeof(frame))) > 0) {
+        received = true;
+        GmacRxScreen::Queues queue =
+            rxScreen.Classify(frame, (uint32_t)length);
+        if (rxQueue.Full(queue)) {
+            rxQueue.Drop(queue);
+            continue;
+        }
+        struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)length, PBUF_POOL);
+        if (p) {
+            pbuf_take(p, frame, (u16_t)length);
+            rxQueue.Push(queue, p);
+        }
+    }
+    return received;
+}
+
+err_t TapNetifInit(struct netif *netif) {
+    netif->output = etharp_output;
+    netif->linkoutput = TapOutput;
+    // The TAP device delivers every frame, so IGMP needs no MAC filter
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP |
+                   NETIF_FLAG_ETHERNET | NETIF_FLAG_IGMP;
+    // The TAP device drops frames above the standard MTU
+    netif->mtu = 1500;
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    memcpy(netif->hwaddr, macAddress, ETH_HWADDR_LEN);
+    netif->name[0] = 'T';
+    netif->name[1] = 'C';
+    return ERR_OK;
+}
+
+} // anonymous namespace
+
+EthernetManager &EthernetManager::Instance() {
+    static EthernetManager *instance = new EthernetManager;
+    return *instance;
+}
+
+EthernetManager::EthernetManager()
+    : m_dhcp(false),
+      m_ethernetActive(false),
+      m_counters() {
+    NvmManager::Instance().MacAddress(macAddress);
+}
+
+bool EthernetManager::PhyLinkActive() {
+    TapOpen();
+    return tapFd >= 0;
+}
+
+void EthernetManager::Setup() {
+    // Setup can only occur once.
+    if (m_ethernetActive) {
+        return;
+    }
+    TapOpen();
+    lwip_init();
+    dns_init();
+
+    ip_addr_t dummyIp = IPADDR4_INIT(0);
+    netif_add(&macInterface, ip_2_ip4(&dummyIp), ip_2_ip4(&dummyIp),
+              ip_2_ip4(&dummyIp), nullptr, TapNetifInit, ethernet_input);
+    netif_set_default(&macInterface);
+    netif_set_link_up(&macInterface);
+    netif_set_up(&macInterface);
+    m_ethernetActive = true;
+}
+
+bool EthernetManager::DhcpBegin() {
+    struct netif *netif = &macInterface;
+    uint32_t DHCP_TIMEOUT_MS = 1500;
+
+    bool dhcpSuccess = false;
+    for (uint8_t i = 0; i < 5 && !dhcpSuccess; i++) {
+        // Try to get our config info from a DHCP server
+        err_t err = dhcp_start(netif);
+
+        if (err == ERR_OK) {
+            uint32_t startMs = Milliseconds();
+
+            while (dhcp_supplied_address(netif) == 0) {
+                if (Milliseconds() - startMs > DHCP_TIMEOUT_MS) {
+                    // Timed out, stop the dhcp process.
+                    dhcp_release_and_stop(netif);
+                    break;
+                }
+                Refresh();
+            }
+            dhcpSuccess = (dhcp_supplied_address(netif) != 0);
+        }
+    }
+    m_dhcp = dhcpSuccess;
+    return dhcpSuccess;
+}
+
+bool EthernetManager::DhcpStart() {
+    if (m_dhcp) {
+        // Already negotiating or bound, a restart would drop the lease.
+        return true;
+    }
+    if (dhcp_start(&macInterface) != ERR_OK) {
+        return false;
+    }
+    m_dhcp = true;
+    return true;
+}
+
+bool EthernetManager::DhcpBound() {
+    return m_dhcp && dhcp_supplied_address(&macInterface) != 0;
+}
+
+/**
+    Pass the received frames to lwIP and run its timers. If nothing arrived
+    the call waits for a frame for up to one sample time, so that the polling
+    main loop does not spin a host CPU.
+**/
+void EthernetManager::Refresh() {
+    bool received = false;
+    // I/O frames first, as on the GMAC (see EthernetManager.cpp)
+    rxQueue.Round(RX_OTHER_QUEUE_CNT);
+    while (m_ethernetActive && tapFd >= 0) {
+        received |= TapInput();
+        struct pbuf *packet;
+        if (!rxQueue.Pop(packet)) {
+            break;
+        }
+        if (macInterface.input(packet, &macInterface) != ERR_OK) {
+            pbuf_free(packet);
+        }
+    }
+    if (!received) {
+        if (tapFd >= 0 &&
+                ClearCoreSimClockModeGet() == kClearCoreSimClockRealtime) {
+            struct pollfd pfd = {tapFd, POLLIN, 0};
+            poll(&pfd, 1, 1);
+        }
+        SimRefreshIdle();
+    }
+    sys_check_timeouts();
+}
+
+uint8_t *EthernetManager::MacAddress() {
+    return macAddress;
+}
+
+IpAddress EthernetManager::LocalIp() {
+    return IpAddress(macInterface.ip_addr.addr);
+}
+
+void EthernetManager::LocalIp(IpAddress ipaddr) {
+    if (!m_dhcp) {
+        macInterface.ip_addr.addr = uint32_t(ipaddr);
+    }
+}
+
+IpAddress EthernetManager::NetmaskIp() {
+    return IpAddress(macInterface.netmask.addr);
+}
+
+void EthernetManager::NetmaskIp(IpAddress address) {
+    if (!m_dhcp) {
+        macInterface.netmask.addr = uint32_t(address);
+    }
+}
+
+IpAddress EthernetManager::GatewayIp() {
+    return IpAddress(macInterface.gw.addr);
+}
+
+void EthernetManager::GatewayIp(IpAddress address) {
+    if (!m_dhcp) {
+        macInterface.gw.addr = uint32_t(address);
+    }
+}
+
+struct netif *EthernetManager::MacInterface() {
+    return &macInterface;
+}
+
+EthernetManager &EthernetMgr = EthernetManager::Instance();
+
+} // ClearCore namespace
+
+/**
+    The LWIP_CHKSUM of lwipopts.h. The TAP device has no checksum offload, so
+    it covers all checksums.
+**/
+extern "C" u16_t clearcore_chksum(const void *dataptr, int len) {
+    return ClearCore::InetChecksum::Sum(dataptr, len);
+}
+
+/**
+    The LWIP_CHKSUM_COPY of lwipopts.h.
+**/
+extern "C" u16_t clearcore_chksum_copy(void *dst, const void *src,
+                                     u16_t len) {
+    return ClearCore::InetChecksum::Copy(dst, src, len);
+}
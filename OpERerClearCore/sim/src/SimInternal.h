@@ -0,0 +1,20 @@
+/**
+    \file SimInternal.h
+    \brief Interfaces between the parts of the virtual ClearCore.
+**/
+
+#ifndef __SIMINTERNAL_H__
+#define __SIMINTERNAL_H__
+
+namespace ClearCore {
+
+/**
+    Called by EthernetManager::Refresh() when no frame was received: runs the
+    elapsed sample times, and in manual clock mode lets one sample time pass
+    so that the polling main loop of the application makes progress.
+**/
+void SimRefreshIdle();
+
+} // ClearCore namespace
+
+#endif // __SIMINTERNAL_H__
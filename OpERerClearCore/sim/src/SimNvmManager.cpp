@@ -0,0 +1,216 @@
+/**
+    \file SimNvmManager.cpp
+    \brief NVM user page and data flash of the virtual ClearCore, kept in
+    files.
+
+    Bounds checks and return values follow libClearCore/src/NvmManager.cpp,
+    including the Teknic reserved area being read only.
+**/
+
+#include "NvmManager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace ClearCore {
+
+NvmManager &NvmManager::Instance() {
+    static NvmManager *instance = new NvmManager;
+    return *instance;
+}
+
+NvmManager::NvmManager() {
+    m_path = getenv("CLEARCORE_SIM_NVM");
+    if (!m_path || !*m_path) {
+        m_path = "clearcore_nvm.bin";
+    }
+    // An erased page reads all ones, like the board out of the box
+    memset(m_nvmPageCache, 0xFF, sizeof(m_nvmPageCache));
+    FILE *file = fopen(m_path, "rb");
+    if (file) {
+        size_t length = fread(m_nvmPageCache, 1, sizeof(m_nvmPageCache), file);
+        (void)length;
+        fclose(file);
+    }
+
+    m_dataFlashPath = getenv("CLEARCORE_SIM_DATA_FLASH");
+    if (!m_dataFlashPath || !*m_dataFlashPath) {
+        m_dataFlashPath = "clearcore_dataflash.bin";
+    }
+    memset(m_dataFlash, 0xFF, sizeof(m_dataFlash));
+    file = fopen(m_dataFlashPath, "rb");
+    if (file) {
+        size_t length = fread(m_dataFlash, 1, sizeof(m_dataFlash), file);
+        (void)length;
+        fclose(file);
+    }
+}
+
+bool NvmManager::Store() {
+    FILE *file = fopen(m_path, "wb");
+    if (!file) {
+        perror(m_path);
+        return false;
+    }
+    bool written = fwrite(m_nvmPageCache, 1, sizeof(m_nvmPageCache), file) ==
+                   sizeof(m_nvmPageCache);
+    return (fclose(file) == 0) && written;
+}
+
+bool NvmManager::StoreDataFlash(uint32_t offset, uint32_t lengthInBytes) {
+    FILE *file = fopen(m_dataFlashPath, "r+b");
+    if (!file) {
+        // First write, create the whole area
+        file = fopen(m_dataFlashPath, "wb");
+        offset = 0;
+        lengthInBytes = sizeof(m_dataFlash);
+    }
+    if (!file) {
+        perror(m_dataFlashPath);
+        return false;
+    }
+    bool written = fseek(file, offset, SEEK_SET) == 0 &&
+                   fwrite(&m_dataFlash[offset], 1, lengthInBytes, file) ==
+                   lengthInBytes;
+    return (fclose(file) == 0) && written;
+}
+
+int8_t NvmManager::Byte(NvmLocations nvmLocation) {
+    int8_t value = -1;
+    BlockRead(nvmLocation, sizeof(value), reinterpret_cast<uint8_t *>(&value));
+    return value;
+}
+
+bool NvmManager::Byte(NvmLocations nvmLocation, int8_t newValue) {
+    if (Byte(nvmLocation) == newValue) {
+        return nvmLocation < NVM_LOC_USER_MAX;
+    }
+    return BlockWrite(nvmLocation, sizeof(newValue),
+                      reinterpret_cast<uint8_t *>(&newValue));
+}
+
+int16_t NvmManager::Int16(NvmLocations nvmLocation) {
+    int16_t value = -1;
+    BlockRead(nvmLocation, sizeof(value), reinterpret_cast<uint8_t *>(&value));
+    return value;
+}
+
+bool NvmManager::Int16(NvmLocations nvmLocation, int16_t newValue) {
+    if (Int16(nvmLocation) == newValue) {
+        return nvmLocation < NVM_LOC_USER_MAX - 1;
+    }
+    return BlockWrite(nvmLocation, sizeof(newValue),
+                      reinterpret_cast<uint8_t *>(&newValue));
+}
+
+int32_t NvmManager::Int32(NvmLocations nvmLocation) {
+    int32_t value = -1;
+    BlockRead(nvmLocation, sizeof(value), reinterpret_cast<uint8_t *>(&value));
+    return value;
+}
+
+bool NvmManager::Int32(NvmLocations nvmLocation, int32_t newValue) {
+    if (Int32(nvmLocation) == newValue) {
+        return nvmLocation < NVM_LOC_USER_MAX - 3;
+    }
+    return BlockWrite(nvmLocation, sizeof(newValue),
+                      reinterpret_cast<uint8_t *>(&newValue));
+}
+
+int64_t NvmManager::Int64(NvmLocations nvmLocationStart) {
+    int64_t value = -1;
+    BlockRead(nvmLocationStart, sizeof(value),
+              reinterpret_cast<uint8_t *>(&value));
+    return value;
+}
+
+bool NvmManager::Int64(NvmLocations nvmLocationStart, int64_t newValue) {
+    if (Int64(nvmLocationStart) == newValue) {
+        return nvmLocationStart < NVM_LOC_USER_MAX - 7;
+    }
+    return BlockWrite(nvmLocationStart, sizeof(newValue),
+                      reinterpret_cast<uint8_t *>(&newValue));
+}
+
+void NvmManager::BlockRead(NvmLocations nvmLocationStart, int lengthInBytes,
+                           uint8_t *const p_data) {
+    if (nvmLocationStart >= (NVM_LOC_USER_MAX - lengthInBytes + 1)) {
+        return;
+    }
+    memcpy(p_data, &m_nvmPageCache[nvmLocationStart], lengthInBytes);
+}
+
+bool NvmManager::BlockWrite(NvmLocations nvmLocationStart, int lengthInBytes,
+                            uint8_t const *const p_data) {
+    if (nvmLocationStart >= (NVM_LOC_USER_MAX - lengthInBytes + 1)) {
+        return false;
+    }
+    if (nvmLocationStart >= (NVM_LOC_RESERVED_TEKNIC - lengthInBytes + 1)) {
+        return false;
+    }
+    // Like the board, rewriting the stored data reports no write
+    if (!memcmp(&m_nvmPageCache[nvmLocationStart], p_data, lengthInBytes)) {
+        return false;
+    }
+    memcpy(&m_nvmPageCache[nvmLocationStart], p_data, lengthInBytes);
+    return Store();
+}
+
+bool NvmManager::DataFlashRead(uint32_t offset, uint32_t lengthInBytes,
+                               uint8_t *p_data) {
+    if (offset > DATA_FLASH_SIZE || lengthInBytes > DATA_FLASH_SIZE - offset) {
+        return false;
+    }
+    memcpy(p_data, &m_dataFlash[offset], lengthInBytes);
+    return true;
+}
+
+/**
+    Programming only clears bits, like the flash does.
+**/
+bool NvmManager::DataFlashWrite(uint32_t offset, uint32_t lengthInBytes,
+                                uint8_t const *p_data) {
+    if (offset > DATA_FLASH_SIZE || lengthInBytes > DATA_FLASH_SIZE - offset ||
+            offset % DATA_FLASH_QUAD_WORD_SIZE ||
+            lengthInBytes % DATA_FLASH_QUAD_WORD_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < lengthInBytes; i++) {
+        m_dataFlash[offset + i] &= p_data[i];
+    }
+    return StoreDataFlash(offset, lengthInBytes);
+}
+
+bool NvmManager::DataFlashErase(uint32_t offset) {
+    if (offset >= DATA_FLASH_SIZE || offset % DATA_FLASH_BLOCK_SIZE) {
+        return false;
+    }
+    memset(&m_dataFlash[offset], 0xFF, DATA_FLASH_BLOCK_SIZE);
+    return StoreDataFlash(offset, DATA_FLASH_BLOCK_SIZE);
+}
+
+/**
+    The MAC address from CLEARCORE_SIM_MAC, so that several simulations can
+    share a bridge.
+**/
+void NvmManager::MacAddress(uint8_t *macAddress) {
+    static const uint8_t defaultMac[6] = {0x02, 0x43, 0x43, 0x00, 0x00, 0x01};
+    unsigned int octets[6];
+    const char *mac = getenv("CLEARCORE_SIM_MAC");
+    if (mac && sscanf(mac, "%x:%x:%x:%x:%x:%x", &octets[0], &octets[1],
+                      &octets[2], &octets[3], &octets[4], &octets[5]) == 6) {
+        for (int i = 0; i < 6; i++) {
+            macAddress[i] = (uint8_t)octets[i];
+        }
+        return;
+    }
+    memcpy(macAddress, defaultMac, sizeof(defaultMac));
+}
+
+uint32_t NvmManager::SerialNumber() {
+    uint32_t serial = (uint32_t)Int32(NVM_LOC_SERIAL_NUMBER);
+    // An erased page has no serial number
+    return serial == UINT32_MAX ? 0 : serial;
+}
+
+} // ClearCore namespace
@@ -0,0 +1,98 @@
+/**
+    \file SimSdCard.cpp
+    \brief Micro SD card of the virtual ClearCore, kept in an image file.
+
+    Return values follow libClearCore/src/SdCardDriver.cpp: a write stream
+    is opened by WriteStart(), takes whole blocks by WriteData() and is
+    closed by WriteStop().
+**/
+
+#include "ClearCore.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ClearCore {
+
+SdCardDriver SdCard;
+
+SdCardDriver::SdCardDriver()
+    : m_fd(-1),
+      m_blockCount(0),
+      m_writeBlock(0),
+      m_writing(false) {}
+
+bool SdCardDriver::CardInit() {
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_blockCount = 0;
+    m_writing = false;
+    const char *path = getenv("CLEARCORE_SIM_SD");
+    if (!path || !*path) {
+        return false;
+    }
+    int fd = open(path, O_RDWR);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0 || status.st_size < BLOCK_SIZE) {
+        perror(path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    m_fd = fd;
+    m_blockCount = (uint32_t)(status.st_size / BLOCK_SIZE);
+    return true;
+}
+
+bool SdCardDriver::BlocksRead(uint32_t block, uint8_t *data,
+                              uint32_t count) {
+    if (m_fd < 0 || m_writing || block + count > m_blockCount) {
+        return false;
+    }
+    size_t length = (size_t)count * BLOCK_SIZE;
+    return pread(m_fd, data, length, (off_t)block * BLOCK_SIZE) ==
+           (ssize_t)length;
+}
+
+bool SdCardDriver::BlocksWrite(uint32_t block, const uint8_t *data,
+                               uint32_t count) {
+    return WriteStart(block, count) && WriteData(data, count) && WriteStop();
+}
+
+bool SdCardDriver::WriteStart(uint32_t block, uint32_t count) {
+    (void)count;
+    if (m_fd < 0 || m_writing || block >= m_blockCount) {
+        return false;
+    }
+    m_writeBlock = block;
+    m_writing = true;
+    return true;
+}
+
+bool SdCardDriver::WriteData(const uint8_t *data, uint32_t count) {
+    if (!m_writing || m_writeBlock + count > m_blockCount) {
+        return false;
+    }
+    size_t length = (size_t)count * BLOCK_SIZE;
+    if (pwrite(m_fd, data, length, (off_t)m_writeBlock * BLOCK_SIZE) !=
+            (ssize_t)length) {
+        return false;
+    }
+    m_writeBlock += count;
+    return true;
+}
+
+bool SdCardDriver::WriteStop() {
+    if (!m_writing) {
+        return false;
+    }
+    m_writing = false;
+    return fdatasync(m_fd) == 0;
+}
+
+} // ClearCore namespace
@@ -0,0 +1,75 @@
+/**
+    \file SimSerial.cpp
+    \brief COM-0 and COM-1 of the virtual ClearCore.
+
+    The ports take the TTL, RS-232 and CCIO modes. In a UART mode each port
+    is a loopback, so a serial gateway request is answered by its own echo.
+**/
+
+#include "ClearCore.h"
+
+namespace ClearCore {
+
+SerialDriver ConnectorCOM0(CLEARCORE_PIN_COM0);
+SerialDriver ConnectorCOM1(CLEARCORE_PIN_COM1);
+
+bool SerialDriver::Mode(Connector::ConnectorModes newMode) {
+    if (newMode != Connector::TTL && newMode != Connector::RS232 &&
+            newMode != Connector::CCIO) {
+        return false;
+    }
+    if (m_mode == Connector::CCIO && newMode != Connector::CCIO) {
+        CcioMgr.LinkClose();
+    }
+    m_mode = newMode;
+    if (m_portOpen && m_mode == Connector::CCIO) {
+        CcioMgr.CcioDiscover(this);
+    }
+    return true;
+}
+
+void SerialDriver::PortOpen() {
+    m_portOpen = true;
+    m_loopCount = 0;
+    if (m_mode == Connector::CCIO) {
+        CcioMgr.CcioDiscover(this);
+    }
+}
+
+void SerialDriver::PortClose() {
+    if (m_portOpen && m_mode == Connector::CCIO) {
+        CcioMgr.LinkClose();
+    }
+    m_portOpen = false;
+}
+
+int32_t SerialDriver::Read(uint8_t *buf, int32_t len) {
+    if (!m_portOpen || m_mode == Connector::CCIO || len <= 0) {
+        return 0;
+    }
+    int32_t count = len < m_loopCount ? len : m_loopCount;
+    for (int32_t i = 0; i < count; i++) {
+        buf[i] = m_loop[m_loopHead];
+        m_loopHead = (m_loopHead + 1) % LOOPBACK_SIZE;
+    }
+    m_loopCount -= count;
+    return count;
+}
+
+int32_t SerialDriver::Write(const uint8_t *buf, int32_t len) {
+    if (!m_portOpen || m_mode == Connector::CCIO || len <= 0) {
+        return 0;
+    }
+    // Characters that find the receive side full are lost, as on an overrun
+    int32_t count = len;
+    if (count > LOOPBACK_SIZE - m_loopCount) {
+        count = LOOPBACK_SIZE - m_loopCount;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        m_loop[(m_loopHead + m_loopCount) % LOOPBACK_SIZE] = buf[i];
+        m_loopCount++;
+    }
+    return len;
+}
+
+} // ClearCore namespace
@@ -0,0 +1,211 @@
+/**
+    \file netmemstress.cpp
+    \brief Drives the lwIP memory profile of lwipopts.h to its limits.
+
+    Built once per profile (CLEARCORE_LWIP_PROFILE) with the lwIP sources
+    and options of the host simulation, and run by ctest. Each stage
+    exhausts what a traffic spike uses up and checks that lwIP degrades
+    gracefully: the allocation that does not fit fails without an assertion,
+    the Network Memory statistics (clearcore_netmem.c) count it, and the
+    pool serves again as soon as an element is freed.
+
+    - a session spike, TCP PCBs until none is left,
+    - a receive storm, PBUF_POOL buffers of full frames,
+    - a reply storm, PBUF_RAM replies of PC_OPENER_ETHERNET_BUFFER_SIZE.
+
+    Prints the Markdown row of the profile for the table of the README. The
+    RAM column is lwIP's pools and heap on the host; the pointers of the
+    64 bit host make the PCBs larger than on the Cortex-M4.
+**/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lwip/init.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/memp_priv.h"
+#include "lwip/tcp.h"
+
+#include "InetChecksum.h"
+#include "opener_user_conf.h"
+#include "ports/ClearCore/clearcore_netmem.h"
+
+/** Replies of the explicit messaging */
+#define STRESS_REPLY_SIZE PC_OPENER_ETHERNET_BUFFER_SIZE
+#define STRESS_FRAME_SIZE 1514
+#define STRESS_MAX_ELEMENTS 1024
+
+static int stress_failures;
+
+#define STRESS_CHECK(condition)                                               \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__,           \
+                   #condition);                                               \
+            stress_failures++;                                                \
+        }                                                                     \
+    } while (0)
+
+/* Platform functions of the port; lwIP's timeouts do not run here */
+extern "C" {
+uint32_t Milliseconds(void) {
+    return 0;
+}
+
+unsigned long GetMillis(void) {
+    return 0;
+}
+
+u16_t clearcore_chksum(const void *dataptr, int len) {
+    return ClearCore::InetChecksum::Sum(dataptr, len);
+}
+
+u16_t clearcore_chksum_copy(void *dst, const void *src, u16_t len) {
+    return ClearCore::InetChecksum::Copy(dst, src, len);
+}
+}
+
+/** Network Memory pool of a memp pool */
+static unsigned int NetMemPool(memp_t type) {
+    return (unsigned int)type + 1;
+}
+
+static ClearCoreNetMemStats NetMemRead(unsigned int pool) {
+    ClearCoreNetMemStats stats;
+    STRESS_CHECK(0 == ClearCoreNetMemRead(pool, &stats));
+    return stats;
+}
+
+/** TCP PCBs until none is left, one per session that connects */
+static unsigned int SessionSpike() {
+    static struct tcp_pcb *pcbs[STRESS_MAX_ELEMENTS];
+    unsigned int count = 0;
+    while (count < STRESS_MAX_ELEMENTS &&
+            (pcbs[count] = tcp_new()) != NULL) {
+        count++;
+    }
+    STRESS_CHECK(MEMP_NUM_TCP_PCB == count);
+    STRESS_CHECK(count >= CLEARCORE_LWIP_TCP_CONNS);
+    /* the session after the last one is refused, not fatal */
+    STRESS_CHECK(NULL == tcp_new());
+    ClearCoreNetMemStats stats = NetMemRead(NetMemPool(MEMP_TCP_PCB));
+    STRESS_CHECK(count == stats.used);
+    STRESS_CHECK(count == stats.max);
+    STRESS_CHECK(stats.err >= 2);
+
+    /* a session that ends makes room for the next one */
+    STRESS_CHECK(ERR_OK == tcp_close(pcbs[--count]));
+    pcbs[count] = tcp_new();
+    STRESS_CHECK(NULL != pcbs[count]);
+    count++;
+
+    for (unsigned int i = 0; i < count; i++) {
+        tcp_abort(pcbs[i]);
+    }
+    STRESS_CHECK(0 == NetMemRead(NetMemPool(MEMP_TCP_PCB)).used);
+    return count;
+}
+
+/** Full frames from the pool until none is left, as the GMAC driver and the
+    receive screening take them */
+static unsigned int ReceiveStorm() {
+    static struct pbuf *frames[STRESS_MAX_ELEMENTS];
+    unsigned int count = 0;
+    while (count < STRESS_MAX_ELEMENTS &&
+            (frames[count] = pbuf_alloc(PBUF_RAW, STRESS_FRAME_SIZE,
+                                        PBUF_POOL)) != NULL) {
+        count++;
+    }
+    STRESS_CHECK(PBUF_POOL_SIZE == count);
+    STRESS_CHECK(count > CLEARCORE_LWIP_RX_QUEUED);
+    STRESS_CHECK(NULL == pbuf_alloc(PBUF_RAW, STRESS_FRAME_SIZE, PBUF_POOL));
+    STRESS_CHECK(NetMemRead(NetMemPool(MEMP_PBUF_POOL)).err >= 1);
+
+    /* replies come from the heap, a receive storm does not block them */
+    struct pbuf *reply = pbuf_alloc(PBUF_TRANSPORT, STRESS_REPLY_SIZE,
+                                    PBUF_RAM);
+    STRESS_CHECK(NULL != reply);
+    if (reply != NULL) {
+        pbuf_free(reply);
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        pbuf_free(frames[i]);
+    }
+    STRESS_CHECK(0 == NetMemRead(NetMemPool(MEMP_PBUF_POOL)).used);
+    return count;
+}
+
+/** Replies from the heap until it is full, as when the TCP data of every
+    session waits for its acknowledgment */
+static unsigned int ReplyStorm() {
+    static struct pbuf *replies[STRESS_MAX_ELEMENTS];
+    unsigned int count = 0;
+    while (count < STRESS_MAX_ELEMENTS &&
+            (replies[count] = pbuf_alloc(PBUF_TRANSPORT, STRESS_REPLY_SIZE,
+                                         PBUF_RAM)) != NULL) {
+        count++;
+    }
+    STRESS_CHECK(count < STRESS_MAX_ELEMENTS);
+    /* a reply in flight for every TCP connection of the profile */
+    STRESS_CHECK(count >= CLEARCORE_LWIP_TCP_CONNS);
+    ClearCoreNetMemStats heap = NetMemRead(0);
+    STRESS_CHECK(heap.err >= 1);
+    STRESS_CHECK(heap.used <= heap.avail);
+
+    /* the next reply fits as soon as one is sent */
+    if (count > 0) {
+        pbuf_free(replies[--count]);
+        replies[count] = pbuf_alloc(PBUF_TRANSPORT, STRESS_REPLY_SIZE,
+                                    PBUF_RAM);
+        STRESS_CHECK(NULL != replies[count]);
+        count++;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        pbuf_free(replies[i]);
+    }
+    return count;
+}
+
+static void ResetClearsErrors() {
+    ClearCoreNetMemReset();
+    for (unsigned int pool = 0; pool < ClearCoreNetMemPoolCount(); pool++) {
+        ClearCoreNetMemStats stats = NetMemRead(pool);
+        STRESS_CHECK(0 == stats.err);
+        STRESS_CHECK(stats.used == stats.max);
+    }
+    STRESS_CHECK(-1 == ClearCoreNetMemRead(ClearCoreNetMemPoolCount(), NULL));
+}
+
+static uint32_t LwipRam() {
+    uint32_t ram = MEM_SIZE;
+    for (unsigned int i = 0; i < MEMP_MAX; i++) {
+        ram += (uint32_t)memp_pools[i]->size * memp_pools[i]->num;
+    }
+    return ram;
+}
+
+int main() {
+    static const char *const profiles[] = { "balanced", "I/O-heavy",
+                                            "explicit-heavy" };
+    lwip_init();
+
+    unsigned int sessions = SessionSpike();
+    unsigned int frames = ReceiveStorm();
+    unsigned int replies = ReplyStorm();
+    ResetClearsErrors();
+
+    printf("| %s | %u | %u | %u | %u | %u | %u |\n",
+           profiles[CLEARCORE_LWIP_PROFILE], sessions, frames, replies,
+           (unsigned int)MEM_SIZE, (unsigned int)ARP_TABLE_SIZE,
+           (unsigned int)LwipRam());
+    if (stress_failures > 0) {
+        printf("%d checks failed\n", stress_failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
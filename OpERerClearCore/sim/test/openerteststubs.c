@@ -0,0 +1,86 @@
+/**
+    \file openerteststubs.c
+    \brief Network handler and lwIP glue of the OpENer unit tests.
+
+    The unit tests link the CIP stack, the vendor objects and the portable
+    port modules, but neither lwIP nor the ClearCore network handler. The
+    encapsulation and connection code calls into both; these stand-ins
+    accept every socket operation and leave the ARP table alone, so that
+    the tests see the protocol behavior only. The application callbacks
+    are the mocks of callback_mock.cpp.
+**/
+
+#include "generic_networkhandler.h"
+#include "clearcore_arppin.h"
+#include "nvdata.h"
+
+NetworkStatus g_network_status;
+SocketTimer g_timestamps[OPENER_NUMBER_OF_SUPPORTED_SESSIONS];
+MilliSeconds g_actual_time;
+
+int CreateUdpSocket(void) {
+  return 1;
+}
+
+void CloseUdpSocket(int socket_handle) {
+  (void) socket_handle;
+}
+
+void CloseTcpSocket(int socket_handle) {
+  (void) socket_handle;
+}
+
+int getpeername(int socket_handle,
+                struct sockaddr *name,
+                socklen_t *name_length) {
+  (void) socket_handle;
+  (void) name;
+  (void) name_length;
+  return -1;
+}
+
+int SetQos(CipUsint qos_for_socket) {
+  (void) qos_for_socket;
+  return 0;
+}
+
+int SetSocketOptionsMulticastProduce(void) {
+  return 0;
+}
+
+EipUint32 GetPeerAddress(void) {
+  return 0;
+}
+
+EipStatus SendUdpData(const struct sockaddr_in *const address,
+                      const ENIPMessage *const outgoing_message) {
+  (void) address;
+  (void) outgoing_message;
+  return kEipStatusOk;
+}
+
+EipStatus SendUdpDataOnSocket(const int socket_handle,
+                              const struct sockaddr_in *const address,
+                              const ENIPMessage *const outgoing_message) {
+  (void) socket_handle;
+  (void) address;
+  (void) outgoing_message;
+  return kEipStatusError;
+}
+
+void ClearCoreArpPin(uint32_t address) {
+  (void) address;
+}
+
+void ClearCoreArpUnpin(uint32_t address) {
+  (void) address;
+}
+
+EipStatus NvTcpipSetCallback(CipInstance *const instance,
+                             CipAttributeStruct *const attribute,
+                             CipByte service) {
+  (void) instance;
+  (void) attribute;
+  (void) service;
+  return kEipStatusOk;
+}
@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""Decode the binary OpENer trace records of a ClearCore.
+
+The firmware records the address of the format string and the raw arguments
+of every trace (see OpENer/source/src/ports/tracering.h). This tool looks the
+format strings up in the ELF file of the same build and prints the traces.
+
+    tracedecode.py OpENer.elf capture.bin       # file or serial device
+    tracedecode.py OpENer.elf --udp 5140        # UDP sink
+
+Text the firmware prints on the USB port between the records is passed
+through unchanged.
+"""
+
+import argparse
+import re
+import socket
+import struct
+import sys
+
+MAGIC = 0x5452
+HEADER_WORDS = 3
+MAX_ARG_WORDS = 32
+MAX_STRING_LENGTH = 48
+FLAG_TRUNCATED = 0x01
+
+CONVERSION = re.compile(
+    r'%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?'
+    r'(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcpfFeEgGaAsn%])')
+
+
+class Elf:
+    """Reads strings from the loaded sections of an ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x3A)
+            layout = endian + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x2E)
+            layout = endian + 'IIIIII'
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(
+                layout, self.data, shoff + i * shentsize)
+            # Loaded sections with contents in the file (SHF_ALLOC, not NOBITS)
+            if flags & 0x2 and sh_type != 8 and addr:
+                self.sections.append((addr, size, offset))
+
+    def string(self, address):
+        for addr, size, offset in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b'\0', start, offset + size)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode('latin-1')
+        return None
+
+
+def signed(value, bits):
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def render(fmt, args):
+    """printf() the format with the recorded argument words."""
+    words = list(args)
+
+    def take():
+        return words.pop(0) if words else None
+
+    def take64():
+        low, high = take(), take()
+        if low is None or high is None:
+            return None
+        return low | (high << 32)
+
+    def substitute(match):
+        conv = match.group('conv')
+        if conv == '%':
+            return '%'
+        spec = '%' + match.group('flags')
+        width = match.group('width')
+        if width == '*':
+            value = take()
+            width = str(signed(value, 32)) if value is not None else ''
+        spec += width or ''
+        precision = match.group('precision')
+        if precision is not None:
+            if precision == '*':
+                value = take()
+                precision = str(signed(value, 32)) if value is not None else ''
+            spec += '.' + precision
+        length = match.group('length')
+        wide = length in ('ll', 'j')
+        if conv == 'n':
+            return ''
+        if conv in 'di':
+            value = take64() if wide else take()
+            if value is None:
+                return '<?>'
+            return (spec + 'd') % signed(value, 64 if wide else 32)
+        if conv in 'ouxX':
+            value = take64() if wide else take()
+            if value is None:
+                return '<?>'
+            return (spec + ('d' if conv == 'u' else conv)) % value
+        if conv == 'c':
+            value = take()
+            return '<?>' if value is None else (spec + 'c') % chr(value & 0xFF)
+        if conv == 'p':
+            value = take()
+            return '<?>' if value is None else '0x%x' % value
+        if conv in 'fFeEgGaA':
+            value = take64()
+            if value is None:
+                return '<?>'
+            number, = struct.unpack('<d', struct.pack('<Q', value))
+            if conv in 'aA':
+                text = number.hex()
+                return text.upper() if conv == 'A' else text
+            return (spec + conv.replace('F', 'f')) % number
+        if conv == 's':
+            length_word = take()
+            if length_word is None or length_word > MAX_STRING_LENGTH or \
+                    (length_word + 3) // 4 > len(words):
+                return '<?>'
+            count = (length_word + 3) // 4
+            raw = b''.join(struct.pack('<I', take()) for _ in range(count))
+            return (spec + 's') % raw[:length_word].decode('latin-1')
+        return match.group(0)
+
+    return CONVERSION.sub(substitute, fmt)
+
+
+class Decoder:
+    def __init__(self, elf, out):
+        self.elf = elf
+        self.out = out
+
+    def record(self, words):
+        header, timestamp, address = words[:HEADER_WORDS]
+        args = words[HEADER_WORDS:]
+        if address == 0:
+            text = '*** %u trace records dropped ***\n' % (args[0] if args else 0)
+        else:
+            fmt = self.elf.string(address)
+            if fmt is None:
+                text = '<unknown format 0x%08x>\n' % address
+            else:
+                text = render(fmt, args)
+                if (header >> 8) & FLAG_TRUNCATED:
+                    text = text.rstrip('\n') + ' <truncated>\n'
+        if not text.endswith('\n'):
+            text += '\n'
+        self.out.write('[%10.6f] %s' % (timestamp / 1e6, text))
+
+    def stream(self, data):
+        """Decode records found in data, pass the other bytes through.
+
+        Returns the number of bytes consumed; an incomplete record at the
+        end is left for the next call.
+        """
+        pos = 0
+        text_start = 0
+        while pos + 4 <= len(data):
+            header, = struct.unpack_from('<I', data, pos)
+            length = header & 0xFF
+            if (header >> 16) == MAGIC and \
+                    HEADER_WORDS <= length <= HEADER_WORDS + MAX_ARG_WORDS:
+                if pos + 4 * length > len(data):
+                    break
+                words = struct.unpack_from('<%dI' % length, data, pos)
+                if words[2] == 0 or self.elf.string(words[2]) is not None:
+                    self.out.write(data[text_start:pos].decode('latin-1'))
+                    self.record(words)
+                    pos += 4 * length
+                    text_start = pos
+                    continue
+            pos += 1
+        if pos + 4 > len(data) and text_start < pos:
+            self.out.write(data[text_start:pos].decode('latin-1'))
+            text_start = pos
+        self.out.flush()
+        return text_start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('elf', help='ELF file of the running firmware')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='capture file or serial device, - for stdin')
+    parser.add_argument('--udp', type=int, metavar='PORT',
+                        help='receive the records of the UDP sink')
+    options = parser.parse_args()
+
+    decoder = Decoder(Elf(options.elf), sys.stdout)
+    if options.udp:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(('', options.udp))
+        while True:
+            decoder.stream(sock.recv(2048))
+    source = sys.stdin.buffer if options.input == '-' else \
+        open(options.input, 'rb', buffering=0)
+    pending = b''
+    while True:
+        chunk = source.read(4096)
+        if not chunk:
+            break
+        pending += chunk
+        pending = pending[decoder.stream(pending):]
+    if pending:
+        sys.stdout.write(pending.decode('latin-1'))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Decode a ClearCore waveform capture read back from the SD card.
+
+The firmware writes the capture as raw blocks, a header block followed by
+the data blocks (see OpENer/source/src/ports/wavecapture.h). This tool reads
+them from a card image or the card device and prints the records as CSV.
+
+    wavedecode.py /dev/sdX                      # capture at block 0
+    wavedecode.py card.img --block 2048 -o run.csv
+
+A capture that did not end, e.g. because the card was pulled, is read up to
+the last data block written for it.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+BLOCK_SIZE = 512
+HEADER_MAGIC = 0x56574343
+BLOCK_MAGIC = 0x5657
+VERSION = 1
+FLAG_COMPLETE = 0x01
+HEADER = struct.Struct('<IHHHHIIHBBIIII')
+BLOCK_HEADER = struct.Struct('<HHIIHH')
+CHANNELS = 4
+SIGNAL_POSITION = 0x0001
+SIGNAL_HLFB = 0x0010
+SIGNAL_ANALOG = 0x0100
+SIGNAL_INPUTS = 0x1000
+HLFB_UNKNOWN = -32768
+TRIGGERS = ('immediate', 'rising', 'falling', 'change')
+
+
+def columns(signals):
+    """Names and struct codes of the record fields, in record order."""
+    fields = []
+    for channel in range(CHANNELS):
+        if signals & (SIGNAL_POSITION << channel):
+            fields.append(('M%d_position' % channel, 'i'))
+    for channel in range(CHANNELS):
+        if signals & (SIGNAL_HLFB << channel):
+            fields.append(('M%d_hlfb_percent' % channel, 'h'))
+    for channel in range(CHANNELS):
+        if signals & (SIGNAL_ANALOG << channel):
+            fields.append(('A%d_volts' % (9 + channel), 'H'))
+    if signals & SIGNAL_INPUTS:
+        fields.append(('inputs', 'I'))
+    return fields
+
+
+def scale(name, value):
+    if name.endswith('_hlfb_percent'):
+        return '' if value == HLFB_UNKNOWN else '%.2f' % (value / 100.0)
+    if name.endswith('_volts'):
+        return '%.4f' % (value * 10.0 / 32768)
+    if name == 'inputs':
+        return '0x%05X' % value
+    return value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('image', help='SD card image or device')
+    parser.add_argument('--block', type=int, default=0,
+                        help='header block of the capture (attribute #7)')
+    parser.add_argument('-o', '--output', default='-',
+                        help='CSV file, - for stdout')
+    options = parser.parse_args()
+
+    card = open(options.image, 'rb')
+    card.seek(options.block * BLOCK_SIZE)
+    (magic, version, capture_id, flags, record_size, signals, period_us,
+     decimation, trigger, trigger_input, trigger_us, samples, lost,
+     data_blocks) = HEADER.unpack_from(card.read(BLOCK_SIZE))
+    if magic != HEADER_MAGIC or version != VERSION:
+        sys.exit('no capture at block %d' % options.block)
+    fields = columns(signals)
+    record = struct.Struct('<' + ''.join(code for _, code in fields))
+    if record.size != record_size:
+        sys.exit('record size %d does not match the signals 0x%04X' %
+                 (record_size, signals))
+    complete = bool(flags & FLAG_COMPLETE)
+    sys.stderr.write(
+        'capture %d: %s, trigger %s on input %d, every %d x %d us\n' %
+        (capture_id, 'complete' if complete else 'not ended',
+         TRIGGERS[trigger] if trigger < len(TRIGGERS) else trigger,
+         trigger_input, decimation, period_us))
+
+    out = sys.stdout if options.output == '-' else \
+        open(options.output, 'w', newline='')
+    writer = csv.writer(out)
+    writer.writerow(['time_us'] + [name for name, _ in fields])
+    tick_us = decimation * period_us
+    records = 0
+    gaps = 0
+    next_tick = 0
+    sequence = 0
+    while not complete or sequence < data_blocks:
+        block = card.read(BLOCK_SIZE)
+        if len(block) < BLOCK_SIZE:
+            break
+        block_magic, count, block_sequence, first_tick, block_capture, _ = \
+            BLOCK_HEADER.unpack_from(block)
+        if (block_magic != BLOCK_MAGIC or block_capture != capture_id or
+                block_sequence != sequence):
+            break
+        if first_tick != next_tick:
+            gaps += first_tick - next_tick
+        for i in range(count):
+            values = record.unpack_from(
+                block, BLOCK_HEADER.size + i * record_size)
+            time_us = (trigger_us + (first_tick + i) * tick_us) & 0xFFFFFFFF
+            writer.writerow([time_us] + [scale(name, value) for
+                                         (name, _), value in
+                                         zip(fields, values)])
+        records += count
+        next_tick = first_tick + count
+        sequence += 1
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write('%d records in %d blocks, %d lost\n' %
+                     (records, sequence, lost if complete else gaps))
+    if complete and records != samples:
+        sys.exit('expected %d records' % samples)
+
+
+if __name__ == '__main__':
+    main()
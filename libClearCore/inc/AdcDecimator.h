@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __ADCDECIMATOR_H__
+#define __ADCDECIMATOR_H__
+
+#include <stdint.h>
+#include "IirFilter.h"
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  AdcDecimator class
+//
+// DESCRIPTION
+///     \brief Block decimation and filtering of one ADC channel.
+///
+///     Processes a block of raw conversion results, one per sample time,
+///     taken from an interleaved DMA buffer. Every result is normalized to
+///     Q15, fed to the channel's Iir16 and summed into a boxcar average
+///     that produces one decimated output every Decimation() results.
+///     The accumulator carries over between blocks, so the decimation does
+///     not need to divide the block length.
+///
+///     AdcManager keeps one per channel and hands it the results of all
+///     sample times since the last pass. Pending() dates the decimated
+///     output, AdcManager subtracts it from the timestamp of the last
+///     result to get the decimated timestamp.
+//
+class AdcDecimator {
+public:
+    /**
+        Longest boxcar, in results. Keeps the sum of Q15 values in 32 bits.
+    **/
+    static const uint16_t DECIMATION_MAX = 1024;
+
+    AdcDecimator(void)
+        : m_decimation(1), m_count(0), m_sum(0), m_last(0), m_decimated(0),
+          m_outputs(0) {};
+
+    /**
+        \brief Normalize a conversion result with \a bits significant bits
+        to Q15.
+    **/
+    static uint16_t Q15(uint16_t raw, uint8_t bits) {
+        return (bits > 15) ? (raw >> (bits - 15)) : (raw << (15 - bits));
+    }
+
+    /**
+        \brief Set the number of results averaged into one decimated output.
+
+        Restarts the current average.
+
+        \return false if \a results is 0 or above DECIMATION_MAX
+    **/
+    bool Decimation(uint16_t results) {
+        if (results == 0 || results > DECIMATION_MAX) {
+            return false;
+        }
+        m_decimation = results;
+        m_count = 0;
+        m_sum = 0;
+        return true;
+    }
+
+    uint16_t Decimation() {
+        return m_decimation;
+    }
+
+    /**
+        \brief Process a block of results.
+
+        \param[in] raw First result of this channel in the block
+        \param[in] stride Distance between the results of this channel, the
+        channel count of an interleaved buffer
+        \param[in] count Number of results in the block
+        \param[in] bits Significant bits of the results
+        \param[in,out] filter The channel's filter, updated with every result
+
+        \return Number of decimated outputs completed in this block
+    **/
+    uint16_t Process(const volatile uint16_t *raw, uint16_t stride,
+                     uint16_t count, uint8_t bits, Iir16 &filter) {
+        uint16_t outputs = 0;
+        uint16_t value = m_last;
+        uint32_t sum = m_sum;
+        uint16_t samples = m_count;
+
+        for (uint16_t i = 0; i < count; i++, raw += stride) {
+            value = Q15(*raw, bits);
+            filter.Update(value);
+            sum += value;
+            if (++samples == m_decimation) {
+                m_decimated = (sum + (m_decimation >> 1)) / m_decimation;
+                sum = 0;
+                samples = 0;
+                outputs++;
+            }
+        }
+
+        m_last = value;
+        m_sum = sum;
+        m_count = samples;
+        m_outputs += outputs;
+        return outputs;
+    }
+
+    /**
+        \brief Restart the average and set all outputs to \a value.
+    **/
+    void Reset(uint16_t value) {
+        m_count = 0;
+        m_sum = 0;
+        m_last = value;
+        m_decimated = value;
+    }
+
+    /**
+        \return The last normalized result
+    **/
+    uint16_t LastResult() {
+        return m_last;
+    }
+
+    /**
+        \return The last decimated output
+    **/
+    uint16_t Decimated() {
+        return m_decimated;
+    }
+
+    /**
+        \return Results summed since the last decimated output. After a
+        block that completed an output, this is the age of the output in
+        results.
+    **/
+    uint16_t Pending() {
+        return m_count;
+    }
+
+    /**
+        \return Decimated outputs since construction, wraps around
+    **/
+    uint32_t Outputs() {
+        return m_outputs;
+    }
+
+private:
+    uint16_t m_decimation; // Results per decimated output
+    uint16_t m_count;      // Results summed into m_sum
+    uint32_t m_sum;        // Sum of the Q15 results
+    uint16_t m_last;       // Last normalized result
+    uint16_t m_decimated;  // Last decimated output
+    uint32_t m_outputs;    // Count of decimated outputs
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __ADCDECIMATOR_H__
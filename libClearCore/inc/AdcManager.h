@@ -31,6 +31,7 @@
 #define __ADCMANAGER_H__
 
 #include <stdint.h>
+#include "AdcDecimator.h"
 #include "IirFilter.h"
 
 namespace ClearCore {
@@ -43,6 +44,10 @@ namespace ClearCore {
     Utilizes DMA sequence to configure channels, trigger conversion, and
     read results.
 
+    In the block acquisition mode the results stream into two DMA buffers
+    in turn. A full buffer is decimated and filtered by a low priority
+    interrupt, so the sample rate interrupt only restarts the sequence.
+
     Uses DMAC Channels: 0,1
 **/
 class AdcManager {
@@ -81,6 +86,19 @@ public:
         FILTER_UNIT_SAMPLES,
     } FilterUnits;
 
+    /**
+        \enum AcquisitionModes
+        \brief How the conversion results are collected and filtered.
+    **/
+    typedef enum {
+        /** The sample rate interrupt copies and filters the results of
+            every sample time. **/
+        ACQ_MODE_SAMPLE,
+        /** The results of #ADC_BLOCK_SAMPLES sample times are collected by
+            DMA and filtered together in a low priority interrupt. **/
+        ACQ_MODE_BLOCK,
+    } AcquisitionModes;
+
     /**
         The default resolution of the ADC, in bits.
     **/
@@ -93,6 +111,20 @@ public:
         The default ADC filter time constant, in milliseconds.
     **/
     static const uint32_t ADC_IIR_FILTER_TC_MS = 2;
+    /**
+        Sample times collected in one DMA buffer in the block acquisition
+        mode, 1 ms.
+    **/
+    static const uint8_t ADC_BLOCK_SAMPLES = 5;
+    /**
+        Highest hardware oversampling, as a power of two (16 conversions).
+    **/
+    static const uint8_t ADC_OVERSAMPLING_MAX = 4;
+    /**
+        Conversions of all channels that fit into one sample time, leaving
+        headroom for the sample length and the DMA.
+    **/
+    static const uint8_t ADC_CONVERSIONS_PER_SAMPLE_MAX = 32;
 
 #ifndef HIDE_FROM_DOXYGEN
     // Max voltage that a channel can read.
@@ -129,6 +161,13 @@ public:
         \note: Should be called at the ClearCore sample rate.
     **/
     void Update();
+
+    /**
+        \brief Filter and decimate the newest full DMA buffer.
+
+        \note Called from the DMA completion interrupt in #ACQ_MODE_BLOCK.
+    **/
+    void BlockUpdate();
 #endif
 
     /**
@@ -263,6 +302,141 @@ public:
         return true;
     }
 
+    /**
+        \brief Select how the conversion results are collected.
+
+        In #ACQ_MODE_BLOCK the results of #ADC_BLOCK_SAMPLES sample times
+        are collected by DMA and then filtered and decimated in one pass by
+        a low priority interrupt. The filtered results lag up to one block
+        behind the conversions, in exchange the sample rate interrupt no
+        longer handles the results.
+
+        \code{.cpp}
+        // Collect the results in blocks
+        AdcMgr.AcquisitionMode(AdcManager::ACQ_MODE_BLOCK);
+        \endcode
+
+        \param[in] mode The new acquisition mode.
+        \return Success.
+
+        \note Waits for the sample rate interrupt to apply the change.
+    **/
+    bool AcquisitionMode(AcquisitionModes mode);
+
+    /**
+        \brief Returns the acquisition mode.
+    **/
+    AcquisitionModes AcquisitionMode() {
+        return m_acqMode;
+    }
+
+    /**
+        \brief Configure the hardware oversampling of an ADC channel.
+
+        The ADC averages 2^\a samplesLog2 conversions into each result of
+        the channel. Oversampled channels always convert at 12 bits and
+        gain up to 4 bits of resolution, which is kept in the Q15 results.
+        The conversions of all channels must fit into one sample time, see
+        #ADC_CONVERSIONS_PER_SAMPLE_MAX.
+
+        \code{.cpp}
+        // Average 16 conversions into each result of A-10
+        AdcMgr.Oversampling(AdcManager::ADC_AIN10, 4);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure.
+        \param[in] samplesLog2 Oversampling as a power of two, 0 (off) to
+        #ADC_OVERSAMPLING_MAX.
+        \return Success, false if the conversions do not fit.
+
+        \note Waits for the sample rate interrupt to apply the change.
+    **/
+    bool Oversampling(AdcChannels adcChannel, uint8_t samplesLog2);
+
+    /**
+        \brief Returns the hardware oversampling of an ADC channel, as a power
+        of two.
+    **/
+    uint8_t Oversampling(AdcChannels adcChannel) {
+        if (adcChannel >= ADC_CHANNEL_COUNT) {
+            return 0;
+        }
+        return m_oversampling[adcChannel];
+    }
+
+    /**
+        \brief Configure the decimation of an ADC channel.
+
+        Each decimated result is the average of \a samples consecutive
+        results of the channel.
+
+        \code{.cpp}
+        // Average A-10 over 2 ms
+        AdcMgr.Decimation(AdcManager::ADC_AIN10, 10);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure.
+        \param[in] samples Results per decimated result, 1 to
+        AdcDecimator::DECIMATION_MAX.
+        \return Success.
+
+        \note Applied with the next results of the channel.
+    **/
+    bool Decimation(AdcChannels adcChannel, uint16_t samples);
+
+    /**
+        \brief Returns the decimation of an ADC channel, in results.
+    **/
+    uint16_t Decimation(AdcChannels adcChannel) {
+        if (adcChannel >= ADC_CHANNEL_COUNT) {
+            return 0;
+        }
+        return m_decimationPending[adcChannel];
+    }
+
+    /**
+        \brief Returns the last decimated result of a specific channel.
+
+        \param[in] adcChannel ADC channel to get the decimated result of.
+        \return Decimated result, in Q15 like ConvertedResult().
+
+        \note For performance reasons, does not perform any bounds checking.
+    **/
+    volatile const uint16_t &DecimatedResult(AdcChannels adcChannel) {
+        return m_AdcResultsDecimated[adcChannel];
+    }
+
+    /**
+        \brief Returns when the last decimated result of a channel was
+        converted.
+
+        \return Microseconds() at the start of the sequence of the newest
+        result in the average.
+
+        \note For performance reasons, does not perform any bounds checking.
+    **/
+    volatile const uint32_t &DecimatedTimestamp(AdcChannels adcChannel) {
+        return m_decimatedTimestamp[adcChannel];
+    }
+
+    /**
+        \brief Returns when the newest converted and filtered results were
+        converted.
+
+        \return Microseconds() at the start of their sequence.
+    **/
+    volatile const uint32_t &ResultTimestamp() {
+        return m_resultTimestamp;
+    }
+
+    /**
+        \brief Returns the number of blocks that were overwritten before they
+        were filtered in #ACQ_MODE_BLOCK.
+    **/
+    volatile const uint32_t &BlockOverruns() {
+        return m_blockOverruns;
+    }
+
     /**
         \brief Configure the ADC conversion timeout.
 
@@ -310,7 +484,8 @@ public:
         \note For performance reasons, does not perform any bounds checking.
     **/
     float AnalogVoltage(AdcChannels adcChannel) {
-        uint16_t maxReading = INT16_MAX & ~(INT16_MAX >> m_AdcResolution);
+        uint16_t maxReading =
+            INT16_MAX & ~(INT16_MAX >> m_resultBits[adcChannel]);
         float voltage = ADC_CHANNEL_MAX_FLOAT[adcChannel] *
                         m_AdcResultsConvertedFiltered[adcChannel] / maxReading;
         return voltage;
@@ -353,7 +528,32 @@ private:
     // ADC state holders in Q15. ADC logic has already been performed
     volatile uint16_t m_AdcResultsConverted[ADC_CHANNEL_COUNT] = {0};
     volatile uint16_t m_AdcResultsConvertedFiltered[ADC_CHANNEL_COUNT] = {0};
+    volatile uint16_t m_AdcResultsDecimated[ADC_CHANNEL_COUNT] = {0};
+    volatile uint32_t m_decimatedTimestamp[ADC_CHANNEL_COUNT] = {0};
     Iir16 m_analogFilter[ADC_CHANNEL_COUNT];
+    AdcDecimator m_decimator[ADC_CHANNEL_COUNT];
+    volatile uint16_t m_decimationPending[ADC_CHANNEL_COUNT];
+
+    // Significant bits of the raw results of each channel
+    uint8_t m_resultBits[ADC_CHANNEL_COUNT];
+    uint8_t m_oversampling[ADC_CHANNEL_COUNT];
+    uint8_t m_oversamplingPending[ADC_CHANNEL_COUNT];
+    volatile bool m_sequencePending;
+
+    AcquisitionModes m_acqMode;
+    volatile AcquisitionModes m_acqModePending;
+
+    // Start of the sequence the current results belong to
+    uint32_t m_sequenceTimestamp;
+    volatile uint32_t m_resultTimestamp;
+
+    // Block acquisition: sequences started in the current block, blocks
+    // whose last sequence was started and the start of that sequence
+    uint8_t m_blockSample;
+    volatile uint32_t m_blocksStarted;
+    uint32_t m_blocksFiltered;
+    volatile uint32_t m_blockTimestamp[2];
+    volatile uint32_t m_blockOverruns;
 
     bool m_initialized;
 
@@ -382,8 +582,25 @@ private:
     AdcManager();
 
     void DmaInit();
+    void DmaResultsInit();
     void DmaUpdate();
 
+    /**
+        \brief Rebuild the DMA sequence from the resolution and the
+        oversampling of the channels.
+    **/
+    void SequenceBuild();
+
+    /**
+        \brief Filter and decimate the results of one sequence or block.
+
+        \param[in] raw First result of the block, channels interleaved
+        \param[in] samples Sample times in the block
+        \param[in] lastTimestamp Start of the last sequence of the block
+    **/
+    void ResultsProcess(const volatile uint16_t *raw, uint8_t samples,
+                        uint32_t lastTimestamp);
+
     /**
         \brief Apply the ADC conversion resolution change.
 
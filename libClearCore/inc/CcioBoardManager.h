@@ -35,6 +35,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "CcioLink.h"
 #include "CcioPin.h"
 #include "SerialDriver.h"
 #include "SysConnectors.h"
@@ -364,6 +365,31 @@ public:
         return m_lastOutputs;
     }
 
+    /**
+        \brief Write the digital state of several CCIO-8 pins at once.
+
+        \code{.cpp}
+        // Set the outputs of the second CCIO-8 board, leave the others alone
+        CcioMgr.OutputsWrite(0x5A00, 0xFF00);
+        \endcode
+
+        \param[in] state The new states, one bit per pin as in OutputState().
+        \param[in] mask (optional) The pins to write.
+    **/
+    void OutputsWrite(uint64_t state, uint64_t mask = UINT64_MAX);
+
+    /**
+        \brief Accessor for the number of CCIO-8 refreshes skipped because
+        the previous transfer had not ended.
+
+        A skipped refresh is retried at the next sample time.
+
+        \return Skipped refreshes since startup.
+    **/
+    volatile const uint32_t &RefreshOverruns() {
+        return m_refreshOverruns;
+    }
+
     /**
         \brief Enable or Disable the automatic rediscover function
 
@@ -407,33 +433,22 @@ public:
     }
 
 private:
-    union CcioBuf {
-        struct __attribute__((packed)) {
-            uint8_t writeMarker;
-            uint64_t inputs;
-            uint64_t outputsSwapped;
-            uint8_t readMarker;
-        } buf64;
-        uint8_t buf8[2 * MAX_CCIO_DEVICES + 2];
-        CcioBuf() {
-            Clear();
-        }
-        void Clear() {
-            buf64.writeMarker = 0;
-            buf64.inputs = 0;
-            buf64.outputsSwapped = 0;
-            buf64.readMarker = 0;
-        };
-    };
-
     typedef enum {
         CCIO_SEARCH,
         CCIO_TEST,
         CCIO_FOUND
     } CcioDiscoverState;
 
-    CcioBuf m_writeBuf;
-    CcioBuf m_readBuf;
+    // Double buffered refresh frames
+    CcioLink m_link;
+    // Discovery of the chain length
+    CcioProbe m_probe;
+    uint8_t m_probeTx[CcioLink::FRAME_MAX];
+    uint8_t m_probeRx[CcioLink::FRAME_MAX];
+    // A rediscover is running in RefreshSlow, one transfer per call
+    volatile bool m_probeActive;
+    // CcioDiscover is running in the foreground
+    volatile bool m_discoverBusy;
 
     // Reference for the discovery state of the CCIO-8 link network
     CcioDiscoverState m_discoverState;
@@ -455,11 +470,16 @@ private:
     uint64_t m_filteredInputs;
     uint64_t m_currentOutputs;
     uint64_t m_outputMask;
-    uint64_t m_lastOutputsSwapped;
     // copy of last outputs sent, prior to any swapping or throttling
     uint64_t m_lastOutputs;
     uint64_t m_outputsWithThrottling;
     uint64_t m_ccioMask;    // mask for active CCIOs
+    // Pins whose overload trip delay may have started counting down
+    uint64_t m_tripPending;
+    // Pins whose input filter is counting down
+    uint64_t m_filterPending;
+    // Refreshes skipped because the previous transfer had not ended
+    uint32_t m_refreshOverruns;
 
     // Pulse out control variables
     uint64_t m_pulseActive;
@@ -504,28 +524,20 @@ private:
     **/
     void IoOverloadRT(uint64_t overloadState);
 
-    /*
-        Fill a buffer with len bytes of the given val
-    */
-    static void FillBuffer(uint8_t *buf, uint8_t len, uint8_t val) {
-        uint8_t i;
-        for (i = 0; i < len; i++) {
-            *buf++ = val;
-        }
-    }
+    /**
+        Brings a discovered chain of \a boards online.
+    **/
+    void LinkStart(uint8_t boards);
 
-    /*
-        Return true if all entries are equal to val
-    */
-    static bool AllEntriesEqual(const uint8_t *buf, uint8_t len, uint8_t val) {
-        uint8_t i;
-        for (i = 0; i < len; i++) {
-            if (buf[i] != val) {
-                return false;
-            }
-        }
-        return true;
-    }
+    /**
+        Flags the link as broken after a failed discovery.
+    **/
+    void LinkFail(bool tooMany);
+
+    /**
+        Evaluates the transfer of a rediscover in progress and starts the next.
+    **/
+    void ProbeStep();
 
 }; // CcioBoardManager
 
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CCIOLINK_H__
+#define __CCIOLINK_H__
+
+#include <stdint.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  CcioLink class
+//
+// DESCRIPTION
+///     \brief Frame codec and double buffer of a CCIO-8 shift chain.
+///
+///     The boards of a link form one shift register of two bytes per board,
+///     an input byte and an output byte. A refresh is one SPI transfer of
+///     Length() bytes: a marker byte, one filler byte per input slot and the
+///     output bytes, last board first. What comes back is the previous
+///     content of the chain - the input bytes the boards loaded, first board
+///     first, and the output bytes of the previous transfer - followed by the
+///     marker, which has shifted through the whole chain. The bits on the
+///     wire are inverted.
+///
+///     Two frames alternate. One is on the wire while the other one is
+///     decoded and filled with the next outputs, so a refresh never waits for
+///     the transfer to end.
+///
+///     CcioBoardManager owns the link and moves the bytes: on every
+///     Refresh() it passes the received frame to Receive(), fills the other
+///     one with Prepare(), swaps and starts the SPI transfer of TxData().
+//
+class CcioLink {
+public:
+    /**
+        Longest chain, in boards.
+    **/
+    static const uint8_t BOARDS_MAX = 8;
+    /**
+        Longest frame, in bytes.
+    **/
+    static const uint8_t FRAME_MAX = 2 * BOARDS_MAX + 1;
+    /**
+        First byte of every frame.
+    **/
+    static const uint8_t MARKER = 0xCC;
+
+    typedef enum {
+        FRAME_OK,
+        // The marker did not come back, e.g. a board is missing
+        FRAME_MARKER_ERROR,
+        // The output bytes did not come back as they were sent
+        FRAME_ECHO_ERROR,
+    } FrameStatus;
+
+    CcioLink(void) {
+        Boards(0);
+    }
+
+    /**
+        \brief Set the length of the chain and switch all outputs off.
+
+        Both frames carry all outputs off and expect them back, so the first
+        refresh after two transfers of TxData() checks out.
+    **/
+    void Boards(uint8_t boards) {
+        m_boards = (boards > BOARDS_MAX) ? BOARDS_MAX : boards;
+        m_active = 0;
+        for (uint8_t i = 0; i < FRAME_MAX; i++) {
+            m_lastOutputs[i] = 0xFF;
+            m_frame[0].rx[i] = 0;
+            m_frame[1].rx[i] = 0;
+        }
+        Prepare(0);
+        Swap();
+        Prepare(0);
+    }
+
+    uint8_t Boards() const {
+        return m_boards;
+    }
+
+    /**
+        \return Bytes of a transfer
+    **/
+    uint8_t Length() const {
+        return 2 * m_boards + 1;
+    }
+
+    /**
+        \return The pin bits of the boards in the chain
+    **/
+    uint64_t Mask() const {
+        return (m_boards >= BOARDS_MAX) ? UINT64_MAX :
+               (1ULL << (m_boards * 8)) - 1;
+    }
+
+    /**
+        \brief Encode \a outputs, one bit per pin with the first pin of the
+        first board in bit 0, into the idle frame.
+    **/
+    void Prepare(uint64_t outputs) {
+        Frame &frame = m_frame[m_active ^ 1];
+        frame.tx[0] = MARKER;
+        for (uint8_t i = 0; i < m_boards; i++) {
+            frame.tx[1 + i] = 0;
+            frame.echo[i] = m_lastOutputs[i];
+            // The byte of the last board is sent first
+            m_lastOutputs[i] = ~static_cast<uint8_t>(
+                                   outputs >> (8 * (m_boards - 1 - i)));
+            frame.tx[1 + m_boards + i] = m_lastOutputs[i];
+        }
+    }
+
+    /**
+        \brief Make the prepared frame the active one, to be transferred next.
+    **/
+    void Swap() {
+        m_active ^= 1;
+    }
+
+    /**
+        \return Data to send for the active frame, Length() bytes
+    **/
+    const uint8_t *TxData() const {
+        return m_frame[m_active].tx;
+    }
+
+    /**
+        \return Destination of the received data of the active frame,
+        Length() bytes
+    **/
+    uint8_t *RxData() {
+        return m_frame[m_active].rx;
+    }
+
+    /**
+        \brief Decode the active frame after its transfer ended.
+
+        \param[out] inputs The input bits of the chain, only written if the
+        frame is intact
+        \return The frame check result
+    **/
+    FrameStatus Receive(uint64_t &inputs) {
+        Frame &frame = m_frame[m_active];
+        uint8_t *marker = &frame.rx[2 * m_boards];
+        bool markerError = *marker != MARKER;
+        // A stale marker must not pass for the next transfer's
+        *marker = 0;
+        if (markerError) {
+            return FRAME_MARKER_ERROR;
+        }
+        for (uint8_t i = 0; i < m_boards; i++) {
+            if (frame.rx[m_boards + i] != frame.echo[i]) {
+                return FRAME_ECHO_ERROR;
+            }
+        }
+        uint64_t value = 0;
+        for (uint8_t i = m_boards; i > 0; i--) {
+            value = (value << 8) | static_cast<uint8_t>(~frame.rx[i - 1]);
+        }
+        inputs = value;
+        return FRAME_OK;
+    }
+
+private:
+    typedef struct {
+        uint8_t tx[FRAME_MAX];
+        uint8_t rx[FRAME_MAX];
+        // Output bytes the chain has to return, sent with the previous frame
+        uint8_t echo[BOARDS_MAX];
+    } Frame;
+
+    Frame m_frame[2];
+    // Output bytes of the last prepared frame, in wire order
+    uint8_t m_lastOutputs[FRAME_MAX];
+    uint8_t m_boards;
+    uint8_t m_active;
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  CcioProbe class
+//
+// DESCRIPTION
+///     \brief Discovery of the length of a CCIO-8 shift chain.
+///
+///     Floods the chain with ones until something comes back, then with
+///     zeros until the ones are gone, and finally with 0xAA bytes; the zero
+///     bytes in front of the first 0xAA are the two bytes of every board.
+///     Next() gives the bytes of the next transfer and Result() evaluates
+///     what came back, so the probe can be run to the end in one go or one
+///     transfer at a time.
+///
+///     CcioBoardManager runs it to the end when a port is opened and one
+///     transfer per RefreshSlow() when it rediscovers a broken link, so that
+///     the refresh of the other connectors is not held up.
+//
+class CcioProbe {
+public:
+    typedef enum {
+        PROBE_RUNNING,
+        PROBE_FOUND,
+        // Nothing answered within the attempts
+        PROBE_NO_LINK,
+        // The chain is longer than CcioLink::BOARDS_MAX boards
+        PROBE_TOO_MANY,
+    } ProbeStatus;
+
+    CcioProbe(void)
+        : m_phase(PHASE_ONES), m_attempts(0), m_attemptsMax(1), m_boards(0) {}
+
+    /**
+        \brief Restart the probe, giving up after \a attempts failed flushes.
+    **/
+    void Start(uint8_t attempts) {
+        m_phase = PHASE_ONES;
+        m_attempts = 0;
+        m_attemptsMax = attempts;
+        m_boards = 0;
+    }
+
+    /**
+        \brief Fill \a tx with the next transfer.
+
+        \return Bytes to transfer; Result() expects as many in its buffer
+    **/
+    uint8_t Next(uint8_t *tx) const {
+        uint8_t fill = (m_phase == PHASE_ONES) ? 0xFF :
+                       (m_phase == PHASE_ZEROS) ? 0x00 : 0xAA;
+        // The 0xAA pattern is one byte longer to find a chain that is too long
+        uint8_t len = (m_phase == PHASE_COUNT) ? CcioLink::FRAME_MAX :
+                      CcioLink::FRAME_MAX - 1;
+        for (uint8_t i = 0; i < len; i++) {
+            tx[i] = fill;
+        }
+        return len;
+    }
+
+    /**
+        \brief Evaluate the bytes received for the last Next() transfer.
+    **/
+    ProbeStatus Result(const uint8_t *rx) {
+        const uint8_t flush = CcioLink::FRAME_MAX - 1;
+        switch (m_phase) {
+            case PHASE_ONES:
+                // Check if any 1's got through, otherwise resend 1's
+                if (!AllEntriesEqual(rx, flush, 0)) {
+                    m_phase = PHASE_ZEROS;
+                    m_attempts = 0;
+                }
+                break;
+            case PHASE_ZEROS:
+                // If 0's got through, count with a's; otherwise resend 0's
+                if (!AllEntriesEqual(rx, flush, 0xFF)) {
+                    m_phase = PHASE_COUNT;
+                }
+                break;
+            case PHASE_COUNT:
+            default: {
+                uint8_t found = 0;
+                while (found < flush && rx[found] != 0xAA) {
+                    found++;
+                }
+                if (found == flush && rx[flush] != 0xAA) {
+                    m_boards = 0;
+                    return PROBE_TOO_MANY;
+                }
+                // Two bytes per board
+                m_boards = found >> 1;
+                return PROBE_FOUND;
+            }
+        }
+        return (++m_attempts >= m_attemptsMax) ? PROBE_NO_LINK : PROBE_RUNNING;
+    }
+
+    /**
+        \return Boards found by the probe
+    **/
+    uint8_t Boards() const {
+        return m_boards;
+    }
+
+private:
+    typedef enum {
+        PHASE_ONES,
+        PHASE_ZEROS,
+        PHASE_COUNT,
+    } Phase;
+
+    Phase m_phase;
+    uint8_t m_attempts;
+    uint8_t m_attemptsMax;
+    uint8_t m_boards;
+
+    /*
+        Return true if all entries are equal to val
+    */
+    static bool AllEntriesEqual(const uint8_t *buf, uint8_t len, uint8_t val) {
+        for (uint8_t i = 0; i < len; i++) {
+            if (buf[i] != val) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __CCIOLINK_H__
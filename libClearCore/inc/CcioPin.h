@@ -167,10 +167,7 @@ public:
 
         \note One sample time is 200 microseconds.
     **/
-    void FilterLength(uint16_t samples) {
-        m_filterLength = samples;
-        m_filterTicksLeft = samples;
-    }
+    void FilterLength(uint16_t samples);
 
     /**
         \brief Set the connector's digital filter length in ms.
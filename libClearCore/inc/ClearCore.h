@@ -42,6 +42,7 @@
 #include "SerialUsb.h"
 #include "StatusManager.h"
 #include "SysManager.h"
+#include "SysProfiler.h"
 #include "SysTiming.h"
 #include "XBeeDriver.h"
 
@@ -109,6 +110,9 @@ extern StatusManager &StatusMgr;
 /// Timing manager
 extern SysTiming &TimingMgr;
 
+/// Background processing profiler
+extern SysProfiler &ProfilerMgr;
+
 /// SD card
 extern SdCardDriver SdCard;
 
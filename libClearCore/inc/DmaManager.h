@@ -44,6 +44,12 @@ typedef enum {
     DMA_SERCOM0_SPI_TX, ///< COM1 SPI streaming output
     DMA_SERCOM7_SPI_RX, ///< COM0 SPI streaming input
     DMA_SERCOM7_SPI_TX, ///< COM0 SPI streaming output
+    DMA_STEP_M0,        ///< M-0 step slot duty counts
+    DMA_STEP_M1,        ///< M-1 step slot duty counts
+    DMA_STEP_M2,        ///< M-2 step slot duty counts
+    DMA_STEP_M3,        ///< M-3 step slot duty counts
+    DMA_SERCOM4_SPI_RX, ///< SD card SPI streaming input
+    DMA_SERCOM4_SPI_TX, ///< SD card SPI streaming output
     DMA_CHANNEL_COUNT,  // Keep at end
     DMA_INVALID_CHANNEL // Placeholder for unset values
 } DmaChannels;
@@ -59,6 +65,14 @@ class DmaManager {
 public:
     static DmacChannel *Channel(DmaChannels index);
     static DmacDescriptor *BaseDescriptor(DmaChannels index);
+    static DmacDescriptor *WriteBackDescriptor(DmaChannels index);
+    /**
+        \brief Beats left in the current block of a channel.
+
+        Reads the live count of the channel the DMAC is serving and the
+        write-back descriptor of any other channel.
+    **/
+    static uint16_t BeatsRemaining(DmaChannels index);
 
     /**
         Public accessor for singleton instance
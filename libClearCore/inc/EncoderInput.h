@@ -31,10 +31,14 @@
 #ifndef __ENCODER_INPUT_H__
 #define __ENCODER_INPUT_H__
 
+#include "IirFilter.h"
+#include "InputManager.h"
 #include "PeripheralRoute.h"
 
 /// Number of encoder samples to use for velocity calculation
 #define VEL_EST_SAMPLES 50
+/// Default 99% rise time of the filtered velocity estimate
+#define VEL_FILTER_TC_MS 10
 
 namespace ClearCore {
 
@@ -174,6 +178,127 @@ public:
         return m_velocity;
     }
 
+    /**
+        \brief Read the low-pass filtered velocity of the encoder input
+        (counts per second)
+
+        The counts of every sample time are run through a fixed-point IIR
+        filter, which responds faster than Velocity() and resolves speeds
+        below one count per sample time.
+
+        \code{.cpp}
+        // Read the filtered encoder velocity
+        int32_t encoderSpeed = EncoderIn.VelocityFiltered();
+        \endcode
+
+        \return The filtered encoder input velocity in counts per second.
+    **/
+    int32_t VelocityFiltered();
+
+    /**
+        \brief Set the time constant of the filtered velocity estimate.
+
+        \code{.cpp}
+        // Settle the filtered velocity within 20 ms
+        EncoderIn.VelocityFilterTc_ms(20);
+        \endcode
+
+        \param[in] tcMs The 99% rise time of the filter in milliseconds.
+    **/
+    void VelocityFilterTc_ms(uint16_t tcMs) {
+        m_velocityFilter.Tc_ms(tcMs);
+    }
+
+    /**
+        \brief The time of the last position update.
+
+        \code{.cpp}
+        // Read the position together with the time it was sampled
+        uint32_t sampleTime = EncoderIn.PositionTimestamp();
+        int32_t position = EncoderIn.Position();
+        \endcode
+
+        \return The value of Microseconds() when the encoder position was
+        sampled in the last sample time.
+    **/
+    volatile const uint32_t& PositionTimestamp() {
+        return m_sampleMicros;
+    }
+
+    /**
+        \brief Arm the registration latch.
+
+        On the next \a trigger condition of the input \a pin the encoder
+        position and Microseconds() are captured in the interrupt. The latch
+        is one-shot; arm it again for the next capture.
+
+        \code{.cpp}
+        // Capture the encoder position on the next rising edge of DI-7
+        EncoderIn.RegistrationLatchArm(CLEARCORE_PIN_DI7);
+        \endcode
+
+        \param[in] pin A connector that can trigger interrupts (DI-6 through
+        A-12).
+        \param[in] trigger The input state condition to capture on.
+
+        \return True if the latch was armed.
+    **/
+    bool RegistrationLatchArm(ClearCorePins pin,
+                              InputManager::InterruptTrigger trigger =
+                                  InputManager::RISING);
+
+    /**
+        \brief Disarm the registration latch without a capture.
+
+        \code{.cpp}
+        EncoderIn.RegistrationLatchDisarm();
+        \endcode
+    **/
+    void RegistrationLatchDisarm();
+
+    /**
+        \brief Check if the registration latch is waiting for its input.
+
+        \return True if armed and not yet captured.
+    **/
+    volatile const bool& RegistrationLatchArmed() {
+        return m_latchArmed;
+    }
+
+    /**
+        \brief Number of registration captures since power up.
+
+        \code{.cpp}
+        static uint32_t lastCount = 0;
+        if (EncoderIn.RegistrationCount() != lastCount) {
+            lastCount = EncoderIn.RegistrationCount();
+            // A new registration position is available
+        }
+        \endcode
+
+        \return The capture counter; changes once the captured position is
+        available.
+    **/
+    volatile const uint32_t& RegistrationCount() {
+        return m_latchCount;
+    }
+
+    /**
+        \brief The encoder position at the last registration capture.
+
+        \return The captured position, adjusted like Position().
+    **/
+    int32_t RegistrationPosition();
+
+    /**
+        \brief The time of the last registration capture.
+
+        \return The value of Microseconds() at the last capture.
+    **/
+    volatile const uint32_t& RegistrationTimestamp() {
+        return m_latchMicros;
+    }
+
     /**
         \brief Check if there was an index pulse in the last sample time.
 
@@ -242,6 +367,13 @@ public:
         return m_stepsLast;
     }
 
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Capture the registration latch; called from the input's interrupt.
+    **/
+    void RegistrationCapture();
+#endif
+
 private:
     const PeripheralRoute *m_aInfo;
     const PeripheralRoute *m_bInfo;
@@ -259,6 +391,16 @@ private:
     bool m_indexDetected;
     bool m_indexInverted;
     int16_t m_stepsLast;
+    IirS16 m_velocityFilter;
+    uint32_t m_sampleMicros;
+    // Registration latch
+    int8_t m_latchExtInt;
+    bool m_latchArmed;
+    bool m_processLatch;
+    int16_t m_hwLatch;
+    uint32_t m_latchMicros;
+    int32_t m_latchPosn;
+    uint32_t m_latchCount;
 
     void Initialize();
 
@@ -39,16 +39,44 @@
 #define TX_BUFF_CNT (8)
 #endif
 
+// A frame takes as many RX buffers as it needs, see the RX ring sizing
+// table of the README for the trade-off between RAM and lost frames.
 #ifndef RX_BUFF_CNT
-#define RX_BUFF_CNT (16)
+#define RX_BUFF_CNT (24)
 #endif
 
 #ifndef TX_BUFFER_SIZE
 #define TX_BUFFER_SIZE (520)
 #endif
 
+// In units of 64 bytes (DCFGR.DRBS), 1536 holds any frame in one buffer
 #ifndef RX_BUFFER_SIZE
-#define RX_BUFFER_SIZE (128)
+#define RX_BUFFER_SIZE (512)
+#endif
+
+#if (RX_BUFFER_SIZE % 64) != 0 || RX_BUFFER_SIZE < 64 || RX_BUFFER_SIZE > 1536
+#error "RX_BUFFER_SIZE must be a multiple of 64 from 64 to 1536"
+#endif
+
+#if RX_BUFF_CNT < 2 || RX_BUFF_CNT > 255
+#error "RX_BUFF_CNT must be from 2 to 255"
+#endif
+
+// Input section of the descriptor lists and buffers. Linker scripts place
+// it with the rest of .bss unless they give it an output section of its own
+// (.gmac_ring in the OpENer linker scripts).
+#ifndef GMAC_RING_SECTION
+#define GMAC_RING_SECTION ".bss.gmac_ring"
+#endif
+
+// Received frames screened off the RX ring, waiting for lwIP (see
+// GmacRxScreen.h)
+#ifndef RX_IO_QUEUE_CNT
+#define RX_IO_QUEUE_CNT (4)
+#endif
+
+#ifndef RX_OTHER_QUEUE_CNT
+#define RX_OTHER_QUEUE_CNT (6)
 #endif
 
 /**
@@ -34,6 +34,7 @@
 #include <cstring>
 #include <sam.h>
 #include "EthernetApi.h"
+#include "GmacRxScreen.h"
 #include "HardwareMapping.h"
 #include "IpAddress.h"
 #include "Phy.h"
@@ -316,6 +317,24 @@ public:
     **/
     bool DhcpBegin();
 
+    /**
+        \brief Start DHCP negotiation without waiting for the result.
+
+        lwIP keeps discovering, and later renews the lease, from Refresh().
+        The interface keeps its current address until a lease is bound, so
+        a previously known address can be applied before calling this.
+
+        \return Returns true if the DHCP client was started.
+    **/
+    bool DhcpStart();
+
+    /**
+        \brief Check whether the DHCP client holds a lease.
+
+        \return Returns true if DHCP supplied the current IP address.
+    **/
+    bool DhcpBound();
+
     /**
         \brief Setup LwIP with the local network interface.
         \note Should only be called once.
@@ -333,6 +352,52 @@ public:
     **/
     void Refresh();
 
+    /**
+        \brief GMAC statistics, in the order of the EtherNet/IP Ethernet
+        Link media counters.
+    **/
+    typedef struct {
+        uint32_t alignmentErrors;       // AE
+        uint32_t fcsErrors;             // FCSE
+        uint32_t singleCollisions;      // SCF
+        uint32_t multipleCollisions;    // MCF
+        uint32_t deferredFrames;        // DTF
+        uint32_t lateCollisions;        // LC
+        uint32_t excessiveCollisions;   // EC
+        uint32_t txUnderruns;           // TUR
+        uint32_t carrierSenseErrors;    // CSE
+        uint32_t oversizeFrames;        // OFR
+        uint32_t rxOverruns;            // ROE, the receive DMA fell behind
+        uint32_t rxResourceErrors;      // RRE, no free RX buffer
+    } MacCounters;
+
+    /**
+        \brief The GMAC statistics since startup or the last CountersClear().
+
+        The statistics registers of the GMAC clear on read and stop at their
+        maximum, so they are added up here, when called and once a second
+        from Refresh().
+    **/
+    const MacCounters &Counters();
+
+    /**
+        \brief Restart the GMAC statistics from zero.
+    **/
+    void CountersClear();
+
+    /**
+        \brief Set the UDP port of the received frames that are passed to
+        LwIP ahead of all others.
+
+        By default the EtherNet/IP class 1 I/O port 2222, so that cyclic I/O
+        is not queued behind ARP and broadcast traffic.
+
+        \param[in] port The UDP destination port.
+    **/
+    void RxPriorityPort(uint16_t port) {
+        m_rxScreen.Port(port);
+    }
+
     /**
         \brief A flag to indicate whether Ethernet setup has been invoked.
 
@@ -386,14 +451,24 @@ private:
     uint8_t m_rxBuffIndex;
     // Transmit Buffer Current Index
     uint16_t m_txBuffIndex;
+    // The descriptor lists and buffers are in GMAC_RING_SECTION.
     // Receive Buffer Descriptor List
-    GMAC_RX_DESC m_rxDesc[RX_BUFF_CNT];
+    static GMAC_RX_DESC m_rxDesc[RX_BUFF_CNT];
     // Transmit Buffer Descriptor List
-    GMAC_TX_DESC m_txDesc[TX_BUFF_CNT];
+    static GMAC_TX_DESC m_txDesc[TX_BUFF_CNT];
     // Receive Buffers
-    uint8_t m_rxBuffer[RX_BUFF_CNT][RX_BUFFER_SIZE];
+    static uint8_t m_rxBuffer[RX_BUFF_CNT][RX_BUFFER_SIZE];
     // Transmit Buffers
-    uint8_t m_txBuffer[TX_BUFF_CNT][TX_BUFFER_SIZE];
+    static uint8_t m_txBuffer[TX_BUFF_CNT][TX_BUFFER_SIZE];
+    // Screening of the received frames
+    GmacRxScreen m_rxScreen;
+    // Received frames waiting for LwIP, I/O first
+    RxArbiter<struct pbuf *, RX_IO_QUEUE_CNT, RX_OTHER_QUEUE_CNT> m_rxQueue;
+
+    // GMAC statistics, accumulated
+    MacCounters m_counters;
+    // Time the statistics registers were last read
+    uint32_t m_countersMs;
 
     // Blocking retransmission timeout in milliseconds
     uint16_t m_retransmissionTimeout;
@@ -416,6 +491,15 @@ private:
     **/
     void NetifInit();
 
+    /**
+        \brief Move the complete frames of the RX ring into the receive
+        queues.
+
+        A frame that finds its queue full is dropped before a pbuf is taken
+        for it.
+    **/
+    void RxScreen();
+
     /**
         \brief Setup a single GMAC GPIO.
 
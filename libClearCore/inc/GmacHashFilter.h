@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __GMACHASHFILTER_H__
+#define __GMACHASHFILTER_H__
+
+#include <stdint.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  GmacHashFilter class
+//
+// DESCRIPTION
+///     \brief Contents of the GMAC 64 bit multicast hash filter.
+///
+///     Each destination MAC address selects one of 64 hash bits; a frame is
+///     accepted when its bit is set in HRB (bits 0 to 31) or HRT (bits 32 to
+///     63). Several groups can share a bit, so each bit counts the groups
+///     that need it and is cleared once the last of them leaves.
+///
+///     The IGMP MAC filter of the lwIP netif (ethernetif.c) keeps one for
+///     the groups joined by lwIP. After every join or leave it writes
+///     Bottom() to HRB and Top() to HRT, and it enables the multicast hash
+///     match of NCFGR only while the filter is not Empty().
+//
+class GmacHashFilter {
+public:
+    GmacHashFilter(void) {
+        Reset();
+    }
+
+    /**
+        \brief Drop all groups.
+    **/
+    void Reset() {
+        for (uint8_t i = 0; i < 64; i++) {
+            m_refs[i] = 0;
+        }
+        m_bits[0] = 0;
+        m_bits[1] = 0;
+    }
+
+    /**
+        \brief Hash bit of a destination address.
+
+        Bit n of the index is the XOR of address bits n, n + 6, n + 12, ...
+        where address bit 0 is the least significant bit of the first byte,
+        as the datasheet describes it.
+
+        \param[in] mac Six byte destination address
+        \return Index 0 to 63
+    **/
+    static uint8_t Index(const uint8_t *mac) {
+        uint8_t index = 0;
+        for (uint8_t bit = 0; bit < 48; bit++) {
+            if ((mac[bit >> 3] >> (bit & 7)) & 1) {
+                index ^= 1 << (bit % 6);
+            }
+        }
+        return index;
+    }
+
+    /**
+        \brief Ethernet address of an IPv4 multicast group.
+
+        \param[in] group Group address, first octet in the low byte as
+        lwIP stores it
+        \param[out] mac 01:00:5E and the low 23 bits of the group
+    **/
+    static void MulticastMac(uint32_t group, uint8_t *mac) {
+        mac[0] = 0x01;
+        mac[1] = 0x00;
+        mac[2] = 0x5E;
+        mac[3] = (group >> 8) & 0x7F;
+        mac[4] = group >> 16;
+        mac[5] = group >> 24;
+    }
+
+    /**
+        \brief Accept frames to \a mac.
+
+        \return true if the registers have to be written
+    **/
+    bool Add(const uint8_t *mac) {
+        uint8_t index = Index(mac);
+        if (m_refs[index]++) {
+            return false;
+        }
+        m_bits[index >> 5] |= 1UL << (index & 31);
+        return true;
+    }
+
+    /**
+        \brief Stop accepting frames to \a mac, unless another address
+        shares its bit.
+
+        \return true if the registers have to be written
+    **/
+    bool Remove(const uint8_t *mac) {
+        uint8_t index = Index(mac);
+        if (!m_refs[index] || --m_refs[index]) {
+            return false;
+        }
+        m_bits[index >> 5] &= ~(1UL << (index & 31));
+        return true;
+    }
+
+    /**
+        \return Value of the Hash Register Bottom
+    **/
+    uint32_t Bottom() const {
+        return m_bits[0];
+    }
+
+    /**
+        \return Value of the Hash Register Top
+    **/
+    uint32_t Top() const {
+        return m_bits[1];
+    }
+
+    /**
+        \return true if no group is joined
+    **/
+    bool Empty() const {
+        return !m_bits[0] && !m_bits[1];
+    }
+
+private:
+    // Groups using each hash bit
+    uint8_t m_refs[64];
+    uint32_t m_bits[2];
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __GMACHASHFILTER_H__
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __GMACRXSCREEN_H__
+#define __GMACRXSCREEN_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  GmacRxScreen class
+//
+// DESCRIPTION
+///     \brief Screening of received frames into the cyclic I/O queue and the
+///     queue of all other frames.
+///
+///     The GMAC of the SAM E5x has a single receive queue and no screening
+///     registers, so the frames are screened in software while they are
+///     taken off the receive ring. A frame goes to the I/O queue when it is
+///     the first fragment of an IPv4 UDP datagram to the I/O port, with or
+///     without an 802.1Q tag.
+///
+///     EthernetManager classifies each frame from its first receive buffer,
+///     before it copies the frame into a pbuf, so a frame for a full queue
+///     is given back to the GMAC without a copy. RxPriorityPort() sets the
+///     I/O port.
+//
+class GmacRxScreen {
+public:
+    typedef enum {
+        QUEUE_IO,
+        QUEUE_OTHER,
+        QUEUE_CNT
+    } Queues;
+
+    /**
+        \param[in] port UDP destination port of the I/O frames, the
+        EtherNet/IP class 1 port by default
+    **/
+    GmacRxScreen(uint16_t port = 2222) : m_port(port) {}
+
+    /**
+        \brief Queue of a frame.
+
+        \param[in] frame Start of the Ethernet header
+        \param[in] len Bytes of \a frame at hand, the headers only need
+        to be there
+    **/
+    Queues Classify(const uint8_t *frame, uint32_t len) const {
+        uint32_t offset = 12;
+        if (len < offset + 2) {
+            return QUEUE_OTHER;
+        }
+        uint16_t type = Be16(frame + offset);
+        if (type == 0x8100) {
+            offset += 4;
+            if (len < offset + 2) {
+                return QUEUE_OTHER;
+            }
+            type = Be16(frame + offset);
+        }
+        offset += 2;
+        // IPv4 header up to the protocol
+        if (type != 0x0800 || len < offset + 20 ||
+                (frame[offset] >> 4) != 4) {
+            return QUEUE_OTHER;
+        }
+        uint32_t headerLen = (frame[offset] & 0x0F) * 4;
+        if (headerLen < 20 || frame[offset + 9] != 17 ||
+                (Be16(frame + offset + 6) & 0x1FFF) != 0) {
+            return QUEUE_OTHER;
+        }
+        offset += headerLen;
+        if (len < offset + 4 || Be16(frame + offset + 2) != m_port) {
+            return QUEUE_OTHER;
+        }
+        return QUEUE_IO;
+    }
+
+    uint16_t Port() const {
+        return m_port;
+    }
+
+    void Port(uint16_t port) {
+        m_port = port;
+    }
+
+private:
+    uint16_t m_port;
+
+    static uint16_t Be16(const uint8_t *data) {
+        return static_cast<uint16_t>((data[0] << 8) | data[1]);
+    }
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  GmacRxRing class
+//
+// DESCRIPTION
+///     \brief Where the first complete frame lies on the receive ring.
+///
+///     A frame starts at a buffer with SF set and ends at the next buffer
+///     with EF set. Buffers owned by software before the SF buffer, such as
+///     the tail of a frame whose start the GMAC dropped, are skipped, so an
+///     EF without an SF ends nothing.
+///
+///     PacketHeader(), PacketLength() and PacketRead() of ethernetif.c all
+///     find the frame through Frame(). EthernetManager screens the frame
+///     that PacketHeader() returns and then has low_level_input() take it
+///     off the ring, so both have to agree where it starts.
+//
+template<typename DESC>
+class GmacRxRing {
+public:
+    /**
+        \brief Find the first complete frame.
+
+        \param[in] desc The receive descriptors
+        \param[in] count Descriptors on the ring
+        \param[in] index Descriptor to start at, the current RX index
+        \param[out] first Offset from \a index of the SF buffer
+        \param[out] last Offset from \a index of the EF buffer
+        \return false if no frame is complete
+    **/
+    static bool Frame(const DESC *desc, uint32_t count, uint32_t index,
+                      uint32_t &first, uint32_t &last) {
+        bool started = false;
+        for (uint32_t i = 0; i < count; i++) {
+            const DESC &buffer = desc[(index + i) % count];
+            // The OWN bit indicates software has ownership of this buffer.
+            if (!buffer.bit.OWN) {
+                break;
+            }
+            if (buffer.bit.SF) {
+                started = true;
+                first = i;
+            }
+            if (buffer.bit.EF && started) {
+                last = i;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  RxArbiter class
+//
+// DESCRIPTION
+///     \brief The screened receive queues and their arbitration.
+///
+///     The I/O queue is always served first. Other frames are served within
+///     a budget per round, one Refresh() of the EthernetManager, and the
+///     rest wait for the next round. A frame that finds its queue full is
+///     dropped, so a storm of other frames neither holds more than
+///     \a OTHER_CNT buffers nor delays an I/O frame by more than a round.
+///
+///     EthernetManager holds the pbufs of the received frames in it. Each
+///     Refresh() opens a round of RX_OTHER_QUEUE_CNT frames and screens the
+///     ring again before every Pop(), so that an I/O frame that arrives
+///     meanwhile is passed to lwIP next.
+//
+template<typename T, uint8_t IO_CNT, uint8_t OTHER_CNT>
+class RxArbiter {
+public:
+    RxArbiter(void) : m_budget(0) {
+        m_queues[0].depth = IO_CNT;
+        m_queues[1].depth = OTHER_CNT;
+        for (uint8_t q = 0; q < GmacRxScreen::QUEUE_CNT; q++) {
+            m_queues[q].head = 0;
+            m_queues[q].count = 0;
+            m_queues[q].dropped = 0;
+        }
+    }
+
+    /**
+        \brief Start a round that serves up to \a budget other frames.
+    **/
+    void Round(uint8_t budget) {
+        m_budget = budget;
+    }
+
+    /**
+        \return true if a frame for \a queue would be dropped
+    **/
+    bool Full(GmacRxScreen::Queues queue) const {
+        return m_queues[queue].count == m_queues[queue].depth;
+    }
+
+    /**
+        \brief Count a frame for \a queue that was dropped before it was
+        pushed, e.g. because it found the queue full.
+    **/
+    void Drop(GmacRxScreen::Queues queue) {
+        m_queues[queue].dropped++;
+    }
+
+    /**
+        \brief Queue a frame.
+
+        \return false, and the frame is counted as dropped, if the queue is
+        full
+    **/
+    bool Push(GmacRxScreen::Queues queue, T item) {
+        Queue &q = m_queues[queue];
+        if (q.count == q.depth) {
+            q.dropped++;
+            return false;
+        }
+        Slots(queue)[(q.head + q.count) % q.depth] = item;
+        q.count++;
+        return true;
+    }
+
+    /**
+        \brief Take the next frame to serve.
+
+        \param[out] item The frame
+        \param[out] queue Its queue, may be NULL
+        \return false if the I/O queue is empty and the other queue is empty
+        or out of budget
+    **/
+    bool Pop(T &item, GmacRxScreen::Queues *queue = NULL) {
+        GmacRxScreen::Queues from = GmacRxScreen::QUEUE_IO;
+        if (!m_queues[from].count) {
+            from = GmacRxScreen::QUEUE_OTHER;
+            if (!m_queues[from].count || !m_budget) {
+                return false;
+            }
+            m_budget--;
+        }
+        Queue &q = m_queues[from];
+        item = Slots(from)[q.head];
+        q.head = (q.head + 1) % q.depth;
+        q.count--;
+        if (queue) {
+            *queue = from;
+        }
+        return true;
+    }
+
+    /**
+        \return Frames waiting in \a queue
+    **/
+    uint8_t Count(GmacRxScreen::Queues queue) const {
+        return m_queues[queue].count;
+    }
+
+    /**
+        \return Frames dropped for \a queue so far
+    **/
+    uint32_t Dropped(GmacRxScreen::Queues queue) const {
+        return m_queues[queue].dropped;
+    }
+
+private:
+    struct Queue {
+        uint8_t head;
+        uint8_t count;
+        uint8_t depth;
+        uint32_t dropped;
+    };
+
+    Queue m_queues[GmacRxScreen::QUEUE_CNT];
+    uint8_t m_budget;
+    T m_io[IO_CNT];
+    T m_other[OTHER_CNT];
+
+    T *Slots(GmacRxScreen::Queues queue) {
+        return queue == GmacRxScreen::QUEUE_IO ? m_io : m_other;
+    }
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __GMACRXSCREEN_H__
@@ -103,6 +103,86 @@ private:
     int32_t m_z;  // "Z" output/accumulator
 };
 
+//*****************************************************************************
+// NAME                                                                       *
+//  IirS16 class
+//
+// DESCRIPTION
+///     \brief An IIR filter that filters a signed 16-bit input and keeps
+///     16 fractional bits in its output.
+///
+///     Same form and time constant scaling as Iir16. Averaging a small
+///     per-sample count (e.g. encoder counts per sample time) keeps the
+///     sub-count resolution in LastOutputQ16().
+//
+class IirS16 {
+public:
+    IirS16(void) : m_tc(0), m_z(0) {};
+
+    /**
+        Update the output with this input.
+    **/
+    void Update(int16_t input) {
+        m_z = ((static_cast<int64_t>(m_z) * m_tc) >> 15) -
+              ((static_cast<int32_t>(input) * m_tc) << 1) +
+              (static_cast<int32_t>(input) << 16);
+    }
+
+    /**
+        \return Return the last output
+    **/
+    int16_t LastOutput() {
+        return (m_z >> 16);
+    };
+
+    /**
+        \return Return the last output with 16 fractional bits
+    **/
+    int32_t LastOutputQ16() {
+        return m_z;
+    };
+
+    /**
+        Set TC
+    **/
+    void Tc(uint16_t newTc) {
+        m_tc = newTc;
+    };
+
+    /**
+        Get TC
+    **/
+    uint16_t Tc() {
+        return m_tc;
+    };
+
+    void TcSamples(uint16_t riseSamples99pct) {
+        float tcTemp = powf(.01, 1. / riseSamples99pct) * 32768 + 0.5;
+        m_tc = (tcTemp < INT16_MAX) ? tcTemp : INT16_MAX;
+    }
+
+    uint16_t TcSamples() {
+        return logf(0.01) / logf(m_tc / 32768.);
+    }
+
+    uint16_t Tc_ms() {
+        return TcSamples() / MS_TO_SAMPLES;
+    }
+
+    void Tc_ms(uint16_t riseMs99pct) {
+        TcSamples(riseMs99pct * MS_TO_SAMPLES);
+    }
+
+    // Reset the filter to this level
+    void Reset(int16_t newSetting) {
+        m_z = static_cast<int32_t>(newSetting) << 16;
+    }
+
+private:
+    uint16_t m_tc; // Filter time constant (positive)
+    int32_t m_z;  // "Z" output/accumulator
+};
+
 } // ClearCore namespace
 #endif // HIDE_FROM_DOXYGEN
 #endif // #ifndef __IIRFILTER_H__
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __INETCHECKSUM_H__
+#define __INETCHECKSUM_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  InetChecksum class
+//
+// DESCRIPTION
+///     \brief Internet checksum (RFC 1071) of a buffer.
+///
+///     The software path of lwIP for what the GMAC checksum offload does not
+///     cover, ICMP, IGMP and all checksums when the offload is disabled.
+///     The bulk of the buffer is added four 32 bit words at a time. On a
+///     Thumb-2 core the words go through one ADDS/ADCS carry chain, elsewhere
+///     into a 64 bit accumulator, so no carry has to be added back inside
+///     the loop.
+///
+///     Bytes are summed at the parity of their address, so the sums of the
+///     pieces of a buffer simply add up; the result is swapped once at the
+///     end if the buffer starts at an odd address.
+///
+///     ethernetif.c exports Sum() as the LWIP_CHKSUM and Copy() as the
+///     LWIP_CHKSUM_COPY of lwipopts.h. The latter only runs when the GMAC
+///     checksum offload is disabled.
+//
+class InetChecksum {
+public:
+    /**
+        \brief Sum the 16 bit words of \a data.
+
+        Meets the LWIP_CHKSUM contract: \a data may start at any address
+        and the result is the folded, non-inverted sum in the byte order
+        of the buffer.
+
+        \param[in] data Start of the buffer
+        \param[in] len Length in bytes
+        \return Ones' complement sum
+    **/
+    static uint16_t Sum(const void *data, int32_t len) {
+        const uint8_t *pb = static_cast<const uint8_t *>(data);
+        if (len <= 0) {
+            return 0;
+        }
+        int32_t head = HeadBytes(pb, len);
+        uint64_t sum = Bytes(pb, head);
+        pb += head;
+        len -= head;
+
+        sum += Words(reinterpret_cast<const uint32_t *>(pb), len >> 2);
+        pb += len & ~3;
+        sum += Bytes(pb, len & 3);
+        return Finish(sum, data);
+    }
+
+    /**
+        \brief Copy \a len bytes from \a src to \a dst and sum them on the
+        way, the LWIP_CHKSUM_COPY of the port.
+
+        Buffers with the same offset from a word address are copied and
+        summed in one pass, others are copied first and summed after.
+
+        \return Sum(dst, len)
+    **/
+    static uint16_t Copy(void *dst, const void *src, int32_t len) {
+        if (len <= 0) {
+            return 0;
+        }
+        if ((reinterpret_cast<uintptr_t>(dst) ^
+                reinterpret_cast<uintptr_t>(src)) & 3) {
+            memcpy(dst, src, len);
+            return Sum(dst, len);
+        }
+        uint8_t *db = static_cast<uint8_t *>(dst);
+        const uint8_t *sb = static_cast<const uint8_t *>(src);
+        int32_t head = HeadBytes(sb, len);
+        memcpy(db, sb, head);
+        uint64_t sum = Bytes(sb, head);
+        db += head;
+        sb += head;
+        len -= head;
+
+        const uint32_t *sl = reinterpret_cast<const uint32_t *>(sb);
+        uint32_t *dl = reinterpret_cast<uint32_t *>(db);
+        int32_t count = len >> 2;
+        for (; count >= 4; count -= 4) {
+            uint32_t w0 = sl[0];
+            uint32_t w1 = sl[1];
+            uint32_t w2 = sl[2];
+            uint32_t w3 = sl[3];
+            dl[0] = w0;
+            dl[1] = w1;
+            dl[2] = w2;
+            dl[3] = w3;
+            sum += w0;
+            sum += w1;
+            sum += w2;
+            sum += w3;
+            sl += 4;
+            dl += 4;
+        }
+        for (; count > 0; count--) {
+            uint32_t w = *sl++;
+            *dl++ = w;
+            sum += w;
+        }
+
+        sb = reinterpret_cast<const uint8_t *>(sl);
+        db = reinterpret_cast<uint8_t *>(dl);
+        memcpy(db, sb, len & 3);
+        sum += Bytes(sb, len & 3);
+        return Finish(sum, dst);
+    }
+
+    /**
+        \brief Fold a wide ones' complement sum to 16 bits.
+    **/
+    static uint16_t Fold(uint64_t sum) {
+        sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        return static_cast<uint16_t>(sum);
+    }
+
+private:
+    /**
+        \return Bytes of \a len before the first word address at or after
+        \a data
+    **/
+    static int32_t HeadBytes(const void *data, int32_t len) {
+        int32_t head = (0 - reinterpret_cast<uintptr_t>(data)) & 3;
+        return head < len ? head : len;
+    }
+
+    /**
+        \brief Sum a few bytes, each at the parity of its address.
+    **/
+    static uint32_t Bytes(const uint8_t *data, int32_t len) {
+        uint32_t sum = 0;
+        for (; len > 0; len--, data++) {
+            uint16_t word = 0;
+            reinterpret_cast<uint8_t *>(&word)[
+                reinterpret_cast<uintptr_t>(data) & 1] = *data;
+            sum += word;
+        }
+        return sum;
+    }
+
+    /**
+        \brief Sum \a count aligned words.
+    **/
+    static uint64_t Words(const uint32_t *data, int32_t count) {
+        uint64_t sum = 0;
+#if defined(__thumb2__)
+        uint32_t chain = 0;
+        for (; count >= 4; count -= 4) {
+            uint32_t w0, w1, w2, w3;
+            // A carry out of one word is added in by the next, the last
+            // one by the ADC. The chain cannot end at all ones with a carry,
+            // so that ADC cannot carry out.
+            __asm__("ldr %[w0], [%[p]], #4\n\t"
+                    "ldr %[w1], [%[p]], #4\n\t"
+                    "ldr %[w2], [%[p]], #4\n\t"
+                    "ldr %[w3], [%[p]], #4\n\t"
+                    "adds %[s], %[s], %[w0]\n\t"
+                    "adcs %[s], %[s], %[w1]\n\t"
+                    "adcs %[s], %[s], %[w2]\n\t"
+                    "adcs %[s], %[s], %[w3]\n\t"
+                    "adc %[s], %[s], #0"
+                    : [s] "+r" (chain), [p] "+r" (data), [w0] "=&r" (w0),
+                    [w1] "=&r" (w1), [w2] "=&r" (w2), [w3] "=&r" (w3)
+                    :
+                    : "cc", "memory");
+        }
+        sum = chain;
+#else
+        for (; count >= 4; count -= 4) {
+            sum += data[0];
+            sum += data[1];
+            sum += data[2];
+            sum += data[3];
+            data += 4;
+        }
+#endif
+        for (; count > 0; count--) {
+            sum += *data++;
+        }
+        return sum;
+    }
+
+    /**
+        \brief Fold \a sum and swap it back for a buffer at an odd address.
+    **/
+    static uint16_t Finish(uint64_t sum, const void *data) {
+        uint16_t folded = Fold(sum);
+        if (reinterpret_cast<uintptr_t>(data) & 1) {
+            folded = static_cast<uint16_t>((folded << 8) | (folded >> 8));
+        }
+        return folded;
+    }
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __INETCHECKSUM_H__
@@ -30,10 +30,12 @@
 #include <stdint.h>
 #include "Connector.h"
 #include "DigitalIn.h"
+#include "DmaManager.h"
 #include "PeripheralRoute.h"
 #include "ShiftRegister.h"
 #include "StatusManager.h"
 #include "StepGenerator.h"
+#include "StepPulseTiming.h"
 #include "SysUtils.h"
 #include "SysManager.h"
 
@@ -1559,6 +1561,17 @@ private:
     ClearFaultState m_clearFaultState;
     uint32_t m_clearFaultHlfbTimer;
 
+    // DMA step output mode
+    bool m_stepDmaActive;
+    uint32_t m_stepSlotMax;
+    StepPulseTiming m_stepTiming;
+    // Two halves of slot duty counts; the DMA plays one while the sample
+    // interrupt fills the other
+    uint32_t m_stepSlots[2][STEP_PULSE_SLOTS];
+    // Second descriptor of the step DMA ring, the first one is the channel's
+    // base descriptor
+    DmacDescriptor m_stepDmaDescriptor __attribute__((aligned(16)));
+
     /**
         Construct, wire in pads and LED Shift register object
     **/
@@ -1572,6 +1585,24 @@ private:
     void UpdateADuty();
     void UpdateBDuty();
 
+    /**
+        Spread the steps of the next sample over the step slots that the DMA
+        will play back after the current ones.
+    **/
+    void UpdateBSlots();
+
+    /**
+        \brief Configure the DMA channel that plays the step slots into the
+        B channel TCC compare buffer on every step timer overflow.
+
+        \param[in] dmaChannel The DMA channel reserved for this connector.
+        \param[in] enable True to start the channel, false to stop it.
+        \param[in] slotMax The step timer period, which is the maximum duty
+        count of a single slot.
+    **/
+    void StepDmaConfigure(DmaChannels dmaChannel, bool enable,
+                          uint32_t slotMax);
+
     /**
           Refresh the Motor on the SysTick time.
     **/
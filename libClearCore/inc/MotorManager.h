@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include "HardwareMapping.h"
 #include "MotorDriver.h"
+#include "StepPulseTiming.h"
 
 namespace ClearCore {
 
@@ -60,9 +61,34 @@ public:
         /**
             Select the fast speed step input rate (2 MHz, 250nS pulse width)
         **/
-        CLOCK_RATE_HIGH
+        CLOCK_RATE_HIGH,
+        /**
+            Select the very fast step input rate (5 MHz, 100nS pulse width).
+            Only accepted in #STEP_OUTPUT_DMA mode; meant for step and
+            direction drives other than ClearPath.
+        **/
+        CLOCK_RATE_VERY_HIGH
     } MotorClockRates;
 
+    /**
+        How the step pulses of a sample time are placed on the step outputs.
+    **/
+    typedef enum {
+        /**
+            All steps of a sample time are sent as one burst at the start of
+            the sample time (default).
+        **/
+        STEP_OUTPUT_BURST,
+        /**
+            The sample time is split into #STEP_PULSE_SLOTS slots and the
+            steps are spread evenly across them. A DMA channel per connector
+            reloads the step count at each slot, so the spacing is done in
+            hardware. Steps are output one sample time later than in
+            #STEP_OUTPUT_BURST mode.
+        **/
+        STEP_OUTPUT_DMA
+    } StepOutputModes;
+
     /**
         Indicates a pair of MotorDriver Connectors.
     **/
@@ -95,6 +121,31 @@ public:
         Initialize hardware and/or internal state.
     **/
     void Initialize();
+
+    /**
+        Called on each step timer overflow from the sample time interrupt.
+
+        \return True if this overflow starts a new sample time.
+    **/
+    bool SampleStart() {
+        if (m_stepOutputMode == STEP_OUTPUT_BURST) {
+            return true;
+        }
+        if (++m_stepSlot < STEP_PULSE_SLOTS) {
+            return false;
+        }
+        m_stepSlot = 0;
+        m_stepSlotHalf ^= 1;
+        return true;
+    }
+
+    /**
+        \return The half of the step slot buffers to be filled in the current
+        sample time.
+    **/
+    uint8_t StepSlotHalf() {
+        return m_stepSlotHalf;
+    }
 #endif
 
     /**
@@ -106,6 +157,9 @@ public:
         \note Setting a HIGH clock rate when using a ClearPath motor may cause
         errors. NORMAL clock rate is recommended for ClearPath motors.
 
+        \note #CLOCK_RATE_VERY_HIGH is only accepted while the step output
+        mode is #STEP_OUTPUT_DMA.
+
         \code{.cpp}
         // Set all MotorDrivers' input clock rate to the high rate
         MotorMgr.MotorInputClocking(MotorManager::CLOCK_RATE_HIGH);
@@ -142,9 +196,51 @@ public:
     **/
     bool MotorModeSet(MotorPair motorPair, Connector::ConnectorModes newMode);
 
+    /**
+        \brief Sets how the step pulses are placed within a sample time.
+
+        In #STEP_OUTPUT_DMA mode the steps of each sample time are spread
+        evenly across the sample in hardware instead of being sent as a
+        burst. Any move in progress is stopped abruptly.
+
+        #STEP_OUTPUT_DMA mode also allows the #CLOCK_RATE_VERY_HIGH step
+        rate, which raises the maximum number of steps per sample time from
+        400 to 1000. Switching back to #STEP_OUTPUT_BURST fails while that
+        rate is selected.
+
+        \note The step timers are shared with the PWM outputs of the
+        MotorDriver connectors, so #STEP_OUTPUT_DMA cannot be used while a
+        connector pair is in one of the PWM modes.
+
+        \code{.cpp}
+        // Spread the step pulses evenly across each sample time
+        MotorMgr.StepOutputModeSet(MotorManager::STEP_OUTPUT_DMA);
+        \endcode
+
+        \param[in] newMode The step output mode to be set.
+
+        \return Success
+    **/
+    bool StepOutputModeSet(StepOutputModes newMode);
+
+    /**
+        \brief Accessor for the current step output mode.
+
+        \return The current step output mode.
+    **/
+    StepOutputModes StepOutputMode() {
+        return m_stepOutputMode;
+    }
+
 protected:
     uint8_t m_gclkIndex;
     MotorClockRates m_clockRate;
+    StepOutputModes m_stepOutputMode;
+    // Step timer counts per sample time at the current clock rate
+    uint32_t m_samplePeriod;
+    // Step timer overflows since the start of the sample in DMA mode
+    volatile uint8_t m_stepSlot;
+    volatile uint8_t m_stepSlotHalf;
     ClearCorePorts m_stepPorts[NUM_MOTOR_PAIRS];
     uint32_t m_stepDataBits[NUM_MOTOR_PAIRS];
     Connector::ConnectorModes m_motorModes[NUM_MOTOR_PAIRS];
@@ -156,6 +252,8 @@ private:
     (500000 / _CLEARCORE_SAMPLE_RATE_HZ * _CLEARCORE_SAMPLE_RATE_HZ)
 #define CPM_CLOCK_RATE_HIGH_HZ \
     (2000000 / _CLEARCORE_SAMPLE_RATE_HZ * _CLEARCORE_SAMPLE_RATE_HZ)
+#define CPM_CLOCK_RATE_VERY_HIGH_HZ \
+    (5000000 / _CLEARCORE_SAMPLE_RATE_HZ * _CLEARCORE_SAMPLE_RATE_HZ)
 
     bool m_initialized;
 
@@ -165,6 +263,20 @@ private:
     MotorManager();
 
     void PinMuxSet();
+
+    /**
+        Reprogram the step timers and the step DMA channels for the current
+        clock rate and step output mode.
+
+        \param[in] clkReq New step carrier frequency, or 0 to keep the
+        current one.
+    **/
+    void StepTimersConfigure(uint32_t clkReq);
+
+    static bool IsPwmMode(Connector::ConnectorModes mode) {
+        return mode == Connector::CPM_MODE_A_DIRECT_B_PWM ||
+               mode == Connector::CPM_MODE_A_PWM_B_PWM;
+    }
 };
 
 } // ClearCore namespace
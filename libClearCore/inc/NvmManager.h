@@ -201,6 +201,68 @@ public:
     **/
     uint32_t SerialNumber();
 
+    /**
+        Erase unit of the data flash area, one NVM block
+    **/
+    static const uint32_t DATA_FLASH_BLOCK_SIZE = NVMCTRL_BLOCK_SIZE;
+
+    /**
+        Program unit of the data flash area, one quad word
+    **/
+    static const uint32_t DATA_FLASH_QUAD_WORD_SIZE = 16;
+
+    /**
+        \brief Size of the main flash area reserved for application data.
+
+        The area is reserved by the linker script with the symbols
+        __data_flash_start__ and __data_flash_end__, block aligned. Placed in
+        the flash bank the program does not run from, erasing and programming
+        it does not stall the CPU.
+
+        \return Size of the area in bytes, 0 if the linker script reserves
+        none
+    **/
+    uint32_t DataFlashSize();
+
+    /**
+        \brief Read from the data flash area
+
+        \param[in] offset byte offset into the area
+        \param[in] lengthInBytes number of bytes to read
+        \param[out] p_data pointer to store read data
+
+        \return True if the range is inside the area
+    **/
+    bool DataFlashRead(uint32_t offset, uint32_t lengthInBytes,
+                       uint8_t *p_data);
+
+    /**
+        \brief Program erased quad words of the data flash area
+
+        \param[in] offset byte offset into the area, quad word aligned
+        \param[in] lengthInBytes number of bytes, a multiple of
+        DATA_FLASH_QUAD_WORD_SIZE
+        \param[in] p_data data to program
+
+        \return True if programmed, false on a bad range, a low supply voltage
+        or an NVM error
+        \note Blocks until the data is programmed. A quad word can only be
+        programmed once after its block was erased.
+    **/
+    bool DataFlashWrite(uint32_t offset, uint32_t lengthInBytes,
+                        uint8_t const *p_data);
+
+    /**
+        \brief Erase one block of the data flash area
+
+        \param[in] offset byte offset of the block into the area
+
+        \return True if erased, false on a bad offset, a low supply voltage or
+        an NVM error
+        \note Blocks until the block is erased, which takes milliseconds.
+    **/
+    bool DataFlashErase(uint32_t offset);
+
     bool FinishNvmWrite() {
         while (m_pageModified || m_writeState != IDLE) {
             if (WriteCacheToNvmProc()) {
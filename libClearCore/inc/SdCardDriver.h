@@ -26,6 +26,11 @@
 
     The class will provide SD card support for data logging, configuration
     files, and disk emulation.
+
+    Cards are accessed in SPI mode as raw 512 byte blocks. Multi-block
+    writes keep the card in one write command across calls, so a stream of
+    blocks is written without the per-command programming overhead of the
+    card.
 **/
 
 #ifndef __SDCARDDRIVER_H__
@@ -46,6 +51,101 @@ class SdCardDriver : public SerialBase {
     friend class SysManager;
 
 public:
+    /**
+        Size of a card block, in bytes.
+    **/
+    static const uint16_t BLOCK_SIZE = 512;
+
+    /**
+        \brief Initialize the card in the reader.
+
+        Runs the SPI mode power-up sequence at 400 kHz, then switches to the
+        full SPI clock. Call again after a card was exchanged.
+
+        \code{.cpp}
+        if (SdCard.CardInit()) {
+            // A card is present and ready for block access
+        }
+        \endcode
+
+        \return True if a card answered and is ready
+    **/
+    bool CardInit();
+
+    /**
+        \brief Check if a card was initialized by CardInit().
+
+        \return True if the card is ready for block access
+    **/
+    bool CardReady() {
+        return m_cardType != CARD_NONE;
+    }
+
+    /**
+        \brief Size of the card.
+
+        \return Number of blocks of the card, 0 if no card is ready
+    **/
+    uint32_t BlockCount() {
+        return m_blockCount;
+    }
+
+    /**
+        \brief Read blocks from the card.
+
+        \param[in] block Number of the first block
+        \param[out] data Destination of \a count * #BLOCK_SIZE bytes
+        \param[in] count Number of blocks
+
+        \return True if all blocks were read
+    **/
+    bool BlocksRead(uint32_t block, uint8_t *data, uint32_t count);
+
+    /**
+        \brief Write blocks to the card in one multi-block write.
+
+        \param[in] block Number of the first block
+        \param[in] data Source of \a count * #BLOCK_SIZE bytes
+        \param[in] count Number of blocks
+
+        \return True if all blocks were accepted by the card
+    **/
+    bool BlocksWrite(uint32_t block, const uint8_t *data, uint32_t count);
+
+    /**
+        \brief Start a stream of contiguous blocks.
+
+        The card stays selected in a multi-block write until WriteStop().
+        No other card access is possible in between.
+
+        \param[in] block Number of the first block of the stream
+        \param[in] count Expected number of blocks, lets the card erase
+        ahead. 0 if unknown.
+
+        \return True if the card accepted the write command
+    **/
+    bool WriteStart(uint32_t block, uint32_t count = 0);
+
+    /**
+        \brief Write the next blocks of a stream.
+
+        The block payloads are sent by DMA.
+
+        \param[in] data Source of \a count * #BLOCK_SIZE bytes
+        \param[in] count Number of blocks
+
+        \return True if all blocks were accepted by the card. A rejected
+        block ends the stream.
+    **/
+    bool WriteData(const uint8_t *data, uint32_t count);
+
+    /**
+        \brief End a stream and wait for the card to program the last block.
+
+        \return True if the card finished without an error
+    **/
+    bool WriteStop();
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         \brief Default constructor so this connector can be a global and
@@ -73,7 +173,28 @@ public:
 #endif // HIDE_FROM_DOXYGEN
 
 private:
+    typedef enum {
+        CARD_NONE,
+        CARD_SD1,   // Version 1 standard capacity, byte addressed
+        CARD_SD2,   // Version 2 standard capacity, byte addressed
+        CARD_SDHC,  // High or extended capacity, block addressed
+    } CardTypes;
+
     uint8_t m_errorCode;
+    CardTypes m_cardType;
+    uint32_t m_blockCount;
+    bool m_writing;
+
+    uint8_t Command(uint8_t cmd, uint32_t arg);
+    uint8_t AppCommand(uint8_t cmd, uint32_t arg);
+    bool WaitReady(uint32_t timeoutMs);
+    bool DataReceive(uint8_t *data, uint16_t length);
+    bool BlockSend(uint8_t token, const uint8_t *data);
+    void Select(bool selected);
+    uint32_t Address(uint32_t block) {
+        return m_cardType == CARD_SDHC ? block : block * BLOCK_SIZE;
+    }
+    bool Fail(uint8_t errorCode);
 
     /**
         Construction, wires in pins and non-volatile info.
@@ -37,6 +37,7 @@
 #include "DmaManager.h"
 #include "ISerial.h"
 #include "PeripheralRoute.h"
+#include "SerialDmaRing.h"
 
 namespace ClearCore {
 
@@ -45,6 +46,17 @@ namespace ClearCore {
 #define SERIAL_BUFFER_SIZE 64
 #endif
 
+/** Size of the UART DMA send and receive rings, in bytes (256). **/
+#ifndef SERIAL_DMA_BUFFER_SIZE
+#define SERIAL_DMA_BUFFER_SIZE 256
+#endif
+
+/** Character times without a received character that make the line idle
+    in UART DMA mode (4, just over the Modbus RTU frame gap). **/
+#ifndef SERIAL_DMA_IDLE_CHARS
+#define SERIAL_DMA_IDLE_CHARS 4
+#endif
+
 /** Serial receive interrupt priority level. **/
 #ifndef SERCOM_NVIC_RX_PRIORITY
 #define SERCOM_NVIC_RX_PRIORITY (static_cast<IRQn_Type>(1))
@@ -472,6 +484,103 @@ public:
     **/
     bool SpiAsyncWaitComplete();
 
+    /**
+        \brief Check for the end of asynchronous transfers without blocking.
+        \return True when all asynchronous transfers are completed.
+    **/
+    bool SpiAsyncComplete();
+
+    // ============================ UART DMA API ===============================
+
+    /**
+        \brief Move UART data with the DMA instead of an interrupt per
+        character.
+
+        Received characters stream into a circular ring and queued characters
+        leave in blocks, so the port costs no interrupt per character. The
+        rings hold #SERIAL_DMA_BUFFER_SIZE bytes. A break is reported as a
+        frame error by ErrorStatusAccum() instead of a #BREAK_DETECTED
+        character. Changing the setting of an open UART port restarts it and
+        drops all buffered data.
+
+        \code{.cpp}
+        if (ConnectorCOM0.UartDma(true)) {
+            // COM-0 moves its UART data with the DMA
+        }
+        \endcode
+
+        \param[in] enable true to use the DMA, false for interrupts
+        \return false if the port has no DMA channels.
+    **/
+    bool UartDma(bool enable);
+
+    /**
+        \brief Return whether the UART data is moved with the DMA.
+
+        \return true if the port is open in UART DMA mode.
+    **/
+    bool UartDma() {
+        return m_uartDma;
+    }
+
+    /**
+        \brief Read up to \a len received characters.
+
+        Works in both UART modes. Does not wait for characters.
+
+        \return The number of characters copied to \a buf.
+    **/
+    int32_t Read(uint8_t *buf, int32_t len);
+
+    /**
+        \brief Queue up to \a len characters to send.
+
+        Works in both UART modes. Does not wait for space.
+
+        \return The number of characters queued.
+    **/
+    int32_t Write(const uint8_t *buf, int32_t len);
+
+    /**
+        \brief Access received characters in place in UART DMA mode.
+
+        Points \a data at the oldest received character. Release the
+        characters with ReadRelease() once they were processed.
+
+        \return The number of characters at \a data, 0 if none or not in
+        UART DMA mode.
+    **/
+    int32_t ReadSpan(const uint8_t *&data);
+
+    /**
+        \brief Release \a len characters accessed with ReadSpan().
+    **/
+    void ReadRelease(int32_t len);
+
+    /**
+        \brief Compose characters to send in place in UART DMA mode.
+
+        Points \a data at free space of the send ring. Queue what was written
+        there with WriteCommit().
+
+        \return The number of characters that fit at \a data, 0 if the ring
+        is full or not in UART DMA mode.
+    **/
+    int32_t WriteSpan(uint8_t *&data);
+
+    /**
+        \brief Queue \a len characters composed with WriteSpan().
+    **/
+    void WriteCommit(int32_t len);
+
+    /**
+        \brief Check for the end of a received message in UART DMA mode.
+
+        \return true once no character arrived for #SERIAL_DMA_IDLE_CHARS
+        character times after the last one.
+    **/
+    bool RxIdle();
+
     // ============================= SETUP API =================================
 
     /**
@@ -626,6 +735,11 @@ protected:
     **/
     void DisableRxcInterruptUart();
 
+    /**
+        Track the UART DMA rings; called once per sample time.
+    **/
+    void UartDmaRefresh();
+
 private:
     // Serial Buffers
     int16_t m_bufferIn[SERIAL_BUFFER_SIZE];
@@ -638,6 +752,14 @@ private:
     // Clear-on-read accumulating error register.
     SerialErrorStatusRegister m_errorRegAccum;
 
+    // UART DMA mode requested and running
+    bool m_uartDmaRequest;
+    volatile bool m_uartDma;
+    // Sample times without a received character that make the line idle
+    uint16_t m_dmaIdleTicks;
+    SerialDmaRx<SERIAL_DMA_BUFFER_SIZE> m_dmaRx;
+    SerialDmaTx<SERIAL_DMA_BUFFER_SIZE> m_dmaTx;
+
     /**
         Enables and disables the SPI connector and waits for the enable
         status to sync properly.
@@ -645,6 +767,34 @@ private:
     void PortEnable(bool initializing = false);
     void PortDisable();
 
+    /**
+        Reset a DMA channel and set it up for the given peripheral trigger.
+    **/
+    static void DmaChannelSetup(DmaChannels channel, uint8_t trigger);
+
+    /**
+        Start the circular receive DMA of the UART DMA mode.
+    **/
+    void UartDmaStart();
+
+    /**
+        Stop both DMA channels of the UART DMA mode.
+    **/
+    void UartDmaStop();
+
+    /**
+        Index of the receive ring the DMA writes next.
+    **/
+    uint16_t UartDmaRxPos() {
+        return SERIAL_DMA_BUFFER_SIZE -
+               DmaManager::BeatsRemaining(m_dmaRxChannel);
+    }
+
+    /**
+        Release a finished transmit block and start the next one.
+    **/
+    void UartDmaTxPump();
+
     /**
         Helper function to get next index in a buffer.
     **/
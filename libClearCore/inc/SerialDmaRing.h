@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __SERIALDMARING_H__
+#define __SERIALDMARING_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// NAME                                                                       *
+//  SerialDmaRx class
+//
+// DESCRIPTION
+///     \brief Receive ring of a UART filled by a circular DMA transfer.
+///
+///     The DMA writes the ring over and over; the caller passes in the
+///     index it writes next, SIZE minus the beats left in the block. The
+///     reader consumes from the head, in place or by copy. Track() is
+///     called at a fixed rate to find overflows and an idle line.
+///
+///     SerialBase points a self-linked DMA descriptor at Buffer() and reads
+///     the write index from the beats left in the write-back descriptor;
+///     UartDmaRefresh() calls Track() every sample time and turns an
+///     overflow into SerialOverflowError.
+//
+template<uint16_t SIZE>
+class SerialDmaRx {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0,
+                  "The ring size must be a power of 2");
+public:
+    SerialDmaRx(void) {
+        Reset();
+    }
+
+    /**
+        \brief Empty the ring for a DMA that starts at index 0.
+    **/
+    void Reset() {
+        m_head = 0;
+        m_last = 0;
+        m_quietTicks = 0;
+        m_idle = false;
+    }
+
+    /**
+        \brief Drop everything received up to \a pos.
+    **/
+    void Discard(uint16_t pos) {
+        m_head = Wrap(pos);
+    }
+
+    /**
+        \return Destination of the DMA, SIZE bytes
+    **/
+    uint8_t *Buffer() {
+        return m_buf;
+    }
+
+    /**
+        \return Bytes received and not consumed yet
+    **/
+    uint16_t Available(uint16_t pos) const {
+        return (Wrap(pos) - m_head) & (SIZE - 1);
+    }
+
+    /**
+        \brief Point \a data at the oldest unread byte.
+
+        \return Bytes readable at \a data without wrapping
+    **/
+    uint16_t Span(uint16_t pos, const uint8_t *&data) const {
+        uint16_t head = m_head;
+        pos = Wrap(pos);
+        data = &m_buf[head];
+        return (pos >= head) ? pos - head : SIZE - head;
+    }
+
+    /**
+        \brief Release \a len bytes read in place through Span().
+    **/
+    void Consume(uint16_t len) {
+        m_head = (m_head + len) & (SIZE - 1);
+    }
+
+    /**
+        \brief Copy up to \a len unread bytes to \a buf and consume them.
+
+        \return Bytes copied
+    **/
+    uint16_t Read(uint16_t pos, uint8_t *buf, uint16_t len) {
+        uint16_t copied = 0;
+        // At most two spans, up to the end of the ring and from its start
+        for (uint8_t part = 0; part < 2 && copied < len; part++) {
+            const uint8_t *data;
+            uint16_t span = Span(pos, data);
+            if (span > len - copied) {
+                span = len - copied;
+            }
+            if (span == 0) {
+                break;
+            }
+            memcpy(buf + copied, data, span);
+            Consume(span);
+            copied += span;
+        }
+        return copied;
+    }
+
+    /**
+        \return The oldest unread byte, or -1 if there is none
+    **/
+    int16_t Peek(uint16_t pos) const {
+        return Available(pos) ? m_buf[m_head] : -1;
+    }
+
+    /**
+        \brief Account for the bytes the DMA wrote since the last call.
+
+        \param[in] pos The index the DMA writes next
+        \param[in] idleTicks Calls without a new byte that make the line idle
+        \return true if unread data was overwritten since the last call
+    **/
+    bool Track(uint16_t pos, uint16_t idleTicks) {
+        pos = Wrap(pos);
+        uint16_t received = (pos - m_last) & (SIZE - 1);
+        uint16_t unread = (m_last - m_head) & (SIZE - 1);
+        m_last = pos;
+        if (received) {
+            m_quietTicks = 0;
+            m_idle = false;
+        }
+        else if (m_quietTicks < idleTicks && ++m_quietTicks >= idleTicks) {
+            m_idle = true;
+        }
+        return unread + received >= SIZE;
+    }
+
+    /**
+        \param[in] pos The index the DMA writes next
+        \return true once the line went quiet after the last received byte
+        and nothing arrived since the last Track()
+    **/
+    bool Idle(uint16_t pos) const {
+        return m_idle && Wrap(pos) == m_last;
+    }
+
+private:
+    uint8_t m_buf[SIZE];
+    // Next byte to read
+    volatile uint16_t m_head;
+    // DMA index at the last Track()
+    uint16_t m_last;
+    uint16_t m_quietTicks;
+    volatile bool m_idle;
+
+    static uint16_t Wrap(uint16_t pos) {
+        return pos & (SIZE - 1);
+    }
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  SerialDmaTx class
+//
+// DESCRIPTION
+///     \brief Transmit ring of a UART drained by DMA block transfers.
+///
+///     The writer fills the ring at the tail, in place or by copy. Next()
+///     hands the longest unwrapped run of queued bytes to the DMA and Done()
+///     releases it once the transfer ended, so the DMA never reads a byte
+///     that the writer may still change.
+///
+///     SerialBase pumps it with interrupts disabled, from the writes of the
+///     application and from the sample time refresh: once the channel has
+///     stopped it calls Done(), then starts the run of Next() as one block.
+//
+template<uint16_t SIZE>
+class SerialDmaTx {
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0,
+                  "The ring size must be a power of 2");
+public:
+    SerialDmaTx(void) {
+        Reset();
+    }
+
+    /**
+        \brief Drop all queued bytes. The DMA must be stopped.
+    **/
+    void Reset() {
+        m_head = 0;
+        m_tail = 0;
+        m_busy = 0;
+    }
+
+    /**
+        \return Bytes that can be queued
+    **/
+    uint16_t Space() const {
+        return (m_head - m_tail - 1) & (SIZE - 1);
+    }
+
+    /**
+        \return Bytes queued or being sent
+    **/
+    uint16_t Pending() const {
+        return (m_tail - m_head) & (SIZE - 1);
+    }
+
+    /**
+        \brief Point \a data at the free space for in place writes.
+
+        \return Bytes writable at \a data without wrapping
+    **/
+    uint16_t Span(uint8_t *&data) {
+        uint16_t head = m_head;
+        uint16_t tail = m_tail;
+        data = &m_buf[tail];
+        // One slot stays free to tell a full ring from an empty one
+        return (head > tail) ? head - tail - 1 :
+               SIZE - tail - (head == 0 ? 1 : 0);
+    }
+
+    /**
+        \brief Queue \a len bytes written in place through Span().
+    **/
+    void Commit(uint16_t len) {
+        m_tail = (m_tail + len) & (SIZE - 1);
+    }
+
+    /**
+        \brief Queue up to \a len bytes from \a buf.
+
+        \return Bytes queued
+    **/
+    uint16_t Write(const uint8_t *buf, uint16_t len) {
+        uint16_t copied = 0;
+        for (uint8_t part = 0; part < 2 && copied < len; part++) {
+            uint8_t *data;
+            uint16_t span = Span(data);
+            if (span > len - copied) {
+                span = len - copied;
+            }
+            if (span == 0) {
+                break;
+            }
+            memcpy(data, buf + copied, span);
+            Commit(span);
+            copied += span;
+        }
+        return copied;
+    }
+
+    /**
+        \brief Take the next block for the DMA if none is in flight.
+
+        \return Bytes to transfer from \a data, 0 if busy or empty
+    **/
+    uint16_t Next(const uint8_t *&data) {
+        if (m_busy) {
+            return 0;
+        }
+        uint16_t head = m_head;
+        uint16_t tail = m_tail;
+        if (head == tail) {
+            return 0;
+        }
+        data = &m_buf[head];
+        m_busy = (tail > head) ? tail - head : SIZE - head;
+        return m_busy;
+    }
+
+    /**
+        \brief Release the block of the last Next() after its transfer.
+    **/
+    void Done() {
+        m_head = (m_head + m_busy) & (SIZE - 1);
+        m_busy = 0;
+    }
+
+    /**
+        \return true while a block is handed to the DMA
+    **/
+    bool Busy() const {
+        return m_busy != 0;
+    }
+
+private:
+    uint8_t m_buf[SIZE];
+    // First byte not yet sent, the start of the block in flight
+    volatile uint16_t m_head;
+    // Next byte to queue
+    volatile uint16_t m_tail;
+    // Bytes of the block in flight
+    volatile uint16_t m_busy;
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __SERIALDMARING_H__
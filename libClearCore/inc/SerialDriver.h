@@ -208,7 +208,9 @@ private:
     /**
         Update connector's state.
     **/
-    void Refresh() override {};
+    void Refresh() override {
+        UartDmaRefresh();
+    }
 }; // SerialDriver
 
 } // ClearCore namespace
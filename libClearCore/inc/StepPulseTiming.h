@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file StepPulseTiming.h
+    \brief Distribution of a sample's step count across the DMA step slots.
+
+    In MotorManager::STEP_OUTPUT_DMA mode each sample time is split into
+    #STEP_PULSE_SLOTS equal slots and a DMA channel reloads the step
+    output's duty count at the start of every slot. This header holds the
+    hardware independent math so it can be built and checked on a host.
+**/
+
+#ifndef __STEPPULSETIMING_H__
+#define __STEPPULSETIMING_H__
+
+#include <stdint.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+/** Number of TCC periods (DMA slots) per sample time in DMA step mode. **/
+#define STEP_PULSE_SLOTS 4
+
+//*****************************************************************************
+// NAME                                                                       *
+//  StepPulseTiming class
+//
+// DESCRIPTION
+///     \brief Spreads the steps of each sample evenly over its slots.
+///
+///     A Bresenham style accumulator carries the sub-slot phase from one
+///     sample to the next so the pulse spacing stays even across sample
+///     boundaries. Each call emits exactly the requested number of steps, so
+///     the position accounting of the StepGenerator (m_stepsSent) is always
+///     matched by the hardware at the end of the sample.
+//
+class StepPulseTiming {
+public:
+    StepPulseTiming() : m_phase(0) {};
+
+    /**
+        Forget the carried phase, e.g. when a move is stopped abruptly.
+    **/
+    void Reset() {
+        m_phase = 0;
+    }
+
+    /**
+        Fill \a slots with the duty counts for the next sample.
+
+        \param[in] steps Steps to emit in the next sample time
+        \param[in] slotMax Largest duty count of one slot (TCC period)
+        \param[out] slots #STEP_PULSE_SLOTS duty counts
+
+        \return The number of steps placed into the slots; only less than
+        \a steps if \a steps exceeds #STEP_PULSE_SLOTS * \a slotMax.
+    **/
+    uint32_t Distribute(uint32_t steps, uint32_t slotMax,
+                        uint32_t *slots) {
+        uint32_t placed = 0;
+        for (uint8_t i = 0; i < STEP_PULSE_SLOTS; i++) {
+            m_phase += steps;
+            uint32_t count = m_phase / STEP_PULSE_SLOTS;
+            m_phase -= count * STEP_PULSE_SLOTS;
+            if (count > slotMax) {
+                count = slotMax;
+            }
+            slots[i] = count;
+            placed += count;
+        }
+        return placed;
+    }
+
+    /**
+        \return The carried sub-slot phase, always less than
+        #STEP_PULSE_SLOTS.
+    **/
+    uint32_t Phase() {
+        return m_phase;
+    }
+
+private:
+    uint32_t m_phase;
+}; // StepPulseTiming
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // __STEPPULSETIMING_H__
@@ -124,6 +124,27 @@ public:
     **/
     void ResetBoard(ResetModes mode = RESET_NORMAL);
 
+    /**
+        \brief Register a function to run at the end of every sample time.
+
+        The function is called from the sample rate interrupt after the
+        connectors and the encoder were updated, so it sees the values of
+        this sample time. It must return well within the sample time.
+
+        \code{.cpp}
+        void MySampleHandler() {
+            // Record ConnectorM0.PositionRefCommanded()
+        }
+
+        SysMgr.SampleCallback(MySampleHandler);
+        \endcode
+
+        \param[in] callback The function to call, nullptr to remove it
+    **/
+    void SampleCallback(voidFuncPtr callback) {
+        m_sampleCallback = callback;
+    }
+
 #ifndef HIDE_FROM_DOXYGEN
     // Ideally these would be private, but they need to be called from C
     // interrupt handler functions that can't be friends without putting them
@@ -135,6 +156,8 @@ public:
 private:
     /// Flag to defer operations until initialized.
     bool m_readyForOperations;
+    /// Function called at the end of every sample time.
+    volatile voidFuncPtr m_sampleCallback;
 
     /**
         Initialize the clock rates and interrupts.
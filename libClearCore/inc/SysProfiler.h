@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file SysProfiler.h
+    \brief Cycle accounting of the ClearCore background processing.
+
+    Splits the fast update (sample rate) and slow update (SysTick) processing
+    into sections and keeps cycle statistics for each of them, so the cost of
+    each MotorDriver, CCIO-8 board or the ADC can be weighed against the
+    sample period.
+**/
+
+#ifndef __SYSPROFILER_H__
+#define __SYSPROFILER_H__
+
+#include <stdint.h>
+#include "SysTiming.h"
+
+/** Number of histogram bins per section. Bin 0 counts zero cycle samples,
+    bin n counts samples of 2^(n-1) to 2^n - 1 cycles and the last bin
+    everything above. **/
+#define PROFILE_HIST_BINS 20
+
+#ifdef __arm__
+#include <sam.h>
+#define PROFILE_CYCLE_COUNT() (DWT->CYCCNT)
+#else
+// Host builds have no DWT; tests advance this counter instead
+namespace ClearCore {
+extern volatile uint32_t ProfileStubCycles;
+}
+#define PROFILE_CYCLE_COUNT() (ClearCore::ProfileStubCycles)
+#endif
+
+namespace ClearCore {
+
+class ISerial;
+
+/**
+    The profiled sections. The fast update sections are measured in the
+    sample rate interrupt, the slow ones in the SysTick interrupt.
+**/
+typedef enum {
+    PROFILE_FAST_TOTAL,     ///< All of the fast update
+    PROFILE_CCIO,           ///< CcioBoardManager::Refresh
+    PROFILE_ADC,            ///< AdcManager::Update
+    PROFILE_STATUS,         ///< StatusManager::Refresh
+    PROFILE_USB,            ///< UsbManager::Refresh
+    PROFILE_INPUTS,         ///< InputManager::UpdateBegin/UpdateEnd
+    PROFILE_CONNECTORS,     ///< Connector refresh except the MotorDrivers
+    PROFILE_MOTORS,         ///< MotorDriver::Refresh of all motors
+    PROFILE_ENCODER,        ///< EncoderInput::Update
+    PROFILE_CALLBACK,       ///< SysManager::SampleCallback function
+    PROFILE_SHIFT_REG,      ///< ShiftRegister::Update
+    PROFILE_SLOW_TOTAL,     ///< All of the slow update
+    PROFILE_SLOW_CCIO,      ///< CcioBoardManager::RefreshSlow
+    PROFILE_SLOW_MOTORS,    ///< MotorDriver::RefreshSlow of all motors
+    PROFILE_SECTION_COUNT   // Keep at end
+} ProfileSections;
+
+/**
+    \brief Cycle statistics of one profiled section.
+**/
+struct ProfileStats {
+    /// Number of recorded samples
+    uint32_t count;
+    /// Fewest cycles of one sample, UINT32_MAX until the first sample
+    uint32_t min;
+    /// Most cycles of one sample
+    uint32_t max;
+    /// Sum of all cycles, for the mean
+    uint64_t sum;
+    /// Samples that took more than \a budget cycles
+    uint32_t overruns;
+    /// Cycle budget of the section, 0 if not checked
+    uint32_t budget;
+    /// Log2 histogram of the cycles per sample
+    uint32_t hist[PROFILE_HIST_BINS];
+
+    /**
+        Clear the statistics, the budget is kept.
+    **/
+    void Reset();
+
+    /**
+        Add one sample of \a cycles to the statistics.
+    **/
+    void Record(uint32_t cycles) {
+        count++;
+        sum += cycles;
+        if (cycles < min) {
+            min = cycles;
+        }
+        if (cycles > max) {
+            max = cycles;
+        }
+        if (budget && cycles > budget) {
+            overruns++;
+        }
+        hist[Bin(cycles)]++;
+    }
+
+    /**
+        \return The mean cycles per sample, 0 without samples.
+    **/
+    uint32_t Mean() const {
+        return count ? static_cast<uint32_t>(sum / count) : 0;
+    }
+
+    /**
+        \return The histogram bin of \a cycles.
+    **/
+    static uint8_t Bin(uint32_t cycles) {
+        uint8_t bin = cycles ? 32 - __builtin_clz(cycles) : 0;
+        return bin < PROFILE_HIST_BINS ? bin : PROFILE_HIST_BINS - 1;
+    }
+};
+
+/**
+    \class SysProfiler
+    \brief ClearCore background processing cycle profiler
+
+    SysManager marks the end of each section of its fast and slow update.
+    The cycles since the previous mark are added to the section and
+    committed to its ProfileStats once per update, so a section that is
+    marked several times (e.g. once per MotorDriver) is accounted as one
+    sample per update.
+
+    \note Cycles spent in higher priority interrupts are counted to the
+    section they interrupt.
+**/
+class SysProfiler {
+    friend class SysManager;
+
+public:
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Public accessor for singleton instance
+    **/
+    static SysProfiler &Instance();
+#endif
+
+    /**
+        \brief Copy the statistics of one section.
+
+        The copy is consistent even if the interrupt updates the section
+        while it is taken.
+
+        \code{.cpp}
+        ProfileStats motors;
+        if (ProfilerMgr.Snapshot(PROFILE_MOTORS, motors)) {
+            // motors.max is the worst case cost of all MotorDrivers
+        }
+        \endcode
+
+        \param[in] section The section to copy.
+        \param[out] stats The statistics of the section.
+
+        \return False if \a section is invalid.
+    **/
+    bool Snapshot(ProfileSections section, ProfileStats &stats);
+
+    /**
+        \brief Set the cycle budget of a section.
+
+        A sample longer than the budget counts as an overrun. The fast
+        update total defaults to the sample period and the slow update total
+        to one millisecond; the other sections are not checked by default.
+
+        \param[in] section The section to set the budget for.
+        \param[in] cycles The budget in CPU cycles, 0 to disable the check.
+    **/
+    void Budget(ProfileSections section, uint32_t cycles);
+
+    /**
+        \brief Clear the statistics of all sections.
+
+        The statistics are cleared by the interrupts at their next update so
+        that no sample is split by the reset.
+    **/
+    void Reset() {
+        m_resetFast = true;
+        m_resetSlow = true;
+    }
+
+    /**
+        \return A short name of the section.
+    **/
+    static const char *SectionName(ProfileSections section);
+
+    /**
+        \brief Write a table of all sections to a serial port.
+
+        \code{.cpp}
+        ProfilerMgr.Dump(ConnectorUsb);
+        \endcode
+
+        \param[in] port The port to print to.
+    **/
+    void Dump(ISerial &port);
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Start of a fast update.
+    **/
+    void FastStart() {
+        m_fastStart = m_fastMark = PROFILE_CYCLE_COUNT();
+    }
+
+    /**
+        End of a fast update section.
+    **/
+    void Mark(ProfileSections section) {
+        uint32_t now = PROFILE_CYCLE_COUNT();
+        m_cycles[section] += now - m_fastMark;
+        m_fastMark = now;
+    }
+
+    /**
+        End of a fast update; commit the fast sections.
+    **/
+    void FastEnd();
+
+    /**
+        Start of a slow update.
+    **/
+    void SlowStart() {
+        m_slowStart = m_slowMark = PROFILE_CYCLE_COUNT();
+    }
+
+    /**
+        End of a slow update section.
+    **/
+    void SlowMark(ProfileSections section) {
+        uint32_t now = PROFILE_CYCLE_COUNT();
+        m_cycles[section] += now - m_slowMark;
+        m_slowMark = now;
+    }
+
+    /**
+        End of a slow update; commit the slow sections.
+    **/
+    void SlowEnd();
+#endif
+
+private:
+    ProfileStats m_stats[PROFILE_SECTION_COUNT];
+    // Cycles of the sections in the update that is in progress
+    uint32_t m_cycles[PROFILE_SECTION_COUNT];
+    uint32_t m_fastStart;
+    uint32_t m_fastMark;
+    uint32_t m_slowStart;
+    uint32_t m_slowMark;
+    // Odd while the fast/slow statistics are being written
+    volatile uint32_t m_fastSeq;
+    volatile uint32_t m_slowSeq;
+    volatile bool m_resetFast;
+    volatile bool m_resetSlow;
+
+    /**
+        Construct
+    **/
+    SysProfiler();
+
+    void Commit(ProfileSections first, ProfileSections last,
+                uint32_t totalCycles, volatile uint32_t &seq,
+                volatile bool &reset);
+}; // SysProfiler
+
+} // ClearCore namespace
+
+#endif // __SYSPROFILER_H__
@@ -34,12 +34,14 @@
 #include "HardwareMapping.h"
 #include "ShiftRegister.h"
 #include "StatusManager.h"
+#include "SysTiming.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
 extern StatusManager &StatusMgr;
+extern SysTiming &TimingMgr;
 AdcManager &AdcMgr = AdcManager::Instance();
 
 constexpr float AdcManager::ADC_INITIAL_FILTER_VALUE_V[ADC_CHANNEL_COUNT];
@@ -48,11 +50,29 @@ constexpr float AdcManager::ADC_CHANNEL_MAX_FLOAT[ADC_CHANNEL_COUNT];
 // Uncomment to generate an interrupt when the ADC result DMA transfer completes
 //#define DEBUG_ADC_RESULT_TIMING
 
+// Below the sample rate interrupt, so that filtering a block never delays it
+#define ADC_BLOCK_INTERRUPT_PRIORITY 5
+
+// Sample length of every conversion, in ADC clock cycles
+#define ADC_SAMPLE_LENGTH 31
+
 /**
     ADC conversion results DMA data destination
 **/
 volatile uint16_t AdcResultsRaw[AdcManager::ADC_CHANNEL_COUNT] = {0};
 
+/**
+    ADC conversion results DMA data destination in the block acquisition
+    mode, two buffers of ADC_BLOCK_SAMPLES sequences that are filled in turn
+**/
+volatile uint16_t AdcBlockResults[2][AdcManager::ADC_BLOCK_SAMPLES]
+[AdcManager::ADC_CHANNEL_COUNT] = {{{0}}};
+
+/**
+    Descriptor of the second block buffer, linked with the base descriptor
+**/
+static DmacDescriptor adcBlockDescriptor __attribute__((aligned(16)));
+
 /**
     ADC channel selection DMA data source structure
 **/
@@ -73,22 +93,52 @@ union adcDSeqCfg {
 #endif
 };
 
-// ADC channel selection DMA data source
-// The first argument is the full INPUTCTRL register value that will be loaded
-// into the ADC
+/**
+    ADC averaging DMA data source structure
+**/
+union adcDSeqAvg {
+    struct {
+        ADC_REFCTRL_Type REFCTRL;     ///< Offset: 0x08 (R/W  8) Not sequenced
+        uint8_t Reserved1;
+        ADC_AVGCTRL_Type AVGCTRL;     ///< Offset: 0x0A (R/W  8) Average Control
+        ADC_SAMPCTRL_Type SAMPCTRL;   ///< Offset: 0x0B (R/W  8) Sample Time
+    } bit;
+    uint32_t reg;
+#ifdef __cplusplus
+    adcDSeqAvg() {
+        reg = 0;
+    }
+#endif
+};
+
+/**
+    ADC DMA sequence entry of one channel
+**/
+struct adcDSeqEntry {
+    adcDSeqCfg input;
+    adcDSeqAvg avg;
+};
+
+// ADC channel inputs
+// Note: index matched to AdcChannels
+static const uint16_t adcMuxPos[AdcManager::ADC_CHANNEL_COUNT] = {
+    ADC_INPUTCTRL_MUXPOS_AIN4,
+    ADC_INPUTCTRL_MUXPOS_AIN5,
+    ADC_INPUTCTRL_MUXPOS_AIN6,
+    ADC_INPUTCTRL_MUXPOS_AIN7,
+    ADC_INPUTCTRL_MUXPOS_AIN8,
+    ADC_INPUTCTRL_MUXPOS_AIN9,
+    ADC_INPUTCTRL_MUXPOS_AIN10,
+    ADC_INPUTCTRL_MUXPOS_AIN11,
+};
+
+// ADC channel selection DMA data source, built by SequenceBuild()
+// Each entry loads INPUTCTRL, CTRLB, AVGCTRL and SAMPCTRL into the ADC so
+// that the resolution and oversampling can differ between the channels.
 // Note: The last position also has the Sequence stop bit enabled
 //       to alert the ADC that the sequence is finished
 // Note: index matched to AdcChannels
-static const adcDSeqCfg adcSequence[AdcManager::ADC_CHANNEL_COUNT] = {
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN4, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN5, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN6, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN7, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN8, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN9, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN10, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN11 | ADC_INPUTCTRL_DSEQSTOP, 0),
-};
+static adcDSeqEntry adcSequence[AdcManager::ADC_CHANNEL_COUNT];
 
 static inline void WaitAdc() {
     while (ADC1->STATUS.bit.ADCBUSY) {
@@ -112,7 +162,23 @@ AdcManager::AdcManager()
       m_AdcResolution(ADC_RESOLUTION_DEFAULT),
       m_AdcResPending(ADC_RESOLUTION_DEFAULT),
       m_AdcTimeoutLimit(ADC_TIMEOUT_DEFAULT),
-      m_AdcBusyCount(0) {}
+      m_AdcBusyCount(0),
+      m_sequencePending(false),
+      m_acqMode(ACQ_MODE_SAMPLE),
+      m_acqModePending(ACQ_MODE_SAMPLE),
+      m_sequenceTimestamp(0),
+      m_resultTimestamp(0),
+      m_blockSample(0),
+      m_blocksStarted(0),
+      m_blocksFiltered(0),
+      m_blockOverruns(0) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        m_decimationPending[i] = 1;
+        m_resultBits[i] = ADC_RESOLUTION_DEFAULT;
+        m_oversampling[i] = 0;
+        m_oversamplingPending[i] = 0;
+    }
+}
 
 /**
     Initialize the ADC to power-up state.
@@ -126,10 +192,21 @@ void AdcManager::Initialize() {
     m_AdcResPending = ADC_RESOLUTION_DEFAULT;
     m_AdcTimeoutLimit = ADC_TIMEOUT_DEFAULT;
     m_AdcBusyCount = 0;
+    m_sequencePending = false;
+    m_acqMode = ACQ_MODE_SAMPLE;
+    m_acqModePending = ACQ_MODE_SAMPLE;
+    m_blockSample = 0;
+    m_blocksStarted = 0;
+    m_blocksFiltered = 0;
+    m_blockOverruns = 0;
 
     // Set default filter constants
     for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
         m_analogFilter[i].Tc_ms(ADC_IIR_FILTER_TC_MS);
+        m_decimator[i].Decimation(1);
+        m_decimationPending[i] = 1;
+        m_oversampling[i] = 0;
+        m_oversamplingPending[i] = 0;
     }
 
     // Configure internal analog inputs: Sdrvr2, Sdrvr3, VBus, 5V Ob monitor
@@ -162,7 +239,7 @@ void AdcManager::Initialize() {
     ADC1->CTRLA.bit.SWRST = 1;
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_SWRST);
 
-    // Configure the ADC read resolution
+    // Configure the ADC read resolution and build the DMA sequence
     AdcResChange();
 
     // Set clock pre-scaler to 4 to result in a clock signal of 48/4 = 12 MHz
@@ -176,8 +253,9 @@ void AdcManager::Initialize() {
     // Setup the DMA input/result transfers
     DmaInit();
 
-    // Update INPUTCTRL from the DMA engine
-    ADC1->DSEQCTRL.bit.INPUTCTRL = 1;
+    // Update INPUTCTRL, CTRLB, AVGCTRL and SAMPCTRL from the DMA engine
+    ADC1->DSEQCTRL.reg |= ADC_DSEQCTRL_INPUTCTRL | ADC_DSEQCTRL_CTRLB |
+                          ADC_DSEQCTRL_AVGCTRL | ADC_DSEQCTRL_SAMPCTRL;
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_INPUTCTRL);
     ADC1->DSEQCTRL.bit.AUTOSTART = 1;
 
@@ -190,7 +268,7 @@ void AdcManager::Initialize() {
     // performed in the background, which results in more reliable readings.
     // Setting the sample length to 31 uses approximately 20% of the available
     // time when doing 8 12-bit readings per 5 kHz interrupt slot.
-    ADC1->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(31);
+    ADC1->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(ADC_SAMPLE_LENGTH);
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_SAMPCTRL);
 
     ADC1->DBGCTRL.bit.DBGRUN = 1;
@@ -218,8 +296,11 @@ void AdcManager::Initialize() {
                        ADC_CHANNEL_MAX_FLOAT[i];
         m_AdcResultsConverted[i] = val;
         m_AdcResultsConvertedFiltered[i] = val;
+        m_AdcResultsDecimated[i] = val;
         m_analogFilter[i].Reset(val);
+        m_decimator[i].Reset(val);
     }
+    m_sequenceTimestamp = TimingMgr.Microseconds();
 
     m_initialized = true;
 }
@@ -232,46 +313,123 @@ void AdcManager::Update() {
         return;
     }
 
+    // In the block acquisition mode the results channel runs continuously,
+    // so the end of the sequence is the end of the conversions
+    DmaChannels busyChannel = (m_acqMode == ACQ_MODE_BLOCK) ?
+                              DMA_ADC_SEQUENCE : DMA_ADC_RESULTS;
+
     // If the previous conversion isn't complete or there are more conversions
     // still to be performed, increment the timeout counter
     if (ADC1->STATUS.bit.ADCBUSY ||
-            DmaManager::Channel(DMA_ADC_RESULTS)->CHCTRLA.bit.ENABLE) {
+            DmaManager::Channel(busyChannel)->CHCTRLA.bit.ENABLE) {
         // If the counter is greater than the timeout, throw an error
         if (++m_AdcBusyCount >= m_AdcTimeoutLimit) {
             m_AdcTimeout = true;
         }
+        if (m_acqMode == ACQ_MODE_SAMPLE) {
+            // Apply IIR filtering even if the ADC values have not been
+            // updated
+            for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+                m_analogFilter[i].Update(m_AdcResultsConverted[i]);
+                m_AdcResultsConvertedFiltered[i] =
+                    m_analogFilter[i].LastOutput();
+            }
+        }
+        return;
     }
-    else {
-        // Clear the error and reset the counter
-        m_AdcBusyCount = 0;
-        m_AdcTimeout = false;
 
-        // Copy the finished results into m_AdcResultsConverted and convert to
-        // Q15
+    // Clear the error and reset the counter
+    m_AdcBusyCount = 0;
+    m_AdcTimeout = false;
+
+    if (m_acqMode == ACQ_MODE_SAMPLE) {
+        // Convert the finished results to Q15 and filter them
+        ResultsProcess(AdcResultsRaw, 1, m_sequenceTimestamp);
+    }
+
+    // Kick off next conversion sequence
+    if (m_AdcResolution != m_AdcResPending) {
+        AdcResChange();
+    }
+    if (m_sequencePending) {
         for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
-            // If HBridgeReset is set, do not update the VSupply value
-            if (i == ADC_VSUPPLY_MON && StatusMgr.StatusRT().bit.HBridgeReset) {
-                continue;
-            }
-            // Normalize the ADC results to a Q15 value
-            m_AdcResultsConverted[i] =
-                AdcResultsRaw[i] << (15 - m_AdcResolution);
+            m_oversampling[i] = m_oversamplingPending[i];
         }
-
-        // Kick off next conversion sequence
-        if (m_AdcResolution != m_AdcResPending) {
-            AdcResChange();
+        SequenceBuild();
+        m_sequencePending = false;
+    }
+    if (m_acqMode != m_acqModePending) {
+        m_acqMode = m_acqModePending;
+        m_blockSample = 0;
+        m_blocksFiltered = m_blocksStarted;
+        DmaResultsInit();
+    }
+    m_shiftRegSnapshot = m_shiftRegPending;
+    m_shiftRegPending = ShiftReg.LastOutput();
+
+    if (m_acqMode == ACQ_MODE_BLOCK) {
+        // Note the start of the last sequence of each block
+        if (++m_blockSample == ADC_BLOCK_SAMPLES) {
+            m_blockSample = 0;
+            m_blockTimestamp[m_blocksStarted & 1] = TimingMgr.Microseconds();
+            m_blocksStarted++;
         }
-        m_shiftRegSnapshot = m_shiftRegPending;
-        m_shiftRegPending = ShiftReg.LastOutput();
-        DmaUpdate();
     }
+    else {
+        m_sequenceTimestamp = TimingMgr.Microseconds();
+    }
+    DmaUpdate();
+}
+
+/**
+    Filter the newest full block buffer
+**/
+void AdcManager::BlockUpdate() {
+    if (m_acqMode != ACQ_MODE_BLOCK) {
+        return;
+    }
+
+    uint32_t started = m_blocksStarted;
+    if (started == m_blocksFiltered) {
+        return;
+    }
+    // Blocks in between have already been overwritten
+    m_blockOverruns += started - m_blocksFiltered - 1;
+    m_blocksFiltered = started;
+
+    uint8_t buffer = (started - 1) & 1;
+    ResultsProcess(AdcBlockResults[buffer][0], ADC_BLOCK_SAMPLES,
+                   m_blockTimestamp[buffer]);
+}
 
-    // Apply IIR filtering even if the ADC values have not been updated
+void AdcManager::ResultsProcess(const volatile uint16_t *raw, uint8_t samples,
+                                uint32_t lastTimestamp) {
     for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
-        m_analogFilter[i].Update(m_AdcResultsConverted[i]);
-        m_AdcResultsConvertedFiltered[i] = m_analogFilter[i].LastOutput();
+        Iir16 &filter = m_analogFilter[i];
+        // If HBridgeReset is set, do not update the VSupply value
+        if (i == ADC_VSUPPLY_MON && StatusMgr.StatusRT().bit.HBridgeReset) {
+            for (uint8_t sample = 0; sample < samples; sample++) {
+                filter.Update(m_AdcResultsConverted[i]);
+            }
+            m_AdcResultsConvertedFiltered[i] = filter.LastOutput();
+            continue;
+        }
+
+        AdcDecimator &decimator = m_decimator[i];
+        if (decimator.Decimation() != m_decimationPending[i]) {
+            decimator.Decimation(m_decimationPending[i]);
+        }
+        if (decimator.Process(raw + i, ADC_CHANNEL_COUNT, samples,
+                              m_resultBits[i], filter)) {
+            m_AdcResultsDecimated[i] = decimator.Decimated();
+            m_decimatedTimestamp[i] = lastTimestamp -
+                                      decimator.Pending() *
+                                      SAMPLE_PERIOD_MICROSECONDS;
+        }
+        m_AdcResultsConverted[i] = decimator.LastResult();
+        m_AdcResultsConvertedFiltered[i] = filter.LastOutput();
     }
+    m_resultTimestamp = lastTimestamp;
 }
 
 /**
@@ -284,50 +442,13 @@ void AdcManager::DmaInit() {
     // to the program-created AdcResultsRaw array. The DMAC needs to
     // move 16-bits(one HWORD) of data(max output from the ADC).
 
-    /***************************************************************
-     * DMA_ADC_RESULTS Channel
-     * Read each ADC result and store it into the AdcResult array.
-     ***************************************************************/
-    DmacChannel *channel;
-    DmacDescriptor *baseDesc;
-    channel = DmaManager::Channel(DMA_ADC_RESULTS);
-    baseDesc = DmaManager::BaseDescriptor(DMA_ADC_RESULTS);
-    // Configure DMA channel 0 to stream results from the ADC
-    // Disable the channel so it can be written to
-    channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
-
-    channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
-    // Wait for the reset to finish
-    while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
-        continue;
-    }
-
-    channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(ADC1_DMAC_ID_RESRDY) |
-                           DMAC_CHCTRLA_TRIGACT_BURST |
-                           DMAC_CHCTRLA_BURSTLEN_SINGLE;
-
-#ifdef DEBUG_ADC_RESULT_TIMING
-    // Enable channel completion interrupts
-    channel->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
-    NVIC_EnableIRQ(static_cast<IRQn_Type>(DMAC_0_IRQn + DMA_ADC_RESULTS));
-#endif
-
-    // Descriptors can work like linked lists. Since this is the only
-    // transfer descriptor for the channel, point to 0 to stop transactions
-    baseDesc->DESCADDR.reg = static_cast<uint32_t>(0);
-    baseDesc->SRCADDR.reg = (uint32_t)&ADC1->RESULT.reg;
-    baseDesc->BTCNT.reg = ADC_CHANNEL_COUNT;
-
-    // End address
-    baseDesc->DSTADDR.reg = (uint32_t)(AdcResultsRaw + ADC_CHANNEL_COUNT);
-    baseDesc->BTCTRL.reg =
-        DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_VALID;
+    DmaResultsInit();
 
     /***************************************************************
      * DMA_ADC_SEQUENCE Channel
      * This tells the ADC what channel to read
      ***************************************************************/
-    channel = DmaManager::Channel(DMA_ADC_SEQUENCE);
+    DmacChannel *channel = DmaManager::Channel(DMA_ADC_SEQUENCE);
     // Disable and reset the channel so it is clean to setup
     channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
     channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
@@ -342,7 +463,7 @@ void AdcManager::DmaInit() {
                            DMAC_CHCTRLA_TRIGACT_BURST |
                            DMAC_CHCTRLA_BURSTLEN_SINGLE;
 
-    baseDesc = DmaManager::BaseDescriptor(DMA_ADC_SEQUENCE);
+    DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(DMA_ADC_SEQUENCE);
     // Descriptors can work like linked lists. Since this is the only
     // transfer descriptor for the channel, point to 0 to stop transactions
     baseDesc->DESCADDR.reg = static_cast<uint32_t>(0);
@@ -350,7 +471,7 @@ void AdcManager::DmaInit() {
     // data before the src addr.
     baseDesc->SRCADDR.reg =
         (reinterpret_cast<uint32_t>(&adcSequence)) + sizeof(adcSequence);
-    baseDesc->BTCNT.reg = ADC_CHANNEL_COUNT;
+    baseDesc->BTCNT.reg = sizeof(adcSequence) / sizeof(uint32_t);
     // The Destination is the ADC register for sequence data.
     // The sequence data is what will be moved into the ADC.
     baseDesc->DSTADDR.reg =
@@ -360,11 +481,94 @@ void AdcManager::DmaInit() {
 }
 
 /**
-    Initialize the DMA engine to stream ADC conversions and results.
+    Configure the results DMA channel for the acquisition mode.
+**/
+void AdcManager::DmaResultsInit() {
+    /***************************************************************
+     * DMA_ADC_RESULTS Channel
+     * Read each ADC result and store it into the AdcResult array.
+     ***************************************************************/
+    DmacChannel *channel = DmaManager::Channel(DMA_ADC_RESULTS);
+    DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(DMA_ADC_RESULTS);
+    IRQn_Type irq = static_cast<IRQn_Type>(DMAC_0_IRQn + DMA_ADC_RESULTS);
+    // Configure DMA channel 0 to stream results from the ADC
+    // Disable the channel so it can be written to
+    channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    while (channel->CHCTRLA.bit.ENABLE) {
+        continue;
+    }
+
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    // Wait for the reset to finish
+    while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
+        continue;
+    }
+
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(ADC1_DMAC_ID_RESRDY) |
+                           DMAC_CHCTRLA_TRIGACT_BURST |
+                           DMAC_CHCTRLA_BURSTLEN_SINGLE;
+    baseDesc->SRCADDR.reg = (uint32_t)&ADC1->RESULT.reg;
+
+    if (m_acqMode == ACQ_MODE_SAMPLE) {
+#ifdef DEBUG_ADC_RESULT_TIMING
+        // Enable channel completion interrupts
+        channel->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+        NVIC_EnableIRQ(irq);
+#else
+        NVIC_DisableIRQ(irq);
+#endif
+
+        // Descriptors can work like linked lists. Since this is the only
+        // transfer descriptor for the channel, point to 0 to stop
+        // transactions
+        baseDesc->DESCADDR.reg = static_cast<uint32_t>(0);
+        baseDesc->BTCNT.reg = ADC_CHANNEL_COUNT;
+
+        // End address
+        baseDesc->DSTADDR.reg = (uint32_t)(AdcResultsRaw + ADC_CHANNEL_COUNT);
+        baseDesc->BTCTRL.reg =
+            DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_VALID;
+        // DmaUpdate() enables the channel for every sequence
+        return;
+    }
+
+    // The two descriptors point at each other so that the channel keeps
+    // alternating between the two block buffers. Each full buffer raises
+    // the channel interrupt, which filters it while the other one fills.
+    // The destination address is the end of the block since it increments.
+    baseDesc->DESCADDR.reg = reinterpret_cast<uint32_t>(&adcBlockDescriptor);
+    baseDesc->BTCNT.reg = ADC_BLOCK_SAMPLES * ADC_CHANNEL_COUNT;
+    baseDesc->DSTADDR.reg = reinterpret_cast<uint32_t>(AdcBlockResults[0]) +
+                            sizeof(AdcBlockResults[0]);
+    baseDesc->BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_DSTINC |
+                           DMAC_BTCTRL_BLOCKACT_INT | DMAC_BTCTRL_VALID;
+
+    adcBlockDescriptor.DESCADDR.reg = reinterpret_cast<uint32_t>(baseDesc);
+    adcBlockDescriptor.SRCADDR.reg = (uint32_t)&ADC1->RESULT.reg;
+    adcBlockDescriptor.BTCNT.reg = ADC_BLOCK_SAMPLES * ADC_CHANNEL_COUNT;
+    adcBlockDescriptor.DSTADDR.reg =
+        reinterpret_cast<uint32_t>(AdcBlockResults[1]) +
+        sizeof(AdcBlockResults[1]);
+    adcBlockDescriptor.BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_HWORD |
+                                    DMAC_BTCTRL_DSTINC |
+                                    DMAC_BTCTRL_BLOCKACT_INT |
+                                    DMAC_BTCTRL_VALID;
+
+    channel->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+    NVIC_SetPriority(irq, ADC_BLOCK_INTERRUPT_PRIORITY);
+    NVIC_EnableIRQ(irq);
+    channel->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+}
+
+/**
+    Start the DMA sequence of the next conversions.
 **/
 void AdcManager::DmaUpdate() {
     // Start channel
-    DmaManager::Channel(DMA_ADC_RESULTS)->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+    if (m_acqMode == ACQ_MODE_SAMPLE) {
+        DmaManager::Channel(DMA_ADC_RESULTS)->CHCTRLA.reg |=
+            DMAC_CHCTRLA_ENABLE;
+    }
     DmaManager::Channel(DMA_ADC_SEQUENCE)->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
 
     // Restart the DMA sequence to the ADC
@@ -408,10 +612,100 @@ bool AdcManager::AdcResChange() {
     }
 
     m_AdcResolution = m_AdcResPending;
+    SequenceBuild();
 
     return true;
 }
 
+void AdcManager::SequenceBuild() {
+    uint16_t resSel;
+    switch (m_AdcResolution) {
+        case 8:
+            resSel = ADC_CTRLB_RESSEL_8BIT;
+            break;
+        case 10:
+            resSel = ADC_CTRLB_RESSEL_10BIT;
+            break;
+        default:
+            resSel = ADC_CTRLB_RESSEL_12BIT;
+            break;
+    }
+
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        uint8_t samplesLog2 = m_oversampling[i];
+        uint16_t inputCtrl = adcMuxPos[i];
+        if (i == ADC_CHANNEL_COUNT - 1) {
+            inputCtrl |= ADC_INPUTCTRL_DSEQSTOP;
+        }
+
+        if (samplesLog2) {
+            // Averaging sums 12-bit conversions into the 16-bit result.
+            // Beyond 16 conversions the ADC shifts the sum back to 16 bits.
+            adcSequence[i].input = adcDSeqCfg(inputCtrl, ADC_CTRLB_RESSEL_16BIT);
+            m_resultBits[i] = 12 + ((samplesLog2 < 4) ? samplesLog2 : 4);
+        }
+        else {
+            adcSequence[i].input = adcDSeqCfg(inputCtrl, resSel);
+            m_resultBits[i] = m_AdcResolution;
+        }
+        adcSequence[i].avg.bit.AVGCTRL.reg =
+            ADC_AVGCTRL_SAMPLENUM(samplesLog2) | ADC_AVGCTRL_ADJRES(0);
+        adcSequence[i].avg.bit.SAMPCTRL.reg =
+            ADC_SAMPCTRL_SAMPLEN(ADC_SAMPLE_LENGTH);
+    }
+}
+
+bool AdcManager::AcquisitionMode(AcquisitionModes mode) {
+    switch (mode) {
+        case ACQ_MODE_SAMPLE:
+        case ACQ_MODE_BLOCK:
+            m_acqModePending = mode;
+            break;
+        default:
+            // Invalid value
+            return false;
+    }
+    // Wait for the change to be applied in the interrupt
+    while (m_acqModePending != m_acqMode) {
+        continue;
+    }
+    return true;
+}
+
+bool AdcManager::Oversampling(AdcChannels adcChannel, uint8_t samplesLog2) {
+    if (adcChannel >= ADC_CHANNEL_COUNT ||
+            samplesLog2 > ADC_OVERSAMPLING_MAX) {
+        return false;
+    }
+
+    // All conversions of the sequence have to finish within a sample time
+    uint16_t conversions = 0;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        conversions += 1 << ((i == adcChannel) ? samplesLog2 :
+                             m_oversamplingPending[i]);
+    }
+    if (conversions > ADC_CONVERSIONS_PER_SAMPLE_MAX) {
+        return false;
+    }
+
+    m_oversamplingPending[adcChannel] = samplesLog2;
+    m_sequencePending = true;
+    // Wait for the change to be applied in the interrupt
+    while (m_sequencePending) {
+        continue;
+    }
+    return true;
+}
+
+bool AdcManager::Decimation(AdcChannels adcChannel, uint16_t samples) {
+    if (adcChannel >= ADC_CHANNEL_COUNT || samples == 0 ||
+            samples > AdcDecimator::DECIMATION_MAX) {
+        return false;
+    }
+    m_decimationPending[adcChannel] = samples;
+    return true;
+}
+
 bool AdcManager::FilterTc(AdcChannels adcChannel,
                           uint16_t tc,
                           FilterUnits theUnits) {
@@ -454,13 +748,11 @@ uint16_t AdcManager::FilterTc(AdcChannels adcChannel,
     }
 }
 
-#ifdef DEBUG_ADC_RESULT_TIMING
-
 extern "C" void DMAC_0_Handler() {
     // DMAC interrupts TERR TCMPL SUSP
     DmaManager::Channel(DMA_ADC_RESULTS)->CHINTFLAG.reg =
         DMAC_CHINTENCLR_TCMPL; // clear interrupt
+    AdcMgr.BlockUpdate();
 }
-#endif
 
 } // ClearCore namespace
\ No newline at end of file
@@ -40,12 +40,10 @@ extern StatusManager &StatusMgr;
 extern volatile uint32_t tickCnt;
 CcioBoardManager &CcioMgr = CcioBoardManager::Instance();
 
-#define MARKER_BYTE (0xCC)
 #define CCIO_REDISCOVER_TIME_TICKS (1000 * MS_TO_SAMPLES)
 
-#if MAX_CCIO_DEVICES != 8
-#error "MAX_CCIO_DEVICES has changed. CcioIoBuf setup needs updating."
-#endif
+static_assert(MAX_CCIO_DEVICES <= CcioLink::BOARDS_MAX,
+              "MAX_CCIO_DEVICES does not fit the CcioLink frames");
 
 /**
     Modifies a specific bit in originalNumber at position to be
@@ -66,15 +64,15 @@ inline uint64_t modifyBit(uint64_t originalNumber, uint8_t position,
 }
 
 /**
-    Reverses the bytes of the given 32-bit value
+    Returns the index of the lowest set bit and clears it.
 
-    \param[in] value Number to be swapped
-    \return Swapped value
+    \param[in,out] bits Bits to visit, must not be 0
+    \return Index of the lowest set bit
 **/
-inline uint32_t reverseBytes(uint32_t value) {
-    uint32_t res = 0;
-    __asm("REV %[result], %[input]" : [result] "=r"(res) : [input] "r"(value));
-    return res;
+inline uint8_t popLowestBit(uint64_t &bits) {
+    uint8_t index = __builtin_ctzll(bits);
+    bits &= bits - 1;
+    return index;
 }
 
 CcioBoardManager &CcioBoardManager::Instance() {
@@ -84,8 +82,10 @@ CcioBoardManager &CcioBoardManager::Instance() {
 
 #ifndef HIDE_FROM_DOXYGEN
 CcioBoardManager::CcioBoardManager()
-    : m_writeBuf(),
-      m_readBuf(),
+    : m_link(),
+      m_probe(),
+      m_probeActive(false),
+      m_discoverBusy(false),
       m_discoverState(CCIO_SEARCH),
       m_serPort(NULL),
       m_ccioCnt(0),
@@ -96,10 +96,12 @@ CcioBoardManager::CcioBoardManager()
       m_filteredInputs(0),
       m_currentOutputs(0),
       m_outputMask(0),
-      m_lastOutputsSwapped(~0),
       m_lastOutputs(0),
       m_outputsWithThrottling(0),
       m_ccioMask(0),
+      m_tripPending(UINT64_MAX),
+      m_filterPending(UINT64_MAX),
+      m_refreshOverruns(0),
       m_pulseActive(0),
       m_pulseValue(0),
       m_pulseStopPending(0),
@@ -131,10 +133,11 @@ void CcioBoardManager::Initialize() {
     m_filteredInputs = 0;
     m_currentOutputs = 0;
     m_outputMask = 0;
-    m_lastOutputsSwapped = ~0ULL;
     m_lastOutputs = 0;
     m_outputsWithThrottling = 0;
     m_ccioMask = 0;
+    m_tripPending = UINT64_MAX;
+    m_filterPending = UINT64_MAX;
     m_pulseActive = 0;
     m_pulseValue = 0;
     m_pulseStopPending = 0;
@@ -193,53 +196,52 @@ void CcioBoardManager::Refresh() {
         return;
     }
 
-    uint64_t mask = 1;
+    uint64_t pending;
 
-    // Refresh pulse counts when pulses are active
+    // Refresh pulse counts of the pins with active pulses
     if (m_pulseActive) {
         uint64_t pulsesEnded = 0;
         uint64_t pulseRise = 0;
         uint64_t pulseFall = 0;
 
-        for (uint8_t i = 0; i < CCIO_PINS_PER_BOARD * m_ccioCnt; i++) {
-            // Pulse out update
-            if (m_pulseActive & mask) {
-                CcioPin &currentPin = m_ccioPins[i];
-                if (!--currentPin.m_pulseTicksRemaining) {
-                    if (m_pulseValue & mask) {
-                        // Turn off the pulse
-                        pulseFall |= mask;
-                        currentPin.m_pulseTicksRemaining =
-                            currentPin.m_pulseOffTicks;
-                        // Increment the counter after a complete cycle
-                        if (++currentPin.m_pulseCounter >=
-                                currentPin.m_pulseStopCount &&
-                                currentPin.m_pulseStopCount) {
-                            pulsesEnded |= mask;
-                        }
-                        // If a stop is pending, handle it now that a cycle has
-                        // completed
-                        if (m_pulseStopPending & mask) {
-                            pulsesEnded |= mask;
-                            m_pulseStopPending &= ~mask;
-                        }
+        pending = m_pulseActive & m_ccioMask;
+        while (pending) {
+            uint8_t i = popLowestBit(pending);
+            uint64_t mask = 1ULL << i;
+            CcioPin &currentPin = m_ccioPins[i];
+            if (!--currentPin.m_pulseTicksRemaining) {
+                if (m_pulseValue & mask) {
+                    // Turn off the pulse
+                    pulseFall |= mask;
+                    currentPin.m_pulseTicksRemaining =
+                        currentPin.m_pulseOffTicks;
+                    // Increment the counter after a complete cycle
+                    if (++currentPin.m_pulseCounter >=
+                            currentPin.m_pulseStopCount &&
+                            currentPin.m_pulseStopCount) {
+                        pulsesEnded |= mask;
+                    }
+                    // If a stop is pending, handle it now that a cycle has
+                    // completed
+                    if (m_pulseStopPending & mask) {
+                        pulsesEnded |= mask;
+                        m_pulseStopPending &= ~mask;
+                    }
+                }
+                else {
+                    // If a stop is pending, stop any upcoming pulses
+                    if (m_pulseStopPending & mask) {
+                        pulsesEnded |= mask;
+                        m_pulseStopPending &= ~mask;
                     }
                     else {
-                        // If a stop is pending, stop any upcoming pulses
-                        if (m_pulseStopPending & mask) {
-                            pulsesEnded |= mask;
-                            m_pulseStopPending &= ~mask;
-                        }
-                        else {
-                            // Turn on the pulse
-                            pulseRise |= mask;
-                            currentPin.m_pulseTicksRemaining =
-                                currentPin.m_pulseOnTicks;
-                        }
+                        // Turn on the pulse
+                        pulseRise |= mask;
+                        currentPin.m_pulseTicksRemaining =
+                            currentPin.m_pulseOnTicks;
                     }
                 }
             }
-            mask <<= 1;
         }
 
         // Update the pulse info with the bits that changed
@@ -253,23 +255,26 @@ void CcioBoardManager::Refresh() {
     if (--m_ccioRefreshDelay) {
         return;
     }
-    else {
-        // Reset delay
-        m_ccioRefreshDelay = m_ccioRefreshRate;
+
+    // Rather than wait for a transfer that has not ended, skip this refresh
+    // and retry at the next sample time
+    if (!m_serPort->SpiAsyncComplete()) {
+        m_refreshOverruns++;
+        m_ccioRefreshDelay = 1;
+        return;
     }
+    // Reset delay
+    m_ccioRefreshDelay = m_ccioRefreshRate;
 
-    // Wait for the previous SPI transfer to complete
-    m_serPort->SpiAsyncWaitComplete();
+    // Ending the frame latches the outputs that were sent with it
     m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_OFF);
 
     // Save the current inputs and the last inputs
     uint64_t lastInputs = m_currentInputs;
+    uint64_t inputs;
 
-    bool markerError =
-        m_readBuf.buf8[MAX_CCIO_DEVICES + m_ccioCnt + 1] != MARKER_BYTE;
-    m_readBuf.buf8[MAX_CCIO_DEVICES + m_ccioCnt + 1] = 0;
-    // Verify that the data read back matches what we had sent
-    if (markerError || m_lastOutputsSwapped ^ m_readBuf.buf64.outputsSwapped) {
+    // Verify the marker and that the outputs read back match what we had sent
+    if (m_link.Receive(inputs) != CcioLink::FRAME_OK) {
         if ((m_consGlitchCnt++ >= MAX_GLITCH_LIM) && (MAX_GLITCH_LIM > 0)) {
             // Announce link broken
             m_ccioLinkBroken = true;
@@ -288,54 +293,98 @@ void CcioBoardManager::Refresh() {
     }
     else {
         m_consGlitchCnt = 0;
-        m_currentInputs =
-            (~m_readBuf.buf64.inputs) >> ((MAX_CCIO_DEVICES - m_ccioCnt)
-                                          * CCIO_PINS_PER_BOARD);
+        m_currentInputs = inputs;
     }
 
-    mask = 1;
-    uint64_t settledChanges = 0;
-    uint64_t changedInputs = lastInputs ^ m_currentInputs;
     uint64_t overloadedOutputSample = m_outputsWithThrottling & ~lastInputs;
-    uint64_t overloadedOutputRT = m_ccioOverloaded;
-    for (uint8_t i = 0; i < CCIO_PINS_PER_BOARD * m_ccioCnt; i++) {
+
+    // Store the last outputs that had been sent
+    m_lastOutputs = m_currentOutputs;
+
+    // Put the current outputs in the next frame and start it right away; the
+    // pins are processed below while the frame shifts through the chain.
+    // Do not assert any bits that are inputs or throttled outputs. Outputs
+    // throttled below are taken out from the next frame on.
+    m_outputsWithThrottling =
+        m_currentOutputs & ~m_throttledOutputs & m_outputMask;
+    m_link.Prepare(m_outputsWithThrottling);
+    m_link.Swap();
+    m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
+    m_serPort->SpiTransferDataAsync(m_link.TxData(), m_link.RxData(),
+                                    m_link.Length());
+
+    // Only the pins that have something to count are visited
+    uint64_t throttled = m_throttledOutputs & m_ccioMask;
+    uint64_t tripping = overloadedOutputSample & ~m_throttledOutputs &
+                        m_ccioMask;
+    uint64_t overloadedOutputRT = m_ccioOverloaded &
+                                  (m_throttledOutputs | overloadedOutputSample);
+
+    // Not overloaded, reset the overload delay timer
+    pending = m_tripPending & m_ccioMask &
+              ~(m_throttledOutputs | overloadedOutputSample);
+    m_tripPending &= ~pending;
+    while (pending) {
+        m_ccioPins[popLowestBit(pending)].m_overloadTripCnt =
+            CCIO_OVERLOAD_TRIP_TICKS;
+    }
+
+    pending = throttled;
+    while (pending) {
+        uint8_t i = popLowestBit(pending);
         CcioPin &currentPin = m_ccioPins[i];
-        if (m_throttledOutputs & mask) {
-            if (!(--currentPin.m_overloadFoldbackCnt)) {
-                // Coming out of foldback, reset the overload
-                // delay timer and restore the pin state
-                m_throttledOutputs &= ~mask;
-                currentPin.m_overloadTripCnt = CCIO_OVERLOAD_TRIP_TICKS;
-            }
-        }
-        // Read filtering update
-        else if (overloadedOutputSample & mask) {
-            // When the overload counter hits zero, signal the overload
-            if (currentPin.m_overloadTripCnt &&
-                    !--currentPin.m_overloadTripCnt) {
-                m_throttledOutputs |= mask;
-                currentPin.m_overloadFoldbackCnt = CCIO_OVERLOAD_FOLDBACK_TICKS;
-                overloadedOutputRT |= mask;
-            }
-        }
-        else {
-            // Not overloaded, reset the overload delay timer
+        if (!(--currentPin.m_overloadFoldbackCnt)) {
+            // Coming out of foldback, reset the overload
+            // delay timer and restore the pin state
+            m_throttledOutputs &= ~(1ULL << i);
+            m_tripPending &= ~(1ULL << i);
             currentPin.m_overloadTripCnt = CCIO_OVERLOAD_TRIP_TICKS;
-            overloadedOutputRT &= ~mask;
         }
+    }
 
-        if (changedInputs & mask) {
-            currentPin.m_filterTicksLeft = currentPin.m_filterLength;
-            if (!currentPin.m_filterLength) {
-                settledChanges |= mask;
-            }
+    m_tripPending |= tripping;
+    pending = tripping;
+    while (pending) {
+        uint8_t i = popLowestBit(pending);
+        CcioPin &currentPin = m_ccioPins[i];
+        // When the overload counter hits zero, signal the overload
+        if (currentPin.m_overloadTripCnt &&
+                !--currentPin.m_overloadTripCnt) {
+            m_throttledOutputs |= 1ULL << i;
+            currentPin.m_overloadFoldbackCnt = CCIO_OVERLOAD_FOLDBACK_TICKS;
+            overloadedOutputRT |= 1ULL << i;
         }
-        else if (currentPin.m_filterTicksLeft &&
-                 !(--currentPin.m_filterTicksLeft)) {
+    }
+
+    // Read filtering update
+    uint64_t settledChanges = 0;
+    uint64_t changedInputs = (lastInputs ^ m_currentInputs) & m_ccioMask;
+
+    pending = m_filterPending & ~changedInputs & m_ccioMask;
+    while (pending) {
+        uint8_t i = popLowestBit(pending);
+        CcioPin &currentPin = m_ccioPins[i];
+        if (currentPin.m_filterTicksLeft &&
+                !(--currentPin.m_filterTicksLeft)) {
             // When we decrement to zero, set the filtered state
-            settledChanges |= mask;
+            settledChanges |= 1ULL << i;
+        }
+        if (!currentPin.m_filterTicksLeft) {
+            m_filterPending &= ~(1ULL << i);
+        }
+    }
+
+    pending = changedInputs;
+    while (pending) {
+        uint8_t i = popLowestBit(pending);
+        CcioPin &currentPin = m_ccioPins[i];
+        currentPin.m_filterTicksLeft = currentPin.m_filterLength;
+        if (!currentPin.m_filterLength) {
+            settledChanges |= 1ULL << i;
+        }
+        else {
+            m_filterPending |= 1ULL << i;
         }
-        mask <<= 1;
     }
 
     // Update the filtered input value with the bits that changed
@@ -354,37 +403,50 @@ void CcioBoardManager::Refresh() {
         // due to a previous overload condition.
         IoOverloadRT(overloadedOutputRT & m_ccioMask);
     }
-
-    // Store the last outputs that had been sent for glitch comparison
-    m_lastOutputsSwapped = m_writeBuf.buf64.outputsSwapped;
-    m_lastOutputs = m_currentOutputs;
-
-    // Put the current outputs in the write buffer
-    // Do not assert any bits that are inputs or throttled outputs
-    m_outputsWithThrottling =
-        m_currentOutputs & ~m_throttledOutputs & m_outputMask;
-    // Outputs are written in reverse byte order so the last byte written
-    // corresponds to the first CCIO-8 in the chain
-    uint64_t outputSwapped =
-        ~((static_cast<uint64_t>(reverseBytes(
-                                     static_cast<uint32_t>(m_outputsWithThrottling))) << 32) |
-          reverseBytes(static_cast<uint32_t>(m_outputsWithThrottling >> 32)));
-    m_writeBuf.buf64.outputsSwapped =
-        outputSwapped >> ((MAX_CCIO_DEVICES - m_ccioCnt) * CCIO_PINS_PER_BOARD);
-    m_writeBuf.buf8[(MAX_CCIO_DEVICES - m_ccioCnt)] = MARKER_BYTE;
-    // Start the SPI transfer
-    m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
-    m_serPort->SpiTransferDataAsync(
-        m_writeBuf.buf8 + (MAX_CCIO_DEVICES - m_ccioCnt),
-        m_readBuf.buf8 + (MAX_CCIO_DEVICES - m_ccioCnt) + 1, 2 * m_ccioCnt + 1);
 }
 
 void CcioBoardManager::RefreshSlow() {
-    if (m_serPort && LinkBroken() && m_autoRediscover &&
-            tickCnt - m_lastDiscoverTime > CCIO_REDISCOVER_TIME_TICKS) {
-        // Reset the discover state and try to remake the broken link network
+    if (m_probeActive) {
+        ProbeStep();
+    }
+    else if (m_serPort && LinkBroken() && m_autoRediscover &&
+             !m_discoverBusy &&
+             tickCnt - m_lastDiscoverTime > CCIO_REDISCOVER_TIME_TICKS) {
+        // Reset the discover state and try to remake the broken link
+        // network, one transfer per call so that the update stays short
         m_discoverState = CCIO_SEARCH;
-        CcioDiscover(m_serPort);
+        m_probe.Start(MAX_FLUSH_ATTEMPTS);
+        m_serPort->SpiAsyncWaitComplete();
+        m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
+        m_serPort->SpiTransferDataAsync(m_probeTx, m_probeRx,
+                                        m_probe.Next(m_probeTx));
+        m_probeActive = true;
+    }
+}
+
+void CcioBoardManager::ProbeStep() {
+    if (!m_serPort->SpiAsyncComplete()) {
+        return;
+    }
+
+    switch (m_probe.Result(m_probeRx)) {
+        case CcioProbe::PROBE_RUNNING:
+            m_serPort->SpiTransferDataAsync(m_probeTx, m_probeRx,
+                                            m_probe.Next(m_probeTx));
+            return;
+        case CcioProbe::PROBE_FOUND:
+            m_probeActive = false;
+            LinkStart(m_probe.Boards());
+            return;
+        case CcioProbe::PROBE_TOO_MANY:
+            m_probeActive = false;
+            LinkFail(true);
+            return;
+        case CcioProbe::PROBE_NO_LINK:
+        default:
+            m_probeActive = false;
+            LinkFail(false);
+            return;
     }
 }
 
@@ -427,6 +489,13 @@ void CcioBoardManager::PinState(ClearCorePins pinNum, bool newState) {
     m_currentOutputs = modifyBit(m_currentOutputs, bitNum, newState);
 }
 
+void CcioBoardManager::OutputsWrite(uint64_t state, uint64_t mask) {
+    // Block the interrupt, the pulses modify the outputs too
+    __disable_irq();
+    m_currentOutputs = (m_currentOutputs & ~mask) | (state & mask);
+    __enable_irq();
+}
+
 void CcioBoardManager::OutputPulsesStart(ClearCorePins pinNum, uint32_t onTime,
         uint32_t offTime, uint16_t pulseCount,
         bool blockUntilDone) {
@@ -500,162 +569,62 @@ uint8_t CcioBoardManager::CcioDiscover(SerialDriver *comInstance) {
         return m_ccioCnt;
     }
 
-    uint8_t numFound = 0;
-    uint8_t flushCnt = 0;
-    bool sendData = true;
-    bool flush0Success = false;
+    // Take over from a rediscover in progress
+    m_discoverBusy = true;
+    m_probeActive = false;
 
     m_serPort = comInstance;
     if (!m_serPort) {
         m_faultLed = ShiftRegister::Masks::SR_NO_FEEDBACK_MASK;
         m_lastDiscoverTime = tickCnt;
+        m_discoverBusy = false;
         return 0;
     }
 
     m_faultLed = m_serPort->m_ledMask;
 
+    m_serPort->SpiAsyncWaitComplete();
     m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
-    while (m_discoverState != CCIO_FOUND) {
-        // Fail after too many attempts
-        if (flushCnt >= MAX_FLUSH_ATTEMPTS) {
-            m_ccioLinkBroken = true;
-            StatusMgr.BlinkCode(
-                BlinkCodeDriver::BLINK_GROUP_DEVICE_ERROR,
-                BlinkCodeDriver::DEVICE_ERROR_CCIO);
-            ShiftReg.LedPattern(m_faultLed,
-                                ShiftRegister::LED_BLINK_CCIO_ONLINE,
-                                false);
-            m_lastDiscoverTime = tickCnt;
-            return 0;
-        }
+    m_probe.Start(MAX_FLUSH_ATTEMPTS);
+    CcioProbe::ProbeStatus status;
+    do {
+        uint8_t len = m_probe.Next(m_probeTx);
+        m_serPort->SpiTransferData(m_probeTx, m_probeRx, len);
+        status = m_probe.Result(m_probeRx);
+    } while (status == CcioProbe::PROBE_RUNNING);
 
-        switch (m_discoverState) {
-            case CCIO_SEARCH:
-                if (sendData) {
-                    // Flush with 1's
-                    FillBuffer(m_writeBuf.buf8, 2 * MAX_CCIO_DEVICES, 0xff);
-                    m_serPort->SpiTransferData(m_writeBuf.buf8, m_readBuf.buf8,
-                                               2 * MAX_CCIO_DEVICES);
-                    sendData = false;
-                }
-                else {
-                    // Check if any 1's got through, otherwise resend 1s
-                    if (!AllEntriesEqual(m_readBuf.buf8,
-                                         2 * MAX_CCIO_DEVICES, 0)) {
-                        m_discoverState = CCIO_TEST;
-                        flushCnt = 0;
-                        flush0Success = false;
-                    }
-                    flushCnt++;
-                    sendData = true;
-                }
-                break;
-            case CCIO_TEST:
-                if (sendData) {
-                    if (!flush0Success) {
-                        // Attempt to flush with 0's
-                        FillBuffer(m_writeBuf.buf8, 2 * MAX_CCIO_DEVICES, 0);
-                        m_serPort->SpiTransferData(m_writeBuf.buf8,
-                                                   m_readBuf.buf8,
-                                                   2 * MAX_CCIO_DEVICES);
-                    }
-                    else {
-                        // Flush with a's, send extra byte to check for too many
-                        // CCIOs
-                        FillBuffer(m_writeBuf.buf8,
-                                   2 * MAX_CCIO_DEVICES + 1, 0xaa);
-                        m_serPort->SpiTransferData(m_writeBuf.buf8,
-                                                   m_readBuf.buf8,
-                                                   2 * MAX_CCIO_DEVICES + 1);
-                    }
-                    sendData = false;
-                }
-                else {
-                    if (!flush0Success) {
-                        // If 0's got through, try again with a's; otherwise
-                        // resend 0's.
-                        if (!AllEntriesEqual(m_readBuf.buf8,
-                                             2 * MAX_CCIO_DEVICES, 0xff)) {
-                            flush0Success = true;
-                        }
-                        flushCnt++;
-                    }
-                    else {
-                        uint8_t i;
-                        bool foundAA = false;
-                        // Count until we see a's
-                        for (i = 0; i < 2 * MAX_CCIO_DEVICES && !foundAA; i++) {
-                            if (m_readBuf.buf8[i] == 0xaa) {
-                                foundAA = true;
-                            }
-                            else {
-                                numFound++;
-                            }
-                        }
-                        if (!foundAA &&
-                                m_readBuf.buf8[2 * MAX_CCIO_DEVICES] != 0xaa) {
-                            // Error state - too many CCIOs
-                            m_ccioCnt = 0;
-                            m_ccioMask = 0;
-                            m_ccioRefreshRate = RefreshRate();
-                            m_ccioLinkBroken = true;
-                            StatusMgr.BlinkCode(
-                                BlinkCodeDriver::BLINK_GROUP_DEVICE_ERROR,
-                                BlinkCodeDriver::DEVICE_ERROR_CCIO);
-                            ShiftReg.LedPattern(m_faultLed,
-                                                ShiftRegister::LED_BLINK_CCIO_ONLINE,
-                                                false);
-                            m_lastDiscoverTime = tickCnt;
-                            return 0;
-                        }
-                        // Break from loop
-                        m_discoverState = CCIO_FOUND;
-                        m_readBuf.Clear();
-                    }
-                    sendData = true;
-                }
-                break;
-            default:
-                break;
-        }
+    uint8_t numFound = 0;
+    if (status == CcioProbe::PROBE_FOUND) {
+        numFound = m_probe.Boards();
+        LinkStart(numFound);
+    }
+    else {
+        LinkFail(status == CcioProbe::PROBE_TOO_MANY);
     }
 
-    // numFound is the number of input and output regs found
-    // so divide by 2 to get CCIO-8 count
-    numFound >>= 1;
-    m_ccioCnt = numFound;
-    m_ccioMask = (1 << (m_ccioCnt * CCIO_PINS_PER_BOARD)) - 1;
-    m_ccioRefreshRate = RefreshRate();
+    m_discoverBusy = false;
+    return numFound;
+}
 
-    if (numFound != 0) {
-        // Store the last outputs that had been sent for glitch comparison
-        m_lastOutputsSwapped =
-            UINT64_MAX >> ((MAX_CCIO_DEVICES - m_ccioCnt) *
-                           CCIO_PINS_PER_BOARD);
-
-        // Clear the outputs so that the CCIOs initialize cleanly
-        m_writeBuf.Clear();
-        m_writeBuf.buf64.outputsSwapped =
-            UINT64_MAX >> ((MAX_CCIO_DEVICES - m_ccioCnt) *
-                           CCIO_PINS_PER_BOARD);
-        m_writeBuf.buf8[MAX_CCIO_DEVICES] = MARKER_BYTE;
-
-        // Start the SPI transfer
-        m_serPort->SpiTransferData(m_writeBuf.buf8 +
-                                   (MAX_CCIO_DEVICES - m_ccioCnt),
-                                   m_readBuf.buf8 +
-                                   (MAX_CCIO_DEVICES - m_ccioCnt) + 1,
-                                   2 * m_ccioCnt + 1);
-        m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_OFF);
-        m_writeBuf.buf8[(MAX_CCIO_DEVICES - m_ccioCnt)] = MARKER_BYTE;
-        m_writeBuf.buf8[MAX_CCIO_DEVICES] = 0;
-        m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
-        m_serPort->SpiTransferData(m_writeBuf.buf8 +
-                                   (MAX_CCIO_DEVICES - m_ccioCnt),
-                                   m_readBuf.buf8 +
-                                   (MAX_CCIO_DEVICES - m_ccioCnt) + 1,
-                                   2 * m_ccioCnt + 1);
-        m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_OFF);
+void CcioBoardManager::LinkStart(uint8_t boards) {
+    m_discoverState = CCIO_FOUND;
+    m_ccioCnt = boards;
+    m_link.Boards(boards);
+    m_ccioMask = m_link.Mask();
+    m_ccioRefreshRate = RefreshRate();
+    // Let the first refresh visit every pin's counters
+    m_tripPending = UINT64_MAX;
+    m_filterPending = UINT64_MAX;
+
+    if (boards != 0) {
+        // Send all outputs off twice so that the CCIOs initialize cleanly and
+        // the first refresh reads back what it expects
+        for (uint8_t i = 0; i < 2; i++) {
+            m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_ON);
+            m_serPort->SpiTransferData(m_link.TxData(), m_link.RxData(),
+                                       m_link.Length());
+            m_serPort->SpiSsMode(SerialBase::CtrlLineModes::LINE_OFF);
+        }
 
         // We are now online and initialized
         m_ccioRefreshDelay = m_ccioRefreshRate;
@@ -668,10 +637,26 @@ uint8_t CcioBoardManager::CcioDiscover(SerialDriver *comInstance) {
     ShiftReg.LedPattern(m_faultLed,
                         ShiftRegister::LED_BLINK_CCIO_ONLINE,
                         !m_ccioLinkBroken && !m_ccioOverloaded &&
-                        (numFound > 0));
+                        (boards > 0));
 
     m_lastDiscoverTime = tickCnt;
-    return numFound;
+}
+
+void CcioBoardManager::LinkFail(bool tooMany) {
+    if (tooMany) {
+        // Error state - too many CCIOs
+        m_ccioCnt = 0;
+        m_ccioMask = 0;
+        m_ccioRefreshRate = RefreshRate();
+    }
+    m_ccioLinkBroken = true;
+    StatusMgr.BlinkCode(
+        BlinkCodeDriver::BLINK_GROUP_DEVICE_ERROR,
+        BlinkCodeDriver::DEVICE_ERROR_CCIO);
+    ShiftReg.LedPattern(m_faultLed,
+                        ShiftRegister::LED_BLINK_CCIO_ONLINE,
+                        false);
+    m_lastDiscoverTime = tickCnt;
 }
 
 void CcioBoardManager::CcioRediscoverEnable(bool enable) {
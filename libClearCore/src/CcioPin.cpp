@@ -127,6 +127,15 @@ bool CcioPin::State(int16_t newState) {
     return success;
 }
 
+void CcioPin::FilterLength(uint16_t samples) {
+    __disable_irq();
+    m_filterLength = samples;
+    m_filterTicksLeft = samples;
+    // Have the next refresh count the new filter down
+    CcioMgr.m_filterPending |= m_dataBit;
+    __enable_irq();
+}
+
 void CcioPin::Filter_ms(uint16_t len) {
     uint32_t samples =
         static_cast<uint32_t>(len) * MS_TO_SAMPLES / CcioMgr.m_ccioRefreshRate;
@@ -92,7 +92,10 @@ void DmaManager::Initialize() {
     DMAC->SWTRIGCTRL.reg &=
         ~((1UL << DMA_ADC_SEQUENCE) | (1UL << DMA_ADC_RESULTS) |
           (1UL << DMA_SERCOM0_SPI_TX) | (1UL << DMA_SERCOM0_SPI_RX) |
-          (1UL << DMA_SERCOM7_SPI_TX) | (1UL << DMA_SERCOM7_SPI_RX));
+          (1UL << DMA_SERCOM7_SPI_TX) | (1UL << DMA_SERCOM7_SPI_RX) |
+          (1UL << DMA_STEP_M0) | (1UL << DMA_STEP_M1) |
+          (1UL << DMA_STEP_M2) | (1UL << DMA_STEP_M3) |
+          (1UL << DMA_SERCOM4_SPI_TX) | (1UL << DMA_SERCOM4_SPI_RX));
 }
 
 DmacChannel *DmaManager::Channel(DmaChannels index) {
@@ -109,4 +112,23 @@ DmacDescriptor *DmaManager::BaseDescriptor(DmaChannels index) {
     return &descriptorBase[index];
 }
 
+DmacDescriptor *DmaManager::WriteBackDescriptor(DmaChannels index) {
+    if (index >= DMA_CHANNEL_COUNT) {
+        return NULL;
+    }
+    return &writeBackDescriptor[index];
+}
+
+uint16_t DmaManager::BeatsRemaining(DmaChannels index) {
+    if (index >= DMA_CHANNEL_COUNT) {
+        return 0;
+    }
+    DMAC_ACTIVE_Type active;
+    active.reg = DMAC->ACTIVE.reg;
+    if (active.bit.ABUSY && active.bit.ID == index) {
+        return active.bit.BTCNT;
+    }
+    return writeBackDescriptor[index].BTCNT.reg;
+}
+
 } // ClearCore namespace
\ No newline at end of file
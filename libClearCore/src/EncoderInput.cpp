@@ -29,6 +29,7 @@
 #include "EncoderInput.h"
 #include "HardwareMapping.h"
 #include "InputManager.h"
+#include "SysManager.h"
 #include "SysTiming.h"
 #include "SysUtils.h"
 #include "atomic_utils.h"
@@ -40,6 +41,8 @@
 namespace ClearCore {
 extern InputManager &InputMgr;
 extern EncoderInput EncoderIn;
+extern SysManager SysMgr;
+extern SysTiming &TimingMgr;
 
 void IndexCallback() {
     PDEC->CTRLBSET.reg = PDEC_CTRLBSET_CMD_READSYNC;
@@ -47,6 +50,10 @@ void IndexCallback() {
     EncoderIn.IndexDetected(PDEC->COUNT.reg);
 }
 
+void RegistrationCallback() {
+    EncoderIn.RegistrationCapture();
+}
+
 int32_t EncoderInput::Position() {
     return atomic_load_n(&m_curPosn) + atomic_load_n(&m_offsetAdjustment);
 }
@@ -55,6 +62,62 @@ int32_t EncoderInput::IndexPosition() {
     return m_indexPosn + atomic_load_n(&m_offsetAdjustment);
 }
 
+int32_t EncoderInput::RegistrationPosition() {
+    return m_latchPosn + atomic_load_n(&m_offsetAdjustment);
+}
+
+int32_t EncoderInput::VelocityFiltered() {
+    // Counts per sample time in Q16 to counts per second
+    return (static_cast<int64_t>(m_velocityFilter.LastOutputQ16()) *
+            _CLEARCORE_SAMPLE_RATE_HZ) >> 16;
+}
+
+bool EncoderInput::RegistrationLatchArm(ClearCorePins pin,
+                                        InputManager::InterruptTrigger trigger) {
+    if (pin < CLEARCORE_PIN_DI6 || pin > CLEARCORE_PIN_A12) {
+        return false;
+    }
+    int8_t extInt = SysMgr.ConnectorByIndex(pin)->ExternalInterrupt();
+    // The index pulse owns its interrupt line
+    if (extInt < 0 || extInt == m_indexInfo->extInt) {
+        return false;
+    }
+
+    RegistrationLatchDisarm();
+    m_latchExtInt = extInt;
+    m_latchArmed = true;
+    // Take the timestamp as close to the edge as the index capture does
+    NVIC_SetPriority((IRQn_Type)(EIC_0_IRQn + extInt),
+                     EIC_INDEX_INTERRUPT_PRIORITY);
+    if (!InputMgr.InterruptHandlerSet(extInt, RegistrationCallback, trigger,
+                                      true, true)) {
+        m_latchArmed = false;
+        return false;
+    }
+    return true;
+}
+
+void EncoderInput::RegistrationLatchDisarm() {
+    if (m_latchExtInt < 0) {
+        return;
+    }
+    InputMgr.InterruptHandlerSet(m_latchExtInt, nullptr);
+    NVIC_SetPriority((IRQn_Type)(EIC_0_IRQn + m_latchExtInt),
+                     EIC_INTERRUPT_PRIORITY);
+    m_latchExtInt = -1;
+    m_latchArmed = false;
+}
+
+void EncoderInput::RegistrationCapture() {
+    uint32_t micros = TimingMgr.Microseconds();
+    PDEC->CTRLBSET.reg = PDEC_CTRLBSET_CMD_READSYNC;
+    SYNCBUSY_WAIT(PDEC, PDEC_SYNCBUSY_COUNT);
+    m_hwLatch = PDEC->COUNT.reg;
+    m_latchMicros = micros;
+    m_latchArmed = false;
+    m_processLatch = true;
+}
+
 int32_t EncoderInput::Position(int32_t newPosn) {
     int32_t newOffset = newPosn - atomic_load_n(&m_curPosn);
     int32_t oldOffset = atomic_exchange_n(&m_offsetAdjustment, newOffset);
@@ -89,6 +152,7 @@ void EncoderInput::Enable(bool isEnabled) {
             m_posnHistory[i] = currentHwPosn;
         }
         m_posnHistoryIndex = 0;
+        m_velocityFilter.Reset(0);
         m_enabled = true;
         __enable_irq();
 
@@ -161,7 +225,17 @@ EncoderInput::EncoderInput()
       m_indexPosn(0),
       m_indexDetected(false),
       m_indexInverted(false),
-      m_stepsLast(0) {
+      m_stepsLast(0),
+      m_velocityFilter(),
+      m_sampleMicros(0),
+      m_latchExtInt(-1),
+      m_latchArmed(false),
+      m_processLatch(false),
+      m_hwLatch(0),
+      m_latchMicros(0),
+      m_latchPosn(0),
+      m_latchCount(0) {
+    m_velocityFilter.Tc_ms(VEL_FILTER_TC_MS);
 }
 
 
@@ -191,8 +265,17 @@ void EncoderInput::Update() {
     PDEC->CTRLBSET.reg = PDEC_CTRLBSET_CMD_READSYNC;
     SYNCBUSY_WAIT(PDEC, PDEC_SYNCBUSY_COUNT);
     int16_t currentHwPosn = PDEC->COUNT.reg;
+    m_sampleMicros = TimingMgr.Microseconds();
     m_stepsLast = currentHwPosn - m_hwPosn;
-    
+    m_velocityFilter.Update(m_stepsLast);
+
+    if (m_processLatch) {
+        m_processLatch = false;
+        m_latchPosn = atomic_load_n(&m_curPosn) +
+                      static_cast<int16_t>(m_hwLatch - m_hwPosn);
+        m_latchCount++;
+    }
+
     m_indexDetected = m_processIndex;
     if (m_processIndex) {
         m_indexPosn = atomic_load_n(&m_curPosn) + m_hwIndex - m_hwPosn;
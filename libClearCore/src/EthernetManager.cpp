@@ -35,12 +35,26 @@
 #include "NvmManager.h"
 #include "SysTiming.h"
 
+// The pbuf pool of the lwIP memory profile (lwipopts.h) holds the frames of
+// the receive screening queues and at least one that the stack works on
+static_assert(PBUF_POOL_SIZE > RX_IO_QUEUE_CNT + RX_OTHER_QUEUE_CNT,
+              "PBUF_POOL_SIZE too small for the receive screening queues");
+
 namespace ClearCore {
 
 extern NvmManager &NvmMgr;
 
 EthernetManager &EthernetMgr = EthernetManager::Instance();
 
+GMAC_RX_DESC EthernetManager::m_rxDesc[RX_BUFF_CNT]
+__attribute__((section(GMAC_RING_SECTION), aligned(8)));
+GMAC_TX_DESC EthernetManager::m_txDesc[TX_BUFF_CNT]
+__attribute__((section(GMAC_RING_SECTION), aligned(8)));
+uint8_t EthernetManager::m_rxBuffer[RX_BUFF_CNT][RX_BUFFER_SIZE]
+__attribute__((section(GMAC_RING_SECTION), aligned(8)));
+uint8_t EthernetManager::m_txBuffer[TX_BUFF_CNT][TX_BUFFER_SIZE]
+__attribute__((section(GMAC_RING_SECTION), aligned(8)));
+
 EthernetManager &EthernetManager::Instance() {
     static EthernetManager *instance = new EthernetManager();
     return *instance;
@@ -60,7 +74,8 @@ EthernetManager::EthernetManager()
       m_portPhyInt(PHY_INT.gpioPort), m_pinPhyInt(PHY_INT.gpioPin),
       m_phyExtInt(PHY_INT.extInt), m_phyLinkUp(false), m_phyRemoteFault(false),
       m_phyInitFailed(false), m_recv(false), m_dhcp(false), m_ethernetActive(false),
-      m_rxBuffIndex(0), m_txBuffIndex(0), m_rxBuffer{0}, m_txBuffer{0},
+      m_rxBuffIndex(0), m_txBuffIndex(0), m_rxScreen(), m_rxQueue(),
+      m_counters(), m_countersMs(0),
       m_retransmissionTimeout(200), m_retransmissionCount(8),
       m_ethernetInterface({}), m_macInterface({}), m_dhcpData(nullptr) { }
 
@@ -82,7 +97,13 @@ void EthernetManager::Initialize() {
     GMAC->DCFGR.bit.FBLDO = 0x04;   // Use INCR4 AHB bursts
     GMAC->DCFGR.bit.RXBMS = 0x03;   // 4 Kbytes receiver packet buffer mem size
     GMAC->DCFGR.bit.TXPBMS = 0x01;  // 4 Kb transmitter packet buffer mem size
-    GMAC->DCFGR.bit.DRBS = 0x02;    // 128 bytes receiver buffer in AHB
+    GMAC->DCFGR.bit.DRBS = RX_BUFFER_SIZE / 64; // RX buffer size in AHB
+#if CLEARCORE_GMAC_CHECKSUM_OFFLOAD
+    // Insert the IP, UDP and TCP checksums of transmitted frames and drop
+    // received frames with bad ones
+    GMAC->DCFGR.bit.TXCOEN = 1;
+    GMAC->NCFGR.bit.RXCOEN = 1;
+#endif
     GMAC->WOL.reg = 0;
     GMAC->IPGS.reg = GMAC_IPGS_FL((0x1 << 8) | 0x1);
 
@@ -444,6 +465,24 @@ bool EthernetManager::DhcpBegin() {
     return dhcpSuccess;
 }
 
+bool EthernetManager::DhcpStart() {
+    struct netif *netif = &m_macInterface;
+    if (m_dhcp) {
+        // Already negotiating or bound, a restart would drop the lease.
+        return true;
+    }
+    if (dhcp_start(netif) != ERR_OK) {
+        return false;
+    }
+    m_dhcpData = netif_dhcp_data(netif);
+    m_dhcp = true;
+    return true;
+}
+
+bool EthernetManager::DhcpBound() {
+    return m_dhcp && dhcp_supplied_address(&m_macInterface) != 0;
+}
+
 void EthernetManager::Setup() {
     // Setup can only occur once.
     if (m_ethernetActive) {
@@ -456,16 +495,69 @@ void EthernetManager::Setup() {
 }
 
 void EthernetManager::Refresh() {
+    // Up to a queue of other frames per call, I/O frames are not limited.
+    m_rxQueue.Round(RX_OTHER_QUEUE_CNT);
     while (true) {
-        // Check for an available packet.
-        struct pbuf *packet = low_level_input(&m_macInterface);
-        if (packet == NULL) {
+        // Screen what arrived meanwhile, so an I/O frame never waits
+        // behind more than the frame in LwIP.
+        RxScreen();
+        struct pbuf *packet;
+        if (!m_rxQueue.Pop(packet)) {
             break;
         }
         // Send the packet as input to LwIP.
         ethernetif_input(&m_macInterface, packet);
     }
+    // Read the statistics before the narrow ones can saturate
+    if (Milliseconds() - m_countersMs >= 1000) {
+        Counters();
+    }
     sys_check_timeouts();
 }
 
+const EthernetManager::MacCounters &EthernetManager::Counters() {
+    m_countersMs = Milliseconds();
+    m_counters.alignmentErrors += GMAC->AE.reg;
+    m_counters.fcsErrors += GMAC->FCSE.reg;
+    m_counters.singleCollisions += GMAC->SCF.reg;
+    m_counters.multipleCollisions += GMAC->MCF.reg;
+    m_counters.deferredFrames += GMAC->DTF.reg;
+    m_counters.lateCollisions += GMAC->LC.reg;
+    m_counters.excessiveCollisions += GMAC->EC.reg;
+    m_counters.txUnderruns += GMAC->TUR.reg;
+    m_counters.carrierSenseErrors += GMAC->CSE.reg;
+    m_counters.oversizeFrames += GMAC->OFR.reg;
+    m_counters.rxOverruns += GMAC->ROE.reg;
+    m_counters.rxResourceErrors += GMAC->RRE.reg;
+    return m_counters;
+}
+
+void EthernetManager::CountersClear() {
+    // Read to clear the registers
+    Counters();
+    memset(&m_counters, 0, sizeof(m_counters));
+}
+
+void EthernetManager::RxScreen() {
+    uint32_t length;
+    const uint8_t *header;
+    while ((header = PacketHeader(&m_ethernetInterface, &length)) != NULL) {
+        GmacRxScreen::Queues queue = m_rxScreen.Classify(header, length);
+        if (m_rxQueue.Full(queue)) {
+            // Give the RX buffers back to the GMAC without a copy.
+            PacketRead(&m_ethernetInterface, NULL, 0);
+            m_rxQueue.Drop(queue);
+            LINK_STATS_INC(link.drop);
+            continue;
+        }
+        struct pbuf *packet = low_level_input(&m_macInterface);
+        if (packet == NULL) {
+            // Out of pbufs, or no frame taken off the ring; screen the rest
+            // on the next Refresh() rather than spin on the same frame.
+            break;
+        }
+        m_rxQueue.Push(queue, packet);
+    }
+}
+
 } // ClearCore namespace
\ No newline at end of file
@@ -144,7 +144,12 @@ MotorDriver::MotorDriver(ShiftRegister::Masks enableMask,
       m_motionCancellingEStop(false),
       m_shiftRegEnableReq(false),
       m_clearFaultState(CLEAR_FAULT_IDLE),
-      m_clearFaultHlfbTimer(0) {
+      m_clearFaultHlfbTimer(0),
+      m_stepDmaActive(false),
+      m_stepSlotMax(0),
+      m_stepTiming(),
+      m_stepSlots(),
+      m_stepDmaDescriptor() {
 
     m_interruptAvail = true;
 
@@ -448,8 +453,14 @@ void MotorDriver::Refresh() {
         StepGenerator::CheckTravelLimits();
 
         m_bDutyCnt = StepGenerator::m_stepsPrevious;
-        // Queue up the steps by writing the B duty value
-        UpdateBDuty();
+        if (m_stepDmaActive) {
+            // Queue up the steps by spreading them over the DMA step slots
+            UpdateBSlots();
+        }
+        else {
+            // Queue up the steps by writing the B duty value
+            UpdateBDuty();
+        }
     }
 }
 
@@ -901,6 +912,13 @@ bool MotorDriver::Mode(ConnectorModes newMode) {
             __disable_irq();
             m_bDutyCnt = 0;
             UpdateBDuty();
+            // Don't replay steps left in the DMA slots from an earlier move
+            for (uint8_t iHalf = 0; iHalf < 2; iHalf++) {
+                for (uint8_t iSlot = 0; iSlot < STEP_PULSE_SLOTS; iSlot++) {
+                    m_stepSlots[iHalf][iSlot] = 0;
+                }
+            }
+            m_stepTiming.Reset();
             // Enable peripheral on port/pin B to use PWM on B only
             PMUX_DISABLE(m_aInfo->gpioPort, m_aInfo->gpioPin);
             PMUX_ENABLE(m_bInfo->gpioPort, m_bInfo->gpioPin);
@@ -942,6 +960,73 @@ void MotorDriver::UpdateBDuty() {
     *m_bTccBuffer = m_bDutyCnt;
 }
 
+void MotorDriver::UpdateBSlots() {
+    m_stepTiming.Distribute(m_bDutyCnt, m_stepSlotMax,
+                            m_stepSlots[MotorMgr.StepSlotHalf()]);
+}
+
+void MotorDriver::StepDmaConfigure(DmaChannels dmaChannel, bool enable,
+                                   uint32_t slotMax) {
+    DmacChannel *channel = DmaManager::Channel(dmaChannel);
+    DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(dmaChannel);
+
+    channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    while (channel->CHCTRLA.bit.ENABLE) {
+        continue;
+    }
+    m_stepDmaActive = false;
+
+    if (!enable) {
+        return;
+    }
+
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    // Wait for reset to complete
+    while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
+        continue;
+    }
+
+    for (uint8_t iHalf = 0; iHalf < 2; iHalf++) {
+        for (uint8_t iSlot = 0; iSlot < STEP_PULSE_SLOTS; iSlot++) {
+            m_stepSlots[iHalf][iSlot] = 0;
+        }
+    }
+    m_stepTiming.Reset();
+    m_stepSlotMax = slotMax;
+
+    // Move one slot into the compare buffer on every overflow of the timer
+    // that drives the B output. The buffered value takes effect on the
+    // following overflow.
+    uint32_t trigger = m_bInfo->tccNum ? TCC1_DMAC_ID_OVF : TCC0_DMAC_ID_OVF;
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(trigger) |
+                           DMAC_CHCTRLA_TRIGACT_BURST |
+                           DMAC_CHCTRLA_BURSTLEN_SINGLE;
+    // A late slot would shift the steps into the next slot
+    channel->CHPRILVL.reg = DMAC_CHPRILVL_PRILVL_LVL3;
+
+    // The two descriptors point at each other so that the channel keeps
+    // alternating between the two halves of the slot buffer.
+    // The source address is the end of the block since it increments.
+    baseDesc->BTCNT.reg = STEP_PULSE_SLOTS;
+    baseDesc->SRCADDR.reg = reinterpret_cast<uint32_t>(m_stepSlots[0]) +
+                            sizeof(m_stepSlots[0]);
+    baseDesc->DSTADDR.reg = reinterpret_cast<uint32_t>(m_bTccBuffer);
+    baseDesc->DESCADDR.reg = reinterpret_cast<uint32_t>(&m_stepDmaDescriptor);
+    baseDesc->BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_WORD | DMAC_BTCTRL_SRCINC |
+                           DMAC_BTCTRL_VALID;
+
+    m_stepDmaDescriptor.BTCNT.reg = STEP_PULSE_SLOTS;
+    m_stepDmaDescriptor.SRCADDR.reg =
+        reinterpret_cast<uint32_t>(m_stepSlots[1]) + sizeof(m_stepSlots[1]);
+    m_stepDmaDescriptor.DSTADDR.reg = reinterpret_cast<uint32_t>(m_bTccBuffer);
+    m_stepDmaDescriptor.DESCADDR.reg = reinterpret_cast<uint32_t>(baseDesc);
+    m_stepDmaDescriptor.BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_WORD |
+                                     DMAC_BTCTRL_SRCINC | DMAC_BTCTRL_VALID;
+
+    m_stepDmaActive = true;
+    channel->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+}
+
 void MotorDriver::RefreshSlow() {
     if (!m_initialized) {
         return;
@@ -27,6 +27,7 @@
 #include "MotorManager.h"
 #include <sam.h>
 #include "AdcManager.h"
+#include "DmaManager.h"
 #include "MotorDriver.h"
 #include "ShiftRegister.h"
 #include "SysConnectors.h"
@@ -38,6 +39,11 @@ namespace ClearCore {
 extern MotorDriver *const MotorConnectors[MOTOR_CON_CNT];
 extern ShiftRegister ShiftReg;
 
+#if ((CPM_CLOCK_RATE_LOW_HZ / _CLEARCORE_SAMPLE_RATE_HZ) % STEP_PULSE_SLOTS) || \
+    ((CPM_CLOCK_RATE_VERY_HIGH_HZ / _CLEARCORE_SAMPLE_RATE_HZ) % STEP_PULSE_SLOTS)
+#error "The step timer period must be a multiple of STEP_PULSE_SLOTS"
+#endif
+
 MotorManager &MotorMgr = MotorManager::Instance();
 
 MotorManager &MotorManager::Instance() {
@@ -51,6 +57,10 @@ MotorManager &MotorManager::Instance() {
 MotorManager::MotorManager()
     : m_gclkIndex(MAIN_INTERRUPT_GCLK_ID),
       m_clockRate(CLOCK_RATE_NORMAL),
+      m_stepOutputMode(STEP_OUTPUT_BURST),
+      m_samplePeriod(0),
+      m_stepSlot(0),
+      m_stepSlotHalf(1),
       m_initialized(false) {
     m_stepPorts[MOTOR_M0M1] =  Mtr_CLK_01.gpioPort;
     m_stepPorts[MOTOR_M2M3] = Mtr_CLK_23.gpioPort;
@@ -84,6 +94,11 @@ bool MotorManager::MotorInputClocking(MotorClockRates newRate) {
         case CLOCK_RATE_HIGH:
             clkReq = CPM_CLOCK_RATE_HIGH_HZ;
             break;
+        case CLOCK_RATE_VERY_HIGH:
+            // Above the ClearPath rates, only with the DMA step output
+            clkReq = CPM_CLOCK_RATE_VERY_HIGH_HZ;
+            modeValid = m_stepOutputMode == STEP_OUTPUT_DMA;
+            break;
         default:
             modeValid = false;
             break;
@@ -95,44 +110,9 @@ bool MotorManager::MotorInputClocking(MotorClockRates newRate) {
 
     // Mode change successful; update the step rate.
     m_clockRate = newRate;
+    m_samplePeriod = clkReq / _CLEARCORE_SAMPLE_RATE_HZ;
 
-    // Configure TCC0 for the step step carrier signal
-    TCC0->CTRLA.bit.ENABLE = 0; // Disable TCC0
-    TCC1->CTRLA.bit.ENABLE = 0; // Disable TCC1
-
-    SYNCBUSY_WAIT(TCC0, TCC_SYNCBUSY_ENABLE);
-    SYNCBUSY_WAIT(TCC1, TCC_SYNCBUSY_ENABLE);
-
-    GClkFreqUpdate(m_gclkIndex, clkReq);
-    int32_t newPeriod = clkReq / _CLEARCORE_SAMPLE_RATE_HZ;
-
-    TCC0->COUNT.reg = 0;
-    TCC1->COUNT.reg = 0;
-
-    // Clear out any pending command
-    for (int8_t iChannel = 0; iChannel < TCC0_CC_NUM; iChannel++) {
-        TCC0->CC[iChannel].reg = 0;
-        TCC0->CCBUF[iChannel].reg = 0;
-    }
-
-    for (int8_t iChannel = 0; iChannel < TCC1_CC_NUM; iChannel++) {
-        TCC1->CC[iChannel].reg = 0;
-        TCC1->CCBUF[iChannel].reg = 0;
-    }
-
-    TCC0->PER.reg = newPeriod - 1;
-    TCC1->PER.reg = newPeriod - 1;
-
-    // Notify the StepGenerators of the new maximum rate
-    for (uint8_t iMotor = 0; iMotor < MOTOR_CON_CNT; iMotor++) {
-        MotorConnectors[iMotor]->StepsPerSampleMaxSet(newPeriod);
-    }
-
-    TCC0->CTRLA.bit.ENABLE = 1; // Enable TCC0
-    TCC1->CTRLA.bit.ENABLE = 1; // Enable TCC1
-
-    SYNCBUSY_WAIT(TCC0, TCC_SYNCBUSY_ENABLE);
-    SYNCBUSY_WAIT(TCC1, TCC_SYNCBUSY_ENABLE);
+    StepTimersConfigure(clkReq);
 
     return true;
 }
@@ -144,6 +124,11 @@ bool MotorManager::MotorModeSet(MotorPair motorPair,
                MotorModeSet(MOTOR_M2M3, newMode);
     }
 
+    // The PWM modes need the full step timer period
+    if (m_stepOutputMode == STEP_OUTPUT_DMA && IsPwmMode(newMode)) {
+        return false;
+    }
+
     switch (newMode) {
         case Connector::CPM_MODE_A_DIRECT_B_DIRECT:
         case Connector::CPM_MODE_STEP_AND_DIR:
@@ -187,6 +172,98 @@ void MotorManager::Initialize() {
     m_initialized = true;
 }
 
+bool MotorManager::StepOutputModeSet(StepOutputModes newMode) {
+    if (newMode == m_stepOutputMode) {
+        return true;
+    }
+
+    switch (newMode) {
+        case STEP_OUTPUT_BURST:
+            if (m_clockRate == CLOCK_RATE_VERY_HIGH) {
+                return false;
+            }
+            break;
+        case STEP_OUTPUT_DMA:
+            for (uint8_t iMotorPair = 0; iMotorPair < NUM_MOTOR_PAIRS;
+                    iMotorPair++) {
+                if (IsPwmMode(m_motorModes[iMotorPair])) {
+                    return false;
+                }
+            }
+            break;
+        default:
+            return false;
+    }
+
+    m_stepOutputMode = newMode;
+    if (m_initialized) {
+        // Steps queued for the old timing can't be carried over
+        for (uint8_t iMotor = 0; iMotor < MOTOR_CON_CNT; iMotor++) {
+            MotorConnectors[iMotor]->MoveStopAbrupt();
+        }
+        StepTimersConfigure(0);
+    }
+    return true;
+}
+
+/**
+    Stop the step timers, reprogram their period for the current step output
+    mode and restart them together with the step DMA channels.
+**/
+void MotorManager::StepTimersConfigure(uint32_t clkReq) {
+    // Configure TCC0 for the step step carrier signal
+    TCC0->CTRLA.bit.ENABLE = 0; // Disable TCC0
+    TCC1->CTRLA.bit.ENABLE = 0; // Disable TCC1
+
+    SYNCBUSY_WAIT(TCC0, TCC_SYNCBUSY_ENABLE);
+    SYNCBUSY_WAIT(TCC1, TCC_SYNCBUSY_ENABLE);
+
+    if (clkReq) {
+        GClkFreqUpdate(m_gclkIndex, clkReq);
+    }
+
+    // In DMA mode the timers overflow once per step slot. TCC0 also
+    // generates the sample time interrupt, which SampleStart() divides back
+    // down to the sample rate.
+    bool dmaMode = m_stepOutputMode == STEP_OUTPUT_DMA;
+    uint32_t timerPeriod = dmaMode ? m_samplePeriod / STEP_PULSE_SLOTS
+                                   : m_samplePeriod;
+
+    TCC0->COUNT.reg = 0;
+    TCC1->COUNT.reg = 0;
+
+    // Clear out any pending command
+    for (int8_t iChannel = 0; iChannel < TCC0_CC_NUM; iChannel++) {
+        TCC0->CC[iChannel].reg = 0;
+        TCC0->CCBUF[iChannel].reg = 0;
+    }
+
+    for (int8_t iChannel = 0; iChannel < TCC1_CC_NUM; iChannel++) {
+        TCC1->CC[iChannel].reg = 0;
+        TCC1->CCBUF[iChannel].reg = 0;
+    }
+
+    TCC0->PER.reg = timerPeriod - 1;
+    TCC1->PER.reg = timerPeriod - 1;
+
+    // Notify the StepGenerators of the new maximum rate and (re)start the
+    // step DMA channels in phase with the timers
+    m_stepSlot = 0;
+    m_stepSlotHalf = 1;
+    for (uint8_t iMotor = 0; iMotor < MOTOR_CON_CNT; iMotor++) {
+        MotorConnectors[iMotor]->StepsPerSampleMaxSet(m_samplePeriod);
+        MotorConnectors[iMotor]->StepDmaConfigure(
+            static_cast<DmaChannels>(DMA_STEP_M0 + iMotor), dmaMode,
+            timerPeriod);
+    }
+
+    TCC0->CTRLA.bit.ENABLE = 1; // Enable TCC0
+    TCC1->CTRLA.bit.ENABLE = 1; // Enable TCC1
+
+    SYNCBUSY_WAIT(TCC0, TCC_SYNCBUSY_ENABLE);
+    SYNCBUSY_WAIT(TCC1, TCC_SYNCBUSY_ENABLE);
+}
+
 /**
     Helper function to control if the step rate signal is active
 **/
@@ -492,6 +492,101 @@ uint32_t NvmManager::SerialNumber() {
     return static_cast<uint32_t>(Int32(NVM_LOC_SERIAL_NUMBER));
 }
 
+// The data flash area is placed by the linker script; without one the
+// symbols resolve to 0 and the area is empty.
+extern "C" {
+extern uint8_t __data_flash_start__[] __attribute__((weak));
+extern uint8_t __data_flash_end__[] __attribute__((weak));
+}
+
+uint32_t NvmManager::DataFlashSize() {
+    return static_cast<uint32_t>(__data_flash_end__ - __data_flash_start__);
+}
+
+bool NvmManager::DataFlashRead(uint32_t offset, uint32_t lengthInBytes,
+                               uint8_t *p_data) {
+    if (offset > DataFlashSize() || lengthInBytes > DataFlashSize() - offset) {
+        return false;
+    }
+    memcpy(p_data, &__data_flash_start__[offset], lengthInBytes);
+    return true;
+}
+
+// Wait for the last NVM command, report whether it failed and clear the
+// error flags for the next one.
+static bool DataFlashCommandDone() {
+    while (NVMCTRL->STATUS.bit.READY == 0) {
+        continue;
+    }
+    bool failed = NVMCTRL->INTFLAG.reg & (NVMCTRL_INTFLAG_ADDRE |
+                                          NVMCTRL_INTFLAG_PROGE |
+                                          NVMCTRL_INTFLAG_LOCKE |
+                                          NVMCTRL_INTFLAG_NVME);
+    NVMCTRL->INTFLAG.reg = NVMCTRL_INTFLAG_MASK;
+    return !failed;
+}
+
+// The Cortex-M cache in front of the flash does not see NVM writes.
+static void InvalidateFlashCache() {
+    CMCC->CTRL.bit.CEN = 0;
+    while (CMCC->SR.bit.CSTS) {
+        continue;
+    }
+    CMCC->MAINT0.reg = CMCC_MAINT0_INVALL;
+    CMCC->CTRL.bit.CEN = 1;
+}
+
+bool NvmManager::DataFlashWrite(uint32_t offset, uint32_t lengthInBytes,
+                                uint8_t const *p_data) {
+    if (offset > DataFlashSize() || lengthInBytes > DataFlashSize() - offset ||
+            offset % DATA_FLASH_QUAD_WORD_SIZE ||
+            lengthInBytes % DATA_FLASH_QUAD_WORD_SIZE) {
+        return false;
+    }
+    // Finish a pending user page write, it uses the same page buffer
+    if (!FinishNvmWrite() || BlockWrite()) {
+        return false;
+    }
+
+    DataFlashCommandDone();
+    NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN;
+    EXEC_CMD(NVMCTRL_CTRLB_CMD_PBC);
+    bool success = DataFlashCommandDone();
+    for (uint32_t i = 0; success && i < lengthInBytes;
+            i += DATA_FLASH_QUAD_WORD_SIZE) {
+        uint32_t quadWord[DATA_FLASH_QUAD_WORD_SIZE / sizeof(uint32_t)];
+        memcpy(quadWord, &p_data[i], sizeof(quadWord));
+        volatile uint32_t *address = reinterpret_cast<volatile uint32_t *>(
+                                         &__data_flash_start__[offset + i]);
+        NVMCTRL->ADDR.reg = reinterpret_cast<uint32_t>(address);
+        // Writes to the flash address land in the page buffer
+        for (uint32_t word = 0; word < 4; word++) {
+            address[word] = quadWord[word];
+        }
+        EXEC_CMD(NVMCTRL_CTRLB_CMD_WQW);
+        success = DataFlashCommandDone();
+    }
+    InvalidateFlashCache();
+    return success;
+}
+
+bool NvmManager::DataFlashErase(uint32_t offset) {
+    if (offset >= DataFlashSize() || offset % DATA_FLASH_BLOCK_SIZE) {
+        return false;
+    }
+    if (!FinishNvmWrite() || BlockWrite()) {
+        return false;
+    }
+
+    DataFlashCommandDone();
+    NVMCTRL->ADDR.reg = reinterpret_cast<uint32_t>(
+                            &__data_flash_start__[offset]);
+    EXEC_CMD(NVMCTRL_CTRLB_CMD_EB);
+    bool success = DataFlashCommandDone();
+    InvalidateFlashCache();
+    return success;
+}
+
 bool NvmManager::BlockWrite() {
     //return StatusManager::Instance().StatusRT().bit.VSupplyUnderVoltage;
     return AdcManager::Instance().ConvertedResult(AdcManager::ADC_VSUPPLY_MON) 
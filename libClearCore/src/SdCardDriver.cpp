@@ -28,11 +28,63 @@
 **/
 
 #include "SdCardDriver.h"
+#include <string.h>
 #include <sam.h>
+#include "SysTiming.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
 
+extern SysTiming &TimingMgr;
+
+// SPI clock during the power-up sequence and after it
+#define SD_INIT_SPEED 400000
+#define SD_SPEED 5000000
+
+#define SD_INIT_TIMEOUT_MS 2000
+#define SD_READ_TIMEOUT_MS 300
+#define SD_WRITE_TIMEOUT_MS 600
+
+// Commands
+#define CMD0 0    // GO_IDLE_STATE
+#define CMD8 8    // SEND_IF_COND
+#define CMD9 9    // SEND_CSD
+#define CMD12 12  // STOP_TRANSMISSION
+#define CMD16 16  // SET_BLOCKLEN
+#define CMD17 17  // READ_SINGLE_BLOCK
+#define CMD18 18  // READ_MULTIPLE_BLOCK
+#define CMD25 25  // WRITE_MULTIPLE_BLOCK
+#define CMD55 55  // APP_CMD
+#define CMD58 58  // READ_OCR
+#define ACMD23 23 // SET_WR_BLK_ERASE_COUNT
+#define ACMD41 41 // SD_SEND_OP_COND
+
+// R1 responses and data tokens
+#define R1_READY_STATE 0x00
+#define R1_IDLE_STATE 0x01
+#define R1_ILLEGAL_COMMAND 0x04
+#define DATA_START_BLOCK 0xFE
+#define WRITE_MULTIPLE_TOKEN 0xFC
+#define STOP_TRAN_TOKEN 0xFD
+#define DATA_RES_MASK 0x1F
+#define DATA_RES_ACCEPTED 0x05
+
+// Error codes, as in the SD library
+#define SD_CARD_ERROR_CMD0 0x01
+#define SD_CARD_ERROR_CMD8 0x02
+#define SD_CARD_ERROR_CMD17 0x03
+#define SD_CARD_ERROR_CMD25 0x05
+#define SD_CARD_ERROR_CMD58 0x06
+#define SD_CARD_ERROR_ACMD23 0x07
+#define SD_CARD_ERROR_ACMD41 0x08
+#define SD_CARD_ERROR_BAD_CSD 0x09
+#define SD_CARD_ERROR_READ 0x0D
+#define SD_CARD_ERROR_READ_REG 0x0E
+#define SD_CARD_ERROR_READ_TIMEOUT 0x0F
+#define SD_CARD_ERROR_STOP_TRAN 0x10
+#define SD_CARD_ERROR_WRITE_MULTIPLE 0x13
+#define SD_CARD_ERROR_WRITE_TIMEOUT 0x15
+
 /**
     Construct and wire into the board.
 **/
@@ -42,10 +94,282 @@ SdCardDriver::SdCardDriver(const PeripheralRoute *misoInfo,
                            const PeripheralRoute *mosiInfo,
                            uint8_t peripheral)
     : SerialBase(misoInfo, ssInfo, sckInfo, mosiInfo, peripheral),
-      m_errorCode(0) {
+      m_errorCode(0),
+      m_cardType(CARD_NONE),
+      m_blockCount(0),
+      m_writing(false) {
     PortMode(SerialBase::SPI);
     SpiClock(SCK_LOW, LEAD_SAMPLE);
     PortOpen();
 }
 
-} // ClearCore namespace
\ No newline at end of file
+bool SdCardDriver::CardInit() {
+    if (m_writing) {
+        WriteStop();
+    }
+    m_cardType = CARD_NONE;
+    m_blockCount = 0;
+    m_errorCode = 0;
+
+    // Reapply the SPI setup, the DMA channels were reset after construction
+    PortMode(SerialBase::SPI);
+    PortOpen();
+    Speed(SD_INIT_SPEED);
+
+    // At least 74 clocks with the card deselected
+    Select(false);
+    for (uint8_t i = 0; i < 10; i++) {
+        SpiTransferData(0xFF);
+    }
+
+    uint32_t start = TimingMgr.Milliseconds();
+    while (Command(CMD0, 0) != R1_IDLE_STATE) {
+        if (TimingMgr.Milliseconds() - start > SD_INIT_TIMEOUT_MS) {
+            return Fail(SD_CARD_ERROR_CMD0);
+        }
+    }
+
+    CardTypes type;
+    // MOSI stays high while the card answers
+    uint8_t response[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    if (Command(CMD8, 0x1AA) & R1_ILLEGAL_COMMAND) {
+        type = CARD_SD1;
+    }
+    else {
+        SpiTransferData(response, response, sizeof(response));
+        if (response[3] != 0xAA) {
+            return Fail(SD_CARD_ERROR_CMD8);
+        }
+        type = CARD_SD2;
+    }
+
+    // Host capacity support for version 2 cards
+    uint32_t arg = type == CARD_SD2 ? 0x40000000 : 0;
+    while (AppCommand(ACMD41, arg) != R1_READY_STATE) {
+        if (TimingMgr.Milliseconds() - start > SD_INIT_TIMEOUT_MS) {
+            return Fail(SD_CARD_ERROR_ACMD41);
+        }
+    }
+
+    if (type == CARD_SD2) {
+        if (Command(CMD58, 0)) {
+            return Fail(SD_CARD_ERROR_CMD58);
+        }
+        memset(response, 0xFF, sizeof(response));
+        SpiTransferData(response, response, sizeof(response));
+        // Card capacity status
+        if ((response[0] & 0xC0) == 0xC0) {
+            type = CARD_SDHC;
+        }
+    }
+    if (type != CARD_SDHC && Command(CMD16, BLOCK_SIZE)) {
+        return Fail(SD_CARD_ERROR_READ_REG);
+    }
+
+    uint8_t csd[16];
+    if (Command(CMD9, 0) || !DataReceive(csd, sizeof(csd))) {
+        return Fail(SD_CARD_ERROR_READ_REG);
+    }
+    Select(false);
+    if ((csd[0] >> 6) == 1) {
+        // CSD version 2: (C_SIZE + 1) * 512 KB
+        uint32_t cSize = ((uint32_t)(csd[7] & 0x3F) << 16) |
+                         ((uint32_t)csd[8] << 8) | csd[9];
+        m_blockCount = (cSize + 1) << 10;
+    }
+    else if ((csd[0] >> 6) == 0) {
+        uint32_t cSize = ((uint32_t)(csd[6] & 0x03) << 10) |
+                         ((uint32_t)csd[7] << 2) | (csd[8] >> 6);
+        uint8_t cSizeMult = ((csd[9] & 0x03) << 1) | (csd[10] >> 7);
+        uint8_t readBlLen = csd[5] & 0x0F;
+        m_blockCount = (cSize + 1) << (cSizeMult + 2 + readBlLen - 9);
+    }
+    else {
+        return Fail(SD_CARD_ERROR_BAD_CSD);
+    }
+
+    Speed(SD_SPEED);
+    m_cardType = type;
+    return true;
+}
+
+bool SdCardDriver::BlocksRead(uint32_t block, uint8_t *data, uint32_t count) {
+    if (!CardReady() || m_writing || !count) {
+        return false;
+    }
+    bool multiple = count > 1;
+    if (Command(multiple ? CMD18 : CMD17, Address(block))) {
+        return Fail(SD_CARD_ERROR_CMD17);
+    }
+    for (uint32_t i = 0; i < count; i++, data += BLOCK_SIZE) {
+        if (!DataReceive(data, BLOCK_SIZE)) {
+            return Fail(SD_CARD_ERROR_READ);
+        }
+    }
+    if (multiple) {
+        Command(CMD12, 0);
+    }
+    Select(false);
+    return true;
+}
+
+bool SdCardDriver::BlocksWrite(uint32_t block, const uint8_t *data,
+                               uint32_t count) {
+    return WriteStart(block, count) && WriteData(data, count) && WriteStop();
+}
+
+bool SdCardDriver::WriteStart(uint32_t block, uint32_t count) {
+    if (!CardReady() || m_writing) {
+        return false;
+    }
+    if (count && AppCommand(ACMD23, count)) {
+        return Fail(SD_CARD_ERROR_ACMD23);
+    }
+    if (Command(CMD25, Address(block))) {
+        return Fail(SD_CARD_ERROR_CMD25);
+    }
+    m_writing = true;
+    return true;
+}
+
+bool SdCardDriver::WriteData(const uint8_t *data, uint32_t count) {
+    if (!m_writing) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++, data += BLOCK_SIZE) {
+        // The card programs the previous block while the CPU is released
+        if (!WaitReady(SD_WRITE_TIMEOUT_MS)) {
+            m_writing = false;
+            return Fail(SD_CARD_ERROR_WRITE_TIMEOUT);
+        }
+        if (!BlockSend(WRITE_MULTIPLE_TOKEN, data)) {
+            m_writing = false;
+            return Fail(SD_CARD_ERROR_WRITE_MULTIPLE);
+        }
+    }
+    return true;
+}
+
+bool SdCardDriver::WriteStop() {
+    if (!m_writing) {
+        return false;
+    }
+    m_writing = false;
+    if (!WaitReady(SD_WRITE_TIMEOUT_MS)) {
+        return Fail(SD_CARD_ERROR_STOP_TRAN);
+    }
+    SpiTransferData(STOP_TRAN_TOKEN);
+    // One byte before the card signals busy
+    SpiTransferData(0xFF);
+    if (!WaitReady(SD_WRITE_TIMEOUT_MS)) {
+        return Fail(SD_CARD_ERROR_STOP_TRAN);
+    }
+    Select(false);
+    return true;
+}
+
+/**
+    Send a command and return its R1 response. Leaves the card selected.
+**/
+uint8_t SdCardDriver::Command(uint8_t cmd, uint32_t arg) {
+    Select(true);
+    if (cmd != CMD0) {
+        WaitReady(SD_READ_TIMEOUT_MS);
+    }
+    uint8_t frame[6] = {
+        static_cast<uint8_t>(0x40 | cmd),
+        static_cast<uint8_t>(arg >> 24),
+        static_cast<uint8_t>(arg >> 16),
+        static_cast<uint8_t>(arg >> 8),
+        static_cast<uint8_t>(arg),
+        // Only CMD0 and CMD8 are checked before CRC checking is off
+        static_cast<uint8_t>(cmd == CMD0 ? 0x95 : cmd == CMD8 ? 0x87 : 0x01)
+    };
+    SpiTransferData(frame, nullptr, sizeof(frame));
+    if (cmd == CMD12) {
+        // Skip the stuff byte
+        SpiTransferData(0xFF);
+    }
+
+    uint8_t response = 0xFF;
+    for (uint8_t i = 0; i < 8 && (response & 0x80); i++) {
+        response = SpiTransferData(0xFF);
+    }
+    return response;
+}
+
+uint8_t SdCardDriver::AppCommand(uint8_t cmd, uint32_t arg) {
+    Command(CMD55, 0);
+    return Command(cmd, arg);
+}
+
+bool SdCardDriver::WaitReady(uint32_t timeoutMs) {
+    uint32_t start = TimingMgr.Milliseconds();
+    while (SpiTransferData(0xFF) != 0xFF) {
+        if (TimingMgr.Milliseconds() - start > timeoutMs) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+    Receive a data block after its start token, and skip its CRC.
+**/
+bool SdCardDriver::DataReceive(uint8_t *data, uint16_t length) {
+    uint32_t start = TimingMgr.Milliseconds();
+    uint8_t token;
+    while ((token = SpiTransferData(0xFF)) == 0xFF) {
+        if (TimingMgr.Milliseconds() - start > SD_READ_TIMEOUT_MS) {
+            Select(false);
+            m_errorCode = SD_CARD_ERROR_READ_TIMEOUT;
+            return false;
+        }
+    }
+    if (token != DATA_START_BLOCK) {
+        Select(false);
+        return false;
+    }
+    // Send 0xFF from the destination, each byte is sent before it is
+    // overwritten by the byte received
+    memset(data, 0xFF, length);
+    if (length == BLOCK_SIZE && SpiTransferDataAsync(data, data, length)) {
+        SpiAsyncWaitComplete();
+    }
+    else {
+        SpiTransferData(data, data, length);
+    }
+    SpiTransferData(0xFF);
+    SpiTransferData(0xFF);
+    return true;
+}
+
+/**
+    Send one block with its token and a dummy CRC, by DMA.
+**/
+bool SdCardDriver::BlockSend(uint8_t token, const uint8_t *data) {
+    SpiTransferData(token);
+    if (!SpiTransferDataAsync(data, nullptr, BLOCK_SIZE)) {
+        SpiTransferData(data, nullptr, BLOCK_SIZE);
+    }
+    SpiAsyncWaitComplete();
+    SpiTransferData(0xFF);
+    SpiTransferData(0xFF);
+    return (SpiTransferData(0xFF) & DATA_RES_MASK) == DATA_RES_ACCEPTED;
+}
+
+void SdCardDriver::Select(bool selected) {
+    SpiSsMode(selected ? SerialBase::LINE_ON : SerialBase::LINE_OFF);
+    if (!selected) {
+        // Let the card release MISO
+        SpiTransferData(0xFF);
+    }
+}
+
+bool SdCardDriver::Fail(uint8_t errorCode) {
+    m_errorCode = errorCode;
+    Select(false);
+    return false;
+}
+
+} // ClearCore namespace
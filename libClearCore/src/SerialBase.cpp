@@ -79,7 +79,10 @@ SerialBase::SerialBase(const PeripheralRoute *ctsMisoInfo,
       m_dmaTxChannel(DMA_INVALID_CHANNEL),
       m_bufferIn{0}, m_bufferOut{0},
       m_inHead(0), m_inTail(0),
-      m_outHead(0), m_outTail(0) {
+      m_outHead(0), m_outTail(0),
+      m_uartDmaRequest(false),
+      m_uartDma(false),
+      m_dmaIdleTicks(1) {
     static Sercom *const sercom_instances[SERCOM_INST_NUM] = SERCOM_INSTS;
     m_serPort = sercom_instances[ctsMisoInfo->sercomNum];
 }
@@ -124,6 +127,7 @@ void SerialBase::PortClose() {
 
         DATA_DIRECTION_INPUT(m_rtsSsInfo->gpioPort, 1L << m_rtsSsInfo->gpioPin);
         PortDisable();
+        UartDmaStop();
         m_portOpen = false;
     }
 }
@@ -242,6 +246,8 @@ bool SerialBase::PortMode(PortModes newMode) {
         return true;
     }
 
+    UartDmaStop();
+
     SercomUsart *usart = &m_serPort->USART;
     // Reset port to power-on state and force port to "disable"
     usart->CTRLA.bit.SWRST = 1;
@@ -278,8 +284,10 @@ bool SerialBase::PortMode(PortModes newMode) {
         IdNvic = SERCOM3_0_IRQn;
     }
     else if (m_serPort == SERCOM4) {
-        m_dmaRxChannel = DMA_INVALID_CHANNEL;
-        m_dmaTxChannel = DMA_INVALID_CHANNEL;
+        m_dmaRxChannel = DMA_SERCOM4_SPI_RX;
+        m_dmaTxChannel = DMA_SERCOM4_SPI_TX;
+        dmaRxTrigger = SERCOM4_DMAC_ID_RX;
+        dmaTxTrigger = SERCOM4_DMAC_ID_TX;
         clockId = SERCOM4_GCLK_ID_CORE;
         IdNvic = SERCOM4_0_IRQn;
     }
@@ -356,40 +364,15 @@ bool SerialBase::PortMode(PortModes newMode) {
             // Setup the DMA descriptors to perform asynchronous SPI transfers
             if (m_dmaRxChannel != DMA_INVALID_CHANNEL &&
                     m_dmaTxChannel != DMA_INVALID_CHANNEL) {
-                DmacChannel *channel;
                 DmacDescriptor *baseDesc;
-                // Rx channel setup
-                channel = DmaManager::Channel(m_dmaRxChannel);
-                // Disable and reset the channel so it is clean to setup
-                channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
-                channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
-                // Wait for the reset to finish
-                while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
-                    continue;
-                }
-
-                channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(dmaRxTrigger) |
-                                       DMAC_CHCTRLA_TRIGACT_BURST |
-                                       DMAC_CHCTRLA_BURSTLEN_SINGLE;
+                DmaChannelSetup(m_dmaRxChannel, dmaRxTrigger);
 
                 // Set up the Rx source descriptor since that will not change
                 baseDesc = DmaManager::BaseDescriptor(m_dmaRxChannel);
                 baseDesc->DESCADDR.reg = static_cast<uint32_t>(0);
                 baseDesc->SRCADDR.reg = (uint32_t)&m_serPort->SPI.DATA.reg;
 
-                // Tx channel setup
-                channel = DmaManager::Channel(m_dmaTxChannel);
-                // Disable and reset the channel so it is clean to setup
-                channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
-                channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
-                // Wait for the reset to finish
-                while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
-                    continue;
-                }
-
-                channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(dmaTxTrigger) |
-                                       DMAC_CHCTRLA_TRIGACT_BURST |
-                                       DMAC_CHCTRLA_BURSTLEN_SINGLE;
+                DmaChannelSetup(m_dmaTxChannel, dmaTxTrigger);
 
                 // Set up the Tx dest descriptor since that will not change
                 baseDesc = DmaManager::BaseDescriptor(m_dmaTxChannel);
@@ -440,9 +423,19 @@ bool SerialBase::PortMode(PortModes newMode) {
             // 0x0 Disables start of frame detection
             usart->CTRLB.bit.SFDE = 0;
 
-            // Enable Error (ERROR) and Receive complete (RXC) interrupts
-            usart->INTENSET.reg =
-                SERCOM_USART_INTENSET_RXC |  SERCOM_USART_INTENSET_ERROR;
+            if (m_uartDmaRequest && m_dmaRxChannel != DMA_INVALID_CHANNEL &&
+                    m_dmaTxChannel != DMA_INVALID_CHANNEL) {
+                // The DMA moves the data, only errors interrupt
+                DmaChannelSetup(m_dmaRxChannel, dmaRxTrigger);
+                DmaChannelSetup(m_dmaTxChannel, dmaTxTrigger);
+                UartDmaStart();
+                usart->INTENSET.reg = SERCOM_USART_INTENSET_ERROR;
+            }
+            else {
+                // Enable Error (ERROR) and Receive complete (RXC) interrupts
+                usart->INTENSET.reg =
+                    SERCOM_USART_INTENSET_RXC |  SERCOM_USART_INTENSET_ERROR;
+            }
 
             // Sync CTRLB
             SYNCBUSY_WAIT(usart, SERCOM_USART_SYNCBUSY_CTRLB);
@@ -508,6 +501,8 @@ bool SerialBase::PortMode(PortModes newMode) {
 bool SerialBase::Speed(uint32_t bitsPerSecond) {
     bool success = true;
     m_baudRate = bitsPerSecond;
+    m_dmaIdleTicks = max(1, (SampleRateHz * 10 * SERIAL_DMA_IDLE_CHARS +
+                             bitsPerSecond - 1) / bitsPerSecond);
     bool sercomEnabled = m_serPort->USART.CTRLA.bit.ENABLE;
     PortDisable();
 
@@ -652,6 +647,18 @@ void SerialBase::DataOrder(DataOrders newOrder) {
     Flush transmit buffers.
 **/
 void SerialBase::Flush() {
+    if (m_uartDma) {
+        // Abort the block in flight before the ring is emptied
+        __disable_irq();
+        DmacChannel *channel = DmaManager::Channel(m_dmaTxChannel);
+        channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+        while (channel->CHCTRLA.bit.ENABLE) {
+            continue;
+        }
+        m_dmaTx.Reset();
+        __enable_irq();
+        return;
+    }
     // Flush buffers
     m_bufferOut[0] = 0;
     m_outTail = 0;
@@ -662,6 +669,10 @@ void SerialBase::Flush() {
     Flush receive buffers.
 **/
 void SerialBase::FlushInput() {
+    if (m_uartDma) {
+        m_dmaRx.Discard(UartDmaRxPos());
+        return;
+    }
     // Flush buffers
     m_bufferIn[0] = 0;
     m_inTail = 0;
@@ -730,6 +741,11 @@ void SerialBase::SpiClock(
     Attempt to get next character from serial channel.
 **/
 int16_t SerialBase::CharGet() {
+    if (m_uartDma) {
+        uint8_t dmaChar;
+        return m_dmaRx.Read(UartDmaRxPos(), &dmaChar, 1) ? dmaChar :
+               SerialBase::EOB;
+    }
     // Return if nothing is waiting.
     if (m_inTail == m_inHead) {
         return SerialBase::EOB;
@@ -751,6 +767,9 @@ int16_t SerialBase::CharGet() {
     out of the buffer.
 **/
 int16_t SerialBase::CharPeek() {
+    if (m_uartDma) {
+        return m_dmaRx.Peek(UartDmaRxPos());
+    }
     // Return if nothing is waiting
     if (m_inTail == m_inHead) {
         return SerialBase::EOB;
@@ -769,6 +788,17 @@ bool SerialBase::SendChar(uint8_t charToSend) {
     if (!m_portOpen || m_portMode == PortModes::SPI) {
         return false;
     }
+    if (m_uartDma) {
+        // Wait for the DMA to make room, as below
+        while (!m_dmaTx.Space()) {
+            if (!m_portOpen) {
+                return false;
+            }
+        }
+        m_dmaTx.Write(&charToSend, 1);
+        UartDmaTxPump();
+        return true;
+    }
     // Calculate next location with wrap
     uint32_t nextIndex = NextIndex(m_outTail);
 
@@ -907,6 +937,16 @@ bool SerialBase::SpiAsyncWaitComplete() {
     return true;
 }
 
+bool SerialBase::SpiAsyncComplete() {
+    // If this channel is not set up to do DMA transfers, it is already done
+    if (m_dmaRxChannel == DMA_INVALID_CHANNEL ||
+            m_dmaTxChannel == DMA_INVALID_CHANNEL) {
+        return true;
+    }
+    return !(m_portOpen && m_portMode == SPI &&
+             DmaManager::Channel(m_dmaRxChannel)->CHCTRLA.bit.ENABLE);
+}
+
 void SerialBase::HandleFrameError() {
     // If there's a framing error raise a warning and clear the flag
     if (m_serPort->USART.STATUS.bit.FERR) {
@@ -949,6 +989,12 @@ SerialBase::SerialErrorStatusRegister SerialBase::ErrorStatusAccum(
 **/
 void SerialBase::WaitForTransmitIdle() {
     if (m_portMode == UART) {
+        if (m_uartDma) {
+            // Keep the blocks going until the ring has emptied
+            while (m_uartDma && m_dmaTx.Pending()) {
+                UartDmaTxPump();
+            }
+        }
         // Wait until the out buffer has emptied
         while (m_outHead != m_outTail) {
             continue;
@@ -973,6 +1019,9 @@ void SerialBase::WaitForTransmitIdle() {
     Return the number of free characters in the receive buffer
 **/
 int32_t SerialBase::AvailableForRead() {
+    if (m_uartDma) {
+        return m_dmaRx.Available(UartDmaRxPos());
+    }
     int32_t difference = m_inTail - m_inHead;
 
     if (difference < 0) {
@@ -987,6 +1036,9 @@ int32_t SerialBase::AvailableForRead() {
     Returns the number of available characters in the transmit buffer
 **/
 int32_t SerialBase::AvailableForWrite() {
+    if (m_uartDma) {
+        return m_dmaTx.Space();
+    }
     int32_t difference = m_outHead - m_outTail - 1;
 
     if (difference < 0) {
@@ -996,6 +1048,184 @@ int32_t SerialBase::AvailableForWrite() {
     return difference;
 }
 
+// ============================ UART DMA API ===============================
+
+bool SerialBase::UartDma(bool enable) {
+    // Only the ports with the SPI DMA channels of PortMode() can use the DMA
+    if (enable && m_serPort != SERCOM0 && m_serPort != SERCOM4 &&
+            m_serPort != SERCOM7) {
+        return false;
+    }
+    if (enable == m_uartDmaRequest) {
+        return true;
+    }
+    m_uartDmaRequest = enable;
+    if (m_portOpen && m_portMode == UART) {
+        // Restart the port in the new mode
+        WaitForTransmitIdle();
+        PortMode(UART);
+    }
+    return true;
+}
+
+int32_t SerialBase::Read(uint8_t *buf, int32_t len) {
+    if (!m_portOpen || m_portMode == SPI || len <= 0) {
+        return 0;
+    }
+    if (m_uartDma) {
+        return m_dmaRx.Read(UartDmaRxPos(), buf,
+                            min(len, SERIAL_DMA_BUFFER_SIZE));
+    }
+
+    int32_t count = 0;
+    while (count < len && m_inHead != m_inTail) {
+        int16_t inChar = m_bufferIn[m_inHead];
+        m_inHead = NextIndex(m_inHead);
+        // A break indication is not a character
+        if (inChar != SerialBase::BREAK_DETECTED) {
+            buf[count++] = static_cast<uint8_t>(inChar);
+        }
+    }
+    EnableRxcInterruptUart();
+    return count;
+}
+
+int32_t SerialBase::Write(const uint8_t *buf, int32_t len) {
+    if (!m_portOpen || m_portMode == SPI || len <= 0) {
+        return 0;
+    }
+    if (m_uartDma) {
+        int32_t count = m_dmaTx.Write(buf, min(len, SERIAL_DMA_BUFFER_SIZE));
+        UartDmaTxPump();
+        return count;
+    }
+
+    int32_t count = 0;
+    uint32_t nextIndex = NextIndex(m_outTail);
+    while (count < len && nextIndex != m_outHead) {
+        m_bufferOut[m_outTail] = buf[count++];
+        m_outTail = nextIndex;
+        nextIndex = NextIndex(m_outTail);
+    }
+    if (count) {
+        EnableDreInterruptUart();
+    }
+    return count;
+}
+
+int32_t SerialBase::ReadSpan(const uint8_t *&data) {
+    if (!m_uartDma) {
+        return 0;
+    }
+    return m_dmaRx.Span(UartDmaRxPos(), data);
+}
+
+void SerialBase::ReadRelease(int32_t len) {
+    if (m_uartDma && len > 0) {
+        m_dmaRx.Consume(len);
+    }
+}
+
+int32_t SerialBase::WriteSpan(uint8_t *&data) {
+    if (!m_uartDma) {
+        return 0;
+    }
+    return m_dmaTx.Span(data);
+}
+
+void SerialBase::WriteCommit(int32_t len) {
+    if (m_uartDma && len > 0) {
+        m_dmaTx.Commit(len);
+        UartDmaTxPump();
+    }
+}
+
+bool SerialBase::RxIdle() {
+    return m_uartDma && m_dmaRx.Idle(UartDmaRxPos());
+}
+
+void SerialBase::DmaChannelSetup(DmaChannels index, uint8_t trigger) {
+    DmacChannel *channel = DmaManager::Channel(index);
+    // Disable and reset the channel so it is clean to setup
+    channel->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    // Wait for the reset to finish
+    while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
+        continue;
+    }
+
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(trigger) |
+                           DMAC_CHCTRLA_TRIGACT_BURST |
+                           DMAC_CHCTRLA_BURSTLEN_SINGLE;
+}
+
+void SerialBase::UartDmaStart() {
+    m_dmaRx.Reset();
+    m_dmaTx.Reset();
+
+    // The Rx descriptor links to itself to refill the ring forever
+    DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(m_dmaRxChannel);
+    baseDesc->DESCADDR.reg = (uint32_t)baseDesc;
+    baseDesc->SRCADDR.reg = (uint32_t)&m_serPort->USART.DATA.reg;
+    baseDesc->DSTADDR.reg =
+        (uint32_t)(m_dmaRx.Buffer() + SERIAL_DMA_BUFFER_SIZE);
+    baseDesc->BTCNT.reg = SERIAL_DMA_BUFFER_SIZE;
+    baseDesc->BTCTRL.reg =
+        DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_VALID;
+    // The write-back count is only loaded with the first character
+    DmaManager::WriteBackDescriptor(m_dmaRxChannel)->BTCNT.reg =
+        SERIAL_DMA_BUFFER_SIZE;
+    DmaManager::Channel(m_dmaRxChannel)->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+
+    // Set up the Tx dest descriptor, the blocks come from UartDmaTxPump()
+    baseDesc = DmaManager::BaseDescriptor(m_dmaTxChannel);
+    baseDesc->DESCADDR.reg = static_cast<uint32_t>(0);
+    baseDesc->DSTADDR.reg = (uint32_t)&m_serPort->USART.DATA.reg;
+
+    m_uartDma = true;
+}
+
+void SerialBase::UartDmaStop() {
+    if (!m_uartDma) {
+        return;
+    }
+    // Clear the mode first so that UartDmaRefresh() leaves the channels be
+    m_uartDma = false;
+    DmaManager::Channel(m_dmaRxChannel)->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    DmaManager::Channel(m_dmaTxChannel)->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+}
+
+void SerialBase::UartDmaTxPump() {
+    // Called from both the application and the sample time interrupt
+    __disable_irq();
+    DmacChannel *channel = DmaManager::Channel(m_dmaTxChannel);
+    if (m_dmaTx.Busy() && !channel->CHCTRLA.bit.ENABLE) {
+        m_dmaTx.Done();
+    }
+    const uint8_t *data;
+    uint16_t len = m_dmaTx.Next(data);
+    if (len) {
+        DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(m_dmaTxChannel);
+        baseDesc->SRCADDR.reg = (uint32_t)(data + len);
+        baseDesc->BTCNT.reg = len;
+        baseDesc->BTCTRL.reg =
+            DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC | DMAC_BTCTRL_VALID;
+        channel->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+    }
+    __enable_irq();
+}
+
+void SerialBase::UartDmaRefresh() {
+    if (!m_uartDma) {
+        return;
+    }
+    if (m_dmaRx.Track(UartDmaRxPos(), m_dmaIdleTicks)) {
+        // The DMA overwrote characters that were not read yet
+        m_errorRegAccum.bit.SerialOverflowError = 1;
+    }
+    UartDmaTxPump();
+}
+
 // =========================== INTERRUPT API ===============================
 
 /**
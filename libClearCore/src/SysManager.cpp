@@ -52,6 +52,7 @@
 #include "ShiftRegister.h"
 #include "StatusManager.h"
 #include "SysConnectors.h"
+#include "SysProfiler.h"
 #include "SysTiming.h"
 #include "SysUtils.h"
 #include "UsbManager.h"
@@ -97,6 +98,7 @@ extern MotorManager &MotorMgr;
 extern NvmManager &NvmMgr;
 extern StatusManager &StatusMgr;
 extern UsbManager &UsbMgr;
+extern SysProfiler &ProfilerMgr;
 extern SysTiming &TimingMgr;
 SdCardDriver SdCard;
 ShiftRegister ShiftReg;
@@ -161,7 +163,9 @@ Connector *const Connectors[CLEARCORE_PIN_MAX] = {
 /**
     Constructor
 **/
-SysManager::SysManager() : m_readyForOperations(false) {
+SysManager::SysManager()
+    : m_readyForOperations(false),
+      m_sampleCallback(nullptr) {
     XBee = XBeeDriver(&XBee_CTS_IN, &XBee_RTS_OUT, &XBee_Rx_IN, &XBee_Tx_OUT,
                       PER_SERCOM_ALT);
     SdCard = SdCardDriver(&MicroSD_MISO, &MicroSD_SS, &MicroSD_SCK,
@@ -329,26 +333,44 @@ void SysManager::Initialize() {
     Update systems at the sample rate
 **/
 void SysManager::UpdateFastImpl() {
+    ProfilerMgr.FastStart();
     CcioMgr.Refresh();
+    ProfilerMgr.Mark(PROFILE_CCIO);
     AdcMgr.Update();
+    ProfilerMgr.Mark(PROFILE_ADC);
     StatusMgr.Refresh();
+    ProfilerMgr.Mark(PROFILE_STATUS);
     UsbMgr.Refresh();
+    ProfilerMgr.Mark(PROFILE_USB);
     InputMgr.UpdateBegin();
+    ProfilerMgr.Mark(PROFILE_INPUTS);
 
     if (SysMgr.Ready()) {
         for (uint8_t i = 0; i < CLEARCORE_PIN_MAX; i++) {
             Connectors[i]->Refresh();
+            ProfilerMgr.Mark((i >= CLEARCORE_PIN_M0 && i <= CLEARCORE_PIN_M3) ?
+                             PROFILE_MOTORS : PROFILE_CONNECTORS);
         }
     }
 
     InputMgr.UpdateEnd();
+    ProfilerMgr.Mark(PROFILE_INPUTS);
     EncoderIn.Update();
+    ProfilerMgr.Mark(PROFILE_ENCODER);
+
+    voidFuncPtr sampleCallback = m_sampleCallback;
+    if (sampleCallback) {
+        sampleCallback();
+    }
+    ProfilerMgr.Mark(PROFILE_CALLBACK);
 
     // Update subsystems in the background
     ShiftReg.Update();
+    ProfilerMgr.Mark(PROFILE_SHIFT_REG);
     TimingMgr.Update();
 
     tickCnt++;
+    ProfilerMgr.FastEnd();
 }
 
 /**
@@ -359,12 +381,16 @@ void SysManager::UpdateSlowImpl() {
         return;
     }
 
+    ProfilerMgr.SlowStart();
     // CCIO-8 Auto-Rediscover
     CcioMgr.RefreshSlow();
+    ProfilerMgr.SlowMark(PROFILE_SLOW_CCIO);
 
     for (uint8_t iMotor = 0; iMotor < MOTOR_CON_CNT; iMotor++) {
         MotorConnectors[iMotor]->RefreshSlow();
     }
+    ProfilerMgr.SlowMark(PROFILE_SLOW_MOTORS);
+    ProfilerMgr.SlowEnd();
 }
 
 Connector *SysManager::ConnectorByIndex(ClearCorePins theConnector) {
@@ -502,6 +528,11 @@ void SysManager::SysTickUpdate() {
 
 void SysManager::FastUpdate() {
     ACK_FAST_UPDATE_INT;
+    // In DMA step output mode the timer overflows once per step slot; only
+    // the first slot of each sample starts a sample time.
+    if (!MotorMgr.SampleStart()) {
+        return;
+    }
     TimingMgr.IsrStart();
     SysMgr.UpdateFastImpl();
     if (FastSysTick) {
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SysProfiler.h"
+#include <stdio.h>
+#include <string.h>
+#include "ISerial.h"
+
+namespace ClearCore {
+
+#ifndef __arm__
+volatile uint32_t ProfileStubCycles = 0;
+#endif
+
+SysProfiler &ProfilerMgr = SysProfiler::Instance();
+
+static const char *const SectionNames[PROFILE_SECTION_COUNT] = {
+    "FastTotal",
+    "Ccio",
+    "Adc",
+    "Status",
+    "Usb",
+    "Inputs",
+    "Connectors",
+    "Motors",
+    "Encoder",
+    "Callback",
+    "ShiftReg",
+    "SlowTotal",
+    "SlowCcio",
+    "SlowMotors",
+};
+
+void ProfileStats::Reset() {
+    count = 0;
+    min = UINT32_MAX;
+    max = 0;
+    sum = 0;
+    overruns = 0;
+    memset(hist, 0, sizeof(hist));
+}
+
+SysProfiler &SysProfiler::Instance() {
+    static SysProfiler *instance = new SysProfiler();
+    return *instance;
+}
+
+SysProfiler::SysProfiler()
+    : m_cycles{0},
+      m_fastStart(0),
+      m_fastMark(0),
+      m_slowStart(0),
+      m_slowMark(0),
+      m_fastSeq(0),
+      m_slowSeq(0),
+      m_resetFast(false),
+      m_resetSlow(false) {
+    for (uint8_t i = 0; i < PROFILE_SECTION_COUNT; i++) {
+        m_stats[i].budget = 0;
+        m_stats[i].Reset();
+    }
+    m_stats[PROFILE_FAST_TOTAL].budget = CYCLES_PER_INTERRUPT;
+    m_stats[PROFILE_SLOW_TOTAL].budget = CYCLES_PER_MILLISECOND;
+}
+
+void SysProfiler::FastEnd() {
+    Commit(PROFILE_FAST_TOTAL, PROFILE_SHIFT_REG,
+           PROFILE_CYCLE_COUNT() - m_fastStart, m_fastSeq, m_resetFast);
+}
+
+void SysProfiler::SlowEnd() {
+    Commit(PROFILE_SLOW_TOTAL, PROFILE_SLOW_MOTORS,
+           PROFILE_CYCLE_COUNT() - m_slowStart, m_slowSeq, m_resetSlow);
+}
+
+void SysProfiler::Commit(ProfileSections first, ProfileSections last,
+                         uint32_t totalCycles, volatile uint32_t &seq,
+                         volatile bool &reset) {
+    seq++;
+    if (reset) {
+        reset = false;
+        for (uint8_t i = first; i <= last; i++) {
+            m_stats[i].Reset();
+        }
+    }
+    m_stats[first].Record(totalCycles);
+    for (uint8_t i = first + 1; i <= last; i++) {
+        m_stats[i].Record(m_cycles[i]);
+        m_cycles[i] = 0;
+    }
+    seq++;
+}
+
+bool SysProfiler::Snapshot(ProfileSections section, ProfileStats &stats) {
+    if (section >= PROFILE_SECTION_COUNT) {
+        return false;
+    }
+    volatile uint32_t &seq =
+        section < PROFILE_SLOW_TOTAL ? m_fastSeq : m_slowSeq;
+
+    // Retry until no update of the section's group overlapped the copy
+    uint32_t seqStart;
+    do {
+        seqStart = seq;
+        __sync_synchronize();
+        memcpy(&stats, &m_stats[section], sizeof(stats));
+        __sync_synchronize();
+    } while ((seqStart & 1) || seqStart != seq);
+    return true;
+}
+
+void SysProfiler::Budget(ProfileSections section, uint32_t cycles) {
+    if (section < PROFILE_SECTION_COUNT) {
+        m_stats[section].budget = cycles;
+    }
+}
+
+const char *SysProfiler::SectionName(ProfileSections section) {
+    return section < PROFILE_SECTION_COUNT ? SectionNames[section] : "";
+}
+
+void SysProfiler::Dump(ISerial &port) {
+    char line[96];
+    port.SendLine("section       count      min      max     mean  overruns"
+                  "  %sample");
+    for (uint8_t i = 0; i < PROFILE_SECTION_COUNT; i++) {
+        ProfileStats stats;
+        Snapshot(static_cast<ProfileSections>(i), stats);
+        // Share of the period the section runs in, in 0.1 %
+        uint32_t period = i < PROFILE_SLOW_TOTAL ? CYCLES_PER_INTERRUPT
+                                                 : CYCLES_PER_MILLISECOND;
+        uint32_t permille = static_cast<uint64_t>(stats.Mean()) * 1000 /
+                            period;
+        snprintf(line, sizeof(line), "%-10s %8lu %8lu %8lu %8lu %9lu %5lu.%lu",
+                 SectionNames[i], (unsigned long)stats.count,
+                 (unsigned long)(stats.count ? stats.min : 0),
+                 (unsigned long)stats.max, (unsigned long)stats.Mean(),
+                 (unsigned long)stats.overruns,
+                 (unsigned long)(permille / 10),
+                 (unsigned long)(permille % 10));
+        port.SendLine(line);
+    }
+}
+
+} // ClearCore namespace